@@ -388,6 +388,7 @@ typedef struct
 #endif
 	char				allowed_addresses[ZBX_HOST_PROXY_ADDRESS_LEN_MAX];
 	time_t				last_version_error_time;
+	unsigned char			compress_codec;
 }
 zbx_dc_proxy_t;
 
@@ -988,6 +989,10 @@ int	zbx_dc_get_host_inventory_value_by_hostid(zbx_uint64_t hostid, char **replac
 #define ZBX_CONFSTATS_BUFFER_FREE	3
 #define ZBX_CONFSTATS_BUFFER_PUSED	4
 #define ZBX_CONFSTATS_BUFFER_PFREE	5
+#define ZBX_CONFSTATS_LOCK_HOLD		6
+#define ZBX_CONFSTATS_LOCK_STALL	7
+#define ZBX_CONFSTATS_LOCK_STALLS	8
+#define ZBX_CONFSTATS_LOCK_BYPASSES	9
 void	*zbx_dc_config_get_stats(int request);
 
 int	zbx_dc_config_get_last_sync_time(void);
@@ -87,6 +87,7 @@ zbx_wcache_info_t;
 #define ZBX_STATS_HISTORY_INDEX_PUSED	20
 #define ZBX_STATS_HISTORY_INDEX_PFREE	21
 #define ZBX_STATS_HISTORY_BIN_COUNTER	22
+#define ZBX_STATS_TREND_FLUSH_TIME	23
 
 /* 'zbx_pp_value_opt_t' element 'flags' values */
 #define ZBX_PP_VALUE_OPT_NONE		0x0000	/* 'zbx_pp_value_opt_t' has no data */
@@ -148,6 +149,7 @@ void	zbx_db_flush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uint6
 		zbx_dc_sync_trend_mode_t sync_trend_mode);
 void	zbx_dc_mass_update_trends(const zbx_dc_history_t *history, int history_num, ZBX_DC_TREND **trends,
 		int *trends_num, int compression_age);
+void	zbx_dc_trends_flush_part_done(void);
 void	zbx_dc_sync_trends(int parallel_num);
 int	zbx_trend_compare(const void *d1, const void *d2);
 void	zbx_dc_export_history_and_trends(const zbx_dc_history_t *history, int history_num,
@@ -181,7 +183,8 @@ typedef void (*zbx_sync_history_cache_f)(const zbx_events_funcs_t *events_cbs, z
 
 int	zbx_init_database_cache(zbx_get_program_type_f get_program_type,
 		zbx_sync_history_cache_f sync_history_cache_func, zbx_uint64_t history_cache_size,
-		zbx_uint64_t history_index_cache_size, zbx_uint64_t *trends_cache_size, char **error);
+		zbx_uint64_t history_index_cache_size, int history_cache_partitions, int trends_flush_syncers,
+		zbx_uint64_t *trends_cache_size, char **error);
 
 void	zbx_free_database_cache(int sync, const zbx_events_funcs_t *events_cbs, int config_history_storage_pipelines);
 
@@ -200,11 +203,6 @@ int	zbx_hc_proxyqueue_dequeue(zbx_uint64_t proxyid);
 void	zbx_hc_proxyqueue_clear(void);
 void	zbx_dbcache_lock(void);
 void	zbx_dbcache_unlock(void);
-void	zbx_dbcache_set_history_num(int num);
-int	zbx_dbcache_get_history_num(void);
-
-zbx_shmem_info_t	*zbx_dbcache_get_hc_mem(void);
-
 void	zbx_dbcache_setproxyqueue_state(int proxyqueue_state);
 int	zbx_dbcache_getproxyqueue_state(void);
 void	zbx_hc_acquire(void);
@@ -17,6 +17,7 @@
 
 #include "zbxalgo.h"
 #include "zbxtime.h"
+#include "zbxcompress.h"
 
 #define ZBX_IPV4_MAX_CIDR_PREFIX	32	/* max number of bits in IPv4 CIDR prefix */
 #define ZBX_IPV6_MAX_CIDR_PREFIX	128	/* max number of bits in IPv6 CIDR prefix */
@@ -173,12 +174,19 @@ typedef struct
 	unsigned char	close_notify_received;
 #elif defined(HAVE_OPENSSL)
 	SSL				*ctx;
+	/* peer identity of client connection, used to cache its session for resumption, 0 if not cached */
+	zbx_hash_t			session_hash;
 #if defined(HAVE_OPENSSL_WITH_PSK)
 	char	psk_buf[HOST_TLS_PSK_LEN / 2];
 	int	psk_len;
 	size_t	identity_len;
+	/* PSK identity captured by server callback function of accepted connection */
+	int	incoming_has_psk;
+	char	incoming_psk_id[PSK_MAX_IDENTITY_LEN + 1];
 #endif
 #endif
+	/* where PSK of accepted connection was found: among host PSKs or autoregistration PSK */
+	unsigned int	psk_usage;
 } zbx_tls_context_t;
 #endif
 
@@ -210,6 +218,10 @@ typedef struct
 
 	/* limits tcp received packet size, overrides flags limits */
 	zbx_uint64_t			max_len_limit;
+
+	/* large compressed message is uncompressed while being received, compressed data is read into chunk */
+	zbx_uncompress_stream_t		*recv_stream;
+	char				*recv_chunk;
 }
 zbx_socket_t;
 
@@ -266,6 +278,10 @@ int	zbx_socket_tls_connect(zbx_socket_t *s, unsigned int tls_connect, const char
 #define ZBX_TCP_PROTOCOL		0x01
 #define ZBX_TCP_COMPRESS		0x02
 #define ZBX_TCP_LARGE			0x04
+/* compression codec flags, used together with ZBX_TCP_COMPRESS - zlib is used when no codec flag is set */
+#define ZBX_TCP_ZSTD			0x08
+#define ZBX_TCP_LZ4			0x10
+#define ZBX_TCP_CODEC_MASK		(ZBX_TCP_ZSTD | ZBX_TCP_LZ4)
 
 #define ZBX_TCP_SEC_UNENCRYPTED		1		/* do not use encryption with this socket */
 #define ZBX_TCP_SEC_TLS_PSK		2		/* use TLS with pre-shared key (PSK) with this socket */
@@ -284,6 +300,8 @@ const char	*zbx_tcp_connection_type_name(unsigned int type);
 
 int	zbx_tcp_send_ext(zbx_socket_t *s, const char *data, size_t len, size_t reserved, unsigned char flags,
 		int timeout);
+unsigned char	zbx_tcp_compress_flags(unsigned char codec);
+unsigned char	zbx_tcp_get_compress_codec(const zbx_socket_t *s);
 int	zbx_tcp_send_context_init(const char *data, size_t len, size_t reserved, unsigned char flags,
 		zbx_tcp_send_context_t *context);
 void	zbx_tcp_send_context_clear(zbx_tcp_send_context_t *state);
@@ -301,6 +319,9 @@ void	zbx_tcp_unlisten(zbx_socket_t *s);
 
 int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, char *tls_listen,
 		const char *unencrypted_allowed_ip);
+int	zbx_tcp_accept_connection(zbx_socket_t *s, ZBX_SOCKET listen_socket);
+int	zbx_tcp_accept_handshake(zbx_socket_t *s, unsigned int tls_accept, char *tls_listen,
+		const char *unencrypted_allowed_ip, short *event);
 void	zbx_tcp_unaccept(zbx_socket_t *s);
 
 #define ZBX_TCP_READ_UNTIL_CLOSE 0x01
@@ -316,9 +337,11 @@ ssize_t		zbx_tcp_recv_ext(zbx_socket_t *s, int timeout, unsigned char flags);
 ssize_t		zbx_tcp_recv_raw_ext(zbx_socket_t *s, int timeout);
 const char	*zbx_tcp_recv_line(zbx_socket_t *s);
 int		zbx_tcp_read_close_notify(zbx_socket_t *s, int timeout, short *events);
+int		zbx_tcp_peer_closed(zbx_socket_t *s);
 
 void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv_context, unsigned char flags);
 ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, unsigned char flags, short *events);
+zbx_uint64_t	zbx_tcp_recv_get_peak_memory(unsigned int connection_type);
 ssize_t	zbx_tcp_recv_context_raw(zbx_socket_t *s, zbx_tcp_recv_context_t *context, short *events, int once);
 const char	*zbx_tcp_recv_context_line(zbx_socket_t *s, zbx_tcp_recv_context_t *context, short *events);
 
@@ -435,6 +458,9 @@ void	zbx_tls_validate_config(zbx_config_tls_t *config_tls, int config_active_for
 		int config_passive_forks, zbx_get_program_type_f zbx_get_program_type_cb);
 void	zbx_tls_library_deinit(zbx_tls_status_t status);
 void	zbx_tls_init_parent(zbx_get_program_type_f zbx_get_program_type_cb_arg);
+#if defined(HAVE_OPENSSL)
+void	zbx_tls_generate_ticket_keys(void);
+#endif
 
 typedef size_t	(*zbx_find_psk_in_cache_f)(const unsigned char *, unsigned char *, unsigned int *);
 
@@ -464,7 +490,7 @@ int		zbx_tls_validate_attr(const zbx_tls_conn_attr_t *attr, const char *tls_issu
 				const char *tls_psk_identity, const char **msg);
 int		zbx_check_server_issuer_subject(const zbx_socket_t *sock, const char *allowed_issuer,
 				const char *allowed_subject, char **error);
-unsigned int	zbx_tls_get_psk_usage(void);
+unsigned int	zbx_tls_get_psk_usage(const zbx_socket_t *s);
 
 /* TLS BLOCK END */
 
@@ -23,8 +23,10 @@ int	zbx_connect_to_server(zbx_socket_t *sock, const char *source_ip, zbx_vector_
 		int connect_timeout, int retry_interval, int level, const zbx_config_tls_t *config_tls);
 void	zbx_disconnect_from_server(zbx_socket_t *sock);
 
-int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error);
-int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error);
+int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char codec, char **error);
+int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char codec, char **error);
 
 int	zbx_send_response_ext(zbx_socket_t *sock, int result, const char *info, const char *version, int protocol,
 		int timeout);
@@ -43,10 +45,27 @@ int	zbx_send_response_json(zbx_socket_t *sock, int result, const char *info, con
 
 int	zbx_recv_response(zbx_socket_t *sock, int timeout, char **error);
 
+void	zbx_add_compress_codecs(struct zbx_json *json);
+unsigned char	zbx_parse_compress_codecs(const struct zbx_json_parse *jp);
+
 void	zbx_add_redirect_response(struct zbx_json *json, const zbx_comms_redirect_t *redirect);
 int	zbx_parse_redirect_response(struct zbx_json_parse *jp, char **host, unsigned short *port,
 		zbx_uint64_t *revision, unsigned char *reset);
 
+/* connection kept open between exchanges with the same address, zero initialized when not connected */
+typedef struct
+{
+	zbx_socket_t	sock;
+	char		*ip;
+	unsigned short	port;
+}
+zbx_comms_keepalive_t;
+
+void	zbx_comms_keepalive_close(zbx_comms_keepalive_t *keepalive);
+int	zbx_comms_exchange_keepalive(zbx_comms_keepalive_t *keepalive, const char *source_ip,
+		zbx_vector_addr_ptr_t *addrs, int timeout, int connect_timeout, int retry_interval, int loglevel,
+		const zbx_config_tls_t *config_tls, const char *data, char *(*connect_callback)(void *),
+		void *cb_data, char **out, char **error);
 int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_t *addrs, int timeout,
 		int connect_timeout, int retry_interval, int loglevel, const zbx_config_tls_t *config_tls,
 		const char *data, char *(*connect_callback)(void *), void *cb_data, char **out, char **error);
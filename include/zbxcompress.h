@@ -17,8 +17,30 @@
 
 #include "zbxtypes.h"
 
+#define ZBX_COMPRESS_ZLIB	0
+#define ZBX_COMPRESS_ZSTD	1
+#define ZBX_COMPRESS_LZ4	2
+
+int	zbx_compress_codec_parse(const char *name, unsigned char *codec);
+int	zbx_compress_codec_supported(unsigned char codec);
+int	zbx_compress_set_codec(unsigned char codec);
+unsigned char	zbx_compress_get_codec(void);
+const char	*zbx_compress_codecs(void);
+unsigned char	zbx_compress_negotiate(const char *codecs);
+
+int	zbx_compress_ext(unsigned char codec, const char *in, size_t size_in, char **out, size_t *size_out);
+int	zbx_uncompress_ext(unsigned char codec, const char *in, size_t size_in, char *out, size_t *size_out);
+
 int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out);
 int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out);
 const char	*zbx_compress_strerror(void);
 
+typedef struct zbx_uncompress_stream	zbx_uncompress_stream_t;
+
+int	zbx_uncompress_stream_supported(unsigned char codec);
+zbx_uncompress_stream_t	*zbx_uncompress_stream_create(unsigned char codec, char *out, size_t size_out);
+int	zbx_uncompress_stream_write(zbx_uncompress_stream_t *stream, const char *in, size_t size_in);
+int	zbx_uncompress_stream_finish(zbx_uncompress_stream_t *stream, size_t *size_out);
+void	zbx_uncompress_stream_free(zbx_uncompress_stream_t *stream);
+
 #endif
@@ -146,6 +146,14 @@ void	zbx_db_trigger_explain_expression(const zbx_db_trigger *trigger, char **exp
 void	zbx_db_trigger_get_function_value(const zbx_db_trigger *trigger, int index, char **value,
 		zbx_evaluate_function_trigger_t evaluate_function_trigger_cb, int recovery);
 
+/* group statuses */
+typedef enum
+{
+	GROUP_STATUS_ACTIVE = 0,
+	GROUP_STATUS_DISABLED
+}
+zbx_group_status_type_t;
+
 int	zbx_db_check_user_perm2system(zbx_uint64_t userid);
 char	*zbx_db_get_user_timezone(zbx_uint64_t userid);
 
@@ -26,4 +26,14 @@ void	zbx_init_escalations(int escalators_num, zbx_rtc_notify_generic_cb_t rtc_no
 void	zbx_start_escalations(zbx_ipc_async_socket_t *rtc, zbx_vector_escalation_new_ptr_t *escalations);
 void	zbx_escalation_new_ptr_free(zbx_escalation_new_t *data);
 
+/* escalation queues with separate shard tables - trigger, item, service and other escalations */
+#define ZBX_ESCALATION_QUEUES_NUM	4
+
+int	zbx_init_escalation_shards(int shards_num, int batch, char **error);
+void	zbx_deinit_escalation_shards(void);
+int	zbx_escalation_shards_num(void);
+void	zbx_escalation_shards_queue(int process_num, int now, int delay);
+int	zbx_escalation_shards_claim(int queue, int process_num, zbx_vector_int32_t *shardids);
+void	zbx_escalation_shards_release(int queue, const zbx_vector_int32_t *shardids);
+
 #endif
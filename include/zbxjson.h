@@ -66,6 +66,7 @@
 #define ZBX_PROTO_TAG_DISCOVERY_DATA		"discovery data"
 #define ZBX_PROTO_TAG_AUTOREGISTRATION		"auto registration"
 #define ZBX_PROTO_TAG_MORE			"more"
+#define ZBX_PROTO_TAG_COMPRESSION		"compression"
 #define ZBX_PROTO_TAG_ITEMID			"itemid"
 #define ZBX_PROTO_TAG_TTL			"ttl"
 #define ZBX_PROTO_TAG_COMMANDTYPE		"commandtype"
@@ -228,6 +229,7 @@
 #define ZBX_PROTO_TAG_LEASE_DURATION		"lease_duration"
 #define ZBX_PROTO_TAG_PREPROC			"preproc"
 #define ZBX_PROTO_TAG_PROXY_SECRETS_PROVIDER	"proxy_secrets_provider"
+#define ZBX_PROTO_TAG_KEEPALIVE			"keepalive"
 
 #define ZBX_PROTO_VALUE_FAILED		"failed"
 #define ZBX_PROTO_VALUE_SUCCESS		"success"
@@ -406,6 +408,7 @@ typedef struct zbx_jsonpath_index zbx_jsonpath_index_t;
 
 int	zbx_jsonpath_compile(const char *path, zbx_jsonpath_t *jsonpath);
 int	zbx_jsonpath_query(const struct zbx_json_parse *jp, const char *path, char **output);
+int	zbx_jsonpath_query_data(const char *data, const zbx_jsonpath_t *jsonpath, char **output);
 void	zbx_jsonpath_clear(zbx_jsonpath_t *jsonpath);
 
 zbx_jsonpath_index_t	*zbx_jsonpath_index_create(char **error);
@@ -414,8 +417,11 @@ void	zbx_jsonpath_index_free(zbx_jsonpath_index_t *index);
 void	zbx_jsonobj_init(zbx_jsonobj_t *obj);
 int	zbx_jsonobj_open(const char *data, zbx_jsonobj_t *obj);
 void	zbx_jsonobj_clear(zbx_jsonobj_t *obj);
+size_t	zbx_jsonobj_get_size(const zbx_jsonobj_t *obj);
 int	zbx_jsonobj_query(const zbx_jsonobj_t *obj, const char *path, char **output);
 int	zbx_jsonobj_query_ext(const zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const char *path, char **output);
+int	zbx_jsonobj_query_compiled(const zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, zbx_jsonpath_t *jsonpath,
+		char **output);
 int	zbx_jsonobj_to_string(char **str, size_t *str_alloc, size_t *str_offset, const zbx_jsonobj_t *obj);
 const zbx_jsonobj_t *zbx_jsonobj_get_value(const zbx_jsonobj_t *obj, const char *name);
 
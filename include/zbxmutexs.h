@@ -30,6 +30,9 @@ typedef HANDLE zbx_mutex_t;
 #	define zbx_mutex_lock(mutex)		__zbx_mutex_lock(__FILE__, __LINE__, mutex)
 #	define zbx_mutex_unlock(mutex)		__zbx_mutex_unlock(__FILE__, __LINE__, mutex)
 #else	/* not _WINDOWS */
+/* the maximum number of history cache partitions, each partition has its own lock */
+#define ZBX_HC_PARTITIONS_MAX	16
+
 typedef enum
 {
 	ZBX_MUTEX_LOG = 0,
@@ -52,6 +55,11 @@ typedef enum
 	ZBX_MUTEX_REMOTE_COMMANDS,
 	ZBX_MUTEX_PROXY_BUFFER,
 	ZBX_MUTEX_VPS_MONITOR,
+	ZBX_MUTEX_CONFIG_STATS,
+	ZBX_MUTEX_ESCALATION_SHARDS,
+	/* history cache partition locks, the first partition uses ZBX_MUTEX_CACHE */
+	ZBX_MUTEX_CACHE_PARTITION,
+	ZBX_MUTEX_CACHE_PARTITION_LAST = ZBX_MUTEX_CACHE_PARTITION + ZBX_HC_PARTITIONS_MAX - 2,
 	/* NOTE: Do not forget to sync changes here with mutex names in diag_add_locks_info()! */
 	ZBX_MUTEX_COUNT
 }
@@ -50,6 +50,7 @@ typedef struct
 	int				config_unreachable_period;
 	int				config_unreachable_delay;
 	int				config_max_concurrent_checks_per_poller;
+	int				config_snmp_max_repetitions_tuning;
 	zbx_get_config_forks_f		get_config_forks;
 	const char			*config_java_gateway;
 	int				config_java_gateway_port;
@@ -102,6 +103,8 @@ zbx_dc_item_context_t	*zbx_async_check_snmp_get_item_context(zbx_snmp_context_t
 
 char	*zbx_async_check_snmp_get_reverse_dns(zbx_snmp_context_t *snmp_context);
 void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context);
+void	zbx_async_check_snmp_batch_begin(int max_repetitions_limit);
+void	zbx_async_check_snmp_batch_end(void);
 int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result,
 		zbx_async_task_process_result_cb_t async_task_process_result_snmp_cb,
 		void *arg, void *arg_action, struct event_base *base, zbx_channel_t *channel,
@@ -142,10 +145,12 @@ int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,
 		zbx_async_resolve_reverse_dns_t resolve_reverse_dns);
 
 typedef struct zbx_async_manager	zbx_async_manager_t;
+typedef struct zbx_async_concurrency	zbx_async_concurrency_t;
 
 typedef struct
 {
 	zbx_async_manager_t	*manager;
+	zbx_async_concurrency_t	*concurrency;
 	const zbx_thread_info_t	*info;
 	int			state;
 	int			clear_cache;
@@ -158,6 +163,7 @@ typedef struct
 	int			config_unreachable_delay;
 	int			config_unreachable_period;
 	int			config_max_concurrent_checks_per_poller;
+	int			config_snmp_max_repetitions_tuning;
 	int			config_timeout;
 	const char		*config_source_ip;
 	const char		*config_ssl_ca_location;
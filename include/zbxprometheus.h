@@ -57,6 +57,7 @@ zbx_prometheus_t;
 
 int	zbx_prometheus_init(zbx_prometheus_t *prom, const char *data, char **error);
 void	zbx_prometheus_clear(zbx_prometheus_t *prom);
+size_t	zbx_prometheus_get_size(const zbx_prometheus_t *prom);
 int	zbx_prometheus_pattern_ex(zbx_prometheus_t *prom, const char *filter_data, const char *request,
 		const char *output, char **value, char **error);
 
@@ -78,5 +78,6 @@ int	zbx_wildcard_match(const char *value, const char *wildcard);
 
 void	zbx_init_regexp_env(void);
 void	zbx_deinit_regexp_env(void);
+void	zbx_regexp_cache_get_stats(zbx_uint64_t *hits, zbx_uint64_t *misses);
 
 #endif /* ZABBIX_ZBXREGEXP_H */
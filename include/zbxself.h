@@ -22,17 +22,30 @@
 
 #define ZBX_SELFMON_DELAY		1
 
+/* process local counters published to self-monitoring collector */
+#define ZBX_SELFMON_COUNTER_RECV_PEAK_UNENCRYPTED	0
+#define ZBX_SELFMON_COUNTER_RECV_PEAK_PSK		1
+#define ZBX_SELFMON_COUNTER_RECV_PEAK_CERT		2
+#define ZBX_SELFMON_COUNTER_REGEXP_CACHE_HITS		3
+#define ZBX_SELFMON_COUNTER_REGEXP_CACHE_MISSES		4
+#define ZBX_SELFMON_COUNTER_COUNT			5
+
 #ifndef _WINDOWS
 #include "zbxthreads.h"
 #include "zbxstats.h"
 
 ZBX_THREAD_ENTRY(zbx_selfmon_thread, args);
 
-int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, char **error);
+typedef void	(*zbx_get_selfmon_counters_f)(zbx_uint64_t *counters);
+
+int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, zbx_get_selfmon_counters_f get_counters,
+		char **error);
 void	zbx_free_selfmon_collector(void);
 void	zbx_update_selfmon_counter(const zbx_thread_info_t *info, unsigned char state);
 void	zbx_get_selfmon_stats(unsigned char proc_type, unsigned char aggr_func, int proc_num, unsigned char state,
 		double *value);
+int	zbx_get_selfmon_counter(unsigned char proc_type, unsigned char aggr_func, int proc_num, int counter,
+		zbx_uint64_t *value);
 int	zbx_get_all_process_stats(zbx_process_info_t *stats);
 void	zbx_sleep_loop(const zbx_thread_info_t *info, int sleeptime);
 #endif
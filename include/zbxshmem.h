@@ -23,6 +23,13 @@
 #define SHMEM_MAX_BUCKET_SIZE		256 /* starting from this size all free chunks are put into the same bucket */
 #define ZBX_SHMEM_BUCKET_COUNT		((SHMEM_MAX_BUCKET_SIZE - ZBX_SHMEM_MIN_BUCKET_SIZE) / 8 + 1)
 
+/* in slab mode allocations up to SHMEM_MAX_BUCKET_SIZE bytes are served from fixed size classes */
+#define ZBX_SHMEM_SLAB_CLASS_COUNT	ZBX_SHMEM_BUCKET_COUNT
+
+/* shared memory allocator modes */
+#define ZBX_SHMEM_MODE_DEFAULT	0
+#define ZBX_SHMEM_MODE_SLAB	1
+
 typedef struct
 {
 	void		*base;
@@ -41,6 +48,11 @@ typedef struct
 	char		allow_oom;
 	void		(*unlock_shmem_on_oom)(void);
 
+	/* slab size classes, NULL if slab mode is not enabled */
+	void		*slab_classes;
+	/* memory used by slab headers, object headers and unused slab tails */
+	zbx_uint64_t	slab_overhead;
+
 	const char	*mem_descr;
 	const char	*mem_param;
 }
@@ -56,11 +68,18 @@ typedef struct
 	unsigned int	chunks_num[ZBX_SHMEM_BUCKET_COUNT];
 	unsigned int	free_chunks;
 	unsigned int	used_chunks;
+
+	/* slab mode statistics */
+	unsigned int	slabs_num;
+	unsigned int	slab_used_num[ZBX_SHMEM_SLAB_CLASS_COUNT];
+	unsigned int	slab_free_num[ZBX_SHMEM_SLAB_CLASS_COUNT];
 }
 zbx_shmem_stats_t;
 
 int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error);
+int	zbx_shmem_create_ext(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
+		int allow_oom, int mode, char **error);
 int	zbx_shmem_create_min(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error);
 void	zbx_shmem_destroy(zbx_shmem_info_t *info);
@@ -54,6 +54,7 @@ typedef struct
 	const char				*config_webdriver_url;
 	zbx_trapper_process_request_func_t	trapper_process_request_func_cb;
 	zbx_autoreg_update_host_func_t		autoreg_update_host_cb;
+	int					config_max_concurrent_connections_per_trapper;
 }
 zbx_thread_trapper_args;
 
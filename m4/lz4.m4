@@ -0,0 +1,120 @@
+# LZ4_CHECK_CONFIG ([DEFAULT-ACTION])
+# ----------------------------------------------------------
+#
+# Checks for LZ4.
+#
+# This macro #defines HAVE_LZ4 if required header files and library are
+# found, and sets @LZ4_LDFLAGS@ and @LZ4_CFLAGS@ to the necessary
+# values.
+#
+# This macro is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+AC_DEFUN([LZ4_TRY_LINK],
+[
+found_lz4=$1
+AC_LINK_IFELSE([AC_LANG_PROGRAM([[
+#include <lz4.h>
+]], [[
+	char	buf[64];
+
+	LZ4_compress_fast_extState(NULL, "", buf, 0, sizeof(buf), 1);
+	LZ4_sizeofState();
+]])],[found_lz4="yes"],[])
+])dnl
+
+AC_DEFUN([LZ4_CHECK_CONFIG],
+[
+	want_lz4="no"
+	AC_ARG_WITH([lz4],[
+If you want to use LZ4 compression library:
+AS_HELP_STRING([--with-lz4@<:@=DIR@:>@], [use LZ4 library @<:@default=no@:>@, optionally from given base install directory (DIR)])],
+		[
+			if test "x$withval" = "xyes"; then
+				want_lz4="yes"
+			elif test "x$withval" != "xno"; then
+				want_lz4="yes"
+				LZ4_CFLAGS="-I$withval/include"
+				LZ4_LDFLAGS="-L$withval/lib"
+				_lz4_dir_set="yes"
+			fi
+		]
+	)
+
+	AC_ARG_WITH([lz4-include],
+		AS_HELP_STRING([--with-lz4-include=DIR],
+			[use LZ4 include headers from given path.]
+		),
+		[
+			LZ4_CFLAGS="-I$withval"
+			_lz4_dir_set="yes"
+			want_lz4="yes"
+		]
+	)
+
+	AC_ARG_WITH([lz4-lib],
+		AS_HELP_STRING([--with-lz4-lib=DIR],
+			[use LZ4 libraries from given path.]
+		),
+		[
+			LZ4_LDFLAGS="-L$withval"
+			_lz4_dir_set="yes"
+			want_lz4="yes"
+		]
+	)
+
+	if test "x$want_lz4" != "xno"; then
+		AC_MSG_CHECKING(for LZ4 support)
+
+		LZ4_LIBS="-llz4"
+
+		if test -n "$_lz4_dir_set" -o -f /usr/include/lz4.h; then
+			found_lz4="yes"
+		elif test -f /usr/local/include/lz4.h; then
+			LZ4_CFLAGS="-I/usr/local/include"
+			LZ4_LDFLAGS="-L/usr/local/lib"
+			found_lz4="yes"
+		elif test -f /usr/pkg/include/lz4.h; then
+			LZ4_CFLAGS="-I/usr/pkg/include"
+			LZ4_LDFLAGS="-L/usr/pkg/lib"
+			found_lz4="yes"
+		elif test -f /opt/homebrew/include/lz4.h; then
+			LZ4_CFLAGS="-I/opt/homebrew/include"
+			LZ4_LDFLAGS="-L/opt/homebrew/lib"
+			found_lz4="yes"
+		else
+			found_lz4="no"
+			AC_MSG_RESULT(no)
+		fi
+
+		if test "x$found_lz4" = "xyes"; then
+			am_save_CFLAGS="$CFLAGS"
+			am_save_LDFLAGS="$LDFLAGS"
+			am_save_LIBS="$LIBS"
+
+			CFLAGS="$CFLAGS $LZ4_CFLAGS"
+			LDFLAGS="$LDFLAGS $LZ4_LDFLAGS"
+			LIBS="$LIBS $LZ4_LIBS"
+
+			LZ4_TRY_LINK([no])
+
+			CFLAGS="$am_save_CFLAGS"
+			LDFLAGS="$am_save_LDFLAGS"
+			LIBS="$am_save_LIBS"
+		fi
+
+		if test "x$found_lz4" = "xyes"; then
+			AC_DEFINE([HAVE_LZ4], 1, [Define to 1 if you have the 'LZ4' library (-llz4)])
+			AC_MSG_RESULT(yes)
+		else
+			LZ4_CFLAGS=""
+			LZ4_LDFLAGS=""
+			LZ4_LIBS=""
+		fi
+
+		AC_SUBST(LZ4_CFLAGS)
+		AC_SUBST(LZ4_LDFLAGS)
+		AC_SUBST(LZ4_LIBS)
+	fi
+])dnl
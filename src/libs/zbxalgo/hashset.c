@@ -482,6 +482,23 @@ const void	*zbx_hashset_const_iter_next(zbx_hashset_const_iter_t *iter)
 	}
 }
 
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get memory allocated for hashset slots and fixed size entries        *
+ *                                                                               *
+ * Parameters:  hs   - [IN] hashset                                              *
+ *              size - [IN] hashset entry data size                              *
+ *                                                                               *
+ * Return value: The allocated memory size, excluding memory referenced by       *
+ *               entry data.                                                     *
+ *                                                                               *
+ *********************************************************************************/
+size_t	zbx_hashset_get_size(const zbx_hashset_t *hs, size_t size)
+{
+	return (size_t)hs->num_slots * sizeof(ZBX_HASHSET_ENTRY_T *) +
+			(size_t)hs->num_data * (ZBX_HASHSET_ENTRY_OFFSET + size);
+}
+
 /*********************************************************************************
  *                                                                               *
  * Purpose: copy hashset with fixed size entries                                 *
@@ -51,6 +51,7 @@
 #include "zbxkvs.h"
 #include "zbxcachevalue.h"
 #include "zbxcomms.h"
+#include "zbxcompress.h"
 #include "zbxdb.h"
 #include "zbxmutexs.h"
 #include "zbxpgservice.h"
@@ -154,14 +155,28 @@ static int	dc_item_ref_compare(const void *d1, const void *d2)
 }
 
 static int	sync_in_progress = 0;
+static double	sync_lock_start, sync_lock_hold;
 
 int	zbx_get_sync_in_progress(void)
 {
 	return sync_in_progress;
 }
 
-#define START_SYNC	do { WRLOCK_CACHE_CONFIG_HISTORY; WRLOCK_CACHE; sync_in_progress = 1; } while(0)
-#define FINISH_SYNC	do { sync_in_progress = 0; UNLOCK_CACHE; UNLOCK_CACHE_CONFIG_HISTORY; } while(0)
+/* hot lookups check sync_writer to avoid waiting while syncer holds or waits for the write lock */
+#define START_SYNC	do { config->sync_writer = 1; WRLOCK_CACHE_CONFIG_HISTORY; WRLOCK_CACHE;		\
+				sync_in_progress = 1; sync_lock_start = zbx_time(); } while(0)
+#define FINISH_SYNC	do { sync_lock_hold = MAX(sync_lock_hold, zbx_time() - sync_lock_start);		\
+				sync_in_progress = 0; UNLOCK_CACHE; UNLOCK_CACHE_CONFIG_HISTORY;		\
+				config->sync_writer = 0; } while(0)
+
+/* lookup lock waits shorter than this are not counted as stalls */
+#define ZBX_CONFIG_LOCK_STALL_MIN	0.001
+
+/* maximum number of items kept in process local snapshot */
+#define ZBX_DC_ITEM_SNAPSHOT_MAX	64
+
+#define ZBX_DC_LOCK_READ	0
+#define ZBX_DC_LOCK_WRITE	1
 
 #define ZBX_SNMP_OID_TYPE_NORMAL	0
 #define ZBX_SNMP_OID_TYPE_DYNAMIC	1
@@ -229,6 +244,7 @@ void	set_dc_config(zbx_dc_config_t *in)
 }
 
 static zbx_rwlock_t	config_lock = ZBX_RWLOCK_NULL;
+static zbx_mutex_t	config_stats_lock = ZBX_MUTEX_NULL;
 static int		wlock_is_locked;
 
 zbx_rwlock_t	zbx_get_config_lock(void)
@@ -251,6 +267,83 @@ void	zbx_config_wlock_set_unlocked(void)
 	wlock_is_locked = 0;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stores the longest configuration cache write lock hold time of    *
+ *          the last sync and resets it for the next sync                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_sync_lock_hold_flush(void)
+{
+	config->sync_lock_hold = sync_lock_hold;
+	sync_lock_hold = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if configuration syncer holds or waits for the write lock  *
+ *                                                                            *
+ * Return value: SUCCEED - lookups should not wait for the lock               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The flag is read without locking, so a lookup started just       *
+ *           before the sync may still wait for it.                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_sync_writer_active(void)
+{
+	if (0 != zbx_get_sync_in_progress() || 0 == config->sync_writer)
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locks configuration cache for a hot lookup and accounts the time  *
+ *          spent waiting for the lock                                        *
+ *                                                                            *
+ * Parameters: mode - [IN] ZBX_DC_LOCK_READ or ZBX_DC_LOCK_WRITE              *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_config_lock_timed(int mode)
+{
+	double	wait;
+
+	if (0 != zbx_get_sync_in_progress())
+		return;
+
+	wait = zbx_time();
+
+	if (ZBX_DC_LOCK_WRITE == mode)
+	{
+		zbx_rwlock_wrlock(config_lock);
+		zbx_config_wlock_set_locked();
+	}
+	else
+		zbx_rwlock_rdlock(config_lock);
+
+	if (ZBX_CONFIG_LOCK_STALL_MIN > (wait = zbx_time() - wait))
+		return;
+
+	zbx_mutex_lock(config_stats_lock);
+	config->lock_stats.stall_time += wait;
+	config->lock_stats.stalls++;
+	zbx_mutex_unlock(config_stats_lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: accounts a hot lookup that did not wait for configuration sync    *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_config_lock_bypass(void)
+{
+	zbx_mutex_lock(config_stats_lock);
+	config->lock_stats.bypasses++;
+	zbx_mutex_unlock(config_stats_lock);
+}
+
 static zbx_rwlock_t	config_history_lock = ZBX_RWLOCK_NULL;
 
 zbx_rwlock_t	zbx_get_config_history_lock(void)
@@ -7400,6 +7493,7 @@ static void	DCsync_proxies(zbx_dbsync_t *sync, zbx_uint64_t revision, const zbx_
 			proxy->lastaccess = (SUCCEED != zbx_db_is_null(row[12]) ? atoi(row[12]) : 0);
 			proxy->last_cfg_error_time = 0;
 			proxy->proxy_delay = 0;
+			proxy->compress_codec = ZBX_COMPRESS_ZLIB;
 			proxy->nodata_win.flags = ZBX_PROXY_SUPPRESS_DISABLE;
 			proxy->nodata_win.values_num = 0;
 			proxy->nodata_win.period_end = 0;
@@ -7695,7 +7789,7 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	zbx_dbsync_init(&hmacro_sync, "hostmacro", mode);
 	zbx_dbsync_init(&if_sync, "interface", mode);
 	zbx_dbsync_init_changelog(&items_sync, "items", changelog_sync_mode);
-	zbx_dbsync_init(&item_discovery_sync, "item_discovery", mode);
+	zbx_dbsync_init(&item_discovery_sync, "item_discovery", changelog_sync_mode);
 	zbx_dbsync_init_changelog(&triggers_sync, "triggers", changelog_sync_mode);
 	zbx_dbsync_init(&tdep_sync, "trigger_depends", mode);
 	zbx_dbsync_init_changelog(&func_sync, "functions", changelog_sync_mode);
@@ -8202,6 +8296,8 @@ out:
 
 	FINISH_SYNC;
 
+	dc_sync_lock_hold_flush();
+
 	switch (dberr)
 	{
 		case ZBX_DB_OK:
@@ -8712,6 +8808,13 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	if (SUCCEED != vps_monitor_create(&config->vps_monitor, error))
 		goto out;
 
+	if (SUCCEED != (ret = zbx_mutex_create(&config_stats_lock, ZBX_MUTEX_CONFIG_STATS, error)))
+		goto out;
+
+	config->sync_lock_hold = 0;
+	config->sync_writer = 0;
+	memset(&config->lock_stats, 0, sizeof(config->lock_stats));
+
 #define CREATE_HASHSET(hashset, hashset_size)									\
 														\
 	CREATE_HASHSET_EXT(hashset, hashset_size, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC)
@@ -8931,6 +9034,7 @@ void	zbx_free_configuration_cache(void)
 	UNLOCK_CACHE;
 
 	vps_monitor_destroy();
+	zbx_mutex_destroy(&config_stats_lock);
 
 	zbx_shmem_destroy(config_mem);
 	config_mem = NULL;
@@ -9867,6 +9971,186 @@ void	zbx_dc_config_get_items_by_keys(zbx_dc_item_t *items, zbx_host_key_t *keys,
 	UNLOCK_CACHE;
 }
 
+/* process local copy of item, taken at the specified configuration revision */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	zbx_uint64_t	revision;
+	zbx_dc_item_t	*item;
+}
+zbx_dc_item_snapshot_t;
+
+static zbx_hashset_t	dc_item_snapshots;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copies item retrieved from configuration cache                    *
+ *                                                                            *
+ * Parameters: dst - [OUT] item copy, must be freed with                      *
+ *                         zbx_dc_config_clean_items()                        *
+ *             src - [IN] item retrieved by DCget_item()                      *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_copy(zbx_dc_item_t *dst, const zbx_dc_item_t *src)
+{
+	memcpy(dst, src, sizeof(zbx_dc_item_t));
+
+	dst->interface.addr = (1 == dst->interface.useip ? dst->interface.ip_orig : dst->interface.dns_orig);
+	dst->delay = zbx_strdup(NULL, src->delay);
+
+	switch (src->type)
+	{
+		case ITEM_TYPE_HTTPAGENT:
+			dst->headers = zbx_strdup(NULL, src->headers);
+			dst->posts = zbx_strdup(NULL, src->posts);
+			break;
+		case ITEM_TYPE_SCRIPT:
+		case ITEM_TYPE_BROWSER:
+			zbx_vector_ptr_pair_create(&dst->script_params);
+			for (int i = 0; i < src->script_params.values_num; i++)
+			{
+				zbx_ptr_pair_t	pair;
+
+				pair.first = zbx_strdup(NULL, src->script_params.values[i].first);
+				pair.second = zbx_strdup(NULL, src->script_params.values[i].second);
+				zbx_vector_ptr_pair_append(&dst->script_params, pair);
+			}
+			ZBX_FALLTHROUGH;
+		case ITEM_TYPE_DB_MONITOR:
+		case ITEM_TYPE_SSH:
+		case ITEM_TYPE_TELNET:
+			dst->params = zbx_strdup(NULL, src->params);
+			break;
+		case ITEM_TYPE_CALCULATED:
+			dst->params = zbx_strdup(NULL, src->params);
+			dst->formula_bin = dup_serialized_expression(src->formula_bin);
+			break;
+	}
+}
+
+static void	dc_item_snapshot_clean(void *data)
+{
+	zbx_dc_item_snapshot_t	*snapshot = (zbx_dc_item_snapshot_t *)data;
+
+	zbx_dc_config_clean_items(snapshot->item, NULL, 1);
+	zbx_free(snapshot->item);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copies items from process local snapshot                          *
+ *                                                                            *
+ * Parameters: items    - [OUT] items                                         *
+ *             itemids  - [IN] item IDs                                       *
+ *             errcodes - [OUT] SUCCEED for all items if snapshot is used     *
+ *             num      - [IN] number of items                                *
+ *                                                                            *
+ * Return value: SUCCEED - all items were copied from snapshot                *
+ *               FAIL    - some item is not in snapshot or was copied at      *
+ *                         older configuration revision                       *
+ *                                                                            *
+ * Comments: Snapshot copies are taken after the last finished sync, so while *
+ *           the next sync is in progress they match what readers would have  *
+ *           seen before the sync started.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_item_snapshot_get(zbx_dc_item_t *items, const zbx_uint64_t *itemids, int *errcodes, size_t num)
+{
+	zbx_uint64_t		revision = config->revision.config;
+	zbx_dc_item_snapshot_t	*snapshot;
+	size_t			i;
+
+	if (0 == dc_item_snapshots.num_slots || ZBX_DC_ITEM_SNAPSHOT_MAX < num)
+		return FAIL;
+
+	for (i = 0; i < num; i++)
+	{
+		if (NULL == (snapshot = (zbx_dc_item_snapshot_t *)zbx_hashset_search(&dc_item_snapshots,
+				&itemids[i])) || revision != snapshot->revision)
+		{
+			return FAIL;
+		}
+	}
+
+	for (i = 0; i < num; i++)
+	{
+		snapshot = (zbx_dc_item_snapshot_t *)zbx_hashset_search(&dc_item_snapshots, &itemids[i]);
+		dc_item_copy(&items[i], snapshot->item);
+		errcodes[i] = SUCCEED;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates process local snapshot with items retrieved from          *
+ *          configuration cache                                               *
+ *                                                                            *
+ * Parameters: items    - [IN] items                                          *
+ *             errcodes - [IN] item error codes                               *
+ *             num      - [IN] number of items                                *
+ *             revision - [IN] configuration revision the items were          *
+ *                             retrieved at                                   *
+ *                                                                            *
+ * Comments: Items are copied at most once per configuration revision. When   *
+ *           the snapshot is full, copies of older revisions are dropped and  *
+ *           new items are not added if there is still no room.               *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_snapshot_update(const zbx_dc_item_t *items, const int *errcodes, size_t num,
+		zbx_uint64_t revision)
+{
+	if (0 == dc_item_snapshots.num_slots)
+	{
+		zbx_hashset_create_ext(&dc_item_snapshots, ZBX_DC_ITEM_SNAPSHOT_MAX, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC, dc_item_snapshot_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+
+	for (size_t i = 0; i < num; i++)
+	{
+		zbx_dc_item_snapshot_t	*snapshot, snapshot_local;
+
+		if (SUCCEED != errcodes[i])
+			continue;
+
+		if (NULL != (snapshot = (zbx_dc_item_snapshot_t *)zbx_hashset_search(&dc_item_snapshots,
+				&items[i].itemid)))
+		{
+			if (revision == snapshot->revision)
+				continue;
+
+			zbx_dc_config_clean_items(snapshot->item, NULL, 1);
+		}
+		else
+		{
+			if (ZBX_DC_ITEM_SNAPSHOT_MAX <= dc_item_snapshots.num_data)
+			{
+				zbx_hashset_iter_t	iter;
+
+				zbx_hashset_iter_reset(&dc_item_snapshots, &iter);
+				while (NULL != (snapshot = (zbx_dc_item_snapshot_t *)zbx_hashset_iter_next(&iter)))
+				{
+					if (revision != snapshot->revision)
+						zbx_hashset_iter_remove(&iter);
+				}
+
+				if (ZBX_DC_ITEM_SNAPSHOT_MAX <= dc_item_snapshots.num_data)
+					return;
+			}
+
+			snapshot_local.itemid = items[i].itemid;
+			snapshot_local.item = (zbx_dc_item_t *)zbx_malloc(NULL, sizeof(zbx_dc_item_t));
+			snapshot = (zbx_dc_item_snapshot_t *)zbx_hashset_insert(&dc_item_snapshots, &snapshot_local,
+					sizeof(snapshot_local));
+		}
+
+		snapshot->revision = revision;
+		dc_item_copy(snapshot->item, &items[i]);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Get item with specified ID                                        *
@@ -9876,14 +10160,25 @@ void	zbx_dc_config_get_items_by_keys(zbx_dc_item_t *items, zbx_host_key_t *keys,
  *             errcodes - [OUT] SUCCEED if item found, otherwise FAIL         *
  *             num      - [IN] number of elements                             *
  *                                                                            *
+ * Comments: While configuration syncer holds or waits for the write lock     *
+ *           items are copied from process local snapshot if all of them are  *
+ *           there, otherwise the lookup waits for the lock.                  *
+ *                                                                            *
  ******************************************************************************/
 void	zbx_dc_config_get_items_by_itemids(zbx_dc_item_t *items, const zbx_uint64_t *itemids, int *errcodes, size_t num)
 {
 	size_t			i;
 	const ZBX_DC_ITEM	*dc_item;
 	const ZBX_DC_HOST	*dc_host;
+	zbx_uint64_t		revision;
 
-	RDLOCK_CACHE;
+	if (SUCCEED == dc_sync_writer_active() && SUCCEED == dc_item_snapshot_get(items, itemids, errcodes, num))
+	{
+		dc_config_lock_bypass();
+		return;
+	}
+
+	dc_config_lock_timed(ZBX_DC_LOCK_READ);
 
 	for (i = 0; i < num; i++)
 	{
@@ -9899,7 +10194,11 @@ void	zbx_dc_config_get_items_by_itemids(zbx_dc_item_t *items, const zbx_uint64_t
 		errcodes[i] = SUCCEED;
 	}
 
+	revision = config->revision.config;
+
 	UNLOCK_CACHE;
+
+	dc_item_snapshot_update(items, errcodes, num, revision);
 }
 
 int	zbx_dc_config_get_active_items_count_by_hostid(zbx_uint64_t hostid)
@@ -10460,6 +10759,10 @@ void	zbx_dc_config_clean_triggers(zbx_dc_trigger_t *triggers, int *errcodes, siz
  *           case configuration changes. On a stable configuration, it should *
  *           work without any problems.                                       *
  *                                                                            *
+ *           While configuration syncer holds or waits for the write lock all *
+ *           items are marked as busy, so history syncer returns them to      *
+ *           history cache instead of waiting for the sync to finish.         *
+ *                                                                            *
  * Return value: the number of items available for processing (unlocked).     *
  *                                                                            *
  ******************************************************************************/
@@ -10471,7 +10774,17 @@ int	zbx_dc_config_lock_triggers_by_history_items(zbx_vector_hc_item_ptr_t *histo
 	ZBX_DC_TRIGGER		*dc_trigger;
 	zbx_hc_item_t		*history_item;
 
-	WRLOCK_CACHE;
+	if (SUCCEED == dc_sync_writer_active())
+	{
+		for (i = 0; i < history_items->values_num; i++)
+			history_items->values[i]->status = ZBX_HC_ITEM_STATUS_BUSY;
+
+		dc_config_lock_bypass();
+
+		return 0;
+	}
+
+	dc_config_lock_timed(ZBX_DC_LOCK_WRITE);
 
 	for (i = 0; i < history_items->values_num; i++)
 	{
@@ -11309,12 +11622,19 @@ int	zbx_dc_config_get_poller_nextcheck(unsigned char poller_type)
 
 	queue = &config->queues[poller_type];
 
+	/* queue is not inspected during sync, poll again after a second */
+	if (SUCCEED == dc_sync_writer_active())
+	{
+		nextcheck = (int)time(NULL) + 1;
+		goto out;
+	}
+
 	RDLOCK_CACHE;
 
 	nextcheck = dc_config_get_queue_nextcheck(queue);
 
 	UNLOCK_CACHE;
-
+out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%d", __func__, nextcheck);
 
 	return nextcheck;
@@ -11383,6 +11703,9 @@ static void	dc_requeue_item_at(ZBX_DC_ITEM *dc_item, ZBX_DC_HOST *dc_host, time_
  *           IPMI poller queue are handled by                                 *
  *           zbx_dc_config_get_ipmi_poller_items() function.                  *
  *                                                                            *
+ *           While configuration syncer holds or waits for the write lock no  *
+ *           items are returned, they stay in the queue until the next call.  *
+ *                                                                            *
  ******************************************************************************/
 int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout, int processing,
 		int config_max_concurrent_checks, zbx_dc_item_t **items)
@@ -11396,6 +11719,12 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 
 	queue = &config->queues[poller_type];
 
+	if (SUCCEED == dc_sync_writer_active())
+	{
+		dc_config_lock_bypass();
+		goto out;
+	}
+
 	switch (poller_type)
 	{
 		case ZBX_POLLER_TYPE_JAVA:
@@ -11407,7 +11736,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 		case ZBX_POLLER_TYPE_HTTPAGENT:
 		case ZBX_POLLER_TYPE_AGENT:
 		case ZBX_POLLER_TYPE_SNMP:
-			if (0 == (max_items = config_max_concurrent_checks - processing))
+			if (0 >= (max_items = config_max_concurrent_checks - processing))
 				goto out;
 
 			items_alloc = max_items;
@@ -11417,7 +11746,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 			max_items = 1;
 	}
 
-	WRLOCK_CACHE;
+	dc_config_lock_timed(ZBX_DC_LOCK_WRITE);
 
 	while (num < max_items && FAIL == zbx_binary_heap_empty(queue))
 	{
@@ -12494,6 +12823,24 @@ void	*zbx_dc_config_get_stats(int request)
 		case ZBX_CONFSTATS_BUFFER_PFREE:
 			value_double = 100 * (double)config_mem->free_size / config_mem->orig_size;
 			return &value_double;
+		case ZBX_CONFSTATS_LOCK_HOLD:
+			value_double = config->sync_lock_hold;
+			return &value_double;
+		case ZBX_CONFSTATS_LOCK_STALL:
+			zbx_mutex_lock(config_stats_lock);
+			value_double = config->lock_stats.stall_time;
+			zbx_mutex_unlock(config_stats_lock);
+			return &value_double;
+		case ZBX_CONFSTATS_LOCK_STALLS:
+			zbx_mutex_lock(config_stats_lock);
+			value_uint = config->lock_stats.stalls;
+			zbx_mutex_unlock(config_stats_lock);
+			return &value_uint;
+		case ZBX_CONFSTATS_LOCK_BYPASSES:
+			zbx_mutex_lock(config_stats_lock);
+			value_uint = config->lock_stats.bypasses;
+			zbx_mutex_unlock(config_stats_lock);
+			return &value_uint;
 		default:
 			return NULL;
 	}
@@ -12512,6 +12859,7 @@ static void	DCget_proxy(zbx_dc_proxy_t *dst_proxy, const ZBX_DC_PROXY *src_proxy
 	dst_proxy->compatibility = src_proxy->compatibility;
 	dst_proxy->lastaccess = src_proxy->lastaccess;
 	dst_proxy->last_version_error_time = src_proxy->last_version_error_time;
+	dst_proxy->compress_codec = src_proxy->compress_codec;
 
 	zbx_strscpy(dst_proxy->name, src_proxy->name);
 	zbx_strscpy(dst_proxy->allowed_addresses, src_proxy->allowed_addresses);
@@ -15132,6 +15480,12 @@ void	zbx_dc_update_proxy(zbx_proxy_diff_t *diff)
 			diff->flags &= (~ZBX_FLAGS_PROXY_DIFF_UPDATE_PROXYDELAY);
 		}
 
+		if (0 != (diff->flags & ZBX_FLAGS_PROXY_DIFF_UPDATE_COMPRESS))
+		{
+			proxy->compress_codec = diff->compress;
+			diff->flags &= (~ZBX_FLAGS_PROXY_DIFF_UPDATE_COMPRESS);
+		}
+
 		if (0 != (diff->flags & ZBX_FLAGS_PROXY_DIFF_UPDATE_SUPPRESS_WIN))
 		{
 			zbx_proxy_suppress_t	*ps_win = &proxy->nodata_win, *ds_win = &diff->nodata_win;
@@ -495,6 +495,7 @@ typedef struct
 	unsigned char			location;
 	const char			*allowed_addresses;
 	int				last_version_error_time;
+	unsigned char			compress_codec;		/* codec for data sent to passive proxy */
 	zbx_uint64_t			revision;
 
 	zbx_vector_dc_host_ptr_t	hosts;
@@ -971,6 +972,15 @@ typedef struct
 }
 zbx_dc_host_proxy_index_t;
 
+/* configuration cache lock statistics of hot lookups */
+typedef struct
+{
+	double		stall_time;	/* total time lookups waited for configuration cache lock     */
+	zbx_uint64_t	stalls;		/* number of lock waits longer than stall threshold          */
+	zbx_uint64_t	bypasses;	/* number of lookups that did not wait for configuration sync */
+}
+zbx_dc_lock_stats_t;
+
 typedef struct
 {
 	/* timestamp of the last host availability diff sent to sever, used only by proxies */
@@ -1065,6 +1075,9 @@ typedef struct
 	char			autoreg_psk_identity[HOST_TLS_PSK_IDENTITY_LEN_MAX];	/* autoregistration PSK */
 	char			autoreg_psk[HOST_TLS_PSK_LEN_MAX];
 	zbx_vps_monitor_t	vps_monitor;
+	double			sync_lock_hold;	/* longest write lock hold time during the last sync */
+	int			sync_writer;	/* configuration syncer holds or waits for write lock */
+	zbx_dc_lock_stats_t	lock_stats;
 	char			*proxy_hostname;	/* hostname - proxy only */
 	int			proxy_failover_delay;		/* proxy group failover delay - proxy only    */
 	const char		*proxy_failover_delay_raw;	/* raw failover delay value - proxy only      */
@@ -662,6 +662,31 @@ static int	dbsync_read_journal(zbx_dbsync_t *sync, char **sql, size_t *sql_alloc
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets identifiers of all objects registered in changelog journal   *
+ *                                                                            *
+ * Parameters: journal   - [IN] changelog journal                             *
+ *             objectids - [OUT] sorted object identifiers                    *
+ *                                                                            *
+ * Comments: The identifiers are taken from changelog records rather than     *
+ *           insert/update/delete lists, because the latter are consumed by   *
+ *           the owning object synchronization.                               *
+ *                                                                            *
+ ******************************************************************************/
+static void	dbsync_get_journal_objectids(const zbx_dbsync_journal_t *journal, zbx_vector_uint64_t *objectids)
+{
+	int	i;
+
+	zbx_vector_uint64_reserve(objectids, (size_t)journal->changelog.values_num);
+
+	for (i = 0; i < journal->changelog.values_num; i++)
+		zbx_vector_uint64_append(objectids, journal->changelog.values[i].objectid);
+
+	zbx_vector_uint64_sort(objectids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(objectids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: initializes changeset                                             *
@@ -1743,6 +1768,8 @@ static char	**dbsync_item_preproc_row(zbx_dbsync_t *sync, char **row)
 			zbx_eval_set_exception(&ctx, zbx_dsprintf(NULL, "Cannot parse formula: %s", error));
 			zbx_free(error);
 		}
+		else
+			zbx_eval_fold_constants(&ctx);
 
 		row[49] = encode_expression(&ctx);
 		zbx_eval_clear(&ctx);
@@ -1807,71 +1834,121 @@ static int	dbsync_compare_item_discovery(const ZBX_DC_ITEM_DISCOVERY *item_disco
 
 /******************************************************************************
  *                                                                            *
- * Purpose: compares mapping between items, prototypes and rules with         *
- *          configuration cache                                               *
+ * Purpose: compares item discovery mapping of items registered in item      *
+ *          changelog with configuration cache                                *
  *                                                                            *
  * Return value: SUCCEED - the changeset was successfully calculated          *
  *               FAIL    - otherwise                                          *
  *                                                                            *
+ * Comments: Item discovery records are created and removed together with     *
+ *           the items they belong to, so only items registered in changelog  *
+ *           since the last sync must be checked.                             *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_dbsync_compare_item_discovery(zbx_dbsync_t *sync)
+static int	dbsync_compare_item_discovery_journal(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
-	zbx_hashset_iter_t	iter;
-	zbx_uint64_t		rowid;
+	zbx_vector_uint64_t	itemids, read_ids;
+	zbx_uint64_t		rowid, *batch;
 	ZBX_DC_ITEM_DISCOVERY	*item_discovery;
-	char			**row;
-
-	zbx_dcsync_sql_start(sync);
+	char			**row, *sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
+	int			i, batch_size, ret = SUCCEED;
 
-	if (NULL == (result = zbx_db_select("select itemid,parent_itemid from item_discovery")))
-		return FAIL;
+	zbx_vector_uint64_create(&itemids);
+	zbx_vector_uint64_create(&read_ids);
 
-	dbsync_prepare(sync, 2, NULL);
+	dbsync_get_journal_objectids(&dbsync_env.journals[ZBX_DBSYNC_JOURNAL(ZBX_DBSYNC_OBJ_ITEM)], &itemids);
 
-	if (ZBX_DBSYNC_INIT == sync->mode)
+	for (batch = itemids.values; batch < itemids.values + itemids.values_num; batch += ZBX_DBSYNC_BATCH_SIZE)
 	{
-		zbx_dcsync_sql_end(sync);
-		sync->dbresult = result;
-		return SUCCEED;
-	}
+		batch_size = MIN(ZBX_DBSYNC_BATCH_SIZE, itemids.values + itemids.values_num - batch);
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->item_discovery.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		sql_offset = 0;
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select itemid,parent_itemid from item_discovery where");
+		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", batch, batch_size);
 
-	while (NULL != (dbrow = zbx_db_fetch(result)))
-	{
-		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
+		if (NULL == (result = zbx_db_select("%s", sql)))
+		{
+			ret = FAIL;
+			goto out;
+		}
 
-		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		while (NULL != (dbrow = zbx_db_fetch(result)))
+		{
+			unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
-		row = dbsync_preproc_row(sync, dbrow);
+			ZBX_STR2UINT64(rowid, dbrow[0]);
+			zbx_vector_uint64_append(&read_ids, rowid);
 
-		if (NULL == (item_discovery = (ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_search(
-				&dbsync_env.cache->item_discovery, &rowid)))
-		{
-			tag = ZBX_DBSYNC_ROW_ADD;
+			row = dbsync_preproc_row(sync, dbrow);
+
+			if (NULL == (item_discovery = (ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_search(
+					&dbsync_env.cache->item_discovery, &rowid)))
+			{
+				tag = ZBX_DBSYNC_ROW_ADD;
+			}
+			else if (FAIL == dbsync_compare_item_discovery(item_discovery, row))
+				tag = ZBX_DBSYNC_ROW_UPDATE;
+
+			if (ZBX_DBSYNC_ROW_NONE != tag)
+				dbsync_add_row(sync, rowid, tag, row);
 		}
-		else if (FAIL == dbsync_compare_item_discovery(item_discovery, row))
-			tag = ZBX_DBSYNC_ROW_UPDATE;
+		zbx_db_free_result(result);
+	}
 
-		if (ZBX_DBSYNC_ROW_NONE != tag)
-			dbsync_add_row(sync, rowid, tag, row);
+	/* items without discovery record either were removed or never were discovered */
+	zbx_vector_uint64_sort(&read_ids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	dbsync_remove_duplicate_ids(&itemids, &read_ids);
+
+	for (i = 0; i < itemids.values_num; i++)
+	{
+		if (NULL != zbx_hashset_search(&dbsync_env.cache->item_discovery, &itemids.values[i]))
+			dbsync_add_row(sync, itemids.values[i], ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
+out:
+	zbx_free(sql);
+	zbx_vector_uint64_destroy(&read_ids);
+	zbx_vector_uint64_destroy(&itemids);
+
+	return ret;
+}
 
-	zbx_hashset_iter_reset(&dbsync_env.cache->item_discovery, &iter);
-	while (NULL != (item_discovery = (ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_iter_next(&iter)))
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compares mapping between items, prototypes and rules with         *
+ *          configuration cache                                               *
+ *                                                                            *
+ * Return value: SUCCEED - the changeset was successfully calculated          *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: During update only the items registered in changelog are        *
+ *           checked, the whole table is read only during initialization.     *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsync_compare_item_discovery(zbx_dbsync_t *sync)
+{
+	zbx_db_result_t		result;
+	int			ret;
+
+	zbx_dcsync_sql_start(sync);
+
+	dbsync_prepare(sync, 2, NULL);
+
+	if (ZBX_DBSYNC_INIT != sync->mode)
 	{
-		if (NULL == zbx_hashset_search(&ids, &item_discovery->itemid))
-			dbsync_add_row(sync, item_discovery->itemid, ZBX_DBSYNC_ROW_REMOVE, NULL);
+		ret = dbsync_compare_item_discovery_journal(sync);
+		zbx_dcsync_sql_end(sync);
+
+		return ret;
 	}
 
-	zbx_hashset_destroy(&ids);
-	zbx_db_free_result(result);
+	if (NULL == (result = zbx_db_select("select itemid,parent_itemid from item_discovery")))
+		return FAIL;
+
 	zbx_dcsync_sql_end(sync);
+	sync->dbresult = result;
 
 	return SUCCEED;
 }
@@ -1915,6 +1992,8 @@ static char	**dbsync_trigger_preproc_row(zbx_dbsync_t *sync, char **row)
 	{
 		if (SUCCEED == zbx_eval_check_timer_functions(&ctx))
 			timer |= ZBX_TRIGGER_TIMER_EXPRESSION;
+
+		zbx_eval_fold_constants(&ctx);
 	}
 
 	ZBX_STR2UCHAR(mode, row[10]);
@@ -1931,6 +2010,8 @@ static char	**dbsync_trigger_preproc_row(zbx_dbsync_t *sync, char **row)
 		{
 			if (SUCCEED == zbx_eval_check_timer_functions(&ctx_r))
 				timer |= ZBX_TRIGGER_TIMER_RECOVERY_EXPRESSION;
+
+			zbx_eval_fold_constants(&ctx_r);
 		}
 	}
 
@@ -39,18 +39,43 @@
 #include "zbxvariant.h"
 #include "zbxipcservice.h"
 
+/* history cache data and index segments of the currently locked partition, */
+/* used by the history cache shared memory allocation functions            */
 static zbx_shmem_info_t	*hc_index_mem = NULL;
 static zbx_shmem_info_t	*hc_mem = NULL;
 static zbx_shmem_info_t	*trend_mem = NULL;
 
-#define	LOCK_CACHE	zbx_mutex_lock(cache_lock)
-#define	UNLOCK_CACHE	zbx_mutex_unlock(cache_lock)
+static zbx_shmem_info_t	*hc_part_index_mem[ZBX_HC_PARTITIONS_MAX];
+static zbx_shmem_info_t	*hc_part_mem[ZBX_HC_PARTITIONS_MAX];
+static zbx_mutex_t	hc_part_locks[ZBX_HC_PARTITIONS_MAX];
+static int		hc_partitions_num = 0;
+
+/* the partition to start looking for history items to sync from */
+static int		hc_pop_partition = 0;
+
+#define	LOCK_PARTITION(partition)				\
+								\
+do								\
+{								\
+	zbx_mutex_lock(hc_part_locks[partition]);		\
+	hc_mem = hc_part_mem[partition];			\
+	hc_index_mem = hc_part_index_mem[partition];		\
+	hc_part = cache->partitions[partition];			\
+}								\
+while (0)
+
+#define	UNLOCK_PARTITION(partition)	zbx_mutex_unlock(hc_part_locks[partition])
+
+/* the first partition lock also protects the history cache header */
+#define	LOCK_CACHE	LOCK_PARTITION(0)
+#define	UNLOCK_CACHE	UNLOCK_PARTITION(0)
 #define	LOCK_TRENDS	zbx_mutex_lock(trends_lock)
 #define	UNLOCK_TRENDS	zbx_mutex_unlock(trends_lock)
 #define	LOCK_CACHE_IDS		zbx_mutex_lock(cache_ids_lock)
 #define	UNLOCK_CACHE_IDS	zbx_mutex_unlock(cache_ids_lock)
 
-static zbx_mutex_t	cache_lock = ZBX_MUTEX_NULL;
+#define	HC_ITEM_PARTITION(itemid)	((int)((itemid) % (zbx_uint64_t)hc_partitions_num))
+
 static zbx_mutex_t	trends_lock = ZBX_MUTEX_NULL;
 static zbx_mutex_t	cache_ids_lock = ZBX_MUTEX_NULL;
 
@@ -66,6 +91,15 @@ static zbx_sync_history_cache_f	sync_history_cache_cb = NULL;
 
 #define ZBX_TRENDS_CLEANUP_TIME	(SEC_PER_MIN * 55)
 
+/* number of parts the hourly trend flush is split into, 1 - hourly flush is done by one history syncer */
+static int	trends_flush_parts = 1;
+
+/* trends are written with upserts merging values with existing rows instead of fetching and updating them */
+static int	trends_flush_upsert = 0;
+
+/* the hourly trend flush part claimed by this process is being written to database */
+static int	trends_flush_part_claimed = 0;
+
 /* the maximum number of characters for history cache values (except binary) */
 #define ZBX_HISTORY_VALUE_LEN		(1024 * 64)
 
@@ -92,17 +126,36 @@ typedef struct
 }
 zbx_hc_proxyqueue_t;
 
+/* history cache partition, items are assigned to partitions by itemid */
 typedef struct
 {
-	zbx_hashset_t		trends;
 	zbx_dc_stats_t		stats;
 
 	zbx_hashset_t		history_items;
 	zbx_binary_heap_t	history_queue;
 
 	int			history_num;
+	int			processing_num;
+	double			last_error_ts;
+}
+zbx_hc_partition_t;
+
+typedef struct
+{
+	zbx_hashset_t		trends;
+
+	zbx_hc_partition_t	*partitions[ZBX_HC_PARTITIONS_MAX];
+
 	int			trends_num;
 	int			trends_last_cleanup_hour;
+
+	/* hourly trend flush progress, the flush is split into trends_flush_parts */
+	/* parts by itemid and the parts are claimed by history syncers           */
+	int			trends_flush_hour;
+	int			trends_flush_part_next;
+	int			trends_flush_parts_done;
+	double			trends_flush_start;
+	double			trends_flush_time;	/* duration of the last hourly flush */
 	int			history_num_total;
 	int			history_progress_ts;
 	int			trends_num_total;
@@ -111,14 +164,15 @@ typedef struct
 	unsigned char		db_trigger_queue_lock;
 
 	zbx_hc_proxyqueue_t	proxyqueue;
-	int			processing_num;
-	double			last_error_ts;
 	int			refcount;
 }
 ZBX_DC_CACHE;
 
 static ZBX_DC_CACHE	*cache = NULL;
 
+/* the currently locked history cache partition */
+static zbx_hc_partition_t	*hc_part = NULL;
+
 /* local history cache */
 #define ZBX_MAX_VALUES_LOCAL	256
 #define ZBX_STRUCT_REALLOC_STEP	8
@@ -162,10 +216,11 @@ static size_t		string_values_alloc = 0, string_values_offset = 0;
 static dc_item_value_t	*item_values = NULL;
 static size_t		item_values_alloc = 0, item_values_num = 0;
 
-static void	hc_add_item_values(dc_item_value_t *values, int values_num);
+static void	hc_add_item_values(dc_item_value_t *values, int values_num, int partition);
 static void	hc_queue_item(zbx_hc_item_t *item);
 static int	hc_queue_elem_compare_func(const void *d1, const void *d2);
 static void	hc_get_items(zbx_vector_uint64_pair_t *items);
+static int	hc_get_history_num(void);
 static void	zbx_log_sync_trends_cache_progress(void);
 
 void	zbx_pp_value_opt_clear(zbx_pp_value_opt_t *opt)
@@ -174,6 +229,46 @@ void	zbx_pp_value_opt_clear(zbx_pp_value_opt_t *opt)
 		zbx_free(opt->source);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sums write cache statistics and memory usage of all history      *
+ *          cache partitions                                                  *
+ *                                                                            *
+ * Parameters: stats         - [OUT] value counters                           *
+ *             history_free  - [OUT] free history data memory                 *
+ *             history_total - [OUT] total history data memory                *
+ *             index_free    - [OUT] free history index memory                *
+ *             index_total   - [OUT] total history index memory               *
+ *                                                                            *
+ ******************************************************************************/
+static void	hc_get_stats(zbx_dc_stats_t *stats, zbx_uint64_t *history_free, zbx_uint64_t *history_total,
+		zbx_uint64_t *index_free, zbx_uint64_t *index_total)
+{
+	memset(stats, 0, sizeof(zbx_dc_stats_t));
+	*history_free = *history_total = *index_free = *index_total = 0;
+
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		LOCK_PARTITION(i);
+
+		stats->history_counter += hc_part->stats.history_counter;
+		stats->history_float_counter += hc_part->stats.history_float_counter;
+		stats->history_uint_counter += hc_part->stats.history_uint_counter;
+		stats->history_str_counter += hc_part->stats.history_str_counter;
+		stats->history_log_counter += hc_part->stats.history_log_counter;
+		stats->history_text_counter += hc_part->stats.history_text_counter;
+		stats->history_bin_counter += hc_part->stats.history_bin_counter;
+		stats->notsupported_counter += hc_part->stats.notsupported_counter;
+
+		*history_free += hc_mem->free_size;
+		*history_total += hc_mem->total_size;
+		*index_free += hc_index_mem->free_size;
+		*index_total += hc_index_mem->total_size;
+
+		UNLOCK_PARTITION(i);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: retrieves all internal metrics of the database cache              *
@@ -183,21 +278,18 @@ void	zbx_pp_value_opt_clear(zbx_pp_value_opt_t *opt)
  ******************************************************************************/
 void	zbx_dc_get_stats_all(zbx_wcache_info_t *wcache_info)
 {
-	LOCK_CACHE;
-
-	wcache_info->stats = cache->stats;
-	wcache_info->history_free = hc_mem->free_size;
-	wcache_info->history_total = hc_mem->total_size;
-	wcache_info->index_free = hc_index_mem->free_size;
-	wcache_info->index_total = hc_index_mem->total_size;
+	hc_get_stats(&wcache_info->stats, &wcache_info->history_free, &wcache_info->history_total,
+			&wcache_info->index_free, &wcache_info->index_total);
 
 	if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
 	{
+		LOCK_CACHE;
+
 		wcache_info->trend_free = trend_mem->free_size;
 		wcache_info->trend_total = trend_mem->orig_size;
-	}
 
-	UNLOCK_CACHE;
+		UNLOCK_CACHE;
+	}
 }
 
 /******************************************************************************
@@ -210,57 +302,70 @@ void	*zbx_dc_get_stats(int request)
 	static zbx_uint64_t	value_uint;
 	static double		value_double;
 	void			*ret;
+	zbx_wcache_info_t	info;
+
+	/* trend lock must not be acquired while holding cache lock */
+	if (ZBX_STATS_TREND_FLUSH_TIME == request)
+	{
+		LOCK_TRENDS;
+		value_double = cache->trends_flush_time;
+		UNLOCK_TRENDS;
+
+		return (void *)&value_double;
+	}
+
+	hc_get_stats(&info.stats, &info.history_free, &info.history_total, &info.index_free, &info.index_total);
 
 	LOCK_CACHE;
 
 	switch (request)
 	{
 		case ZBX_STATS_HISTORY_COUNTER:
-			value_uint = cache->stats.history_counter;
+			value_uint = info.stats.history_counter;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_FLOAT_COUNTER:
-			value_uint = cache->stats.history_float_counter;
+			value_uint = info.stats.history_float_counter;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_UINT_COUNTER:
-			value_uint = cache->stats.history_uint_counter;
+			value_uint = info.stats.history_uint_counter;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_STR_COUNTER:
-			value_uint = cache->stats.history_str_counter;
+			value_uint = info.stats.history_str_counter;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_LOG_COUNTER:
-			value_uint = cache->stats.history_log_counter;
+			value_uint = info.stats.history_log_counter;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_TEXT_COUNTER:
-			value_uint = cache->stats.history_text_counter;
+			value_uint = info.stats.history_text_counter;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_NOTSUPPORTED_COUNTER:
-			value_uint = cache->stats.notsupported_counter;
+			value_uint = info.stats.notsupported_counter;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_TOTAL:
-			value_uint = hc_mem->total_size;
+			value_uint = info.history_total;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_USED:
-			value_uint = hc_mem->total_size - hc_mem->free_size;
+			value_uint = info.history_total - info.history_free;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_FREE:
-			value_uint = hc_mem->free_size;
+			value_uint = info.history_free;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_PUSED:
-			value_double = 100 * (double)(hc_mem->total_size - hc_mem->free_size) / hc_mem->total_size;
+			value_double = 100 * (double)(info.history_total - info.history_free) / info.history_total;
 			ret = (void *)&value_double;
 			break;
 		case ZBX_STATS_HISTORY_PFREE:
-			value_double = 100 * (double)hc_mem->free_size / hc_mem->total_size;
+			value_double = 100 * (double)info.history_free / info.history_total;
 			ret = (void *)&value_double;
 			break;
 		case ZBX_STATS_TREND_TOTAL:
@@ -285,28 +390,27 @@ void	*zbx_dc_get_stats(int request)
 			ret = (void *)&value_double;
 			break;
 		case ZBX_STATS_HISTORY_INDEX_TOTAL:
-			value_uint = hc_index_mem->total_size;
+			value_uint = info.index_total;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_INDEX_USED:
-			value_uint = hc_index_mem->total_size - hc_index_mem->free_size;
+			value_uint = info.index_total - info.index_free;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_INDEX_FREE:
-			value_uint = hc_index_mem->free_size;
+			value_uint = info.index_free;
 			ret = (void *)&value_uint;
 			break;
 		case ZBX_STATS_HISTORY_INDEX_PUSED:
-			value_double = 100 * (double)(hc_index_mem->total_size - hc_index_mem->free_size) /
-					hc_index_mem->total_size;
+			value_double = 100 * (double)(info.index_total - info.index_free) / info.index_total;
 			ret = (void *)&value_double;
 			break;
 		case ZBX_STATS_HISTORY_INDEX_PFREE:
-			value_double = 100 * (double)hc_index_mem->free_size / hc_index_mem->total_size;
+			value_double = 100 * (double)info.index_free / info.index_total;
 			ret = (void *)&value_double;
 			break;
 		case ZBX_STATS_HISTORY_BIN_COUNTER:
-			value_uint = cache->stats.history_bin_counter;
+			value_uint = info.stats.history_bin_counter;
 			ret = (void *)&value_uint;
 			break;
 		default:
@@ -386,28 +490,37 @@ void	zbx_dc_update_trends(zbx_vector_uint64_pair_t *trends_diff)
  *                                                                            *
  * Purpose: helper function for DCflush trends                                *
  *                                                                            *
+ * Parameters: trends      - [IN/OUT] trends to write, written trends are     *
+ *                                    cleared                                 *
+ *             trends_num  - [IN]                                             *
+ *             clause      - [IN] insert clause merging trends with existing  *
+ *                                rows (optional)                             *
+ *             value_type  - [IN]                                             *
+ *             table_name  - [IN]                                             *
+ *             clock       - [IN] trend hour                                  *
+ *             trends_diff - [OUT] disable_from changes of written trends     *
+ *                                 (optional)                                 *
+ *                                                                            *
+ * Return value: SUCCEED - trends were written                                *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
  ******************************************************************************/
-static void	dc_insert_trends_in_db(ZBX_DC_TREND *trends, int trends_num, int upserts_num, unsigned char value_type,
-		const char *table_name, int clock)
+static int	dc_insert_trends_in_db(ZBX_DC_TREND *trends, int trends_num, const char *clause,
+		unsigned char value_type, const char *table_name, int clock, zbx_vector_uint64_pair_t *trends_diff)
 {
 	ZBX_DC_TREND	*trend;
-	int		i;
+	int		i, ret, diff_num = 0;
+	zbx_uint64_t	last_itemid = 0;
 	zbx_db_insert_t	db_insert;
 
+	if (NULL != trends_diff)
+		diff_num = trends_diff->values_num;
+
 	zbx_db_insert_prepare(&db_insert, table_name, "itemid", "clock", "num", "value_min", "value_avg",
 			"value_max", (char *)NULL);
 
-#ifdef HAVE_POSTGRESQL
-	if (0 != upserts_num)
-	{
-		zbx_db_insert_clause(&db_insert, " on conflict (itemid,clock) do update set num=EXCLUDED.num,"
-				"value_min=EXCLUDED.value_min,"
-				"value_avg=EXCLUDED.value_avg,"
-				"value_max=EXCLUDED.value_max");
-	}
-#else
-	ZBX_UNUSED(upserts_num);
-#endif
+	if (NULL != clause)
+		zbx_db_insert_clause(&db_insert, clause);
 
 	for (i = 0; i < trends_num; i++)
 	{
@@ -419,6 +532,20 @@ static void	dc_insert_trends_in_db(ZBX_DC_TREND *trends, int trends_num, int ups
 		if (clock != trend->clock || value_type != trend->value_type)
 			continue;
 
+		/* upsert cannot affect the same row twice in one statement, leave duplicates for the next batch */
+		if (NULL != clause && last_itemid == trend->itemid)
+			continue;
+
+		last_itemid = trend->itemid;
+
+		/* trend row exists for this hour now, do not check the item for missing trends */
+		if (NULL != trends_diff && 0 != trend->disable_from && clock >= trend->disable_from)
+		{
+			zbx_uint64_pair_t	pair = {.first = trend->itemid, .second = clock + SEC_PER_HOUR};
+
+			zbx_vector_uint64_pair_append(trends_diff, pair);
+		}
+
 		if (ITEM_VALUE_TYPE_FLOAT == value_type)
 		{
 			zbx_db_insert_add_values(&db_insert, trend->itemid, trend->clock, trend->num,
@@ -438,10 +565,58 @@ static void	dc_insert_trends_in_db(ZBX_DC_TREND *trends, int trends_num, int ups
 		trend->itemid = 0;
 	}
 
-	zbx_db_insert_execute(&db_insert);
+	if (SUCCEED != (ret = zbx_db_insert_execute(&db_insert)) && NULL != trends_diff)
+		trends_diff->values_num = diff_num;
+
 	zbx_db_insert_clean(&db_insert);
+
+	return ret;
 }
 
+#if defined(HAVE_POSTGRESQL) || defined(HAVE_MYSQL)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns insert clause merging trend with existing database row    *
+ *                                                                            *
+ * Parameters: value_type - [IN] trend value type                             *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*dc_trends_merge_clause(unsigned char value_type)
+{
+#if defined(HAVE_POSTGRESQL)
+#	define ZBX_TRENDS_MERGE_CLAUSE(table, avg_func)								\
+		" on conflict (itemid,clock) do update set"							\
+		" num=" table ".num+EXCLUDED.num,"								\
+		"value_min=least(" table ".value_min,EXCLUDED.value_min),"					\
+		"value_avg=" avg_func "((" table ".value_avg*" table ".num+EXCLUDED.value_avg*EXCLUDED.num)/"	\
+			"(" table ".num+EXCLUDED.num)),"							\
+		"value_max=greatest(" table ".value_max,EXCLUDED.value_max)"
+
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+		return ZBX_TRENDS_MERGE_CLAUSE("trends", "");
+
+	return ZBX_TRENDS_MERGE_CLAUSE("trends_uint", "trunc");
+#else
+	/* MySQL evaluates assignments from left to right, so the number of values is updated last */
+#	define ZBX_TRENDS_MERGE_CLAUSE(avg_func, avg_old, avg_new)						\
+		" on duplicate key update"									\
+		" value_avg=" avg_func "((" avg_old "*num+" avg_new "*values(num))/(num+values(num))),"		\
+		"value_min=least(value_min,values(value_min)),"							\
+		"value_max=greatest(value_max,values(value_max)),"						\
+		"num=num+values(num)"
+
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+		return ZBX_TRENDS_MERGE_CLAUSE("", "value_avg", "values(value_avg)");
+
+	/* value sums of unsigned trends can exceed bigint unsigned range, calculate them in decimal */
+	return ZBX_TRENDS_MERGE_CLAUSE("floor", "cast(value_avg as decimal(65,0))",
+			"cast(values(value_avg) as decimal(65,0))");
+#endif
+
+#undef ZBX_TRENDS_MERGE_CLAUSE
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Update trends disable_until for items without trends data past or *
@@ -721,6 +896,20 @@ void	zbx_db_flush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uint6
 			assert(0);
 	}
 
+#if defined(HAVE_POSTGRESQL) || defined(HAVE_MYSQL)
+	if (0 != trends_flush_upsert)
+	{
+		for (i = 0; i < *trends_num && ZBX_HC_SYNC_MAX > inserts_num; i++)
+		{
+			if (clock == trends[i].clock && value_type == trends[i].value_type)
+				inserts_num++;
+		}
+
+		(void)dc_insert_trends_in_db(trends, i, dc_trends_merge_clause(value_type), value_type, table_name,
+				clock, trends_diff);
+		goto clean;
+	}
+#endif
 	itemids_alloc = MIN(ZBX_HC_SYNC_MAX, *trends_num);
 	itemids = (zbx_uint64_t *)zbx_malloc(itemids, itemids_alloc * sizeof(zbx_uint64_t));
 
@@ -799,8 +988,23 @@ void	zbx_db_flush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uint6
 	}
 
 	if (0 != inserts_num)
-		dc_insert_trends_in_db(trends, trends_to, upserts_num, value_type, table_name, clock);
+	{
+		const char	*clause = NULL;
 
+#ifdef HAVE_POSTGRESQL
+		if (0 != upserts_num)
+		{
+			clause = " on conflict (itemid,clock) do update set num=EXCLUDED.num,"
+					"value_min=EXCLUDED.value_min,"
+					"value_avg=EXCLUDED.value_avg,"
+					"value_max=EXCLUDED.value_max";
+		}
+#endif
+		(void)dc_insert_trends_in_db(trends, trends_to, clause, value_type, table_name, clock, NULL);
+	}
+#if defined(HAVE_POSTGRESQL) || defined(HAVE_MYSQL)
+clean:
+#endif
 	/* clean trends */
 	for (i = 0, num = 0; i < *trends_num; i++)
 	{
@@ -924,6 +1128,23 @@ void	zbx_dc_mass_update_trends(const zbx_dc_history_t *history, int history_num,
 	{
 		zbx_hashset_iter_t	iter;
 		ZBX_DC_TREND		*trend;
+		int			part;
+
+		if (cache->trends_flush_hour != hour)
+		{
+			cache->trends_flush_hour = hour;
+			cache->trends_flush_part_next = 0;
+			cache->trends_flush_parts_done = 0;
+			cache->trends_flush_start = zbx_time();
+		}
+
+		/* claim the next part of hourly flush, other parts are flushed by other syncers */
+		part = cache->trends_flush_part_next++;
+
+		if (trends_flush_parts == cache->trends_flush_part_next)
+			cache->trends_last_cleanup_hour = hour;
+
+		trends_flush_part_claimed = hour;
 
 		zbx_hashset_iter_reset(&cache->trends, &iter);
 
@@ -932,6 +1153,9 @@ void	zbx_dc_mass_update_trends(const zbx_dc_history_t *history, int history_num,
 			if (trend->clock == hour)
 				continue;
 
+			if (part != (int)(trend->itemid % (zbx_uint64_t)trends_flush_parts))
+				continue;
+
 			/* discard trend items that are older than compression age */
 			if (0 != compression_age && trend->clock < compression_age && 0 != trend->clock)
 			{
@@ -958,8 +1182,6 @@ void	zbx_dc_mass_update_trends(const zbx_dc_history_t *history, int history_num,
 					zbx_vector_uint64_append(&del_itemids, trend->itemid);
 			}
 		}
-
-		cache->trends_last_cleanup_hour = hour;
 	}
 
 	UNLOCK_TRENDS;
@@ -994,6 +1216,35 @@ void	zbx_dc_mass_update_trends(const zbx_dc_history_t *history, int history_num,
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: marks the hourly trend flush part claimed by the last             *
+ *          zbx_dc_mass_update_trends() call as written to database           *
+ *                                                                            *
+ * Comments: The hourly flush duration is measured from the moment the first  *
+ *           part is claimed until the last part is written.                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_trends_flush_part_done(void)
+{
+	if (0 == trends_flush_part_claimed)
+		return;
+
+	LOCK_TRENDS;
+
+	if (cache->trends_flush_hour == trends_flush_part_claimed &&
+			trends_flush_parts == ++cache->trends_flush_parts_done)
+	{
+		cache->trends_flush_time = zbx_time() - cache->trends_flush_start;
+
+		zabbix_log(LOG_LEVEL_DEBUG, "hourly trend flush done in " ZBX_FS_DBL " sec", cache->trends_flush_time);
+	}
+
+	UNLOCK_TRENDS;
+
+	trends_flush_part_claimed = 0;
+}
+
 int	zbx_trend_compare(const void *d1, const void *d2)
 {
 	const ZBX_DC_TREND	*p1 = (const ZBX_DC_TREND *)d1;
@@ -1903,9 +2154,10 @@ static void	sync_history_cache_full(const zbx_events_funcs_t *events_cbs, int co
 {
 	zbx_hashset_iter_t	iter;
 	zbx_hc_item_t		*item;
-	zbx_binary_heap_t	tmp_history_queue;
+	zbx_binary_heap_t	tmp_history_queue[ZBX_HC_PARTITIONS_MAX];
+	int			i;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() history_num:%d", __func__, cache->history_num);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() history_num:%d", __func__, hc_get_history_num());
 
 	/* History index cache might be full without any space left for queueing items from history index to  */
 	/* history queue. The solution: replace the shared-memory history queue with heap-allocated one. Add  */
@@ -1924,18 +2176,24 @@ static void	sync_history_cache_full(const zbx_events_funcs_t *events_cbs, int co
 		zbx_dc_config_unlock_all_triggers();
 	}
 
-	tmp_history_queue = cache->history_queue;
+	for (i = 0; i < hc_partitions_num; i++)
+	{
+		hc_part = cache->partitions[i];
 
-	zbx_binary_heap_create(&cache->history_queue, hc_queue_elem_compare_func, ZBX_BINARY_HEAP_OPTION_EMPTY);
-	zbx_hashset_iter_reset(&cache->history_items, &iter);
+		tmp_history_queue[i] = hc_part->history_queue;
 
-	/* add all items from history index to the new history queue */
-	while (NULL != (item = (zbx_hc_item_t *)zbx_hashset_iter_next(&iter)))
-	{
-		if (NULL != item->tail)
+		zbx_binary_heap_create(&hc_part->history_queue, hc_queue_elem_compare_func,
+				ZBX_BINARY_HEAP_OPTION_EMPTY);
+		zbx_hashset_iter_reset(&hc_part->history_items, &iter);
+
+		/* add all items from history index to the new history queue */
+		while (NULL != (item = (zbx_hc_item_t *)zbx_hashset_iter_next(&iter)))
 		{
-			item->status = ZBX_HC_ITEM_STATUS_NORMAL;
-			hc_queue_item(item);
+			if (NULL != item->tail)
+			{
+				item->status = ZBX_HC_ITEM_STATUS_NORMAL;
+				hc_queue_item(item);
+			}
 		}
 	}
 
@@ -1950,15 +2208,20 @@ static void	sync_history_cache_full(const zbx_events_funcs_t *events_cbs, int co
 			sync_history_cache_cb(events_cbs, NULL, config_history_storage_pipelines, &stats);
 
 			zabbix_log(LOG_LEVEL_WARNING, "syncing history data... " ZBX_FS_DBL "%%",
-					(double)stats.values_num / (cache->history_num + stats.values_num) * 100);
+					(double)stats.values_num / (hc_get_history_num() + stats.values_num) * 100);
 		}
 		while (0 != zbx_hc_queue_get_size());
 
 		zabbix_log(LOG_LEVEL_WARNING, "syncing history data done");
 	}
 
-	zbx_binary_heap_destroy(&cache->history_queue);
-	cache->history_queue = tmp_history_queue;
+	for (i = 0; i < hc_partitions_num; i++)
+	{
+		hc_part = cache->partitions[i];
+
+		zbx_binary_heap_destroy(&hc_part->history_queue);
+		hc_part->history_queue = tmp_history_queue[i];
+	}
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -1971,7 +2234,9 @@ static void	sync_history_cache_full(const zbx_events_funcs_t *events_cbs, int co
 void	zbx_log_sync_history_cache_progress(void)
 {
 	double		pcnt = -1.0;
-	int		ts_last, ts_next, sec;
+	int		ts_last, ts_next, sec, history_num;
+
+	history_num = hc_get_history_num();
 
 	LOCK_CACHE;
 
@@ -1986,16 +2251,16 @@ void	zbx_log_sync_history_cache_progress(void)
 
 	if (0 == cache->history_progress_ts)
 	{
-		cache->history_num_total = cache->history_num;
+		cache->history_num_total = history_num;
 		cache->history_progress_ts = sec;
 	}
 
-	if (ZBX_HC_SYNC_TIME_MAX <= sec - cache->history_progress_ts || 0 == cache->history_num)
+	if (ZBX_HC_SYNC_TIME_MAX <= sec - cache->history_progress_ts || 0 == history_num)
 	{
 		if (0 != cache->history_num_total)
-			pcnt = 100 * (double)(cache->history_num_total - cache->history_num) / cache->history_num_total;
+			pcnt = 100 * (double)(cache->history_num_total - history_num) / cache->history_num_total;
 
-		cache->history_progress_ts = (0 == cache->history_num ? INT_MAX : sec);
+		cache->history_progress_ts = (0 == history_num ? INT_MAX : sec);
 	}
 
 	ts_next = cache->history_progress_ts;
@@ -2080,7 +2345,7 @@ static void	zbx_log_sync_trends_cache_progress(void)
 void	zbx_sync_history_cache(const zbx_events_funcs_t *events_cbs, zbx_ipc_async_socket_t *rtc,
 		int config_history_storage_pipelines, zbx_history_sync_stats_t *stats)
 {
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() history_num:%d", __func__, cache->history_num);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() history_num:%d", __func__, hc_get_history_num());
 
 	sync_history_cache_cb(events_cbs, rtc, config_history_storage_pipelines, stats);
 }
@@ -2586,26 +2851,33 @@ void	zbx_dc_add_history_variant(zbx_uint64_t itemid, unsigned char value_type, u
 
 size_t	zbx_dc_flush_history(void)
 {
-	LOCK_CACHE;
+	int	values_num[ZBX_HC_PARTITIONS_MAX] = {0}, processing_num = 0, i;
+	size_t	count = item_values_num;
 
 	if (0 == item_values_num)
-	{
-		UNLOCK_CACHE;
 		return 0;
-	}
 
-	hc_add_item_values(item_values, item_values_num);
+	for (i = 0; i < (int)item_values_num; i++)
+		values_num[HC_ITEM_PARTITION(item_values[i].itemid)]++;
 
-	cache->history_num += item_values_num;
+	for (i = 0; i < hc_partitions_num; i++)
+	{
+		if (0 == values_num[i])
+			continue;
 
-	int	processing_num = cache->processing_num;
-	size_t	count = item_values_num;
+		LOCK_PARTITION(i);
+
+		hc_add_item_values(item_values, item_values_num, i);
+
+		hc_part->history_num += values_num[i];
+		processing_num += hc_part->processing_num;
+
+		UNLOCK_PARTITION(i);
+	}
 
 	item_values_num = 0;
 	string_values_offset = 0;
 
-	UNLOCK_CACHE;
-
 	zbx_vps_monitor_add_collected((zbx_uint64_t)count);
 
 	if (0 != processing_num)
@@ -2696,7 +2968,7 @@ static void	hc_queue_item(zbx_hc_item_t *item)
 {
 	zbx_binary_heap_elem_t	elem = {item->itemid, (void *)item};
 
-	zbx_binary_heap_insert(&cache->history_queue, &elem);
+	zbx_binary_heap_insert(&hc_part->history_queue, &elem);
 }
 
 /******************************************************************************
@@ -2711,7 +2983,7 @@ static void	hc_queue_item(zbx_hc_item_t *item)
  ******************************************************************************/
 static zbx_hc_item_t	*hc_get_item(zbx_uint64_t itemid)
 {
-	return (zbx_hc_item_t *)zbx_hashset_search(&cache->history_items, &itemid);
+	return (zbx_hc_item_t *)zbx_hashset_search(&hc_part->history_items, &itemid);
 }
 
 /******************************************************************************
@@ -2728,7 +3000,7 @@ static zbx_hc_item_t	*hc_add_item(zbx_uint64_t itemid, zbx_hc_data_t *data)
 {
 	zbx_hc_item_t	item_local = {itemid, ZBX_HC_ITEM_STATUS_NORMAL, 0, data, data};
 
-	return (zbx_hc_item_t *)zbx_hashset_insert(&cache->history_items, &item_local, sizeof(item_local));
+	return (zbx_hc_item_t *)zbx_hashset_insert(&hc_part->history_items, &item_local, sizeof(item_local));
 }
 
 /******************************************************************************
@@ -2743,9 +3015,9 @@ static zbx_hc_item_t	*hc_add_item(zbx_uint64_t itemid, zbx_hc_data_t *data)
  ******************************************************************************/
 int	zbx_hc_clear_item_middle(zbx_uint64_t itemid)
 {
-	int	i = 0;
+	int	i = 0, partition = HC_ITEM_PARTITION(itemid);
 
-	LOCK_CACHE;
+	LOCK_PARTITION(partition);
 
 	zbx_hc_item_t	*item;
 
@@ -2765,12 +3037,12 @@ int	zbx_hc_clear_item_middle(zbx_uint64_t itemid)
 			}
 		}
 
-		cache->history_num -= i;
+		hc_part->history_num -= i;
 	}
 	else
 		i = FAIL;
 
-	UNLOCK_CACHE;
+	UNLOCK_PARTITION(partition);
 
 	return i;
 }
@@ -2905,7 +3177,7 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 			return FAIL;
 
 		(*data)->value_type = item_value->value_type;
-		cache->stats.notsupported_counter++;
+		hc_part->stats.notsupported_counter++;
 
 		return SUCCEED;
 	}
@@ -2917,8 +3189,8 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 
 		(*data)->value_type = ITEM_VALUE_TYPE_TEXT;
 
-		cache->stats.history_text_counter++;
-		cache->stats.history_counter++;
+		hc_part->stats.history_text_counter++;
+		hc_part->stats.history_counter++;
 
 		return SUCCEED;
 	}
@@ -2955,22 +3227,22 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 		switch (item_value->item_value_type)
 		{
 			case ITEM_VALUE_TYPE_FLOAT:
-				cache->stats.history_float_counter++;
+				hc_part->stats.history_float_counter++;
 				break;
 			case ITEM_VALUE_TYPE_UINT64:
-				cache->stats.history_uint_counter++;
+				hc_part->stats.history_uint_counter++;
 				break;
 			case ITEM_VALUE_TYPE_STR:
-				cache->stats.history_str_counter++;
+				hc_part->stats.history_str_counter++;
 				break;
 			case ITEM_VALUE_TYPE_TEXT:
-				cache->stats.history_text_counter++;
+				hc_part->stats.history_text_counter++;
 				break;
 			case ITEM_VALUE_TYPE_LOG:
-				cache->stats.history_log_counter++;
+				hc_part->stats.history_log_counter++;
 				break;
 			case ITEM_VALUE_TYPE_BIN:
-				cache->stats.history_bin_counter++;
+				hc_part->stats.history_bin_counter++;
 				break;
 			case ITEM_VALUE_TYPE_NONE:
 			default:
@@ -2978,7 +3250,7 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 				exit(EXIT_FAILURE);
 		}
 
-		cache->stats.history_counter++;
+		hc_part->stats.history_counter++;
 	}
 
 	(*data)->value_type = item_value->value_type;
@@ -3013,7 +3285,7 @@ static void	hc_print_history_cache_full(zbx_vector_uint64_pair_t *items)
 	size_t	str_alloc = 0, str_offset = 0;
 	double	time_now = zbx_time();
 
-	if (SEC_PER_MIN > time_now - cache->last_error_ts)
+	if (SEC_PER_MIN > time_now - hc_part->last_error_ts)
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "History cache is full. Sleeping for 1 second.");
 		return;
@@ -3021,7 +3293,7 @@ static void	hc_print_history_cache_full(zbx_vector_uint64_pair_t *items)
 
 	zabbix_log(LOG_LEVEL_WARNING, "History cache is full. Sleeping for 1 second.");
 
-	cache->last_error_ts = time_now;
+	hc_part->last_error_ts = time_now;
 
 	zbx_vector_uint64_pair_sort(items, diag_compare_pair_second_desc);
 
@@ -3042,17 +3314,19 @@ static void	hc_print_history_cache_full(zbx_vector_uint64_pair_t *items)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: adds item values to the history cache                             *
+ * Purpose: adds item values to the history cache partition                   *
  *                                                                            *
  * Parameters: values     - [IN] the item values to add                       *
  *             values_num - [IN] the number of item values to add             *
+ *             partition  - [IN] the locked history cache partition, values   *
+ *                               of items from other partitions are skipped   *
  *                                                                            *
  * Comments: If the history cache is full this function will wait until       *
  *           history syncers processes values freeing enough space to store   *
  *           the new value.                                                   *
  *                                                                            *
  ******************************************************************************/
-static void	hc_add_item_values(dc_item_value_t *values, int values_num)
+static void	hc_add_item_values(dc_item_value_t *values, int values_num, int partition)
 {
 	dc_item_value_t	*item_value;
 	int		i;
@@ -3064,6 +3338,9 @@ static void	hc_add_item_values(dc_item_value_t *values, int values_num)
 
 		item_value = &values[i];
 
+		if (partition != HC_ITEM_PARTITION(item_value->itemid))
+			continue;
+
 		/* a record with metadata and no value can be dropped if  */
 		/* the metadata update is copied to the last queued value */
 		if (NULL != (item = hc_get_item(item_value->itemid)) && 0 != (item_value->flags & ZBX_DC_FLAG_NOVALUE))
@@ -3093,14 +3370,14 @@ static void	hc_add_item_values(dc_item_value_t *values, int values_num)
 
 				hc_get_items(&items);
 
-				UNLOCK_CACHE;
+				UNLOCK_PARTITION(partition);
 
 				hc_print_history_cache_full(&items);
 
 				zbx_vector_uint64_pair_destroy(&items);
 				sleep(1);
 
-				LOCK_CACHE;
+				LOCK_PARTITION(partition);
 			}
 			while (SUCCEED != hc_clone_history_data(&data, item_value));
 
@@ -3195,7 +3472,10 @@ static void	hc_copy_history_data(zbx_dc_history_t *history, zbx_uint64_t itemid,
  * Parameters: history_items - [OUT] the locked history items                 *
  *                                                                            *
  * Comments: The history_items must be returned back to history cache with    *
- *           zbx_hc_push_items() function after they have been processed.         *
+ *           zbx_hc_push_items() function after they have been processed.     *
+ *           All items of the batch are taken from the same history cache     *
+ *           partition. Partitions are visited in round-robin order so that   *
+ *           history syncers spread over all partitions.                      *
  *                                                                            *
  ******************************************************************************/
 void	zbx_hc_pop_items(zbx_vector_hc_item_ptr_t *history_items)
@@ -3203,17 +3483,29 @@ void	zbx_hc_pop_items(zbx_vector_hc_item_ptr_t *history_items)
 	zbx_binary_heap_elem_t	*elem;
 	zbx_hc_item_t		*item;
 
-	while (ZBX_HC_SYNC_MAX > history_items->values_num && FAIL == zbx_binary_heap_empty(&cache->history_queue))
+	for (int i = 0; i < hc_partitions_num && 0 == history_items->values_num; i++)
 	{
-		elem = zbx_binary_heap_find_min(&cache->history_queue);
-		item = elem->data;
-		zbx_vector_hc_item_ptr_append(history_items, item);
+		int	partition = hc_pop_partition;
 
-		zbx_binary_heap_remove_min(&cache->history_queue);
-	}
+		hc_pop_partition = (hc_pop_partition + 1) % hc_partitions_num;
+
+		LOCK_PARTITION(partition);
+
+		while (ZBX_HC_SYNC_MAX > history_items->values_num &&
+				FAIL == zbx_binary_heap_empty(&hc_part->history_queue))
+		{
+			elem = zbx_binary_heap_find_min(&hc_part->history_queue);
+			item = elem->data;
+			zbx_vector_hc_item_ptr_append(history_items, item);
+
+			zbx_binary_heap_remove_min(&hc_part->history_queue);
+		}
+
+		if (0 != history_items->values_num)
+			hc_part->processing_num++;
 
-	if (0 != history_items->values_num)
-		cache->processing_num++;
+		UNLOCK_PARTITION(partition);
+	}
 }
 
 /******************************************************************************
@@ -3256,10 +3548,18 @@ void	zbx_hc_get_item_values(zbx_dc_history_t *history, zbx_vector_hc_item_ptr_t
  ******************************************************************************/
 void	zbx_hc_push_items(zbx_vector_hc_item_ptr_t *history_items)
 {
-	int		i;
+	int		i, partition;
 	zbx_hc_item_t	*item;
 	zbx_hc_data_t	*data_free;
 
+	if (0 == history_items->values_num)
+		return;
+
+	/* all items were popped from the same partition */
+	partition = HC_ITEM_PARTITION(history_items->values[0]->itemid);
+
+	LOCK_PARTITION(partition);
+
 	for (i = 0; i < history_items->values_num; i++)
 	{
 		item = history_items->values[i];
@@ -3277,24 +3577,53 @@ void	zbx_hc_push_items(zbx_vector_hc_item_ptr_t *history_items)
 				item->tail = item->tail->next;
 				hc_free_data(data_free);
 				if (NULL == item->tail)
-					zbx_hashset_remove(&cache->history_items, item);
+					zbx_hashset_remove(&hc_part->history_items, item);
 				else
 					hc_queue_item(item);
+				hc_part->history_num--;
 				break;
 		}
 	}
 
-	cache->processing_num--;
+	hc_part->processing_num--;
+
+	UNLOCK_PARTITION(partition);
 }
 
 /******************************************************************************
  *                                                                            *
  * Purpose: retrieve the size of history queue                                *
  *                                                                            *
+ * Comments: The partitions are not locked, so the returned value is only an  *
+ *           estimate while history is being added or synced.                 *
+ *                                                                            *
  ******************************************************************************/
 int	zbx_hc_queue_get_size(void)
 {
-	return cache->history_queue.elems_num;
+	int	size = 0;
+
+	for (int i = 0; i < hc_partitions_num; i++)
+		size += cache->partitions[i]->history_queue.elems_num;
+
+	return size;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: retrieve the number of values in history cache                    *
+ *                                                                            *
+ * Comments: The partitions are not locked, so the returned value is only an  *
+ *           estimate while history is being added or synced.                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	hc_get_history_num(void)
+{
+	int	history_num = 0;
+
+	for (int i = 0; i < hc_partitions_num; i++)
+		history_num += cache->partitions[i]->history_num;
+
+	return history_num;
 }
 
 int	zbx_hc_get_history_compression_age(void)
@@ -3325,21 +3654,32 @@ int	zbx_hc_get_history_compression_age(void)
  ******************************************************************************/
 double	zbx_hc_mem_pused(void)
 {
-	return 100 * (double)(zbx_dbcache_get_hc_mem()->total_size - zbx_dbcache_get_hc_mem()->free_size) /
-			zbx_dbcache_get_hc_mem()->total_size;
+	zbx_uint64_t	total_size = 0, free_size = 0;
+
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		total_size += hc_part_mem[i]->total_size;
+		free_size += hc_part_mem[i]->free_size;
+	}
+
+	return 100 * (double)(total_size - free_size) / total_size;
 }
 
 double	zbx_hc_mem_pused_lock(void)
 {
-	double	pused;
+	zbx_uint64_t	total_size = 0, free_size = 0;
 
-	zbx_dbcache_lock();
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		LOCK_PARTITION(i);
 
-	pused = zbx_hc_mem_pused();
+		total_size += hc_mem->total_size;
+		free_size += hc_mem->free_size;
 
-	zbx_dbcache_unlock();
+		UNLOCK_PARTITION(i);
+	}
 
-	return pused;
+	return 100 * (double)(total_size - free_size) / total_size;
 }
 
 /******************************************************************************
@@ -3373,6 +3713,11 @@ static int	init_trend_cache(zbx_uint64_t *trends_cache_size, char **error)
 
 	cache->trends_num = 0;
 	cache->trends_last_cleanup_hour = 0;
+	cache->trends_flush_hour = 0;
+	cache->trends_flush_part_next = 0;
+	cache->trends_flush_parts_done = 0;
+	cache->trends_flush_start = 0;
+	cache->trends_flush_time = 0;
 
 #define INIT_HASHSET_SIZE	100	/* Should be calculated dynamically based on trends size? */
 					/* Still does not make sense to have it more than initial */
@@ -3389,18 +3734,88 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: Allocate shared memory for history cache partition                *
+ *                                                                            *
+ * Parameters: partition                - [IN] partition index                *
+ *             history_cache_size       - [IN] partition data memory size     *
+ *             history_index_cache_size - [IN] partition index memory size    *
+ *             error                    - [OUT]                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	init_history_cache_partition(int partition, zbx_uint64_t history_cache_size,
+		zbx_uint64_t history_index_cache_size, char **error)
+{
+	int	ret;
+
+	if (SUCCEED != (ret = zbx_mutex_create(&hc_part_locks[partition], 0 == partition ? ZBX_MUTEX_CACHE :
+			ZBX_MUTEX_CACHE_PARTITION + partition - 1, error)))
+	{
+		return ret;
+	}
+
+	/* history values, items and queue entries are mostly small fixed size allocations */
+	/* with high churn, serve them from slabs to avoid free list scans and fragmentation */
+	if (SUCCEED != (ret = zbx_shmem_create_ext(&hc_part_mem[partition], history_cache_size, "history cache",
+			"HistoryCacheSize", 1, ZBX_SHMEM_MODE_SLAB, error)))
+	{
+		return ret;
+	}
+
+	if (SUCCEED != (ret = zbx_shmem_create_ext(&hc_part_index_mem[partition], history_index_cache_size,
+			"history index cache", "HistoryIndexCacheSize", 0, ZBX_SHMEM_MODE_SLAB, error)))
+	{
+		return ret;
+	}
+
+	hc_mem = hc_part_mem[partition];
+	hc_index_mem = hc_part_index_mem[partition];
+
+	if (0 == partition)
+	{
+		cache = (ZBX_DC_CACHE *)__hc_index_shmem_malloc_func(NULL, sizeof(ZBX_DC_CACHE));
+		memset(cache, 0, sizeof(ZBX_DC_CACHE));
+	}
+
+	hc_part = (zbx_hc_partition_t *)__hc_index_shmem_malloc_func(NULL, sizeof(zbx_hc_partition_t));
+	memset(hc_part, 0, sizeof(zbx_hc_partition_t));
+
+	zbx_hashset_create_ext(&hc_part->history_items, ZBX_HC_ITEMS_INIT_SIZE / hc_partitions_num,
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC, NULL,
+			__hc_index_shmem_malloc_func, __hc_index_shmem_realloc_func, __hc_index_shmem_free_func);
+
+	zbx_binary_heap_create_ext(&hc_part->history_queue, hc_queue_elem_compare_func, ZBX_BINARY_HEAP_OPTION_EMPTY,
+			__hc_index_shmem_malloc_func, __hc_index_shmem_realloc_func, __hc_index_shmem_free_func);
+
+	cache->partitions[partition] = hc_part;
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Allocate shared memory for database cache                         *
  *                                                                            *
+ * Comments: History cache and history index cache memory is split evenly     *
+ *           between history cache partitions. Each partition has its own     *
+ *           lock, so values of items from different partitions can be added  *
+ *           and synced in parallel.                                          *
+ *                                                                            *
+ *           When trends_flush_syncers is set the hourly trend flush is split *
+ *           by itemid between that many history syncers and trends are       *
+ *           merged with existing rows by upserts.                            *
+ *                                                                            *
  ******************************************************************************/
 int	zbx_init_database_cache(zbx_get_program_type_f get_program_type,
 		zbx_sync_history_cache_f sync_history_cache_func, zbx_uint64_t history_cache_size,
-		zbx_uint64_t history_index_cache_size, zbx_uint64_t *trends_cache_size, char **error)
+		zbx_uint64_t history_index_cache_size, int history_cache_partitions, int trends_flush_syncers,
+		zbx_uint64_t *trends_cache_size, char **error)
 {
+#define ZBX_HC_PARTITION_SIZE_MIN	(128 * ZBX_KIBIBYTE)
 	int	ret;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() partitions:%d", __func__, history_cache_partitions);
 
 	get_program_type_cb = get_program_type;
 	sync_history_cache_cb = sync_history_cache_func;
@@ -3411,37 +3826,51 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type,
 		goto out;
 	}
 
-	if (SUCCEED != (ret = zbx_mutex_create(&cache_lock, ZBX_MUTEX_CACHE, error)))
-		goto out;
-
-	if (SUCCEED != (ret = zbx_mutex_create(&cache_ids_lock, ZBX_MUTEX_CACHE_IDS, error)))
+	if (1 > history_cache_partitions || ZBX_HC_PARTITIONS_MAX < history_cache_partitions)
+	{
+		*error = zbx_dsprintf(*error, "invalid number of history cache partitions: %d",
+				history_cache_partitions);
+		ret = FAIL;
 		goto out;
+	}
 
-	if (SUCCEED != (ret = zbx_shmem_create(&hc_mem, history_cache_size, "history cache",
-			"HistoryCacheSize", 1, error)))
+	if (ZBX_HC_PARTITION_SIZE_MIN > history_cache_size / (zbx_uint64_t)history_cache_partitions ||
+			ZBX_HC_PARTITION_SIZE_MIN > history_index_cache_size / (zbx_uint64_t)history_cache_partitions)
 	{
+		*error = zbx_dsprintf(*error, "HistoryCacheSize and HistoryIndexCacheSize must be at least "
+				ZBX_FS_UI64 " bytes per history cache partition", (zbx_uint64_t)ZBX_HC_PARTITION_SIZE_MIN);
+		ret = FAIL;
 		goto out;
 	}
 
-	if (SUCCEED != (ret = zbx_shmem_create(&hc_index_mem, history_index_cache_size, "history index cache",
-			"HistoryIndexCacheSize", 0, error)))
+	hc_partitions_num = history_cache_partitions;
+
+	if (0 != trends_flush_syncers)
 	{
+		trends_flush_parts = trends_flush_syncers;
+		trends_flush_upsert = 1;
+	}
+
+	if (SUCCEED != (ret = zbx_mutex_create(&cache_ids_lock, ZBX_MUTEX_CACHE_IDS, error)))
 		goto out;
+
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		if (SUCCEED != (ret = init_history_cache_partition(i, history_cache_size / hc_partitions_num,
+				history_index_cache_size / hc_partitions_num, error)))
+		{
+			goto out;
+		}
 	}
 
-	cache = (ZBX_DC_CACHE *)__hc_index_shmem_malloc_func(NULL, sizeof(ZBX_DC_CACHE));
-	memset(cache, 0, sizeof(ZBX_DC_CACHE));
+	/* the history cache header is stored in the first partition */
+	hc_mem = hc_part_mem[0];
+	hc_index_mem = hc_part_index_mem[0];
+	hc_part = cache->partitions[0];
 
 	ids = (ZBX_DC_IDS *)__hc_index_shmem_malloc_func(NULL, sizeof(ZBX_DC_IDS));
 	memset(ids, 0, sizeof(ZBX_DC_IDS));
 
-	zbx_hashset_create_ext(&cache->history_items, ZBX_HC_ITEMS_INIT_SIZE,
-			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC, NULL,
-			__hc_index_shmem_malloc_func, __hc_index_shmem_realloc_func, __hc_index_shmem_free_func);
-
-	zbx_binary_heap_create_ext(&cache->history_queue, hc_queue_elem_compare_func, ZBX_BINARY_HEAP_OPTION_EMPTY,
-			__hc_index_shmem_malloc_func, __hc_index_shmem_realloc_func, __hc_index_shmem_free_func);
-
 	if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
 	{
 		zbx_hashset_create_ext(&(cache->proxyqueue.index), ZBX_HC_SYNC_MAX,
@@ -3458,10 +3887,8 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type,
 	}
 
 	cache->refcount = 0;
-	cache->processing_num = 0;
 	cache->history_num_total = 0;
 	cache->history_progress_ts = 0;
-	cache->last_error_ts = 0;
 	cache->trends_progress_ts = 0;
 
 	cache->db_trigger_queue_lock = 1;
@@ -3472,6 +3899,7 @@ out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
 	return ret;
+#undef ZBX_HC_PARTITION_SIZE_MIN
 }
 
 /******************************************************************************
@@ -3504,13 +3932,22 @@ void	zbx_free_database_cache(int sync, const zbx_events_funcs_t *events_cbs, int
 		DCsync_all(events_cbs, config_history_storage_pipelines);
 
 	cache = NULL;
-
-	zbx_shmem_destroy(hc_mem);
+	hc_part = NULL;
 	hc_mem = NULL;
-	zbx_shmem_destroy(hc_index_mem);
 	hc_index_mem = NULL;
 
-	zbx_mutex_destroy(&cache_lock);
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		zbx_shmem_destroy(hc_part_mem[i]);
+		hc_part_mem[i] = NULL;
+		zbx_shmem_destroy(hc_part_index_mem[i]);
+		hc_part_index_mem[i] = NULL;
+
+		zbx_mutex_destroy(&hc_part_locks[i]);
+	}
+
+	hc_partitions_num = 0;
+
 	zbx_mutex_destroy(&cache_ids_lock);
 
 	if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
@@ -3631,12 +4068,52 @@ out:
  ******************************************************************************/
 void	zbx_hc_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num)
 {
-	LOCK_CACHE;
+	*values_num = 0;
+	*items_num = 0;
 
-	*values_num = cache->history_num;
-	*items_num = cache->history_items.num_data;
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		LOCK_PARTITION(i);
 
-	UNLOCK_CACHE;
+		*values_num += hc_part->history_num;
+		*items_num += hc_part->history_items.num_data;
+
+		UNLOCK_PARTITION(i);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add shared memory allocator statistics of one segment to the      *
+ *          statistics of other segments                                      *
+ *                                                                            *
+ ******************************************************************************/
+static void	hc_add_mem_stats(zbx_shmem_stats_t *dst, const zbx_shmem_stats_t *src)
+{
+	if (0 == dst->used_chunks + dst->free_chunks)
+	{
+		*dst = *src;
+		return;
+	}
+
+	dst->free_size += src->free_size;
+	dst->used_size += src->used_size;
+	dst->overhead += src->overhead;
+	dst->free_chunks += src->free_chunks;
+	dst->used_chunks += src->used_chunks;
+	dst->min_chunk_size = MIN(dst->min_chunk_size, src->min_chunk_size);
+	dst->max_chunk_size = MAX(dst->max_chunk_size, src->max_chunk_size);
+
+	for (int i = 0; i < ZBX_SHMEM_BUCKET_COUNT; i++)
+		dst->chunks_num[i] += src->chunks_num[i];
+
+	dst->slabs_num += src->slabs_num;
+
+	for (int i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+	{
+		dst->slab_used_num[i] += src->slab_used_num[i];
+		dst->slab_free_num[i] += src->slab_free_num[i];
+	}
 }
 
 /******************************************************************************
@@ -3646,15 +4123,32 @@ void	zbx_hc_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num)
  ******************************************************************************/
 void	zbx_hc_get_mem_stats(zbx_shmem_stats_t *data, zbx_shmem_stats_t *index)
 {
-	LOCK_CACHE;
+	zbx_shmem_stats_t	stats;
 
 	if (NULL != data)
-		zbx_shmem_get_stats(hc_mem, data);
+		memset(data, 0, sizeof(zbx_shmem_stats_t));
 
 	if (NULL != index)
-		zbx_shmem_get_stats(hc_index_mem, index);
+		memset(index, 0, sizeof(zbx_shmem_stats_t));
 
-	UNLOCK_CACHE;
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		LOCK_PARTITION(i);
+
+		if (NULL != data)
+		{
+			zbx_shmem_get_stats(hc_mem, &stats);
+			hc_add_mem_stats(data, &stats);
+		}
+
+		if (NULL != index)
+		{
+			zbx_shmem_get_stats(hc_index_mem, &stats);
+			hc_add_mem_stats(index, &stats);
+		}
+
+		UNLOCK_PARTITION(i);
+	}
 }
 
 /******************************************************************************
@@ -3664,21 +4158,21 @@ void	zbx_hc_get_mem_stats(zbx_shmem_stats_t *data, zbx_shmem_stats_t *index)
  ******************************************************************************/
 int	zbx_hc_is_itemid_cached(zbx_uint64_t itemid)
 {
-	int	ret = FAIL;
+	int	ret = FAIL, partition = HC_ITEM_PARTITION(itemid);
 
-	LOCK_CACHE;
+	LOCK_PARTITION(partition);
 
-	if (NULL != zbx_hashset_search(&cache->history_items, &itemid))
+	if (NULL != zbx_hashset_search(&hc_part->history_items, &itemid))
 		ret = SUCCEED;
 
-	UNLOCK_CACHE;
+	UNLOCK_PARTITION(partition);
 
 	return ret;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: get statistics of cached items                                    *
+ * Purpose: get statistics of cached items in the locked partition            *
  *                                                                            *
  ******************************************************************************/
 static void	hc_get_items(zbx_vector_uint64_pair_t *items)
@@ -3686,9 +4180,9 @@ static void	hc_get_items(zbx_vector_uint64_pair_t *items)
 	zbx_hashset_iter_t	iter;
 	zbx_hc_item_t		*item;
 
-	zbx_vector_uint64_pair_reserve(items, cache->history_items.num_data);
+	zbx_vector_uint64_pair_reserve(items, (size_t)(items->values_num + hc_part->history_items.num_data));
 
-	zbx_hashset_iter_reset(&cache->history_items, &iter);
+	zbx_hashset_iter_reset(&hc_part->history_items, &iter);
 	while (NULL != (item = (zbx_hc_item_t *)zbx_hashset_iter_next(&iter)))
 	{
 		zbx_uint64_pair_t	pair = {item->itemid, item->values_num};
@@ -3703,11 +4197,14 @@ static void	hc_get_items(zbx_vector_uint64_pair_t *items)
  ******************************************************************************/
 void	zbx_hc_get_items(zbx_vector_uint64_pair_t *items)
 {
-	LOCK_CACHE;
+	for (int i = 0; i < hc_partitions_num; i++)
+	{
+		LOCK_PARTITION(i);
 
-	hc_get_items(items);
+		hc_get_items(items);
 
-	UNLOCK_CACHE;
+		UNLOCK_PARTITION(i);
+	}
 }
 
 void	zbx_hc_acquire(void)
@@ -3845,21 +4342,6 @@ void	zbx_dbcache_unlock(void)
 	UNLOCK_CACHE;
 }
 
-void	zbx_dbcache_set_history_num(int num)
-{
-	cache->history_num = num;
-}
-
-int	zbx_dbcache_get_history_num(void)
-{
-	return cache->history_num;
-}
-
-zbx_shmem_info_t	*zbx_dbcache_get_hc_mem(void)
-{
-	return hc_mem;
-}
-
 void	zbx_dbcache_setproxyqueue_state(int proxyqueue_state)
 {
 	cache->proxyqueue.state = proxyqueue_state;
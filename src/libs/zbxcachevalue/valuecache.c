@@ -105,11 +105,31 @@ typedef struct zbx_vc_chunk
 	/* the number of item value slots in chunk */
 	int			slots_num;
 
-	/* the item value data */
+	/* the size of encoded value data if the chunk is packed, 0 otherwise */
+	int			packed_size;
+
+	/* the item value data, packed chunks store zbx_vc_packed_t here */
 	zbx_history_record_t	slots[1];
 }
 zbx_vc_chunk_t;
 
+/* the packed chunk data */
+typedef struct
+{
+	/* the timestamps of the first (oldest) and last (newest) values in chunk */
+	zbx_timespec_t	first_ts;
+	zbx_timespec_t	last_ts;
+
+	/* the encoded timestamps and values, see vch_chunk_pack_values() */
+	unsigned char	data[1];
+}
+zbx_vc_packed_t;
+
+#define VC_PACKED_CHUNK(chunk)	((zbx_vc_packed_t *)(chunk)->slots)
+
+/* the maximum number of bytes required to encode one value in packed chunk */
+#define VC_PACKED_RECORD_MAX	(5 + 5 + 10)
+
 /* min/max number of item history values to store in chunk */
 
 #define ZBX_VC_MIN_CHUNK_RECORDS	2
@@ -288,6 +308,7 @@ static void	vc_history_record_vector_clean(zbx_vector_history_record_t *vector,
 
 static size_t	vch_item_free_cache(zbx_vc_item_t *item);
 static size_t	vch_item_free_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk);
+static void	*vc_item_malloc(zbx_vc_item_t *item, size_t size);
 static int	vch_item_add_values_at_tail(zbx_vc_item_t *item, const zbx_history_record_t *values, int values_num);
 static void	vch_item_clean_cache(zbx_vc_item_t *item, int timestamp);
 
@@ -1292,8 +1313,364 @@ static void	vc_item_update_db_cached_from(zbx_vc_item_t *item, int timestamp)
  *
  * After adding a new chunk, the older chunks (outside the largest request
  * range) are automatically removed from cache.
+ *
+ * Numeric (FLOAT and UINT64) values of full chunks are packed once a newer chunk
+ * is added - timestamps are stored as delta-of-delta seconds and nanoseconds,
+ * unsigned values as deltas and float values as XOR with the previous value.
+ * Packed chunks are decoded when read and unpacked back into slots only in the
+ * rare cases when their values must be modified (removed or shifted).
  */
 
+/* the buffer for decoded packed chunk values */
+static zbx_history_record_t	*vc_unpacked = NULL;
+
+static unsigned char	*vc_encode_varint(unsigned char *ptr, zbx_uint64_t value)
+{
+	while (0x80 <= value)
+	{
+		*ptr++ = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+
+	*ptr++ = (unsigned char)value;
+
+	return ptr;
+}
+
+static const unsigned char	*vc_decode_varint(const unsigned char *ptr, zbx_uint64_t *value)
+{
+	int	shift = 0;
+
+	*value = 0;
+
+	do
+	{
+		*value |= (zbx_uint64_t)(*ptr & 0x7f) << shift;
+		shift += 7;
+	}
+	while (0 != (*ptr++ & 0x80));
+
+	return ptr;
+}
+
+static zbx_uint64_t	vc_zigzag_encode(zbx_int64_t value)
+{
+	return ((zbx_uint64_t)value << 1) ^ (zbx_uint64_t)(value >> 63);
+}
+
+static zbx_int64_t	vc_zigzag_decode(zbx_uint64_t value)
+{
+	return (zbx_int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: encodes XOR of two consecutive float values                       *
+ *                                                                            *
+ * Comments: The value is encoded as control byte 0 if the XOR is zero or     *
+ *           control byte 01LLLTTT followed by the non-zero bytes, where LLL  *
+ *           is the number of leading and TTT is the number of trailing zero  *
+ *           bytes.                                                           *
+ *                                                                            *
+ ******************************************************************************/
+static unsigned char	*vc_encode_xor(unsigned char *ptr, zbx_uint64_t value)
+{
+	int	lead, trail, i;
+
+	if (0 == value)
+	{
+		*ptr++ = 0;
+		return ptr;
+	}
+
+	for (lead = 0; 0 == ((value >> (56 - lead * 8)) & 0xff); lead++)
+		;
+
+	for (trail = 0; 0 == ((value >> (trail * 8)) & 0xff); trail++)
+		;
+
+	*ptr++ = (unsigned char)(0x40 | (lead << 3) | trail);
+
+	for (i = 7 - lead; i >= trail; i--)
+		*ptr++ = (unsigned char)(value >> (i * 8));
+
+	return ptr;
+}
+
+static const unsigned char	*vc_decode_xor(const unsigned char *ptr, zbx_uint64_t *value)
+{
+	int	lead, trail, i;
+
+	*value = 0;
+
+	if (0 == *ptr)
+		return ptr + 1;
+
+	lead = (*ptr >> 3) & 7;
+	trail = *ptr++ & 7;
+
+	for (i = 7 - lead; i >= trail; i--)
+		*value |= (zbx_uint64_t)*ptr++ << (i * 8);
+
+	return ptr;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: encodes numeric history values                                    *
+ *                                                                            *
+ * Parameters: value_type - [IN] the value type (FLOAT or UINT64)             *
+ *             values     - [IN] the values to encode in ascending order      *
+ *             values_num - [IN] the number of values to encode               *
+ *             data       - [OUT] the encoded data, must have space for at    *
+ *                                least values_num * VC_PACKED_RECORD_MAX     *
+ *                                bytes                                       *
+ *                                                                            *
+ * Return value: the size of encoded data                                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_chunk_pack_values(unsigned char value_type, const zbx_history_record_t *values, int values_num,
+		unsigned char *data)
+{
+	unsigned char	*ptr = data;
+	zbx_int64_t	delta, prev_delta = 0;
+	zbx_uint64_t	prev_value = 0;
+	int		i, prev_sec = values[0].timestamp.sec;
+
+	for (i = 0; i < values_num; i++)
+	{
+		delta = (zbx_int64_t)values[i].timestamp.sec - prev_sec;
+		ptr = vc_encode_varint(ptr, vc_zigzag_encode(delta - prev_delta));
+		ptr = vc_encode_varint(ptr, (zbx_uint64_t)values[i].timestamp.ns);
+
+		if (ITEM_VALUE_TYPE_FLOAT == value_type)
+			ptr = vc_encode_xor(ptr, values[i].value.ui64 ^ prev_value);
+		else
+			ptr = vc_encode_varint(ptr, vc_zigzag_encode((zbx_int64_t)(values[i].value.ui64 - prev_value)));
+
+		prev_sec = values[i].timestamp.sec;
+		prev_delta = delta;
+		prev_value = values[i].value.ui64;
+	}
+
+	return (int)(ptr - data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: decodes values of packed chunk                                    *
+ *                                                                            *
+ * Parameters: value_type - [IN] the value type (FLOAT or UINT64)             *
+ *             chunk      - [IN] the packed chunk                             *
+ *             values     - [OUT] the decoded values                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_chunk_unpack_values(unsigned char value_type, const zbx_vc_chunk_t *chunk,
+		zbx_history_record_t *values)
+{
+	const zbx_vc_packed_t	*packed = VC_PACKED_CHUNK(chunk);
+	const unsigned char	*ptr = packed->data;
+	zbx_int64_t		delta = 0;
+	zbx_uint64_t		value, prev_value = 0;
+	int			i, sec = packed->first_ts.sec;
+
+	for (i = 0; i <= chunk->last_value; i++)
+	{
+		ptr = vc_decode_varint(ptr, &value);
+		delta += vc_zigzag_decode(value);
+		sec += (int)delta;
+		values[i].timestamp.sec = sec;
+
+		ptr = vc_decode_varint(ptr, &value);
+		values[i].timestamp.ns = (int)value;
+
+		if (ITEM_VALUE_TYPE_FLOAT == value_type)
+		{
+			ptr = vc_decode_xor(ptr, &value);
+			values[i].value.ui64 = prev_value ^ value;
+		}
+		else
+		{
+			ptr = vc_decode_varint(ptr, &value);
+			values[i].value.ui64 = prev_value + (zbx_uint64_t)vc_zigzag_decode(value);
+		}
+
+		prev_value = values[i].value.ui64;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns the size of memory allocated for chunk                    *
+ *                                                                            *
+ ******************************************************************************/
+static size_t	vch_chunk_size(const zbx_vc_chunk_t *chunk)
+{
+	if (0 != chunk->packed_size)
+	{
+		return offsetof(zbx_vc_chunk_t, slots) + offsetof(zbx_vc_packed_t, data) +
+				(size_t)chunk->packed_size;
+	}
+
+	return sizeof(zbx_vc_chunk_t) + sizeof(zbx_history_record_t) * (size_t)(chunk->slots_num - 1);
+}
+
+static const zbx_timespec_t	*vch_chunk_first_ts(const zbx_vc_chunk_t *chunk)
+{
+	if (0 != chunk->packed_size)
+		return &VC_PACKED_CHUNK(chunk)->first_ts;
+
+	return &chunk->slots[chunk->first_value].timestamp;
+}
+
+static const zbx_timespec_t	*vch_chunk_last_ts(const zbx_vc_chunk_t *chunk)
+{
+	if (0 != chunk->packed_size)
+		return &VC_PACKED_CHUNK(chunk)->last_ts;
+
+	return &chunk->slots[chunk->last_value].timestamp;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns chunk values for reading                                  *
+ *                                                                            *
+ * Parameters: value_type - [IN] the value type                               *
+ *             chunk      - [IN] the chunk                                    *
+ *                                                                            *
+ * Return value: The chunk value slots. Values of packed chunks are decoded   *
+ *               into process local buffer, which is valid until the next     *
+ *               packed chunk is read.                                        *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_history_record_t	*vch_chunk_get_values(unsigned char value_type, const zbx_vc_chunk_t *chunk)
+{
+	if (0 == chunk->packed_size)
+		return (zbx_history_record_t *)chunk->slots;
+
+	if (NULL == vc_unpacked)
+		vc_unpacked = (zbx_history_record_t *)zbx_malloc(NULL, sizeof(zbx_history_record_t) *
+				ZBX_VC_MAX_CHUNK_RECORDS);
+
+	vch_chunk_unpack_values(value_type, chunk, vc_unpacked);
+
+	return vc_unpacked;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: replaces chunk in item's chunk list                               *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_replace_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk, zbx_vc_chunk_t *new_chunk)
+{
+	new_chunk->prev = chunk->prev;
+	new_chunk->next = chunk->next;
+
+	if (NULL != chunk->prev)
+		chunk->prev->next = new_chunk;
+	else
+		item->tail = new_chunk;
+
+	if (NULL != chunk->next)
+		chunk->next->prev = new_chunk;
+	else
+		item->head = new_chunk;
+
+	__vc_shmem_free_func(chunk);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: packs values of numeric item chunk                                *
+ *                                                                            *
+ * Parameters: item  - [IN] the chunk owner item                              *
+ *             chunk - [IN] the chunk to pack                                 *
+ *                                                                            *
+ * Comments: Packing is an optimization - the chunk is left as it is if the   *
+ *           packed data would not be smaller or there is not enough memory.  *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_pack_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk)
+{
+	unsigned char	*data;
+	int		values_num, data_size;
+	size_t		size;
+	zbx_vc_chunk_t	*packed_chunk;
+	zbx_vc_packed_t	*packed;
+
+	if ((ITEM_VALUE_TYPE_FLOAT != item->value_type && ITEM_VALUE_TYPE_UINT64 != item->value_type) ||
+			0 != chunk->packed_size)
+	{
+		return;
+	}
+
+	values_num = chunk->last_value - chunk->first_value + 1;
+	data = (unsigned char *)zbx_malloc(NULL, (size_t)values_num * VC_PACKED_RECORD_MAX);
+	data_size = vch_chunk_pack_values(item->value_type, chunk->slots + chunk->first_value, values_num, data);
+
+	size = offsetof(zbx_vc_chunk_t, slots) + offsetof(zbx_vc_packed_t, data) + (size_t)data_size;
+
+	/* don't release space from other items just to pack this chunk */
+	if (size >= vch_chunk_size(chunk) || NULL == (packed_chunk = (zbx_vc_chunk_t *)__vc_shmem_malloc_func(NULL,
+			size)))
+	{
+		goto out;
+	}
+
+	packed_chunk->first_value = 0;
+	packed_chunk->last_value = values_num - 1;
+	packed_chunk->slots_num = values_num;
+	packed_chunk->packed_size = data_size;
+
+	packed = VC_PACKED_CHUNK(packed_chunk);
+	packed->first_ts = chunk->slots[chunk->first_value].timestamp;
+	packed->last_ts = chunk->slots[chunk->last_value].timestamp;
+	memcpy(packed->data, data, (size_t)data_size);
+
+	vch_item_replace_chunk(item, chunk, packed_chunk);
+out:
+	zbx_free(data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: unpacks chunk values back into slots so they can be modified      *
+ *                                                                            *
+ * Parameters: item  - [IN] the chunk owner item                              *
+ *             chunk - [IN] the chunk to unpack                               *
+ *                                                                            *
+ * Return value: The unpacked chunk (the same chunk if it was not packed) or  *
+ *               NULL if there was not enough memory.                         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_vc_chunk_t	*vch_item_unpack_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk)
+{
+	zbx_vc_chunk_t	*unpacked_chunk;
+	int		values_num;
+
+	if (0 == chunk->packed_size)
+		return chunk;
+
+	values_num = chunk->last_value + 1;
+
+	if (NULL == (unpacked_chunk = (zbx_vc_chunk_t *)vc_item_malloc(item, sizeof(zbx_vc_chunk_t) +
+			sizeof(zbx_history_record_t) * (size_t)(values_num - 1))))
+	{
+		return NULL;
+	}
+
+	unpacked_chunk->first_value = 0;
+	unpacked_chunk->last_value = values_num - 1;
+	unpacked_chunk->slots_num = values_num;
+	unpacked_chunk->packed_size = 0;
+	vch_chunk_unpack_values(item->value_type, chunk, unpacked_chunk->slots);
+
+	vch_item_replace_chunk(item, chunk, unpacked_chunk);
+
+	return unpacked_chunk;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: updates item range with current request range                     *
@@ -1320,7 +1697,7 @@ static void	vch_item_update_range(zbx_vc_item_t *item, int range, int now)
 		diff += 0xff;
 
 	if (NULL != item->head)
-		last_value_timestamp = item->head->slots[item->head->last_value].timestamp.sec;
+		last_value_timestamp = vch_chunk_last_ts(item->head)->sec;
 	else
 		last_value_timestamp = now;
 
@@ -1428,8 +1805,9 @@ static int	vch_item_add_chunk(zbx_vc_item_t *item, int nslots, zbx_vc_chunk_t *i
  * Purpose: find the index of the last value in chunk with timestamp less or  *
  *          equal to the specified timestamp.                                 *
  *                                                                            *
- * Parameters:  chunk - [IN] the chunk                                        *
- *              ts    - [IN] the target timestamp                             *
+ * Parameters:  value_type - [IN] the value type                              *
+ *              chunk      - [IN] the chunk                                   *
+ *              ts         - [IN] the target timestamp                        *
  *                                                                            *
  * Return value: The index of the last value in chunk with timestamp less or  *
  *               equal to the specified timestamp.                            *
@@ -1437,30 +1815,34 @@ static int	vch_item_add_chunk(zbx_vc_item_t *item, int nslots, zbx_vc_chunk_t *i
  *               values have timestamps greater than the target timestamp).   *
  *                                                                            *
  ******************************************************************************/
-static int	vch_chunk_find_last_value_before(const zbx_vc_chunk_t *chunk, const zbx_timespec_t *ts)
+static int	vch_chunk_find_last_value_before(unsigned char value_type, const zbx_vc_chunk_t *chunk,
+		const zbx_timespec_t *ts)
 {
-	int	start = chunk->first_value, end = chunk->last_value, middle;
+	int			start = chunk->first_value, end = chunk->last_value, middle;
+	zbx_history_record_t	*slots;
 
 	/* check if the last value timestamp is already greater or equal to the specified timestamp */
-	if (0 >= zbx_timespec_compare(&chunk->slots[end].timestamp, ts))
+	if (0 >= zbx_timespec_compare(vch_chunk_last_ts(chunk), ts))
 		return end;
 
 	/* chunk contains only one value, which did not pass the above check, return failure */
 	if (start == end)
 		return -1;
 
+	slots = vch_chunk_get_values(value_type, chunk);
+
 	/* perform value lookup using binary search */
 	while (start != end)
 	{
 		middle = start + (end - start) / 2;
 
-		if (0 < zbx_timespec_compare(&chunk->slots[middle].timestamp, ts))
+		if (0 < zbx_timespec_compare(&slots[middle].timestamp, ts))
 		{
 			end = middle;
 			continue;
 		}
 
-		if (0 >= zbx_timespec_compare(&chunk->slots[middle + 1].timestamp, ts))
+		if (0 >= zbx_timespec_compare(&slots[middle + 1].timestamp, ts))
 		{
 			start = middle;
 			continue;
@@ -1502,16 +1884,16 @@ static int	vch_item_get_last_value(const zbx_vc_item_t *item, const zbx_timespec
 
 	index = chunk->last_value;
 
-	if (0 < zbx_timespec_compare(&chunk->slots[index].timestamp, ts))
+	if (0 < zbx_timespec_compare(vch_chunk_last_ts(chunk), ts))
 	{
-		while (0 < zbx_timespec_compare(&chunk->slots[chunk->first_value].timestamp, ts))
+		while (0 < zbx_timespec_compare(vch_chunk_first_ts(chunk), ts))
 		{
 			chunk = chunk->prev;
 			/* there are no values for requested range, return failure */
 			if (NULL == chunk)
 				return FAIL;
 		}
-		index = vch_chunk_find_last_value_before(chunk, ts);
+		index = vch_chunk_find_last_value_before(item->value_type, chunk, ts);
 	}
 
 	*pchunk = chunk;
@@ -1642,7 +2024,7 @@ static size_t	vch_item_free_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk)
 {
 	size_t	freed;
 
-	freed = sizeof(zbx_vc_chunk_t) + (size_t)(chunk->slots_num - 1) * sizeof(zbx_history_record_t);
+	freed = vch_chunk_size(chunk);
 	freed += vc_item_free_values(item, chunk->slots, chunk->first_value, chunk->last_value);
 
 	__vc_shmem_free_func(chunk);
@@ -1698,9 +2080,8 @@ static void	vch_item_clean_cache(zbx_vc_item_t *item, int timestamp)
 		/* Try to remove chunks with all history values older than maximum request range, maximum */
 		/* request range should be calculated from last received value with which active range    */
 		/* was calculated to avoid dropping of chunks that might be still used in count request.  */
-		while (NULL != chunk && chunk->slots[chunk->last_value].timestamp.sec < timestamp &&
-				chunk->slots[chunk->last_value].timestamp.sec !=
-						item->head->slots[item->head->last_value].timestamp.sec)
+		while (NULL != chunk && vch_chunk_last_ts(chunk)->sec < timestamp &&
+				vch_chunk_last_ts(chunk)->sec != vch_chunk_last_ts(item->head)->sec)
 		{
 			/* don't remove the head chunk */
 			if (NULL == (next = chunk->next))
@@ -1714,10 +2095,17 @@ static void	vch_item_clean_cache(zbx_vc_item_t *item, int timestamp)
 			/* In this case increase the first value index of the next chunk until the first  */
 			/* value timestamp is greater.                                                    */
 
-			if (next->slots[next->first_value].timestamp.sec != next->slots[next->last_value].timestamp.sec)
+			if (vch_chunk_first_ts(next)->sec != vch_chunk_last_ts(next)->sec)
 			{
+				if (vch_chunk_first_ts(next)->sec == vch_chunk_last_ts(chunk)->sec &&
+						NULL == (next = vch_item_unpack_chunk(item, next)))
+				{
+					/* keeping more values than necessary is safe, retry on the next cleanup */
+					break;
+				}
+
 				while (next->slots[next->first_value].timestamp.sec ==
-						chunk->slots[chunk->last_value].timestamp.sec)
+						vch_chunk_last_ts(chunk)->sec)
 				{
 					vc_item_free_values(item, next->slots, next->first_value, next->first_value);
 					next->first_value++;
@@ -1725,7 +2113,7 @@ static void	vch_item_clean_cache(zbx_vc_item_t *item, int timestamp)
 			}
 
 			/* set the database cached from timestamp to the last (oldest) removed value timestamp + 1 */
-			item->db_cached_from = chunk->slots[chunk->last_value].timestamp.sec + 1;
+			item->db_cached_from = vch_chunk_last_ts(chunk)->sec + 1;
 
 			vch_item_remove_chunk(item, chunk);
 
@@ -1747,8 +2135,12 @@ static void	vch_item_clean_cache(zbx_vc_item_t *item, int timestamp)
  *              timestamp - [IN] the timestamp (number of seconds since the   *
  *                               Epoch)                                       *
  *                                                                            *
+ * Return value: SUCCEED - the values were removed                            *
+ *               FAIL - not enough memory to unpack the chunk containing      *
+ *                      values to remove                                      *
+ *                                                                            *
  ******************************************************************************/
-static void	vch_item_remove_values(zbx_vc_item_t *item, int timestamp)
+static int	vch_item_remove_values(zbx_vc_item_t *item, int timestamp)
 {
 	zbx_vc_chunk_t	*chunk = item->tail;
 
@@ -1756,15 +2148,18 @@ static void	vch_item_remove_values(zbx_vc_item_t *item, int timestamp)
 		item->status = 0;
 
 	/* try to remove chunks with all history values older than the timestamp */
-	while (NULL != chunk && chunk->slots[chunk->first_value].timestamp.sec < timestamp)
+	while (NULL != chunk && vch_chunk_first_ts(chunk)->sec < timestamp)
 	{
 		zbx_vc_chunk_t	*next;
 
 		/* If chunk contains values with timestamp greater or equal - remove */
 		/* only the values with less timestamp. Otherwise remove the while   */
 		/* chunk and check next one.                                         */
-		if (chunk->slots[chunk->last_value].timestamp.sec >= timestamp)
+		if (vch_chunk_last_ts(chunk)->sec >= timestamp)
 		{
+			if (NULL == (chunk = vch_item_unpack_chunk(item, chunk)))
+				return FAIL;
+
 			while (chunk->slots[chunk->first_value].timestamp.sec < timestamp)
 			{
 				vc_item_free_values(item, chunk->slots, chunk->first_value, chunk->first_value);
@@ -1778,6 +2173,8 @@ static void	vch_item_remove_values(zbx_vc_item_t *item, int timestamp)
 		vch_item_remove_chunk(item, chunk);
 		chunk = next;
 	}
+
+	return SUCCEED;
 }
 
 /******************************************************************************
@@ -1800,15 +2197,15 @@ static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_rec
 	int		ret = FAIL, index, sindex, nslots = 0;
 	zbx_vc_chunk_t	*chunk, *schunk;
 
-	if (NULL != item->head &&
-			0 < zbx_history_record_compare_asc_func(&item->head->slots[item->head->last_value], value))
+	if (NULL != item->head && 0 < zbx_timespec_compare(vch_chunk_last_ts(item->head), &value->timestamp))
 	{
-		if (0 < zbx_history_record_compare_asc_func(&item->tail->slots[item->tail->first_value], value))
+		if (0 < zbx_timespec_compare(vch_chunk_first_ts(item->tail), &value->timestamp))
 		{
 			/* If the added value has the same or older timestamp as the first value in cache */
 			/* we can't add it to keep cache consistency. Additionally we must make sure no   */
 			/* values with matching timestamp seconds are kept in cache.                      */
-			vch_item_remove_values(item, value->timestamp.sec + 1);
+			if (SUCCEED != vch_item_remove_values(item, value->timestamp.sec + 1))
+				goto out;
 
 			/* empty items must be removed to avoid situation when a new value is added to cache */
 			/* while other values with matching timestamp seconds are not cached                 */
@@ -1857,6 +2254,12 @@ static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_rec
 					goto out;
 				}
 
+				if (NULL == (schunk = vch_item_unpack_chunk(item, schunk)))
+				{
+					memset(&chunk->slots[index], 0, sizeof(zbx_history_record_t));
+					goto out;
+				}
+
 				sindex = schunk->last_value;
 			}
 		}
@@ -1872,6 +2275,10 @@ static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_rec
 		{
 			if (FAIL == vch_item_add_chunk(item, vch_item_chunk_slot_count(item, 1), NULL))
 				goto out;
+
+			/* the previous head chunk is full and will not receive new values */
+			if (NULL != item->head->prev)
+				vch_item_pack_chunk(item, item->head->prev);
 		}
 		else
 			item->head->last_value++;
@@ -1913,7 +2320,7 @@ static int	vch_item_add_values_at_tail(zbx_vc_item_t *item, const zbx_history_re
 	/* skip values already added to the item cache by another process */
 	if (NULL != item->tail)
 	{
-		int	sec = item->tail->slots[item->tail->first_value].timestamp.sec;
+		int	sec = vch_chunk_first_ts(item->tail)->sec;
 
 		while (--count >= 0 && values[count].timestamp.sec >= sec)
 			;
@@ -1937,6 +2344,10 @@ static int	vch_item_add_values_at_tail(zbx_vc_item_t *item, const zbx_history_re
 
 			item->tail->last_value = nslots - 1;
 			item->tail->first_value = nslots;
+
+			/* the previous tail chunk is full, pack it unless it's also the head chunk */
+			if (NULL != item->tail->next && item->head != item->tail->next)
+				vch_item_pack_chunk(item, item->tail->next);
 		}
 
 		/* copy values to chunk */
@@ -1984,7 +2395,7 @@ static int	vch_item_cache_values_by_time(zbx_vc_item_t **item, int range_start)
 	if (NULL != (*item)->tail)
 	{
 		/* we need to get item values before the first cached value, but not including it */
-		range_end = (*item)->tail->slots[(*item)->tail->first_value].timestamp.sec - 1;
+		range_end = vch_chunk_first_ts((*item)->tail)->sec - 1;
 	}
 	else
 		range_end = ZBX_JAN_2038;
@@ -2093,7 +2504,7 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 
 	/* get the end timestamp to which (including) the values should be cached */
 	if (0 != (*item)->db_cached_from && NULL != (*item)->head)
-		range_end = (*item)->tail->slots[(*item)->tail->first_value].timestamp.sec - 1;
+		range_end = vch_chunk_first_ts((*item)->tail)->sec - 1;
 	else
 		range_end = ZBX_JAN_2038;
 
@@ -2151,8 +2562,7 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 
 	if ((count <= records.values_num || 0 == range_start) && 0 != records.values_num)
 	{
-		vc_item_update_db_cached_from(*item,
-				(*item)->tail->slots[(*item)->tail->first_value].timestamp.sec);
+		vc_item_update_db_cached_from(*item, vch_chunk_first_ts((*item)->tail)->sec);
 	}
 	else if (0 != range_start)
 		vc_item_update_db_cached_from(*item, range_start);
@@ -2177,9 +2587,10 @@ out:
 static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_history_record_t *values, int seconds,
 		const zbx_timespec_t *ts)
 {
-	int		index, now;
-	zbx_timespec_t	start = {ts->sec - seconds, ts->ns};
-	zbx_vc_chunk_t	*chunk;
+	int			index, now;
+	zbx_timespec_t		start = {ts->sec - seconds, ts->ns};
+	zbx_vc_chunk_t		*chunk;
+	zbx_history_record_t	*slots;
 
 	now = (int)time(NULL);
 	/* add another second to include nanosecond shifts */
@@ -2193,10 +2604,12 @@ static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_hi
 	}
 
 	/* fill the values vector with item history values until the start timestamp is reached */
-	while (0 < zbx_timespec_compare(&chunk->slots[chunk->last_value].timestamp, &start))
+	while (0 < zbx_timespec_compare(vch_chunk_last_ts(chunk), &start))
 	{
-		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&chunk->slots[index].timestamp, &start))
-			vc_history_record_vector_append(values, item->value_type, &chunk->slots[index--]);
+		slots = vch_chunk_get_values(item->value_type, chunk);
+
+		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&slots[index].timestamp, &start))
+			vc_history_record_vector_append(values, item->value_type, &slots[index--]);
 
 		if (NULL == (chunk = chunk->prev))
 			break;
@@ -2223,9 +2636,10 @@ static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_hi
 static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vector_history_record_t *values,
 		int seconds, int count, const zbx_timespec_t *ts)
 {
-	int		index, now, range_timestamp;
-	zbx_vc_chunk_t	*chunk;
-	zbx_timespec_t	start;
+	int			index, now, range_timestamp;
+	zbx_vc_chunk_t		*chunk;
+	zbx_timespec_t		start;
+	zbx_history_record_t	*slots;
 
 	/* set start timestamp of the requested time period */
 	if (0 != seconds)
@@ -2248,11 +2662,13 @@ static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vecto
 	/* fill the values vector with item history values until the <count> values are read    */
 	/* or no more values within specified time period                                       */
 	/* fill the values vector with item history values until the start timestamp is reached */
-	while (0 < zbx_timespec_compare(&chunk->slots[chunk->last_value].timestamp, &start))
+	while (0 < zbx_timespec_compare(vch_chunk_last_ts(chunk), &start))
 	{
-		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&chunk->slots[index].timestamp, &start))
+		slots = vch_chunk_get_values(item->value_type, chunk);
+
+		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&slots[index].timestamp, &start))
 		{
-			vc_history_record_vector_append(values, item->value_type, &chunk->slots[index--]);
+			vc_history_record_vector_append(values, item->value_type, &slots[index--]);
 
 			if (values->values_num == count)
 				goto out;
@@ -2585,7 +3001,7 @@ int	zbx_vc_add_values(zbx_vector_dc_history_ptr_t *history, int *ret_flush, int
 			int			last_value_timestamp;
 
 			if (NULL != head)
-				last_value_timestamp = head->slots[head->last_value].timestamp.sec;
+				last_value_timestamp = vch_chunk_last_ts(head)->sec;
 			else
 				last_value_timestamp = (int)time(NULL);
 
@@ -378,6 +378,22 @@ void	zbx_socket_clean(zbx_socket_t *s)
 	s->buf_type = ZBX_BUF_TYPE_STAT;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free state of message being uncompressed while received           *
+ *                                                                            *
+ ******************************************************************************/
+static void	tcp_recv_stream_close(zbx_socket_t *s)
+{
+	if (NULL != s->recv_stream)
+	{
+		zbx_uncompress_stream_free(s->recv_stream);
+		s->recv_stream = NULL;
+	}
+
+	zbx_free(s->recv_chunk);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: free socket's dynamic buffer                                      *
@@ -387,6 +403,8 @@ static void	zbx_socket_free(zbx_socket_t *s)
 {
 	if (ZBX_BUF_TYPE_DYN == s->buf_type)
 		zbx_free(s->buffer);
+
+	tcp_recv_stream_close(s);
 }
 
 /******************************************************************************
@@ -812,6 +830,60 @@ ssize_t	zbx_tcp_write(zbx_socket_t *s, const char *buf, size_t len, short *event
 #define ZBX_TCP_HEADER_DATA	"ZBXD"
 #define ZBX_TCP_HEADER_LEN	ZBX_CONST_STRLEN(ZBX_TCP_HEADER_DATA)
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get protocol header flags for compression codec                   *
+ *                                                                            *
+ * Parameters: codec - [IN] ZBX_COMPRESS_* codec                              *
+ *                                                                            *
+ * Return value: ZBX_TCP_COMPRESS with codec flags                            *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_tcp_compress_flags(unsigned char codec)
+{
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZSTD:
+			return ZBX_TCP_COMPRESS | ZBX_TCP_ZSTD;
+		case ZBX_COMPRESS_LZ4:
+			return ZBX_TCP_COMPRESS | ZBX_TCP_LZ4;
+		default:
+			return ZBX_TCP_COMPRESS;
+	}
+}
+
+static unsigned char	tcp_flags_codec(unsigned char flags)
+{
+	if (0 != (flags & ZBX_TCP_ZSTD))
+		return ZBX_COMPRESS_ZSTD;
+
+	if (0 != (flags & ZBX_TCP_LZ4))
+		return ZBX_COMPRESS_LZ4;
+
+	return ZBX_COMPRESS_ZLIB;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compression codec to be used for data sent over socket        *
+ *                                                                            *
+ * Parameters: s - [IN] socket                                                *
+ *                                                                            *
+ * Return value: ZBX_COMPRESS_* codec                                         *
+ *                                                                            *
+ * Comments: When compressed data was received from the socket, the same      *
+ *           codec is used for sending. Otherwise zlib is used, as the peer   *
+ *           might not support other codecs.                                  *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_tcp_get_compress_codec(const zbx_socket_t *s)
+{
+	if (0 != (s->protocol & ZBX_TCP_COMPRESS))
+		return tcp_flags_codec((unsigned char)s->protocol);
+
+	return ZBX_COMPRESS_ZLIB;
+}
+
 int	zbx_tcp_send_context_init(const char *data, size_t len, size_t reserved, unsigned char flags,
 		zbx_tcp_send_context_t *context)
 {
@@ -849,7 +921,8 @@ int	zbx_tcp_send_context_init(const char *data, size_t len, size_t reserved, uns
 		/* compress if not compressed yet */
 		if (0 == reserved)
 		{
-			if (SUCCEED != zbx_compress(data, len, &context->compressed_data, &context->send_len))
+			if (SUCCEED != zbx_compress_ext(tcp_flags_codec(flags), data, len, &context->compressed_data,
+					&context->send_len))
 			{
 				zbx_set_socket_strerror("cannot compress data: %s", zbx_compress_strerror());
 
@@ -989,6 +1062,10 @@ int	zbx_tcp_send_ext(zbx_socket_t *s, const char *data, size_t len, size_t reser
 	if (0 != timeout)
 		zbx_socket_set_deadline(s, timeout);
 
+	/* data not compressed yet is compressed with the codec negotiated for the socket */
+	if (0 != (flags & ZBX_TCP_COMPRESS) && 0 == reserved && 0 == (flags & ZBX_TCP_CODEC_MASK))
+		flags |= zbx_tcp_compress_flags(zbx_tcp_get_compress_codec(s));
+
 	if (SUCCEED == (ret = zbx_tcp_send_context_init(data, len, reserved, flags, &context)))
 	{
 		ret = zbx_tcp_send_context(s, &context, NULL);
@@ -1586,84 +1663,37 @@ void	zbx_tcp_unlisten(zbx_socket_t *s)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: permits an incoming connection attempt on a socket                *
+ * Purpose: accepts pending connection on one of listening sockets            *
  *                                                                            *
- * Parameters: s              - [IN/OUT] socket to listen                     *
- *             tls_accept     - [IN] TLS configuration                        *
- *             poll_timeout   - [IN] milliseconds to wait for connection      *
- *                                  0 - don't wait, -1 - wait forever         *
- *             tls_listen     - [IN] allow unencrypted inbound                *
- *             unencrypted_allowed_ip - [IN]                                  *
+ * Parameters: s             - [IN/OUT] listening socket, the accepted        *
+ *                                      connection replaces its main socket   *
+ *             listen_socket - [IN] listening socket with pending connection  *
  *                                                                            *
  * Return value: SUCCEED       - success                                      *
  *               FAIL          - an error occurred                            *
- *               TIMEOUT_ERROR - no connections for the timeout period        *
+ *               TIMEOUT_ERROR - connection was not pending anymore           *
+ *                                                                            *
+ * Comments: On failure the connection must be closed with                    *
+ *           zbx_tcp_unaccept().                                              *
  *                                                                            *
  ******************************************************************************/
-int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, char *tls_listen,
-		const char *unencrypted_allowed_ip)
+int	zbx_tcp_accept_connection(zbx_socket_t *s, ZBX_SOCKET listen_socket)
 {
 	ZBX_SOCKADDR	serv_addr;
 	ZBX_SOCKET	accepted_socket;
 	ZBX_SOCKLEN_T	nlen;
-	int		i, ret = FAIL;
-	ssize_t		res;
-	char		buf;	/* 1 byte buffer */
-	zbx_pollfd_t	*pds;
-
-	zbx_tcp_unaccept(s);
-
-	pds = (zbx_pollfd_t *)zbx_malloc(NULL, sizeof(zbx_pollfd_t) * (size_t)s->num_socks);
-
-	for (i = 0; i < s->num_socks; i++)
-	{
-		pds[i].fd = s->sockets[i];
-		pds[i].events = POLLIN;
-	}
-
-	if (ZBX_PROTO_ERROR == (ret = zbx_socket_poll(pds, (unsigned long)s->num_socks, poll_timeout * 1000)))
-	{
-		if (SUCCEED == zbx_socket_had_nonblocking_error())
-			ret = TIMEOUT_ERROR;
-		else
-			zbx_set_socket_strerror("poll() failed: %s", zbx_strerror_from_system(zbx_socket_last_error()));
-
-		goto out;
-	}
-
-	if (0 == ret)
-	{
-		ret = TIMEOUT_ERROR;
-		goto out;
-	}
-
-	for (i = 0; i < s->num_socks; i++)
-	{
-		if (0 != (pds[i].revents & POLLIN))
-			break;
-	}
-
-	if (i == s->num_socks)
-	{
-		zbx_set_socket_strerror("incoming connection has failed");
-		goto out;
-	}
 
-	/* Since this socket was returned by poll, we know we have */
-	/* a connection waiting and that this accept() will not block. */
 	nlen = sizeof(serv_addr);
-	if (ZBX_SOCKET_ERROR == (accepted_socket = (ZBX_SOCKET)accept(s->sockets[i], (struct sockaddr *)&serv_addr,
+	if (ZBX_SOCKET_ERROR == (accepted_socket = (ZBX_SOCKET)accept(listen_socket, (struct sockaddr *)&serv_addr,
 			&nlen)))
 	{
+		/* listening sockets are non-blocking, connection could have been taken by other process */
 		if (SUCCEED == zbx_socket_had_nonblocking_error())
-			ret = TIMEOUT_ERROR;
-		else
-		{
-			zbx_set_socket_strerror("accept() failed: %s",
-					zbx_strerror_from_system(zbx_socket_last_error()));
-		}
+			return TIMEOUT_ERROR;
 
-		goto out;
+		zbx_set_socket_strerror("accept() failed: %s", zbx_strerror_from_system(zbx_socket_last_error()));
+
+		return FAIL;
 	}
 
 	s->socket_orig = s->socket;	/* remember main socket */
@@ -1674,25 +1704,70 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, c
 	{
 		zbx_set_socket_strerror("failed to set socket non-blocking mode: %s",
 				zbx_strerror_from_system(zbx_socket_last_error()));
-		zbx_tcp_unaccept(s);
-		goto out;
+		return FAIL;
 	}
 
+	/* cannot get peer IP address */
 	if (SUCCEED != zbx_socket_peer_ip_save(s))
-	{
-		/* cannot get peer IP address */
-		zbx_tcp_unaccept(s);
-		goto out;
-	}
+		return FAIL;
 
-	zbx_socket_set_deadline(s, s->timeout);
+	return SUCCEED;
+}
 
-	if (FAIL == (res = tcp_peek(s, &buf, 1)) || TIMEOUT_ERROR == res)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: establishes connection security on accepted connection - either   *
+ *          performs TLS handshake or checks if unencrypted connection is     *
+ *          allowed                                                           *
+ *                                                                            *
+ * Parameters: s              - [IN/OUT] accepted connection                  *
+ *             tls_accept     - [IN] TLS configuration                        *
+ *             tls_listen     - [IN] allow unencrypted inbound                *
+ *             unencrypted_allowed_ip - [IN]                                  *
+ *             event          - [OUT] optional, socket event to wait for      *
+ *                                    before calling this function again.     *
+ *                                    Without it the function blocks until    *
+ *                                    socket deadline.                        *
+ *                                                                            *
+ * Return value: SUCCEED - success                                            *
+ *               FAIL    - an error occurred or, if event is set, the         *
+ *                         connection is not ready yet                        *
+ *                                                                            *
+ * Comments: On failure (event not set) the connection must be closed with    *
+ *           zbx_tcp_unaccept().                                              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tcp_accept_handshake(zbx_socket_t *s, unsigned int tls_accept, char *tls_listen,
+		const char *unencrypted_allowed_ip, short *event)
+{
+	ssize_t	res = 1;
+	char	buf = '\x16';	/* 1 byte buffer, TLS record type is assumed when resuming TLS handshake */
+
+	if (NULL != event)
+		*event = 0;
+
+#if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
+	if (NULL == s->tls_ctx)
+#endif
 	{
-		zbx_set_socket_strerror("from %s: reading first byte from connection failed: %s", s->peer,
-				zbx_strerror_from_system(zbx_socket_last_error()));
-		zbx_tcp_unaccept(s);
-		goto out;
+		if (NULL != event)
+		{
+			if (ZBX_PROTO_ERROR == (res = ZBX_TCP_RECV(s->socket, &buf, 1, MSG_PEEK)) &&
+					SUCCEED == zbx_socket_had_nonblocking_error())
+			{
+				*event = POLLIN;
+				return FAIL;
+			}
+		}
+		else
+			res = tcp_peek(s, &buf, 1);
+
+		if (FAIL == res || TIMEOUT_ERROR == res)
+		{
+			zbx_set_socket_strerror("from %s: reading first byte from connection failed: %s", s->peer,
+					zbx_strerror_from_system(zbx_socket_last_error()));
+			return FAIL;
+		}
 	}
 
 	/* if the 1st byte is 0x16 then assume it's a TLS connection */
@@ -1703,24 +1778,24 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, c
 		{
 			char	*error = NULL;
 
-			if (SUCCEED != zbx_tls_accept(s, tls_accept, &error))
+			if (SUCCEED != zbx_tls_accept(s, tls_accept, event, &error))
 			{
+				if (NULL != event && 0 != *event)
+					return FAIL;
+
 				zbx_set_socket_strerror("from %s: %s", s->peer, error);
-				zbx_tcp_unaccept(s);
 				zbx_free(error);
-				goto out;
+				return FAIL;
 			}
 		}
 		else
 		{
 			zbx_set_socket_strerror("from %s: TLS connections are not allowed", s->peer);
-			zbx_tcp_unaccept(s);
-			goto out;
+			return FAIL;
 		}
 #else
 		zbx_set_socket_strerror("from %s: support for TLS was not compiled in", s->peer);
-		zbx_tcp_unaccept(s);
-		goto out;
+		return FAIL;
 #endif
 	}
 	else
@@ -1728,8 +1803,7 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, c
 		if (0 == (tls_accept & ZBX_TCP_SEC_UNENCRYPTED))
 		{
 			zbx_set_socket_strerror("from %s: unencrypted connections are not allowed", s->peer);
-			zbx_tcp_unaccept(s);
-			goto out;
+			return FAIL;
 		}
 
 		s->connection_type = ZBX_TCP_SEC_UNENCRYPTED;
@@ -1742,8 +1816,7 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, c
 		if (NULL == unencrypted_allowed_ip || SUCCEED != zbx_tcp_check_allowed_peers(s, unencrypted_allowed_ip))
 		{
 			zbx_set_socket_strerror("from %s: unencrypted connections are not allowed", s->peer);
-			zbx_tcp_unaccept(s);
-			goto out;
+			return FAIL;
 		}
 		else
 		{
@@ -1752,9 +1825,87 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, c
 		}
 	}
 
-	zbx_socket_set_deadline(s, 0);
+	return SUCCEED;
+}
 
-	ret = SUCCEED;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: permits an incoming connection attempt on a socket                *
+ *                                                                            *
+ * Parameters: s              - [IN/OUT] socket to listen                     *
+ *             tls_accept     - [IN] TLS configuration                        *
+ *             poll_timeout   - [IN] milliseconds to wait for connection      *
+ *                                  0 - don't wait, -1 - wait forever         *
+ *             tls_listen     - [IN] allow unencrypted inbound                *
+ *             unencrypted_allowed_ip - [IN]                                  *
+ *                                                                            *
+ * Return value: SUCCEED       - success                                      *
+ *               FAIL          - an error occurred                            *
+ *               TIMEOUT_ERROR - no connections for the timeout period        *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout, char *tls_listen,
+		const char *unencrypted_allowed_ip)
+{
+	int		i, ret = FAIL;
+	zbx_pollfd_t	*pds;
+
+	zbx_tcp_unaccept(s);
+
+	pds = (zbx_pollfd_t *)zbx_malloc(NULL, sizeof(zbx_pollfd_t) * (size_t)s->num_socks);
+
+	for (i = 0; i < s->num_socks; i++)
+	{
+		pds[i].fd = s->sockets[i];
+		pds[i].events = POLLIN;
+	}
+
+	if (ZBX_PROTO_ERROR == (ret = zbx_socket_poll(pds, (unsigned long)s->num_socks, poll_timeout * 1000)))
+	{
+		if (SUCCEED == zbx_socket_had_nonblocking_error())
+			ret = TIMEOUT_ERROR;
+		else
+			zbx_set_socket_strerror("poll() failed: %s", zbx_strerror_from_system(zbx_socket_last_error()));
+
+		goto out;
+	}
+
+	if (0 == ret)
+	{
+		ret = TIMEOUT_ERROR;
+		goto out;
+	}
+
+	for (i = 0; i < s->num_socks; i++)
+	{
+		if (0 != (pds[i].revents & POLLIN))
+			break;
+	}
+
+	if (i == s->num_socks)
+	{
+		zbx_set_socket_strerror("incoming connection has failed");
+		ret = FAIL;
+		goto out;
+	}
+
+	/* Since this socket was returned by poll, we know we have */
+	/* a connection waiting and that this accept() will not block. */
+	if (SUCCEED != (ret = zbx_tcp_accept_connection(s, s->sockets[i])))
+	{
+		zbx_tcp_unaccept(s);
+		goto out;
+	}
+
+	zbx_socket_set_deadline(s, s->timeout);
+
+	if (SUCCEED != (ret = zbx_tcp_accept_handshake(s, tls_accept, tls_listen, unencrypted_allowed_ip, NULL)))
+	{
+		zbx_tcp_unaccept(s);
+		goto out;
+	}
+
+	zbx_socket_set_deadline(s, 0);
 out:
 	zbx_free(pds);
 
@@ -1986,6 +2137,30 @@ int	zbx_tcp_read_close_notify(zbx_socket_t *s, int timeout, short *events)
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if idle connection can be used for the next request        *
+ *                                                                            *
+ * Parameters: s - [IN] socket descriptor                                     *
+ *                                                                            *
+ * Return value: SUCCEED - connection was closed by the other side or it has  *
+ *                         unexpected pending data                            *
+ *               FAIL    - connection is idle and can be used                 *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tcp_peer_closed(zbx_socket_t *s)
+{
+	char	buf;
+
+	if (ZBX_PROTO_ERROR == ZBX_TCP_RECV(s->socket, &buf, 1, MSG_PEEK) &&
+			SUCCEED == zbx_socket_had_nonblocking_error())
+	{
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sets deadline for socket operations                               *
@@ -2022,6 +2197,130 @@ int	zbx_socket_check_deadline(zbx_socket_t *s)
 #define ZBX_TCP_EXPECT_LENGTH		4
 #define ZBX_TCP_EXPECT_SIZE		5
 
+/* size of chunks compressed data is read in when it is uncompressed while being received */
+#define ZBX_TCP_RECV_CHUNK_SIZE		(64 * ZBX_KIBIBYTE)
+
+/* peak memory used to receive single message by unencrypted, PSK and certificate connections */
+static ZBX_THREAD_LOCAL zbx_uint64_t	recv_peak_memory[3];
+
+static zbx_uint64_t	*tcp_recv_peak_memory(unsigned int connection_type)
+{
+	switch (connection_type)
+	{
+		case ZBX_TCP_SEC_TLS_PSK:
+			return &recv_peak_memory[1];
+		case ZBX_TCP_SEC_TLS_CERT:
+			return &recv_peak_memory[2];
+		default:
+			return &recv_peak_memory[0];
+	}
+}
+
+static void	tcp_recv_update_peak_memory(const zbx_socket_t *s, zbx_uint64_t memory)
+{
+	zbx_uint64_t	*peak = tcp_recv_peak_memory(s->connection_type);
+
+	if (memory <= *peak)
+		return;
+
+	*peak = memory;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "receiving message from %s used new peak of " ZBX_FS_UI64 " bytes of memory"
+			" for %s connections", s->peer, memory, zbx_tcp_connection_type_name(s->connection_type));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns peak memory used by this process to receive single        *
+ *          message over connection of specified type                         *
+ *                                                                            *
+ * Parameters: connection_type - [IN] ZBX_TCP_SEC_UNENCRYPTED,                *
+ *                                    ZBX_TCP_SEC_TLS_PSK or                  *
+ *                                    ZBX_TCP_SEC_TLS_CERT                    *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint64_t	zbx_tcp_recv_get_peak_memory(unsigned int connection_type)
+{
+	return *tcp_recv_peak_memory(connection_type);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets buffer where next received data must be read into            *
+ *                                                                            *
+ * Comments: Message body is read directly into buffer allocated for its      *
+ *           length, compressed message body is read in chunks that are       *
+ *           uncompressed into buffer allocated for uncompressed length.      *
+ *                                                                            *
+ ******************************************************************************/
+static char	*tcp_recv_buffer(zbx_socket_t *s, const zbx_tcp_recv_context_t *context, size_t *size)
+{
+	if (ZBX_BUF_TYPE_STAT == s->buf_type)
+	{
+		*size = sizeof(s->buf_stat) - context->buf_stat_bytes;
+		return s->buf_stat + context->buf_stat_bytes;
+	}
+
+	*size = (size_t)(context->expected_len - context->buf_dyn_bytes);
+
+	if (NULL != s->recv_stream)
+	{
+		if (ZBX_TCP_RECV_CHUNK_SIZE < *size)
+			*size = ZBX_TCP_RECV_CHUNK_SIZE;
+
+		return s->recv_chunk;
+	}
+
+	return s->buffer + context->buf_dyn_bytes;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares to uncompress large message while it is being received   *
+ *                                                                            *
+ * Return value: SUCCEED - uncompression stream was created and data          *
+ *                         received so far was uncompressed                   *
+ *               FAIL    - an error occurred                                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	tcp_recv_stream_open(zbx_socket_t *s, zbx_tcp_recv_context_t *context)
+{
+	char	*buffer;
+	size_t	len;
+
+	if (NULL == (buffer = (char *)malloc(context->reserved + 1)))
+	{
+		zbx_set_socket_strerror("cannot allocate memory to uncompress data: out of memory");
+		zabbix_log(LOG_LEVEL_WARNING, "Uncompressed message size " ZBX_FS_UI64 " from %s exceeds the"
+				" available memory size. Message ignored.", context->reserved, s->peer);
+		return FAIL;
+	}
+
+	if (NULL == (s->recv_stream = zbx_uncompress_stream_create(
+			tcp_flags_codec((unsigned char)context->protocol_version), buffer, context->reserved)))
+	{
+		zbx_free(buffer);
+		zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+		return FAIL;
+	}
+
+	s->recv_chunk = (char *)zbx_malloc(NULL, ZBX_TCP_RECV_CHUNK_SIZE);
+	s->buf_type = ZBX_BUF_TYPE_DYN;
+	s->buffer = buffer;
+
+	len = context->buf_stat_bytes - context->offset;
+	context->buf_dyn_bytes = len;
+	context->buf_stat_bytes = 0;
+
+	if (SUCCEED != zbx_uncompress_stream_write(s->recv_stream, s->buf_stat + context->offset, len))
+	{
+		zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
 void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv_context, unsigned char flags)
 {
 	tcp_recv_context->buf_dyn_bytes = 0;
@@ -2056,13 +2355,19 @@ void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv
 ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, unsigned char flags, short *events)
 {
 	ssize_t	nbytes;
+	char	*buf;
+	size_t	size;
 
 	if (NULL != events)
 		*events = 0;
 
-	while (0 != (nbytes = zbx_tcp_read(s, s->buf_stat + context->buf_stat_bytes,
-			sizeof(s->buf_stat) - context->buf_stat_bytes, events)))
+	for (;;)
 	{
+		buf = tcp_recv_buffer(s, context, &size);
+
+		if (0 == (nbytes = zbx_tcp_read(s, buf, size, events)))
+			break;
+
 		if (ZBX_PROTO_ERROR == nbytes)
 			goto out;
 
@@ -2070,8 +2375,14 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 			context->buf_stat_bytes += (size_t)nbytes;
 		else
 		{
-			if (context->buf_dyn_bytes + (size_t)nbytes <= context->expected_len)
-				memcpy(s->buffer + context->buf_dyn_bytes, s->buf_stat, (size_t)nbytes);
+			if (NULL != s->recv_stream &&
+					SUCCEED != zbx_uncompress_stream_write(s->recv_stream, buf, (size_t)nbytes))
+			{
+				zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+				nbytes = ZBX_PROTO_ERROR;
+				goto out;
+			}
+
 			context->buf_dyn_bytes += (size_t)nbytes;
 		}
 
@@ -2109,7 +2420,11 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 			context->protocol_version = s->buf_stat[ZBX_TCP_HEADER_LEN];
 
 			if (0 == (context->protocol_version & ZBX_TCP_PROTOCOL) ||
-					context->protocol_version > (ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS | flags))
+					0 != (context->protocol_version & ~(ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS |
+					ZBX_TCP_CODEC_MASK | flags)) ||
+					(0 != (context->protocol_version & ZBX_TCP_CODEC_MASK) &&
+					0 == (context->protocol_version & ZBX_TCP_COMPRESS)) ||
+					(ZBX_TCP_CODEC_MASK == (context->protocol_version & ZBX_TCP_CODEC_MASK)))
 			{
 				/* invalid protocol version, abort receiving */
 				break;
@@ -2178,6 +2493,16 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 				context->buf_stat_bytes -= context->offset;
 				memmove(s->buf_stat, s->buf_stat + context->offset, context->buf_stat_bytes);
 			}
+			else if (0 != (context->protocol_version & ZBX_TCP_COMPRESS) &&
+					SUCCEED == zbx_uncompress_stream_supported(
+					tcp_flags_codec((unsigned char)context->protocol_version)))
+			{
+				if (SUCCEED != tcp_recv_stream_open(s, context))
+				{
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+			}
 			else
 			{
 				char	*buffer;
@@ -2210,7 +2535,34 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 	{
 		if (context->buf_stat_bytes + context->buf_dyn_bytes == context->expected_len)
 		{
-			if (0 != (context->protocol_version & ZBX_TCP_COMPRESS))
+			if (NULL != s->recv_stream)
+			{
+				size_t	out_size;
+
+				if (SUCCEED != zbx_uncompress_stream_finish(s->recv_stream, &out_size))
+				{
+					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+
+				if (out_size != context->reserved)
+				{
+					zbx_set_socket_strerror("size of uncompressed data is less than expected");
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+
+				tcp_recv_stream_close(s);
+				s->read_bytes = context->reserved;
+				tcp_recv_update_peak_memory(s, context->reserved + 1 + ZBX_TCP_RECV_CHUNK_SIZE);
+
+				zabbix_log(LOG_LEVEL_TRACE, "%s(): received " ZBX_FS_SIZE_T " bytes with"
+						" compression ratio %.1f", __func__,
+						(zbx_fs_size_t)context->buf_dyn_bytes,
+						(double)context->reserved / (double)context->buf_dyn_bytes);
+			}
+			else if (0 != (context->protocol_version & ZBX_TCP_COMPRESS))
 			{
 				char	*out;
 				size_t	out_size = context->reserved;
@@ -2225,8 +2577,8 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 					goto out;
 				}
 
-				if (FAIL == zbx_uncompress(s->buffer, context->buf_stat_bytes + context->buf_dyn_bytes,
-						out, &out_size))
+				if (FAIL == zbx_uncompress_ext(tcp_flags_codec((unsigned char)context->protocol_version),
+						s->buffer, context->buf_stat_bytes + context->buf_dyn_bytes, out, &out_size))
 				{
 					zbx_free(out);
 					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
@@ -2243,7 +2595,12 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 				}
 
 				if (ZBX_BUF_TYPE_DYN == s->buf_type)
+				{
 					zbx_free(s->buffer);
+					tcp_recv_update_peak_memory(s, context->expected_len + context->reserved + 2);
+				}
+				else
+					tcp_recv_update_peak_memory(s, context->reserved + 1);
 
 				s->buf_type = ZBX_BUF_TYPE_DYN;
 				s->buffer = out;
@@ -2256,8 +2613,13 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 						context->buf_dyn_bytes));
 			}
 			else
+			{
 				s->read_bytes = context->buf_stat_bytes + context->buf_dyn_bytes;
 
+				if (ZBX_BUF_TYPE_DYN == s->buf_type)
+					tcp_recv_update_peak_memory(s, context->expected_len + 1);
+			}
+
 			s->buffer[s->read_bytes] = '\0';
 		}
 		else
@@ -2316,6 +2678,7 @@ out:
 #undef ZBX_TCP_EXPECT_HEADER
 #undef ZBX_TCP_EXPECT_LENGTH
 #undef ZBX_TCP_EXPECT_SIZE
+#undef ZBX_TCP_RECV_CHUNK_SIZE
 }
 
 /******************************************************************************
@@ -34,9 +34,6 @@ static ZBX_THREAD_LOCAL size_t		my_psk_len		= 0;
 /* but other components (e.g. agent) do not link dbconfig.o. */
 static zbx_find_psk_in_cache_f	find_psk_in_cache_cb = NULL;
 
-/* variable for passing information from callback functions if PSK was found among host PSKs or autoregistration PSK */
-static unsigned int	psk_usage;
-
 static zbx_tls_status_t	tls_status = ZBX_TLS_INIT_NONE;
 
 static ZBX_THREAD_LOCAL gnutls_certificate_credentials_t	my_cert_creds		= NULL;
@@ -137,7 +134,8 @@ static int	tls_is_nonblocking_error(ssize_t err)
  *     find and set the requested pre-shared key upon GnuTLS request          *
  *                                                                            *
  * Parameters:                                                                *
- *     session      - [IN] not used                                           *
+ *     session      - [IN] session, its pointer holds the TLS context of      *
+ *                         accepted connection                                *
  *     psk_identity - [IN] PSK identity for which the PSK should be searched  *
  *                         and set                                            *
  *     key          - [OUT pre-shared key allocated and set                   *
@@ -153,21 +151,21 @@ static int	tls_is_nonblocking_error(ssize_t err)
  ******************************************************************************/
 static int	zbx_psk_cb(gnutls_session_t session, const char *psk_identity, gnutls_datum_t *key)
 {
-	char		*psk;
-	size_t		psk_len = 0;
-	int		psk_bin_len;
-	unsigned char	tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
-
-	ZBX_UNUSED(session);
+	char			*psk;
+	size_t			psk_len = 0;
+	int			psk_bin_len;
+	unsigned char		tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
+	zbx_tls_context_t	*tls_ctx = (zbx_tls_context_t *)gnutls_session_get_ptr(session);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "%s() requested PSK identity \"%s\"", __func__, psk_identity);
 
-	psk_usage = 0;
+	tls_ctx->psk_usage = 0;
 
 	if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
 	{
 		/* call the function zbx_dc_get_psk_by_identity() by pointer */
-		if (0 < find_psk_in_cache_cb((const unsigned char *)psk_identity, tls_psk_hex, &psk_usage))
+		if (0 < find_psk_in_cache_cb((const unsigned char *)psk_identity, tls_psk_hex,
+				&tls_ctx->psk_usage))
 		{
 			/* The PSK is in configuration cache. Convert PSK to binary form. */
 			if (0 >= (psk_bin_len = zbx_hex2bin(tls_psk_hex, psk_buf, sizeof(psk_buf))))
@@ -186,13 +184,13 @@ static int	zbx_psk_cb(gnutls_session_t session, const char *psk_identity, gnutls
 				strcmp(my_psk_identity, psk_identity))
 		{
 			/* the PSK is in proxy configuration file */
-			psk_usage |= ZBX_PSK_FOR_PROXY;
+			tls_ctx->psk_usage |= ZBX_PSK_FOR_PROXY;
 
 			if (0 < psk_len && (psk_len != my_psk_len || 0 != memcmp(psk, my_psk, psk_len)))
 			{
 				/* PSK was also found in configuration cache but with different value */
 				zbx_psk_warn_misconfig(psk_identity);
-				psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
+				tls_ctx->psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
 			}
 
 			psk = my_psk;	/* prefer PSK from proxy configuration file */
@@ -1501,26 +1499,21 @@ out1:
 
 /******************************************************************************
  *                                                                            *
- * Purpose: establish a TLS connection over an accepted TCP connection        *
+ * Purpose: create TLS session for accepted TCP connection                    *
  *                                                                            *
  * Parameters:                                                                *
  *     s          - [IN] socket with opened connection                        *
+ *     tls_accept - [IN] type of connection to accept                         *
  *     error      - [OUT] dynamically allocated memory with error message     *
- *     tls_accept - [IN] type of connection to accept. Can be be either       *
- *                       ZBX_TCP_SEC_TLS_CERT or ZBX_TCP_SEC_TLS_PSK, or      *
- *                       a bitwise 'OR' of both.                              *
  *                                                                            *
  * Return value:                                                              *
- *     SUCCEED - successful TLS handshake with a valid certificate or PSK     *
+ *     SUCCEED - TLS session created and attached to the socket               *
  *     FAIL - an error occurred                                               *
  *                                                                            *
  ******************************************************************************/
-int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
+static int	tls_accept_init(zbx_socket_t *s, unsigned int tls_accept, char **error)
 {
-	int				ret = FAIL, res;
-	gnutls_credentials_type_t	creds;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	int	res;
 
 	/* set up TLS context */
 
@@ -1529,6 +1522,7 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 	s->tls_ctx->psk_client_creds = NULL;
 	s->tls_ctx->psk_server_creds = NULL;
 	s->tls_ctx->close_notify_received = 0;
+	s->tls_ctx->psk_usage = 0;
 
 	if (GNUTLS_E_SUCCESS != (res = gnutls_init(&s->tls_ctx->ctx, GNUTLS_SERVER)))
 	{
@@ -1652,12 +1646,69 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 
 	gnutls_transport_set_int(s->tls_ctx->ctx, ZBX_SOCKET_TO_INT(s->socket));
 
+	/* PSK callback function stores its findings in TLS context of the connection */
+	gnutls_session_set_ptr(s->tls_ctx->ctx, s->tls_ctx);
+
+	return SUCCEED;
+out:
+	if (NULL != s->tls_ctx->ctx)
+	{
+		gnutls_credentials_clear(s->tls_ctx->ctx);
+		gnutls_deinit(s->tls_ctx->ctx);
+	}
+
+	if (NULL != s->tls_ctx->psk_server_creds)
+		gnutls_psk_free_server_credentials(s->tls_ctx->psk_server_creds);
+
+	zbx_free(s->tls_ctx);
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: establish a TLS connection over an accepted TCP connection        *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     s          - [IN] socket with opened connection                        *
+ *     tls_accept - [IN] type of connection to accept. Can be be either       *
+ *                       ZBX_TCP_SEC_TLS_CERT or ZBX_TCP_SEC_TLS_PSK, or      *
+ *                       a bitwise 'OR' of both.                              *
+ *     event      - [OUT] optional, socket event the handshake is waiting for *
+ *     error      - [OUT] dynamically allocated memory with error message     *
+ *                                                                            *
+ * Return value:                                                              *
+ *     SUCCEED - successful TLS handshake with a valid certificate or PSK     *
+ *     FAIL - an error occurred or, if event is set, handshake must be        *
+ *            resumed with another call when the socket is ready              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, short *event, char **error)
+{
+	int				ret = FAIL, res;
+	gnutls_credentials_type_t	creds;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (NULL != event)
+		*event = 0;
+
+	if (NULL == s->tls_ctx && SUCCEED != tls_accept_init(s, tls_accept, error))
+		goto out1;
+
 	/* TLS handshake */
 
 	while (GNUTLS_E_SUCCESS != (res = gnutls_handshake(s->tls_ctx->ctx)))
 	{
 		if (GNUTLS_E_INTERRUPTED == res || GNUTLS_E_AGAIN == res)
 		{
+			if (NULL != event)
+			{
+				tls_socket_event(s->tls_ctx->ctx, 0, event);
+				zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, tls_error_string(res));
+				return FAIL;
+			}
+
 			if (FAIL == tls_socket_wait(s->socket, s->tls_ctx->ctx, 0))
 			{
 				*error = zbx_dsprintf(*error, "cannot wait for TLS handshake: %s",
@@ -2151,9 +2202,9 @@ void	zbx_tls_take_vars(ZBX_THREAD_SENDVAL_TLS_ARGS *args)
 }
 #endif
 
-unsigned int	zbx_tls_get_psk_usage(void)
+unsigned int	zbx_tls_get_psk_usage(const zbx_socket_t *s)
 {
-	return	psk_usage;
+	return	s->tls_ctx->psk_usage;
 }
 
 /******************************************************************************
@@ -189,9 +189,6 @@ static ZBX_THREAD_LOCAL size_t		my_psk_len		= 0;
 /* but other components (e.g. agent) do not link dbconfig.o. */
 static zbx_find_psk_in_cache_f	find_psk_in_cache_cb = NULL;
 
-/* variable for passing information from callback functions if PSK was found among host PSKs or autoregistration PSK */
-static unsigned int	psk_usage;
-
 static zbx_tls_status_t	tls_status = ZBX_TLS_INIT_NONE;
 
 static ZBX_THREAD_LOCAL const SSL_METHOD	*method			= NULL;
@@ -205,14 +202,33 @@ static ZBX_THREAD_LOCAL size_t			psk_identity_len_for_cb	= 0;
 static ZBX_THREAD_LOCAL char			*psk_for_cb		= NULL;
 static ZBX_THREAD_LOCAL size_t			psk_len_for_cb		= 0;
 #endif
-#ifdef HAVE_OPENSSL_WITH_PSK
-/* variables for capturing PSK identity from server callback function */
-static ZBX_THREAD_LOCAL int			incoming_connection_has_psk = 0;
-static ZBX_THREAD_LOCAL char			incoming_connection_psk_id[PSK_MAX_IDENTITY_LEN + 1];
-#endif
 /* buffer for messages produced by zbx_openssl_info_cb() */
 ZBX_THREAD_LOCAL char				info_buf[256];
 
+#if OPENSSL_VERSION_NUMBER >= 0x1010100fL && !defined(LIBRESSL_VERSION_NUMBER)	/* only OpenSSL 1.1.1 or newer */
+#define ZBX_TLS_SESSION_RESUMPTION
+
+/* session ticket keys generated before forking, so tickets issued by one process are accepted by others */
+static unsigned char	ticket_keys[80];
+static int		ticket_keys_set = 0;
+
+/* application data of tickets issued for certificate-based sessions */
+#define ZBX_TLS_TICKET_CERT	"cert"
+
+/* certificate-based sessions of client connections to resume on reconnect */
+#define ZBX_TLS_CLIENT_SESSIONS_MAX	16
+
+typedef struct
+{
+	zbx_hash_t	hash;
+	SSL_SESSION	*session;
+}
+zbx_tls_client_session_t;
+
+static ZBX_THREAD_LOCAL zbx_tls_client_session_t	client_sessions[ZBX_TLS_CLIENT_SESSIONS_MAX];
+static ZBX_THREAD_LOCAL int				client_sessions_next = 0;
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get state, alert, error information on TLS connection             *
@@ -416,7 +432,8 @@ static unsigned int	zbx_psk_client_cb(SSL *ssl, const char *hint, char *identity
  *     set pre-shared key for incoming TLS connection upon OpenSSL request    *
  *                                                                            *
  * Parameters:                                                                *
- *     ssl              - [IN] not used                                       *
+ *     ssl              - [IN] connection, its application data holds the     *
+ *                             TLS context of accepted connection             *
  *     identity         - [IN] PSK identity sent by client                    *
  *     psk              - [OUT] buffer to write PSK into                      *
  *     max_psk_len      - [IN] size of the 'psk' buffer                       *
@@ -433,22 +450,22 @@ static unsigned int	zbx_psk_client_cb(SSL *ssl, const char *hint, char *identity
 static unsigned int	zbx_psk_server_cb(SSL *ssl, const char *identity, unsigned char *psk,
 		unsigned int max_psk_len)
 {
-	const char	*psk_loc;
-	size_t		psk_len = 0;
-	int		psk_bin_len;
-	unsigned char	tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
-
-	ZBX_UNUSED(ssl);
+	const char		*psk_loc;
+	size_t			psk_len = 0;
+	int			psk_bin_len;
+	unsigned char		tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
+	zbx_tls_context_t	*tls_ctx = (zbx_tls_context_t *)SSL_get_app_data(ssl);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "%s() requested PSK identity \"%s\"", __func__, identity);
 
-	incoming_connection_has_psk = 1;
-	psk_usage = 0;
+	tls_ctx->incoming_has_psk = 1;
+	tls_ctx->psk_usage = 0;
 
 	if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
 	{
 		/* call the function zbx_dc_get_psk_by_identity() by pointer */
-		if (0 < find_psk_in_cache_cb((const unsigned char *)identity, tls_psk_hex, &psk_usage))
+		if (0 < find_psk_in_cache_cb((const unsigned char *)identity, tls_psk_hex,
+				&tls_ctx->psk_usage))
 		{
 			/* The PSK is in configuration cache. Convert PSK to binary form. */
 			if (0 >= (psk_bin_len = zbx_hex2bin(tls_psk_hex, psk_buf, sizeof(psk_buf))))
@@ -468,13 +485,13 @@ static unsigned int	zbx_psk_server_cb(SSL *ssl, const char *identity, unsigned c
 				0 == strcmp(my_psk_identity, identity))
 		{
 			/* the PSK is in proxy configuration file */
-			psk_usage |= ZBX_PSK_FOR_PROXY;
+			tls_ctx->psk_usage |= ZBX_PSK_FOR_PROXY;
 
 			if (0 < psk_len && (psk_len != my_psk_len || 0 != memcmp(psk_loc, my_psk, psk_len)))
 			{
 				/* PSK was also found in configuration cache but with different value */
 				zbx_psk_warn_misconfig(identity);
-				psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
+				tls_ctx->psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
 			}
 
 			psk_loc = my_psk;	/* prefer PSK from proxy configuration file */
@@ -515,12 +532,12 @@ static unsigned int	zbx_psk_server_cb(SSL *ssl, const char *identity, unsigned c
 		}
 
 		memcpy(psk, psk_loc, psk_len);
-		zbx_strlcpy(incoming_connection_psk_id, identity, sizeof(incoming_connection_psk_id));
+		zbx_strlcpy(tls_ctx->incoming_psk_id, identity, sizeof(tls_ctx->incoming_psk_id));
 
 		return (unsigned int)psk_len;	/* success */
 	}
 fail:
-	incoming_connection_psk_id[0] = '\0';
+	tls_ctx->incoming_psk_id[0] = '\0';
 	return 0;	/* PSK not found */
 }
 #endif
@@ -808,6 +825,7 @@ void	zbx_tls_init_parent(zbx_get_program_type_f zbx_get_program_type_cb_arg)
 	zbx_get_program_type_cb = zbx_get_program_type_cb_arg;
 
 	zbx_tls_library_init(ZBX_TLS_INIT_THREADS);
+	zbx_tls_generate_ticket_keys();
 }
 
 static const char	*zbx_ctx_name(SSL_CTX *param)
@@ -826,6 +844,210 @@ static const char	*zbx_ctx_name(SSL_CTX *param)
 	return ZBX_NULL2STR(NULL);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: generates session ticket keys to be shared by child processes     *
+ *                                                                            *
+ * Comments: Must be called before forking. Without shared keys each process  *
+ *           uses own random keys and resumes only sessions it issued.        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_tls_generate_ticket_keys(void)
+{
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+	if (1 == RAND_bytes(ticket_keys, sizeof(ticket_keys)))
+		ticket_keys_set = 1;
+#endif
+}
+
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: marks tickets of certificate-based sessions                       *
+ *                                                                            *
+ * Comments:                                                                  *
+ *     This is a callback function, its arguments are defined in OpenSSL.     *
+ *                                                                            *
+ ******************************************************************************/
+static int	zbx_ticket_gen_cb(SSL *ssl, void *arg)
+{
+	SSL_SESSION	*session = SSL_get_session(ssl);
+
+	ZBX_UNUSED(arg);
+
+	if (NULL == session || NULL == SSL_SESSION_get0_peer(session))
+		return 1;
+
+	return SSL_SESSION_set1_ticket_appdata(session, ZBX_TLS_TICKET_CERT, ZBX_CONST_STRLEN(ZBX_TLS_TICKET_CERT));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allows resuming only certificate-based sessions                   *
+ *                                                                            *
+ * Comments:                                                                  *
+ *     This is a callback function, its arguments are defined in OpenSSL.     *
+ *     PSK-based sessions are not resumed because PSK identity is checked by  *
+ *     server callback function during full handshake only.                   *
+ *                                                                            *
+ ******************************************************************************/
+static SSL_TICKET_RETURN	zbx_ticket_dec_cb(SSL *ssl, SSL_SESSION *session, const unsigned char *keyname,
+		size_t keyname_len, SSL_TICKET_STATUS status, void *arg)
+{
+	void	*data;
+	size_t	len;
+
+	ZBX_UNUSED(ssl);
+	ZBX_UNUSED(keyname);
+	ZBX_UNUSED(keyname_len);
+	ZBX_UNUSED(arg);
+
+	switch (status)
+	{
+		case SSL_TICKET_SUCCESS:
+		case SSL_TICKET_SUCCESS_RENEW:
+			if (1 != SSL_SESSION_get0_ticket_appdata(session, &data, &len) ||
+					ZBX_CONST_STRLEN(ZBX_TLS_TICKET_CERT) != len ||
+					0 != memcmp(data, ZBX_TLS_TICKET_CERT, len))
+			{
+				return SSL_TICKET_RETURN_IGNORE;
+			}
+
+			return SSL_TICKET_SUCCESS == status ? SSL_TICKET_RETURN_USE : SSL_TICKET_RETURN_USE_RENEW;
+		case SSL_TICKET_NONE:
+		case SSL_TICKET_EMPTY:
+		case SSL_TICKET_NO_DECRYPT:
+			return SSL_TICKET_RETURN_IGNORE_RENEW;
+		default:
+			return SSL_TICKET_RETURN_ABORT;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enables stateless session tickets for certificate-based sessions  *
+ *                                                                            *
+ ******************************************************************************/
+static void	zbx_ctx_enable_tickets(SSL_CTX *ctx)
+{
+	SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+	SSL_CTX_set_num_tickets(ctx, 1);
+
+	if (1 != SSL_CTX_set_session_ticket_cb(ctx, zbx_ticket_gen_cb, zbx_ticket_dec_cb, NULL))
+	{
+		SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+		return;
+	}
+
+	if (0 != ticket_keys_set && 1 != SSL_CTX_set_tlsext_ticket_keys(ctx, ticket_keys, sizeof(ticket_keys)))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() cannot set shared session ticket keys for %s", __func__,
+				zbx_ctx_name(ctx));
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates identity of peer expected by client connection         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_hash_t	tls_session_hash(const zbx_socket_t *s, const char *server_name, const char *tls_arg1,
+		const char *tls_arg2)
+{
+	zbx_hash_t	hash;
+
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(s->peer, strlen(s->peer), ZBX_DEFAULT_HASH_SEED);
+
+	if (NULL != server_name)
+		hash = ZBX_DEFAULT_STRING_HASH_ALGO(server_name, strlen(server_name), hash);
+
+	if (NULL != tls_arg1)
+		hash = ZBX_DEFAULT_STRING_HASH_ALGO(tls_arg1, strlen(tls_arg1), hash);
+
+	if (NULL != tls_arg2)
+		hash = ZBX_DEFAULT_STRING_HASH_ALGO(tls_arg2, strlen(tls_arg2), hash);
+
+	return hash;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds session cached for the peer                                 *
+ *                                                                            *
+ ******************************************************************************/
+static SSL_SESSION	*tls_session_find(zbx_hash_t hash)
+{
+	int	i;
+
+	for (i = 0; i < ZBX_TLS_CLIENT_SESSIONS_MAX; i++)
+	{
+		if (NULL != client_sessions[i].session && hash == client_sessions[i].hash)
+			return client_sessions[i].session;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: caches session of closing client connection to resume it later    *
+ *                                                                            *
+ * Comments: Sessions are cached when connection is closed because TLS 1.3    *
+ *           tickets arrive after the handshake.                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	tls_session_save(zbx_hash_t hash, SSL *ssl)
+{
+	SSL_SESSION			*session;
+	zbx_tls_client_session_t	*cached = NULL;
+	int				i;
+
+	if (NULL == (session = SSL_get1_session(ssl)))
+		return;
+
+	if (1 != SSL_SESSION_is_resumable(session))
+	{
+		SSL_SESSION_free(session);
+		return;
+	}
+
+	for (i = 0; i < ZBX_TLS_CLIENT_SESSIONS_MAX; i++)
+	{
+		if (NULL != client_sessions[i].session && hash == client_sessions[i].hash)
+		{
+			cached = &client_sessions[i];
+			break;
+		}
+	}
+
+	if (NULL == cached)
+	{
+		cached = &client_sessions[client_sessions_next];
+		client_sessions_next = (client_sessions_next + 1) % ZBX_TLS_CLIENT_SESSIONS_MAX;
+	}
+
+	if (NULL != cached->session)
+		SSL_SESSION_free(cached->session);
+
+	cached->hash = hash;
+	cached->session = session;
+}
+
+static void	tls_sessions_free(void)
+{
+	int	i;
+
+	for (i = 0; i < ZBX_TLS_CLIENT_SESSIONS_MAX; i++)
+	{
+		if (NULL != client_sessions[i].session)
+		{
+			SSL_SESSION_free(client_sessions[i].session);
+			client_sessions[i].session = NULL;
+		}
+	}
+}
+#endif
+
 static int	zbx_set_ecdhe_parameters(SSL_CTX *ctx)
 {
 	const char	*msg = "Perfect Forward Secrecy ECDHE ciphersuites will not be available for";
@@ -1152,6 +1374,10 @@ void	zbx_tls_init_child(const zbx_config_tls_t *config_tls, zbx_get_program_type
 
 		/* use server ciphersuite preference, do not use RFC 4507 ticket extension */
 		SSL_CTX_set_options(ctx_cert, SSL_OP_CIPHER_SERVER_PREFERENCE | SSL_OP_NO_TICKET);
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+		/* except for resuming certificate-based sessions */
+		zbx_ctx_enable_tickets(ctx_cert);
+#endif
 
 		/* do not connect to unpatched servers */
 		SSL_CTX_clear_options(ctx_cert, SSL_OP_LEGACY_SERVER_CONNECT);
@@ -1324,6 +1550,9 @@ void	zbx_tls_init_child(const zbx_config_tls_t *config_tls, zbx_get_program_type
 		}
 
 		SSL_CTX_set_options(ctx_all, SSL_OP_CIPHER_SERVER_PREFERENCE | SSL_OP_NO_TICKET);
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+		zbx_ctx_enable_tickets(ctx_all);
+#endif
 		SSL_CTX_clear_options(ctx_all, SSL_OP_LEGACY_SERVER_CONNECT);
 		SSL_CTX_set_session_cache_mode(ctx_all, SSL_SESS_CACHE_OFF);
 
@@ -1482,6 +1711,9 @@ void	zbx_tls_free(void)
 		zbx_free(my_psk);
 	}
 
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+	tls_sessions_free();
+#endif
 	zbx_tls_library_deinit(ZBX_TLS_INIT_PROCESS);
 }
 
@@ -1599,6 +1831,7 @@ int	zbx_tls_connect(zbx_socket_t *s, unsigned int tls_connect, const char *tls_a
 	{
 		s->tls_ctx = zbx_malloc(s->tls_ctx, sizeof(zbx_tls_context_t));
 		s->tls_ctx->ctx = NULL;
+		s->tls_ctx->session_hash = 0;
 		initialized = 0;
 	}
 	else
@@ -1625,6 +1858,17 @@ int	zbx_tls_connect(zbx_socket_t *s, unsigned int tls_connect, const char *tls_a
 				zbx_tls_error_msg(error, &error_alloc, &error_offset);
 				goto out;
 			}
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+			{
+				SSL_SESSION	*session;
+
+				if (NULL != (session = tls_session_find(tls_session_hash(s, server_name, tls_arg1,
+						tls_arg2))))
+				{
+					SSL_set_session(s->tls_ctx->ctx, session);
+				}
+			}
+#endif
 		}
 	}
 	else if (ZBX_TCP_SEC_TLS_PSK == tls_connect)
@@ -1793,6 +2037,10 @@ int	zbx_tls_connect(zbx_socket_t *s, unsigned int tls_connect, const char *tls_a
 			zbx_tls_close(s);
 			goto out1;
 		}
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+		/* verified session can be cached on close */
+		s->tls_ctx->session_hash = tls_session_hash(s, server_name, tls_arg1, tls_arg2);
+#endif
 	}
 
 	s->connection_type = tls_connect;
@@ -1815,37 +2063,33 @@ out1:
 
 /******************************************************************************
  *                                                                            *
- * Purpose: establish a TLS connection over an accepted TCP connection        *
+ * Purpose: create TLS context for accepted TCP connection                    *
  *                                                                            *
  * Parameters:                                                                *
  *     s          - [IN] socket with opened connection                        *
+ *     tls_accept - [IN] type of connection to accept                         *
  *     error      - [OUT] dynamically allocated memory with error message     *
- *     tls_accept - [IN] type of connection to accept. Can be be either       *
- *                       ZBX_TCP_SEC_TLS_CERT or ZBX_TCP_SEC_TLS_PSK, or      *
- *                       a bitwise 'OR' of both.                              *
  *                                                                            *
  * Return value:                                                              *
- *     SUCCEED - successful TLS handshake with a valid certificate or PSK     *
+ *     SUCCEED - TLS context created and attached to the socket               *
  *     FAIL - an error occurred                                               *
  *                                                                            *
  ******************************************************************************/
-int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
+static int	tls_accept_init(zbx_socket_t *s, unsigned int tls_accept, char **error)
 {
-	const char	*cipher_name;
-	int		ret = FAIL, res;
-	size_t		error_alloc = 0, error_offset = 0;
-	long		verify_result;
+	size_t	error_alloc = 0, error_offset = 0;
 
 #if OPENSSL_VERSION_NUMBER >= 0x1010100fL	/* OpenSSL 1.1.1 or newer, or LibreSSL */
 	const unsigned char	session_id_context[] = {'Z', 'b', 'x'};
 #endif
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
-
 	s->tls_ctx = zbx_malloc(s->tls_ctx, sizeof(zbx_tls_context_t));
 	s->tls_ctx->ctx = NULL;
+	s->tls_ctx->session_hash = 0;
 
+	s->tls_ctx->psk_usage = 0;
 #if defined(HAVE_OPENSSL_WITH_PSK)
-	incoming_connection_has_psk = 0;	/* assume certificate-based connection by default */
+	s->tls_ctx->incoming_has_psk = 0;	/* assume certificate-based connection by default */
+	s->tls_ctx->incoming_psk_id[0] = '\0';
 #endif
 	if ((ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK) == (tls_accept & (ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK)))
 	{
@@ -1967,6 +2211,52 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 		goto out;
 	}
 
+	/* PSK server callback stores its findings in TLS context of the connection */
+	SSL_set_app_data(s->tls_ctx->ctx, s->tls_ctx);
+
+	return SUCCEED;
+out:
+	if (NULL != s->tls_ctx->ctx)
+		SSL_free(s->tls_ctx->ctx);
+
+	zbx_free(s->tls_ctx);
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: establish a TLS connection over an accepted TCP connection        *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     s          - [IN] socket with opened connection                        *
+ *     tls_accept - [IN] type of connection to accept. Can be be either       *
+ *                       ZBX_TCP_SEC_TLS_CERT or ZBX_TCP_SEC_TLS_PSK, or      *
+ *                       a bitwise 'OR' of both.                              *
+ *     event      - [OUT] optional, socket event the handshake is waiting for *
+ *     error      - [OUT] dynamically allocated memory with error message     *
+ *                                                                            *
+ * Return value:                                                              *
+ *     SUCCEED - successful TLS handshake with a valid certificate or PSK     *
+ *     FAIL - an error occurred or, if event is set, handshake must be        *
+ *            resumed with another call when the socket is ready              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, short *event, char **error)
+{
+	const char	*cipher_name;
+	int		ret = FAIL, res;
+	size_t		error_alloc = 0, error_offset = 0;
+	long		verify_result;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (NULL != event)
+		*event = 0;
+
+	if (NULL == s->tls_ctx && SUCCEED != tls_accept_init(s, tls_accept, error))
+		goto out1;
+
 	/* TLS handshake */
 
 	info_buf[0] = '\0';	/* empty buffer for zbx_openssl_info_cb() messages */
@@ -1980,6 +2270,15 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 		if (SSL_ERROR_WANT_READ != ssl_err && SSL_ERROR_WANT_WRITE != ssl_err)
 			break;
 
+		if (NULL != event)
+		{
+			tls_socket_event(s->tls_ctx->ctx, ssl_err, event);
+
+			zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s %s", __func__, tls_error_string(ssl_err),
+					zbx_result_string(ret));
+			return FAIL;
+		}
+
 		if (FAIL == tls_socket_wait(s->socket, s->tls_ctx->ctx, ssl_err))
 		{
 			*error = zbx_dsprintf(*error, "cannot wait for TLS handshake: %s",
@@ -2039,7 +2338,7 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 	cipher_name = SSL_get_cipher(s->tls_ctx->ctx);
 
 #if defined(HAVE_OPENSSL_WITH_PSK)
-	if (1 == incoming_connection_has_psk)
+	if (1 == s->tls_ctx->incoming_has_psk)
 	{
 		s->connection_type = ZBX_TCP_SEC_TLS_PSK;
 	}
@@ -2290,7 +2589,10 @@ void	zbx_tls_close(zbx_socket_t *s)
 				}
 			}
 		}
-
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+		if (0 != s->tls_ctx->session_hash)
+			tls_session_save(s->tls_ctx->session_hash, s->tls_ctx->ctx);
+#endif
 		SSL_free(s->tls_ctx->ctx);
 	}
 
@@ -2350,14 +2652,12 @@ int	zbx_tls_get_attr_cert(const zbx_socket_t *s, zbx_tls_conn_attr_t *attr)
 #if defined(HAVE_OPENSSL_WITH_PSK)
 int	zbx_tls_get_attr_psk(const zbx_socket_t *s, zbx_tls_conn_attr_t *attr)
 {
-	ZBX_UNUSED(s);
-
 	/* SSL_get_psk_identity() is not used here. It works with TLS 1.2, */
 	/* but returns NULL with TLS 1.3 in OpenSSL 1.1.1 */
-	if ('\0' == incoming_connection_psk_id[0])
+	if ('\0' == s->tls_ctx->incoming_psk_id[0])
 		return FAIL;
 
-	attr->psk_identity = incoming_connection_psk_id;
+	attr->psk_identity = s->tls_ctx->incoming_psk_id;
 	attr->psk_identity_len = strlen(attr->psk_identity);
 	return SUCCEED;
 }
@@ -2498,9 +2798,9 @@ void	zbx_tls_take_vars(ZBX_THREAD_SENDVAL_TLS_ARGS *args)
 }
 #endif
 
-unsigned int	zbx_tls_get_psk_usage(void)
+unsigned int	zbx_tls_get_psk_usage(const zbx_socket_t *s)
 {
-	return	psk_usage;
+	return	s->tls_ctx->psk_usage;
 }
 
 /******************************************************************************
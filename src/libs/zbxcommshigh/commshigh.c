@@ -25,6 +25,7 @@
 #endif
 
 #include "zbxcfg.h"
+#include "zbxcompress.h"
 
 void	zbx_addrs_failover(zbx_vector_addr_ptr_t *addrs)
 {
@@ -144,17 +145,26 @@ void	zbx_disconnect_from_server(zbx_socket_t *sock)
  *                                                                            *
  * Purpose: get configuration and other data from server                      *
  *                                                                            *
+ * Parameters: sock        - [IN] connection socket                           *
+ *             buffer      - [IN/OUT] the compressed request                  *
+ *             buffer_size - [IN] the compressed request size                 *
+ *             reserved    - [IN] the uncompressed request size               *
+ *             codec       - [IN] ZBX_COMPRESS_* codec used for buffer        *
+ *             error       - [OUT] the error message                          *
+ *                                                                            *
  * Return value: SUCCEED - processed successfully                             *
  *               FAIL - an error occurred                                     *
  *                                                                            *
  ******************************************************************************/
-int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error)
+int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char codec, char **error)
 {
 	int		ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, 0))
+	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved,
+			ZBX_TCP_PROTOCOL | zbx_tcp_compress_flags(codec), 0))
 	{
 		*error = zbx_strdup(*error, zbx_socket_strerror());
 		goto exit;
@@ -187,17 +197,26 @@ exit:
  *                                                                            *
  * Purpose: send data to server                                               *
  *                                                                            *
+ * Parameters: sock        - [IN] connection socket                           *
+ *             buffer      - [IN/OUT] the compressed data                     *
+ *             buffer_size - [IN] the compressed data size                    *
+ *             reserved    - [IN] the uncompressed data size                  *
+ *             codec       - [IN] ZBX_COMPRESS_* codec used for buffer        *
+ *             error       - [OUT] the error message                          *
+ *                                                                            *
  * Return value: SUCCEED - processed successfully                             *
  *               FAIL - an error occurred                                     *
  *                                                                            *
  ******************************************************************************/
-int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error)
+int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char codec, char **error)
 {
 	int	ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() datalen:" ZBX_FS_SIZE_T, __func__, (zbx_fs_size_t)buffer_size);
 
-	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, 0))
+	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved,
+			ZBX_TCP_PROTOCOL | zbx_tcp_compress_flags(codec), 0))
 	{
 		*error = zbx_strdup(*error, zbx_socket_strerror());
 		goto out;
@@ -378,6 +397,37 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: advertise compression codecs supported by this side               *
+ *                                                                            *
+ * Parameters: json - [IN/OUT] json request or response                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_add_compress_codecs(struct zbx_json *json)
+{
+	zbx_json_addstring(json, ZBX_PROTO_TAG_COMPRESSION, zbx_compress_codecs(), ZBX_JSON_TYPE_STRING);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: choose codec for data sent to peer from the codecs it advertised  *
+ *                                                                            *
+ * Parameters: jp - [IN] json request or response received from peer          *
+ *                                                                            *
+ * Return value: ZBX_COMPRESS_* codec                                         *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_parse_compress_codecs(const struct zbx_json_parse *jp)
+{
+	char	codecs[MAX_STRING_LEN];
+
+	if (SUCCEED != zbx_json_value_by_name(jp, ZBX_PROTO_TAG_COMPRESSION, codecs, sizeof(codecs), NULL))
+		return zbx_compress_negotiate(NULL);
+
+	return zbx_compress_negotiate(codecs);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add redirection information to json response                      *
@@ -523,15 +573,64 @@ static int	comms_check_redirect(const char *data, zbx_vector_addr_ptr_t *addrs)
 	return ZBX_REDIRECT_RETRY;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if response confirms that connection is kept open          *
+ *                                                                            *
+ ******************************************************************************/
+static int	comms_check_keepalive(const char *data)
+{
+	zbx_json_parse_t	jp;
+	char			value[MAX_ID_LEN + 1];
+
+	if (FAIL == zbx_json_open(data, &jp))
+		return FAIL;
+
+	if (FAIL == zbx_json_value_by_name(&jp, ZBX_PROTO_TAG_KEEPALIVE, value, sizeof(value), NULL))
+		return FAIL;
+
+	return 0 == strcmp(value, ZBX_PROTO_VALUE_TRUE) ? SUCCEED : FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: closes connection and forgets it as kept open                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	comms_close(zbx_socket_t *sock, zbx_comms_keepalive_t *keepalive)
+{
+	zbx_tcp_close(sock);
+
+	if (NULL != keepalive)
+		zbx_free(keepalive->ip);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: closes connection kept open for next requests                     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_comms_keepalive_close(zbx_comms_keepalive_t *keepalive)
+{
+	if (NULL == keepalive->ip)
+		return;
+
+	zbx_tcp_close(&keepalive->sock);
+	zbx_free(keepalive->ip);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sends data to socket and receives response                        *
  *                                                                            *
- * Parameters: sock  - [IN] socket descriptor                                 *
- *             data  - [IN] data to send                                      *
- *             addr  - [IN] address information for logging                   *
- *             out   - [IN] wait for response if not NULL                     *
- *             error - [OUT] error message in case of failure                 *
+ * Parameters: sock      - [IN] socket descriptor                             *
+ *             data      - [IN] data to send                                  *
+ *             addr      - [IN] address information for logging               *
+ *             out       - [IN] wait for response if not NULL                 *
+ *             keepalive - [OUT] set to 1 if the other side keeps connection  *
+ *                               open for next request, NULL if keepalive was *
+ *                               not requested                                *
+ *             error     - [OUT] error message in case of failure             *
  *                                                                            *
  * Return value: SUCCEED - data successfully exchanged                        *
  *               SEND_ERROR - failed to send data                             *
@@ -539,7 +638,7 @@ static int	comms_check_redirect(const char *data, zbx_vector_addr_ptr_t *addrs)
  *                                                                            *
  ******************************************************************************/
 static int	zbx_comms_exchange_data(zbx_socket_t *sock, const char *data, zbx_addr_t *addr,
-		char **out, char **error)
+		char **out, int *keepalive, char **error)
 {
 	zabbix_log(LOG_LEVEL_DEBUG, "sending to [%s]:%d: %s", addr->ip, addr->port, data);
 
@@ -569,6 +668,10 @@ static int	zbx_comms_exchange_data(zbx_socket_t *sock, const char *data, zbx_add
 
 		return RECV_ERROR;
 	}
+	else if (NULL != keepalive && SUCCEED == comms_check_keepalive(sock->buffer))
+	{
+		*keepalive = 1;
+	}
 	else
 	{
 		if (ZBX_PROTO_ERROR == zbx_tcp_read_close_notify(sock, 0, NULL))
@@ -587,6 +690,10 @@ static int	zbx_comms_exchange_data(zbx_socket_t *sock, const char *data, zbx_add
  *                                                                            *
  * Purpose: connect to a host and exchange data                               *
  *                                                                            *
+ * Parameters: keepalive - [IN/OUT] connection to reuse and keep open after   *
+ *                                  the exchange if the other side agrees,    *
+ *                                  NULL to close connection after exchange   *
+ *                                                                            *
  * Return value: SUCCEED - data was exchanged successfully                    *
  *               CONNECT_ERROR - connection error                             *
  *               SEND_ERROR - request sending error                           *
@@ -596,17 +703,41 @@ static int	zbx_comms_exchange_data(zbx_socket_t *sock, const char *data, zbx_add
  *           be updated accordingly and connection will be retried with the   *
  *           new address.                                                     *
  *                                                                            *
+ *           Data must contain keepalive tag to request keeping connection    *
+ *           open. Reused connection which was closed by the other side while *
+ *           idle is reestablished before sending. Data is sent again over a  *
+ *           new connection only if sending over the reused one failed - once *
+ *           the request was written the other side might have processed it.  *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_t *addrs, int timeout,
-		int connect_timeout, int retry_interval, int loglevel, const zbx_config_tls_t *config_tls,
-		const char *data, char *(*connect_callback)(void *), void *cb_data, char **out, char **error)
+int	zbx_comms_exchange_keepalive(zbx_comms_keepalive_t *keepalive, const char *source_ip,
+		zbx_vector_addr_ptr_t *addrs, int timeout, int connect_timeout, int retry_interval, int loglevel,
+		const zbx_config_tls_t *config_tls, const char *data, char *(*connect_callback)(void *),
+		void *cb_data, char **out, char **error)
 {
-	zbx_socket_t		sock;
-	int			conn_ret, ret = FAIL, retries = 0;
+	zbx_socket_t	sock_local, *sock = &sock_local;
+	int		conn_ret = SUCCEED, ret = FAIL, retries = 0, kept = 0;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
-	conn_ret = zbx_connect_to_server(&sock, source_ip, addrs, timeout, connect_timeout, retry_interval,
-			loglevel, config_tls);
+
+	if (NULL != keepalive)
+	{
+		sock = &keepalive->sock;
+
+		if (NULL != keepalive->ip && (0 != strcmp(keepalive->ip, addrs->values[0]->ip) ||
+				keepalive->port != addrs->values[0]->port || SUCCEED == zbx_tcp_peer_closed(sock)))
+		{
+			zbx_comms_keepalive_close(keepalive);
+		}
+	}
+
+	if (NULL == keepalive || NULL == keepalive->ip)
+	{
+		conn_ret = zbx_connect_to_server(sock, source_ip, addrs, timeout, connect_timeout, retry_interval,
+				loglevel, config_tls);
+	}
+	else
+		zbx_socket_set_deadline(sock, timeout);
 
 	for (;;)
 	{
@@ -626,9 +757,12 @@ int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_
 		if (NULL != connect_callback)
 			data = connect_callback(cb_data);
 
-		if (SUCCEED == (ret = zbx_comms_exchange_data(&sock, data, addrs->values[0], out, error)))
+		kept = 0;
+
+		if (SUCCEED == (ret = zbx_comms_exchange_data(sock, data, addrs->values[0], out,
+				NULL != keepalive ? &kept : NULL, error)))
 		{
-			if (ZBX_REDIRECT_FAIL != (conn_ret = comms_check_redirect(sock.buffer, addrs)))
+			if (ZBX_REDIRECT_FAIL != (conn_ret = comms_check_redirect(sock->buffer, addrs)))
 			{
 				if (0 != retries)
 				{
@@ -636,7 +770,7 @@ int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_
 						*error = zbx_strdup(NULL, "sequential redirect responses detected");
 
 					ret = CONNECT_ERROR;
-					zbx_tcp_close(&sock);
+					comms_close(sock, keepalive);
 
 					goto out;
 				}
@@ -648,9 +782,9 @@ int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_
 				zabbix_log(LOG_LEVEL_DEBUG, "%s() redirect response found, retrying to: [%s]:%hu",
 						__func__, addrs->values[0]->ip, addrs->values[0]->port);
 
-				zbx_tcp_close(&sock);
+				comms_close(sock, keepalive);
 
-				conn_ret = zbx_connect_to_server(&sock, source_ip, addrs, timeout, connect_timeout,
+				conn_ret = zbx_connect_to_server(sock, source_ip, addrs, timeout, connect_timeout,
 						retry_interval, loglevel, config_tls);
 
 				continue;
@@ -659,7 +793,7 @@ int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_
 			{
 				zbx_vector_addr_ptr_t	addrs_tmp;
 
-				zbx_tcp_close(&sock);
+				comms_close(sock, keepalive);
 
 				zabbix_log(LOG_LEVEL_DEBUG, "%s() redirect connection without failover to: [%s]:%hu",
 						__func__, addrs->values[0]->ip, addrs->values[0]->port);
@@ -668,7 +802,7 @@ int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_
 				zbx_vector_addr_ptr_append(&addrs_tmp, addrs->values[0]);
 
 				/* one host in addrs list will try connection without failover logic */
-				conn_ret = zbx_connect_to_server(&sock, source_ip, &addrs_tmp, timeout, connect_timeout,
+				conn_ret = zbx_connect_to_server(sock, source_ip, &addrs_tmp, timeout, connect_timeout,
 						0, loglevel, config_tls);
 
 				zbx_vector_addr_ptr_destroy(&addrs_tmp);
@@ -683,6 +817,21 @@ int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_
 						"connection was reset because of service being offline");
 			}
 		}
+		else if (SEND_ERROR == ret && NULL != keepalive && NULL != keepalive->ip)
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() cannot send over kept connection to [%s]:%hu, reconnecting",
+					__func__, addrs->values[0]->ip, addrs->values[0]->port);
+
+			comms_close(sock, keepalive);
+
+			if (NULL != error)
+				zbx_free(*error);
+
+			conn_ret = zbx_connect_to_server(sock, source_ip, addrs, timeout, connect_timeout,
+					retry_interval, loglevel, config_tls);
+
+			continue;
+		}
 
 		break;
 	}
@@ -690,11 +839,34 @@ int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_
 	if (SUCCEED != ret)
 		zbx_addrs_failover(addrs);
 	else if (NULL != out)
-		*out = zbx_socket_detach_buffer(&sock);
+		*out = zbx_socket_detach_buffer(sock);
+
+	if (SUCCEED == ret && 0 != kept)
+	{
+		if (NULL == keepalive->ip)
+			keepalive->ip = zbx_strdup(NULL, addrs->values[0]->ip);
 
-	zbx_tcp_close(&sock);
+		keepalive->port = addrs->values[0]->port;
+	}
+	else
+		comms_close(sock, keepalive);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
 	return ret;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: connect to a host and exchange data, close connection afterwards  *
+ *                                                                            *
+ * Return value: see zbx_comms_exchange_keepalive()                           *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_comms_exchange_with_redirect(const char *source_ip, zbx_vector_addr_ptr_t *addrs, int timeout,
+		int connect_timeout, int retry_interval, int loglevel, const zbx_config_tls_t *config_tls,
+		const char *data, char *(*connect_callback)(void *), void *cb_data, char **out, char **error)
+{
+	return zbx_comms_exchange_keepalive(NULL, source_ip, addrs, timeout, connect_timeout, retry_interval,
+			loglevel, config_tls, data, connect_callback, cb_data, out, error);
+}
@@ -16,12 +16,133 @@
 
 #include "zbxcommon.h"
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets compression codec by name                                    *
+ *                                                                            *
+ * Parameters: name  - [IN] codec name - zlib, zstd or lz4                    *
+ *             codec - [OUT] ZBX_COMPRESS_* codec                             *
+ *                                                                            *
+ * Return value: SUCCEED - the codec name is valid                            *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: This function does not check if the codec is supported.          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_compress_codec_parse(const char *name, unsigned char *codec)
+{
+	if (0 == strcmp(name, "zlib"))
+		*codec = ZBX_COMPRESS_ZLIB;
+	else if (0 == strcmp(name, "zstd"))
+		*codec = ZBX_COMPRESS_ZSTD;
+	else if (0 == strcmp(name, "lz4"))
+		*codec = ZBX_COMPRESS_LZ4;
+	else
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns comma separated list of supported codecs to advertise     *
+ *          to peers                                                          *
+ *                                                                            *
+ ******************************************************************************/
+const char	*zbx_compress_codecs(void)
+{
+#ifdef HAVE_ZLIB
+	return "zlib"
+#ifdef HAVE_ZSTD
+			",zstd"
+#endif
+#ifdef HAVE_LZ4
+			",lz4"
+#endif
+			;
+#else
+	return "";
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: chooses codec for data sent to peer                               *
+ *                                                                            *
+ * Parameters: codecs - [IN] comma separated list of codecs supported by      *
+ *                           peer, can be NULL                                *
+ *                                                                            *
+ * Return value: the configured codec if it is supported by both sides,       *
+ *               ZBX_COMPRESS_ZLIB otherwise                                  *
+ *                                                                            *
+ * Comments: Peers that do not advertise codecs are older versions, which     *
+ *           understand only zlib.                                            *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_compress_negotiate(const char *codecs)
+{
+	unsigned char	codec_local, codec;
+	const char	*ptr, *next;
+	char		name[16];
+
+	if (NULL == codecs || ZBX_COMPRESS_ZLIB == (codec_local = zbx_compress_get_codec()))
+		return ZBX_COMPRESS_ZLIB;
+
+	for (ptr = codecs; '\0' != *ptr; ptr = next)
+	{
+		size_t	len;
+
+		if (NULL == (next = strchr(ptr, ',')))
+			next = ptr + strlen(ptr);
+
+		if (sizeof(name) > (len = (size_t)(next - ptr)))
+		{
+			memcpy(name, ptr, len);
+			name[len] = '\0';
+
+			if (SUCCEED == zbx_compress_codec_parse(name, &codec) && codec == codec_local)
+				return codec;
+		}
+
+		if (',' == *next)
+			next++;
+	}
+
+	return ZBX_COMPRESS_ZLIB;
+}
+
 #ifdef HAVE_ZLIB
 #include "zlib.h"
 
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#endif
+
+#ifdef HAVE_LZ4
+#include "lz4.h"
+#endif
+
 #define ZBX_COMPRESS_STRERROR_LEN	512
 
-static int	zbx_zlib_errno = 0;
+/* error state is per thread, the library is used by multithreaded processes */
+static ZBX_THREAD_LOCAL int		zbx_zlib_errno = 0;
+static ZBX_THREAD_LOCAL const char	*zbx_compress_errmsg = NULL;	/* error message of codecs other than zlib */
+
+/* compression codec preferred for data sent to peers supporting it */
+static unsigned char	zbx_compress_codec = ZBX_COMPRESS_ZLIB;
+
+/* compression contexts are kept between calls to avoid reinitializing codec state for every message */
+static ZBX_THREAD_LOCAL z_stream	*deflate_stream = NULL;
+static ZBX_THREAD_LOCAL z_stream	*inflate_stream = NULL;
+
+#ifdef HAVE_ZSTD
+static ZBX_THREAD_LOCAL ZSTD_CCtx	*zstd_cctx = NULL;
+static ZBX_THREAD_LOCAL ZSTD_DCtx	*zstd_dctx = NULL;
+#endif
+
+#ifdef HAVE_LZ4
+static ZBX_THREAD_LOCAL void		*lz4_state = NULL;
+#endif
 
 /******************************************************************************
  *                                                                            *
@@ -30,7 +151,13 @@ static int	zbx_zlib_errno = 0;
  ******************************************************************************/
 const char	*zbx_compress_strerror(void)
 {
-	static char	message[ZBX_COMPRESS_STRERROR_LEN];
+	static ZBX_THREAD_LOCAL char	message[ZBX_COMPRESS_STRERROR_LEN];
+
+	if (NULL != zbx_compress_errmsg)
+	{
+		zbx_strlcpy(message, zbx_compress_errmsg, sizeof(message));
+		return message;
+	}
 
 	switch (zbx_zlib_errno)
 	{
@@ -56,43 +183,390 @@ const char	*zbx_compress_strerror(void)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: compress data                                                     *
+ * Purpose: checks if compression codec is supported                          *
  *                                                                            *
- * Parameters: in       - [IN] the data to compress                           *
- *             size_in  - [IN] the input data size                            *
- *             out      - [OUT] the compressed data                           *
- *             size_out - [OUT] the compressed data size                      *
+ * Parameters: codec - [IN] ZBX_COMPRESS_* codec                              *
  *                                                                            *
- * Return value: SUCCEED - the data was compressed successfully               *
+ * Return value: SUCCEED - the codec is supported                             *
  *               FAIL    - otherwise                                          *
  *                                                                            *
- * Comments: In the case of success the output buffer must be freed by the    *
- *           caller.                                                          *
+ ******************************************************************************/
+int	zbx_compress_codec_supported(unsigned char codec)
+{
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			return SUCCEED;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			return SUCCEED;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			return SUCCEED;
+#endif
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets compression codec preferred for data sent to peers           *
+ *                                                                            *
+ * Parameters: codec - [IN] ZBX_COMPRESS_* codec                              *
+ *                                                                            *
+ * Return value: SUCCEED - the codec was set                                  *
+ *               FAIL    - the codec is not supported                         *
  *                                                                            *
  ******************************************************************************/
-int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
+int	zbx_compress_set_codec(unsigned char codec)
+{
+	if (SUCCEED != zbx_compress_codec_supported(codec))
+		return FAIL;
+
+	zbx_compress_codec = codec;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns compression codec preferred for data sent to peers        *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_compress_get_codec(void)
+{
+	return zbx_compress_codec;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: runs zlib deflate/inflate over input and output buffers that can  *
+ *          exceed zlib stream buffer size limit                              *
+ *                                                                            *
+ * Parameters: stream   - [IN/OUT] zlib stream with input and output buffer   *
+ *                                 pointers set                               *
+ *             process  - [IN] deflate() or inflate()                         *
+ *             size_in  - [IN] the input data size                            *
+ *             size_out - [IN] the output buffer size                         *
+ *                                                                            *
+ * Return value: the last zlib processing result                              *
+ *                                                                            *
+ ******************************************************************************/
+static int	zlib_process(z_stream *stream, int (*process)(z_streamp, int), size_t size_in, size_t size_out)
+{
+	const uInt	max = (uInt)-1;
+	int		err;
+
+	stream->avail_in = 0;
+	stream->avail_out = 0;
+
+	do
+	{
+		if (0 == stream->avail_out)
+		{
+			stream->avail_out = size_out > max ? max : (uInt)size_out;
+			size_out -= stream->avail_out;
+		}
+
+		if (0 == stream->avail_in)
+		{
+			stream->avail_in = size_in > max ? max : (uInt)size_in;
+			size_in -= stream->avail_in;
+		}
+
+		err = process(stream, 0 != size_in ? Z_NO_FLUSH : Z_FINISH);
+	}
+	while (Z_OK == err);
+
+	return err;
+}
+
+static int	compress_zlib(const char *in, size_t size_in, char **out, size_t *size_out)
 {
 	Bytef	*buf;
-	uLongf	buf_size;
+	uLong	buf_size;
 
-	buf_size = compressBound(size_in);
+	if (NULL == deflate_stream)
+	{
+		deflate_stream = (z_stream *)zbx_malloc(NULL, sizeof(z_stream));
+		memset(deflate_stream, 0, sizeof(z_stream));
+
+		if (Z_OK != (zbx_zlib_errno = deflateInit(deflate_stream, Z_DEFAULT_COMPRESSION)))
+		{
+			zbx_free(deflate_stream);
+			return FAIL;
+		}
+	}
+	else if (Z_OK != (zbx_zlib_errno = deflateReset(deflate_stream)))
+		return FAIL;
+
+	buf_size = deflateBound(deflate_stream, (uLong)size_in);
 	buf = (Bytef *)zbx_malloc(NULL, buf_size);
 
-	if (Z_OK != (zbx_zlib_errno = compress(buf, &buf_size, (const Bytef *)in, size_in)))
+	deflate_stream->next_in = (z_const Bytef *)in;
+	deflate_stream->next_out = buf;
+
+	if (Z_STREAM_END != (zbx_zlib_errno = zlib_process(deflate_stream, deflate, size_in, buf_size)))
 	{
+		if (Z_OK == zbx_zlib_errno)
+			zbx_zlib_errno = Z_BUF_ERROR;
+
 		zbx_free(buf);
 		return FAIL;
 	}
 
 	*out = (char *)buf;
-	*size_out = buf_size;
+	*size_out = deflate_stream->total_out;
+
+	return SUCCEED;
+}
+
+static int	uncompress_zlib(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	if (NULL == inflate_stream)
+	{
+		inflate_stream = (z_stream *)zbx_malloc(NULL, sizeof(z_stream));
+		memset(inflate_stream, 0, sizeof(z_stream));
+
+		if (Z_OK != (zbx_zlib_errno = inflateInit(inflate_stream)))
+		{
+			zbx_free(inflate_stream);
+			return FAIL;
+		}
+	}
+	else if (Z_OK != (zbx_zlib_errno = inflateReset(inflate_stream)))
+		return FAIL;
+
+	inflate_stream->next_in = (z_const Bytef *)in;
+	inflate_stream->next_out = (Bytef *)out;
+
+	if (Z_STREAM_END != (zbx_zlib_errno = zlib_process(inflate_stream, inflate, size_in, *size_out)))
+	{
+		/* follow uncompress() error reporting */
+		if (Z_NEED_DICT == zbx_zlib_errno || (Z_BUF_ERROR == zbx_zlib_errno &&
+				0 == inflate_stream->avail_in))
+		{
+			zbx_zlib_errno = Z_DATA_ERROR;
+		}
+		else if (Z_OK == zbx_zlib_errno)
+			zbx_zlib_errno = Z_BUF_ERROR;
+
+		return FAIL;
+	}
+
+	*size_out = inflate_stream->total_out;
+
+	return SUCCEED;
+}
+
+#ifdef HAVE_ZSTD
+static int	compress_zstd(const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	char	*buf;
+	size_t	buf_size, ret;
+
+	if (NULL == zstd_cctx && NULL == (zstd_cctx = ZSTD_createCCtx()))
+	{
+		zbx_compress_errmsg = "cannot create zstd compression context";
+		return FAIL;
+	}
+
+	buf_size = ZSTD_compressBound(size_in);
+	buf = (char *)zbx_malloc(NULL, buf_size);
+
+	if (0 != ZSTD_isError(ret = ZSTD_compress2(zstd_cctx, buf, buf_size, in, size_in)))
+	{
+		zbx_compress_errmsg = ZSTD_getErrorName(ret);
+		zbx_free(buf);
+
+		/* reset context, so the next message is not affected by failed compression */
+		ZSTD_CCtx_reset(zstd_cctx, ZSTD_reset_session_only);
+
+		return FAIL;
+	}
+
+	*out = buf;
+	*size_out = ret;
 
 	return SUCCEED;
 }
 
+static int	uncompress_zstd(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	size_t	ret;
+
+	if (NULL == zstd_dctx && NULL == (zstd_dctx = ZSTD_createDCtx()))
+	{
+		zbx_compress_errmsg = "cannot create zstd decompression context";
+		return FAIL;
+	}
+
+	if (0 != ZSTD_isError(ret = ZSTD_decompressDCtx(zstd_dctx, out, *size_out, in, size_in)))
+	{
+		zbx_compress_errmsg = ZSTD_getErrorName(ret);
+		return FAIL;
+	}
+
+	*size_out = ret;
+
+	return SUCCEED;
+}
+#endif
+
+#ifdef HAVE_LZ4
+static int	compress_lz4(const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	char	*buf;
+	int	buf_size, ret;
+
+	if (LZ4_MAX_INPUT_SIZE < size_in)
+	{
+		zbx_compress_errmsg = "input data is too large for LZ4 compression";
+		return FAIL;
+	}
+
+	if (NULL == lz4_state)
+		lz4_state = zbx_malloc(NULL, (size_t)LZ4_sizeofState());
+
+	buf_size = LZ4_compressBound((int)size_in);
+	buf = (char *)zbx_malloc(NULL, (size_t)buf_size);
+
+	if (0 >= (ret = LZ4_compress_fast_extState(lz4_state, in, buf, (int)size_in, buf_size, 1)))
+	{
+		zbx_compress_errmsg = "not enough space in output buffer";
+		zbx_free(buf);
+		return FAIL;
+	}
+
+	*out = buf;
+	*size_out = (size_t)ret;
+
+	return SUCCEED;
+}
+
+static int	uncompress_lz4(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	int	ret;
+
+	if (INT_MAX < size_in || INT_MAX < *size_out)
+	{
+		zbx_compress_errmsg = "data is too large for LZ4 decompression";
+		return FAIL;
+	}
+
+	if (0 > (ret = LZ4_decompress_safe(in, out, (int)size_in, (int)*size_out)))
+	{
+		zbx_compress_errmsg = "corrupted input data";
+		return FAIL;
+	}
+
+	*size_out = (size_t)ret;
+
+	return SUCCEED;
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
- * Purpose: uncompress data                                                   *
+ * Purpose: compress data with the specified codec                            *
+ *                                                                            *
+ * Parameters: codec    - [IN] ZBX_COMPRESS_* codec                           *
+ *             in       - [IN] the data to compress                           *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the compressed data                           *
+ *             size_out - [OUT] the compressed data size                      *
+ *                                                                            *
+ * Return value: SUCCEED - the data was compressed successfully               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: In the case of success the output buffer must be freed by the    *
+ *           caller.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_compress_ext(unsigned char codec, const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	zbx_compress_errmsg = NULL;
+
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			return compress_zlib(in, size_in, out, size_out);
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			return compress_zstd(in, size_in, out, size_out);
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			return compress_lz4(in, size_in, out, size_out);
+#endif
+		default:
+			zbx_compress_errmsg = "unsupported compression codec";
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress data with the specified codec                          *
+ *                                                                            *
+ * Parameters: codec    - [IN] ZBX_COMPRESS_* codec                           *
+ *             in       - [IN] the data to uncompress                         *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the uncompressed data                         *
+ *             size_out - [IN/OUT] the buffer and uncompressed data size      *
+ *                                                                            *
+ * Return value: SUCCEED - the data was uncompressed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_ext(unsigned char codec, const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	zbx_compress_errmsg = NULL;
+
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			return uncompress_zlib(in, size_in, out, size_out);
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			return uncompress_zstd(in, size_in, out, size_out);
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			return uncompress_lz4(in, size_in, out, size_out);
+#endif
+		default:
+			zbx_compress_errmsg = "unsupported compression codec";
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress data with zlib, understood by all peers                  *
+ *                                                                            *
+ * Parameters: in       - [IN] the data to compress                           *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the compressed data                           *
+ *             size_out - [OUT] the compressed data size                      *
+ *                                                                            *
+ * Return value: SUCCEED - the data was compressed successfully               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: In the case of success the output buffer must be freed by the    *
+ *           caller.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	return zbx_compress_ext(ZBX_COMPRESS_ZLIB, in, size_in, out, size_out);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress zlib compressed data                                   *
  *                                                                            *
  * Parameters: in       - [IN] the data to uncompress                         *
  *             size_in  - [IN] the input data size                            *
@@ -105,18 +579,301 @@ int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
  ******************************************************************************/
 int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
 {
-	uLongf	size_o = *size_out;
+	return zbx_uncompress_ext(ZBX_COMPRESS_ZLIB, in, size_in, out, size_out);
+}
+
+/* streaming decompression state, zlib and zstd only - LZ4 block format cannot be decompressed in parts */
+struct zbx_uncompress_stream
+{
+	unsigned char	codec;
+	char		*out;
+	size_t		size_out;
+	size_t		offset;
+	int		finished;
+	z_stream	zlib;
+#ifdef HAVE_ZSTD
+	ZSTD_DStream	*zstd;
+#endif
+};
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if data compressed with the codec can be uncompressed in   *
+ *          parts                                                             *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream_supported(unsigned char codec)
+{
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+#endif
+			return SUCCEED;
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates stream to uncompress data as it arrives                   *
+ *                                                                            *
+ * Parameters: codec    - [IN] ZBX_COMPRESS_* codec                           *
+ *             out      - [IN] the output buffer                              *
+ *             size_out - [IN] the output buffer size                         *
+ *                                                                            *
+ * Return value: the created stream or NULL if the codec does not support     *
+ *               streaming or its context cannot be created                   *
+ *                                                                            *
+ * Comments: Each stream has own codec context, so several messages can be    *
+ *           received at the same time.                                       *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uncompress_stream_t	*zbx_uncompress_stream_create(unsigned char codec, char *out, size_t size_out)
+{
+	zbx_uncompress_stream_t	*stream;
+
+	zbx_compress_errmsg = NULL;
+
+	if (SUCCEED != zbx_uncompress_stream_supported(codec))
+	{
+		zbx_compress_errmsg = "unsupported compression codec";
+		return NULL;
+	}
+
+	stream = (zbx_uncompress_stream_t *)zbx_malloc(NULL, sizeof(zbx_uncompress_stream_t));
+	memset(stream, 0, sizeof(zbx_uncompress_stream_t));
+
+	stream->codec = codec;
+	stream->out = out;
+	stream->size_out = size_out;
+
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			if (Z_OK != (zbx_zlib_errno = inflateInit(&stream->zlib)))
+			{
+				zbx_free(stream);
+				return NULL;
+			}
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			if (NULL == (stream->zstd = ZSTD_createDStream()))
+			{
+				zbx_compress_errmsg = "cannot create zstd decompression context";
+				zbx_free(stream);
+				return NULL;
+			}
+			break;
+#endif
+	}
+
+	return stream;
+}
+
+static int	uncompress_stream_zlib(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	const uInt	max = (uInt)-1;
+	z_stream	*zs = &stream->zlib;
+
+	zs->next_in = (z_const Bytef *)in;
+
+	while (0 != size_in)
+	{
+		zs->avail_in = size_in > max ? max : (uInt)size_in;
+		size_in -= zs->avail_in;
+
+		while (0 != zs->avail_in)
+		{
+			size_t	left = stream->size_out - stream->offset;
+			uInt	avail, avail_in = zs->avail_in;
+
+			/* data after the end of compressed stream */
+			if (0 != stream->finished)
+			{
+				zbx_zlib_errno = Z_DATA_ERROR;
+				return FAIL;
+			}
+
+			/* inflate is called also with full output buffer - end of block and checksum */
+			/* can still follow the last uncompressed byte                                 */
+			zs->next_out = (Bytef *)stream->out + stream->offset;
+			zs->avail_out = avail = left > max ? max : (uInt)left;
+
+			zbx_zlib_errno = inflate(zs, Z_NO_FLUSH);
+			stream->offset += avail - zs->avail_out;
+
+			if (Z_STREAM_END == zbx_zlib_errno)
+			{
+				stream->finished = 1;
+			}
+			else if (Z_BUF_ERROR == zbx_zlib_errno || (Z_OK == zbx_zlib_errno &&
+					avail_in == zs->avail_in && avail == zs->avail_out))
+			{
+				/* no progress - uncompressed data does not fit in output buffer */
+				zbx_zlib_errno = Z_BUF_ERROR;
+				return FAIL;
+			}
+			else if (Z_OK != zbx_zlib_errno)
+			{
+				if (Z_NEED_DICT == zbx_zlib_errno)
+					zbx_zlib_errno = Z_DATA_ERROR;
+
+				return FAIL;
+			}
+		}
+	}
+
+	return SUCCEED;
+}
+
+#ifdef HAVE_ZSTD
+static int	uncompress_stream_zstd(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	ZSTD_inBuffer	input = {in, size_in, 0};
+
+	while (input.pos < input.size)
+	{
+		ZSTD_outBuffer	output = {stream->out, stream->size_out, stream->offset};
+		size_t		ret, pos_in = input.pos;
+
+		if (0 != ZSTD_isError(ret = ZSTD_decompressStream(stream->zstd, &output, &input)))
+		{
+			zbx_compress_errmsg = ZSTD_getErrorName(ret);
+			return FAIL;
+		}
+
+		if (pos_in == input.pos && stream->offset == output.pos)
+		{
+			zbx_compress_errmsg = "not enough space in output buffer";
+			return FAIL;
+		}
+
+		stream->offset = output.pos;
+
+		/* zero is returned when frame is complete, the input can have several frames */
+		stream->finished = (0 == ret);
+	}
+
+	return SUCCEED;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompresses next part of data                                    *
+ *                                                                            *
+ * Parameters: stream  - [IN/OUT] the uncompression stream                    *
+ *             in      - [IN] the data to uncompress                          *
+ *             size_in - [IN] the input data size                             *
+ *                                                                            *
+ * Return value: SUCCEED - the data was uncompressed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream_write(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	zbx_compress_errmsg = NULL;
+
+	switch (stream->codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			return uncompress_stream_zlib(stream, in, size_in);
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			return uncompress_stream_zstd(stream, in, size_in);
+#endif
+		default:
+			zbx_compress_errmsg = "unsupported compression codec";
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks that all compressed data was received                      *
+ *                                                                            *
+ * Parameters: stream   - [IN] the uncompression stream                       *
+ *             size_out - [OUT] the uncompressed data size                    *
+ *                                                                            *
+ * Return value: SUCCEED - the compressed data is complete                    *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream_finish(zbx_uncompress_stream_t *stream, size_t *size_out)
+{
+	zbx_compress_errmsg = NULL;
 
-	if (Z_OK != (zbx_zlib_errno = uncompress((Bytef *)out, &size_o, (const Bytef *)in, size_in)))
+	if (0 == stream->finished)
+	{
+		zbx_compress_errmsg = "unexpected end of compressed data";
 		return FAIL;
+	}
 
-	*size_out = size_o;
+	*size_out = stream->offset;
 
 	return SUCCEED;
 }
 
+void	zbx_uncompress_stream_free(zbx_uncompress_stream_t *stream)
+{
+	switch (stream->codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			inflateEnd(&stream->zlib);
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			ZSTD_freeDStream(stream->zstd);
+			break;
+#endif
+	}
+
+	zbx_free(stream);
+}
+
 #else
 
+int	zbx_compress_codec_supported(unsigned char codec)
+{
+	ZBX_UNUSED(codec);
+	return FAIL;
+}
+
+int	zbx_compress_set_codec(unsigned char codec)
+{
+	ZBX_UNUSED(codec);
+	return FAIL;
+}
+
+unsigned char	zbx_compress_get_codec(void)
+{
+	return ZBX_COMPRESS_ZLIB;
+}
+
+int	zbx_compress_ext(unsigned char codec, const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	ZBX_UNUSED(codec);
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
+int	zbx_uncompress_ext(unsigned char codec, const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	ZBX_UNUSED(codec);
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
 int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
 {
 	ZBX_UNUSED(in);
@@ -135,6 +892,40 @@ int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
 	return FAIL;
 }
 
+int	zbx_uncompress_stream_supported(unsigned char codec)
+{
+	ZBX_UNUSED(codec);
+	return FAIL;
+}
+
+zbx_uncompress_stream_t	*zbx_uncompress_stream_create(unsigned char codec, char *out, size_t size_out)
+{
+	ZBX_UNUSED(codec);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	return NULL;
+}
+
+int	zbx_uncompress_stream_write(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	ZBX_UNUSED(stream);
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	return FAIL;
+}
+
+int	zbx_uncompress_stream_finish(zbx_uncompress_stream_t *stream, size_t *size_out)
+{
+	ZBX_UNUSED(stream);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
+void	zbx_uncompress_stream_free(zbx_uncompress_stream_t *stream)
+{
+	ZBX_UNUSED(stream);
+}
+
 const char	*zbx_compress_strerror(void)
 {
 	return "";
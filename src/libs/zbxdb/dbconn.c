@@ -970,6 +970,127 @@ static int	dbconn_execute(zbx_dbconn_t *db, const char *fmt, ...)
 	return ret;
 }
 
+#if defined(HAVE_POSTGRESQL)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks COPY command result                                        *
+ *                                                                            *
+ * Return value: ZBX_DB_OK, ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on         *
+ *               recoverable error)                                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbconn_check_copy_result(zbx_dbconn_t *db, PGresult *result, ExecStatusType status, const char *sql)
+{
+	zbx_err_codes_t	errcode;
+	char		*error = NULL;
+
+	if (NULL == result)
+	{
+		dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), sql);
+		return CONNECTION_OK == PQstatus(db->conn) ? ZBX_DB_FAIL : ZBX_DB_DOWN;
+	}
+
+	if (status == PQresultStatus(result))
+		return ZBX_DB_OK;
+
+	db_get_postgresql_error(&error, result);
+
+	if (0 == zbx_strcmp_null(PQresultErrorField(result, PG_DIAG_SQLSTATE), ZBX_PG_UNIQUE_VIOLATION))
+		errcode = ERR_Z3008;
+	else if (0 == zbx_strcmp_null(PQresultErrorField(result, PG_DIAG_SQLSTATE), ZBX_PG_READ_ONLY))
+		errcode = ERR_Z3009;
+	else
+		errcode = ERR_Z3005;
+
+	dbconn_errlog(db, errcode, 0, error, sql);
+	zbx_free(error);
+
+	return SUCCEED == dbconn_is_recoverable_error(db, result) ? ZBX_DB_DOWN : ZBX_DB_FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes COPY ... FROM STDIN statement and sends the data         *
+ *                                                                            *
+ * Parameters: db   - [IN] database connection                                *
+ *             sql  - [IN] COPY statement                                     *
+ *             data - [IN] data in the format specified by COPY statement     *
+ *             size - [IN] data size                                          *
+ *                                                                            *
+ * Return value: ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *               or number of rows copied (on success)                        *
+ *                                                                            *
+ * Comments: Unlike query execution the transaction is not marked as failed   *
+ *           on errors, so the caller can roll back to a savepoint and retry  *
+ *           the operation in other way.                                      *
+ *                                                                            *
+ ******************************************************************************/
+int	dbconn_copy_from(zbx_dbconn_t *db, const char *sql, const char *data, size_t size)
+{
+	PGresult	*result;
+	int		ret;
+	size_t		offset;
+	double		sec = 0;
+
+	if (ZBX_DB_OK != db->txn_error)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "ignoring query [txnlev:%d] [%s] within failed transaction", db->txn_level,
+				sql);
+		return ZBX_DB_FAIL;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "query [txnlev:%d] [%s] (" ZBX_FS_SIZE_T " bytes)", db->txn_level, sql,
+			(zbx_fs_size_t)size);
+
+	if (0 != db->config->log_slow_queries)
+		sec = zbx_time();
+
+	result = PQexec(db->conn, sql);
+
+	if (ZBX_DB_OK != (ret = dbconn_check_copy_result(db, result, PGRES_COPY_IN, sql)))
+	{
+		PQclear(result);
+		return ret;
+	}
+
+	PQclear(result);
+
+	for (offset = 0; offset < size;)
+	{
+		size_t	chunk_size = MIN(size - offset, ZBX_MEBIBYTE);
+
+		if (1 != PQputCopyData(db->conn, data + offset, (int)chunk_size))
+			break;
+
+		offset += chunk_size;
+	}
+
+	if (1 != PQputCopyEnd(db->conn, offset == size ? NULL : "cannot send data"))
+		dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), sql);
+
+	result = PQgetResult(db->conn);
+
+	if (ZBX_DB_OK == (ret = dbconn_check_copy_result(db, result, PGRES_COMMAND_OK, sql)))
+		ret = atoi(PQcmdTuples(result));
+
+	/* consume remaining results to return connection into idle state */
+	do
+	{
+		PQclear(result);
+	}
+	while (NULL != (result = PQgetResult(db->conn)));
+
+	if (0 != db->config->log_slow_queries)
+	{
+		sec = zbx_time() - sec;
+		if (sec > (double)db->config->log_slow_queries / 1000.0)
+			zabbix_log(LOG_LEVEL_WARNING, "slow query: " ZBX_FS_DBL " sec, \"%s\"", sec, sql);
+	}
+
+	return ret;
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: start transaction                                                 *
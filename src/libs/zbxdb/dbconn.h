@@ -83,5 +83,9 @@ int	db_is_escape_sequence(char c);
 
 zbx_uint32_t	db_get_server_version(void);
 
+#if defined(HAVE_POSTGRESQL)
+int	dbconn_copy_from(zbx_dbconn_t *db, const char *sql, const char *data, size_t size);
+#endif
+
 #endif
 
@@ -562,6 +562,417 @@ out:
 	return ret;
 }
 
+#if defined(HAVE_POSTGRESQL)
+
+#define ZBX_PG_COPY_SAVEPOINT		"zbx_copy"
+#define ZBX_PG_COPY_NULL		((zbx_uint32_t)-1)	/* field length of NULL value */
+#define ZBX_PG_COPY_RETRY_PERIOD	SEC_PER_HOUR
+#define ZBX_PG_COPY_DISABLED_MAX	16
+
+typedef struct
+{
+	const zbx_db_table_t	*table;
+	time_t			retry_time;
+}
+zbx_db_copy_disabled_t;
+
+/* tables for which COPY failed because of data or permission problems, bulk */
+/* inserts into them use INSERT statements until the retry time              */
+static zbx_db_copy_disabled_t	copy_disabled[ZBX_PG_COPY_DISABLED_MAX];
+static int			copy_disabled_num = 0;
+
+static int	db_copy_disabled_index(const zbx_db_table_t *table)
+{
+	for (int i = 0; i < copy_disabled_num; i++)
+	{
+		if (copy_disabled[i].table == table)
+			return i;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if COPY is temporarily disabled for the table              *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_copy_is_disabled(const zbx_db_table_t *table)
+{
+	int	index;
+
+	if (FAIL == (index = db_copy_disabled_index(table)))
+		return FAIL;
+
+	if (time(NULL) < copy_disabled[index].retry_time)
+		return SUCCEED;
+
+	copy_disabled[index] = copy_disabled[--copy_disabled_num];
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: disables COPY for the table until the retry period expires        *
+ *                                                                            *
+ * Comments: When all slots are taken the entry with the earliest retry time  *
+ *           is reused.                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_disable(const zbx_db_table_t *table)
+{
+	int	index;
+
+	if (FAIL == (index = db_copy_disabled_index(table)))
+	{
+		if (ZBX_PG_COPY_DISABLED_MAX > copy_disabled_num)
+		{
+			index = copy_disabled_num++;
+		}
+		else
+		{
+			index = 0;
+
+			for (int i = 1; i < copy_disabled_num; i++)
+			{
+				if (copy_disabled[i].retry_time < copy_disabled[index].retry_time)
+					index = i;
+			}
+		}
+	}
+
+	copy_disabled[index].table = table;
+	copy_disabled[index].retry_time = time(NULL) + ZBX_PG_COPY_RETRY_PERIOD;
+}
+
+static void	db_copy_append(char **buf, size_t *alloc, size_t *offset, const void *data, size_t size)
+{
+	if (*offset + size > *alloc)
+	{
+		while (*offset + size > *alloc)
+			*alloc *= 2;
+
+		*buf = (char *)zbx_realloc(*buf, *alloc);
+	}
+
+	memcpy(*buf + *offset, data, size);
+	*offset += size;
+}
+
+static void	db_copy_append_uint16(char **buf, size_t *alloc, size_t *offset, unsigned short value)
+{
+	unsigned char	data[2] = {(unsigned char)(value >> 8), (unsigned char)value};
+
+	db_copy_append(buf, alloc, offset, data, sizeof(data));
+}
+
+static void	db_copy_append_uint32(char **buf, size_t *alloc, size_t *offset, zbx_uint32_t value)
+{
+	unsigned char	data[4];
+
+	for (int i = 3; 0 <= i; i--, value >>= 8)
+		data[i] = (unsigned char)value;
+
+	db_copy_append(buf, alloc, offset, data, sizeof(data));
+}
+
+static void	db_copy_append_uint64(char **buf, size_t *alloc, size_t *offset, zbx_uint64_t value)
+{
+	unsigned char	data[8];
+
+	for (int i = 7; 0 <= i; i--, value >>= 8)
+		data[i] = (unsigned char)value;
+
+	db_copy_append(buf, alloc, offset, data, sizeof(data));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends unsigned 64 bit integer in PostgreSQL binary numeric      *
+ *          format                                                            *
+ *                                                                            *
+ * Comments: Numeric is sent as number of base 10000 digits, weight of the    *
+ *           first digit, sign, display scale and the digits starting with    *
+ *           the most significant one.                                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_append_numeric(char **buf, size_t *alloc, size_t *offset, zbx_uint64_t value)
+{
+	unsigned short	digits[5];	/* 2^64 has 20 decimal digits */
+	int		digits_num = 0, weight, i;
+
+	for (; 0 != value; value /= 10000)
+		digits[digits_num++] = (unsigned short)(value % 10000);
+
+	weight = (0 == digits_num ? 0 : digits_num - 1);
+
+	/* trailing zero digits are implied by the weight */
+	for (i = 0; i < digits_num && 0 == digits[i]; i++)
+		;
+
+	db_copy_append_uint32(buf, alloc, offset, (zbx_uint32_t)(8 + 2 * (digits_num - i)));
+	db_copy_append_uint16(buf, alloc, offset, (unsigned short)(digits_num - i));
+	db_copy_append_uint16(buf, alloc, offset, (unsigned short)weight);
+	db_copy_append_uint16(buf, alloc, offset, 0);	/* positive sign */
+	db_copy_append_uint16(buf, alloc, offset, 0);	/* display scale */
+
+	while (i < digits_num--)
+		db_copy_append_uint16(buf, alloc, offset, digits[digits_num]);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends string value stored in bulk insert row                    *
+ *                                                                            *
+ * Comments: Row values are escaped for use in SQL statements, COPY expects   *
+ *           raw values, so the escape sequences are removed.                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_append_str(char **buf, size_t *alloc, size_t *offset, const char *str)
+{
+	size_t		len_offset = *offset;
+	const char	*ptr = str;
+	zbx_uint32_t	len;
+
+	db_copy_append_uint32(buf, alloc, offset, 0);
+
+	while ('\0' != *ptr)
+	{
+		const char	*start = ptr;
+
+		/* copy up to and including the next escaped character and skip its duplicate */
+		while ('\0' != *ptr && SUCCEED != db_is_escape_sequence(*ptr))
+			ptr++;
+
+		if ('\0' != *ptr)
+			ptr++;
+
+		db_copy_append(buf, alloc, offset, start, (size_t)(ptr - start));
+
+		if ('\0' != *ptr && SUCCEED == db_is_escape_sequence(*ptr))
+			ptr++;
+	}
+
+	len = (zbx_uint32_t)(*offset - len_offset - 4);
+
+	for (int i = 3; 0 <= i; i--, len >>= 8)
+		(*buf)[len_offset + (size_t)i] = (char)(unsigned char)len;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends base64 encoded binary value stored in bulk insert row     *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_append_bin(char **buf, size_t *alloc, size_t *offset, const char *str)
+{
+	size_t	data_alloc = strlen(str) * 3 / 4 + 1, data_len;
+	char	*data = (char *)zbx_malloc(NULL, data_alloc);
+
+	zbx_base64_decode(str, data, data_alloc, &data_len);
+
+	db_copy_append_uint32(buf, alloc, offset, (zbx_uint32_t)data_len);
+	db_copy_append(buf, alloc, offset, data, data_len);
+
+	zbx_free(data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: serializes bulk insert rows in PostgreSQL binary COPY format      *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_insert_copy_serialize(const zbx_db_insert_t *db_insert, char **buf, size_t *alloc, size_t *offset)
+{
+	/* signature, flags and header extension length */
+	db_copy_append(buf, alloc, offset, "PGCOPY\n\377\r\n", 11);
+	db_copy_append_uint32(buf, alloc, offset, 0);
+	db_copy_append_uint32(buf, alloc, offset, 0);
+
+	for (int i = 0; i < db_insert->rows.values_num; i++)
+	{
+		const zbx_db_value_t	*values = db_insert->rows.values[i];
+
+		db_copy_append_uint16(buf, alloc, offset, (unsigned short)db_insert->fields.values_num);
+
+		for (int j = 0; j < db_insert->fields.values_num; j++)
+		{
+			const zbx_db_value_t	*value = &values[j];
+			zbx_uint64_t		dbl_bits;
+
+			switch (db_insert->fields.values[j]->type)
+			{
+				case ZBX_TYPE_CHAR:
+				case ZBX_TYPE_TEXT:
+				case ZBX_TYPE_LONGTEXT:
+				case ZBX_TYPE_CUID:
+					if (NULL == value->str)
+						db_copy_append_uint32(buf, alloc, offset, ZBX_PG_COPY_NULL);
+					else
+						db_copy_append_str(buf, alloc, offset, value->str);
+					break;
+				case ZBX_TYPE_BLOB:
+					/* same as INSERT statements - NULL blob is inserted as empty value */
+					db_copy_append_bin(buf, alloc, offset, ZBX_NULL2EMPTY_STR(value->str));
+					break;
+				case ZBX_TYPE_INT:
+					db_copy_append_uint32(buf, alloc, offset, 4);
+					db_copy_append_uint32(buf, alloc, offset, (zbx_uint32_t)value->i32);
+					break;
+				case ZBX_TYPE_FLOAT:
+					memcpy(&dbl_bits, &value->dbl, sizeof(dbl_bits));
+					db_copy_append_uint32(buf, alloc, offset, 8);
+					db_copy_append_uint64(buf, alloc, offset, dbl_bits);
+					break;
+				case ZBX_TYPE_UINT:
+					db_copy_append_numeric(buf, alloc, offset, value->ui64);
+					break;
+				case ZBX_TYPE_ID:
+					/* same as INSERT statements - zero identifier is inserted as NULL */
+					if (0 == value->ui64)
+					{
+						db_copy_append_uint32(buf, alloc, offset, ZBX_PG_COPY_NULL);
+						break;
+					}
+					ZBX_FALLTHROUGH;
+				case ZBX_TYPE_SERIAL:
+					db_copy_append_uint32(buf, alloc, offset, 8);
+					db_copy_append_uint64(buf, alloc, offset, value->ui64);
+					break;
+				default:
+					THIS_SHOULD_NEVER_HAPPEN;
+					exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	/* file trailer */
+	db_copy_append_uint16(buf, alloc, offset, 0xffff);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if bulk insert can be performed with COPY command          *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_insert_copy_supported(const zbx_db_insert_t *db_insert)
+{
+	if (-1 != db_insert->autoincrement || NULL != db_insert->clause)
+		return FAIL;
+
+	if (SUCCEED == db_copy_is_disabled(db_insert->table))
+		return FAIL;
+
+	for (int i = 0; i < db_insert->fields.values_num; i++)
+	{
+		if (0 != (db_insert->fields.values[i]->flags & ZBX_UPPER))
+			return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: inserts the prepared rows with binary COPY command                *
+ *                                                                            *
+ * Return value: SUCCEED - the rows were inserted                             *
+ *               FAIL    - the transaction has failed                         *
+ *               NOTSUPPORTED - COPY failed, the transaction was rolled back  *
+ *                              to the state before COPY                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_insert_copy(zbx_db_insert_t *db_insert)
+{
+	char	*sql = NULL, *data;
+	size_t	sql_alloc = 0, sql_offset = 0, data_alloc = 16 * ZBX_KIBIBYTE, data_offset = 0;
+	int	rc;
+
+	if (ZBX_DB_OK > zbx_dbconn_execute(db_insert->db, "savepoint " ZBX_PG_COPY_SAVEPOINT ";"))
+		return FAIL;
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "copy %s (", db_insert->table->table);
+
+	for (int i = 0; i < db_insert->fields.values_num; i++)
+	{
+		if (0 != i)
+			zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ',');
+
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, db_insert->fields.values[i]->name);
+	}
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ") from stdin (format binary)");
+
+	data = (char *)zbx_malloc(NULL, data_alloc);
+	db_insert_copy_serialize(db_insert, &data, &data_alloc, &data_offset);
+
+	rc = dbconn_copy_from(db_insert->db, sql, data, data_offset);
+
+	zbx_free(data);
+	zbx_free(sql);
+
+	if (ZBX_DB_OK <= rc)
+	{
+		if (ZBX_DB_OK > zbx_dbconn_execute(db_insert->db, "release savepoint " ZBX_PG_COPY_SAVEPOINT ";"))
+			return FAIL;
+
+		return SUCCEED;
+	}
+
+	if (ZBX_DB_FAIL == rc && ERR_Z3008 == db_insert->db->last_db_errcode)
+	{
+		/* INSERT statements would fail with the same error */
+		db_insert->db->txn_error = ZBX_DB_FAIL;
+		return FAIL;
+	}
+
+	if (ZBX_DB_OK > zbx_dbconn_execute(db_insert->db, "rollback to savepoint " ZBX_PG_COPY_SAVEPOINT ";"))
+		return FAIL;
+
+	if (ZBX_DB_FAIL == rc)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot insert data into table \"%s\" with COPY command, falling back"
+				" to INSERT statements for %d seconds", db_insert->table->table,
+				ZBX_PG_COPY_RETRY_PERIOD);
+		db_copy_disable(db_insert->table);
+	}
+
+	return NOTSUPPORTED;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes the prepared database bulk insert operation using the    *
+ *          fastest method supported by database                              *
+ *                                                                            *
+ * Parameters: self - [IN] the bulk insert data                               *
+ *                                                                            *
+ * Return value: SUCCEED if the operation completed successfully or           *
+ *               FAIL otherwise.                                              *
+ *                                                                            *
+ * Comments: On PostgreSQL the rows are sent with binary COPY command. If it  *
+ *           fails the rows are inserted with INSERT statements instead.      *
+ *           Autoincrement fields, insert clauses and fields requiring SQL    *
+ *           functions are not supported by COPY and are always inserted      *
+ *           with INSERT statements.                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_insert_execute_copy(zbx_db_insert_t *db_insert)
+{
+#if defined(HAVE_POSTGRESQL)
+	int	ret;
+
+	if (0 == db_insert->rows.values_num)
+		return SUCCEED;
+
+	if (SUCCEED == db_insert_copy_supported(db_insert) && NOTSUPPORTED != (ret = db_insert_copy(db_insert)))
+		return ret;
+#endif
+	return zbx_db_insert_execute(db_insert);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: executes the prepared database bulk insert operation              *
@@ -16,14 +16,6 @@
 
 #include "zbxdb.h"
 
-/* group statuses */
-typedef enum
-{
-	GROUP_STATUS_ACTIVE = 0,
-	GROUP_STATUS_DISABLED
-}
-zbx_group_status_type_t;
-
 /******************************************************************************
  *                                                                            *
  * Purpose: Check user permissions to access system.                          *
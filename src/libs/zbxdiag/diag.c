@@ -197,6 +197,33 @@ void	zbx_diag_add_mem_stats(struct zbx_json *json, const char *name, const zbx_s
 
 	zbx_json_close(json);
 	zbx_json_close(json);
+
+	if (0 != stats->slabs_num)
+	{
+		zbx_json_addobject(json, "slabs");
+		zbx_json_adduint64(json, "count", stats->slabs_num);
+		zbx_json_addarray(json, "classes");
+
+		for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+		{
+			char	buf[MAX_ID_LEN + 2];
+
+			if (0 == stats->slab_used_num[i] + stats->slab_free_num[i])
+				continue;
+
+			zbx_snprintf(buf, sizeof(buf), "%d", ZBX_SHMEM_MIN_BUCKET_SIZE + 8 * i);
+			zbx_json_addobject(json, NULL);
+			zbx_json_addobject(json, buf);
+			zbx_json_adduint64(json, "used", stats->slab_used_num[i]);
+			zbx_json_adduint64(json, "free", stats->slab_free_num[i]);
+			zbx_json_close(json);
+			zbx_json_close(json);
+		}
+
+		zbx_json_close(json);
+		zbx_json_close(json);
+	}
+
 	zbx_json_close(json);
 }
 
@@ -409,29 +436,42 @@ void	zbx_diag_add_locks_info(struct zbx_json *json)
 {
 	int		i;
 #ifdef HAVE_VMINFO_T_UPDATES
-	const char	*names[ZBX_MUTEX_COUNT] = {"ZBX_MUTEX_LOG", "ZBX_MUTEX_CACHE", "ZBX_MUTEX_TRENDS",
+	const char	*names[ZBX_MUTEX_CACHE_PARTITION] = {"ZBX_MUTEX_LOG", "ZBX_MUTEX_CACHE", "ZBX_MUTEX_TRENDS",
 				"ZBX_MUTEX_CACHE_IDS", "ZBX_MUTEX_SELFMON", "ZBX_MUTEX_CPUSTATS", "ZBX_MUTEX_DISKSTATS",
 				"ZBX_MUTEX_VALUECACHE", "ZBX_MUTEX_VMWARE", "ZBX_MUTEX_SQLITE3",
 				"ZBX_MUTEX_PROCSTAT", "ZBX_MUTEX_PROXY_HISTORY", "ZBX_MUTEX_KSTAT", "ZBX_MUTEX_MODBUS",
 				"ZBX_MUTEX_TREND_FUNC", "ZBX_MUTEX_REMOTE_COMMANDS", "ZBX_MUTEX_PROXY_BUFFER",
-				"ZBX_MUTEX_VPS_MONITOR"};
+				"ZBX_MUTEX_VPS_MONITOR", "ZBX_MUTEX_CONFIG_STATS",
+				"ZBX_MUTEX_ESCALATION_SHARDS"};
 #else
-	const char	*names[ZBX_MUTEX_COUNT] = {"ZBX_MUTEX_LOG", "ZBX_MUTEX_CACHE", "ZBX_MUTEX_TRENDS",
+	const char	*names[ZBX_MUTEX_CACHE_PARTITION] = {"ZBX_MUTEX_LOG", "ZBX_MUTEX_CACHE", "ZBX_MUTEX_TRENDS",
 				"ZBX_MUTEX_CACHE_IDS", "ZBX_MUTEX_SELFMON", "ZBX_MUTEX_CPUSTATS", "ZBX_MUTEX_DISKSTATS",
 				"ZBX_MUTEX_VALUECACHE", "ZBX_MUTEX_VMWARE", "ZBX_MUTEX_SQLITE3",
 				"ZBX_MUTEX_PROCSTAT", "ZBX_MUTEX_PROXY_HISTORY", "ZBX_MUTEX_MODBUS",
 				"ZBX_MUTEX_TREND_FUNC", "ZBX_MUTEX_REMOTE_COMMANDS", "ZBX_MUTEX_PROXY_BUFFER",
-				"ZBX_MUTEX_VPS_MONITOR"};
+				"ZBX_MUTEX_VPS_MONITOR", "ZBX_MUTEX_CONFIG_STATS",
+				"ZBX_MUTEX_ESCALATION_SHARDS"};
 #endif
 	zbx_json_addarray(json, ZBX_DIAG_LOCKS);
 
-	for (i = 0; i < ZBX_MUTEX_COUNT; i++)
+	for (i = 0; i < ZBX_MUTEX_CACHE_PARTITION; i++)
 	{
 		zbx_json_addobject(json, NULL);
 		zbx_json_addhex(json, names[i], (zbx_uint64_t)zbx_mutex_addr_get(i));
 		zbx_json_close(json);
 	}
 
+	for (; i < ZBX_MUTEX_COUNT; i++)
+	{
+		char	name[64];
+
+		zbx_snprintf(name, sizeof(name), "ZBX_MUTEX_CACHE_PARTITION_%d", i - ZBX_MUTEX_CACHE_PARTITION + 1);
+
+		zbx_json_addobject(json, NULL);
+		zbx_json_addhex(json, name, (zbx_uint64_t)zbx_mutex_addr_get(i));
+		zbx_json_close(json);
+	}
+
 	zbx_json_addobject(json, NULL);
 	zbx_json_addhex(json, "ZBX_RWLOCK_CONFIG", (zbx_uint64_t)zbx_rwlock_addr_get(ZBX_RWLOCK_CONFIG));
 	zbx_json_close(json);
@@ -540,7 +580,7 @@ static void	diag_prepare_default_request(struct zbx_json *j, unsigned int flags)
 	}
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_LLD)))
-		diag_add_section_request(j, ZBX_DIAG_LLD, "values", NULL);
+		diag_add_section_request(j, ZBX_DIAG_LLD, "values", "time_ms", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_ALERTING)))
 		diag_add_section_request(j, ZBX_DIAG_ALERTING, "media.alerts", "source.alerts", NULL);
@@ -772,6 +812,7 @@ static void	diag_log_lld(struct zbx_json_parse *jp, char **out, size_t *out_allo
 	zbx_free(msg);
 
 	diag_log_top_view(jp, "top.values", "$.top.values", out, out_alloc, out_offset);
+	diag_log_top_view(jp, "top.time_ms", "$.top.time_ms", out, out_alloc, out_offset);
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
@@ -19,10 +19,47 @@
 #include "zbxipcservice.h"
 #include "zbx_rtc_constants.h"
 #include "zbxserialize.h"
+#include "zbxshmem.h"
+#include "zbxmutexs.h"
 
 static int				escalators_number;
 static zbx_rtc_notify_generic_cb_t	rtc_notify_generic_cb;
 
+/* escalation shard states */
+#define ZBX_ESCALATION_SHARD_IDLE	0	/* shard was processed and waits to be queued again */
+#define ZBX_ESCALATION_SHARD_QUEUED	1	/* shard is waiting to be processed by any escalator */
+#define ZBX_ESCALATION_SHARD_BUSY	2	/* shard is being processed by an escalator */
+
+typedef struct
+{
+	unsigned char	state;
+	int		queued;		/* time when shard was last queued */
+}
+zbx_escalation_shard_t;
+
+static int				escalation_shards_num;
+static int				escalation_shards_batch;
+static zbx_mutex_t			escalation_shards_lock = ZBX_MUTEX_NULL;
+static zbx_shmem_info_t			*escalation_shards_mem;
+static zbx_escalation_shard_t		*escalation_shards;	/* shards of all escalation queues */
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns escalator process number the object escalations are       *
+ *          assigned to                                                       *
+ *                                                                            *
+ * Comments: With shards the object is assigned to the home escalator of its  *
+ *           shard, so notifications wake the escalator that queues it.       *
+ *                                                                            *
+ ******************************************************************************/
+static int	escalation_home_escalator(zbx_uint64_t objectid)
+{
+	if (0 != escalation_shards_num)
+		return (int)(objectid % (uint64_t)escalation_shards_num) % escalators_number + 1;
+
+	return (int)(objectid % (uint64_t)escalators_number + 1);
+}
+
 void	zbx_init_escalations(int escalators_num, zbx_rtc_notify_generic_cb_t rtc_notify_generic_func)
 {
 	escalators_number = escalators_num;
@@ -47,7 +84,7 @@ void	zbx_start_escalations(zbx_ipc_async_socket_t *rtc, zbx_vector_escalation_ne
 		{
 			int	escalator_process_num;
 
-			escalator_process_num = (int)(escalation->event->objectid % (uint64_t)escalators_number + 1);
+			escalator_process_num = escalation_home_escalator(escalation->event->objectid);
 			zbx_vector_uint64_append(&escalator_escalationids[escalator_process_num - 1],
 					escalation->escalationid);
 		}
@@ -85,3 +122,186 @@ void	zbx_escalation_new_ptr_free(zbx_escalation_new_t *escalation)
 
 	zbx_free(escalation);
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initializes shared escalation shard table for dynamic work        *
+ *          distribution between escalators                                   *
+ *                                                                            *
+ * Parameters: shards_num - [IN] number of shards per escalation queue,       *
+ *                               0 - escalations are statically distributed   *
+ *             batch      - [IN] number of shards claimed at once             *
+ *             error      - [OUT]                                             *
+ *                                                                            *
+ * Return value: SUCCEED - shard table was initialized or is not used         *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Escalations are mapped to shards by their trigger, item, service *
+ *           or escalation identifier, so escalations of the same object are  *
+ *           always processed by a single escalator at a time and in order.   *
+ *           Shard i is home shard of escalator i % StartEscalators + 1, it   *
+ *           is queued by its home escalator or, when overdue, by any other   *
+ *           escalator and can be claimed by any escalator that has processed *
+ *           its own queued shards.                                           *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_init_escalation_shards(int shards_num, int batch, char **error)
+{
+	size_t	size;
+
+	if (0 == shards_num || 0 == escalators_number)
+		return SUCCEED;
+
+	size = (size_t)shards_num * ZBX_ESCALATION_QUEUES_NUM * sizeof(zbx_escalation_shard_t);
+
+	if (SUCCEED != zbx_mutex_create(&escalation_shards_lock, ZBX_MUTEX_ESCALATION_SHARDS, error))
+		return FAIL;
+
+	if (SUCCEED != zbx_shmem_create_min(&escalation_shards_mem, size, "escalation shards", NULL, 0, error))
+		return FAIL;
+
+	escalation_shards = (zbx_escalation_shard_t *)zbx_shmem_malloc(escalation_shards_mem, NULL, size);
+	memset(escalation_shards, 0, size);
+
+	escalation_shards_num = shards_num;
+	escalation_shards_batch = batch;
+
+	return SUCCEED;
+}
+
+void	zbx_deinit_escalation_shards(void)
+{
+	if (NULL == escalation_shards_mem)
+		return;
+
+	zbx_shmem_destroy(escalation_shards_mem);
+	escalation_shards_mem = NULL;
+	escalation_shards = NULL;
+	escalation_shards_num = 0;
+
+	zbx_mutex_destroy(&escalation_shards_lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns number of shards per escalation queue, 0 if escalations   *
+ *          are statically distributed between escalators                     *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_escalation_shards_num(void)
+{
+	return escalation_shards_num;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: queues home shards of escalator and overdue shards of other       *
+ *          escalators in all escalation queues                               *
+ *                                                                            *
+ * Parameters: process_num - [IN] escalator process number                    *
+ *             now         - [IN] current time                                *
+ *             delay       - [IN] time after which shard of other escalator   *
+ *                                is overdue since it was last queued         *
+ *                                                                            *
+ * Comments: Shards of an escalator busy with a long pass are queued by the   *
+ *           other escalators, so they can be taken over without waiting for  *
+ *           the home escalator to finish its pass.                           *
+ *           Shards being processed are left busy and will be queued in the   *
+ *           next pass.                                                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_escalation_shards_queue(int process_num, int now, int delay)
+{
+	zbx_mutex_lock(escalation_shards_lock);
+
+	for (int queue = 0; queue < ZBX_ESCALATION_QUEUES_NUM; queue++)
+	{
+		zbx_escalation_shard_t	*shards = escalation_shards + queue * escalation_shards_num;
+
+		for (int i = 0; i < escalation_shards_num; i++)
+		{
+			if (ZBX_ESCALATION_SHARD_IDLE != shards[i].state)
+				continue;
+
+			if (process_num - 1 != i % escalators_number && now - shards[i].queued < delay)
+				continue;
+
+			shards[i].state = ZBX_ESCALATION_SHARD_QUEUED;
+			shards[i].queued = now;
+		}
+	}
+
+	zbx_mutex_unlock(escalation_shards_lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: claims next batch of queued shards for processing                 *
+ *                                                                            *
+ * Parameters: queue       - [IN] escalation queue                            *
+ *             process_num - [IN] escalator process number                    *
+ *             shardids    - [OUT] claimed shards                             *
+ *                                                                            *
+ * Return value: number of claimed shards                                     *
+ *                                                                            *
+ * Comments: Home shards of the escalator are claimed first, then queued      *
+ *           shards of other escalators are taken over starting with the      *
+ *           next escalator to spread stealing evenly.                        *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_escalation_shards_claim(int queue, int process_num, zbx_vector_int32_t *shardids)
+{
+	zbx_escalation_shard_t	*shards = escalation_shards + queue * escalation_shards_num;
+
+	zbx_vector_int32_clear(shardids);
+
+	zbx_mutex_lock(escalation_shards_lock);
+
+	for (int i = process_num - 1; i < escalation_shards_num && shardids->values_num < escalation_shards_batch;
+			i += escalators_number)
+	{
+		if (ZBX_ESCALATION_SHARD_QUEUED == shards[i].state)
+		{
+			shards[i].state = ZBX_ESCALATION_SHARD_BUSY;
+			zbx_vector_int32_append(shardids, i);
+		}
+	}
+
+	if (0 == shardids->values_num)
+	{
+		for (int j = 0; j < escalation_shards_num && shardids->values_num < escalation_shards_batch; j++)
+		{
+			int	i = (process_num + j) % escalation_shards_num;
+
+			if (ZBX_ESCALATION_SHARD_QUEUED == shards[i].state)
+			{
+				shards[i].state = ZBX_ESCALATION_SHARD_BUSY;
+				zbx_vector_int32_append(shardids, i);
+			}
+		}
+	}
+
+	zbx_mutex_unlock(escalation_shards_lock);
+
+	return shardids->values_num;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: releases processed shards                                         *
+ *                                                                            *
+ * Parameters: queue    - [IN] escalation queue                               *
+ *             shardids - [IN] shards claimed by zbx_escalation_shards_claim()*
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_escalation_shards_release(int queue, const zbx_vector_int32_t *shardids)
+{
+	zbx_escalation_shard_t	*shards = escalation_shards + queue * escalation_shards_num;
+
+	zbx_mutex_lock(escalation_shards_lock);
+
+	for (int i = 0; i < shardids->values_num; i++)
+		shards[shardids->values[i]].state = ZBX_ESCALATION_SHARD_IDLE;
+
+	zbx_mutex_unlock(escalation_shards_lock);
+}
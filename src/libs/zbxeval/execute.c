@@ -2938,6 +2938,150 @@ static int	eval_execute_function_xmlxpath(const zbx_eval_context_t *ctx, const z
 #endif
 }
 
+typedef enum
+{
+	EVAL_FUNCTION_GENERIC = 0,
+	EVAL_FUNCTION_BITWISE,
+	EVAL_FUNCTION_TRIM,
+	EVAL_FUNCTION_MATH_SINGLE,
+	EVAL_FUNCTION_MATH_DOUBLE,
+	EVAL_FUNCTION_MATH_VALUE,
+	EVAL_FUNCTION_STATISTICAL
+}
+zbx_eval_function_type_t;
+
+typedef int	(*zbx_eval_function_exec_t)(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
+		zbx_vector_var_t *output, char **error);
+
+typedef struct
+{
+	const char			*name;
+	zbx_eval_function_type_t	type;
+	union
+	{
+		zbx_eval_function_exec_t	exec;
+		int				optype;
+		double				(*math_single)(double);
+		double				(*math_double)(double, double);
+		double				value;
+		zbx_statistical_func_t		stat;
+	}
+	func;
+}
+zbx_eval_function_t;
+
+/* common functions sorted by name for binary search */
+static const zbx_eval_function_t	eval_functions[] = {
+	{"abs", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_abs}},
+	{"acos", EVAL_FUNCTION_MATH_SINGLE, {.math_single = acos}},
+	{"ascii", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_ascii}},
+	{"asin", EVAL_FUNCTION_MATH_SINGLE, {.math_single = asin}},
+	{"atan", EVAL_FUNCTION_MATH_SINGLE, {.math_single = atan}},
+	{"atan2", EVAL_FUNCTION_MATH_DOUBLE, {.math_double = atan2}},
+	{"avg", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_avg}},
+	{"between", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_between}},
+	{"bitand", EVAL_FUNCTION_BITWISE, {.optype = FUNCTION_OPTYPE_BIT_AND}},
+	{"bitlength", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_bitlength}},
+	{"bitlshift", EVAL_FUNCTION_BITWISE, {.optype = FUNCTION_OPTYPE_BIT_LSHIFT}},
+	{"bitnot", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_bitnot}},
+	{"bitor", EVAL_FUNCTION_BITWISE, {.optype = FUNCTION_OPTYPE_BIT_OR}},
+	{"bitrshift", EVAL_FUNCTION_BITWISE, {.optype = FUNCTION_OPTYPE_BIT_RSHIFT}},
+	{"bitxor", EVAL_FUNCTION_BITWISE, {.optype = FUNCTION_OPTYPE_BIT_XOR}},
+	{"bytelength", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_bytelength}},
+	{"cbrt", EVAL_FUNCTION_MATH_SINGLE, {.math_single = cbrt}},
+	{"ceil", EVAL_FUNCTION_MATH_SINGLE, {.math_single = ceil}},
+	{"char", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_char}},
+	{"concat", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_concat}},
+	{"cos", EVAL_FUNCTION_MATH_SINGLE, {.math_single = cos}},
+	{"cosh", EVAL_FUNCTION_MATH_SINGLE, {.math_single = cosh}},
+	{"cot", EVAL_FUNCTION_MATH_SINGLE, {.math_single = eval_math_func_cot}},
+	{"count", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_count}},
+	{"date", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_date}},
+	{"dayofmonth", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_dayofmonth}},
+	{"dayofweek", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_dayofweek}},
+	{"degrees", EVAL_FUNCTION_MATH_SINGLE, {.math_single = eval_math_func_degrees}},
+	{"e", EVAL_FUNCTION_MATH_VALUE, {.value = ZBX_MATH_CONST_E}},
+	{"exp", EVAL_FUNCTION_MATH_SINGLE, {.math_single = exp}},
+	{"expm1", EVAL_FUNCTION_MATH_SINGLE, {.math_single = expm1}},
+	{"floor", EVAL_FUNCTION_MATH_SINGLE, {.math_single = floor}},
+	{"histogram_quantile", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_histogram_quantile}},
+	{"in", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_in}},
+	{"insert", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_insert}},
+	{"jsonpath", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_jsonpath}},
+	{"kurtosis", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_kurtosis}},
+	{"left", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_left}},
+	{"length", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_length}},
+	{"log", EVAL_FUNCTION_MATH_SINGLE, {.math_single = log}},
+	{"log10", EVAL_FUNCTION_MATH_SINGLE, {.math_single = log10}},
+	{"ltrim", EVAL_FUNCTION_TRIM, {.optype = FUNCTION_OPTYPE_TRIM_LEFT}},
+	{"mad", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_mad}},
+	{"max", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_max}},
+	{"mid", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_mid}},
+	{"min", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_min}},
+	{"mod", EVAL_FUNCTION_MATH_DOUBLE, {.math_double = fmod}},
+	{"now", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_now}},
+	{"pi", EVAL_FUNCTION_MATH_VALUE, {.value = ZBX_MATH_CONST_PI}},
+	{"power", EVAL_FUNCTION_MATH_DOUBLE, {.math_double = pow}},
+	{"radians", EVAL_FUNCTION_MATH_SINGLE, {.math_single = eval_math_func_radians}},
+	{"rand", EVAL_FUNCTION_MATH_VALUE, {.value = ZBX_MATH_RANDOM}},
+	{"repeat", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_repeat}},
+	{"replace", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_replace}},
+	{"right", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_right}},
+	{"round", EVAL_FUNCTION_MATH_DOUBLE, {.math_double = eval_math_func_round}},
+	{"rtrim", EVAL_FUNCTION_TRIM, {.optype = FUNCTION_OPTYPE_TRIM_RIGHT}},
+	{"signum", EVAL_FUNCTION_MATH_SINGLE, {.math_single = eval_math_func_signum}},
+	{"sin", EVAL_FUNCTION_MATH_SINGLE, {.math_single = sin}},
+	{"sinh", EVAL_FUNCTION_MATH_SINGLE, {.math_single = sinh}},
+	{"skewness", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_skewness}},
+	{"sqrt", EVAL_FUNCTION_MATH_SINGLE, {.math_single = sqrt}},
+	{"stddevpop", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_stddevpop}},
+	{"stddevsamp", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_stddevsamp}},
+	{"sum", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_sum}},
+	{"sumofsquares", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_sumofsquares}},
+	{"tan", EVAL_FUNCTION_MATH_SINGLE, {.math_single = tan}},
+	{"time", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_time}},
+	{"trim", EVAL_FUNCTION_TRIM, {.optype = FUNCTION_OPTYPE_TRIM_ALL}},
+	{"truncate", EVAL_FUNCTION_MATH_DOUBLE, {.math_double = eval_math_func_truncate}},
+	{"varpop", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_varpop}},
+	{"varsamp", EVAL_FUNCTION_STATISTICAL, {.stat = zbx_eval_calc_varsamp}},
+	{"xmlxpath", EVAL_FUNCTION_GENERIC, {.exec = eval_execute_function_xmlxpath}},
+};
+
+static int	eval_function_compare(const void *d1, const void *d2)
+{
+	const char			*name = (const char *)d1;
+	const zbx_eval_function_t	*function = (const zbx_eval_function_t *)d2;
+
+	return strcmp(name, function->name);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds common function by name of function token                   *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             token - [IN] function token                                    *
+ *                                                                            *
+ * Return value: function or NULL if function token is not a builtin common   *
+ *               function                                                     *
+ *                                                                            *
+ ******************************************************************************/
+static const zbx_eval_function_t	*eval_function_find(const zbx_eval_context_t *ctx,
+		const zbx_eval_token_t *token)
+{
+	char	name[32];
+	size_t	len = token->loc.r - token->loc.l + 1;
+
+	if (sizeof(name) <= len)
+		return NULL;
+
+	memcpy(name, ctx->expression + token->loc.l, len);
+	name[len] = '\0';
+
+	return (const zbx_eval_function_t *)bsearch(name, eval_functions, ARRSIZE(eval_functions),
+			sizeof(zbx_eval_function_t), eval_function_compare);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluates common function                                         *
@@ -2954,6 +3098,8 @@ static int	eval_execute_function_xmlxpath(const zbx_eval_context_t *ctx, const z
 static int	eval_execute_common_function(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
 		zbx_vector_var_t *output, char **error)
 {
+	const zbx_eval_function_t	*function;
+
 	if ((zbx_uint32_t)output->values_num < token->opt)
 	{
 		*error = zbx_dsprintf(*error, "not enough arguments for function at \"%s\"",
@@ -2961,155 +3107,31 @@ static int	eval_execute_common_function(const zbx_eval_context_t *ctx, const zbx
 		return FAIL;
 	}
 
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "min", ZBX_CONST_STRLEN("min")))
-		return eval_execute_function_min(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "max", ZBX_CONST_STRLEN("max")))
-		return eval_execute_function_max(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sum", ZBX_CONST_STRLEN("sum")))
-		return eval_execute_function_sum(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "avg", ZBX_CONST_STRLEN("avg")))
-		return eval_execute_function_avg(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "abs", ZBX_CONST_STRLEN("abs")))
-		return eval_execute_function_abs(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "length", ZBX_CONST_STRLEN("length")))
-		return eval_execute_function_length(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "date", ZBX_CONST_STRLEN("date")))
-		return eval_execute_function_date(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "time", ZBX_CONST_STRLEN("time")))
-		return eval_execute_function_time(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "now", ZBX_CONST_STRLEN("now")))
-		return eval_execute_function_now(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "dayofweek", ZBX_CONST_STRLEN("dayofweek")))
-		return eval_execute_function_dayofweek(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "dayofmonth", ZBX_CONST_STRLEN("dayofmonth")))
-		return eval_execute_function_dayofmonth(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitand", ZBX_CONST_STRLEN("bitand")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_AND, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitor", ZBX_CONST_STRLEN("bitor")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_OR, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitxor", ZBX_CONST_STRLEN("bitxor")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_XOR, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitlshift", ZBX_CONST_STRLEN("bitlshift")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_LSHIFT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitrshift", ZBX_CONST_STRLEN("bitrshift")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_RSHIFT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitnot", ZBX_CONST_STRLEN("bitnot")))
-		return eval_execute_function_bitnot(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "between", ZBX_CONST_STRLEN("between")))
-		return eval_execute_function_between(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "in", ZBX_CONST_STRLEN("in")))
-		return eval_execute_function_in(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "ascii", ZBX_CONST_STRLEN("ascii")))
-		return eval_execute_function_ascii(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "char", ZBX_CONST_STRLEN("char")))
-		return eval_execute_function_char(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "left", ZBX_CONST_STRLEN("left")))
-		return eval_execute_function_left(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "right", ZBX_CONST_STRLEN("right")))
-		return eval_execute_function_right(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "mid", ZBX_CONST_STRLEN("mid")))
-		return eval_execute_function_mid(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitlength", ZBX_CONST_STRLEN("bitlength")))
-		return eval_execute_function_bitlength(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bytelength", ZBX_CONST_STRLEN("bytelength")))
-		return eval_execute_function_bytelength(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "concat", ZBX_CONST_STRLEN("concat")))
-		return eval_execute_function_concat(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "insert", ZBX_CONST_STRLEN("insert")))
-		return eval_execute_function_insert(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "replace", ZBX_CONST_STRLEN("replace")))
-		return eval_execute_function_replace(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "repeat", ZBX_CONST_STRLEN("repeat")))
-		return eval_execute_function_repeat(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "ltrim", ZBX_CONST_STRLEN("ltrim")))
-		return eval_execute_function_trim(ctx, token, FUNCTION_OPTYPE_TRIM_LEFT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "rtrim", ZBX_CONST_STRLEN("rtrim")))
-		return eval_execute_function_trim(ctx, token, FUNCTION_OPTYPE_TRIM_RIGHT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "trim", ZBX_CONST_STRLEN("trim")))
-		return eval_execute_function_trim(ctx, token, FUNCTION_OPTYPE_TRIM_ALL, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cbrt", ZBX_CONST_STRLEN("cbrt")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, cbrt);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "ceil", ZBX_CONST_STRLEN("ceil")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, ceil);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "exp", ZBX_CONST_STRLEN("exp")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, exp);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "expm1", ZBX_CONST_STRLEN("expm1")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, expm1);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "floor", ZBX_CONST_STRLEN("floor")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, floor);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "signum", ZBX_CONST_STRLEN("signum")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_signum);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "degrees", ZBX_CONST_STRLEN("degrees")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_degrees);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "radians", ZBX_CONST_STRLEN("radians")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_radians);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "acos", ZBX_CONST_STRLEN("acos")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, acos);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "asin", ZBX_CONST_STRLEN("asin")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, asin);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "atan", ZBX_CONST_STRLEN("atan")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, atan);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cos", ZBX_CONST_STRLEN("cos")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, cos);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cosh", ZBX_CONST_STRLEN("cosh")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, cosh);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cot", ZBX_CONST_STRLEN("cot")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_cot);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sin", ZBX_CONST_STRLEN("sin")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, sin);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sinh", ZBX_CONST_STRLEN("sinh")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, sinh);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "tan", ZBX_CONST_STRLEN("tan")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, tan);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "log", ZBX_CONST_STRLEN("log")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, log);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "log10", ZBX_CONST_STRLEN("log10")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, log10);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sqrt", ZBX_CONST_STRLEN("sqrt")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, sqrt);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "power", ZBX_CONST_STRLEN("power")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, pow);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "round", ZBX_CONST_STRLEN("round")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, eval_math_func_round);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "mod", ZBX_CONST_STRLEN("mod")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, fmod);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "truncate", ZBX_CONST_STRLEN("truncate")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, eval_math_func_truncate);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "atan2", ZBX_CONST_STRLEN("atan2")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, atan2);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "pi", ZBX_CONST_STRLEN("pi")))
-		return eval_execute_math_return_value(ctx, token, output, error, ZBX_MATH_CONST_PI);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "e", ZBX_CONST_STRLEN("e")))
-		return eval_execute_math_return_value(ctx, token, output, error, ZBX_MATH_CONST_E);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "rand", ZBX_CONST_STRLEN("rand")))
-		return eval_execute_math_return_value(ctx, token, output, error, ZBX_MATH_RANDOM);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "kurtosis", ZBX_CONST_STRLEN("kurtosis")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_kurtosis, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "mad", ZBX_CONST_STRLEN("mad")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_mad, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "skewness", ZBX_CONST_STRLEN("skewness")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_skewness, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "stddevpop", ZBX_CONST_STRLEN("stddevpop")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_stddevpop, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "stddevsamp", ZBX_CONST_STRLEN("stddevsamp")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_stddevsamp, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sumofsquares", ZBX_CONST_STRLEN("sumofsquares")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_sumofsquares, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "varpop", ZBX_CONST_STRLEN("varpop")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_varpop, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "varsamp", ZBX_CONST_STRLEN("varsamp")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_varsamp, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "count", ZBX_CONST_STRLEN("count")))
-		return eval_execute_function_count(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "histogram_quantile",
-			ZBX_CONST_STRLEN("histogram_quantile")))
-	{
-		return eval_execute_function_histogram_quantile(ctx, token, output, error);
-	}
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "jsonpath", ZBX_CONST_STRLEN("jsonpath")))
-		return eval_execute_function_jsonpath(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "xmlxpath", ZBX_CONST_STRLEN("xmlxpath")))
-		return eval_execute_function_xmlxpath(ctx, token, output, error);
+	if (NULL != (function = eval_function_find(ctx, token)))
+	{
+		switch (function->type)
+		{
+			case EVAL_FUNCTION_GENERIC:
+				return function->func.exec(ctx, token, output, error);
+			case EVAL_FUNCTION_BITWISE:
+				return eval_execute_function_bitwise(ctx, token,
+						(zbx_function_bit_optype_t)function->func.optype, output, error);
+			case EVAL_FUNCTION_TRIM:
+				return eval_execute_function_trim(ctx, token,
+						(zbx_function_trim_optype_t)function->func.optype, output, error);
+			case EVAL_FUNCTION_MATH_SINGLE:
+				return eval_execute_math_function_single_param(ctx, token, output, error,
+						function->func.math_single);
+			case EVAL_FUNCTION_MATH_DOUBLE:
+				return eval_execute_math_function_double_param(ctx, token, output, error,
+						function->func.math_double);
+			case EVAL_FUNCTION_MATH_VALUE:
+				return eval_execute_math_return_value(ctx, token, output, error, function->func.value);
+			case EVAL_FUNCTION_STATISTICAL:
+				return eval_execute_statistical_function(ctx, token, function->func.stat, output,
+						error);
+		}
+	}
 
 	if (NULL != ctx->eval_function_common_cb)
 		return eval_execute_cb_function(ctx, token, ctx->eval_function_common_cb, output, error);
@@ -3200,6 +3222,8 @@ static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, cha
 	char			*errmsg = NULL;
 
 	zbx_vector_var_create(&output);
+	/* output stack cannot grow larger than the number of tokens */
+	zbx_vector_var_reserve(&output, (size_t)ctx->stack.values_num);
 
 	for (i = 0; i < ctx->stack.values_num; i++)
 	{
@@ -3375,3 +3399,162 @@ int	zbx_eval_execute_ext(zbx_eval_context_t *ctx, const zbx_timespec_t *ts,
 
 	return eval_execute(ctx, value, error);
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: extends location of folded operator over parentheses              *
+ *          enclosing its operands                                            *
+ *                                                                            *
+ * Parameters: expression - [IN] expression                                   *
+ *             loc        - [IN/OUT] location of folded operator              *
+ *                                                                            *
+ ******************************************************************************/
+static void	eval_fold_extend_loc(const char *expression, zbx_strloc_t *loc)
+{
+	int	open = 0, close = 0;
+
+	for (size_t i = loc->l; i <= loc->r; i++)
+	{
+		if ('(' == expression[i])
+			open++;
+		else if (')' == expression[i])
+		{
+			if (0 < open)
+				open--;
+			else
+				close++;
+		}
+	}
+
+	for (; 0 < close; loc->l--)
+	{
+		if ('(' == expression[loc->l - 1])
+			close--;
+	}
+
+	for (; 0 < open; loc->r++)
+	{
+		if (')' == expression[loc->r + 1])
+			open--;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates operator with constant numeric operands                 *
+ *                                                                            *
+ * Parameters: ctx          - [IN] evaluation context                         *
+ *             operands     - [IN/OUT] operand tokens, replaced by the result *
+ *                                     in the first token on success          *
+ *             operands_num - [IN] number of operands                         *
+ *             token        - [IN] operator token                             *
+ *                                                                            *
+ * Return value: SUCCEED - operator was folded                                *
+ *               FAIL    - operator cannot be evaluated beforehand            *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_fold_operator(const zbx_eval_context_t *ctx, zbx_eval_token_t *operands, int operands_num,
+		const zbx_eval_token_t *token)
+{
+	zbx_vector_var_t	output;
+	char			*error = NULL;
+	int			i, ret;
+
+	for (i = 0; i < operands_num; i++)
+	{
+		const zbx_eval_token_t	*operand = &operands[i];
+
+		if (ZBX_EVAL_TOKEN_VAR_NUM != operand->type)
+			return FAIL;
+
+		/* numbers can be compound with macros, e.g. {$SIZE}K */
+		if (ZBX_VARIANT_NONE == operand->value.type && NULL != memchr(ctx->expression + operand->loc.l, '{',
+				operand->loc.r - operand->loc.l + 1))
+		{
+			return FAIL;
+		}
+
+		/* otherwise numbers have values only if they were folded */
+		if (ZBX_VARIANT_NONE != operand->value.type && ZBX_VARIANT_DBL != operand->value.type)
+			return FAIL;
+	}
+
+	zbx_vector_var_create(&output);
+
+	for (i = 0; i < operands_num; i++)
+		eval_execute_push_value(ctx, &operands[i], &output, &error);
+
+	if (1 == operands_num)
+		ret = eval_execute_op_unary(ctx, token, &output, &error);
+	else
+		ret = eval_execute_op_binary(ctx, token, &output, &error);
+
+	/* errors like division by zero are left to be reported at execution time */
+	if (SUCCEED == ret)
+	{
+		operands[0].loc.r = operands[operands_num - 1].loc.r;
+
+		if (operands[0].loc.l > token->loc.l)
+			operands[0].loc.l = token->loc.l;
+
+		if (operands[0].loc.r < token->loc.r)
+			operands[0].loc.r = token->loc.r;
+
+		eval_fold_extend_loc(ctx->expression, &operands[0].loc);
+
+		operands[0].value = output.values[0];
+		output.values_num = 0;
+	}
+
+	for (i = 0; i < output.values_num; i++)
+		zbx_variant_clear(&output.values[i]);
+
+	zbx_vector_var_destroy(&output);
+	zbx_free(error);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: replaces operators having only constant numeric operands with     *
+ *          their results                                                     *
+ *                                                                            *
+ * Parameters: ctx - [IN/OUT] parsed expression                               *
+ *                                                                            *
+ * Comments: Folded numbers get their values set while their location spans   *
+ *           the whole folded subexpression, so that composing expression     *
+ *           with cleared values restores the original text.                  *
+ *           Expressions are folded when cached, before serialization, so     *
+ *           constant parts are not recalculated by each evaluation.          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_eval_fold_constants(zbx_eval_context_t *ctx)
+{
+	int	i, num = 0;
+
+	for (i = 0; i < ctx->stack.values_num; i++)
+	{
+		zbx_eval_token_t	*token = &ctx->stack.values[i];
+		int			operands_num;
+
+		if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR1))
+			operands_num = 1;
+		else if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR2))
+			operands_num = 2;
+		else
+			operands_num = 0;
+
+		if (0 != operands_num && operands_num <= num && SUCCEED == eval_fold_operator(ctx,
+				&ctx->stack.values[num - operands_num], operands_num, token))
+		{
+			num -= operands_num - 1;
+			zbx_variant_clear(&token->value);
+			continue;
+		}
+
+		ctx->stack.values[num++] = *token;
+	}
+
+	ctx->stack.values_num = num;
+}
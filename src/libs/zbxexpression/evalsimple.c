@@ -26,7 +26,8 @@
  *                                                                            *
  * Global variables are used for efficiency reasons so that arguments do not  *
  * have to be passed to each of evaluate_termX() functions. For this reason,  *
- * too, this module is isolated into a separate file.                         *
+ * too, this module is isolated into a separate file. The variables are       *
+ * thread local, so expressions can be evaluated by several threads.          *
  *                                                                            *
  * The priority of supported operators is as follows:                         *
  *                                                                            *
@@ -44,11 +45,11 @@
  *                                                                            *
  ******************************************************************************/
 
-static const char	*ptr;		/* character being looked at */
-static int		level;		/* expression nesting level  */
+static ZBX_THREAD_LOCAL const char	*ptr;		/* character being looked at */
+static ZBX_THREAD_LOCAL int		level;		/* expression nesting level  */
 
-static char		*buffer;	/* error message buffer      */
-static size_t		max_buffer_len;	/* error message buffer size */
+static ZBX_THREAD_LOCAL char		*buffer;	/* error message buffer      */
+static ZBX_THREAD_LOCAL size_t		max_buffer_len;	/* error message buffer size */
 
 /******************************************************************************
  *                                                                            *
@@ -165,7 +165,7 @@ static int	sql_writer_flush(void)
 		for (i = 0; i < writer.dbinserts.values_num; i++)
 		{
 			zbx_db_insert_t	*db_insert = (zbx_db_insert_t *)writer.dbinserts.values[i];
-			zbx_db_insert_execute(db_insert);
+			zbx_db_insert_execute_copy(db_insert);
 		}
 	}
 	while (ZBX_DB_DOWN == (txn_error = zbx_db_commit()));
@@ -20,6 +20,11 @@
 
 #include "zbxnum.h"
 
+#if defined(__SSE2__) && defined(__GNUC__) && !defined(__SANITIZE_ADDRESS__) && !defined(ZBX_JSON_SCAN_SCALAR)
+#	include <emmintrin.h>
+#	define ZBX_JSON_SCAN_SSE2
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: return string describing json error                               *
@@ -583,6 +588,46 @@ static zbx_json_type_t	__zbx_json_type(const char *p)
 	return ZBX_JSON_TYPE_UNKNOWN;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: skip string characters that do not need special handling          *
+ *                                                                            *
+ * Parameters: p - [IN] pointer inside json string                            *
+ *                                                                            *
+ * Return value: pointer to the first quote, backslash or control character   *
+ *               (including terminating zero)                                 *
+ *                                                                            *
+ * Comments: With SSE2 the data is scanned in aligned 16 byte blocks. Aligned *
+ *           loads never cross page boundary, so reading past the             *
+ *           terminating zero inside the last block is safe.                  *
+ *                                                                            *
+ ******************************************************************************/
+const char	*json_skip_string_chars(const char *p)
+{
+#ifdef ZBX_JSON_SCAN_SSE2
+	const __m128i	quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), control = _mm_set1_epi8(0x1f);
+	const char	*block = (const char *)((uintptr_t)p & ~(uintptr_t)15);
+	unsigned int	mask;
+
+	for (mask = ~0u << (p - block);; block += 16, mask = ~0u)
+	{
+		__m128i	data = _mm_load_si128((const __m128i *)block);
+
+		mask &= (unsigned int)_mm_movemask_epi8(_mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(data, quote), _mm_cmpeq_epi8(data, backslash)),
+				_mm_cmpeq_epi8(_mm_min_epu8(data, control), data)));
+
+		if (0 != mask)
+			return block + __builtin_ctz(mask);
+	}
+#else
+	while ('"' != *p && '\\' != *p && 0x1f < (unsigned char)*p)
+		p++;
+
+	return p;
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Return value: position of the right bracket                                *
@@ -632,6 +677,9 @@ static const char	*__zbx_json_rbracket(const char *p)
 				break;
 		}
 		p++;
+
+		if (1 == state)
+			p = json_skip_string_chars(p);
 	}
 
 	return NULL;
@@ -739,6 +787,9 @@ const char	*zbx_json_next(const struct zbx_json_parse *jp, const char *p)
 				break;
 		}
 		p++;
+
+		if (1 == state)
+			p = json_skip_string_chars(p);
 	}
 
 	return NULL;
@@ -924,7 +975,9 @@ unsigned int	zbx_json_decode_character(const char **p, unsigned char *bytes)
  ******************************************************************************/
 const char	*json_copy_string(const char *p, char *out, size_t size)
 {
-	char	*start = out;
+	char		*start = out;
+	const char	*next;
+	size_t		len;
 
 	if (0 == size)
 		return NULL;
@@ -954,7 +1007,14 @@ const char	*json_copy_string(const char *p, char *out, size_t size)
 				*out = '\0';
 				return ++p;
 			default:
-				*out++ = *p++;
+				/* copy characters up to the next quote, escape sequence or control character */
+				if (p == (next = json_skip_string_chars(p)))
+					next++;
+
+				len = MIN((size_t)(next - p), size - (size_t)(out - start));
+				memcpy(out, p, len);
+				out += len;
+				p += len;
 		}
 
 		if ((size_t)(out - start) == size)
@@ -1093,11 +1153,42 @@ const char	*zbx_json_pair_next(const struct zbx_json_parse *jp, const char *p, c
 const char	*zbx_json_pair_by_name(const struct zbx_json_parse *jp, const char *name)
 {
 	char		buffer[MAX_STRING_LEN];
-	const char	*p = NULL;
+	const char	*p = NULL, *end;
+	size_t		name_len = strlen(name);
+	int		match;
+
+	while (NULL != (p = zbx_json_next(jp, p)))
+	{
+		if ('"' != *p)
+			break;
+
+		/* names without escape sequences are compared in place */
+		if ('"' == *(end = json_skip_string_chars(p + 1)))
+		{
+			if ((size_t)(end - p - 1) >= sizeof(buffer))
+				break;
+
+			match = (name_len == (size_t)(end - p - 1) && 0 == memcmp(p + 1, name, name_len));
+			p = end + 1;
+		}
+		else
+		{
+			if (NULL == (p = json_copy_string(p, buffer, sizeof(buffer))))
+				break;
+
+			match = (0 == strcmp(name, buffer));
+		}
+
+		SKIP_WHITESPACE(p);
 
-	while (NULL != (p = zbx_json_pair_next(jp, p, buffer, sizeof(buffer))))
-		if (0 == strcmp(name, buffer))
+		if (':' != *p++)
+			break;
+
+		SKIP_WHITESPACE(p);
+
+		if (0 != match)
 			return p;
+	}
 
 	zbx_set_json_strerror("cannot find pair with name \"%s\"", name);
 
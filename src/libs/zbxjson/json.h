@@ -28,6 +28,7 @@
 void	zbx_set_json_strerror(const char *fmt, ...) __zbx_attr_format_printf(1, 2);
 
 const char	*json_copy_string(const char *p, char *out, size_t size);
+const char	*json_skip_string_chars(const char *p);
 unsigned int	zbx_json_decode_character(const char **p, unsigned char *bytes);
 
 #endif
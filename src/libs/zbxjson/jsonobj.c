@@ -195,6 +195,43 @@ void	zbx_jsonobj_init(zbx_jsonobj_t *obj)
 	obj->type = ZBX_JSON_TYPE_UNKNOWN;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get memory allocated for json object contents                     *
+ *                                                                            *
+ * Return value: The allocated memory size, excluding the object itself.      *
+ *                                                                            *
+ ******************************************************************************/
+size_t	zbx_jsonobj_get_size(const zbx_jsonobj_t *obj)
+{
+	size_t				size;
+	zbx_hashset_const_iter_t	iter;
+	const zbx_jsonobj_el_t		*el;
+
+	switch (obj->type)
+	{
+		case ZBX_JSON_TYPE_STRING:
+			return strlen(obj->data.string) + 1;
+		case ZBX_JSON_TYPE_ARRAY:
+			size = (size_t)obj->data.array.values_alloc * sizeof(zbx_jsonobj_t *);
+
+			for (int i = 0; i < obj->data.array.values_num; i++)
+				size += sizeof(zbx_jsonobj_t) + zbx_jsonobj_get_size(obj->data.array.values[i]);
+
+			return size;
+		case ZBX_JSON_TYPE_OBJECT:
+			size = zbx_hashset_get_size(&obj->data.object, sizeof(zbx_jsonobj_el_t));
+
+			zbx_hashset_const_iter_reset(&obj->data.object, &iter);
+			while (NULL != (el = (const zbx_jsonobj_el_t *)zbx_hashset_const_iter_next(&iter)))
+				size += strlen(el->name) + 1 + zbx_jsonobj_get_size(&el->value);
+
+			return size;
+		default:
+			return 0;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: convert json object to text format                                *
@@ -21,6 +21,7 @@
 #include "zbxnum.h"
 #include "zbxexpr.h"
 #include "jsonobj.h"
+#include "json_parser.h"
 #include "zbxalgo.h"
 #include "zbxstr.h"
 
@@ -2870,30 +2871,30 @@ static void	jsonpath_ctx_clear(zbx_jsonpath_context_t *ctx)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: perform jsonpath query on the specified json object               *
+ * Purpose: perform compiled jsonpath query on the specified json object      *
  *                                                                            *
- * Parameters: obj    - [IN] json object                                      *
- *             index  - [IN] jsonpath index (optional)                        *
- *             path   - [IN] jsonpath                                         *
- *             output - [OUT] output value                                    *
+ * Parameters: obj      - [IN] json object                                    *
+ *             index    - [IN] jsonpath index (optional)                      *
+ *             jsonpath - [IN] compiled jsonpath                              *
+ *             output   - [OUT] output value                                  *
  *                                                                            *
  * Return value: SUCCEED - the query was performed successfully (empty result *
  *                         being counted as successful query)                 *
  *               FAIL    - otherwise                                          *
  *                                                                            *
+ * Comments: The compiled jsonpath is not modified by the query, so it can be *
+ *           reused for multiple queries.                                     *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_jsonobj_query_ext(const zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const char *path, char **output)
+int	zbx_jsonobj_query_compiled(const zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, zbx_jsonpath_t *jsonpath,
+		char **output)
 {
 	zbx_jsonpath_context_t	ctx;
-	zbx_jsonpath_t		jsonpath;
 	int			ret = SUCCEED;
 
-	if (FAIL == zbx_jsonpath_compile(path, &jsonpath))
-		return FAIL;
-
 	ctx.found = 0;
 	ctx.root = obj;
-	ctx.path = &jsonpath;
+	ctx.path = jsonpath;
 	zbx_vector_jsonobj_ref_create(&ctx.objects);
 	ctx.index = index;
 
@@ -2912,15 +2913,15 @@ int	zbx_jsonobj_query_ext(const zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index,
 	if (SUCCEED == ret)
 	{
 		zbx_vector_jsonobj_ref_t	out;
-		int				definite_path = jsonpath.definite, path_depth;
+		int				definite_path = jsonpath->definite, path_depth;
 
 		zbx_vector_jsonobj_ref_create(&out);
 
-		path_depth = jsonpath.segments_num;
-		while (0 < path_depth && ZBX_JSONPATH_SEGMENT_FUNCTION == jsonpath.segments[path_depth - 1].type)
+		path_depth = jsonpath->segments_num;
+		while (0 < path_depth && ZBX_JSONPATH_SEGMENT_FUNCTION == jsonpath->segments[path_depth - 1].type)
 			path_depth--;
 
-		if (path_depth < jsonpath.segments_num)
+		if (path_depth < jsonpath->segments_num)
 		{
 			if (SUCCEED == (ret = jsonpath_apply_functions(&ctx, path_depth, &definite_path, &out)))
 				ret = jsonpath_format_query_result(&out, definite_path, output);
@@ -2933,6 +2934,34 @@ int	zbx_jsonobj_query_ext(const zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index,
 	}
 
 	jsonpath_ctx_clear(&ctx);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: perform jsonpath query on the specified json object               *
+ *                                                                            *
+ * Parameters: obj    - [IN] json object                                      *
+ *             index  - [IN] jsonpath index (optional)                        *
+ *             path   - [IN] jsonpath                                         *
+ *             output - [OUT] output value                                    *
+ *                                                                            *
+ * Return value: SUCCEED - the query was performed successfully (empty result *
+ *                         being counted as successful query)                 *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_jsonobj_query_ext(const zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const char *path, char **output)
+{
+	zbx_jsonpath_t	jsonpath;
+	int		ret;
+
+	if (FAIL == zbx_jsonpath_compile(path, &jsonpath))
+		return FAIL;
+
+	ret = zbx_jsonobj_query_compiled(obj, index, &jsonpath, output);
+
 	zbx_jsonpath_clear(&jsonpath);
 
 	return ret;
@@ -2943,6 +2972,213 @@ int	zbx_jsonobj_query(const zbx_jsonobj_t *obj, const char *path, char **output)
 	return zbx_jsonobj_query_ext(obj, NULL, path, output);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find the value of the named object member in validated json data  *
+ *                                                                            *
+ * Parameters: ptr   - [IN] the object start '{'                              *
+ *             name  - [IN] the member name                                   *
+ *             value - [OUT] the member value or NULL if it was not found     *
+ *                                                                            *
+ * Return value: SUCCEED      - the object was scanned                        *
+ *               NOTSUPPORTED - the object has escaped member names, which    *
+ *                              cannot be compared without decoding           *
+ *                                                                            *
+ * Comments: When member names are duplicated the last member is returned,    *
+ *           the same as when the object is parsed into json object tree.     *
+ *                                                                            *
+ ******************************************************************************/
+static int	jsonpath_data_find_name(const char *ptr, const char *name, const char **value)
+{
+	size_t	name_len = strlen(name);
+
+	*value = NULL;
+
+	ptr++;
+	SKIP_WHITESPACE(ptr);
+
+	while ('"' == *ptr)
+	{
+		const char	*start = ++ptr;
+		int		match;
+
+		for (; '"' != *ptr; ptr++)
+		{
+			if ('\\' == *ptr)
+				return NOTSUPPORTED;
+		}
+
+		match = ((size_t)(ptr - start) == name_len && 0 == memcmp(start, name, name_len));
+
+		ptr++;
+		SKIP_WHITESPACE(ptr);
+		ptr++;
+		SKIP_WHITESPACE(ptr);
+
+		if (0 != match)
+			*value = ptr;
+
+		ptr += json_parse_value(ptr, NULL, 0, NULL);
+		SKIP_WHITESPACE(ptr);
+
+		if (',' != *ptr)
+			break;
+
+		ptr++;
+		SKIP_WHITESPACE(ptr);
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find array element by its index in validated json data            *
+ *                                                                            *
+ * Parameters: ptr   - [IN] the array start '['                               *
+ *             index - [IN] the element index, negative index is counted from *
+ *                          the end of array                                  *
+ *                                                                            *
+ * Return value: The element value or NULL if the index is out of bounds.     *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*jsonpath_data_find_index(const char *ptr, int index)
+{
+	const char	*start;
+	int		i;
+
+	ptr++;
+	SKIP_WHITESPACE(ptr);
+
+	if (']' == *ptr)
+		return NULL;
+
+	start = ptr;
+
+	if (0 > index)
+	{
+		for (i = 1;; i++)
+		{
+			ptr += json_parse_value(ptr, NULL, 0, NULL);
+			SKIP_WHITESPACE(ptr);
+
+			if (',' != *ptr)
+				break;
+
+			ptr++;
+		}
+
+		if (0 > (index += i))
+			return NULL;
+
+		ptr = start;
+	}
+
+	for (i = 0;; i++)
+	{
+		SKIP_WHITESPACE(ptr);
+
+		if (i == index)
+			return ptr;
+
+		ptr += json_parse_value(ptr, NULL, 0, NULL);
+		SKIP_WHITESPACE(ptr);
+
+		if (',' != *ptr)
+			break;
+
+		ptr++;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: perform compiled jsonpath query directly on json formatted data   *
+ *                                                                            *
+ * Parameters: data     - [IN] json data                                      *
+ *             jsonpath - [IN] compiled jsonpath                              *
+ *             output   - [OUT] output value                                  *
+ *                                                                            *
+ * Return value: SUCCEED      - the query was performed successfully (empty   *
+ *                              result being counted as successful query)     *
+ *               FAIL         - internal json error                           *
+ *               NOTSUPPORTED - the query cannot be performed without parsing *
+ *                              data into json object tree                    *
+ *                                                                            *
+ * Comments: Only definite paths consisting of single member names and array  *
+ *           indices are supported. The data is scanned without building json *
+ *           object tree and only the matched value is parsed. Invalid json   *
+ *           data is reported as not supported, so the caller can fall back   *
+ *           to zbx_jsonobj_open() to get the parsing error.                  *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_jsonpath_query_data(const char *data, const zbx_jsonpath_t *jsonpath, char **output)
+{
+	int		i, ret;
+	const char	*ptr = data;
+	zbx_jsonobj_t	obj;
+	size_t		output_alloc = 0, output_offset = 0;
+
+	if (1 != jsonpath->definite || 0 == jsonpath->segments_num)
+		return NOTSUPPORTED;
+
+	for (i = 0; i < jsonpath->segments_num; i++)
+	{
+		const zbx_jsonpath_segment_t	*segment = &jsonpath->segments[i];
+
+		if (ZBX_JSONPATH_SEGMENT_MATCH_LIST != segment->type || 0 != segment->detached ||
+				NULL == segment->data.list.values || NULL != segment->data.list.values->next)
+		{
+			return NOTSUPPORTED;
+		}
+	}
+
+	if (0 == zbx_json_validate(data, NULL))
+		return NOTSUPPORTED;
+
+	SKIP_WHITESPACE(ptr);
+
+	for (i = 0; i < jsonpath->segments_num; i++)
+	{
+		const zbx_jsonpath_list_t	*list = &jsonpath->segments[i].data.list;
+
+		if (ZBX_JSONPATH_LIST_NAME == list->type)
+		{
+			if ('{' != *ptr)
+				return SUCCEED;
+
+			if (NOTSUPPORTED == jsonpath_data_find_name(ptr, list->values->data, &ptr))
+				return NOTSUPPORTED;
+		}
+		else
+		{
+			int	index;
+
+			if ('[' != *ptr)
+				return SUCCEED;
+
+			memcpy(&index, list->values->data, sizeof(index));
+			ptr = jsonpath_data_find_index(ptr, index);
+		}
+
+		if (NULL == ptr)
+			return SUCCEED;
+	}
+
+	jsonobj_init(&obj, ZBX_JSON_TYPE_UNKNOWN);
+
+	if (0 != json_parse_value(ptr, &obj, 0, NULL))
+		ret = jsonpath_str_copy_value(output, &output_alloc, &output_offset, &obj);
+	else
+		ret = FAIL;
+
+	zbx_jsonobj_clear(&obj);
+
+	return ret;
+}
+
 #if !defined(_WINDOWS) && !defined(__MINGW32__)
 /* jsonobject index hashset support */
 
@@ -0,0 +1,393 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "async_concurrency.h"
+
+#include "async_manager.h"
+
+#include "zbxalgo.h"
+#include "zbxtime.h"
+#include "zbxcacheconfig.h"
+
+#define ASYNC_CONCURRENCY_WINDOW	1	/* seconds between concurrency adjustments */
+
+typedef struct
+{
+	zbx_uint64_pair_t	key;		/* hostid, interfaceid */
+	int			limit;
+	int			inflight_num;
+	int			window_timeouts;
+	unsigned char		queued;		/* host is in the deferred hosts list */
+	zbx_list_t		deferred;
+}
+zbx_async_host_t;
+
+typedef struct
+{
+	zbx_uint64_t		itemid;
+	zbx_uint64_pair_t	key;
+	double			start;
+}
+zbx_async_check_t;
+
+static void	async_host_clean(void *data)
+{
+	zbx_async_host_t	*host = (zbx_async_host_t *)data;
+	zbx_async_deferred_t	*deferred;
+
+	while (SUCCEED == zbx_list_pop(&host->deferred, (void **)&deferred))
+	{
+		if (0 == --deferred->poller_item->deferred_num)
+			zbx_poller_item_free(deferred->poller_item);
+
+		zbx_free(deferred);
+	}
+
+	zbx_list_destroy(&host->deferred);
+}
+
+void	async_concurrency_init(zbx_async_concurrency_t *concurrency, int limit_max, int config_timeout)
+{
+	concurrency->limit = limit_max;
+	concurrency->limit_max = limit_max;
+	concurrency->config_timeout = config_timeout;
+	concurrency->inflight_num = 0;
+	concurrency->deferred_num = 0;
+
+	zbx_hashset_create_ext(&concurrency->hosts, 100, ZBX_DEFAULT_UINT64_PAIR_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC, async_host_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create(&concurrency->checks, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_list_create(&concurrency->deferred_hosts);
+	concurrency->deferred_hosts_num = 0;
+
+	concurrency->window_start = zbx_time();
+	concurrency->window_finished = 0;
+	concurrency->window_timeouts = 0;
+	concurrency->window_timeout_hosts = 0;
+	concurrency->window_inflight_max = 0;
+	concurrency->window_succeeded = 0;
+	concurrency->window_latency = 0;
+}
+
+void	async_concurrency_destroy(zbx_async_concurrency_t *concurrency)
+{
+	zbx_list_destroy(&concurrency->deferred_hosts);
+	zbx_hashset_destroy(&concurrency->checks);
+	zbx_hashset_destroy(&concurrency->hosts);
+}
+
+static zbx_async_host_t	*async_concurrency_get_host(zbx_async_concurrency_t *concurrency, const zbx_dc_item_t *item)
+{
+	zbx_async_host_t	*host, host_local = {.key = {item->host.hostid, item->interface.interfaceid}};
+
+	if (NULL == (host = (zbx_async_host_t *)zbx_hashset_search(&concurrency->hosts, &host_local)))
+	{
+		host_local.limit = concurrency->limit_max;
+		host = (zbx_async_host_t *)zbx_hashset_insert(&concurrency->hosts, &host_local, sizeof(host_local));
+		zbx_list_create(&host->deferred);
+	}
+
+	return host;
+}
+
+static void	async_concurrency_start(zbx_async_concurrency_t *concurrency, zbx_async_host_t *host,
+		zbx_uint64_t itemid)
+{
+	zbx_async_check_t	check_local = {.itemid = itemid, .key = host->key, .start = zbx_time()};
+
+	zbx_hashset_insert(&concurrency->checks, &check_local, sizeof(check_local));
+
+	host->inflight_num++;
+
+	if (++concurrency->inflight_num > concurrency->window_inflight_max)
+		concurrency->window_inflight_max = concurrency->inflight_num;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: takes slot for the check if neither poller nor its host are at    *
+ *          their concurrency limits                                          *
+ *                                                                            *
+ * Return value: SUCCEED - the check can be started                           *
+ *               FAIL    - the check must be deferred                         *
+ *                                                                            *
+ ******************************************************************************/
+int	async_concurrency_acquire(zbx_async_concurrency_t *concurrency, const zbx_dc_item_t *item)
+{
+	zbx_async_host_t	*host = async_concurrency_get_host(concurrency, item);
+
+	/* keep checks of the same host in order */
+	if (0 != host->queued || host->inflight_num >= host->limit || concurrency->inflight_num >=
+			(int)concurrency->limit)
+	{
+		return FAIL;
+	}
+
+	async_concurrency_start(concurrency, host, item->itemid);
+
+	return SUCCEED;
+}
+
+void	async_concurrency_defer(zbx_async_concurrency_t *concurrency, const zbx_dc_item_t *item,
+		zbx_poller_item_t *poller_item, int index)
+{
+	zbx_async_host_t	*host = async_concurrency_get_host(concurrency, item);
+	zbx_async_deferred_t	*deferred;
+
+	deferred = (zbx_async_deferred_t *)zbx_malloc(NULL, sizeof(zbx_async_deferred_t));
+	deferred->poller_item = poller_item;
+	deferred->index = index;
+	zbx_list_append(&host->deferred, deferred, NULL);
+
+	poller_item->deferred_num++;
+	concurrency->deferred_num++;
+
+	if (0 == host->queued)
+	{
+		host->queued = 1;
+		zbx_list_append(&concurrency->deferred_hosts, host, NULL);
+		concurrency->deferred_hosts_num++;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: takes slot for the next deferred check, visiting hosts in         *
+ *          round-robin order so that slow hosts cannot starve others         *
+ *                                                                            *
+ * Return value: SUCCEED - deferred check is returned and can be started,     *
+ *                         deferred_num of its poller item must be decreased *
+ *               FAIL    - no deferred checks can be started now              *
+ *                                                                            *
+ ******************************************************************************/
+int	async_concurrency_next_deferred(zbx_async_concurrency_t *concurrency, zbx_async_deferred_t *deferred)
+{
+	for (int i = concurrency->deferred_hosts_num; 0 < i && concurrency->inflight_num < (int)concurrency->limit;
+			i--)
+	{
+		zbx_async_host_t	*host;
+		zbx_async_deferred_t	*host_deferred;
+
+		zbx_list_pop(&concurrency->deferred_hosts, (void **)&host);
+
+		if (host->inflight_num >= host->limit)
+		{
+			zbx_list_append(&concurrency->deferred_hosts, host, NULL);
+			continue;
+		}
+
+		zbx_list_pop(&host->deferred, (void **)&host_deferred);
+		*deferred = *host_deferred;
+		zbx_free(host_deferred);
+		concurrency->deferred_num--;
+
+		if (SUCCEED == zbx_list_peek(&host->deferred, (void **)&host_deferred))
+		{
+			zbx_list_append(&concurrency->deferred_hosts, host, NULL);
+		}
+		else
+		{
+			host->queued = 0;
+			concurrency->deferred_hosts_num--;
+		}
+
+		async_concurrency_start(concurrency, host, deferred->poller_item->items[deferred->index].itemid);
+
+		return SUCCEED;
+	}
+
+	return FAIL;
+}
+
+static zbx_async_host_t	*async_concurrency_finish(zbx_async_concurrency_t *concurrency, zbx_uint64_t itemid,
+		double *latency)
+{
+	zbx_async_check_t	*check;
+	zbx_async_host_t	*host;
+
+	if (NULL == (check = (zbx_async_check_t *)zbx_hashset_search(&concurrency->checks, &itemid)))
+		return NULL;
+
+	*latency = zbx_time() - check->start;
+
+	if (NULL != (host = (zbx_async_host_t *)zbx_hashset_search(&concurrency->hosts, &check->key)))
+		host->inflight_num--;
+
+	concurrency->inflight_num--;
+	zbx_hashset_remove_direct(&concurrency->checks, check);
+
+	return host;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees slot of the check that could not be started                 *
+ *                                                                            *
+ ******************************************************************************/
+void	async_concurrency_cancel(zbx_async_concurrency_t *concurrency, zbx_uint64_t itemid)
+{
+	double	latency;
+
+	async_concurrency_finish(concurrency, itemid, &latency);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees slot of finished check and adjusts concurrency of its host  *
+ *                                                                            *
+ * Comments: Host concurrency is halved on timeouts and network errors and    *
+ *           grows by one with each successful check.                         *
+ *                                                                            *
+ ******************************************************************************/
+void	async_concurrency_release(zbx_async_concurrency_t *concurrency, zbx_uint64_t itemid, int errcode)
+{
+	zbx_async_host_t	*host;
+	double			latency;
+
+	if (NULL == (host = async_concurrency_finish(concurrency, itemid, &latency)))
+		return;
+
+	concurrency->window_finished++;
+
+	if (TIMEOUT_ERROR == errcode || NETWORK_ERROR == errcode)
+	{
+		host->limit = MAX(1, MIN(host->limit, host->inflight_num + 1) / 2);
+
+		if (TIMEOUT_ERROR == errcode)
+		{
+			concurrency->window_timeouts++;
+
+			if (0 == host->window_timeouts++)
+				concurrency->window_timeout_hosts++;
+		}
+	}
+	else
+	{
+		if (host->limit < concurrency->limit_max)
+			host->limit++;
+
+		concurrency->window_succeeded++;
+		concurrency->window_latency += latency;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adjusts poller concurrency by checks finished during the last     *
+ *          window                                                            *
+ *                                                                            *
+ * Comments: Concurrency is halved when more than quarter of checks timed out *
+ *           on more than one host, and lowered by quarter when average       *
+ *           latency exceeds half of the timeout. Otherwise it grows by 2% of *
+ *           MaxConcurrentChecksPerPoller if it was fully used. Timeouts of   *
+ *           a single host only lower concurrency of that host.               *
+ *                                                                            *
+ ******************************************************************************/
+void	async_concurrency_update(zbx_async_concurrency_t *concurrency)
+{
+	double			now, limit_min, limit_old = concurrency->limit;
+	zbx_hashset_iter_t	iter;
+	zbx_async_host_t	*host;
+
+	now = zbx_time();
+
+	if (ASYNC_CONCURRENCY_WINDOW > now - concurrency->window_start)
+		return;
+
+	limit_min = MAX(1, concurrency->limit_max / 10);
+
+	if (0 != concurrency->window_finished)
+	{
+		if (1 < concurrency->window_timeout_hosts &&
+				concurrency->window_timeouts * 4 > concurrency->window_finished)
+		{
+			concurrency->limit = MAX(limit_min, concurrency->limit / 2);
+		}
+		else if (0 != concurrency->window_succeeded && concurrency->window_latency /
+				concurrency->window_succeeded > concurrency->config_timeout / 2.0)
+		{
+			concurrency->limit = MAX(limit_min, concurrency->limit * 0.75);
+		}
+		else if (concurrency->window_inflight_max >= (int)concurrency->limit)
+		{
+			concurrency->limit = MIN(concurrency->limit_max,
+					concurrency->limit + MAX(1, concurrency->limit_max / 50));
+		}
+	}
+
+	if (limit_old != concurrency->limit)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() concurrency changed from %d to %d, finished:%d timeouts:%d"
+				" timed out hosts:%d", __func__, (int)limit_old, (int)concurrency->limit,
+				concurrency->window_finished, concurrency->window_timeouts,
+				concurrency->window_timeout_hosts);
+	}
+
+	zbx_hashset_iter_reset(&concurrency->hosts, &iter);
+
+	while (NULL != (host = (zbx_async_host_t *)zbx_hashset_iter_next(&iter)))
+	{
+		host->window_timeouts = 0;
+
+		if (0 == host->inflight_num && 0 == host->queued && host->limit >= concurrency->limit_max)
+			zbx_hashset_iter_remove(&iter);
+	}
+
+	concurrency->window_start = now;
+	concurrency->window_finished = 0;
+	concurrency->window_timeouts = 0;
+	concurrency->window_timeout_hosts = 0;
+	concurrency->window_inflight_max = concurrency->inflight_num;
+	concurrency->window_succeeded = 0;
+	concurrency->window_latency = 0;
+}
+
+int	async_concurrency_get_limit(const zbx_async_concurrency_t *concurrency)
+{
+	return (int)concurrency->limit;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns number of checks poller may hold, including deferred      *
+ *          checks so that they do not prevent polling of other hosts         *
+ *                                                                            *
+ ******************************************************************************/
+int	async_concurrency_get_fetch_limit(const zbx_async_concurrency_t *concurrency)
+{
+	return (int)concurrency->limit + MIN(concurrency->deferred_num, concurrency->limit_max);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns age in seconds of the oldest check in progress            *
+ *                                                                            *
+ ******************************************************************************/
+double	async_concurrency_get_inflight_age(const zbx_async_concurrency_t *concurrency)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_async_check_t	*check;
+	double			now = zbx_time(), start = now;
+
+	zbx_hashset_iter_reset((zbx_hashset_t *)&concurrency->checks, &iter);
+
+	while (NULL != (check = (zbx_async_check_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (check->start < start)
+			start = check->start;
+	}
+
+	return now - start;
+}
@@ -0,0 +1,67 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#ifndef ZABBIX_ASYNC_CONCURRENCY_H
+#define ZABBIX_ASYNC_CONCURRENCY_H
+
+#include "async_manager.h"
+
+#include "zbxalgo.h"
+#include "zbxcacheconfig.h"
+
+/* check waiting for free slot of its host */
+typedef struct
+{
+	zbx_poller_item_t	*poller_item;
+	int			index;
+}
+zbx_async_deferred_t;
+
+struct zbx_async_concurrency
+{
+	double		limit;			/* current concurrency of poller */
+	int		limit_max;		/* MaxConcurrentChecksPerPoller */
+	int		config_timeout;
+	int		inflight_num;
+	int		deferred_num;
+
+	zbx_hashset_t	hosts;
+	zbx_hashset_t	checks;			/* checks in progress by itemid */
+	zbx_list_t	deferred_hosts;		/* hosts with deferred checks in round-robin order */
+	int		deferred_hosts_num;
+
+	/* statistics of the current window */
+	double		window_start;
+	int		window_finished;
+	int		window_timeouts;
+	int		window_timeout_hosts;
+	int		window_inflight_max;
+	int		window_succeeded;
+	double		window_latency;		/* total latency of succeeded checks */
+};
+
+void	async_concurrency_init(zbx_async_concurrency_t *concurrency, int limit_max, int config_timeout);
+void	async_concurrency_destroy(zbx_async_concurrency_t *concurrency);
+int	async_concurrency_acquire(zbx_async_concurrency_t *concurrency, const zbx_dc_item_t *item);
+void	async_concurrency_defer(zbx_async_concurrency_t *concurrency, const zbx_dc_item_t *item,
+		zbx_poller_item_t *poller_item, int index);
+int	async_concurrency_next_deferred(zbx_async_concurrency_t *concurrency, zbx_async_deferred_t *deferred);
+void	async_concurrency_cancel(zbx_async_concurrency_t *concurrency, zbx_uint64_t itemid);
+void	async_concurrency_release(zbx_async_concurrency_t *concurrency, zbx_uint64_t itemid, int errcode);
+void	async_concurrency_update(zbx_async_concurrency_t *concurrency);
+int	async_concurrency_get_limit(const zbx_async_concurrency_t *concurrency);
+int	async_concurrency_get_fetch_limit(const zbx_async_concurrency_t *concurrency);
+double	async_concurrency_get_inflight_age(const zbx_async_concurrency_t *concurrency);
+
+#endif
@@ -197,6 +197,39 @@ void	zbx_async_manager_interfaces_flush(zbx_async_manager_t *manager, zbx_hashse
 	zbx_hashset_clear(interfaces);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: publishes poller concurrency statistics and sets number of items  *
+ *          workers may fetch for the poller                                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_manager_update_stats(zbx_async_manager_t *manager, const zbx_async_manager_stats_t *stats,
+		int processing_limit)
+{
+	async_task_queue_lock(&manager->queue);
+
+	manager->queue.stats.concurrency = stats->concurrency;
+	manager->queue.stats.deferred_num = stats->deferred_num;
+	manager->queue.stats.inflight_age = stats->inflight_age;
+
+	if (manager->queue.processing_limit < (zbx_uint64_t)processing_limit)
+		manager->queue.check_queue = 1;
+
+	manager->queue.processing_limit = (zbx_uint64_t)processing_limit;
+
+	async_task_queue_unlock(&manager->queue);
+}
+
+void	zbx_async_manager_get_stats(zbx_async_manager_t *manager, zbx_async_manager_stats_t *stats)
+{
+	async_task_queue_lock(&manager->queue);
+
+	*stats = manager->queue.stats;
+	stats->processing_num = manager->queue.processing_num;
+
+	async_task_queue_unlock(&manager->queue);
+}
+
 void	zbx_interface_status_clean(zbx_interface_status_t *interface_status)
 {
 	zbx_free(interface_status->key_orig);
@@ -28,6 +28,7 @@ typedef struct
 	AGENT_RESULT	*results;
 	int		*errcodes;
 	int		num;
+	int		deferred_num;	/* items waiting for concurrency slot */
 }
 zbx_poller_item_t;
 
@@ -47,6 +48,15 @@ zbx_interface_status_t;
 
 ZBX_PTR_VECTOR_DECL(interface_status, zbx_interface_status_t *)
 
+typedef struct
+{
+	int		concurrency;
+	int		deferred_num;
+	double		inflight_age;
+	zbx_uint64_t	processing_num;
+}
+zbx_async_manager_stats_t;
+
 zbx_async_manager_t	*zbx_async_manager_create(int workers_num, zbx_async_notify_cb_t async_notify_func,
 					void *finished_data, zbx_thread_poller_args *poller_args_in, char **error);
 void			zbx_async_manager_free(zbx_async_manager_t *manager);
@@ -57,6 +67,9 @@ void			zbx_async_manager_requeue(zbx_async_manager_t *manager, zbx_uint64_t item
 					int lastclock);
 void			zbx_async_manager_requeue_flush(zbx_async_manager_t *manager);
 void			zbx_async_manager_interfaces_flush(zbx_async_manager_t *manager, zbx_hashset_t *interfaces);
+void			zbx_async_manager_update_stats(zbx_async_manager_t *manager,
+					const zbx_async_manager_stats_t *stats, int processing_limit);
+void			zbx_async_manager_get_stats(zbx_async_manager_t *manager, zbx_async_manager_stats_t *stats);
 void			zbx_interface_status_clean(zbx_interface_status_t *interface_status);
 void			zbx_interface_status_free(zbx_interface_status_t *interface_status);
 void			zbx_poller_item_free(zbx_poller_item_t *poller_item);
@@ -16,6 +16,7 @@
 #include "zbxpoller.h"
 
 #include "async_manager.h"
+#include "async_concurrency.h"
 
 #ifdef HAVE_LIBCURL
 #	include "async_httpagent.h"
@@ -111,6 +112,7 @@ static void	process_async_result(zbx_dc_item_context_t *item, zbx_poller_config_
 		SET_MSG_RESULT(&item->result, NULL);
 	}
 
+	async_concurrency_release(poller_config->concurrency, item->itemid, item->ret);
 	zbx_async_manager_requeue(poller_config->manager, item->itemid, item->ret, timespec.sec);
 
 	poller_config->processing--;
@@ -154,6 +156,7 @@ static void	process_httpagent_result(CURL *easy_handle, CURLcode err, void *arg)
 	zbx_timespec_t			timespec;
 	zbx_poller_config_t		*poller_config;
 	CURLcode			err_info;
+	int				errcode;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -199,6 +202,20 @@ static void	process_httpagent_result(CURL *easy_handle, CURLcode err, void *arg)
 	zbx_free_agent_result(&result);
 	zbx_free(out);
 
+	switch (err)
+	{
+		case CURLE_OPERATION_TIMEDOUT:
+			errcode = TIMEOUT_ERROR;
+			break;
+		case CURLE_COULDNT_RESOLVE_HOST:
+		case CURLE_COULDNT_CONNECT:
+			errcode = NETWORK_ERROR;
+			break;
+		default:
+			errcode = SUCCEED;
+	}
+
+	async_concurrency_release(poller_config->concurrency, item_context->itemid, errcode);
 	zbx_async_manager_requeue(poller_config->manager, httpagent_context->item_context.itemid, SUCCEED,
 			timespec.sec);
 
@@ -222,13 +239,76 @@ static void	async_wake(evutil_socket_t fd, short events, void *arg)
 	ZBX_UNUSED(arg);
 }
 
+static int	async_check_start(zbx_poller_config_t *poller_config, zbx_dc_item_t *item, AGENT_RESULT *result,
+		const char *zbx_progname)
+{
+	int	errcode;
+
+	if (ITEM_TYPE_HTTPAGENT == item->type)
+	{
+#ifdef HAVE_LIBCURL
+		errcode = zbx_async_check_httpagent(item, result, poller_config->config_source_ip,
+				poller_config->config_ssl_ca_location, poller_config->config_ssl_cert_location,
+				poller_config->config_ssl_key_location, poller_config->curl_handle);
+#else
+		errcode = NOTSUPPORTED;
+		SET_MSG_RESULT(result, zbx_strdup(NULL, "Support for HTTP agent was not compiled in: missing cURL"
+				" library"));
+#endif
+	}
+	else if (ITEM_TYPE_ZABBIX == item->type)
+	{
+		errcode = zbx_async_check_agent(item, result, process_agent_result, poller_config, poller_config,
+				poller_config->base, poller_config->channel, poller_config->dnsbase,
+				poller_config->config_source_ip, ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO);
+	}
+	else
+	{
+#ifdef HAVE_NETSNMP
+		zbx_set_snmp_bulkwalk_options(zbx_progname);
+
+		errcode = zbx_async_check_snmp(item, result, process_snmp_result, poller_config, poller_config,
+				poller_config->base, poller_config->channel, poller_config->dnsbase,
+				poller_config->config_source_ip, ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO,
+				ZBX_SNMP_DEFAULT_NUMBER_OF_RETRIES);
+#else
+		ZBX_UNUSED(zbx_progname);
+		errcode = NOTSUPPORTED;
+		SET_MSG_RESULT(result, zbx_strdup(NULL, "Support for SNMP checks was not compiled in."));
+#endif
+	}
+
+	if (SUCCEED == errcode)
+		poller_config->processing++;
+	else
+		async_concurrency_cancel(poller_config->concurrency, item->itemid);
+
+	return errcode;
+}
+
+static void	async_check_fail(zbx_poller_config_t *poller_config, const zbx_dc_item_t *item, AGENT_RESULT *result,
+		int errcode)
+{
+	zbx_timespec_t	timespec;
+
+	zbx_timespec(&timespec);
+
+	if (ZBX_IS_RUNNING())
+	{
+		zbx_preprocess_item_value(item->itemid, item->host.hostid, item->value_type, item->flags,
+				item->preprocessing, NULL, &timespec, ITEM_STATE_NOTSUPPORTED, result->msg);
+	}
+
+	zbx_async_manager_requeue(poller_config->manager, item->itemid, errcode, timespec.sec);
+}
+
 static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, const char *zbx_progname)
 {
 	zbx_dc_item_t			*items = NULL;
 	AGENT_RESULT			*results;
 	int				*errcodes, total = 0;
-	zbx_timespec_t			timespec;
 	zbx_vector_poller_item_t	poller_items;
+	zbx_async_deferred_t		deferred;
 
 	zbx_vector_poller_item_create(&poller_items);
 #ifdef HAVE_NETSNMP
@@ -250,14 +330,31 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 
 		poller_config->clear_cache = 0;
 	}
-#else
-	ZBX_UNUSED(zbx_progname);
 #endif
 
 	zbx_async_manager_queue_get(poller_config->manager, &poller_items);
 
 	if (0 != poller_items.values_num)
 		zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+#ifdef HAVE_NETSNMP
+	/* walk[] items of the same device are coalesced within the batch */
+	zbx_async_check_snmp_batch_begin(poller_config->config_snmp_max_repetitions_tuning);
+#endif
+	/* checks deferred earlier go first, hosts are visited in round-robin order */
+	while (SUCCEED == async_concurrency_next_deferred(poller_config->concurrency, &deferred))
+	{
+		zbx_poller_item_t	*poller_item = deferred.poller_item;
+		int			i = deferred.index, errcode;
+
+		if (SUCCEED != (errcode = async_check_start(poller_config, &poller_item->items[i],
+				&poller_item->results[i], zbx_progname)))
+		{
+			async_check_fail(poller_config, &poller_item->items[i], &poller_item->results[i], errcode);
+		}
+
+		if (0 == --poller_item->deferred_num)
+			zbx_poller_item_free(poller_item);
+	}
 
 	for (int j = 0; j < poller_items.values_num; j++)
 	{
@@ -272,72 +369,27 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 
 		for (int i = 0; i < num; i++)
 		{
-			if (SUCCEED != errcodes[i])
-				continue;
-
-			if (ITEM_TYPE_HTTPAGENT == items[i].type)
-			{
-	#ifdef HAVE_LIBCURL
-				errcodes[i] = zbx_async_check_httpagent(&items[i], &results[i],
-						poller_config->config_source_ip, poller_config->config_ssl_ca_location,
-						poller_config->config_ssl_cert_location,
-						poller_config->config_ssl_key_location, poller_config->curl_handle);
-	#else
-				errcodes[i] = NOTSUPPORTED;
-				SET_MSG_RESULT(&results[i], zbx_strdup(NULL, "Support for HTTP agent was not compiled"
-						" in: missing cURL library"));
-	#endif
-			}
-			else if (ITEM_TYPE_ZABBIX == items[i].type)
-			{
-				errcodes[i] = zbx_async_check_agent(&items[i], &results[i], process_agent_result,
-						poller_config, poller_config, poller_config->base,
-						poller_config->channel, poller_config->dnsbase,
-						poller_config->config_source_ip, ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO);
-			}
-			else
-			{
-	#ifdef HAVE_NETSNMP
-				zbx_set_snmp_bulkwalk_options(zbx_progname);
-
-				errcodes[i] = zbx_async_check_snmp(&items[i], &results[i], process_snmp_result,
-					poller_config, poller_config, poller_config->base, poller_config->channel,
-					poller_config->dnsbase, poller_config->config_source_ip,
-					ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO, ZBX_SNMP_DEFAULT_NUMBER_OF_RETRIES);
-	#else
-				errcodes[i] = NOTSUPPORTED;
-				SET_MSG_RESULT(&results[i], zbx_strdup(NULL, "Support for SNMP checks was not compiled"
-						"in."));
-	#endif
-			}
-
 			if (SUCCEED == errcodes[i])
-				poller_config->processing++;
-		}
-
-		zbx_timespec(&timespec);
-
-		/* process item values */
-		for (int i = 0; i < num; i++)
-		{
-			if (SUCCEED != errcodes[i])
 			{
-				if (ZBX_IS_RUNNING())
+				if (SUCCEED != async_concurrency_acquire(poller_config->concurrency, &items[i]))
 				{
-					zbx_preprocess_item_value(items[i].itemid,
-							items[i].host.hostid, items[i].value_type,
-							items[i].flags, items[i].preprocessing, NULL, &timespec,
-							ITEM_STATE_NOTSUPPORTED, results[i].msg);
+					async_concurrency_defer(poller_config->concurrency, &items[i],
+							poller_items.values[j], i);
+					continue;
 				}
 
-				zbx_async_manager_requeue(poller_config->manager, items[i].itemid, errcodes[i],
-						timespec.sec);
+				errcodes[i] = async_check_start(poller_config, &items[i], &results[i], zbx_progname);
 			}
+
+			if (SUCCEED != errcodes[i])
+				async_check_fail(poller_config, &items[i], &results[i], errcodes[i]);
 		}
 
-		zbx_poller_item_free(poller_items.values[j]);
+		if (0 == poller_items.values[j]->deferred_num)
+			zbx_poller_item_free(poller_items.values[j]);
 	}
 #ifdef HAVE_NETSNMP
+	zbx_async_check_snmp_batch_end();
 exit:
 #endif
 	if (0 != total)
@@ -361,7 +413,19 @@ static void	async_timer(evutil_socket_t fd, short events, void *arg)
 	ZBX_UNUSED(events);
 
 	if (ZBX_IS_RUNNING())
+	{
+		zbx_async_manager_stats_t	stats;
+
+		async_concurrency_update(poller_config->concurrency);
+
+		stats.concurrency = async_concurrency_get_limit(poller_config->concurrency);
+		stats.deferred_num = poller_config->concurrency->deferred_num;
+		stats.inflight_age = async_concurrency_get_inflight_age(poller_config->concurrency);
+		zbx_async_manager_update_stats(poller_config->manager, &stats,
+				async_concurrency_get_fetch_limit(poller_config->concurrency));
+
 		zbx_async_manager_queue_sync(poller_config->manager);
+	}
 }
 #ifdef HAVE_ARES
 static void	async_timeout_timer(evutil_socket_t fd, short events, void *arg)
@@ -460,10 +524,15 @@ static void	async_poller_init(zbx_poller_config_t *poller_config, zbx_thread_pol
 	poller_config->config_unreachable_period = poller_args_in->config_unreachable_period;
 	poller_config->config_max_concurrent_checks_per_poller =
 			poller_args_in->config_max_concurrent_checks_per_poller;
+	poller_config->config_snmp_max_repetitions_tuning = poller_args_in->config_snmp_max_repetitions_tuning;
 	poller_config->clear_cache = 0;
 	poller_config->process_num = process_num;
 	poller_config->channel = NULL;
 
+	poller_config->concurrency = (zbx_async_concurrency_t *)zbx_malloc(NULL, sizeof(zbx_async_concurrency_t));
+	async_concurrency_init(poller_config->concurrency, poller_config->config_max_concurrent_checks_per_poller,
+			poller_config->config_timeout);
+
 	if (NULL == (poller_config->async_wake_timer = event_new(poller_config->base, -1, EV_PERSIST, async_wake,
 			poller_config)))
 	{
@@ -646,6 +715,8 @@ static void	async_poller_destroy(zbx_poller_config_t *poller_config)
 {
 	zbx_hashset_destroy(&poller_config->fd_events);
 	zbx_async_manager_free(poller_config->manager);
+	async_concurrency_destroy(poller_config->concurrency);
+	zbx_free(poller_config->concurrency);
 	event_base_free(poller_config->base);
 	zbx_hashset_clear(&poller_config->interfaces);
 	zbx_hashset_destroy(&poller_config->interfaces);
@@ -760,7 +831,7 @@ ZBX_THREAD_ENTRY(zbx_async_poller_thread, args)
 		unsigned char	*rtc_data;
 
 		if (ZBX_PROCESS_STATE_BUSY == poller_config.state &&
-				poller_config.processing < poller_config.config_max_concurrent_checks_per_poller)
+				poller_config.processing < async_concurrency_get_limit(poller_config.concurrency))
 		{
 			zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
 			poller_config.state = ZBX_PROCESS_STATE_IDLE;
@@ -784,9 +855,15 @@ ZBX_THREAD_ENTRY(zbx_async_poller_thread, args)
 		{
 			zbx_update_env(get_process_type_string(process_type), zbx_time());
 
-			zbx_setproctitle("%s #%d [got %d values, queued %d in 5 sec, awaiting %d%s]",
+			zbx_async_manager_stats_t	stats;
+
+			zbx_async_manager_get_stats(poller_config.manager, &stats);
+
+			zbx_setproctitle("%s #%d [got %d values, queued %d in 5 sec, awaiting %d, deferred %d,"
+				" concurrency %d, oldest %.1f sec%s]",
 				get_process_type_string(process_type), process_num, poller_config.processed,
-				poller_config.queued, poller_config.processing, zbx_vps_monitor_status());
+				poller_config.queued, poller_config.processing, stats.deferred_num,
+				stats.concurrency, stats.inflight_age, zbx_vps_monitor_status());
 
 			poller_config.processed = 0;
 			poller_config.queued = 0;
@@ -55,6 +55,8 @@ int	async_task_queue_init(zbx_async_queue_t *queue, zbx_thread_poller_args *poll
 	queue->config_unavailable_delay = poller_args_in->config_unavailable_delay;
 	queue->config_unreachable_delay = poller_args_in->config_unreachable_delay;
 	queue->config_unreachable_period = poller_args_in-> config_unreachable_period;
+	memset(&queue->stats, 0, sizeof(queue->stats));
+	queue->stats.concurrency = poller_args_in->config_max_concurrent_checks_per_poller;
 
 	zbx_vector_uint64_create(&queue->itemids);
 	zbx_vector_int32_create(&queue->errcodes);
@@ -41,6 +41,7 @@ typedef struct
 	zbx_vector_int32_t		errcodes;
 	zbx_vector_int32_t		lastclocks;
 	unsigned char			check_queue;
+	zbx_async_manager_stats_t	stats;
 
 	pthread_mutex_t			lock;
 	pthread_cond_t			event;
@@ -38,6 +38,7 @@ static zbx_poller_item_t	*dc_config_async_get_poller_items(zbx_uint64_t processi
 
 	poller_item = zbx_malloc(NULL, sizeof(zbx_poller_item_t));
 	poller_item->items = NULL;
+	poller_item->deferred_num = 0;
 
 	poller_item->num = zbx_dc_config_get_poller_items(poller_type, config_timeout,
 			processing_num, processing_limit, &poller_item->items);
@@ -158,8 +159,8 @@ static void	*async_worker_entry(void *args)
 	zbx_vector_int32_create(&lastclocks);
 
 	const unsigned char	poller_type = queue->poller_type;
-	const zbx_uint64_t	processing_limit = queue->processing_limit;
-	zbx_uint64_t		queue_poller_items_values_num, processing_num = queue->processing_num;
+	zbx_uint64_t		queue_poller_items_values_num, processing_num = queue->processing_num,
+				processing_limit;
 	const int		config_timeout = queue->config_timeout,
 				config_unavailable_delay = queue->config_unavailable_delay,
 				config_unreachable_period = queue->config_unreachable_period,
@@ -171,6 +172,7 @@ static void	*async_worker_entry(void *args)
 		unsigned char		check_queue = queue->check_queue;
 
 		queue->check_queue = 0;
+		processing_limit = queue->processing_limit;
 
 		if (0 != queue->interfaces.values_num)
 		{
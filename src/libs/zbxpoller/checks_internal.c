@@ -233,6 +233,76 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets process local counter of processes specified by item key     *
+ *          <type>,<mode> parameters                                          *
+ *                                                                            *
+ * Parameters: request          - [IN] item key request                       *
+ *             counter          - [IN] one of ZBX_SELFMON_COUNTER_*           *
+ *             get_config_forks - [IN]                                        *
+ *             result           - [OUT] counter value or error message        *
+ *                                                                            *
+ * Return value: SUCCEED - counter value was retrieved                        *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	get_selfmon_counter_value(const AGENT_REQUEST *request, int counter,
+		zbx_get_config_forks_f get_config_forks, AGENT_RESULT *result)
+{
+	unsigned char	process_type, aggr_func;
+	unsigned short	process_num = 0;
+	int		process_forks;
+	const char	*tmp;
+	zbx_uint64_t	value;
+
+	if (ZBX_PROCESS_TYPE_UNKNOWN == (process_type = (unsigned char)get_process_type_by_name(
+			get_rparam(request, 1))))
+	{
+		SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid second parameter."));
+		return FAIL;
+	}
+
+	if (NULL == (tmp = get_rparam(request, 2)) || '\0' == *tmp || 0 == strcmp(tmp, "max"))
+		aggr_func = ZBX_SELFMON_AGGR_FUNC_MAX;
+	else if (0 == strcmp(tmp, "avg"))
+		aggr_func = ZBX_SELFMON_AGGR_FUNC_AVG;
+	else if (0 == strcmp(tmp, "min"))
+		aggr_func = ZBX_SELFMON_AGGR_FUNC_MIN;
+	else if (SUCCEED == zbx_is_ushort(tmp, &process_num) && 0 < process_num)
+		aggr_func = ZBX_SELFMON_AGGR_FUNC_ONE;
+	else
+	{
+		SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
+		return FAIL;
+	}
+
+	if (0 == (process_forks = get_config_forks(process_type)))
+	{
+		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "No \"%s\" processes started.",
+				get_process_type_string(process_type)));
+		return FAIL;
+	}
+
+	if (process_num > process_forks)
+	{
+		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Process \"%s #%d\" is not started.",
+				get_process_type_string(process_type), process_num));
+		return FAIL;
+	}
+
+	if (SUCCEED != zbx_get_selfmon_counter(process_type, aggr_func, process_num, counter, &value))
+	{
+		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Process \"%s\" is not monitored by self-monitoring.",
+				get_process_type_string(process_type)));
+		return FAIL;
+	}
+
+	SET_UI64_RESULT(result, value);
+
+	return SUCCEED;
+}
+
 /**********************************************************************************
  *                                                                                *
  * Purpose: retrieves data from Zabbix server (internally supported items)        *
@@ -588,6 +658,57 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 			SET_DBL_RESULT(result, value);
 		}
 	}
+	else if (0 == strcmp(tmp, "recv_peak"))		/* zabbix[recv_peak,<type>,<mode>,<connection>] */
+	{
+		int	counter;
+
+		if (2 > nparams || nparams > 4)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid number of parameters."));
+			goto out;
+		}
+
+		if (NULL == (tmp1 = get_rparam(&request, 3)) || '\0' == *tmp1 ||
+				0 == strcmp(tmp1, ZBX_TCP_SEC_UNENCRYPTED_TXT))
+		{
+			counter = ZBX_SELFMON_COUNTER_RECV_PEAK_UNENCRYPTED;
+		}
+		else if (0 == strcmp(tmp1, ZBX_TCP_SEC_TLS_PSK_TXT))
+			counter = ZBX_SELFMON_COUNTER_RECV_PEAK_PSK;
+		else if (0 == strcmp(tmp1, ZBX_TCP_SEC_TLS_CERT_TXT))
+			counter = ZBX_SELFMON_COUNTER_RECV_PEAK_CERT;
+		else
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid fourth parameter."));
+			goto out;
+		}
+
+		if (SUCCEED != get_selfmon_counter_value(&request, counter, get_config_forks, result))
+			goto out;
+	}
+	else if (0 == strcmp(tmp, "regexp_cache"))		/* zabbix[regexp_cache,<type>,<mode>,<counter>] */
+	{
+		int	counter;
+
+		if (2 > nparams || nparams > 4)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid number of parameters."));
+			goto out;
+		}
+
+		if (NULL == (tmp1 = get_rparam(&request, 3)) || '\0' == *tmp1 || 0 == strcmp(tmp1, "hits"))
+			counter = ZBX_SELFMON_COUNTER_REGEXP_CACHE_HITS;
+		else if (0 == strcmp(tmp1, "misses"))
+			counter = ZBX_SELFMON_COUNTER_REGEXP_CACHE_MISSES;
+		else
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid fourth parameter."));
+			goto out;
+		}
+
+		if (SUCCEED != get_selfmon_counter_value(&request, counter, get_config_forks, result))
+			goto out;
+	}
 	else if (0 == strcmp(tmp, "wcache"))			/* zabbix[wcache,<cache>,<mode>] */
 	{
 		if (2 > nparams || nparams > 3)
@@ -682,6 +803,8 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_get_stats(ZBX_STATS_TREND_FREE));
 			else if (0 == strcmp(tmp1, "pused"))
 				SET_DBL_RESULT(result, *(double *)zbx_dc_get_stats(ZBX_STATS_TREND_PUSED));
+			else if (0 == strcmp(tmp1, "flush"))
+				SET_DBL_RESULT(result, *(double *)zbx_dc_get_stats(ZBX_STATS_TREND_FLUSH_TIME));
 			else
 			{
 				SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
@@ -767,6 +890,32 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 				goto out;
 			}
 		}
+		else if (0 == strcmp(tmp, "lock"))
+		{
+			if (NULL == tmp1 || '\0' == *tmp1 || 0 == strcmp(tmp1, "hold"))
+			{
+				SET_DBL_RESULT(result, *(double *)zbx_dc_config_get_stats(ZBX_CONFSTATS_LOCK_HOLD));
+			}
+			else if (0 == strcmp(tmp1, "stall"))
+			{
+				SET_DBL_RESULT(result, *(double *)zbx_dc_config_get_stats(ZBX_CONFSTATS_LOCK_STALL));
+			}
+			else if (0 == strcmp(tmp1, "stalls"))
+			{
+				SET_UI64_RESULT(result, *(zbx_uint64_t *)
+						zbx_dc_config_get_stats(ZBX_CONFSTATS_LOCK_STALLS));
+			}
+			else if (0 == strcmp(tmp1, "bypasses"))
+			{
+				SET_UI64_RESULT(result, *(zbx_uint64_t *)
+						zbx_dc_config_get_stats(ZBX_CONFSTATS_LOCK_BYPASSES));
+			}
+			else
+			{
+				SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
+				goto out;
+			}
+		}
 		else
 		{
 			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid second parameter."));
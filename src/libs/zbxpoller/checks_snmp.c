@@ -152,12 +152,58 @@ typedef struct
 	char			*error;
 	netsnmp_large_fd_set	fdset;
 	char			*error_msgget;
+	int			max_repetitions;	/* max-repetitions of the last GETBULK request */
 }
 zbx_bulkwalk_context_t;
 
 ZBX_PTR_VECTOR_DECL(bulkwalk_context, zbx_bulkwalk_context_t*)
 ZBX_PTR_VECTOR_IMPL(bulkwalk_context, zbx_bulkwalk_context_t*)
 
+/* variable received by walk of merged subtrees, used to split results between coalesced items */
+typedef struct
+{
+	oid			*name;
+	size_t			name_length;
+	const zbx_snmp_oid_t	*root;		/* merged subtree the variable was received for */
+	size_t			offset;		/* variable line location in walk results */
+	size_t			len;
+}
+zbx_snmp_walk_var_t;
+
+ZBX_VECTOR_DECL(snmp_walk_var, zbx_snmp_walk_var_t)
+ZBX_VECTOR_IMPL(snmp_walk_var, zbx_snmp_walk_var_t)
+
+ZBX_PTR_VECTOR_DECL(snmp_context, zbx_snmp_context_t *)
+ZBX_PTR_VECTOR_IMPL(snmp_context, zbx_snmp_context_t *)
+
+/* walk[] items of the same device with overlapping OID subtrees polled by single walk */
+typedef struct
+{
+	zbx_vector_snmp_oid_t		oids;		/* merged subtrees */
+	zbx_vector_snmp_context_t	members;
+	zbx_vector_snmp_walk_var_t	vars;
+}
+zbx_snmp_walk_group_t;
+
+ZBX_PTR_VECTOR_DECL(snmp_walk_group, zbx_snmp_walk_group_t *)
+ZBX_PTR_VECTOR_IMPL(snmp_walk_group, zbx_snmp_walk_group_t *)
+
+typedef struct
+{
+	char				*device;
+	zbx_vector_snmp_walk_group_t	groups;
+}
+zbx_snmp_walk_device_t;
+
+/* max-repetitions tuned for device */
+typedef struct
+{
+	char	*device;
+	int	max_repetitions;
+	int	ceiling;	/* lowered when device responds with tooBig error */
+}
+zbx_snmp_repetitions_t;
+
 struct zbx_snmp_context
 {
 	void				*arg;
@@ -188,6 +234,13 @@ struct zbx_snmp_context
 	zbx_async_resolve_reverse_dns_t	resolve_reverse_dns;
 	zbx_async_rdns_step_t		step;
 	char				*reverse_dns;
+	char				*device;
+	zbx_snmp_repetitions_t		*repetitions;	/* NULL if max-repetitions are not tuned */
+	zbx_snmp_walk_group_t		*group;		/* walk of merged subtrees or NULL */
+	struct event_base		*base;
+	zbx_channel_t			*channel;
+	struct evdns_base		*dnsbase;
+	zbx_async_task_process_result_cb_t	process_result_cb;
 };
 
 typedef struct
@@ -207,6 +260,11 @@ static char				snmp_rwlock_init_done;
 static zbx_hashset_t	engineid_cache;
 static int		engineid_cache_initialized = 0;
 
+static ZBX_THREAD_LOCAL zbx_hashset_t	*snmp_walk_devices;	/* walk[] items coalesced in current batch */
+static ZBX_THREAD_LOCAL int		snmp_walk_batch;
+static ZBX_THREAD_LOCAL zbx_hashset_t	snmp_repetitions;
+static ZBX_THREAD_LOCAL int		snmp_repetitions_init, snmp_repetitions_limit;
+
 #define ZBX_SNMP_GET	0
 #define ZBX_SNMP_WALK	1
 
@@ -2732,7 +2790,8 @@ static void	snmp_bulkwalk_trace_variable(zbx_uint64_t itemid, const struct varia
 static int	snmp_bulkwalk_handle_response(int status, struct snmp_pdu *response,
 		zbx_bulkwalk_context_t *bulkwalk_context, char **results, size_t *results_alloc,
 		size_t *results_offset, const zbx_snmp_sess_t ssp, const zbx_dc_interface_t *interface,
-		unsigned char snmp_oid_type, zbx_uint64_t itemid, char *error, size_t max_error_len)
+		unsigned char snmp_oid_type, zbx_uint64_t itemid, zbx_vector_snmp_walk_var_t *vars, char *error,
+		size_t max_error_len)
 {
 	struct variable_list	*var;
 	int			ret = SUCCEED;
@@ -2854,6 +2913,19 @@ static int	snmp_bulkwalk_handle_response(int status, struct snmp_pdu *response,
 			if (NULL != *results)
 				zbx_chrcpy_alloc(results, results_alloc, results_offset, '\n');
 
+			if (NULL != vars)
+			{
+				zbx_snmp_walk_var_t	walk_var;
+
+				walk_var.name = (oid *)zbx_malloc(NULL, var->name_length * sizeof(oid));
+				memcpy(walk_var.name, var->name, var->name_length * sizeof(oid));
+				walk_var.name_length = var->name_length;
+				walk_var.root = bulkwalk_context->p_oid;
+				walk_var.offset = *results_offset;
+				walk_var.len = strlen(buffer);
+				zbx_vector_snmp_walk_var_append(vars, walk_var);
+			}
+
 			zbx_strcpy_alloc(results, results_alloc, results_offset, buffer);
 
 			if (NULL == var->next_variable)
@@ -2889,6 +2961,78 @@ out:
 	return ret;
 }
 
+static void	snmp_max_repetitions_set(zbx_snmp_context_t *snmp_context, int max_repetitions)
+{
+	if (max_repetitions > snmp_context->repetitions->ceiling)
+		max_repetitions = snmp_context->repetitions->ceiling;
+
+	if (1 > max_repetitions)
+		max_repetitions = 1;
+
+	if (max_repetitions == snmp_context->snmp_max_repetitions)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "itemid:" ZBX_FS_UI64 " max-repetitions changed from %d to %d",
+			snmp_context->item.itemid, snmp_context->snmp_max_repetitions, max_repetitions);
+
+	snmp_context->snmp_max_repetitions = max_repetitions;
+	snmp_context->repetitions->max_repetitions = max_repetitions;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: tunes max-repetitions of device by received GETBULK response      *
+ *                                                                            *
+ * Comments: Max-repetitions are doubled while responses are full and their   *
+ *           estimated size stays within ZBX_SNMP_TUNE_PDU_SIZE. Response     *
+ *           with fewer variables than requested in the middle of walk means  *
+ *           that agent has truncated it to fit its message size, so the      *
+ *           returned number of variables is used instead.                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_max_repetitions_tune(zbx_snmp_context_t *snmp_context,
+		const zbx_bulkwalk_context_t *bulkwalk_context, const struct snmp_pdu *response)
+{
+#define ZBX_SNMP_TUNE_PDU_SIZE	(16 * ZBX_KIBIBYTE)
+	const struct variable_list	*var;
+	int				vars_num = 0, max_repetitions;
+	size_t				size = 0;
+
+	if (NULL == snmp_context->repetitions || SNMP_MSG_GETBULK != bulkwalk_context->pdu_type ||
+			0 == bulkwalk_context->running)
+	{
+		return;
+	}
+
+	/* approximate BER encoded size, each sub-identifier mostly takes one or two bytes */
+	for (var = response->variables; NULL != var; var = var->next_variable)
+	{
+		size += var->name_length + var->val_len + 8;
+		vars_num++;
+	}
+
+	if (0 == vars_num)
+		return;
+
+	if (vars_num < bulkwalk_context->max_repetitions)
+	{
+		max_repetitions = vars_num;
+	}
+	else
+	{
+		max_repetitions = bulkwalk_context->max_repetitions * 2;
+
+		if ((size_t)max_repetitions > ZBX_SNMP_TUNE_PDU_SIZE / (size / (size_t)vars_num))
+			max_repetitions = (int)(ZBX_SNMP_TUNE_PDU_SIZE / (size / (size_t)vars_num));
+
+		if (max_repetitions < bulkwalk_context->max_repetitions)
+			max_repetitions = bulkwalk_context->max_repetitions;
+	}
+
+	snmp_max_repetitions_set(snmp_context, max_repetitions);
+#undef ZBX_SNMP_TUNE_PDU_SIZE
+}
+
 static int	asynch_response(int operation, struct snmp_session *sp, int reqid, struct snmp_pdu *pdu, void *magic)
 {
 	zbx_bulkwalk_context_t	*bulkwalk_context;
@@ -2987,13 +3131,25 @@ static int	asynch_response(int operation, struct snmp_session *sp, int reqid, st
 	{
 		char	error[MAX_STRING_LEN];
 
+		if (STAT_SUCCESS == stat && SNMP_ERR_TOOBIG == pdu->errstat && NULL != snmp_context->repetitions &&
+				SNMP_MSG_GETBULK == bulkwalk_context->pdu_type && 1 < bulkwalk_context->max_repetitions)
+		{
+			/* request the same variables again with fewer repetitions instead of failing */
+			snmp_context->repetitions->ceiling = bulkwalk_context->max_repetitions / 2;
+			snmp_max_repetitions_set(snmp_context, snmp_context->repetitions->ceiling);
+			ret = SUCCEED;
+			goto out;
+		}
+
 		if (SUCCEED != (ret = snmp_bulkwalk_handle_response(stat, pdu, bulkwalk_context, &snmp_context->results,
 				&snmp_context->results_alloc, &snmp_context->results_offset, snmp_context->ssp,
 				&snmp_context->item.interface, snmp_context->snmp_oid_type, snmp_context->item.itemid,
-				error, sizeof(error))))
+				NULL != snmp_context->group ? &snmp_context->group->vars : NULL, error, sizeof(error))))
 		{
 			bulkwalk_context->error = zbx_strdup(bulkwalk_context->error, error);
 		}
+		else
+			snmp_max_repetitions_tune(snmp_context, bulkwalk_context, pdu);
 	}
 	else
 	{
@@ -3039,6 +3195,7 @@ static zbx_bulkwalk_context_t	*snmp_bulkwalk_context_create(zbx_snmp_context_t *
 	bulkwalk_context->arg = snmp_context;
 	bulkwalk_context->error = NULL;
 	bulkwalk_context->error_msgget = NULL;
+	bulkwalk_context->max_repetitions = 0;
 
 	netsnmp_large_fd_set_init(&bulkwalk_context->fdset, FD_SETSIZE);
 
@@ -3103,6 +3260,7 @@ static int	snmp_bulkwalk_add(zbx_snmp_context_t *snmp_context, int *fd, char *er
 		{
 			pdu->non_repeaters = 0;
 			pdu->max_repetitions = snmp_context->snmp_max_repetitions;
+			bulkwalk_context->max_repetitions = snmp_context->snmp_max_repetitions;
 		}
 
 		if (NULL == snmp_add_null_var(pdu, bulkwalk_context->name, bulkwalk_context->name_length))
@@ -3374,15 +3532,23 @@ static int	async_task_process_task_snmp_cb(short event, void *data, int *fd, zbx
 
 		if (NULL != bulkwalk_context->error)
 		{
-			snmp_context->item.ret = NOTSUPPORTED;
-			SET_MSG_RESULT(&snmp_context->item.result, bulkwalk_context->error);
-			bulkwalk_context->error = NULL;
-			goto stop;
+			/* coalesced walk continues with the next subtree, the error is reported */
+			/* only to items under the failed subtree                                */
+			if (NULL == snmp_context->group)
+			{
+				snmp_context->item.ret = NOTSUPPORTED;
+				SET_MSG_RESULT(&snmp_context->item.result, bulkwalk_context->error);
+				bulkwalk_context->error = NULL;
+				goto stop;
+			}
+
+			bulkwalk_context->running = 0;
 		}
 
 		if (0 == bulkwalk_context->running)
 		{
-			if (0 == bulkwalk_context->vars_num && SNMP_MSG_GETBULK == bulkwalk_context->pdu_type)
+			if (0 == bulkwalk_context->vars_num && SNMP_MSG_GETBULK == bulkwalk_context->pdu_type &&
+					NULL == bulkwalk_context->error)
 			{
 				bulkwalk_context->pdu_type = SNMP_MSG_GET;
 			}
@@ -3396,7 +3562,8 @@ static int	async_task_process_task_snmp_cb(short event, void *data, int *fd, zbx
 					{
 						char	*getrequest_err;
 
-						if (NULL != (getrequest_err =
+						/* errors of coalesced walk are reported per item */
+						if (NULL == snmp_context->group && NULL != (getrequest_err =
 								snmp_bulkwalk_get_getrequest_errors(snmp_context)))
 						{
 							snmp_context->item.ret = NOTSUPPORTED;
@@ -3509,6 +3676,7 @@ void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context)
 	zbx_free(snmp_context->item.key_orig);
 	zbx_free(snmp_context->results);
 	zbx_free(snmp_context->reverse_dns);
+	zbx_free(snmp_context->device);
 	zbx_free_agent_result(&snmp_context->item.result);
 
 	zbx_vector_bulkwalk_context_clear_ext(&snmp_context->bulkwalk_contexts, snmp_bulkwalk_context_free);
@@ -3518,6 +3686,486 @@ void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context)
 	zbx_free(snmp_context);
 }
 
+static int	zbx_snmp_oid_in_subtree(const zbx_snmp_oid_t *p_oid, const oid *name, size_t name_length)
+{
+	if (name_length < p_oid->root_oid_len || 0 != memcmp(p_oid->root_oid, name, p_oid->root_oid_len * sizeof(oid)))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+static void	snmp_device_key_add(char **key, size_t *key_alloc, size_t *key_offset, const char *str)
+{
+	str = ZBX_NULL2EMPTY_STR(str);
+	zbx_snprintf_alloc(key, key_alloc, key_offset, ZBX_FS_SIZE_T ":%s", (zbx_fs_size_t)strlen(str), str);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns key identifying device and session parameters of item     *
+ *                                                                            *
+ ******************************************************************************/
+static char	*snmp_device_key(const zbx_snmp_context_t *snmp_context)
+{
+	char	*key = NULL;
+	size_t	key_alloc = 0, key_offset = 0;
+
+	zbx_snprintf_alloc(&key, &key_alloc, &key_offset, "%hu:%d:%d:%d:%d:%d:", snmp_context->item.interface.port,
+			(int)snmp_context->snmp_version, (int)snmp_context->snmpv3_securitylevel,
+			(int)snmp_context->snmpv3_authprotocol, (int)snmp_context->snmpv3_privprotocol,
+			snmp_context->config_timeout);
+
+	snmp_device_key_add(&key, &key_alloc, &key_offset, snmp_context->item.interface.addr);
+	snmp_device_key_add(&key, &key_alloc, &key_offset, snmp_context->snmp_community);
+	snmp_device_key_add(&key, &key_alloc, &key_offset, snmp_context->snmpv3_securityname);
+	snmp_device_key_add(&key, &key_alloc, &key_offset, snmp_context->snmpv3_contextname);
+	snmp_device_key_add(&key, &key_alloc, &key_offset, snmp_context->snmpv3_authpassphrase);
+	snmp_device_key_add(&key, &key_alloc, &key_offset, snmp_context->snmpv3_privpassphrase);
+
+	return key;
+}
+
+static void	snmp_repetitions_clean(void *data)
+{
+	zbx_snmp_repetitions_t	*repetitions = (zbx_snmp_repetitions_t *)data;
+
+	zbx_free(repetitions->device);
+}
+
+static zbx_snmp_repetitions_t	*snmp_repetitions_get(const char *device, int max_repetitions)
+{
+	zbx_snmp_repetitions_t	*repetitions, repetitions_local;
+
+	if (0 == snmp_repetitions_init)
+	{
+		zbx_hashset_create_ext(&snmp_repetitions, 100, ZBX_DEFAULT_STRING_PTR_HASH_FUNC,
+				zbx_default_str_compare_func, snmp_repetitions_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+		snmp_repetitions_init = 1;
+	}
+
+	repetitions_local.device = (char *)device;
+
+	if (NULL == (repetitions = (zbx_snmp_repetitions_t *)zbx_hashset_search(&snmp_repetitions,
+			&repetitions_local)))
+	{
+		repetitions_local.device = zbx_strdup(NULL, device);
+		repetitions_local.ceiling = snmp_repetitions_limit;
+		repetitions_local.max_repetitions = MIN(max_repetitions, snmp_repetitions_limit);
+
+		repetitions = (zbx_snmp_repetitions_t *)zbx_hashset_insert(&snmp_repetitions, &repetitions_local,
+				sizeof(repetitions_local));
+	}
+
+	return repetitions;
+}
+
+static void	snmp_walk_group_free(zbx_snmp_walk_group_t *group)
+{
+	for (int i = 0; i < group->vars.values_num; i++)
+		zbx_free(group->vars.values[i].name);
+
+	zbx_vector_snmp_walk_var_destroy(&group->vars);
+	zbx_vector_snmp_oid_clear_ext(&group->oids, vector_snmp_oid_free);
+	zbx_vector_snmp_oid_destroy(&group->oids);
+	zbx_vector_snmp_context_destroy(&group->members);
+	zbx_free(group);
+}
+
+static int	snmp_walk_group_overlaps(const zbx_snmp_walk_group_t *group, const zbx_vector_snmp_oid_t *oids)
+{
+	for (int i = 0; i < group->oids.values_num; i++)
+	{
+		const zbx_snmp_oid_t	*root = group->oids.values[i];
+
+		for (int j = 0; j < oids->values_num; j++)
+		{
+			const zbx_snmp_oid_t	*p_oid = oids->values[j];
+
+			if (SUCCEED == zbx_snmp_oid_in_subtree(root, p_oid->root_oid, p_oid->root_oid_len) ||
+					SUCCEED == zbx_snmp_oid_in_subtree(p_oid, root->root_oid, root->root_oid_len))
+			{
+				return SUCCEED;
+			}
+		}
+	}
+
+	return FAIL;
+}
+
+static void	snmp_walk_group_merge_oid(zbx_snmp_walk_group_t *group, const zbx_snmp_oid_t *p_oid)
+{
+	zbx_snmp_oid_t	*root;
+
+	for (int i = 0; i < group->oids.values_num; i++)
+	{
+		if (SUCCEED == zbx_snmp_oid_in_subtree(group->oids.values[i], p_oid->root_oid, p_oid->root_oid_len))
+			return;
+	}
+
+	for (int i = 0; i < group->oids.values_num;)
+	{
+		root = group->oids.values[i];
+
+		if (SUCCEED == zbx_snmp_oid_in_subtree(p_oid, root->root_oid, root->root_oid_len))
+		{
+			vector_snmp_oid_free(root);
+			zbx_vector_snmp_oid_remove(&group->oids, i);
+		}
+		else
+			i++;
+	}
+
+	root = (zbx_snmp_oid_t *)zbx_malloc(NULL, sizeof(zbx_snmp_oid_t));
+	memcpy(root->root_oid, p_oid->root_oid, p_oid->root_oid_len * sizeof(oid));
+	root->root_oid_len = p_oid->root_oid_len;
+	root->str_oid = zbx_strdup(NULL, p_oid->str_oid);
+	zbx_vector_snmp_oid_append(&group->oids, root);
+}
+
+static void	snmp_walk_device_clean(void *data)
+{
+	zbx_snmp_walk_device_t	*device = (zbx_snmp_walk_device_t *)data;
+
+	zbx_vector_snmp_walk_group_destroy(&device->groups);
+	zbx_free(device->device);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds walk[] item to group of items with overlapping OID subtrees  *
+ *          of the same device, polled at the end of batch                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_walk_group_add(zbx_snmp_context_t *snmp_context)
+{
+	zbx_snmp_walk_device_t	*device, device_local;
+	zbx_snmp_walk_group_t	*group = NULL;
+
+	if (NULL == snmp_walk_devices)
+	{
+		snmp_walk_devices = (zbx_hashset_t *)zbx_malloc(NULL, sizeof(zbx_hashset_t));
+		zbx_hashset_create_ext(snmp_walk_devices, 10, ZBX_DEFAULT_STRING_PTR_HASH_FUNC,
+				zbx_default_str_compare_func, snmp_walk_device_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+
+	device_local.device = snmp_context->device;
+
+	if (NULL == (device = (zbx_snmp_walk_device_t *)zbx_hashset_search(snmp_walk_devices, &device_local)))
+	{
+		device_local.device = zbx_strdup(NULL, snmp_context->device);
+		zbx_vector_snmp_walk_group_create(&device_local.groups);
+		device = (zbx_snmp_walk_device_t *)zbx_hashset_insert(snmp_walk_devices, &device_local,
+				sizeof(device_local));
+	}
+
+	for (int i = 0; i < device->groups.values_num;)
+	{
+		zbx_snmp_walk_group_t	*overlapping = device->groups.values[i];
+
+		if (SUCCEED != snmp_walk_group_overlaps(overlapping, &snmp_context->param_oids))
+		{
+			i++;
+			continue;
+		}
+
+		if (NULL == group)
+		{
+			group = overlapping;
+			i++;
+			continue;
+		}
+
+		/* item overlaps several groups - they are joined into the first one */
+		for (int j = 0; j < overlapping->oids.values_num; j++)
+			snmp_walk_group_merge_oid(group, overlapping->oids.values[j]);
+
+		zbx_vector_snmp_context_append_array(&group->members, overlapping->members.values,
+				overlapping->members.values_num);
+
+		zbx_vector_snmp_walk_group_remove(&device->groups, i);
+		snmp_walk_group_free(overlapping);
+	}
+
+	if (NULL == group)
+	{
+		group = (zbx_snmp_walk_group_t *)zbx_malloc(NULL, sizeof(zbx_snmp_walk_group_t));
+		zbx_vector_snmp_oid_create(&group->oids);
+		zbx_vector_snmp_context_create(&group->members);
+		zbx_vector_snmp_walk_var_create(&group->vars);
+		zbx_vector_snmp_walk_group_append(&device->groups, group);
+	}
+
+	for (int i = 0; i < snmp_context->param_oids.values_num; i++)
+		snmp_walk_group_merge_oid(group, snmp_context->param_oids.values[i]);
+
+	zbx_vector_snmp_context_append(&group->members, snmp_context);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets result of coalesced walk[] item from walk of merged subtrees *
+ *                                                                            *
+ * Return value: SUCCEED - the result is set                                  *
+ *               FAIL    - nothing was received for OID which lies deeper     *
+ *                         than the walked subtree or walk of the subtree     *
+ *                         failed, item must be polled separately to get the  *
+ *                         same result as without coalescing                  *
+ *                                                                            *
+ * Comments: Failed walk of one subtree does not affect items under other     *
+ *           subtrees of the group.                                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmp_walk_group_set_result(const zbx_snmp_context_t *walker, zbx_snmp_context_t *member)
+{
+	const zbx_vector_snmp_walk_var_t	*vars = &walker->group->vars;
+	const char				*results, *error = NULL;
+	char					*out = NULL, *errors = NULL;
+	size_t					out_alloc = 0, out_offset = 0;
+	int					ret = SUCCEED, walked_root = 1;
+
+	if (SUCCEED != walker->item.ret)
+	{
+		member->item.ret = walker->item.ret;
+
+		if (ZBX_ISSET_MSG(&walker->item.result))
+			SET_MSG_RESULT(&member->item.result, zbx_strdup(NULL, walker->item.result.msg));
+
+		return SUCCEED;
+	}
+
+	results = ZBX_ISSET_TEXT(&walker->item.result) ? walker->item.result.text : "";
+
+	for (int i = 0; i < member->param_oids.values_num; i++)
+	{
+		const zbx_snmp_oid_t	*p_oid = member->param_oids.values[i];
+
+		for (int j = 0; j < walker->bulkwalk_contexts.values_num; j++)
+		{
+			const zbx_bulkwalk_context_t	*bulkwalk_context = walker->bulkwalk_contexts.values[j];
+
+			if (FAIL == zbx_snmp_oid_in_subtree(bulkwalk_context->p_oid, p_oid->root_oid,
+					p_oid->root_oid_len))
+			{
+				continue;
+			}
+
+			if (bulkwalk_context->p_oid->root_oid_len != p_oid->root_oid_len)
+			{
+				walked_root = 0;
+
+				/* walk of larger subtree failed, the OID itself might be fine */
+				if (NULL != bulkwalk_context->error)
+					ret = FAIL;
+			}
+			else if (NULL != bulkwalk_context->error)
+				error = bulkwalk_context->error;
+			else if (NULL != bulkwalk_context->error_msgget)
+				errors = zbx_strdcatf(errors, "%s\n", bulkwalk_context->error_msgget);
+
+			break;
+		}
+
+		for (int j = 0; j < vars->values_num; j++)
+		{
+			const zbx_snmp_walk_var_t	*var = &vars->values[j];
+
+			if (FAIL == zbx_snmp_oid_in_subtree(p_oid, var->name, var->name_length))
+				continue;
+
+			if (NULL != out)
+				zbx_chrcpy_alloc(&out, &out_alloc, &out_offset, '\n');
+
+			zbx_strncpy_alloc(&out, &out_alloc, &out_offset, results + var->offset, var->len);
+		}
+	}
+
+	if (FAIL == ret)
+	{
+		zbx_free(out);
+	}
+	else if (NULL != error)
+	{
+		SET_MSG_RESULT(&member->item.result, zbx_strdup(NULL, error));
+		member->item.ret = NOTSUPPORTED;
+		zbx_free(out);
+	}
+	else if (NULL != out)
+	{
+		SET_TEXT_RESULT(&member->item.result, out);
+		member->item.ret = SUCCEED;
+	}
+	else if (0 == walked_root)
+	{
+		ret = FAIL;
+	}
+	else if (NULL != errors)
+	{
+		SET_MSG_RESULT(&member->item.result, errors);
+		errors = NULL;
+		member->item.ret = NOTSUPPORTED;
+	}
+	else
+	{
+		SET_TEXT_RESULT(&member->item.result, zbx_strdup(NULL, ""));
+		member->item.ret = SUCCEED;
+	}
+
+	zbx_free(errors);
+
+	return ret;
+}
+
+static void	snmp_walk_group_process_result(void *data)
+{
+	zbx_snmp_context_t	*walker = (zbx_snmp_context_t *)data;
+	zbx_snmp_walk_group_t	*group = walker->group;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() items:%d subtrees:%d variables:%d", __func__,
+			group->members.values_num, walker->param_oids.values_num, group->vars.values_num);
+
+	for (int i = 0; i < group->members.values_num; i++)
+	{
+		zbx_snmp_context_t	*member = group->members.values[i];
+
+		if (SUCCEED == snmp_walk_group_set_result(walker, member))
+		{
+			member->process_result_cb(member);
+			continue;
+		}
+
+		zabbix_log(LOG_LEVEL_DEBUG, "itemid:" ZBX_FS_UI64 " no variables in coalesced walk, polling"
+				" separately", member->item.itemid);
+
+		zbx_async_poller_add_task(member->base, member->channel, member->dnsbase, member->item.interface.addr,
+				member, member->config_timeout, async_task_process_task_snmp_cb,
+				member->process_result_cb);
+	}
+
+	walker->group = NULL;
+	snmp_walk_group_free(group);
+	zbx_async_check_snmp_clean(walker);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
+static char	*snmp_strdup_null(const char *str)
+{
+	return NULL != str ? zbx_strdup(NULL, str) : NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates context walking merged subtrees of group with session     *
+ *          parameters of the first item                                      *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_snmp_context_t	*snmp_walk_group_create_walker(zbx_snmp_walk_group_t *group)
+{
+	zbx_snmp_context_t	*walker, *member = group->members.values[0];
+
+	walker = (zbx_snmp_context_t *)zbx_malloc(NULL, sizeof(zbx_snmp_context_t));
+	*walker = *member;
+
+	walker->item.interface.addr = (member->item.interface.addr == member->item.interface.dns_orig ?
+			walker->item.interface.dns_orig : walker->item.interface.ip_orig);
+	walker->item.key = zbx_strdup(NULL, member->item.key);
+	walker->item.key_orig = zbx_strdup(NULL, member->item.key_orig);
+	zbx_init_agent_result(&walker->item.result);
+
+	walker->snmp_community = snmp_strdup_null(member->snmp_community);
+	walker->snmpv3_securityname = snmp_strdup_null(member->snmpv3_securityname);
+	walker->snmpv3_contextname = snmp_strdup_null(member->snmpv3_contextname);
+	walker->snmpv3_authpassphrase = snmp_strdup_null(member->snmpv3_authpassphrase);
+	walker->snmpv3_privpassphrase = snmp_strdup_null(member->snmpv3_privpassphrase);
+	walker->device = zbx_strdup(NULL, member->device);
+	walker->group = group;
+	walker->process_result_cb = snmp_walk_group_process_result;
+
+	zbx_vector_snmp_oid_create(&walker->param_oids);
+	zbx_vector_snmp_oid_append_array(&walker->param_oids, group->oids.values, group->oids.values_num);
+	zbx_vector_snmp_oid_clear(&group->oids);
+	zbx_vector_snmp_oid_sort(&walker->param_oids, (zbx_compare_func_t)zbx_snmp_oid_compare);
+
+	zbx_vector_bulkwalk_context_create(&walker->bulkwalk_contexts);
+
+	for (int i = 0; i < walker->param_oids.values_num; i++)
+	{
+		zbx_vector_bulkwalk_context_append(&walker->bulkwalk_contexts,
+				snmp_bulkwalk_context_create(walker, SNMP_MSG_GETBULK, walker->param_oids.values[i]));
+	}
+
+	return walker;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts collecting walk[] items to be coalesced                    *
+ *                                                                            *
+ * Parameters: max_repetitions_limit - [IN] upper limit of max-repetitions    *
+ *                                          tuning, 0 - disabled              *
+ *                                                                            *
+ * Comments: Walk[] items of the same device with overlapping OID subtrees    *
+ *           checked until zbx_async_check_snmp_batch_end() is called are     *
+ *           polled by single walk of merged subtrees.                        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_check_snmp_batch_begin(int max_repetitions_limit)
+{
+	snmp_repetitions_limit = max_repetitions_limit;
+	snmp_walk_batch = 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts polling of walk[] items collected since                    *
+ *          zbx_async_check_snmp_batch_begin()                                *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_check_snmp_batch_end(void)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_snmp_walk_device_t	*device;
+	int			walks_num = 0, items_num = 0;
+
+	snmp_walk_batch = 0;
+
+	if (NULL == snmp_walk_devices)
+		return;
+
+	zbx_hashset_iter_reset(snmp_walk_devices, &iter);
+
+	while (NULL != (device = (zbx_snmp_walk_device_t *)zbx_hashset_iter_next(&iter)))
+	{
+		for (int i = 0; i < device->groups.values_num; i++)
+		{
+			zbx_snmp_walk_group_t	*group = device->groups.values[i];
+			zbx_snmp_context_t	*snmp_context;
+
+			walks_num++;
+			items_num += group->members.values_num;
+
+			if (1 == group->members.values_num)
+			{
+				snmp_context = group->members.values[0];
+				snmp_walk_group_free(group);
+			}
+			else
+				snmp_context = snmp_walk_group_create_walker(group);
+
+			zbx_async_poller_add_task(snmp_context->base, snmp_context->channel, snmp_context->dnsbase,
+					snmp_context->item.interface.addr, snmp_context, snmp_context->config_timeout,
+					async_task_process_task_snmp_cb, snmp_context->process_result_cb);
+		}
+	}
+
+	zbx_hashset_destroy(snmp_walk_devices);
+	zbx_free(snmp_walk_devices);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() coalesced %d walk items into %d walks", __func__, items_num, walks_num);
+}
+
 int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result,
 		zbx_async_task_process_result_cb_t async_task_process_result_snmp_cb,
 		void *arg, void *arg_action, struct event_base *base, zbx_channel_t *channel,
@@ -3538,6 +4186,13 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result,
 	snmp_context->resolve_reverse_dns = resolve_reverse_dns;
 	snmp_context->step = ZABBIX_ASYNC_STEP_DEFAULT;
 	snmp_context->reverse_dns = NULL;
+	snmp_context->device = NULL;
+	snmp_context->repetitions = NULL;
+	snmp_context->group = NULL;
+	snmp_context->base = base;
+	snmp_context->channel = channel;
+	snmp_context->dnsbase = dnsbase;
+	snmp_context->process_result_cb = async_task_process_result_snmp_cb;
 
 	snmp_context->ssp = NULL;
 	snmp_context->item.interface = item->interface;
@@ -3669,8 +4324,25 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result,
 		zbx_vector_bulkwalk_context_append(&snmp_context->bulkwalk_contexts, bulkwalk_context);
 	}
 
-	zbx_async_poller_add_task(base, channel, dnsbase, snmp_context->item.interface.addr, snmp_context,
-			item->timeout, async_task_process_task_snmp_cb, async_task_process_result_snmp_cb);
+	if (0 != snmp_walk_batch && SNMP_MSG_GETBULK == pdu_type &&
+			ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO == resolve_reverse_dns)
+	{
+		snmp_context->device = snmp_device_key(snmp_context);
+
+		if (0 != snmp_repetitions_limit)
+		{
+			snmp_context->repetitions = snmp_repetitions_get(snmp_context->device,
+					snmp_context->snmp_max_repetitions);
+			snmp_context->snmp_max_repetitions = snmp_context->repetitions->max_repetitions;
+		}
+
+		snmp_walk_group_add(snmp_context);
+	}
+	else
+	{
+		zbx_async_poller_add_task(base, channel, dnsbase, snmp_context->item.interface.addr, snmp_context,
+				item->timeout, async_task_process_task_snmp_cb, async_task_process_result_snmp_cb);
+	}
 
 	ret = SUCCEED;
 out:
@@ -4218,6 +4890,9 @@ void	zbx_clear_cache_snmp(unsigned char process_type, int process_num)
 
 	shutdown_usm();
 
+	if (0 != snmp_repetitions_init)
+		zbx_hashset_clear(&snmp_repetitions);
+
 	if (ZBX_PROCESS_TYPE_SNMP_POLLER == process_type)
 		cached_dev_count = zbx_clear_snmp_engineid_cache();
 
@@ -18,15 +18,34 @@
 #include "zbxjson.h"
 #include "zbxprometheus.h"
 #include "preproc_snmp.h"
+#include "item_preproc.h"
 
-int	pp_cache_get_type(int step_type)
+static pthread_mutex_t	pp_cache_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static zbx_uint64_t	pp_cache_stats_num, pp_cache_stats_size;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get parsed value representation used by preprocessing step        *
+ *                                                                            *
+ * Parameters: step_type - [IN] preprocessing step type                       *
+ *                                                                            *
+ * Return value: The parsed value representation index or FAIL if the step    *
+ *               does not support caching.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_cache_get_data_index(int step_type)
 {
 	switch (step_type)
 	{
+		case ZBX_PREPROC_JSONPATH:
+			return PP_CACHE_DATA_JSON;
+		case ZBX_PREPROC_PROMETHEUS_PATTERN:
 		case ZBX_PREPROC_PROMETHEUS_TO_JSON:
-			return ZBX_PREPROC_PROMETHEUS_PATTERN;
+			return PP_CACHE_DATA_PROMETHEUS;
+		case ZBX_PREPROC_SNMP_WALK_VALUE:
+			return PP_CACHE_DATA_SNMP_WALK;
 		default:
-			return step_type;
+			return FAIL;
 	}
 }
 
@@ -34,61 +53,89 @@ int	pp_cache_get_type(int step_type)
  *                                                                            *
  * Purpose: create preprocessing cache                                        *
  *                                                                            *
- * Parameters: preproc  - [IN] preprocessing data                             *
- *             value    - [IN/OUT] input value - it will copied to cache      *
- *                                 and cleared                                *
+ * Parameters: value - [IN] input value - it will copied to cache             *
  *                                                                            *
- * Return value: The created preprocessing cache                              *
+ * Return value: The created preprocessing cache or NULL if the cache locks   *
+ *               could not be initialized.                                    *
  *                                                                            *
  ******************************************************************************/
-zbx_pp_cache_t	*pp_cache_create(const zbx_pp_item_preproc_t *preproc, const zbx_variant_t *value)
+zbx_pp_cache_t	*pp_cache_create(const zbx_variant_t *value)
 {
 	zbx_pp_cache_t	*cache = (zbx_pp_cache_t *)zbx_malloc(NULL, sizeof(zbx_pp_cache_t));
+	int		err;
 
-	if (0 != preproc->steps_num)
+	for (int i = 0; i < PP_CACHE_DATA_NUM; i++)
 	{
-		cache->type = pp_cache_get_type(preproc->steps[0].type);
+		if (0 != (err = pthread_mutex_init(&cache->data[i].lock, NULL)))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot initialize preprocessing cache mutex: %s",
+					zbx_strerror(err));
+
+			while (0 < i--)
+				pthread_mutex_destroy(&cache->data[i].lock);
+
+			zbx_free(cache);
+			return NULL;
+		}
+
+		cache->data[i].data = NULL;
+		cache->data[i].error = NULL;
+		cache->data[i].size = 0;
 	}
-	else
-		cache->type = ZBX_PREPROC_NONE;
 
 	zbx_variant_copy(&cache->value, value);
-	cache->data = NULL;
 	cache->refcount = 1;
-	cache->error = NULL;
 
 	return cache;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: free preprocessing cache                                          *
+ * Purpose: free parsed value representation                                  *
  *                                                                            *
  ******************************************************************************/
-static void	pp_cache_free(zbx_pp_cache_t *cache)
+static void	pp_cache_data_clear(int index, zbx_pp_cache_data_t *cache_data)
 {
-	zbx_variant_clear(&cache->value);
-
-	if (NULL != cache->data)
+	if (NULL != cache_data->data)
 	{
-		switch (cache->type)
+		switch (index)
 		{
-			case ZBX_PREPROC_JSONPATH:
-				zbx_jsonobj_clear(&((zbx_pp_cache_jsonpath_t *)cache->data)->obj);
-				zbx_jsonpath_index_free(((zbx_pp_cache_jsonpath_t *)cache->data)->index);
+			case PP_CACHE_DATA_JSON:
+				zbx_jsonobj_clear(&((zbx_pp_cache_jsonpath_t *)cache_data->data)->obj);
+				zbx_jsonpath_index_free(((zbx_pp_cache_jsonpath_t *)cache_data->data)->index);
 				break;
-			case ZBX_PREPROC_PROMETHEUS_PATTERN:
-				zbx_prometheus_clear((zbx_prometheus_t *)cache->data);
+			case PP_CACHE_DATA_PROMETHEUS:
+				zbx_prometheus_clear((zbx_prometheus_t *)cache_data->data);
 				break;
-			case ZBX_PREPROC_SNMP_WALK_VALUE:
-				zbx_snmp_value_cache_clear((zbx_snmp_value_cache_t *)cache->data);
+			case PP_CACHE_DATA_SNMP_WALK:
+				zbx_snmp_value_cache_clear((zbx_snmp_value_cache_t *)cache_data->data);
 				break;
 		}
 
-		zbx_free(cache->data);
+		zbx_free(cache_data->data);
+
+		pthread_mutex_lock(&pp_cache_stats_lock);
+		pp_cache_stats_num--;
+		pp_cache_stats_size -= cache_data->size;
+		pthread_mutex_unlock(&pp_cache_stats_lock);
 	}
 
-	zbx_free(cache->error);
+	zbx_free(cache_data->error);
+	pthread_mutex_destroy(&cache_data->lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free preprocessing cache                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_cache_free(zbx_pp_cache_t *cache)
+{
+	zbx_variant_clear(&cache->value);
+
+	for (int i = 0; i < PP_CACHE_DATA_NUM; i++)
+		pp_cache_data_clear(i, &cache->data[i]);
+
 	zbx_free(cache);
 }
 
@@ -122,6 +169,184 @@ zbx_pp_cache_t	*pp_cache_copy(zbx_pp_cache_t *cache)
 	return cache;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse cached value into representation used by preprocessing step *
+ *                                                                            *
+ * Parameters: index - [IN] parsed value representation index                 *
+ *             value - [IN] value to parse                                    *
+ *             error - [OUT] parsing error message                            *
+ *                                                                            *
+ * Return value: The parsed value representation or NULL in the case of       *
+ *               error.                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	*pp_cache_data_parse(int index, const char *value, char **error)
+{
+	zbx_pp_cache_jsonpath_t	*jsonpath;
+	zbx_prometheus_t	*prometheus;
+	zbx_snmp_value_cache_t	*snmp;
+
+	switch (index)
+	{
+		case PP_CACHE_DATA_JSON:
+			jsonpath = (zbx_pp_cache_jsonpath_t *)zbx_malloc(NULL, sizeof(zbx_pp_cache_jsonpath_t));
+
+			if (SUCCEED != zbx_jsonobj_open(value, &jsonpath->obj))
+			{
+				*error = zbx_strdup(NULL, zbx_json_strerror());
+				zbx_free(jsonpath);
+				return NULL;
+			}
+
+			if (NULL == (jsonpath->index = zbx_jsonpath_index_create(error)))
+			{
+				zbx_jsonobj_clear(&jsonpath->obj);
+				zbx_free(jsonpath);
+				return NULL;
+			}
+
+			return jsonpath;
+		case PP_CACHE_DATA_PROMETHEUS:
+			prometheus = (zbx_prometheus_t *)zbx_malloc(NULL, sizeof(zbx_prometheus_t));
+
+			if (SUCCEED != zbx_prometheus_init(prometheus, value, error))
+			{
+				zbx_free(prometheus);
+				return NULL;
+			}
+
+			return prometheus;
+		case PP_CACHE_DATA_SNMP_WALK:
+			snmp = (zbx_snmp_value_cache_t *)zbx_malloc(NULL, sizeof(zbx_snmp_value_cache_t));
+
+			if (SUCCEED != zbx_snmp_value_cache_init(snmp, value, error))
+			{
+				zbx_free(snmp);
+				return NULL;
+			}
+
+			return snmp;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			*error = zbx_strdup(NULL, "unsupported preprocessing cache type");
+			return NULL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get memory allocated for parsed value representation              *
+ *                                                                            *
+ * Parameters: index - [IN] parsed value representation index                 *
+ *             data  - [IN] parsed value representation                       *
+ *                                                                            *
+ * Comments: Indexes built on demand by queries are not included.             *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	pp_cache_data_size(int index, const void *data)
+{
+	switch (index)
+	{
+		case PP_CACHE_DATA_JSON:
+			return sizeof(zbx_pp_cache_jsonpath_t) +
+					zbx_jsonobj_get_size(&((const zbx_pp_cache_jsonpath_t *)data)->obj);
+		case PP_CACHE_DATA_PROMETHEUS:
+			return sizeof(zbx_prometheus_t) + zbx_prometheus_get_size((const zbx_prometheus_t *)data);
+		case PP_CACHE_DATA_SNMP_WALK:
+			return sizeof(zbx_snmp_value_cache_t) +
+					zbx_snmp_value_cache_get_size((const zbx_snmp_value_cache_t *)data);
+		default:
+			return 0;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get cached value representation used by preprocessing step        *
+ *                                                                            *
+ * Parameters: cache     - [IN] preprocessing cache                           *
+ *             step_type - [IN] preprocessing step type                       *
+ *             error     - [OUT] error message                                *
+ *                                                                            *
+ * Return value: The parsed value representation or NULL in the case of       *
+ *               error.                                                       *
+ *                                                                            *
+ * Comments: The cached value is parsed by the first step requesting the      *
+ *           representation, while other workers requesting the same          *
+ *           representation wait for it to be parsed. Different               *
+ *           representations of the same value can be parsed in parallel.     *
+ *           Parsing errors are cached and returned to all dependent items.   *
+ *                                                                            *
+ *           The returned data is shared between workers and must not be      *
+ *           modified.                                                        *
+ *                                                                            *
+ ******************************************************************************/
+void	*pp_cache_get_data(zbx_pp_cache_t *cache, int step_type, char **error)
+{
+	zbx_pp_cache_data_t	*cache_data;
+	int			index;
+	void			*data;
+
+	if (FAIL == (index = pp_cache_get_data_index(step_type)))
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		*error = zbx_strdup(*error, "unsupported preprocessing cache type");
+		return NULL;
+	}
+
+	cache_data = &cache->data[index];
+
+	pthread_mutex_lock(&cache_data->lock);
+
+	if (NULL == cache_data->data && NULL == cache_data->error)
+	{
+		zbx_variant_t	value;
+
+		zbx_variant_copy(&value, &cache->value);
+
+		if (SUCCEED == item_preproc_convert_value(&value, ZBX_VARIANT_STR, error))
+		{
+			if (NULL != (cache_data->data = pp_cache_data_parse(index, value.data.str, &cache_data->error)))
+			{
+				cache_data->size = pp_cache_data_size(index, cache_data->data);
+
+				pthread_mutex_lock(&pp_cache_stats_lock);
+				pp_cache_stats_num++;
+				pp_cache_stats_size += cache_data->size;
+				pthread_mutex_unlock(&pp_cache_stats_lock);
+			}
+		}
+
+		zbx_variant_clear(&value);
+	}
+
+	if (NULL != cache_data->error)
+		*error = zbx_strdup(*error, cache_data->error);
+
+	data = cache_data->data;
+
+	pthread_mutex_unlock(&cache_data->lock);
+
+	return data;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get statistics of parsed values shared by dependent items         *
+ *                                                                            *
+ * Parameters: num  - [OUT] number of parsed value representations            *
+ *             size - [OUT] total size of parsed values                       *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_cache_get_stats(zbx_uint64_t *num, zbx_uint64_t *size)
+{
+	pthread_mutex_lock(&pp_cache_stats_lock);
+	*num = pp_cache_stats_num;
+	*size = pp_cache_stats_size;
+	pthread_mutex_unlock(&pp_cache_stats_lock);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: copy original value from cache if needed                          *
@@ -130,14 +355,14 @@ zbx_pp_cache_t	*pp_cache_copy(zbx_pp_cache_t *cache)
  *             step_type - [IN] preprocessing step type                       *
  *             value     - [OUT] output value                                 *
  *                                                                            *
- * Comments: The value is copied from preprocessing cache if cache exists and *
- *           cache is not initialized or wrong preprocessing step type is     *
- *           cached. Otherwise the cache will be used to execute the step.    *
+ * Comments: The value is copied from preprocessing cache if the step cannot  *
+ *           use cached value representation or the cached value is error.    *
+ *           Otherwise the cache will be used to execute the step.            *
  *                                                                            *
  ******************************************************************************/
 void	pp_cache_prepare_output_value(zbx_pp_cache_t *cache, int step_type, zbx_variant_t *value)
 {
-	if (NULL == cache->data || pp_cache_get_type(step_type) != cache->type)
+	if (ZBX_VARIANT_ERR == cache->value.type || FAIL == pp_cache_get_data_index(step_type))
 		zbx_variant_copy(value, &cache->value);
 }
 
@@ -154,17 +379,8 @@ void	pp_cache_prepare_output_value(zbx_pp_cache_t *cache, int step_type, zbx_var
  ******************************************************************************/
 int	pp_cache_is_supported(zbx_pp_item_preproc_t *preproc)
 {
-	if (0 < preproc->steps_num)
-	{
-		switch (preproc->steps[0].type)
-		{
-			case ZBX_PREPROC_JSONPATH:
-			case ZBX_PREPROC_PROMETHEUS_PATTERN:
-			case ZBX_PREPROC_PROMETHEUS_TO_JSON:
-			case ZBX_PREPROC_SNMP_WALK_VALUE:
-				return SUCCEED;
-		}
-	}
+	if (0 < preproc->steps_num && FAIL != pp_cache_get_data_index(preproc->steps[0].type))
+		return SUCCEED;
 
 	return FAIL;
 }
@@ -26,20 +26,34 @@ typedef struct
 }
 zbx_pp_cache_jsonpath_t;
 
+/* parsed value representations that can be shared by dependent items */
+#define PP_CACHE_DATA_JSON		0
+#define PP_CACHE_DATA_PROMETHEUS	1
+#define PP_CACHE_DATA_SNMP_WALK		2
+#define PP_CACHE_DATA_NUM		3
+
 typedef struct
 {
-	zbx_uint32_t	refcount;
-	zbx_variant_t	value;
-	int		type;
+	pthread_mutex_t	lock;
 	void		*data;
 	char		*error;
+	zbx_uint64_t	size;		/* size of parsed value */
+}
+zbx_pp_cache_data_t;
+
+typedef struct
+{
+	zbx_uint32_t		refcount;
+	zbx_variant_t		value;
+	zbx_pp_cache_data_t	data[PP_CACHE_DATA_NUM];
 }
 zbx_pp_cache_t;
 
-int	pp_cache_get_type(int step_type);
-zbx_pp_cache_t	*pp_cache_create(const zbx_pp_item_preproc_t *preproc, const zbx_variant_t *value);
+zbx_pp_cache_t	*pp_cache_create(const zbx_variant_t *value);
 void		pp_cache_release(zbx_pp_cache_t *cache);
 zbx_pp_cache_t	*pp_cache_copy(zbx_pp_cache_t *cache);
+void		*pp_cache_get_data(zbx_pp_cache_t *cache, int step_type, char **error);
+void		pp_cache_get_stats(zbx_uint64_t *num, zbx_uint64_t *size);
 
 void	pp_cache_prepare_output_value(zbx_pp_cache_t *cache, int step_type, zbx_variant_t *value);
 int	pp_cache_is_supported(zbx_pp_item_preproc_t *preproc);
@@ -78,12 +78,12 @@ int	zbx_diag_add_preproc_info(const struct zbx_json_parse *jp, struct zbx_json *
 		if (0 != (fields & ZBX_DIAG_PREPROC_SIMPLE))
 		{
 			zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num, queued_num, queued_sz,
-					direct_num, direct_sz, history_sz;
+					direct_num, direct_sz, history_sz, cache_num, cache_sz;
 
 			time1 = zbx_time();
 			if (FAIL == (ret = zbx_preprocessor_get_diag_stats(&preproc_num, &pending_num, &finished_num,
 					&sequences_num, &queued_num, &queued_sz, &direct_num, &direct_sz,
-					&history_sz, error)))
+					&history_sz, &cache_num, &cache_sz, error)))
 			{
 				goto out;
 			}
@@ -102,6 +102,8 @@ int	zbx_diag_add_preproc_info(const struct zbx_json_parse *jp, struct zbx_json *
 				zbx_json_adduint64(json, "direct count", direct_num);
 				zbx_json_adduint64(json, "direct size", direct_sz);
 				zbx_json_adduint64(json, "history size", history_sz);
+				zbx_json_adduint64(json, "cache count", cache_num);
+				zbx_json_adduint64(json, "cache size", cache_sz);
 			}
 		}
 
@@ -239,7 +239,8 @@ static int	pp_execute_regsub(zbx_variant_t *value, const char *params)
  *                                                                            *
  * Purpose: execute jsonpath query                                            *
  *                                                                            *
- * Parameters: cache  - [IN] preprocessing cache                              *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             cache  - [IN] preprocessing cache                              *
  *             value  - [IN/OUT] value to process                             *
  *             params - [IN] step parameters                                  *
  *             errmsg - [OUT]                                                 *
@@ -248,70 +249,60 @@ static int	pp_execute_regsub(zbx_variant_t *value, const char *params)
  *               FAIL    - otherwise.                                         *
  *                                                                            *
  ******************************************************************************/
-static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value, const char *params,
-		char **errmsg)
+static int	pp_excute_jsonpath_query(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_variant_t *value,
+		const char *params, char **errmsg)
 {
-	char	*data = NULL;
+	char		*data = NULL;
+	zbx_jsonpath_t	*jsonpath;
+	int		ret;
 
-	if (NULL == cache || ZBX_PREPROC_JSONPATH != cache->type)
+	if (NULL == cache)
 	{
 		zbx_jsonobj_t	obj;
 
 		if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 			return FAIL;
 
-		if (FAIL == zbx_jsonobj_open(value->data.str, &obj))
+		/* simple definite paths are resolved by scanning the value without parsing it */
+		if (NULL != (jsonpath = pp_context_jsonpath(ctx, params)))
+			ret = zbx_jsonpath_query_data(value->data.str, jsonpath, &data);
+		else
+			ret = NOTSUPPORTED;
+
+		if (NOTSUPPORTED == ret)
 		{
-			*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
-			return FAIL;
+			if (FAIL == zbx_jsonobj_open(value->data.str, &obj))
+			{
+				*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
+				return FAIL;
+			}
+
+			if (NULL != jsonpath)
+				ret = zbx_jsonobj_query_compiled(&obj, NULL, jsonpath, &data);
+			else
+				ret = zbx_jsonobj_query(&obj, params, &data);
+
+			zbx_jsonobj_clear(&obj);
 		}
 
-		if (FAIL == zbx_jsonobj_query(&obj, params, &data))
+		if (FAIL == ret)
 		{
-			zbx_jsonobj_clear(&obj);
 			*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
 			return FAIL;
 		}
-
-		zbx_jsonobj_clear(&obj);
 	}
 	else
 	{
 		zbx_pp_cache_jsonpath_t	*index;
 
-		if (NULL != cache->error)
+		if (NULL == (index = (zbx_pp_cache_jsonpath_t *)pp_cache_get_data(cache, ZBX_PREPROC_JSONPATH,
+				errmsg)))
 		{
-			*errmsg = zbx_strdup(NULL, cache->error);
 			return FAIL;
 		}
 
-		if (NULL == (index = (zbx_pp_cache_jsonpath_t *)cache->data))
-		{
-			if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
-				return FAIL;
-
-			index = (zbx_pp_cache_jsonpath_t *)zbx_malloc(NULL, sizeof(zbx_pp_cache_jsonpath_t));
-
-			if (SUCCEED != zbx_jsonobj_open(value->data.str, &index->obj))
-			{
-				cache->error = zbx_strdup(NULL, zbx_json_strerror());
-				*errmsg = zbx_strdup(NULL, cache->error);
-				zbx_free(index);
-				return FAIL;
-			}
-
-			if (NULL == (index->index = zbx_jsonpath_index_create(errmsg)))
-			{
-				zbx_jsonobj_clear(&index->obj);
-				zbx_free(index);
-				cache->type = ZBX_PREPROC_NONE;
-				return FAIL;
-			}
-
-			cache->data = (void *)index;
-		}
-
-		if (FAIL == zbx_jsonobj_query_ext(&index->obj, index->index, params, &data))
+		if (NULL == (jsonpath = pp_context_jsonpath(ctx, params)) ||
+				FAIL == zbx_jsonobj_query_compiled(&index->obj, index->index, jsonpath, &data))
 		{
 			*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
 			return FAIL;
@@ -334,7 +325,8 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
  *                                                                            *
  * Purpose: execute 'jsonpath' step                                           *
  *                                                                            *
- * Parameters: cache  - [IN] preprocessing cache                              *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             cache  - [IN] preprocessing cache                              *
  *             value  - [IN/OUT] value to process                             *
  *             params - [IN] step parameters                                  *
  *                                                                            *
@@ -342,12 +334,13 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
  *               FAIL    - otherwise. The error message is stored in value.   *
  *                                                                            *
  ******************************************************************************/
-static int	pp_execute_jsonpath(zbx_pp_cache_t *cache, zbx_variant_t *value, const char *params)
+static int	pp_execute_jsonpath(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_variant_t *value,
+		const char *params)
 {
 	char	*errmsg = NULL, *error = NULL;
 	size_t	error_alloc = 0, error_offset = 0;
 
-	if (SUCCEED == pp_excute_jsonpath_query(cache, value, params, &errmsg))
+	if (SUCCEED == pp_excute_jsonpath_query(ctx, cache, value, params, &errmsg))
 		return SUCCEED;
 
 	zbx_variant_clear(value);
@@ -719,7 +712,7 @@ static int	pp_execute_prometheus_query(zbx_pp_cache_t *cache, zbx_variant_t *val
 	}
 	*output++ = '\0';
 
-	if (NULL == cache || ZBX_PREPROC_PROMETHEUS_PATTERN != cache->type)
+	if (NULL == cache)
 	{
 		if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 			goto out;
@@ -730,29 +723,12 @@ static int	pp_execute_prometheus_query(zbx_pp_cache_t *cache, zbx_variant_t *val
 	{
 		zbx_prometheus_t	*prom_cache;
 
-		if (NULL != cache->error)
+		if (NULL == (prom_cache = (zbx_prometheus_t *)pp_cache_get_data(cache,
+				ZBX_PREPROC_PROMETHEUS_PATTERN, &err)))
 		{
-			err = zbx_strdup(NULL, cache->error);
 			goto out;
 		}
 
-		if (NULL == (prom_cache = (zbx_prometheus_t *)cache->data))
-		{
-			if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
-				goto out;
-
-			prom_cache = (zbx_prometheus_t *)zbx_malloc(NULL, sizeof(zbx_prometheus_t));
-
-			if (SUCCEED != zbx_prometheus_init(prom_cache, value->data.str, &cache->error))
-			{
-				zbx_free(prom_cache);
-				err = zbx_strdup(NULL, cache->error);
-				goto out;
-			}
-
-			cache->data = (void *)prom_cache;
-		}
-
 		ret = zbx_prometheus_pattern_ex(prom_cache, pattern, request, output, &value_out, &err);
 	}
 
@@ -817,7 +793,7 @@ static int	pp_execute_prometheus_to_json_conversion(zbx_pp_cache_t *cache, zbx_v
 	char	*value_out = NULL, *err = NULL;
 	int	ret = FAIL;
 
-	if (NULL == cache || ZBX_PREPROC_PROMETHEUS_PATTERN != cache->type)
+	if (NULL == cache)
 	{
 		if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 			goto out;
@@ -828,29 +804,12 @@ static int	pp_execute_prometheus_to_json_conversion(zbx_pp_cache_t *cache, zbx_v
 	{
 		zbx_prometheus_t	*prom_cache;
 
-		if (NULL != cache->error)
+		if (NULL == (prom_cache = (zbx_prometheus_t *)pp_cache_get_data(cache,
+				ZBX_PREPROC_PROMETHEUS_TO_JSON, &err)))
 		{
-			err = zbx_strdup(NULL, cache->error);
 			goto out;
 		}
 
-		if (NULL == (prom_cache = (zbx_prometheus_t *)cache->data))
-		{
-			if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
-				goto out;
-
-			prom_cache = (zbx_prometheus_t *)zbx_malloc(NULL, sizeof(zbx_prometheus_t));
-
-			if (SUCCEED != zbx_prometheus_init(prom_cache, value->data.str, &cache->error))
-			{
-				zbx_free(prom_cache);
-				err = zbx_strdup(NULL, cache->error);
-				goto out;
-			}
-
-			cache->data = (void *)prom_cache;
-		}
-
 		ret = zbx_prometheus_to_json_ex(prom_cache, params, &value_out, &err);
 	}
 
@@ -1111,7 +1070,7 @@ int	pp_execute_step(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_dc_um_shar
 			ret = pp_execute_xpath(value, params);
 			goto out;
 		case ZBX_PREPROC_JSONPATH:
-			ret = pp_execute_jsonpath(cache, value, params);
+			ret = pp_execute_jsonpath(ctx, cache, value, params);
 			goto out;
 		case ZBX_PREPROC_VALIDATE_RANGE:
 			ret = pp_validate_range(value_type, value, params);
@@ -1349,10 +1308,21 @@ void	pp_context_init(zbx_pp_context_t *ctx)
 	memset(ctx, 0, sizeof(zbx_pp_context_t));
 }
 
+static void	pp_jsonpath_clear(void *d)
+{
+	zbx_pp_jsonpath_t	*jsonpath = (zbx_pp_jsonpath_t *)d;
+
+	zbx_free(jsonpath->path);
+	zbx_jsonpath_clear(&jsonpath->jsonpath);
+}
+
 void	pp_context_destroy(zbx_pp_context_t *ctx)
 {
 	if (0 != ctx->es_initialized)
 		zbx_es_destroy(&ctx->es_engine);
+
+	if (0 != ctx->jsonpaths_initialized)
+		zbx_hashset_destroy(&ctx->jsonpaths);
 }
 
 zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx)
@@ -1365,3 +1335,50 @@ zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx)
 
 	return &ctx->es_engine;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compiled jsonpath from preprocessing context cache            *
+ *                                                                            *
+ * Parameters: ctx  - [IN] preprocessing context                              *
+ *             path - [IN] jsonpath                                           *
+ *                                                                            *
+ * Return value: The compiled jsonpath or NULL if the path compilation        *
+ *               failed. The compilation error can be retrieved with          *
+ *               zbx_json_strerror().                                         *
+ *                                                                            *
+ * Comments: The compiled paths are cached per worker by the path text with   *
+ *           user macros already resolved. The cache is reset when it grows   *
+ *           over the limit to drop paths that are not used anymore.          *
+ *                                                                            *
+ ******************************************************************************/
+zbx_jsonpath_t	*pp_context_jsonpath(zbx_pp_context_t *ctx, const char *path)
+{
+#define PP_JSONPATH_CACHE_MAX	4096
+	zbx_pp_jsonpath_t	*jsonpath, jsonpath_local;
+
+	if (0 == ctx->jsonpaths_initialized)
+	{
+		zbx_hashset_create_ext(&ctx->jsonpaths, 0, ZBX_DEFAULT_STRING_PTR_HASH_FUNC,
+				ZBX_DEFAULT_STR_PTR_COMPARE_FUNC, pp_jsonpath_clear, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+		ctx->jsonpaths_initialized = 1;
+	}
+
+	jsonpath_local.path = (char *)path;
+
+	if (NULL != (jsonpath = (zbx_pp_jsonpath_t *)zbx_hashset_search(&ctx->jsonpaths, &jsonpath_local)))
+		return &jsonpath->jsonpath;
+
+	if (FAIL == zbx_jsonpath_compile(path, &jsonpath_local.jsonpath))
+		return NULL;
+
+	if (PP_JSONPATH_CACHE_MAX <= ctx->jsonpaths.num_data)
+		zbx_hashset_clear(&ctx->jsonpaths);
+
+	jsonpath_local.path = zbx_strdup(NULL, path);
+	jsonpath = (zbx_pp_jsonpath_t *)zbx_hashset_insert(&ctx->jsonpaths, &jsonpath_local, sizeof(jsonpath_local));
+
+	return &jsonpath->jsonpath;
+#undef PP_JSONPATH_CACHE_MAX
+}
@@ -21,17 +21,30 @@
 #include "zbxtime.h"
 #include "zbxcacheconfig.h"
 #include "zbxpreprocbase.h"
+#include "zbxjson.h"
+#include "zbxalgo.h"
+
+typedef struct
+{
+	char		*path;
+	zbx_jsonpath_t	jsonpath;
+}
+zbx_pp_jsonpath_t;
 
 typedef struct
 {
 	int		es_initialized;
 	zbx_es_t	es_engine;
+
+	int		jsonpaths_initialized;
+	zbx_hashset_t	jsonpaths;	/* compiled jsonpaths, zbx_pp_jsonpath_t */
 }
 zbx_pp_context_t;
 
 void		pp_context_init(zbx_pp_context_t *ctx);
 void		pp_context_destroy(zbx_pp_context_t *ctx);
 zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx);
+zbx_jsonpath_t	*pp_context_jsonpath(zbx_pp_context_t *ctx, const char *path);
 
 void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_cache_t *cache,
 		zbx_dc_um_shared_handle_t *um_handle, zbx_variant_t *value_in, zbx_timespec_t ts,
@@ -144,7 +144,7 @@ static zbx_pp_manager_t	*zbx_pp_manager_create(int workers_num, zbx_pp_finished_
 	manager = (zbx_pp_manager_t *)zbx_malloc(NULL, sizeof(zbx_pp_manager_t));
 	memset(manager, 0, sizeof(zbx_pp_manager_t));
 
-	if (SUCCEED != pp_task_queue_init(&manager->queue, error))
+	if (SUCCEED != pp_task_queue_init(&manager->queue, workers_num, error))
 		goto out;
 
 	manager->timekeeper = zbx_timekeeper_create(workers_num, NULL);
@@ -396,12 +396,13 @@ static void	pp_manager_queue_dependents(zbx_pp_manager_t *manager, zbx_pp_item_p
 	cache = pp_cache_copy(cache);
 
 	if (NULL == cache)
-		cache = pp_cache_create(preproc, value);
+		cache = pp_cache_create(value);
 
 	for (int i = 0; i < preproc->dep_itemids_num; i++)
 	{
 		zbx_pp_item_t	*item;
 		zbx_pp_task_t	*new_task;
+		zbx_variant_t	value_copy, *task_value = NULL;
 
 		/* skip already preprocessed dependent item */
 		if (preproc->dep_itemids[i] == exclude_itemid)
@@ -411,14 +412,21 @@ static void	pp_manager_queue_dependents(zbx_pp_manager_t *manager, zbx_pp_item_p
 		if (NULL == (item = (zbx_pp_item_t *)zbx_hashset_search(&manager->items, &preproc->dep_itemids[i])))
 			continue;
 
+		/* without cache every dependent item gets its own copy of the value */
+		if (NULL == cache)
+		{
+			zbx_variant_copy(&value_copy, value);
+			task_value = &value_copy;
+		}
+
 		if (ZBX_PP_PROCESS_PARALLEL == item->preproc->mode)
 		{
-			new_task = pp_task_value_create(item->itemid, item->preproc, um_handle, NULL, ts, NULL,
+			new_task = pp_task_value_create(item->itemid, item->preproc, um_handle, task_value, ts, NULL,
 					cache);
 		}
 		else
 		{
-			new_task = pp_task_value_seq_create(item->itemid, item->preproc, um_handle, NULL, ts,
+			new_task = pp_task_value_seq_create(item->itemid, item->preproc, um_handle, task_value, ts,
 					NULL, cache);
 		}
 
@@ -447,6 +455,7 @@ static void	pp_manager_queue_value_task_result(zbx_pp_manager_t *manager, zbx_pp
 {
 	zbx_pp_task_value_t	*d = (zbx_pp_task_value_t *)PP_TASK_DATA(task);
 	zbx_pp_item_t		*item;
+	zbx_pp_cache_t		*cache;
 
 	d->preproc->time_ms = task->time_ms;
 	d->preproc->total_ms += task->time_ms;
@@ -455,7 +464,7 @@ static void	pp_manager_queue_value_task_result(zbx_pp_manager_t *manager, zbx_pp
 		return;
 
 	if (NULL != (item = pp_manager_get_cacheable_dependent_item(manager, d->preproc->dep_itemids,
-			d->preproc->dep_itemids_num)))
+			d->preproc->dep_itemids_num)) && NULL != (cache = pp_cache_create(&d->result)))
 	{
 		zbx_pp_task_t	*dep_task;
 		zbx_variant_t	value;
@@ -463,7 +472,7 @@ static void	pp_manager_queue_value_task_result(zbx_pp_manager_t *manager, zbx_pp
 		dep_task = pp_task_dependent_create(item->itemid, d->preproc);
 		zbx_pp_task_dependent_t	*d_dep = (zbx_pp_task_dependent_t *)PP_TASK_DATA(dep_task);
 
-		d_dep->cache = pp_cache_create(item->preproc, &d->result);
+		d_dep->cache = cache;
 		zbx_variant_set_none(&value);
 
 		d_dep->primary = pp_task_value_create(item->itemid, item->preproc, d->um_handle, &value, d->ts,
@@ -603,9 +612,7 @@ static void	zbx_pp_manager_process_finished(zbx_pp_manager_t *manager, zbx_vecto
 		zbx_vector_pp_task_ptr_append(tasks, task);
 	}
 
-	*pending_num = manager->queue.pending_num;
-	*finished_num = manager->queue.finished_num;
-	*processing_num = manager->queue.processing_num;
+	pp_task_queue_get_stats(&manager->queue, pending_num, processing_num, finished_num);
 
 	pp_task_queue_unlock(&manager->queue);
 	zbx_prof_end();
@@ -677,10 +684,14 @@ zbx_hashset_t  *zbx_pp_manager_items(zbx_pp_manager_t *manager)
 static void	zbx_pp_manager_get_diag_stats(zbx_pp_manager_t *manager, zbx_uint64_t *preproc_num,
 		zbx_uint64_t *pending_num, zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num)
 {
+	zbx_uint64_t	processing_num;
+
 	*preproc_num = (zbx_uint64_t)manager->items.num_data;
-	*pending_num = manager->queue.pending_num;
-	*finished_num = manager->queue.finished_num;
+
+	pp_task_queue_lock(&manager->queue);
+	pp_task_queue_get_stats(&manager->queue, pending_num, &processing_num, finished_num);
 	*sequences_num = (zbx_uint64_t)manager->queue.sequences.num_data;
+	pp_task_queue_unlock(&manager->queue);
 }
 
 /******************************************************************************
@@ -772,116 +783,77 @@ static void	preprocessor_sync_configuration(zbx_pp_manager_t *manager)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: frees resources allocated by preprocessor item value              *
+ * Purpose: copy string from value batch arena                                *
  *                                                                            *
- * Parameters: value - [IN] value to be freed                                 *
+ * Parameters: arena  - [IN] value batch arena                                *
+ *             offset - [IN] string offset in arena                           *
+ *             len    - [IN] string length                                    *
+ *                                                                            *
+ * Return value: copied string or NULL if no string was packed                *
  *                                                                            *
  ******************************************************************************/
-static void	preproc_item_value_clear(zbx_preproc_item_value_t *value)
+static char	*preproc_arena_strdup(const char *arena, zbx_uint32_t offset, zbx_uint32_t len)
 {
-	zbx_free(value->error);
-	zbx_free(value->ts);
+	char	*str;
 
-	if (NULL != value->result)
-	{
-		zbx_free_agent_result(value->result);
-		zbx_free(value->result);
-	}
+	if (UINT32_MAX == offset)
+		return NULL;
+
+	str = (char *)zbx_malloc(NULL, (size_t)len + 1);
+	memcpy(str, arena + offset, (size_t)len + 1);
+
+	return str;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: extract value, timestamp and optional data from preprocessing     *
- *          item value.                                                       *
+ * Purpose: extract value, timestamp and optional data from packed            *
+ *          preprocessing item value                                          *
  *                                                                            *
- * Parameters: value - [IN] preprocessing item value                          *
+ * Parameters: value - [IN] packed preprocessing item value                   *
+ *             arena - [IN] value batch arena                                 *
  *             var   - [OUT] extracted value (including error message)        *
  *             ts    - [OUT] extracted timestamp                              *
  *             opt   - [OUT] extracted optional data                          *
  *                                                                            *
  ******************************************************************************/
-static void	preproc_item_value_extract_data(zbx_preproc_item_value_t *value, zbx_variant_t *var, zbx_timespec_t *ts,
-		zbx_pp_value_opt_t *opt)
+static void	preproc_packed_value_extract_data(const zbx_pp_packed_value_t *value, const char *arena,
+		zbx_variant_t *var, zbx_timespec_t *ts, zbx_pp_value_opt_t *opt)
 {
-	opt->flags = ZBX_PP_VALUE_OPT_NONE;
-
-	if (NULL != value->ts)
-	{
-		*ts = *value->ts;
-	}
-	else
-	{
-		ts->sec = 0;
-		ts->ns = 0;
-	}
-
-	if (ITEM_STATE_NOTSUPPORTED == value->state)
-	{
-		if (NULL != value->error)
-		{
-			zbx_variant_set_error(var, value->error);
-			value->error = NULL;
-		}
-		else if (NULL != value->result && ZBX_ISSET_MSG(value->result))
-			zbx_variant_set_error(var, zbx_strdup(NULL, value->result->msg));
-		else
-			zbx_variant_set_error(var, zbx_strdup(NULL, "Unknown error."));
+	*ts = value->ts;
+	opt->flags = value->opt_flags;
 
-		return;
-	}
-
-	if (NULL == value->result)
+	switch (value->type)
 	{
-		zbx_variant_set_none(var);
-		return;
+		case ZBX_VARIANT_UI64:
+			zbx_variant_set_ui64(var, value->ui64);
+			break;
+		case ZBX_VARIANT_DBL:
+			zbx_variant_set_dbl(var, value->dbl);
+			break;
+		case ZBX_VARIANT_STR:
+			zbx_variant_set_str(var, preproc_arena_strdup(arena, value->value_offset, value->value_len));
+			break;
+		case ZBX_VARIANT_ERR:
+			zbx_variant_set_error(var, preproc_arena_strdup(arena, value->value_offset,
+					value->value_len));
+			break;
+		default:
+			zbx_variant_set_none(var);
 	}
 
-	if (ZBX_ISSET_LOG(value->result))
-	{
-		zbx_variant_set_str(var, value->result->log->value);
-		value->result->log->value = NULL;
-
-		opt->source = value->result->log->source;
-		value->result->log->source = NULL;
-
-		opt->logeventid = value->result->log->logeventid;
-		opt->severity = value->result->log->severity;
-		opt->timestamp = value->result->log->timestamp;
-
-		opt->flags |= ZBX_PP_VALUE_OPT_LOG;
-	}
-	else if (ZBX_ISSET_UI64(value->result))
-	{
-		zbx_variant_set_ui64(var, value->result->ui64);
-	}
-	else if (ZBX_ISSET_DBL(value->result))
-	{
-		zbx_variant_set_dbl(var, value->result->dbl);
-	}
-	else if (ZBX_ISSET_STR(value->result))
-	{
-		zbx_variant_set_str(var, value->result->str);
-		value->result->str = NULL;
-	}
-	else if (ZBX_ISSET_TEXT(value->result))
-	{
-		zbx_variant_set_str(var, value->result->text);
-		value->result->text = NULL;
-	}
-	else if (ZBX_ISSET_BIN(value->result))
+	if (0 != (opt->flags & ZBX_PP_VALUE_OPT_LOG))
 	{
-		THIS_SHOULD_NEVER_HAPPEN;
-		exit(EXIT_FAILURE);
+		opt->source = preproc_arena_strdup(arena, value->source_offset, value->source_len);
+		opt->logeventid = value->logeventid;
+		opt->severity = value->severity;
+		opt->timestamp = value->timestamp;
 	}
-	else
-		zbx_variant_set_none(var);
 
-	if (ZBX_ISSET_META(value->result))
+	if (0 != (opt->flags & ZBX_PP_VALUE_OPT_META))
 	{
-		opt->lastlogsize = value->result->lastlogsize;
-		opt->mtime = value->result->mtime;
-
-		opt->flags |= ZBX_PP_VALUE_OPT_META;
+		opt->lastlogsize = value->lastlogsize;
+		opt->mtime = value->mtime;
 	}
 }
 
@@ -900,34 +872,37 @@ static void	preproc_item_value_extract_data(zbx_preproc_item_value_t *value, zbx
 static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_message_t *message,
 		zbx_uint64_t *direct_num, zbx_uint64_t *direct_sz, zbx_vector_pp_task_ptr_t *tasks)
 {
-	zbx_uint32_t			offset = 0;
-	zbx_preproc_item_value_t	value;
+	const zbx_pp_packed_value_t	*values;
+	const char			*arena;
+	int				values_num;
 	zbx_uint64_t			queued_num;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	preprocessor_sync_configuration(manager);
 
-	while (offset < message->size)
+	values_num = zbx_preprocessor_unpack_value_batch(message->data, message->size, &values, &arena);
+	zbx_vector_pp_task_ptr_reserve(tasks, (size_t)values_num);
+
+	for (int i = 0; i < values_num; i++)
 	{
-		zbx_uint32_t		offset_prev = offset;
-		zbx_uint64_t		sz;
-		zbx_variant_t		var;
-		zbx_pp_value_opt_t	var_opt;
-		zbx_timespec_t		ts;
-		zbx_pp_task_t		*task;
-		zbx_pp_item_t		*item;
-
-		offset += zbx_preprocessor_unpack_value(&value, message->data + offset);
-		sz = offset - offset_prev;
-		preproc_item_value_extract_data(&value, &var, &ts, &var_opt);
-
-		if (NULL == (task = zbx_pp_manager_create_task(manager, value.itemid, &var, ts, &var_opt)))
+		const zbx_pp_packed_value_t	*value = &values[i];
+		zbx_uint64_t			sz;
+		zbx_variant_t			var;
+		zbx_pp_value_opt_t		var_opt;
+		zbx_timespec_t			ts;
+		zbx_pp_task_t			*task;
+		zbx_pp_item_t			*item;
+
+		sz = sizeof(zbx_pp_packed_value_t) + value->value_len + value->source_len;
+		preproc_packed_value_extract_data(value, arena, &var, &ts, &var_opt);
+
+		if (NULL == (task = zbx_pp_manager_create_task(manager, value->itemid, &var, ts, &var_opt)))
 		{
 			(*direct_num)++;
 			*direct_sz += sz;
 			/* allow empty values */
-			preproc_flush_value_func_cb(manager, value.itemid, value.item_value_type, value.item_flags,
+			preproc_flush_value_func_cb(manager, value->itemid, value->item_value_type, value->item_flags,
 					&var, ts, &var_opt);
 
 			zbx_variant_clear(&var);
@@ -936,13 +911,11 @@ static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_
 		else
 			zbx_vector_pp_task_ptr_append(tasks, task);
 
-		if (NULL != (item = (zbx_pp_item_t *)zbx_hashset_search(&manager->items, &value.itemid)))
+		if (NULL != (item = (zbx_pp_item_t *)zbx_hashset_search(&manager->items, &value->itemid)))
 		{
 			item->preproc->values_num++;
 			item->preproc->values_sz += sz;
 		}
-
-		preproc_item_value_clear(&value);
 	}
 
 	if (0 != tasks->values_num)
@@ -984,7 +957,11 @@ static void	preprocessor_add_test_request(zbx_pp_manager_t *manager, zbx_ipc_cli
 
 static void	preprocessor_reply_queue_size(zbx_pp_manager_t *manager, zbx_ipc_client_t *client)
 {
-	zbx_uint64_t	pending_num = manager->queue.pending_num;
+	zbx_uint64_t	pending_num;
+
+	pp_task_queue_lock(&manager->queue);
+	pending_num = pp_task_queue_get_pending_num(&manager->queue);
+	pp_task_queue_unlock(&manager->queue);
 
 	zbx_ipc_client_send(client, ZBX_IPC_PREPROCESSOR_QUEUE, (unsigned char *)&pending_num, sizeof(pending_num));
 }
@@ -994,7 +971,11 @@ static void	preprocessor_reply_size(zbx_pp_manager_t *manager, zbx_ipc_client_t
 {
 	unsigned char	*data;
 	zbx_uint32_t	data_len;
-	zbx_uint64_t	pending_num = manager->queue.pending_num;
+	zbx_uint64_t	pending_num;
+
+	pp_task_queue_lock(&manager->queue);
+	pending_num = pp_task_queue_get_pending_num(&manager->queue);
+	pp_task_queue_unlock(&manager->queue);
 
 	data_len = zbx_preprocessor_pack_values_stats(&data, queued_num, queued_sz, direct_num, direct_sz, pending_num);
 
@@ -1106,14 +1087,15 @@ static zbx_uint64_t	zbx_pp_manager_items_history_size(zbx_pp_manager_t *manager)
 static void	preprocessor_reply_diag_info(zbx_pp_manager_t *manager, zbx_ipc_client_t *client,
 		zbx_uint64_t queued_num, zbx_uint64_t queued_sz, zbx_uint64_t direct_num, zbx_uint64_t direct_sz)
 {
-	zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num, history_sz;
+	zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num, history_sz, cache_num, cache_sz;
 	unsigned char	*data;
 	zbx_uint32_t	data_len;
 
 	history_sz = zbx_pp_manager_items_history_size(manager);
+	pp_cache_get_stats(&cache_num, &cache_sz);
 	zbx_pp_manager_get_diag_stats(manager, &preproc_num, &pending_num, &finished_num, &sequences_num);
 	data_len = zbx_preprocessor_pack_diag_stats(&data, preproc_num, pending_num, finished_num, sequences_num,
-			queued_num, queued_sz, direct_num, direct_sz, history_sz);
+			queued_num, queued_sz, direct_num, direct_sz, history_sz, cache_num, cache_sz);
 
 	zbx_ipc_client_send(client, ZBX_IPC_PREPROCESSOR_DIAG_STATS_RESULT, data, data_len);
 
@@ -31,8 +31,13 @@
 #define PACKED_FIELD(value, size)	\
 		(zbx_packed_field_t){(value), (size), (0 == (size) ? PACKED_FIELD_STRING : PACKED_FIELD_RAW)}
 
-static zbx_ipc_message_t	cached_message;
-static int			cached_values;
+#define PP_PACKED_STRING_NULL	UINT32_MAX
+
+/* batch of values cached by data gathering processes before sending to preprocessing manager */
+static zbx_pp_packed_value_t	cached_values[ZBX_PREPROCESSING_BATCH_SIZE + 1];
+static int			cached_values_num;
+static char			*cached_arena;
+static size_t			cached_arena_alloc, cached_arena_offset;
 
 ZBX_PTR_VECTOR_IMPL(ipcmsg, zbx_ipc_message_t *)
 
@@ -128,63 +133,188 @@ static zbx_uint32_t	message_pack_data(zbx_ipc_message_t *message, zbx_packed_fie
 
 /******************************************************************************
  *                                                                            *
- * Purpose: pack item value data into a single buffer that can be used in IPC *
- *                                                                            *
- * Parameters: message - [OUT] IPC message                                    *
- *             value   - [IN] value to be packed                              *
+ * Purpose: copy string into value batch arena                                *
  *                                                                            *
- * Return value: size of packed data                                          *
+ * Parameters: str    - [IN] string to copy, can be NULL                      *
+ *             offset - [OUT] string offset in arena                          *
+ *             len    - [OUT] string length                                   *
  *                                                                            *
  ******************************************************************************/
-static zbx_uint32_t	preprocessor_pack_value(zbx_ipc_message_t *message, zbx_preproc_item_value_t *value)
+static void	preprocessor_arena_add_str(const char *str, zbx_uint32_t *offset, zbx_uint32_t *len)
 {
-	zbx_packed_field_t	fields[24], *offset = fields;	/* 24 - max field count */
-	unsigned char		ts_marker, result_marker, log_marker;
+	size_t	str_len;
 
-	ts_marker = (NULL != value->ts);
-	result_marker = (NULL != value->result);
+	if (NULL == str)
+	{
+		*offset = PP_PACKED_STRING_NULL;
+		*len = 0;
+		return;
+	}
 
-	*offset++ = PACKED_FIELD(&value->itemid, sizeof(zbx_uint64_t));
-	*offset++ = PACKED_FIELD(&value->hostid, sizeof(zbx_uint64_t));
-	*offset++ = PACKED_FIELD(&value->item_value_type, sizeof(unsigned char));
-	*offset++ = PACKED_FIELD(&value->item_flags, sizeof(unsigned char));
-	*offset++ = PACKED_FIELD(&value->state, sizeof(unsigned char));
-	*offset++ = PACKED_FIELD(value->error, 0);
-	*offset++ = PACKED_FIELD(&ts_marker, sizeof(unsigned char));
+	str_len = strlen(str);
 
-	if (NULL != value->ts)
+	if (cached_arena_alloc < cached_arena_offset + str_len + 1)
 	{
-		*offset++ = PACKED_FIELD(&value->ts->sec, sizeof(int));
-		*offset++ = PACKED_FIELD(&value->ts->ns, sizeof(int));
+		while (cached_arena_alloc < cached_arena_offset + str_len + 1)
+			cached_arena_alloc = (0 == cached_arena_alloc ? ZBX_KIBIBYTE * 4 : cached_arena_alloc * 2);
+
+		cached_arena = (char *)zbx_realloc(cached_arena, cached_arena_alloc);
 	}
 
-	*offset++ = PACKED_FIELD(&result_marker, sizeof(unsigned char));
+	memcpy(cached_arena + cached_arena_offset, str, str_len + 1);
+
+	*offset = (zbx_uint32_t)cached_arena_offset;
+	*len = (zbx_uint32_t)str_len;
+
+	cached_arena_offset += str_len + 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get size of value strings to be copied into value batch arena     *
+ *                                                                            *
+ ******************************************************************************/
+static size_t	preprocessor_value_str_size(const zbx_preproc_item_value_t *value)
+{
+	size_t	size = 2;
+
+	if (NULL != value->error)
+		size += strlen(value->error);
 
 	if (NULL != value->result)
 	{
+		if (ZBX_ISSET_STR(value->result))
+			size += strlen(value->result->str);
+
+		if (ZBX_ISSET_TEXT(value->result))
+			size += strlen(value->result->text);
 
-		*offset++ = PACKED_FIELD(&value->result->lastlogsize, sizeof(zbx_uint64_t));
-		*offset++ = PACKED_FIELD(&value->result->ui64, sizeof(zbx_uint64_t));
-		*offset++ = PACKED_FIELD(&value->result->dbl, sizeof(double));
-		*offset++ = PACKED_FIELD(value->result->str, 0);
-		*offset++ = PACKED_FIELD(value->result->text, 0);
-		*offset++ = PACKED_FIELD(value->result->msg, 0);
-		*offset++ = PACKED_FIELD(&value->result->type, sizeof(int));
-		*offset++ = PACKED_FIELD(&value->result->mtime, sizeof(int));
-
-		log_marker = (NULL != value->result->log);
-		*offset++ = PACKED_FIELD(&log_marker, sizeof(unsigned char));
-		if (NULL != value->result->log)
+		if (ZBX_ISSET_MSG(value->result))
+			size += strlen(value->result->msg);
+
+		if (ZBX_ISSET_LOG(value->result))
 		{
-			*offset++ = PACKED_FIELD(value->result->log->value, 0);
-			*offset++ = PACKED_FIELD(value->result->log->source, 0);
-			*offset++ = PACKED_FIELD(&value->result->log->timestamp, sizeof(int));
-			*offset++ = PACKED_FIELD(&value->result->log->severity, sizeof(int));
-			*offset++ = PACKED_FIELD(&value->result->log->logeventid, sizeof(int));
+			if (NULL != value->result->log->value)
+				size += strlen(value->result->log->value);
+
+			if (NULL != value->result->log->source)
+				size += strlen(value->result->log->source);
 		}
 	}
 
-	return message_pack_data(message, fields, (int)(offset - fields));
+	return size;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add item value to the cached value batch                          *
+ *                                                                            *
+ * Parameters: value - [IN] value to be packed                                *
+ *                                                                            *
+ * Comments: The value is converted to the form used by preprocessing tasks,  *
+ *           so the manager can create tasks without unpacking agent results. *
+ *                                                                            *
+ ******************************************************************************/
+static void	preprocessor_pack_value(const zbx_preproc_item_value_t *value)
+{
+	zbx_pp_packed_value_t	*packed;
+	const AGENT_RESULT	*result = value->result;
+	const char		*str = NULL;
+
+	if (UINT32_MAX - sizeof(zbx_pp_packed_batch_t) - sizeof(cached_values) - cached_arena_offset <
+			preprocessor_value_str_size(value))
+	{
+		zbx_preprocessor_flush();
+	}
+
+	packed = &cached_values[cached_values_num++];
+
+	packed->itemid = value->itemid;
+	packed->item_value_type = value->item_value_type;
+	packed->item_flags = value->item_flags;
+	packed->opt_flags = ZBX_PP_VALUE_OPT_NONE;
+	packed->source_offset = PP_PACKED_STRING_NULL;
+	packed->source_len = 0;
+
+	if (NULL != value->ts)
+	{
+		packed->ts = *value->ts;
+	}
+	else
+	{
+		packed->ts.sec = 0;
+		packed->ts.ns = 0;
+	}
+
+	if (ITEM_STATE_NOTSUPPORTED == value->state)
+	{
+		packed->type = ZBX_VARIANT_ERR;
+
+		if (NULL != value->error)
+			str = value->error;
+		else if (NULL != result && ZBX_ISSET_MSG(result))
+			str = result->msg;
+		else
+			str = "Unknown error.";
+
+		preprocessor_arena_add_str(str, &packed->value_offset, &packed->value_len);
+
+		return;
+	}
+
+	packed->type = ZBX_VARIANT_NONE;
+
+	if (NULL == result)
+		return;
+
+	if (ZBX_ISSET_LOG(result))
+	{
+		packed->type = ZBX_VARIANT_STR;
+		str = result->log->value;
+
+		preprocessor_arena_add_str(result->log->source, &packed->source_offset, &packed->source_len);
+		packed->logeventid = result->log->logeventid;
+		packed->severity = result->log->severity;
+		packed->timestamp = result->log->timestamp;
+
+		packed->opt_flags |= ZBX_PP_VALUE_OPT_LOG;
+	}
+	else if (ZBX_ISSET_UI64(result))
+	{
+		packed->type = ZBX_VARIANT_UI64;
+		packed->ui64 = result->ui64;
+	}
+	else if (ZBX_ISSET_DBL(result))
+	{
+		packed->type = ZBX_VARIANT_DBL;
+		packed->dbl = result->dbl;
+	}
+	else if (ZBX_ISSET_STR(result))
+	{
+		packed->type = ZBX_VARIANT_STR;
+		str = result->str;
+	}
+	else if (ZBX_ISSET_TEXT(result))
+	{
+		packed->type = ZBX_VARIANT_STR;
+		str = result->text;
+	}
+	else if (ZBX_ISSET_BIN(result))
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		exit(EXIT_FAILURE);
+	}
+
+	if (ZBX_VARIANT_STR == packed->type)
+		preprocessor_arena_add_str(str, &packed->value_offset, &packed->value_len);
+
+	if (ZBX_ISSET_META(result))
+	{
+		packed->lastlogsize = result->lastlogsize;
+		packed->mtime = result->mtime;
+
+		packed->opt_flags |= ZBX_PP_VALUE_OPT_META;
+	}
 }
 
 /******************************************************************************
@@ -489,12 +619,16 @@ zbx_uint32_t	zbx_preprocessor_pack_test_result(unsigned char **data, const zbx_p
  *                               require preprocessing                        *
  *             direct_sz     - [IN] size of queued values that do not         *
  *                               require preprocessing                        *
+ *             cache_num     - [IN] number of parsed values shared by         *
+ *                               dependent items                              *
+ *             cache_sz      - [IN] size of parsed values shared by           *
+ *                               dependent items                              *
  *                                                                            *
  ******************************************************************************/
 zbx_uint32_t	zbx_preprocessor_pack_diag_stats(unsigned char **data, zbx_uint64_t preproc_num,
 		zbx_uint64_t pending_num, zbx_uint64_t finished_num, zbx_uint64_t sequences_num,
 		zbx_uint64_t queued_num, zbx_uint64_t queued_sz, zbx_uint64_t direct_num, zbx_uint64_t direct_sz,
-		zbx_uint64_t history_sz)
+		zbx_uint64_t history_sz, zbx_uint64_t cache_num, zbx_uint64_t cache_sz)
 {
 	unsigned char	*ptr;
 	zbx_uint32_t	data_len = 0;
@@ -508,6 +642,8 @@ zbx_uint32_t	zbx_preprocessor_pack_diag_stats(unsigned char **data, zbx_uint64_t
 	zbx_serialize_prepare_value(data_len, direct_num);
 	zbx_serialize_prepare_value(data_len, direct_sz);
 	zbx_serialize_prepare_value(data_len, history_sz);
+	zbx_serialize_prepare_value(data_len, cache_num);
+	zbx_serialize_prepare_value(data_len, cache_sz);
 
 	*data = (unsigned char *)zbx_malloc(NULL, data_len);
 
@@ -520,7 +656,9 @@ zbx_uint32_t	zbx_preprocessor_pack_diag_stats(unsigned char **data, zbx_uint64_t
 	ptr += zbx_serialize_value(ptr, queued_sz);
 	ptr += zbx_serialize_value(ptr, direct_num);
 	ptr += zbx_serialize_value(ptr, direct_sz);
-	(void)zbx_serialize_value(ptr, history_sz);
+	ptr += zbx_serialize_value(ptr, history_sz);
+	ptr += zbx_serialize_value(ptr, cache_num);
+	(void)zbx_serialize_value(ptr, cache_sz);
 
 	return data_len;
 }
@@ -653,72 +791,36 @@ zbx_uint32_t	zbx_preprocessor_pack_top_stats_result(unsigned char **data, zbx_ve
 
 /******************************************************************************
  *                                                                            *
- * Purpose: unpack item value data from IPC data buffer                       *
+ * Purpose: unpack item value batch from IPC data buffer                      *
  *                                                                            *
- * Parameters: value - [OUT] unpacked item value                              *
- *             data  - [IN]  IPC data buffer                                  *
+ * Parameters: data   - [IN] IPC data buffer                                  *
+ *             size   - [IN] IPC data buffer size                             *
+ *             values - [OUT] packed value records                            *
+ *             arena  - [OUT] arena with value strings                        *
  *                                                                            *
- * Return value: size of packed data                                          *
+ * Return value: number of values in batch                                    *
+ *                                                                            *
+ * Comments: Value records and strings are not copied, they reference the IPC *
+ *           data buffer.                                                     *
  *                                                                            *
  ******************************************************************************/
-zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsigned char *data)
+int	zbx_preprocessor_unpack_value_batch(const unsigned char *data, zbx_uint32_t size,
+		const zbx_pp_packed_value_t **values, const char **arena)
 {
-	zbx_uint32_t	value_len;
-	zbx_timespec_t	*timespec = NULL;
-	AGENT_RESULT	*agent_result = NULL;
-	zbx_log_t	*log = NULL;
-	unsigned char	*offset = data, ts_marker, result_marker, log_marker;
-
-	offset += zbx_deserialize_uint64(offset, &value->itemid);
-	offset += zbx_deserialize_uint64(offset, &value->hostid);
-	offset += zbx_deserialize_char(offset, &value->item_value_type);
-	offset += zbx_deserialize_char(offset, &value->item_flags);
-	offset += zbx_deserialize_char(offset, &value->state);
-	offset += zbx_deserialize_str(offset, &value->error, value_len);
-	offset += zbx_deserialize_char(offset, &ts_marker);
-
-	if (0 != ts_marker)
-	{
-		timespec = (zbx_timespec_t *)zbx_malloc(NULL, sizeof(zbx_timespec_t));
-
-		offset += zbx_deserialize_int(offset, &timespec->sec);
-		offset += zbx_deserialize_int(offset, &timespec->ns);
-	}
-
-	value->ts = timespec;
+	const zbx_pp_packed_batch_t	*batch = (const zbx_pp_packed_batch_t *)data;
 
-	offset += zbx_deserialize_char(offset, &result_marker);
-	if (0 != result_marker)
+	if (sizeof(zbx_pp_packed_batch_t) > size || size < batch->arena_offset ||
+			batch->arena_offset < sizeof(zbx_pp_packed_batch_t) +
+			(zbx_uint64_t)batch->values_num * sizeof(zbx_pp_packed_value_t))
 	{
-		agent_result = (AGENT_RESULT *)zbx_malloc(NULL, sizeof(AGENT_RESULT));
-
-		offset += zbx_deserialize_uint64(offset, &agent_result->lastlogsize);
-		offset += zbx_deserialize_uint64(offset, &agent_result->ui64);
-		offset += zbx_deserialize_double(offset, &agent_result->dbl);
-		offset += zbx_deserialize_str(offset, &agent_result->str, value_len);
-		offset += zbx_deserialize_str(offset, &agent_result->text, value_len);
-		offset += zbx_deserialize_str(offset, &agent_result->msg, value_len);
-		offset += zbx_deserialize_int(offset, &agent_result->type);
-		offset += zbx_deserialize_int(offset, &agent_result->mtime);
-
-		offset += zbx_deserialize_char(offset, &log_marker);
-		if (0 != log_marker)
-		{
-			log = (zbx_log_t *)zbx_malloc(NULL, sizeof(zbx_log_t));
-
-			offset += zbx_deserialize_str(offset, &log->value, value_len);
-			offset += zbx_deserialize_str(offset, &log->source, value_len);
-			offset += zbx_deserialize_int(offset, &log->timestamp);
-			offset += zbx_deserialize_int(offset, &log->severity);
-			offset += zbx_deserialize_int(offset, &log->logeventid);
-		}
-
-		agent_result->log = log;
+		THIS_SHOULD_NEVER_HAPPEN;
+		return 0;
 	}
 
-	value->result = agent_result;
+	*values = (const zbx_pp_packed_value_t *)(data + sizeof(zbx_pp_packed_batch_t));
+	*arena = (const char *)data + batch->arena_offset;
 
-	return (zbx_uint32_t)(offset - data);
+	return (int)batch->values_num;
 }
 
 /******************************************************************************
@@ -772,13 +874,17 @@ void	zbx_preprocessor_unpack_test_result(zbx_vector_pp_result_ptr_t *results, zb
  *                               require preprocessing                        *
  *             direct_sz     - [OUT] size of queued values that do not        *
  *                               require preprocessing                        *
+ *             cache_num     - [OUT] number of parsed values shared by        *
+ *                               dependent items                              *
+ *             cache_sz      - [OUT] size of parsed values shared by          *
+ *                               dependent items                              *
  *             data          - [OUT] data buffer                              *
  *                                                                            *
  ******************************************************************************/
 void	zbx_preprocessor_unpack_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pending_num,
 		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, zbx_uint64_t *queued_num,
 		zbx_uint64_t *queued_sz, zbx_uint64_t *direct_num, zbx_uint64_t *direct_sz, zbx_uint64_t *history_sz,
-		const unsigned char *data)
+		zbx_uint64_t *cache_num, zbx_uint64_t *cache_sz, const unsigned char *data)
 {
 	const unsigned char	*offset = data;
 
@@ -790,7 +896,9 @@ void	zbx_preprocessor_unpack_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t
 	offset += zbx_deserialize_value(offset, queued_sz);
 	offset += zbx_deserialize_value(offset, direct_num);
 	offset += zbx_deserialize_value(offset, direct_sz);
-	(void)zbx_deserialize_value(offset, history_sz);
+	offset += zbx_deserialize_value(offset, history_sz);
+	offset += zbx_deserialize_value(offset, cache_num);
+	(void)zbx_deserialize_value(offset, cache_sz);
 }
 
 /******************************************************************************
@@ -992,15 +1100,10 @@ void	zbx_preprocess_item_value(zbx_uint64_t itemid, zbx_uint64_t hostid,
 
 	if (ZBX_ITEM_REQUIRES_PREPROCESSING_YES == preprocessing)
 	{
-		if (0 == preprocessor_pack_value(&cached_message, &value))
-		{
-			zbx_preprocessor_flush();
-			preprocessor_pack_value(&cached_message, &value);
-		}
+		preprocessor_pack_value(&value);
 
-		if (ZBX_PREPROCESSING_BATCH_SIZE < ++cached_values)
+		if (ZBX_PREPROCESSING_BATCH_SIZE < cached_values_num)
 			zbx_preprocessor_flush();
-
 	}
 	else
 	{
@@ -1015,16 +1118,36 @@ void	zbx_preprocess_item_value(zbx_uint64_t itemid, zbx_uint64_t hostid,
  *                                                                            *
  * Purpose: send flush command to preprocessing manager                       *
  *                                                                            *
+ * Comments: The cached values are sent as a single batch - header, value     *
+ *           records and arena with value strings.                            *
+ *                                                                            *
  ******************************************************************************/
 void	zbx_preprocessor_flush(void)
 {
-	if (0 < cached_message.size)
+	if (0 < cached_values_num)
 	{
-		preprocessor_send(ZBX_IPC_PREPROCESSOR_REQUEST, cached_message.data, cached_message.size, NULL);
+		zbx_pp_packed_batch_t	*batch;
+		unsigned char		*data;
+		size_t			records_size, size;
+
+		records_size = sizeof(zbx_pp_packed_value_t) * (size_t)cached_values_num;
+		size = sizeof(zbx_pp_packed_batch_t) + records_size + cached_arena_offset;
+		data = (unsigned char *)zbx_malloc(NULL, size);
+
+		batch = (zbx_pp_packed_batch_t *)data;
+		batch->values_num = (zbx_uint32_t)cached_values_num;
+		batch->arena_offset = (zbx_uint32_t)(sizeof(zbx_pp_packed_batch_t) + records_size);
+
+		memcpy(data + sizeof(zbx_pp_packed_batch_t), cached_values, records_size);
+
+		if (0 != cached_arena_offset)
+			memcpy(data + batch->arena_offset, cached_arena, cached_arena_offset);
+
+		preprocessor_send(ZBX_IPC_PREPROCESSOR_REQUEST, data, (zbx_uint32_t)size, NULL);
 
-		zbx_ipc_message_clean(&cached_message);
-		zbx_ipc_message_init(&cached_message);
-		cached_values = 0;
+		zbx_free(data);
+		cached_values_num = 0;
+		cached_arena_offset = 0;
 	}
 
 	zbx_dc_flush_history();
@@ -1220,7 +1343,7 @@ out:
 int	zbx_preprocessor_get_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pending_num,
 		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, zbx_uint64_t *queued_num,
 		zbx_uint64_t *queued_sz, zbx_uint64_t *direct_num, zbx_uint64_t *direct_sz, zbx_uint64_t *history_sz,
-		char **error)
+		zbx_uint64_t *cache_num, zbx_uint64_t *cache_sz, char **error)
 {
 	unsigned char	*result;
 
@@ -1231,7 +1354,7 @@ int	zbx_preprocessor_get_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pen
 	}
 
 	zbx_preprocessor_unpack_diag_stats(preproc_num, pending_num, finished_num, sequences_num, queued_num,
-			queued_sz, direct_num, direct_sz, history_sz, result);
+			queued_sz, direct_num, direct_sz, history_sz, cache_num, cache_sz, result);
 	zbx_free(result);
 
 	return SUCCEED;
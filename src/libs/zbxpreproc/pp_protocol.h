@@ -54,6 +54,37 @@ typedef struct
 }
 zbx_preproc_item_value_t;
 
+/* item value record in packed value batch, strings are stored in batch arena */
+typedef struct
+{
+	zbx_uint64_t		itemid;
+	zbx_uint64_t		ui64;
+	double			dbl;
+	zbx_uint64_t		lastlogsize;
+	zbx_timespec_t		ts;
+	int			mtime;
+	int			timestamp;
+	int			severity;
+	int			logeventid;
+	zbx_uint32_t		value_offset;	/* string or error value offset in arena */
+	zbx_uint32_t		value_len;	/* string or error value length, without terminating zero */
+	zbx_uint32_t		source_offset;	/* log source offset in arena */
+	zbx_uint32_t		source_len;	/* log source length, without terminating zero */
+	unsigned char		type;		/* ZBX_VARIANT_* value type */
+	unsigned char		item_value_type;
+	unsigned char		item_flags;
+	unsigned char		opt_flags;	/* ZBX_PP_VALUE_OPT_* flags */
+}
+zbx_pp_packed_value_t;
+
+/* packed value batch header, followed by value records and string arena */
+typedef struct
+{
+	zbx_uint32_t	values_num;
+	zbx_uint32_t	arena_offset;
+}
+zbx_pp_packed_batch_t;
+
 ZBX_PTR_VECTOR_DECL(ipcmsg, zbx_ipc_message_t *)
 
 /* packed field data description */
@@ -65,7 +96,8 @@ typedef struct
 }
 zbx_packed_field_t;
 
-zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsigned char *data);
+int	zbx_preprocessor_unpack_value_batch(const unsigned char *data, zbx_uint32_t size,
+		const zbx_pp_packed_value_t **values, const char **arena);
 
 void	zbx_preprocessor_unpack_test_request(zbx_pp_item_preproc_t *preproc, zbx_variant_t *value, zbx_timespec_t *ts,
 		const unsigned char *data);
@@ -79,7 +111,7 @@ void	zbx_preprocessor_unpack_test_result(zbx_vector_pp_result_ptr_t *results, zb
 zbx_uint32_t	zbx_preprocessor_pack_diag_stats(unsigned char **data, zbx_uint64_t preproc_num,
 		zbx_uint64_t pending_num, zbx_uint64_t finished_num, zbx_uint64_t sequences_num,
 		zbx_uint64_t queued_num, zbx_uint64_t queued_sz, zbx_uint64_t direct_num, zbx_uint64_t direct_sz,
-		zbx_uint64_t history_size);
+		zbx_uint64_t history_size, zbx_uint64_t cache_num, zbx_uint64_t cache_sz);
 
 zbx_uint32_t	zbx_preprocessor_pack_values_stats(unsigned char **data, zbx_uint64_t queued_num,
 		zbx_uint64_t queued_sz, zbx_uint64_t direct_num, zbx_uint64_t direct_sz, zbx_uint64_t enqueued_num);
@@ -87,7 +119,7 @@ zbx_uint32_t	zbx_preprocessor_pack_values_stats(unsigned char **data, zbx_uint64
 void	zbx_preprocessor_unpack_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pending_num,
 		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, zbx_uint64_t *queued_num,
 		zbx_uint64_t *queued_sz, zbx_uint64_t *direct_num, zbx_uint64_t *direct_sz, zbx_uint64_t *history_sz,
-		const unsigned char *data);
+		zbx_uint64_t *cache_num, zbx_uint64_t *cache_sz, const unsigned char *data);
 
 void	zbx_preprocessor_unpack_values_stats(zbx_uint64_t *queued_num, zbx_uint64_t *queued_sz,
 		zbx_uint64_t *direct_num, zbx_uint64_t *direct_sz, zbx_uint64_t *enqueued_num,
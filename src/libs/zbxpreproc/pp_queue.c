@@ -20,6 +20,11 @@
 #define PP_TASK_QUEUE_INIT_NONE		0x00
 #define PP_TASK_QUEUE_INIT_LOCK		0x01
 #define PP_TASK_QUEUE_INIT_EVENT	0x02
+#define PP_TASK_QUEUE_INIT_FINISHED	0x04
+
+/* the number of tasks a worker pops from its own queue before checking the shared */
+/* queue, so immediate tasks are not delayed by a long worker queue                */
+#define PP_TASK_QUEUE_LOCAL_POPS_MAX	8
 
 ZBX_PTR_VECTOR_IMPL(pp_top_stats_ptr, zbx_pp_top_stats_t *)
 
@@ -49,17 +54,25 @@ zbx_pp_item_tasks_t;
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-int	pp_task_queue_init(zbx_pp_queue_t *queue, char **error)
+int	pp_task_queue_init(zbx_pp_queue_t *queue, int workers_num, char **error)
 {
 	int	err, ret = FAIL;
 
 	queue->workers_num = 0;
 	queue->pending_num = 0;
+	queue->popped_num = 0;
 	queue->finished_num = 0;
-	queue->processing_num = 0;
+	queue->done_num = 0;
+	queue->done_total = 0;
 	zbx_list_create(&queue->pending);
 	zbx_list_create(&queue->immediate);
 	zbx_list_create(&queue->finished);
+	zbx_list_create(&queue->done);
+
+	queue->worker_queues_num = 0;
+	queue->worker_queue_next = 0;
+	queue->worker_queues = (zbx_pp_worker_queue_t *)zbx_malloc(NULL,
+			sizeof(zbx_pp_worker_queue_t) * (size_t)MAX(workers_num, 1));
 
 	zbx_hashset_create(&queue->sequences, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	zbx_hashset_create(&queue->tasks, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
@@ -78,6 +91,30 @@ int	pp_task_queue_init(zbx_pp_queue_t *queue, char **error)
 	}
 	queue->init_flags |= PP_TASK_QUEUE_INIT_EVENT;
 
+	if (0 != (err = pthread_mutex_init(&queue->finished_lock, NULL)))
+	{
+		*error = zbx_dsprintf(NULL, "cannot initialize finished task queue mutex: %s", zbx_strerror(err));
+		goto out;
+	}
+	queue->init_flags |= PP_TASK_QUEUE_INIT_FINISHED;
+
+	for (; queue->worker_queues_num < MAX(workers_num, 1); queue->worker_queues_num++)
+	{
+		zbx_pp_worker_queue_t	*wq = &queue->worker_queues[queue->worker_queues_num];
+
+		if (0 != (err = pthread_mutex_init(&wq->lock, NULL)))
+		{
+			*error = zbx_dsprintf(NULL, "cannot initialize worker task queue mutex: %s",
+					zbx_strerror(err));
+			goto out;
+		}
+
+		zbx_list_create(&wq->tasks);
+		wq->pending_num = 0;
+		wq->popped_num = 0;
+		wq->local_pops = 0;
+	}
+
 	ret = SUCCEED;
 out:
 	if (FAIL == ret)
@@ -112,6 +149,19 @@ void	pp_task_queue_destroy(zbx_pp_queue_t *queue)
 	if (0 != (queue->init_flags & PP_TASK_QUEUE_INIT_EVENT))
 		pthread_cond_destroy(&queue->event);
 
+	if (0 != (queue->init_flags & PP_TASK_QUEUE_INIT_FINISHED))
+		pthread_mutex_destroy(&queue->finished_lock);
+
+	for (int i = 0; i < queue->worker_queues_num; i++)
+	{
+		pthread_mutex_destroy(&queue->worker_queues[i].lock);
+		pp_task_queue_clear_tasks(&queue->worker_queues[i].tasks);
+		zbx_list_destroy(&queue->worker_queues[i].tasks);
+	}
+
+	zbx_free(queue->worker_queues);
+	queue->worker_queues_num = 0;
+
 	pp_task_queue_clear_tasks(&queue->pending);
 	zbx_list_destroy(&queue->pending);
 
@@ -121,6 +171,9 @@ void	pp_task_queue_destroy(zbx_pp_queue_t *queue)
 	pp_task_queue_clear_tasks(&queue->finished);
 	zbx_list_destroy(&queue->finished);
 
+	pp_task_queue_clear_tasks(&queue->done);
+	zbx_list_destroy(&queue->done);
+
 	zbx_hashset_destroy(&queue->sequences);
 	zbx_hashset_destroy(&queue->tasks);
 
@@ -147,6 +200,26 @@ void	pp_task_queue_unlock(zbx_pp_queue_t *queue)
 	pthread_mutex_unlock(&queue->lock);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: lock finished task queue                                          *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_task_queue_lock_finished(zbx_pp_queue_t *queue)
+{
+	pthread_mutex_lock(&queue->finished_lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: unlock finished task queue                                        *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_task_queue_unlock_finished(zbx_pp_queue_t *queue)
+{
+	pthread_mutex_unlock(&queue->finished_lock);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: register a new worker                                             *
@@ -297,11 +370,13 @@ void	pp_task_queue_push_test(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
  * Comments: This function is used to push tasks created by new preprocessing *
  *           or testing requests.                                             *
  *                                                                            *
+ *           Value tasks do not depend on other tasks, so they are spread     *
+ *           over worker queues to reduce contention on the shared queue.     *
+ *                                                                            *
  ******************************************************************************/
 void	pp_task_queue_push(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
 {
 	zbx_pp_task_value_t	*d = (zbx_pp_task_value_t *)PP_TASK_DATA(task);
-	queue->pending_num++;
 
 	/* track input value order to have the same output order for non sequential tasks */
 	if (ZBX_PP_TASK_VALUE == task->type)
@@ -309,10 +384,28 @@ void	pp_task_queue_push(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
 
 	if (ITEM_TYPE_INTERNAL != d->preproc->type)
 	{
+		if (ZBX_PP_TASK_VALUE == task->type)
+		{
+			zbx_pp_worker_queue_t	*wq = &queue->worker_queues[queue->worker_queue_next];
+
+			if (++queue->worker_queue_next == queue->worker_queues_num)
+				queue->worker_queue_next = 0;
+
+			pthread_mutex_lock(&wq->lock);
+			(void)zbx_list_append(&wq->tasks, task, NULL);
+			wq->pending_num++;
+			pthread_mutex_unlock(&wq->lock);
+
+			return;
+		}
+
+		queue->pending_num++;
 		(void)zbx_list_append(&queue->pending, task, NULL);
 		return;
 	}
 
+	queue->pending_num++;
+
 	if (ZBX_PP_TASK_VALUE == task->type)
 	{
 		(void)zbx_list_append(&queue->immediate, task, NULL);
@@ -327,30 +420,31 @@ void	pp_task_queue_push(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: pop task from task queue                                          *
+ * Purpose: pop task from shared task queue                                   *
  *                                                                            *
  * Parameters: queue - [IN] task queue                                        *
  *                                                                            *
  * Return value: The popped task or NULL if there are no tasks to be          *
  *               processed.                                                   *
  *                                                                            *
- * Comments: This function is used by workers to pop tasks for processing.    *
- *           Sequence tasks will be moved to existing tasks sequences or      *
+ * Comments: Sequence tasks will be moved to existing tasks sequences or      *
  *           returned if there are no registered sequences for this item.     *
  *                                                                            *
  ******************************************************************************/
-zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue)
+static zbx_pp_task_t	*pp_task_queue_pop_shared(zbx_pp_queue_t *queue)
 {
 	zbx_pp_task_t	*task = NULL;
 
+	pp_task_queue_lock(queue);
+
 	if (SUCCEED == zbx_list_pop(&queue->immediate, (void **)&task))
 	{
 		/* while sequence tasks do not affect statistics, the first task in sequence */
 		/* does, so the statistics can be updated for all tasks                      */
 		queue->pending_num--;
-		queue->processing_num++;
+		queue->popped_num++;
 
-		return (zbx_pp_task_t *)task;
+		goto out;
 	}
 
 	while (SUCCEED == zbx_list_pop(&queue->pending, (void **)&task))
@@ -365,8 +459,89 @@ zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue)
 		if (NULL != task)
 		{
 			queue->pending_num--;
-			queue->processing_num++;
+			queue->popped_num++;
 
+			goto out;
+		}
+	}
+
+	task = NULL;
+out:
+	pp_task_queue_unlock(queue);
+
+	return task;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pop task from worker task queue                                   *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_pp_task_t	*pp_worker_queue_pop(zbx_pp_worker_queue_t *wq)
+{
+	zbx_pp_task_t	*task = NULL;
+
+	pthread_mutex_lock(&wq->lock);
+
+	if (SUCCEED == zbx_list_pop(&wq->tasks, (void **)&task))
+	{
+		wq->pending_num--;
+		wq->popped_num++;
+	}
+
+	pthread_mutex_unlock(&wq->lock);
+
+	return task;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pop task for processing                                           *
+ *                                                                            *
+ * Parameters: queue        - [IN] task queue                                 *
+ *             worker_index - [IN] index of the calling worker                *
+ *                                                                            *
+ * Return value: The popped task or NULL if there are no tasks to be          *
+ *               processed.                                                   *
+ *                                                                            *
+ * Comments: This function is used by workers to pop tasks for processing.    *
+ *           The task queue must not be locked by caller.                     *
+ *                                                                            *
+ *           The shared queue with immediate and sequence tasks is checked    *
+ *           first every PP_TASK_QUEUE_LOCAL_POPS_MAX pops, otherwise tasks   *
+ *           are popped from the worker's own queue. When both are empty      *
+ *           tasks are stolen from other worker queues.                       *
+ *                                                                            *
+ ******************************************************************************/
+zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue, int worker_index)
+{
+	zbx_pp_worker_queue_t	*wq = &queue->worker_queues[worker_index % queue->worker_queues_num];
+	zbx_pp_task_t		*task;
+
+	if (PP_TASK_QUEUE_LOCAL_POPS_MAX <= wq->local_pops)
+	{
+		wq->local_pops = 0;
+
+		if (NULL != (task = pp_task_queue_pop_shared(queue)))
+			return task;
+	}
+
+	if (NULL != (task = pp_worker_queue_pop(wq)))
+	{
+		wq->local_pops++;
+		return task;
+	}
+
+	wq->local_pops = 0;
+
+	if (NULL != (task = pp_task_queue_pop_shared(queue)))
+		return task;
+
+	for (int i = 1; i < queue->worker_queues_num; i++)
+	{
+		if (NULL != (task = pp_worker_queue_pop(&queue->worker_queues[(worker_index + i) %
+				queue->worker_queues_num])))
+		{
 			return task;
 		}
 	}
@@ -381,11 +556,30 @@ zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue)
  * Parameters: queue - [IN] task queue                                        *
  *             task  - [IN] task                                              *
  *                                                                            *
+ * Comments: This function is used by workers, the finished task queue must   *
+ *           be locked by caller.                                             *
+ *                                                                            *
  ******************************************************************************/
 void	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
+{
+	(void)zbx_list_append(&queue->done, task, NULL);
+	queue->done_num++;
+	queue->done_total++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: move task finished by worker to finished task list, keeping the   *
+ *          input order of value tasks                                        *
+ *                                                                            *
+ * Parameters: queue - [IN] task queue                                        *
+ *             task  - [IN] task                                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_task_queue_order_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
 {
 	zbx_pp_item_tasks_t	*item_tasks;
-	queue->processing_num--;
+
 	task->state = ZBX_PP_TASK_FINISHED;
 
 	if (ZBX_PP_TASK_VALUE == task->type &&
@@ -419,18 +613,102 @@ void	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
  *                                                                            *
  * Return value: The popped task or NULL if there are no finished tasks.      *
  *                                                                            *
+ * Comments: This function is used by manager. All tasks finished by workers  *
+ *           are taken with a single finished queue lock when the ordered     *
+ *           finished task list is empty.                                     *
+ *                                                                            *
  ******************************************************************************/
 zbx_pp_task_t	*pp_task_queue_pop_finished(zbx_pp_queue_t *queue)
 {
 	zbx_pp_task_t	*task;
 
-	if (SUCCEED == zbx_list_pop(&queue->finished, (void **)&task))
+	if (SUCCEED != zbx_list_pop(&queue->finished, (void **)&task))
 	{
-		queue->finished_num--;
-		return task;
+		zbx_list_t	done;
+
+		pp_task_queue_lock_finished(queue);
+		done = queue->done;
+		zbx_list_create(&queue->done);
+		queue->done_num = 0;
+		pp_task_queue_unlock_finished(queue);
+
+		while (SUCCEED == zbx_list_pop(&done, (void **)&task))
+			pp_task_queue_order_finished(queue, task);
+
+		zbx_list_destroy(&done);
+
+		if (SUCCEED != zbx_list_pop(&queue->finished, (void **)&task))
+			return NULL;
 	}
 
-	return NULL;
+	queue->finished_num--;
+
+	return task;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get number of pending tasks                                       *
+ *                                                                            *
+ * Parameters: queue - [IN] task queue                                        *
+ *                                                                            *
+ * Comments: The task queue must be locked by caller.                         *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint64_t	pp_task_queue_get_pending_num(zbx_pp_queue_t *queue)
+{
+	zbx_uint64_t	pending_num = queue->pending_num;
+
+	for (int i = 0; i < queue->worker_queues_num; i++)
+	{
+		zbx_pp_worker_queue_t	*wq = &queue->worker_queues[i];
+
+		pthread_mutex_lock(&wq->lock);
+		pending_num += wq->pending_num;
+		pthread_mutex_unlock(&wq->lock);
+	}
+
+	return pending_num;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get task queue statistics                                         *
+ *                                                                            *
+ * Parameters: queue          - [IN] task queue                               *
+ *             pending_num    - [OUT] tasks waiting to be processed           *
+ *             processing_num - [OUT] tasks being processed by workers        *
+ *             finished_num   - [OUT] finished tasks                          *
+ *                                                                            *
+ * Comments: This function is used by manager, the task queue must be locked  *
+ *           by caller.                                                       *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_task_queue_get_stats(zbx_pp_queue_t *queue, zbx_uint64_t *pending_num, zbx_uint64_t *processing_num,
+		zbx_uint64_t *finished_num)
+{
+	zbx_uint64_t	popped_num = queue->popped_num, done_total;
+
+	/* finished tasks are counted before popped tasks, so tasks finished in */
+	/* the meantime are reported as processing instead of being lost        */
+	pp_task_queue_lock_finished(queue);
+	done_total = queue->done_total;
+	*finished_num = queue->finished_num + queue->done_num;
+	pp_task_queue_unlock_finished(queue);
+
+	*pending_num = queue->pending_num;
+
+	for (int i = 0; i < queue->worker_queues_num; i++)
+	{
+		zbx_pp_worker_queue_t	*wq = &queue->worker_queues[i];
+
+		pthread_mutex_lock(&wq->lock);
+		*pending_num += wq->pending_num;
+		popped_num += wq->popped_num;
+		pthread_mutex_unlock(&wq->lock);
+	}
+
+	*processing_num = popped_num - done_total;
 }
 
 /******************************************************************************
@@ -443,7 +721,8 @@ zbx_pp_task_t	*pp_task_queue_pop_finished(zbx_pp_queue_t *queue)
  * Return value: SUCCEED - the wait succeeded                                 *
  *               FAIL    - an error has occurred                              *
  *                                                                            *
- * Comments: This function is used by workers to wait for new tasks.          *
+ * Comments: This function is used by workers to wait for new tasks, the task *
+ *           queue must be locked by caller.                                  *
  *                                                                            *
  ******************************************************************************/
 int	pp_task_queue_wait(zbx_pp_queue_t *queue, char **error)
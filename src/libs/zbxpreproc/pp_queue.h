@@ -18,31 +18,68 @@
 #include "zbxpreproc.h"
 #include "zbxalgo.h"
 
+/* queue of value tasks assigned to a worker, other workers steal from it when idle */
+typedef struct
+{
+	zbx_list_t	tasks;
+	zbx_uint64_t	pending_num;
+	zbx_uint64_t	popped_num;
+
+	/* number of tasks popped by the owner since the last shared queue check, */
+	/* accessed only by the owner worker                                      */
+	int		local_pops;
+
+	pthread_mutex_t	lock;
+}
+zbx_pp_worker_queue_t;
+
 typedef struct
 {
 	zbx_uint32_t	init_flags;
 	int		workers_num;
+
+	/* the following counters are protected by queue lock */
 	zbx_uint64_t	pending_num;
+	zbx_uint64_t	popped_num;
+
+	/* number of tasks in finished list, accessed only by manager */
 	zbx_uint64_t	finished_num;
-	zbx_uint64_t	processing_num;
+
+	/* the following counters are protected by finished queue lock */
+	zbx_uint64_t	done_num;
+	zbx_uint64_t	done_total;
 
 	zbx_hashset_t	sequences;
+
+	/* value task order tracking, accessed only by manager */
 	zbx_hashset_t	tasks;
 
 	zbx_list_t	pending;
 	zbx_list_t	immediate;
+
+	/* ordered finished tasks, accessed only by manager */
 	zbx_list_t	finished;
 
+	/* tasks finished by workers, protected by finished queue lock */
+	zbx_list_t	done;
+
+	zbx_pp_worker_queue_t	*worker_queues;
+	int			worker_queues_num;
+	int			worker_queue_next;
+
 	pthread_mutex_t	lock;
+	pthread_mutex_t	finished_lock;
 	pthread_cond_t	event;
 }
 zbx_pp_queue_t;
 
-int	pp_task_queue_init(zbx_pp_queue_t *queue, char **error);
+int	pp_task_queue_init(zbx_pp_queue_t *queue, int workers_num, char **error);
 void	pp_task_queue_destroy(zbx_pp_queue_t *queue);
 
 void	pp_task_queue_lock(zbx_pp_queue_t *queue);
 void	pp_task_queue_unlock(zbx_pp_queue_t *queue);
+void	pp_task_queue_lock_finished(zbx_pp_queue_t *queue);
+void	pp_task_queue_unlock_finished(zbx_pp_queue_t *queue);
 void	pp_task_queue_register_worker(zbx_pp_queue_t *queue);
 void	pp_task_queue_deregister_worker(zbx_pp_queue_t *queue);
 void	pp_task_queue_remove_sequence(zbx_pp_queue_t *queue, zbx_uint64_t itemid);
@@ -54,11 +91,14 @@ void	pp_task_queue_notify_all(zbx_pp_queue_t *queue);
 void	pp_task_queue_push_test(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 void	pp_task_queue_push(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 
-zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue);
+zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue, int worker_index);
 void	pp_task_queue_push_immediate(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 void	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 zbx_pp_task_t	*pp_task_queue_pop_finished(zbx_pp_queue_t *queue);
 
+zbx_uint64_t	pp_task_queue_get_pending_num(zbx_pp_queue_t *queue);
+void	pp_task_queue_get_stats(zbx_pp_queue_t *queue, zbx_uint64_t *pending_num, zbx_uint64_t *processing_num,
+		zbx_uint64_t *finished_num);
 void	pp_task_queue_get_sequence_stats(zbx_pp_queue_t *queue, zbx_vector_pp_top_stats_ptr_t *stats);
 
 #endif
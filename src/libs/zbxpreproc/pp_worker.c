@@ -121,13 +121,12 @@ static void	*pp_worker_entry(void *args)
 	pp_context_init(&worker->execute_ctx);
 	pp_task_queue_lock(queue);
 	pp_task_queue_register_worker(queue);
+	pp_task_queue_unlock(queue);
 
 	while (0 == worker->stop)
 	{
-		if (NULL != (in = pp_task_queue_pop_new(queue)))
+		if (NULL != (in = pp_task_queue_pop_new(queue, worker->id - 1)))
 		{
-			pp_task_queue_unlock(queue);
-
 			zbx_timekeeper_update(worker->timekeeper, worker->id - 1, ZBX_PROCESS_STATE_BUSY);
 
 			zabbix_log(LOG_LEVEL_TRACE, "%s() process task type:%u itemid:" ZBX_FS_UI64, __func__,
@@ -152,26 +151,36 @@ static void	*pp_worker_entry(void *args)
 
 			in->time_ms = zbx_timekeeper_update(worker->timekeeper, worker->id - 1, ZBX_PROCESS_STATE_IDLE);
 
-			pp_task_queue_lock(queue);
+			pp_task_queue_lock_finished(queue);
 			pp_task_queue_push_finished(queue, in);
 
 			if (NULL != worker->pp_finished_task_cb)
 				worker->pp_finished_task_cb(worker->pp_finished_task_data);
 
+			pp_task_queue_unlock_finished(queue);
+
 			continue;
 		}
 
-		if (SUCCEED != pp_task_queue_wait(queue, &error))
+		pp_task_queue_lock(queue);
+
+		/* tasks are pushed with task queue locked, so checking pending tasks under */
+		/* the same lock ensures that notifications are not lost                    */
+		if (0 == worker->stop && 0 == pp_task_queue_get_pending_num(queue) &&
+				SUCCEED != pp_task_queue_wait(queue, &error))
 		{
 			zabbix_log(LOG_LEVEL_WARNING, "[%d] %s", worker->id, error);
 			zbx_free(error);
 			worker->stop = 1;
 		}
 
-		if (1 < queue->pending_num)
+		if (1 < pp_task_queue_get_pending_num(queue))
 			pp_task_queue_notify(queue);
+
+		pp_task_queue_unlock(queue);
 	}
 
+	pp_task_queue_lock(queue);
 	pp_task_queue_deregister_worker(queue);
 	pp_task_queue_unlock(queue);
 	zbx_deinit_regexp_env();
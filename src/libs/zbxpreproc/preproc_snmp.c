@@ -796,6 +796,26 @@ int	zbx_snmp_value_cache_init(zbx_snmp_value_cache_t *cache, const char *data, c
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get memory allocated for parsed SNMP walk value                   *
+ *                                                                            *
+ ******************************************************************************/
+size_t	zbx_snmp_value_cache_get_size(const zbx_snmp_value_cache_t *cache)
+{
+	size_t				size;
+	zbx_hashset_const_iter_t	iter;
+	const zbx_snmp_value_pair_t	*pair;
+
+	size = zbx_hashset_get_size(&cache->pairs, sizeof(zbx_snmp_value_pair_t));
+
+	zbx_hashset_const_iter_reset(&cache->pairs, &iter);
+	while (NULL != (pair = (const zbx_snmp_value_pair_t *)zbx_hashset_const_iter_next(&iter)))
+		size += strlen(pair->oid) + 1 + (NULL == pair->value ? 0 : strlen(pair->value) + 1);
+
+	return size;
+}
+
 static void	snmp_walk_serialize_json(zbx_hashset_t *grouped_prefixes, char **result)
 {
 	struct zbx_json			json;
@@ -838,7 +858,7 @@ int	item_preproc_snmp_walk_to_value(zbx_pp_cache_t *cache, zbx_variant_t *value,
 		return FAIL;
 	}
 
-	if (NULL == cache || ZBX_PREPROC_SNMP_WALK_VALUE != cache->type)
+	if (NULL == cache)
 	{
 		if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 			return FAIL;
@@ -849,29 +869,12 @@ int	item_preproc_snmp_walk_to_value(zbx_pp_cache_t *cache, zbx_variant_t *value,
 	{
 		zbx_snmp_value_cache_t	*snmp_cache;
 
-		if (NULL != cache->error)
+		if (NULL == (snmp_cache = (zbx_snmp_value_cache_t *)pp_cache_get_data(cache,
+				ZBX_PREPROC_SNMP_WALK_VALUE, errmsg)))
 		{
-			*errmsg = zbx_strdup(NULL, cache->error);
 			return FAIL;
 		}
 
-		if (NULL == (snmp_cache = (zbx_snmp_value_cache_t *)cache->data))
-		{
-			if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
-				return FAIL;
-
-			snmp_cache = (zbx_snmp_value_cache_t *)zbx_malloc(NULL, sizeof(zbx_snmp_value_cache_t));
-
-			if (SUCCEED != zbx_snmp_value_cache_init(snmp_cache, value->data.str, &cache->error))
-			{
-				zbx_free(snmp_cache);
-				*errmsg = zbx_strdup(NULL, cache->error);
-				return FAIL;
-			}
-
-			cache->data = (void *)snmp_cache;
-		}
-
 		ret = snmp_value_from_cached_walk(snmp_cache, params, &value_out, &err);
 	}
 
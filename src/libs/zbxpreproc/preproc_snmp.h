@@ -77,6 +77,7 @@ zbx_snmp_walk_json_output_obj_t;
 
 int	zbx_snmp_value_cache_init(zbx_snmp_value_cache_t *cache, const char *data, char **error);
 void	zbx_snmp_value_cache_clear(zbx_snmp_value_cache_t *cache);
+size_t	zbx_snmp_value_cache_get_size(const zbx_snmp_value_cache_t *cache);
 
 int	item_preproc_snmp_walk_to_value(zbx_pp_cache_t *cache, zbx_variant_t *value, const char *params, char **errmsg);
 int	item_preproc_snmp_walk_to_json(zbx_variant_t *value, const char *params, char **errmsg);
@@ -1710,6 +1710,58 @@ void	zbx_prometheus_clear(zbx_prometheus_t *prom)
 	pthread_mutex_destroy(&prom->index_lock);
 }
 
+static size_t	prometheus_str_size(const char *str)
+{
+	return NULL == str ? 0 : strlen(str) + 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get memory allocated for parsed prometheus data                   *
+ *                                                                            *
+ * Parameters: prom - [IN] the prometheus cache                               *
+ *                                                                            *
+ * Return value: The allocated memory size of parsed rows and hints.          *
+ *                                                                            *
+ * Comments: Label indexes are created on demand by queries and are not       *
+ *           included.                                                        *
+ *                                                                            *
+ ******************************************************************************/
+size_t	zbx_prometheus_get_size(const zbx_prometheus_t *prom)
+{
+	size_t				size;
+	zbx_hashset_const_iter_t	iter;
+	const zbx_prometheus_hint_t	*hint;
+
+	size = (size_t)prom->rows.values_alloc * sizeof(zbx_prometheus_row_t *);
+
+	for (int i = 0; i < prom->rows.values_num; i++)
+	{
+		const zbx_prometheus_row_t	*row = prom->rows.values[i];
+
+		size += sizeof(zbx_prometheus_row_t) + prometheus_str_size(row->metric) +
+				prometheus_str_size(row->value) + prometheus_str_size(row->raw) +
+				(size_t)row->labels.values_alloc * sizeof(zbx_prometheus_label_t *);
+
+		for (int j = 0; j < row->labels.values_num; j++)
+		{
+			size += sizeof(zbx_prometheus_label_t) + prometheus_str_size(row->labels.values[j]->name) +
+					prometheus_str_size(row->labels.values[j]->value);
+		}
+	}
+
+	size += zbx_hashset_get_size(&prom->hints, sizeof(zbx_prometheus_hint_t));
+
+	zbx_hashset_const_iter_reset(&prom->hints, &iter);
+	while (NULL != (hint = (const zbx_prometheus_hint_t *)zbx_hashset_const_iter_next(&iter)))
+	{
+		size += prometheus_str_size(hint->metric) + prometheus_str_size(hint->type) +
+				prometheus_str_size(hint->help);
+	}
+
+	return size;
+}
+
 static void	prometheus_lock(zbx_prometheus_t *prom)
 {
 	if (0 != pthread_mutex_lock(&prom->index_lock))
@@ -49,8 +49,25 @@ zbx_match_t;
 ZBX_PTR_VECTOR_DECL(match, zbx_match_t *)
 ZBX_PTR_VECTOR_IMPL(match, zbx_match_t *)
 
-static ZBX_THREAD_LOCAL zbx_regexp_t	*curr_regexp = NULL;
-static ZBX_THREAD_LOCAL char		*curr_pattern = NULL;
+/* number of compiled regular expressions cached per thread */
+#define ZBX_REGEXP_CACHE_SIZE	16
+
+typedef struct
+{
+	char		*pattern;
+	uint32_t	flags;
+	zbx_regexp_t	*regexp;
+}
+zbx_regexp_cache_entry_t;
+
+/* the most recently used regular expressions are kept at the beginning of cache */
+static ZBX_THREAD_LOCAL zbx_regexp_cache_entry_t	regexp_cache[ZBX_REGEXP_CACHE_SIZE];
+static ZBX_THREAD_LOCAL int				regexp_cache_num = 0;
+static ZBX_THREAD_LOCAL zbx_uint64_t			regexp_cache_hits = 0;
+static ZBX_THREAD_LOCAL zbx_uint64_t			regexp_cache_misses = 0;
+
+/* match data block reused by all matches in the thread */
+static ZBX_THREAD_LOCAL pcre2_match_data		*regexp_match_data = NULL;
 
 #ifdef HAVE_PCRE2_H
 static void	zbx_match_free(zbx_match_t *match)
@@ -145,6 +162,10 @@ static int	regexp_compile(const char *pattern, uint32_t flags, zbx_regexp_t **re
 			return FAIL;
 		}
 
+		/* JIT compilation is optional - if it is not supported or fails the */
+		/* regular expression is matched by interpreter                       */
+		(void)pcre2_jit_compile(pcre2_regexp, PCRE2_JIT_COMPLETE);
+
 		*regexp = (zbx_regexp_t *)zbx_malloc(NULL, sizeof(zbx_regexp_t));
 		(*regexp)->pcre2_regexp = pcre2_regexp;
 		(*regexp)->match_ctx = match_ctx;
@@ -203,37 +224,70 @@ int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp,
 
 /****************************************************************************************************
  *                                                                                                  *
- * Purpose: wrapper for zbx_regexp_compile. Caches and reuses the last used regexp.                 *
+ * Purpose: wrapper for zbx_regexp_compile. Caches and reuses the recently used regexps.            *
+ *                                                                                                  *
+ * Comments: The returned regexp is owned by cache and stays valid until it is evicted by           *
+ *           ZBX_REGEXP_CACHE_SIZE other regexps prepared in the same thread.                       *
  *                                                                                                  *
  ****************************************************************************************************/
 static int	regexp_prepare(const char *pattern, uint32_t flags, zbx_regexp_t **regexp, char **err_msg)
 {
-	static ZBX_THREAD_LOCAL uint32_t	curr_flags = 0;
-	int					ret = SUCCEED;
+	zbx_regexp_cache_entry_t	entry;
+	int				i;
 
-	if (NULL == curr_regexp || 0 != strcmp(curr_pattern, pattern) || curr_flags != flags)
+	for (i = 0; i < regexp_cache_num; i++)
 	{
-		if (NULL != curr_regexp)
-		{
-			zbx_regexp_free(curr_regexp);
-			zbx_free(curr_pattern);
-		}
+		if (regexp_cache[i].flags == flags && 0 == strcmp(regexp_cache[i].pattern, pattern))
+			break;
+	}
 
-		curr_regexp = NULL;
-		curr_pattern = NULL;
-		curr_flags = 0;
+	if (i < regexp_cache_num)
+	{
+		regexp_cache_hits++;
+		entry = regexp_cache[i];
+	}
+	else
+	{
+		regexp_cache_misses++;
+
+		if (SUCCEED != regexp_compile(pattern, flags, &entry.regexp, err_msg))
+			return FAIL;
+
+		entry.pattern = zbx_strdup(NULL, pattern);
+		entry.flags = flags;
 
-		if (SUCCEED == regexp_compile(pattern, flags, &curr_regexp, err_msg))
+		if (ZBX_REGEXP_CACHE_SIZE == regexp_cache_num)
 		{
-			curr_pattern = zbx_strdup(curr_pattern, pattern);
-			curr_flags = flags;
+			i = --regexp_cache_num;
+			zbx_regexp_free(regexp_cache[i].regexp);
+			zbx_free(regexp_cache[i].pattern);
 		}
 		else
-			ret = FAIL;
+			i = regexp_cache_num;
+
+		regexp_cache_num++;
 	}
 
-	*regexp = curr_regexp;
-	return ret;
+	memmove(&regexp_cache[1], &regexp_cache[0], (size_t)i * sizeof(zbx_regexp_cache_entry_t));
+	regexp_cache[0] = entry;
+
+	*regexp = entry.regexp;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets regular expression cache statistics of the calling thread    *
+ *                                                                            *
+ * Parameters: hits   - [OUT] number of patterns found in cache               *
+ *             misses - [OUT] number of patterns compiled                     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_regexp_cache_get_stats(zbx_uint64_t *hits, zbx_uint64_t *misses)
+{
+	*hits = regexp_cache_hits;
+	*misses = regexp_cache_misses;
 }
 
 /* calculate recursion limit, PCRE man page suggests to reckon on about 500 bytes per recursion */
@@ -259,10 +313,23 @@ void	zbx_init_regexp_env(void)
 
 void	zbx_deinit_regexp_env(void)
 {
-	if (NULL != curr_regexp)
+	int	i;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "regular expression cache hits:" ZBX_FS_UI64 " misses:" ZBX_FS_UI64,
+			regexp_cache_hits, regexp_cache_misses);
+
+	for (i = 0; i < regexp_cache_num; i++)
+	{
+		zbx_regexp_free(regexp_cache[i].regexp);
+		zbx_free(regexp_cache[i].pattern);
+	}
+
+	regexp_cache_num = 0;
+
+	if (NULL != regexp_match_data)
 	{
-		zbx_regexp_free(curr_regexp);
-		zbx_free(curr_pattern);
+		pcre2_match_data_free(regexp_match_data);
+		regexp_match_data = NULL;
 	}
 }
 
@@ -369,7 +436,16 @@ static int	regexp_exec(const char *string, const zbx_regexp_t *regexp, int flags
 	pcre2_set_match_limit(regexp->match_ctx, 1000000);
 
 	pcre2_set_recursion_limit(regexp->match_ctx, (uint32_t)compute_match_recursion_limit());
-	match_data = pcre2_match_data_create((uint32_t)count, NULL);
+
+	if (ZBX_REGEXP_GROUPS_MAX >= count)
+	{
+		if (NULL == regexp_match_data)
+			regexp_match_data = pcre2_match_data_create(ZBX_REGEXP_GROUPS_MAX, NULL);
+
+		match_data = regexp_match_data;
+	}
+	else
+		match_data = pcre2_match_data_create((uint32_t)count, NULL);
 
 	if (NULL == match_data)
 	{
@@ -382,8 +458,17 @@ static int	regexp_exec(const char *string, const zbx_regexp_t *regexp, int flags
 		flags |= PCRE2_NO_UTF_CHECK;
 #endif
 
-		if (0 <= (r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, offset,
-			flags, match_data, regexp->match_ctx)))
+		r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, offset, flags,
+				match_data, regexp->match_ctx);
+
+		/* JIT uses small machine stack, fall back to interpreter which uses heap and recursion limit */
+		if (PCRE2_ERROR_JIT_STACKLIMIT == r)
+		{
+			r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, offset,
+					flags | PCRE2_NO_JIT, match_data, regexp->match_ctx);
+		}
+
+		if (0 <= r)
 		{
 			if (NULL != matches)
 			{
@@ -423,7 +508,8 @@ static int	regexp_exec(const char *string, const zbx_regexp_t *regexp, int flags
 			result = FAIL;
 		}
 
-		pcre2_match_data_free(match_data);
+		if (match_data != regexp_match_data)
+			pcre2_match_data_free(match_data);
 	}
 
 	return result;
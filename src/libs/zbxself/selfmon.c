@@ -33,11 +33,13 @@ typedef struct
 	zbx_timekeeper_t	*monitor;
 	zbx_timekeeper_sync_t	sync;
 	int			process_index[ZBX_PROCESS_TYPE_COUNT];
+	zbx_uint64_t		*counters;	/* ZBX_SELFMON_COUNTER_COUNT counters per monitored process */
 }
 zbx_selfmon_collector_t;
 
-static zbx_selfmon_collector_t	collector;
-static zbx_get_config_forks_f	get_config_forks_cb = NULL;
+static zbx_selfmon_collector_t		collector;
+static zbx_get_config_forks_f		get_config_forks_cb = NULL;
+static zbx_get_selfmon_counters_f	get_counters_cb = NULL;
 
 static zbx_mutex_t	sm_lock = ZBX_MUTEX_NULL;
 
@@ -79,16 +81,23 @@ static int	selfmon_is_process_monitored(unsigned char proc_type)
  * Purpose: Initialize structures and prepare state                           *
  *          for self-monitoring collector                                     *
  *                                                                            *
+ * Parameters: get_config_forks - [IN] returns number of processes by type    *
+ *             get_counters     - [IN] returns process local counters, see    *
+ *                                     ZBX_SELFMON_COUNTER_* defines          *
+ *             error            - [OUT]                                       *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, char **error)
+int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, zbx_get_selfmon_counters_f get_counters,
+		char **error)
 {
-	size_t		sz_total;
+	size_t		sz_total, sz_counters;
 	unsigned char	proc_type;
 	int		units_num = 0, ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	get_config_forks_cb = get_config_forks;
+	get_counters_cb = get_counters;
 
 	for (proc_type = 0; ZBX_PROCESS_TYPE_COUNT > proc_type; proc_type++)
 	{
@@ -99,7 +108,9 @@ int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, char **e
 		units_num += get_config_forks_cb(proc_type);
 	}
 
-	sz_total = zbx_timekeeper_get_memmalloc_size(units_num);
+	/* counters array + allocation overhead */
+	sz_counters = sizeof(zbx_uint64_t) * ZBX_SELFMON_COUNTER_COUNT * (size_t)units_num + 2 * sizeof(zbx_uint64_t);
+	sz_total = zbx_timekeeper_get_memmalloc_size(units_num) + sz_counters;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "%s() size:" ZBX_FS_SIZE_T, __func__, (zbx_fs_size_t)sz_total);
 
@@ -112,6 +123,10 @@ int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, char **e
 	zbx_timekeeper_sync_init(&collector.sync, sm_sync_lock, sm_sync_unlock, (void *)&sm_lock);
 	collector.monitor = zbx_timekeeper_create_ext(units_num, &collector.sync, __sm_shmem_malloc_func,
 			__sm_shmem_realloc_func, __sm_shmem_free_func);
+
+	sz_counters = sizeof(zbx_uint64_t) * ZBX_SELFMON_COUNTER_COUNT * (size_t)units_num;
+	collector.counters = (zbx_uint64_t *)__sm_shmem_malloc_func(NULL, sz_counters);
+	memset(collector.counters, 0, sz_counters);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() collector.monitor:%p", __func__, (void *)collector.monitor);
 
@@ -131,6 +146,8 @@ void	zbx_free_selfmon_collector(void)
 		return;
 
 	zbx_timekeeper_free(collector.monitor);
+	__sm_shmem_free_func(collector.counters);
+	collector.counters = NULL;
 
 	zbx_mutex_destroy(&sm_lock);
 
@@ -152,6 +169,17 @@ void	zbx_update_selfmon_counter(const zbx_thread_info_t *info, unsigned char sta
 
 	zbx_timekeeper_update(collector.monitor, unit_index, state);
 
+	/* publish process local counters when process has finished its work */
+	if (ZBX_PROCESS_STATE_IDLE == state && NULL != get_counters_cb)
+	{
+		zbx_uint64_t	counters[ZBX_SELFMON_COUNTER_COUNT] = {0};
+
+		get_counters_cb(counters);
+
+		zbx_mutex_lock(sm_lock);
+		memcpy(collector.counters + unit_index * ZBX_SELFMON_COUNTER_COUNT, counters, sizeof(counters));
+		zbx_mutex_unlock(sm_lock);
+	}
 }
 
 static void	collect_selfmon_stats(void)
@@ -212,6 +240,78 @@ void	zbx_get_selfmon_stats(unsigned char proc_type, unsigned char aggr_func, int
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets process local counter published by selected process(es)      *
+ *                                                                            *
+ * Parameters: proc_type - [IN] type of process; ZBX_PROCESS_TYPE_*           *
+ *             aggr_func - [IN] one of ZBX_SELFMON_AGGR_FUNC_*                *
+ *             proc_num  - [IN] process number; 1 - first process;            *
+ *                              0 - all processes                             *
+ *             counter   - [IN] one of ZBX_SELFMON_COUNTER_*                  *
+ *             value     - [OUT] counter value                                *
+ *                                                                            *
+ * Return value: SUCCEED - counter value was retrieved                        *
+ *               FAIL    - process is not monitored                           *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_get_selfmon_counter(unsigned char proc_type, unsigned char aggr_func, int proc_num, int counter,
+		zbx_uint64_t *value)
+{
+	int	unit_index, unit_count, i;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proc_type:%u proc_num:%d counter:%d", __func__, proc_type, proc_num,
+			counter);
+
+	if (SUCCEED != selfmon_is_process_monitored(proc_type) || NULL == collector.counters)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "End of %s():FAIL", __func__);
+		return FAIL;
+	}
+
+	unit_index = collector.process_index[proc_type];
+
+	if (0 < proc_num)
+	{
+		unit_index += proc_num - 1;
+		unit_count = 1;
+	}
+	else
+		unit_count = get_config_forks_cb(proc_type);
+
+	*value = 0;
+
+	zbx_mutex_lock(sm_lock);
+
+	for (i = 0; i < unit_count; i++)
+	{
+		zbx_uint64_t	unit_value = collector.counters[(unit_index + i) * ZBX_SELFMON_COUNTER_COUNT + counter];
+
+		switch (aggr_func)
+		{
+			case ZBX_SELFMON_AGGR_FUNC_MAX:
+				if (0 == i || unit_value > *value)
+					*value = unit_value;
+				break;
+			case ZBX_SELFMON_AGGR_FUNC_MIN:
+				if (0 == i || unit_value < *value)
+					*value = unit_value;
+				break;
+			default:
+				*value += unit_value;
+		}
+	}
+
+	zbx_mutex_unlock(sm_lock);
+
+	if (ZBX_SELFMON_AGGR_FUNC_AVG == aggr_func && 0 < unit_count)
+		*value /= (zbx_uint64_t)unit_count;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():SUCCEED value:" ZBX_FS_UI64, __func__, *value);
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: retrieves internal metrics of all running processes based on      *
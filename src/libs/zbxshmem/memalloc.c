@@ -77,6 +77,21 @@
  *  lo_bound             `size' fields in chunk B                   hi_bound  *
  *  (aligned)            have SHMEM_FLG_USED bit set               (aligned)  *
  *                                                                            *
+ * (*) in slab mode small allocations (up to SHMEM_MAX_BUCKET_SIZE bytes) are *
+ *     served from slabs - used chunks of SHMEM_SLAB_SIZE bytes split into    *
+ *     objects of the same size class:                                        *
+ *                                                                            *
+ *                |--------|---------|--------|-------|--------|-------|...   *
+ *                  size     slab     object   user    object   user          *
+ *                           header   header   data    header   data          *
+ *                                                                            *
+ *     object header has SHMEM_FLG_USED and SHMEM_FLG_SLAB bits set and the   *
+ *     offset of the object from the slab header in the remaining bits, so   *
+ *     the owning slab can be found in constant time when freeing             *
+ *                                                                            *
+ *     free objects of a slab are kept in a singly-linked list stored in the  *
+ *     user data, slabs with free objects are kept in a per class list        *
+ *                                                                            *
  ******************************************************************************/
 
 static void	*ALIGN4(void *ptr);
@@ -106,6 +121,7 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr);
 #define SHMEM_SIZE_FIELD	sizeof(zbx_uint64_t)
 
 #define SHMEM_FLG_USED		((__UINT64_C(1))<<63)
+#define SHMEM_FLG_SLAB		((__UINT64_C(1))<<62)
 
 #define FREE_CHUNK(ptr)		(((*(zbx_uint64_t *)(ptr)) & SHMEM_FLG_USED) == 0)
 #define CHUNK_SIZE(ptr)		((*(zbx_uint64_t *)(ptr)) & ~SHMEM_FLG_USED)
@@ -113,6 +129,34 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr);
 #define SHMEM_MIN_SIZE		__UINT64_C(128)
 #define SHMEM_MAX_SIZE		__UINT64_C(0x1000000000)	/* 64 GB */
 
+#define SHMEM_SLAB_SIZE		__UINT64_C(4096)
+
+#define SLAB_OBJECT(ptr)	(0 != ((*(zbx_uint64_t *)(ptr)) & SHMEM_FLG_SLAB))
+#define SLAB_OBJECT_OFFSET(ptr)	((*(zbx_uint64_t *)(ptr)) & ~(SHMEM_FLG_USED | SHMEM_FLG_SLAB))
+
+typedef struct shmem_slab
+{
+	struct shmem_slab	*prev;
+	struct shmem_slab	*next;
+	void			*free_list;
+	zbx_uint32_t		used_num;
+	zbx_uint32_t		objects_num;
+	zbx_uint32_t		unused_index;
+	zbx_uint32_t		class_index;
+}
+shmem_slab_t;
+
+typedef struct
+{
+	/* slabs having free objects */
+	shmem_slab_t	*partial;
+	zbx_uint32_t	slabs_num;
+	zbx_uint32_t	used_num;
+	zbx_uint32_t	objects_num;
+	zbx_uint32_t	object_size;
+}
+shmem_slab_class_t;
+
 /* helper functions */
 
 static void	*ALIGN4(void *ptr)
@@ -521,10 +565,257 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr)
 	}
 }
 
+/* slab allocation functions */
+
+static void	mem_slab_classes_init(shmem_slab_class_t *classes)
+{
+	int	i;
+
+	for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+	{
+		classes[i].partial = NULL;
+		classes[i].slabs_num = 0;
+		classes[i].used_num = 0;
+		classes[i].object_size = ZBX_SHMEM_MIN_BUCKET_SIZE + 8 * i;
+		classes[i].objects_num = (zbx_uint32_t)((SHMEM_SLAB_SIZE - sizeof(shmem_slab_t)) /
+				(SHMEM_SIZE_FIELD + classes[i].object_size));
+	}
+}
+
+static void	mem_slab_link(shmem_slab_class_t *cls, shmem_slab_t *slab)
+{
+	slab->prev = NULL;
+	slab->next = cls->partial;
+
+	if (NULL != cls->partial)
+		cls->partial->prev = slab;
+
+	cls->partial = slab;
+}
+
+static void	mem_slab_unlink(shmem_slab_class_t *cls, shmem_slab_t *slab)
+{
+	if (NULL != slab->prev)
+		slab->prev->next = slab->next;
+	else
+		cls->partial = slab->next;
+
+	if (NULL != slab->next)
+		slab->next->prev = slab->prev;
+
+	slab->prev = NULL;
+	slab->next = NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates new slab for the specified size class                   *
+ *                                                                            *
+ * Comments: The slab memory is moved from used to free/overhead statistics,  *
+ *           so that only the allocated objects are reported as used.         *
+ *                                                                            *
+ ******************************************************************************/
+static shmem_slab_t	*mem_slab_create(zbx_shmem_info_t *info, int class_index)
+{
+	shmem_slab_class_t	*cls = (shmem_slab_class_t *)info->slab_classes + class_index;
+	shmem_slab_t		*slab;
+	void			*chunk;
+	zbx_uint64_t		objects_size;
+
+	if (NULL == (chunk = __mem_malloc(info, SHMEM_SLAB_SIZE)))
+		return NULL;
+
+	objects_size = (zbx_uint64_t)cls->objects_num * cls->object_size;
+
+	info->used_size -= CHUNK_SIZE(chunk);
+	info->free_size += objects_size;
+	info->slab_overhead += CHUNK_SIZE(chunk) - objects_size;
+
+	slab = (shmem_slab_t *)((char *)chunk + SHMEM_SIZE_FIELD);
+	slab->free_list = NULL;
+	slab->used_num = 0;
+	slab->objects_num = cls->objects_num;
+	slab->unused_index = 0;
+	slab->class_index = (zbx_uint32_t)class_index;
+
+	mem_slab_link(cls, slab);
+	cls->slabs_num++;
+
+	return slab;
+}
+
+static void	mem_slab_destroy(zbx_shmem_info_t *info, shmem_slab_t *slab)
+{
+	shmem_slab_class_t	*cls = (shmem_slab_class_t *)info->slab_classes + slab->class_index;
+	void			*chunk = (char *)slab - SHMEM_SIZE_FIELD;
+	zbx_uint64_t		objects_size;
+
+	mem_slab_unlink(cls, slab);
+	cls->slabs_num--;
+
+	objects_size = (zbx_uint64_t)cls->objects_num * cls->object_size;
+
+	info->used_size += CHUNK_SIZE(chunk);
+	info->free_size -= objects_size;
+	info->slab_overhead -= CHUNK_SIZE(chunk) - objects_size;
+
+	__mem_free(info, slab);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates object from slab of the corresponding size class        *
+ *                                                                            *
+ * Parameters: info - [IN] shared memory information                          *
+ *             size - [IN] proper allocation size, must not exceed            *
+ *                         SHMEM_MAX_BUCKET_SIZE                              *
+ *                                                                            *
+ * Return value: The object header or NULL if there is not enough memory.     *
+ *                                                                            *
+ * Comments: Falls back to general allocation if a new slab cannot be         *
+ *           allocated.                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	*mem_slab_malloc(zbx_shmem_info_t *info, zbx_uint64_t size)
+{
+	int			class_index;
+	shmem_slab_class_t	*cls;
+	shmem_slab_t		*slab;
+	void			*object;
+
+	class_index = mem_bucket_by_size(size);
+	cls = (shmem_slab_class_t *)info->slab_classes + class_index;
+
+	if (NULL == (slab = cls->partial) && NULL == (slab = mem_slab_create(info, class_index)))
+		return __mem_malloc(info, size);
+
+	if (NULL != slab->free_list)
+	{
+		object = slab->free_list;
+		slab->free_list = *(void **)((char *)object + SHMEM_SIZE_FIELD);
+	}
+	else
+	{
+		object = (char *)(slab + 1) + (SHMEM_SIZE_FIELD + cls->object_size) * slab->unused_index++;
+		*(zbx_uint64_t *)object = SHMEM_FLG_USED | SHMEM_FLG_SLAB | (zbx_uint64_t)((char *)object -
+				(char *)slab);
+	}
+
+	if (++slab->used_num == slab->objects_num)
+		mem_slab_unlink(cls, slab);
+
+	cls->used_num++;
+	info->used_size += cls->object_size;
+	info->free_size -= cls->object_size;
+
+	return object;
+}
+
+static void	mem_slab_free(zbx_shmem_info_t *info, void *object)
+{
+	shmem_slab_t		*slab;
+	shmem_slab_class_t	*cls;
+
+	slab = (shmem_slab_t *)((char *)object - SLAB_OBJECT_OFFSET(object));
+	cls = (shmem_slab_class_t *)info->slab_classes + slab->class_index;
+
+	if (slab->used_num-- == slab->objects_num)
+		mem_slab_link(cls, slab);
+
+	*(void **)((char *)object + SHMEM_SIZE_FIELD) = slab->free_list;
+	slab->free_list = object;
+
+	cls->used_num--;
+	info->used_size -= cls->object_size;
+	info->free_size += cls->object_size;
+
+	/* keep the last partial slab of a class to avoid allocating it again on the next request */
+	if (0 == slab->used_num && (cls->partial != slab || NULL != slab->next))
+		mem_slab_destroy(info, slab);
+}
+
+static void	*mem_slab_realloc(zbx_shmem_info_t *info, void *object, zbx_uint64_t size)
+{
+	shmem_slab_t		*slab;
+	shmem_slab_class_t	*cls;
+	void			*new_object;
+
+	slab = (shmem_slab_t *)((char *)object - SLAB_OBJECT_OFFSET(object));
+	cls = (shmem_slab_class_t *)info->slab_classes + slab->class_index;
+
+	size = mem_proper_alloc_size(size);
+
+	if (size <= cls->object_size)
+		return object;
+
+	if (SHMEM_MAX_BUCKET_SIZE >= size)
+		new_object = mem_slab_malloc(info, size);
+	else
+		new_object = __mem_malloc(info, size);
+
+	if (NULL == new_object)
+		return NULL;
+
+	memcpy((char *)new_object + SHMEM_SIZE_FIELD, (char *)object + SHMEM_SIZE_FIELD, cls->object_size);
+	mem_slab_free(info, object);
+
+	return new_object;
+}
+
+static void	*mem_malloc(zbx_shmem_info_t *info, zbx_uint64_t size)
+{
+	if (NULL != info->slab_classes && SHMEM_MAX_BUCKET_SIZE >= mem_proper_alloc_size(size))
+		return mem_slab_malloc(info, mem_proper_alloc_size(size));
+
+	return __mem_malloc(info, size);
+}
+
+static void	*mem_realloc(zbx_shmem_info_t *info, void *old, zbx_uint64_t size)
+{
+	if (SLAB_OBJECT((char *)old - SHMEM_SIZE_FIELD))
+		return mem_slab_realloc(info, (char *)old - SHMEM_SIZE_FIELD, size);
+
+	return __mem_realloc(info, old, size);
+}
+
+static void	mem_free(zbx_shmem_info_t *info, void *ptr)
+{
+	if (SLAB_OBJECT((char *)ptr - SHMEM_SIZE_FIELD))
+		mem_slab_free(info, (char *)ptr - SHMEM_SIZE_FIELD);
+	else
+		__mem_free(info, ptr);
+}
+
 /* public memory interface */
 
 int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error)
+{
+	return zbx_shmem_create_ext(info, size, descr, param, allow_oom, ZBX_SHMEM_MODE_DEFAULT, error);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates shared memory segment with the specified allocator mode   *
+ *                                                                            *
+ * Parameters: info      - [OUT] shared memory information                    *
+ *             size      - [IN] shared memory size                            *
+ *             descr     - [IN] shared memory description                     *
+ *             param     - [IN] configuration parameter defining the size     *
+ *             allow_oom - [IN] 1 - return NULL when out of memory,           *
+ *                              0 - exit when out of memory                   *
+ *             mode      - [IN] allocator mode:                               *
+ *                              ZBX_SHMEM_MODE_DEFAULT - first-fit allocation *
+ *                              ZBX_SHMEM_MODE_SLAB - small allocations are   *
+ *                                  served from fixed size class slabs        *
+ *             error     - [OUT] error message                                *
+ *                                                                            *
+ * Return value: SUCCEED - the memory was allocated successfully              *
+ *               FAIL - otherwise                                             *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_shmem_create_ext(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
+		int allow_oom, int mode, char **error)
 {
 	int	shm_id, index, ret = FAIL;
 	void	*base;
@@ -584,6 +875,21 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 	size -= (char *)((*info)->buckets + ZBX_SHMEM_BUCKET_COUNT) - (char *)base;
 	base = (void *)((*info)->buckets + ZBX_SHMEM_BUCKET_COUNT);
 
+	(*info)->slab_overhead = 0;
+
+	if (ZBX_SHMEM_MODE_SLAB == mode)
+	{
+		shmem_slab_class_t	*classes;
+
+		classes = (shmem_slab_class_t *)ALIGN8(base);
+		mem_slab_classes_init(classes);
+		(*info)->slab_classes = classes;
+		size -= (char *)(classes + ZBX_SHMEM_SLAB_CLASS_COUNT) - (char *)base;
+		base = (void *)(classes + ZBX_SHMEM_SLAB_CLASS_COUNT);
+	}
+	else
+		(*info)->slab_classes = NULL;
+
 	zbx_strlcpy((char *)base, descr, size);
 	(*info)->mem_descr = (char *)base;
 	size -= strlen(descr) + 1;
@@ -613,10 +919,11 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 	(*info)->used_size = 0;
 	(*info)->free_size = (*info)->total_size;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "shmid: %d valid user addresses: [%p, %p] total size: " ZBX_FS_SIZE_T, shm_id,
+	zabbix_log(LOG_LEVEL_DEBUG, "shmid: %d valid user addresses: [%p, %p] total size: " ZBX_FS_SIZE_T
+			" slab mode: %s", shm_id,
 			(void *)((char *)(*info)->lo_bound + SHMEM_SIZE_FIELD),
 			(void *)((char *)(*info)->hi_bound - SHMEM_SIZE_FIELD),
-			(zbx_fs_size_t)(*info)->total_size);
+			(zbx_fs_size_t)(*info)->total_size, NULL != (*info)->slab_classes ? "yes" : "no");
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
@@ -682,7 +989,7 @@ void	*__zbx_shmem_malloc(const char *file, int line, zbx_shmem_info_t *info, con
 		exit(EXIT_FAILURE);
 	}
 
-	chunk = __mem_malloc(info, size);
+	chunk = mem_malloc(info, size);
 
 	if (NULL == chunk)
 	{
@@ -718,9 +1025,9 @@ void	*__zbx_shmem_realloc(const char *file, int line, zbx_shmem_info_t *info, vo
 	}
 
 	if (NULL == old)
-		chunk = __mem_malloc(info, size);
+		chunk = mem_malloc(info, size);
 	else
-		chunk = __mem_realloc(info, old, size);
+		chunk = mem_realloc(info, old, size);
 
 	if (NULL == chunk)
 	{
@@ -752,7 +1059,7 @@ void	__zbx_shmem_free(const char *file, int line, zbx_shmem_info_t *info, void *
 		exit(EXIT_FAILURE);
 	}
 
-	__mem_free(info, ptr);
+	mem_free(info, ptr);
 }
 
 void	zbx_shmem_clear(zbx_shmem_info_t *info)
@@ -770,6 +1077,11 @@ void	zbx_shmem_clear(zbx_shmem_info_t *info)
 	info->used_size = 0;
 	info->free_size = info->total_size;
 
+	if (NULL != info->slab_classes)
+		mem_slab_classes_init((shmem_slab_class_t *)info->slab_classes);
+
+	info->slab_overhead = 0;
+
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
@@ -804,9 +1116,30 @@ void	zbx_shmem_get_stats(const zbx_shmem_info_t *info, zbx_shmem_stats_t *stats)
 		stats->min_chunk_size = 0;
 
 	stats->overhead = info->total_size - info->used_size - info->free_size;
-	stats->used_chunks = stats->overhead / (2 * SHMEM_SIZE_FIELD) + 1 - stats->free_chunks;
+	stats->used_chunks = (stats->overhead - info->slab_overhead) / (2 * SHMEM_SIZE_FIELD) + 1 -
+			stats->free_chunks;
 	stats->free_size = info->free_size;
 	stats->used_size = info->used_size;
+
+	stats->slabs_num = 0;
+
+	for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+	{
+		const shmem_slab_class_t	*cls;
+
+		if (NULL == info->slab_classes)
+		{
+			stats->slab_used_num[i] = 0;
+			stats->slab_free_num[i] = 0;
+			continue;
+		}
+
+		cls = (const shmem_slab_class_t *)info->slab_classes + i;
+
+		stats->slabs_num += cls->slabs_num;
+		stats->slab_used_num[i] = cls->used_num;
+		stats->slab_free_num[i] = cls->slabs_num * cls->objects_num - cls->used_num;
+	}
 }
 
 void	zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info)
@@ -840,6 +1173,22 @@ void	zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info)
 	zabbix_log(level, "of those, %10llu bytes are used by allocation overhead",
 			(unsigned long long)stats.overhead);
 
+	if (NULL != info->slab_classes)
+	{
+		zabbix_log(level, "of those, %10llu bytes are used by %u slabs",
+				(unsigned long long)info->slab_overhead, stats.slabs_num);
+
+		for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+		{
+			if (0 == stats.slab_used_num[i] + stats.slab_free_num[i])
+				continue;
+
+			zabbix_log(level, "slab objects of size %3d bytes: %8u used %8u free",
+					ZBX_SHMEM_MIN_BUCKET_SIZE + 8 * i, stats.slab_used_num[i],
+					stats.slab_free_num[i]);
+		}
+	}
+
 	zabbix_log(level, "================================");
 }
 
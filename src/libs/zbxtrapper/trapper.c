@@ -54,6 +54,8 @@
 #	include "zbxipcservice.h"
 #endif
 
+#include <event2/event.h>
+
 #define ZBX_MAX_SECTION_ENTRIES		4
 #define ZBX_MAX_ENTRY_ATTRIBUTES	3
 
@@ -169,13 +171,48 @@ int	zbx_check_frontend_conn_accept(zbx_socket_t *sock, const zbx_config_tls_t *c
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if client asked to keep connection open for next request   *
+ *                                                                            *
+ ******************************************************************************/
+static int	keepalive_requested(const struct zbx_json_parse *jp)
+{
+	char	value[MAX_ID_LEN + 1];
+
+	if (SUCCEED != zbx_json_value_by_name(jp, ZBX_PROTO_TAG_KEEPALIVE, value, sizeof(value), NULL))
+		return FAIL;
+
+	return 0 == strcmp(value, ZBX_PROTO_VALUE_TRUE) ? SUCCEED : FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: grants connection keepalive to client when it was requested and   *
+ *          supported by caller                                               *
+ *                                                                            *
+ * Parameters: jp        - [IN] request data                                  *
+ *             keepalive - [OUT] set to 1 if connection is kept open, NULL    *
+ *                               when caller does not support keepalive       *
+ *             ext       - [IN/OUT] additional data of response               *
+ *                                                                            *
+ ******************************************************************************/
+static void	keepalive_grant(const struct zbx_json_parse *jp, int *keepalive, char **ext)
+{
+	if (NULL == keepalive || NULL != *ext || SUCCEED != keepalive_requested(jp))
+		return;
+
+	*ext = zbx_strdup(NULL, "{\"" ZBX_PROTO_TAG_KEEPALIVE "\":\"" ZBX_PROTO_VALUE_TRUE "\"}");
+	*keepalive = 1;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: processes received values from active agents                      *
  *                                                                            *
  ******************************************************************************/
 static void	recv_agenthistory(zbx_socket_t *sock, struct zbx_json_parse *jp, zbx_timespec_t *ts,
-		int config_timeout)
+		int config_timeout, int *keepalive)
 {
 	char	*info = NULL, *ext = NULL;
 	int	ret;
@@ -210,6 +247,9 @@ static void	recv_agenthistory(zbx_socket_t *sock, struct zbx_json_parse *jp, zbx
 
 	zbx_process_command_results(jp);
 
+	if (SUCCEED == ret)
+		keepalive_grant(jp, keepalive, &ext);
+
 	zbx_send_response_json(sock, ret, info, NULL, sock->protocol, config_timeout, ext);
 
 	zbx_free(info);
@@ -224,7 +264,7 @@ static void	recv_agenthistory(zbx_socket_t *sock, struct zbx_json_parse *jp, zbx
  *                                                                            *
  ******************************************************************************/
 static void	recv_senderhistory(zbx_socket_t *sock, struct zbx_json_parse *jp, zbx_timespec_t *ts,
-		int config_timeout)
+		int config_timeout, int *keepalive)
 {
 	char	*info = NULL, *ext = NULL;
 	int	ret;
@@ -248,6 +288,9 @@ static void	recv_senderhistory(zbx_socket_t *sock, struct zbx_json_parse *jp, zb
 		ret = FAIL;
 	}
 
+	if (SUCCEED == ret)
+		keepalive_grant(jp, keepalive, &ext);
+
 	zbx_send_response_json(sock, ret, info, NULL, sock->protocol, config_timeout, ext);
 
 	zbx_free(info);
@@ -1209,10 +1252,13 @@ static int	process_trap(zbx_socket_t *sock, char *s, zbx_timespec_t *ts,
 		const char *config_ssh_key_location, const char *config_webdriver_url,
 		zbx_trapper_process_request_func_t trapper_process_request_cb,
 		zbx_autoreg_update_host_func_t autoreg_update_host_cb, const char *config_frontend_allowed_ip,
-		zbx_ipc_async_socket_t *rtc)
+		zbx_ipc_async_socket_t *rtc, int *keepalive)
 {
 	int	ret = SUCCEED;
 
+	if (NULL != keepalive)
+		*keepalive = 0;
+
 	zbx_rtrim(s, " \r\n");
 
 	zabbix_log(LOG_LEVEL_DEBUG, "trapper got '%s'", s);
@@ -1250,11 +1296,11 @@ static int	process_trap(zbx_socket_t *sock, char *s, zbx_timespec_t *ts,
 
 		if (0 == strcmp(value, ZBX_PROTO_VALUE_AGENT_DATA))
 		{
-			recv_agenthistory(sock, &jp, ts, config_comms->config_timeout);
+			recv_agenthistory(sock, &jp, ts, config_comms->config_timeout, keepalive);
 		}
 		else if (0 == strcmp(value, ZBX_PROTO_VALUE_SENDER_DATA))
 		{
-			recv_senderhistory(sock, &jp, ts, config_comms->config_timeout);
+			recv_senderhistory(sock, &jp, ts, config_comms->config_timeout, keepalive);
 		}
 		else if (0 == strcmp(value, ZBX_PROTO_VALUE_PROXY_HEARTBEAT))
 		{
@@ -1416,7 +1462,401 @@ static void	process_trapper_child(zbx_socket_t *sock, zbx_timespec_t *ts,
 			config_java_gateway, config_java_gateway_port, config_externalscripts,
 			config_enable_global_scripts, zbx_get_value_internal_ext_cb, config_ssh_key_location,
 			config_webdriver_url, trapper_process_request_cb, autoreg_update_host_cb,
-			config_frontend_allowed_ip, rtc);
+			config_frontend_allowed_ip, rtc, NULL);
+}
+
+typedef struct
+{
+	struct event_base		*base;
+	struct event			**listen_events;
+	int				listening;
+	zbx_vector_ptr_t		connections;
+	zbx_socket_t			*listen_sock;
+	const zbx_thread_trapper_args	*args;
+	const zbx_thread_info_t		*info;
+	zbx_ipc_async_socket_t		*rtc;
+	double				sec;
+}
+zbx_trapper_loop_t;
+
+#define ZBX_TRAPPER_CONN_HANDSHAKE	0
+#define ZBX_TRAPPER_CONN_RECV		1
+#define ZBX_TRAPPER_CONN_IDLE		2
+
+typedef struct
+{
+	zbx_socket_t		s;
+	zbx_tcp_recv_context_t	recv_context;
+	zbx_timespec_t		ts;
+	unsigned char		state;
+	int			keepalive;
+	double			lastactivity;	/* time when the last request was processed */
+	struct event		*io_event;
+	short			io_what;
+	struct event		*timeout_event;
+	zbx_trapper_loop_t	*loop;
+}
+zbx_trapper_conn_t;
+
+static void	trapper_loop_listen(zbx_trapper_loop_t *loop, int enable)
+{
+	int	i;
+
+	if (loop->listening == enable)
+		return;
+
+	for (i = 0; i < loop->listen_sock->num_socks; i++)
+	{
+		if (0 != enable)
+			event_add(loop->listen_events[i], NULL);
+		else
+			event_del(loop->listen_events[i]);
+	}
+
+	loop->listening = enable;
+}
+
+static void	trapper_conn_free(zbx_trapper_conn_t *conn)
+{
+	zbx_trapper_loop_t	*loop = conn->loop;
+	int			i;
+
+	if (NULL != conn->io_event)
+		event_free(conn->io_event);
+
+	event_free(conn->timeout_event);
+	zbx_tcp_unaccept(&conn->s);
+
+	if (FAIL != (i = zbx_vector_ptr_search(&loop->connections, conn, ZBX_DEFAULT_PTR_COMPARE_FUNC)))
+		zbx_vector_ptr_remove(&loop->connections, i);
+
+	zbx_free(conn);
+
+	if (loop->connections.values_num < loop->args->config_max_concurrent_connections_per_trapper)
+		trapper_loop_listen(loop, 1);
+}
+
+static void	trapper_conn_event(evutil_socket_t fd, short what, void *arg);
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: waits for connection socket to become readable or writable        *
+ *                                                                            *
+ * Parameters: conn  - [IN] connection                                        *
+ *             event - [IN] POLLIN or POLLOUT                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_conn_wait(zbx_trapper_conn_t *conn, short event)
+{
+	short	io_what = (0 != (event & POLLOUT) ? EV_WRITE : EV_READ);
+
+	if (NULL == conn->io_event || io_what != conn->io_what)
+	{
+		if (NULL != conn->io_event)
+			event_free(conn->io_event);
+
+		conn->io_event = event_new(conn->loop->base, conn->s.socket, io_what, trapper_conn_event, conn);
+		conn->io_what = io_what;
+	}
+
+	event_add(conn->io_event, NULL);
+}
+
+static void	trapper_conn_process(zbx_trapper_conn_t *conn)
+{
+	zbx_trapper_loop_t		*loop = conn->loop;
+	const zbx_thread_trapper_args	*args = loop->args;
+
+	zbx_update_selfmon_counter(loop->info, ZBX_PROCESS_STATE_BUSY);
+
+	zbx_setproctitle("%s #%d [processing data]", get_process_type_string(loop->info->process_type),
+			loop->info->process_num);
+
+	loop->sec = zbx_time();
+	process_trap(&conn->s, conn->s.buffer, &conn->ts, args->config_comms, args->config_vault,
+			args->config_startup_time, args->events_cbs, args->proxydata_frequency,
+			args->get_process_forks_cb_arg, args->config_stats_allowed_ip, args->progname,
+			args->config_java_gateway, args->config_java_gateway_port, args->config_externalscripts,
+			args->config_enable_global_scripts, args->zbx_get_value_internal_ext_cb,
+			args->config_ssh_key_location, args->config_webdriver_url,
+			args->trapper_process_request_func_cb, args->autoreg_update_host_cb,
+			args->config_frontend_allowed_ip, loop->rtc, &conn->keepalive);
+	loop->sec = zbx_time() - loop->sec;
+
+	zbx_update_selfmon_counter(loop->info, ZBX_PROCESS_STATE_IDLE);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: advances accepted connection through TLS handshake and request    *
+ *          receiving without blocking, processes the request once it is      *
+ *          fully received                                                    *
+ *                                                                            *
+ * Comments: Connections kept alive by client request return to idle state    *
+ *           after the response and wait for the next request.                *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_conn_event(evutil_socket_t fd, short what, void *arg)
+{
+	zbx_trapper_conn_t	*conn = (zbx_trapper_conn_t *)arg;
+	short			event;
+	struct timeval		tv = {conn->loop->args->config_comms->config_trapper_timeout, 0};
+
+	ZBX_UNUSED(fd);
+
+	if (0 != (what & EV_TIMEOUT))
+	{
+		if (ZBX_TRAPPER_CONN_HANDSHAKE == conn->state)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "failed to accept an incoming connection: from %s: timed out",
+					conn->s.peer);
+		}
+		else
+			zabbix_log(LOG_LEVEL_DEBUG, "connection from %s timed out", conn->s.peer);
+
+		trapper_conn_free(conn);
+		return;
+	}
+
+	if (ZBX_TRAPPER_CONN_HANDSHAKE == conn->state)
+	{
+		/* Trapper has to accept all types of connections it can accept with the specified configuration. */
+		/* Only after receiving data it is known who has sent them and one can decide to accept or discard */
+		/* the data. */
+		if (SUCCEED != zbx_tcp_accept_handshake(&conn->s, ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK |
+				ZBX_TCP_SEC_UNENCRYPTED, conn->loop->args->config_comms->config_tls->tls_listen,
+				conn->loop->args->config_stats_allowed_ip, &event))
+		{
+			if (0 != event)
+			{
+				trapper_conn_wait(conn, event);
+				return;
+			}
+
+			zabbix_log(LOG_LEVEL_WARNING, "failed to accept an incoming connection: %s",
+					zbx_socket_strerror());
+			trapper_conn_free(conn);
+			return;
+		}
+
+		/* get connection timestamp */
+		zbx_timespec(&conn->ts);
+
+		zbx_tcp_recv_context_init(&conn->s, &conn->recv_context, 0);
+		conn->state = ZBX_TRAPPER_CONN_RECV;
+		evtimer_add(conn->timeout_event, &tv);
+	}
+	else if (ZBX_TRAPPER_CONN_IDLE == conn->state)
+	{
+		/* next request on kept alive connection */
+		zbx_timespec(&conn->ts);
+		conn->state = ZBX_TRAPPER_CONN_RECV;
+	}
+
+	if (FAIL == zbx_tcp_recv_context(&conn->s, &conn->recv_context, 0, &event))
+	{
+		if (0 != event)
+			trapper_conn_wait(conn, event);
+		else
+			trapper_conn_free(conn);
+
+		return;
+	}
+
+	if (NULL != conn->io_event)
+	{
+		event_free(conn->io_event);
+		conn->io_event = NULL;
+	}
+
+	evtimer_del(conn->timeout_event);
+
+	trapper_conn_process(conn);
+
+	if (0 == conn->keepalive)
+	{
+		trapper_conn_free(conn);
+		return;
+	}
+
+	zbx_tcp_recv_context_init(&conn->s, &conn->recv_context, 0);
+	conn->state = ZBX_TRAPPER_CONN_IDLE;
+	conn->lastactivity = zbx_time();
+	evtimer_add(conn->timeout_event, &tv);
+	trapper_conn_wait(conn, POLLIN);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: closes the idle connection with the least recent activity to      *
+ *          free a slot for new connection                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_loop_evict_idle(zbx_trapper_loop_t *loop)
+{
+	int			i;
+	zbx_trapper_conn_t	*stalest = NULL;
+
+	for (i = 0; i < loop->connections.values_num; i++)
+	{
+		zbx_trapper_conn_t	*conn = (zbx_trapper_conn_t *)loop->connections.values[i];
+
+		if (ZBX_TRAPPER_CONN_IDLE != conn->state)
+			continue;
+
+		if (NULL == stalest || conn->lastactivity < stalest->lastactivity)
+			stalest = conn;
+	}
+
+	if (NULL == stalest)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "closing idle connection from %s", stalest->s.peer);
+	trapper_conn_free(stalest);
+}
+
+static void	trapper_accept_event(evutil_socket_t fd, short what, void *arg)
+{
+	zbx_trapper_loop_t	*loop = (zbx_trapper_loop_t *)arg;
+	zbx_trapper_conn_t	*conn;
+	struct timeval		tv;
+	int			ret;
+
+	ZBX_UNUSED(what);
+
+	conn = (zbx_trapper_conn_t *)zbx_malloc(NULL, sizeof(zbx_trapper_conn_t));
+	memcpy(&conn->s, loop->listen_sock, sizeof(zbx_socket_t));
+
+	if (SUCCEED != (ret = zbx_tcp_accept_connection(&conn->s, fd)))
+	{
+		if (TIMEOUT_ERROR != ret)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "failed to accept an incoming connection: %s",
+					zbx_socket_strerror());
+		}
+
+		zbx_tcp_unaccept(&conn->s);
+		zbx_free(conn);
+		return;
+	}
+
+	conn->state = ZBX_TRAPPER_CONN_HANDSHAKE;
+	conn->keepalive = 0;
+	conn->lastactivity = 0;
+	conn->io_event = NULL;
+	conn->io_what = 0;
+	conn->loop = loop;
+	conn->timeout_event = evtimer_new(loop->base, trapper_conn_event, conn);
+
+	tv.tv_sec = conn->s.timeout;
+	tv.tv_usec = 0;
+	evtimer_add(conn->timeout_event, &tv);
+
+	zbx_vector_ptr_append(&loop->connections, conn);
+
+	/* idle kept alive connections must not block new clients */
+	if (loop->connections.values_num >= loop->args->config_max_concurrent_connections_per_trapper)
+		trapper_loop_evict_idle(loop);
+
+	if (loop->connections.values_num >= loop->args->config_max_concurrent_connections_per_trapper)
+		trapper_loop_listen(loop, 0);
+
+	trapper_conn_event(conn->s.socket, EV_READ, conn);
+}
+
+static void	trapper_wake_event(evutil_socket_t fd, short what, void *arg)
+{
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(what);
+	ZBX_UNUSED(arg);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: serves multiple connections in one trapper process                *
+ *                                                                            *
+ * Comments: Connection accepting, TLS handshakes and request receiving are   *
+ *           multiplexed with libevent, so slow senders do not occupy trapper *
+ *           processes. Fully received requests are processed one by one.     *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_loop_run(zbx_socket_t *listen_sock, const zbx_thread_trapper_args *args,
+		const zbx_thread_info_t *info, zbx_ipc_async_socket_t *rtc)
+{
+#define POLL_TIMEOUT	1
+	zbx_trapper_loop_t	loop;
+	struct event		*rtc_event, *timer_event;
+	struct timeval		tv = {POLL_TIMEOUT, 0};
+	int			i;
+
+	if (NULL == (loop.base = event_base_new()))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize event base");
+		exit(EXIT_FAILURE);
+	}
+
+	loop.listen_sock = listen_sock;
+	loop.args = args;
+	loop.info = info;
+	loop.rtc = rtc;
+	loop.sec = 0.0;
+	loop.listening = 0;
+	zbx_vector_ptr_create(&loop.connections);
+
+	loop.listen_events = (struct event **)zbx_malloc(NULL, sizeof(struct event *) *
+			(size_t)listen_sock->num_socks);
+
+	for (i = 0; i < listen_sock->num_socks; i++)
+	{
+		loop.listen_events[i] = event_new(loop.base, listen_sock->sockets[i], EV_READ | EV_PERSIST,
+				trapper_accept_event, &loop);
+	}
+
+	trapper_loop_listen(&loop, 1);
+
+	rtc_event = event_new(loop.base, zbx_ipc_client_get_fd(rtc->client), EV_READ | EV_PERSIST, trapper_wake_event,
+			NULL);
+	event_add(rtc_event, NULL);
+
+	/* wake up periodically to update process environment and check for shutdown */
+	timer_event = event_new(loop.base, -1, EV_PERSIST, trapper_wake_event, NULL);
+	evtimer_add(timer_event, &tv);
+
+	while (ZBX_IS_RUNNING())
+	{
+		zbx_uint32_t	rtc_cmd;
+		unsigned char	*rtc_data;
+
+		zbx_setproctitle("%s #%d [processed data in " ZBX_FS_DBL " sec, serving %d connections%s]",
+				get_process_type_string(info->process_type), info->process_num, loop.sec,
+				loop.connections.values_num, zbx_vps_monitor_status());
+
+		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
+
+		event_base_loop(loop.base, EVLOOP_ONCE);
+
+		zbx_update_env(get_process_type_string(info->process_type), zbx_time());
+
+		while (SUCCEED == zbx_rtc_wait(rtc, info, &rtc_cmd, &rtc_data, 0) && 0 != rtc_cmd)
+		{
+			if (ZBX_RTC_SHUTDOWN == rtc_cmd)
+				goto out;
+		}
+	}
+out:
+
+	while (0 != loop.connections.values_num)
+		trapper_conn_free((zbx_trapper_conn_t *)loop.connections.values[0]);
+
+	for (i = 0; i < listen_sock->num_socks; i++)
+		event_free(loop.listen_events[i]);
+
+	zbx_free(loop.listen_events);
+	zbx_vector_ptr_destroy(&loop.connections);
+	event_free(timer_event);
+	event_free(rtc_event);
+	event_base_free(loop.base);
+#undef POLL_TIMEOUT
 }
 
 ZBX_THREAD_ENTRY(zbx_trapper_thread, args)
@@ -1451,6 +1891,12 @@ ZBX_THREAD_ENTRY(zbx_trapper_thread, args)
 
 	zbx_rtc_subscribe(process_type, process_num, NULL, 0, trapper_args_in->config_comms->config_timeout, &rtc);
 
+	if (1 < trapper_args_in->config_max_concurrent_connections_per_trapper)
+	{
+		trapper_loop_run(&s, trapper_args_in, info, &rtc);
+		goto out;
+	}
+
 	while (ZBX_IS_RUNNING())
 	{
 		zbx_uint32_t	rtc_cmd;
@@ -107,6 +107,9 @@ static ZBX_THREAD_LOCAL zbx_vector_persistent_inactive_t	persistent_inactive_vec
 
 static ZBX_THREAD_LOCAL int	history_upload = ZBX_HISTORY_UPLOAD_ENABLED;
 
+/* connection kept open between buffer sends when server supports it */
+static ZBX_THREAD_LOCAL zbx_comms_keepalive_t	send_keepalive;
+
 typedef struct
 {
 	zbx_uint64_t	id;
@@ -1254,6 +1257,7 @@ static int	send_buffer(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_persistent_t
 	zbx_json_addstring(&json, ZBX_PROTO_TAG_VERSION, ZABBIX_VERSION, ZBX_JSON_TYPE_STRING);
 	zbx_json_addint64(&json, ZBX_PROTO_TAG_VARIANT, ZBX_PROGRAM_VARIANT_AGENT);
 	zbx_json_addstring(&json, ZBX_PROTO_TAG_HOST, config_hostname, ZBX_JSON_TYPE_STRING);
+	zbx_json_addstring(&json, ZBX_PROTO_TAG_KEEPALIVE, ZBX_PROTO_VALUE_TRUE, ZBX_JSON_TYPE_STRING);
 
 	ret_metrics = format_metric_results(&json, now, config_buffer_send, config_buffer_size);
 	ret_commands = format_command_results(&json);
@@ -1263,8 +1267,9 @@ static int	send_buffer(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_persistent_t
 
 	level = 0 == buffer.first_error ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG;
 
-	ret = zbx_comms_exchange_with_redirect(config_source_ip, addrs, MIN(buffer.count * config_timeout, 60),
-			config_timeout, 0, level, config_tls, json.buffer, connect_callback, &json, &data, NULL);
+	ret = zbx_comms_exchange_keepalive(&send_keepalive, config_source_ip, addrs,
+			MIN(buffer.count * config_timeout, 60), config_timeout, 0, level, config_tls, json.buffer,
+			connect_callback, &json, &data, NULL);
 
 	if (SUCCEED == ret)
 	{
@@ -2072,6 +2077,7 @@ ZBX_THREAD_ENTRY(active_checks_thread, args)
 	}
 
 	zbx_free(session_token);
+	zbx_comms_keepalive_close(&send_keepalive);
 
 #ifdef _WINDOWS
 	zbx_vector_addr_ptr_clear_ext(&activechk_args.addrs, (zbx_clean_func_t)zbx_addr_free);
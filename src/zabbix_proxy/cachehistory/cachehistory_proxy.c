@@ -391,13 +391,9 @@ void	zbx_sync_history_cache_proxy(const zbx_events_funcs_t *events_cbs, zbx_ipc_
 	{
 		stats->more = ZBX_SYNC_DONE;
 
-		zbx_dbcache_lock();
-
 		zbx_hc_pop_items(&history_items);		/* select and take items out of history cache */
 		history_num = history_items.values_num;
 
-		zbx_dbcache_unlock();
-
 		if (0 == history_num)
 			break;
 
@@ -424,8 +420,6 @@ void	zbx_sync_history_cache_proxy(const zbx_events_funcs_t *events_cbs, zbx_ipc_
 		sec2 = zbx_time();
 		stats->time_update_items += sec2 - sec1;
 
-		zbx_dbcache_lock();
-
 		zbx_hc_push_items(&history_items);	/* return items to history cache */
 
 		if (ZBX_DB_FAIL != txn_rc)
@@ -433,22 +427,15 @@ void	zbx_sync_history_cache_proxy(const zbx_events_funcs_t *events_cbs, zbx_ipc_
 			if (0 != item_diff.values_num)
 				zbx_dc_config_items_apply_changes(&item_diff);
 
-			zbx_dbcache_set_history_num(zbx_dbcache_get_history_num() - history_num);
-
 			if (0 != zbx_hc_queue_get_size())
 				stats->more = ZBX_SYNC_MORE;
 
-			zbx_dbcache_unlock();
-
 			stats->values_num += history_num;
 
 			zbx_hc_free_item_values(history, history_num);
 		}
 		else
-		{
 			stats->more = ZBX_SYNC_MORE;
-			zbx_dbcache_unlock();
-		}
 
 		zbx_vector_hc_item_ptr_clear(&history_items);
 		zbx_vector_item_diff_ptr_clear_ext(&item_diff, zbx_item_diff_free);
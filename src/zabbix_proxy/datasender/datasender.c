@@ -58,6 +58,9 @@
  *               FAIL - an error occurred                                     *
  *                                                                            *
  ******************************************************************************/
+/* codec for data sent to server, chosen from the codecs advertised in server responses */
+static unsigned char	server_codec = ZBX_COMPRESS_ZLIB;
+
 static void	get_hist_upload_state(const char *buffer, int *state)
 {
 	struct zbx_json_parse	jp;
@@ -176,7 +179,7 @@ static int	proxy_data_sender(int *more, int now, int *hist_upload_state, int *ne
 		if (0 != (flags & ZBX_DATASENDER_HISTORY) && 0 != (proxy_delay = zbx_proxy_get_delay(history_lastid)))
 			zbx_json_adduint64(&j, ZBX_PROTO_TAG_PROXY_DELAY, proxy_delay);
 
-		if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+		if (SUCCEED != zbx_compress_ext(server_codec, j.buffer, j.buffer_size, &buffer, &buffer_size))
 		{
 			zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 			goto clean;
@@ -201,13 +204,16 @@ static int	proxy_data_sender(int *more, int now, int *hist_upload_state, int *ne
 
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
 
-		upload_state = zbx_put_data_to_server(&sock, &buffer, buffer_size, reserved, &error);
+		upload_state = zbx_put_data_to_server(&sock, &buffer, buffer_size, reserved, server_codec, &error);
 		get_hist_upload_state(sock.buffer, hist_upload_state);
 
 		if (SUCCEED != upload_state)
 		{
 			zbx_addrs_failover(args->config_server_addrs);
 
+			/* the next server might not support the codec */
+			server_codec = ZBX_COMPRESS_ZLIB;
+
 			*more = ZBX_PROXY_DATA_DONE;
 			if (ZBX_PROXY_UPLOAD_DISABLED != *hist_upload_state)
 			{
@@ -225,6 +231,8 @@ static int	proxy_data_sender(int *more, int now, int *hist_upload_state, int *ne
 			{
 				if (SUCCEED == zbx_json_brackets_by_name(&jp, ZBX_PROTO_TAG_TASKS, &jp_tasks))
 					flags |= ZBX_DATASENDER_TASKS_RECV;
+
+				server_codec = zbx_parse_compress_codecs(&jp);
 			}
 
 			if (0 != (flags & ZBX_DATASENDER_DB_UPDATE))
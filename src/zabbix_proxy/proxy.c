@@ -49,6 +49,8 @@
 #include "stats/stats_proxy.h"
 
 #include "zbxcomms.h"
+#include "zbxcompress.h"
+#include "zbxregexp.h"
 #include "zbxvault.h"
 #include "zbxdiag.h"
 #include "diag/diag_proxy.h"
@@ -250,6 +252,15 @@ static int	get_config_forks(unsigned char process_type)
 	return 0;
 }
 
+static void	get_selfmon_counters(zbx_uint64_t *counters)
+{
+	counters[ZBX_SELFMON_COUNTER_RECV_PEAK_UNENCRYPTED] = zbx_tcp_recv_get_peak_memory(ZBX_TCP_SEC_UNENCRYPTED);
+	counters[ZBX_SELFMON_COUNTER_RECV_PEAK_PSK] = zbx_tcp_recv_get_peak_memory(ZBX_TCP_SEC_TLS_PSK);
+	counters[ZBX_SELFMON_COUNTER_RECV_PEAK_CERT] = zbx_tcp_recv_get_peak_memory(ZBX_TCP_SEC_TLS_CERT);
+	zbx_regexp_cache_get_stats(&counters[ZBX_SELFMON_COUNTER_REGEXP_CACHE_HITS],
+			&counters[ZBX_SELFMON_COUNTER_REGEXP_CACHE_MISSES]);
+}
+
 ZBX_GET_CONFIG_VAR(int, zbx_config_timeout, 3)
 static int	zbx_config_trapper_timeout	= 300;
 static int	config_startup_time		= 0;
@@ -278,10 +289,13 @@ static zbx_uint64_t	config_history_cache_size	= 16 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_history_index_cache_size	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_trends_cache_size	= 0;
 static zbx_uint64_t	config_vmware_cache_size	= 8 * ZBX_MEBIBYTE;
+static int		config_history_cache_partitions	= 1;
 
 static int	config_unreachable_period		= 45;
 static int	config_unreachable_delay		= 15;
 static int	config_max_concurrent_checks_per_poller	= 1000;
+static int	config_snmp_max_repetitions_tuning	= 0;
+static int	config_max_concurrent_connections_per_trapper	= 1;
 
 static int	config_log_level		= LOG_LEVEL_WARNING;
 
@@ -319,6 +333,7 @@ static zbx_config_vault_t	zbx_config_vault = {NULL, NULL, NULL, NULL, NULL, NULL
 static char	*config_socket_path	= NULL;
 static int	config_history_storage_pipelines	= 0;
 static char	*config_stats_allowed_ip	= NULL;
+static char	*config_compression_codec	= NULL;
 static int	config_tcp_max_backlog_size	= SOMAXCONN;
 static char	*config_file		= NULL;
 static int	config_allow_root	= 0;
@@ -674,6 +689,25 @@ static void	zbx_validate_config(ZBX_TASK_EX *task)
 		zbx_free(ch_error);
 		err = 1;
 	}
+
+	if (NULL != config_compression_codec)
+	{
+		unsigned char	codec;
+
+		if (SUCCEED != zbx_compress_codec_parse(config_compression_codec, &codec))
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "invalid \"CompressionCodec\" configuration parameter: '%s'",
+					config_compression_codec);
+			err = 1;
+		}
+		else if (SUCCEED != zbx_compress_set_codec(codec))
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "\"CompressionCodec\" configuration parameter cannot be set to"
+					" '%s': compiled without %s support", config_compression_codec,
+					config_compression_codec);
+			err = 1;
+		}
+	}
 #if !defined(HAVE_IPV6)
 	err |= (FAIL == zbx_check_cfg_feature_str("Fping6Location", zbx_config_fping6_location, "IPv6 support"));
 #endif
@@ -902,6 +936,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(16) * ZBX_GIBIBYTE},
 		{"HistoryIndexCacheSize",	&config_history_index_cache_size,	ZBX_CFG_TYPE_UINT64,
 				ZBX_CONF_PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(16) * ZBX_GIBIBYTE},
+		{"HistoryCachePartitions",	&config_history_cache_partitions,	ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	1,			ZBX_HC_PARTITIONS_MAX},
 		{"HousekeepingFrequency",	&config_housekeeping_frequency,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	0,			24},
 		{"ProxyLocalBuffer",		&config_proxy_local_buffer,		ZBX_CFG_TYPE_INT,
@@ -926,6 +962,10 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	1,			30},
 		{"TrapperTimeout",		&zbx_config_trapper_timeout,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			300},
+		{"MaxConcurrentConnectionsPerTrapper",
+						&config_max_concurrent_connections_per_trapper,
+											ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	1,			1000},
 		{"UnreachablePeriod",		&config_unreachable_period,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			SEC_PER_HOUR},
 		{"UnreachableDelay",		&config_unreachable_delay,		ZBX_CFG_TYPE_INT,
@@ -1067,6 +1107,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	0,			1},
 		{"LogRemoteCommands",		&zbx_config_log_remote_commands,	ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	0,			1},
+		{"CompressionCodec",		&config_compression_codec,		ZBX_CFG_TYPE_STRING,
+				ZBX_CONF_PARM_OPT,	0,			0},
 		{"StatsAllowedIP",		&config_stats_allowed_ip,		ZBX_CFG_TYPE_STRING_LIST,
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"StartPreprocessors",		&config_forks[ZBX_PROCESS_TYPE_PREPROCESSOR],
@@ -1096,6 +1138,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 						&config_max_concurrent_checks_per_poller,
 											ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			1000},
+		{"SNMPMaxRepetitionsTuning",	&config_snmp_max_repetitions_tuning,	ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	0,			1000},
 		{"StartBrowserPollers",		&config_forks[ZBX_PROCESS_TYPE_BROWSERPOLLER],	ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	0,			1000},
 		{"WebDriverURL",		&config_webdriver_url,			ZBX_CFG_TYPE_STRING,
@@ -1491,6 +1535,7 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 			.config_unreachable_period = config_unreachable_period,
 			.config_unreachable_delay = config_unreachable_delay,
 			.config_max_concurrent_checks_per_poller = config_max_concurrent_checks_per_poller,
+			.config_snmp_max_repetitions_tuning = config_snmp_max_repetitions_tuning,
 			.get_config_forks = get_config_forks,
 			.config_java_gateway = config_java_gateway,
 			.config_java_gateway_port = config_java_gateway_port,
@@ -1590,7 +1635,9 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 			.config_ssh_key_location = config_ssh_key_location,
 			.config_webdriver_url = config_webdriver_url,
 			.trapper_process_request_func_cb = trapper_process_request_proxy,
-			.autoreg_update_host_cb = zbx_autoreg_update_host_proxy
+			.autoreg_update_host_cb = zbx_autoreg_update_host_proxy,
+			.config_max_concurrent_connections_per_trapper =
+					config_max_concurrent_connections_per_trapper
 		};
 
 	zbx_thread_proxy_housekeeper_args	housekeeper_args =
@@ -1738,6 +1785,10 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		zabbix_log(LOG_LEVEL_CRIT, "cannot disable core dump, exiting...");
 		exit(EXIT_FAILURE);
 	}
+#endif
+#if defined(HAVE_OPENSSL)
+	/* session tickets issued by one process must be accepted by the others */
+	zbx_tls_generate_ticket_keys();
 #endif
 	if (FAIL == zbx_load_modules(config_load_module_path, config_load_module, zbx_config_timeout, 1))
 	{
@@ -1760,7 +1811,8 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 	zbx_unblock_signals(&orig_mask);
 
 	if (SUCCEED != zbx_init_database_cache(get_zbx_program_type, zbx_sync_history_cache_proxy,
-			config_history_cache_size, config_history_index_cache_size, &config_trends_cache_size, &error))
+			config_history_cache_size, config_history_index_cache_size, config_history_cache_partitions, 0,
+			&config_trends_cache_size, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize database cache: %s", error);
 		zbx_free(error);
@@ -1782,7 +1834,7 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		exit(EXIT_FAILURE);
 	}
 
-	if (SUCCEED != zbx_init_selfmon_collector(get_config_forks, &error))
+	if (SUCCEED != zbx_init_selfmon_collector(get_config_forks, get_selfmon_counters, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize self-monitoring: %s", error);
 		zbx_free(error);
@@ -35,6 +35,9 @@
 #include "zbxnum.h"
 #include "zbxjson.h"
 
+/* codec for data sent to server, chosen from the codecs advertised in server responses */
+static unsigned char	server_codec = ZBX_COMPRESS_ZLIB;
+
 static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_t *synced,
 		const zbx_thread_info_t *thread_info, zbx_thread_proxyconfig_args *args)
 {
@@ -67,7 +70,7 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 	if (0 != hostmap_revision)
 		zbx_json_adduint64(&j, ZBX_PROTO_TAG_HOSTMAP_REVISION, hostmap_revision);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	if (SUCCEED != zbx_compress_ext(server_codec, j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto out;
@@ -88,7 +91,7 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 #undef CONFIG_PROXYCONFIG_RETRY
 	zbx_update_selfmon_counter(thread_info, ZBX_PROCESS_STATE_BUSY);
 
-	if (SUCCEED != zbx_get_data_from_server(&sock, &buffer, buffer_size, reserved, &error))
+	if (SUCCEED != zbx_get_data_from_server(&sock, &buffer, buffer_size, reserved, server_codec, &error))
 	{
 		zabbix_log(LOG_LEVEL_WARNING, "cannot obtain configuration data from server at \"%s\": %s",
 				sock.peer, error);
@@ -111,6 +114,8 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 
 	*data_size = (size_t)(jp.end - jp.start + 1);     /* performance metric */
 
+	server_codec = zbx_parse_compress_codecs(&jp);
+
 	/* if the answer is short then most likely it is a negative answer "response":"failed" */
 	if (128 > *data_size &&
 			SUCCEED == zbx_json_value_by_name(&jp, ZBX_PROTO_TAG_RESPONSE, value, sizeof(value), NULL) &&
@@ -159,6 +164,9 @@ error:
 		zbx_dc_set_upstream_revision(0, 0);
 
 		zbx_addrs_failover(args->config_server_addrs);
+
+		/* the next server might not support the codec */
+		server_codec = ZBX_COMPRESS_ZLIB;
 	}
 
 out:
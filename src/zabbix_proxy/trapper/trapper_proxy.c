@@ -69,15 +69,16 @@ static void	active_passive_misconfig(zbx_socket_t *sock, int config_timeout)
  *             buffer          - [IN/OUT]                                     *
  *             buffer_size     - [IN]                                         *
  *             reserved        - [IN]                                         *
+ *             codec           - [IN] compression codec used for buffer       *
  *             config_timeout  - [IN]                                         *
  *             error           - [OUT] error message                          *
  *                                                                            *
  ******************************************************************************/
 static int	send_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
-		int config_timeout, char **error)
+		unsigned char codec, int config_timeout, char **error)
 {
-	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS,
-			config_timeout))
+	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved,
+			ZBX_TCP_PROTOCOL | zbx_tcp_compress_flags(codec), config_timeout))
 	{
 		*error = zbx_strdup(*error, zbx_socket_strerror());
 		return FAIL;
@@ -113,6 +114,7 @@ static void	send_proxy_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	zbx_vector_tm_task_t	tasks;
 	struct zbx_json_parse	jp, jp_tasks;
 	size_t			buffer_size, reserved;
+	unsigned char		codec;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -153,11 +155,15 @@ static void	send_proxy_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_VERSION, ZABBIX_VERSION, ZBX_JSON_TYPE_STRING);
 	zbx_json_addint64(&j, ZBX_PROTO_TAG_CLOCK, ts->sec);
 	zbx_json_addint64(&j, ZBX_PROTO_TAG_NS, ts->ns);
+	zbx_add_compress_codecs(&j);
 
 	if (0 != history_lastid && 0 != (proxy_delay = zbx_proxy_get_delay(history_lastid)))
 		zbx_json_addint64(&j, ZBX_PROTO_TAG_PROXY_DELAY, proxy_delay);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	/* reply with the codec used by server */
+	codec = zbx_tcp_get_compress_codec(sock);
+
+	if (SUCCEED != zbx_compress_ext(codec, j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto clean;
@@ -166,8 +172,8 @@ static void	send_proxy_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	reserved = j.buffer_size;
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
 
-	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, config_comms->config_timeout,
-			&error))
+	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, codec,
+			config_comms->config_timeout, &error))
 	{
 		zbx_set_availability_diff_ts(availability_ts);
 
@@ -245,6 +251,7 @@ static void	send_task_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	zbx_vector_tm_task_t	tasks;
 	struct zbx_json_parse	jp, jp_tasks;
 	size_t			buffer_size, reserved;
+	unsigned char		codec;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -266,8 +273,12 @@ static void	send_task_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_VERSION, ZABBIX_VERSION, ZBX_JSON_TYPE_STRING);
 	zbx_json_addint64(&j, ZBX_PROTO_TAG_CLOCK, ts->sec);
 	zbx_json_addint64(&j, ZBX_PROTO_TAG_NS, ts->ns);
+	zbx_add_compress_codecs(&j);
+
+	/* reply with the codec used by server */
+	codec = zbx_tcp_get_compress_codec(sock);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	if (SUCCEED != zbx_compress_ext(codec, j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto clean;
@@ -276,8 +287,8 @@ static void	send_task_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	reserved = j.buffer_size;
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
 
-	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, config_comms->config_timeout,
-			&error))
+	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, codec,
+			config_comms->config_timeout, &error))
 	{
 		zbx_db_begin();
 
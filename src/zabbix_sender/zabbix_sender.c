@@ -349,6 +349,9 @@ zbx_send_destinations_t;
 static zbx_send_destinations_t	*destinations = NULL;		/* list of servers to send data to */
 static int			destinations_count = 0;
 
+/* input file batches for single destination are sent over connection kept open between batches */
+static zbx_comms_keepalive_t	*send_keepalive = NULL;
+
 volatile sig_atomic_t	sig_exiting = 0;
 
 #if !defined(_WINDOWS)
@@ -386,9 +389,12 @@ static void	main_signal_handler(int sig)
 
 		for (i = 0; i < destinations_count; i++)
 		{
-			pid_t	child = *(destinations[i].thread);
+			pid_t	child;
+
+			if (NULL == destinations[i].thread)
+				continue;
 
-			if (ZBX_THREAD_HANDLE_NULL != child)
+			if (ZBX_THREAD_HANDLE_NULL != (child = *(destinations[i].thread)))
 				kill(child, sig);
 		}
 	}
@@ -626,31 +632,31 @@ static char	*connect_callback(void *data)
 	return json->buffer;
 }
 
-static	ZBX_THREAD_ENTRY(send_value, args)
+static char	*keepalive_connect_callback(void *data)
 {
-	zbx_thread_sendval_args	*sendval_args = (zbx_thread_sendval_args *)((zbx_thread_args_t *)args)->args;
-	int			ret, ret_resp;
-	char			*data = NULL;
-#if !defined(_WINDOWS)
-	zbx_addr_t		*last_addr;
-	int			i;
+	zbx_json_addstring((zbx_json_t *)data, ZBX_PROTO_TAG_KEEPALIVE, ZBX_PROTO_VALUE_TRUE, ZBX_JSON_TYPE_STRING);
 
-	last_addr = (zbx_addr_t *)sendval_args->addrs->values[0];
+	return connect_callback(data);
+}
 
-	zbx_set_sender_signal_handlers();
-#endif
-#if defined(_WINDOWS) && (defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL))
-	if (ZBX_TCP_SEC_UNENCRYPTED != sendval_args->zbx_config_tls->connect_mode)
-	{
-		/* take TLS data passed from 'main' thread */
-		zbx_tls_take_vars(&sendval_args->tls_vars);
-	}
-#endif
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sends data to destination and checks response                     *
+ *                                                                            *
+ * Parameters: sendval_args - [IN] data and destination addresses             *
+ *             keepalive    - [IN/OUT] connection kept open between sends,    *
+ *                                     NULL to close connection after sending *
+ *                                                                            *
+ ******************************************************************************/
+static int	send_value_exchange(zbx_thread_sendval_args *sendval_args, zbx_comms_keepalive_t *keepalive)
+{
+	int	ret, ret_resp;
+	char	*data = NULL;
 
-	ret = zbx_comms_exchange_with_redirect(config_source_ip, sendval_args->addrs, CONFIG_SENDER_TIMEOUT,
+	ret = zbx_comms_exchange_keepalive(keepalive, config_source_ip, sendval_args->addrs, CONFIG_SENDER_TIMEOUT,
 			config_timeout, 0, LOG_LEVEL_DEBUG, sendval_args->zbx_config_tls, sendval_args->json->buffer,
-			connect_callback, sendval_args->json, &data, NULL);
-
+			NULL == keepalive ? connect_callback : keepalive_connect_callback, sendval_args->json, &data,
+			NULL);
 
 	if (SUCCEED == ret)
 	{
@@ -673,6 +679,31 @@ static	ZBX_THREAD_ENTRY(send_value, args)
 		zbx_free(data);
 	}
 
+	return ret;
+}
+
+static	ZBX_THREAD_ENTRY(send_value, args)
+{
+	zbx_thread_sendval_args	*sendval_args = (zbx_thread_sendval_args *)((zbx_thread_args_t *)args)->args;
+	int			ret;
+#if !defined(_WINDOWS)
+	zbx_addr_t		*last_addr;
+	int			i;
+
+	last_addr = (zbx_addr_t *)sendval_args->addrs->values[0];
+
+	zbx_set_sender_signal_handlers();
+#endif
+#if defined(_WINDOWS) && (defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL))
+	if (ZBX_TCP_SEC_UNENCRYPTED != sendval_args->zbx_config_tls->connect_mode)
+	{
+		/* take TLS data passed from 'main' thread */
+		zbx_tls_take_vars(&sendval_args->tls_vars);
+	}
+#endif
+
+	ret = send_value_exchange(sendval_args, NULL);
+
 #if !defined(_WINDOWS)
 	for (i = sendval_args->addrs->values_num - 1; i >= 0; i--)
 	{
@@ -718,6 +749,18 @@ static int	perform_data_sending(zbx_thread_sendval_args *sendval_args, int old_s
 	ZBX_THREAD_HANDLE	*threads = NULL;
 	zbx_thread_args_t	*threads_args;
 
+	if (NULL != send_keepalive)
+	{
+		/* single destination is served without thread to keep connection open for next batch */
+		sendval_args->addrs = &destinations[0].addrs;
+		ret = send_value_exchange(sendval_args, send_keepalive);
+
+		if (SUCCEED != ret && SUCCEED_PARTIAL != ret)
+			return FAIL;
+
+		return SUCCEED_PARTIAL == old_status || SUCCEED_PARTIAL == ret ? SUCCEED_PARTIAL : SUCCEED;
+	}
+
 	threads = (ZBX_THREAD_HANDLE *)zbx_calloc(threads, (size_t)destinations_count, sizeof(ZBX_THREAD_HANDLE));
 	threads_args = (zbx_thread_args_t *)zbx_calloc(NULL, (size_t)destinations_count, sizeof(zbx_thread_args_t));
 
@@ -787,6 +830,7 @@ static int	add_serveractive_host_sender_cb(const zbx_vector_addr_ptr_t *addrs, z
 			sizeof(zbx_send_destinations_t) * destinations_count);
 
 	zbx_vector_addr_ptr_create(&destinations[destinations_count - 1].addrs);
+	destinations[destinations_count - 1].thread = NULL;
 
 	zbx_addr_copy(&destinations[destinations_count - 1].addrs, addrs);
 
@@ -1577,6 +1621,15 @@ int	main(int argc, char **argv)
 		sendval_args->sync_timestamp = WITH_TIMESTAMPS;
 		in_line = (char *)zbx_malloc(NULL, in_line_alloc);
 
+		if (1 == destinations_count)
+		{
+#if !defined(_WINDOWS)
+			/* writing to kept connection closed by server must fail instead of stopping sender */
+			signal(SIGPIPE, SIG_IGN);
+#endif
+			send_keepalive = (zbx_comms_keepalive_t *)zbx_calloc(NULL, 1, sizeof(zbx_comms_keepalive_t));
+		}
+
 		ret = SUCCEED;
 
 		while (0 == sig_exiting && (SUCCEED == ret || SUCCEED_PARTIAL == ret) &&
@@ -1639,6 +1692,12 @@ int	main(int argc, char **argv)
 		if (in != stdin)
 			fclose(in);
 
+		if (NULL != send_keepalive)
+		{
+			zbx_comms_keepalive_close(send_keepalive);
+			zbx_free(send_keepalive);
+		}
+
 		zbx_free(in_line);
 	}
 	else
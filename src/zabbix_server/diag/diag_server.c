@@ -231,7 +231,7 @@ static void	diag_add_lld_items(struct zbx_json *json, const char *field, const z
 	{
 		zbx_json_addobject(json, NULL);
 		zbx_json_adduint64(json, "itemid", items->values[i].first);
-		zbx_json_adduint64(json, "values", items->values[i].second);
+		zbx_json_adduint64(json, field, items->values[i].second);
 		zbx_json_close(json);
 	}
 
@@ -293,14 +293,20 @@ static int	diag_add_lld_info(const struct zbx_json_parse *jp, struct zbx_json *j
 			{
 				zbx_diag_map_t	*map = tops.values[i];
 
-				if (0 == strcmp(map->name, "values"))
+				if (0 == strcmp(map->name, "values") || 0 == strcmp(map->name, "time_ms"))
 				{
 					zbx_vector_uint64_pair_t	items;
 
 					zbx_vector_uint64_pair_create(&items);
 
 					time1 = zbx_time();
-					if (FAIL == (ret = zbx_lld_get_top_items(map->value, &items, error)))
+
+					if (0 == strcmp(map->name, "values"))
+						ret = zbx_lld_get_top_items(map->value, &items, error);
+					else
+						ret = zbx_lld_get_top_time_ms(map->value, &items, error);
+
+					if (FAIL == ret)
 					{
 						zbx_vector_uint64_pair_destroy(&items);
 						goto out;
@@ -46,6 +46,7 @@
 #include "zbxrtc.h"
 #include "zbx_rtc_constants.h"
 #include "zbxserialize.h"
+#include "zbxescalations.h"
 
 #define CONFIG_ESCALATOR_FREQUENCY	3
 
@@ -109,6 +110,109 @@ ZBX_PTR_VECTOR_IMPL(tag_filter_ptr, zbx_tag_filter_t*)
 ZBX_PTR_VECTOR_DECL(db_escalation_ptr, zbx_db_escalation*)
 ZBX_PTR_VECTOR_IMPL(db_escalation_ptr, zbx_db_escalation*)
 
+#define ZBX_ESCALATION_OPMESSAGE_NONE		0	/* operation has no message */
+#define ZBX_ESCALATION_OPMESSAGE_CUSTOM		1	/* operation has custom message */
+#define ZBX_ESCALATION_OPMESSAGE_DEFAULT	2	/* operation uses media type message templates */
+
+typedef struct
+{
+	char		*value;
+	unsigned char	conditiontype;
+	unsigned char	op;
+}
+zbx_escalation_opcondition_t;
+
+ZBX_PTR_VECTOR_DECL(escalation_opcondition_ptr, zbx_escalation_opcondition_t *)
+ZBX_PTR_VECTOR_IMPL(escalation_opcondition_ptr, zbx_escalation_opcondition_t *)
+
+typedef struct
+{
+	zbx_uint64_t					operationid;
+	zbx_uint64_t					actionid;
+	zbx_uint64_t					mediatypeid;	/* message media type, 0 - all */
+	char						*esc_period;
+	char						*subject;
+	char						*message;
+	int						esc_step_from;
+	int						esc_step_to;
+	unsigned char					operationtype;
+	unsigned char					recovery;
+	unsigned char					evaltype;
+	unsigned char					opmessage;
+	zbx_vector_escalation_opcondition_ptr_t	conditions;	/* sorted by condition type */
+	zbx_vector_uint64_t				userids;	/* message recipients */
+}
+zbx_escalation_operation_t;
+
+ZBX_PTR_VECTOR_DECL(escalation_operation_ptr, zbx_escalation_operation_t *)
+ZBX_PTR_VECTOR_IMPL(escalation_operation_ptr, zbx_escalation_operation_t *)
+
+typedef struct
+{
+	zbx_uint64_t				actionid;
+	zbx_vector_escalation_operation_ptr_t	operations;	/* sorted by operationid */
+}
+zbx_escalation_action_t;
+
+typedef struct
+{
+	zbx_uint64_t	mediatypeid;
+	char		*sendto;
+	char		*period;
+	int		severity;
+	int		active;
+	int		mediatype_status;
+	int		mediatype_type;
+}
+zbx_escalation_media_t;
+
+ZBX_PTR_VECTOR_DECL(escalation_media_ptr, zbx_escalation_media_t *)
+ZBX_PTR_VECTOR_IMPL(escalation_media_ptr, zbx_escalation_media_t *)
+
+typedef struct
+{
+	zbx_uint64_t				userid;
+	int					perm2system;	/* SUCCEED - user can access system */
+	zbx_vector_escalation_media_ptr_t	media;
+}
+zbx_escalation_user_t;
+
+/* message alert of escalation step, used to find recipients of the previous messages */
+typedef struct
+{
+	zbx_uint64_t	actionid;
+	zbx_uint64_t	eventid;
+	zbx_uint64_t	userid;
+	zbx_uint64_t	mediatypeid;
+	char		*subject;
+	char		*message;
+	int		esc_step;
+}
+zbx_escalation_alert_t;
+
+ZBX_PTR_VECTOR_DECL(escalation_alert_ptr, zbx_escalation_alert_t *)
+ZBX_PTR_VECTOR_IMPL(escalation_alert_ptr, zbx_escalation_alert_t *)
+
+/* data shared by all escalations processed in one batch */
+typedef struct
+{
+	zbx_hashset_t	roles;			/* service roles */
+	zbx_hashset_t	operations;		/* operations of batch actions by operationid */
+	zbx_hashset_t	actions;		/* operations of batch actions by actionid */
+	zbx_hashset_t	users;			/* message recipients with their media */
+	zbx_hashset_t	acknowledges;		/* acknowledgments of batch escalations */
+
+	/* message alerts are accumulated and written together with escalation updates */
+	zbx_db_insert_t	db_insert_alerts;
+	zbx_db_insert_t	db_insert_err_alerts;
+	int		alerts_num;
+	int		err_alerts_num;
+
+	/* accumulated step message alerts, not yet visible in database */
+	zbx_vector_escalation_alert_ptr_t	step_alerts;
+}
+zbx_escalation_batch_t;
+
 static void	zbx_tag_filter_free(zbx_tag_filter_t *tag_filter)
 {
 	zbx_free(tag_filter->tag);
@@ -116,10 +220,339 @@ static void	zbx_tag_filter_free(zbx_tag_filter_t *tag_filter)
 	zbx_free(tag_filter);
 }
 
-static void	add_message_alert(const zbx_db_event *event, const zbx_db_event *r_event, zbx_uint64_t actionid,
-		int esc_step, zbx_uint64_t userid, zbx_uint64_t mediatypeid, const char *subject, const char *message,
-		const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm, const zbx_db_service *service,
-		int err_type, const char *tz);
+static void	escalation_opcondition_free(zbx_escalation_opcondition_t *condition)
+{
+	zbx_free(condition->value);
+	zbx_free(condition);
+}
+
+static void	escalation_media_free(zbx_escalation_media_t *media)
+{
+	zbx_free(media->sendto);
+	zbx_free(media->period);
+	zbx_free(media);
+}
+
+static void	escalation_alert_free(zbx_escalation_alert_t *alert)
+{
+	zbx_free(alert->subject);
+	zbx_free(alert->message);
+	zbx_free(alert);
+}
+
+static zbx_escalation_alert_t	*escalation_alert_create(zbx_uint64_t actionid, zbx_uint64_t eventid,
+		zbx_uint64_t userid, zbx_uint64_t mediatypeid, const char *subject, const char *message, int esc_step)
+{
+	zbx_escalation_alert_t	*alert;
+
+	alert = (zbx_escalation_alert_t *)zbx_malloc(NULL, sizeof(zbx_escalation_alert_t));
+	alert->actionid = actionid;
+	alert->eventid = eventid;
+	alert->userid = userid;
+	alert->mediatypeid = mediatypeid;
+	alert->subject = zbx_strdup(NULL, subject);
+	alert->message = zbx_strdup(NULL, message);
+	alert->esc_step = esc_step;
+
+	return alert;
+}
+
+static int	escalation_alert_compare_by_recipient(const void *d1, const void *d2)
+{
+	const zbx_escalation_alert_t	*alert1 = *(const zbx_escalation_alert_t * const *)d1;
+	const zbx_escalation_alert_t	*alert2 = *(const zbx_escalation_alert_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(alert1->userid, alert2->userid);
+	ZBX_RETURN_IF_NOT_EQUAL(alert1->mediatypeid, alert2->mediatypeid);
+
+	/* the last step first */
+	ZBX_RETURN_IF_NOT_EQUAL(alert2->esc_step, alert1->esc_step);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads access permission and media of users into batch cache     *
+ *                                                                            *
+ * Parameters: batch   - [IN/OUT]                                             *
+ *             userids - [IN] sorted user identifiers                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_batch_load_users(zbx_escalation_batch_t *batch, const zbx_vector_uint64_t *userids)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
+	zbx_uint64_t		userid;
+	zbx_escalation_user_t	*user, user_local;
+
+	if (0 == userids->values_num)
+		return;
+
+	for (int i = 0; i < userids->values_num; i++)
+	{
+		if (NULL != zbx_hashset_search(&batch->users, &userids->values[i]))
+			continue;
+
+		user_local.userid = userids->values[i];
+		user_local.perm2system = SUCCEED;
+		user = (zbx_escalation_user_t *)zbx_hashset_insert(&batch->users, &user_local, sizeof(user_local));
+		zbx_vector_escalation_media_ptr_create(&user->media);
+	}
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select distinct ug.userid"
+			" from usrgrp g,users_groups ug"
+			" where g.usrgrpid=ug.usrgrpid"
+				" and g.users_status=%d"
+				" and",
+			GROUP_STATUS_DISABLED);
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "ug.userid", userids->values,
+			userids->values_num);
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(userid, row[0]);
+
+		if (NULL != (user = (zbx_escalation_user_t *)zbx_hashset_search(&batch->users, &userid)))
+			user->perm2system = FAIL;
+	}
+	zbx_db_free_result(result);
+
+	sql_offset = 0;
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			"select m.userid,m.mediatypeid,m.sendto,m.severity,m.period,mt.status,m.active,mt.type"
+			" from media m,media_type mt"
+			" where m.mediatypeid=mt.mediatypeid"
+				" and");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "m.userid", userids->values,
+			userids->values_num);
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_escalation_media_t	*media;
+
+		ZBX_STR2UINT64(userid, row[0]);
+
+		if (NULL == (user = (zbx_escalation_user_t *)zbx_hashset_search(&batch->users, &userid)))
+			continue;
+
+		media = (zbx_escalation_media_t *)zbx_malloc(NULL, sizeof(zbx_escalation_media_t));
+		ZBX_STR2UINT64(media->mediatypeid, row[1]);
+		media->sendto = zbx_strdup(NULL, row[2]);
+		media->severity = atoi(row[3]);
+		media->period = zbx_strdup(NULL, row[4]);
+		media->mediatype_status = atoi(row[5]);
+		media->active = atoi(row[6]);
+		media->mediatype_type = atoi(row[7]);
+
+		zbx_vector_escalation_media_ptr_append(&user->media, media);
+	}
+	zbx_db_free_result(result);
+
+	zbx_free(sql);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns cached user, loading it if it was not prefetched          *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_escalation_user_t	*escalation_batch_get_user(zbx_escalation_batch_t *batch, zbx_uint64_t userid)
+{
+	zbx_escalation_user_t	*user;
+	zbx_vector_uint64_t	userids;
+
+	if (NULL != (user = (zbx_escalation_user_t *)zbx_hashset_search(&batch->users, &userid)))
+		return user;
+
+	zbx_vector_uint64_create(&userids);
+	zbx_vector_uint64_append(&userids, userid);
+	escalation_batch_load_users(batch, &userids);
+	zbx_vector_uint64_destroy(&userids);
+
+	return (zbx_escalation_user_t *)zbx_hashset_search(&batch->users, &userid);
+}
+
+static int	escalation_batch_check_user_perm2system(zbx_escalation_batch_t *batch, zbx_uint64_t userid)
+{
+	return escalation_batch_get_user(batch, userid)->perm2system;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets recipients of step messages sent by action for event or its  *
+ *          recovery event                                                    *
+ *                                                                            *
+ * Parameters: batch      - [IN] escalation batch data                        *
+ *             actionid   - [IN]                                              *
+ *             eventid    - [IN] problem event identifier                     *
+ *             r_eventid  - [IN] recovery event identifier, 0 if none         *
+ *             recipients - [OUT] sorted unique user and media type pairs     *
+ *                                                                            *
+ * Comments: Message alerts accumulated by the batch are checked too, as they *
+ *           are written to database only after the whole batch is processed. *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_batch_get_recipients(const zbx_escalation_batch_t *batch, zbx_uint64_t actionid,
+		zbx_uint64_t eventid, zbx_uint64_t r_eventid, zbx_vector_uint64_pair_t *recipients)
+{
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_uint64_pair_t	pair;
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select distinct userid,mediatypeid"
+			" from alerts"
+			" where actionid=" ZBX_FS_UI64
+				" and mediatypeid is not null"
+				" and alerttype=%d"
+				" and acknowledgeid is null"
+				" and (eventid=" ZBX_FS_UI64,
+				actionid, ALERT_TYPE_MESSAGE, eventid);
+
+	if (0 != r_eventid)
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " or eventid=" ZBX_FS_UI64, r_eventid);
+
+	zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ')');
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_DBROW2UINT64(pair.first, row[0]);
+		ZBX_STR2UINT64(pair.second, row[1]);
+		zbx_vector_uint64_pair_append(recipients, pair);
+	}
+	zbx_db_free_result(result);
+
+	zbx_free(sql);
+
+	for (int i = 0; i < batch->step_alerts.values_num; i++)
+	{
+		const zbx_escalation_alert_t	*alert = batch->step_alerts.values[i];
+
+		if (alert->actionid != actionid || (alert->eventid != eventid &&
+				(0 == r_eventid || alert->eventid != r_eventid)))
+		{
+			continue;
+		}
+
+		pair.first = alert->userid;
+		pair.second = alert->mediatypeid;
+		zbx_vector_uint64_pair_append(recipients, pair);
+	}
+
+	zbx_vector_uint64_pair_sort(recipients, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+	zbx_vector_uint64_pair_uniq(recipients, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets the last step message sent by action for event to each       *
+ *          recipient                                                         *
+ *                                                                            *
+ * Parameters: batch    - [IN] escalation batch data                          *
+ *             actionid - [IN]                                                *
+ *             eventid  - [IN]                                                *
+ *             alerts   - [OUT] alerts sorted by user and media type          *
+ *                                                                            *
+ * Comments: Message alerts accumulated by the batch are checked too, as they *
+ *           are written to database only after the whole batch is processed. *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_batch_get_last_alerts(const zbx_escalation_batch_t *batch, zbx_uint64_t actionid,
+		zbx_uint64_t eventid, zbx_vector_escalation_alert_ptr_t *alerts)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_escalation_alert_t	*alert;
+	int			i, j;
+
+	result = zbx_db_select(
+			"select userid,mediatypeid,subject,message,esc_step"
+			" from alerts"
+			" where actionid=" ZBX_FS_UI64
+				" and mediatypeid is not null"
+				" and alerttype=%d"
+				" and acknowledgeid is null"
+				" and eventid=" ZBX_FS_UI64,
+				actionid, ALERT_TYPE_MESSAGE, eventid);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_uint64_t	userid, mediatypeid;
+
+		ZBX_DBROW2UINT64(userid, row[0]);
+		ZBX_STR2UINT64(mediatypeid, row[1]);
+
+		alert = escalation_alert_create(actionid, eventid, userid, mediatypeid, row[2], row[3], atoi(row[4]));
+		zbx_vector_escalation_alert_ptr_append(alerts, alert);
+	}
+	zbx_db_free_result(result);
+
+	for (i = 0; i < batch->step_alerts.values_num; i++)
+	{
+		const zbx_escalation_alert_t	*step_alert = batch->step_alerts.values[i];
+
+		if (step_alert->actionid != actionid || step_alert->eventid != eventid)
+			continue;
+
+		alert = escalation_alert_create(actionid, eventid, step_alert->userid, step_alert->mediatypeid,
+				step_alert->subject, step_alert->message, step_alert->esc_step);
+		zbx_vector_escalation_alert_ptr_append(alerts, alert);
+	}
+
+	zbx_vector_escalation_alert_ptr_sort(alerts, escalation_alert_compare_by_recipient);
+
+	/* keep only the last step alerts of each recipient */
+	for (i = 0, j = 0; i < alerts->values_num; i++)
+	{
+		alert = alerts->values[i];
+
+		if (0 != j && alert->userid == alerts->values[j - 1]->userid &&
+				alert->mediatypeid == alerts->values[j - 1]->mediatypeid &&
+				alert->esc_step < alerts->values[j - 1]->esc_step)
+		{
+			escalation_alert_free(alert);
+			continue;
+		}
+
+		alerts->values[j++] = alert;
+	}
+
+	alerts->values_num = j;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns prefetched operations of action sorted by operationid     *
+ *                                                                            *
+ ******************************************************************************/
+static const zbx_vector_escalation_operation_ptr_t	*escalation_batch_get_operations(
+		zbx_escalation_batch_t *batch, zbx_uint64_t actionid)
+{
+	zbx_escalation_action_t	*action;
+
+	if (NULL == (action = (zbx_escalation_action_t *)zbx_hashset_search(&batch->actions, &actionid)))
+		return NULL;
+
+	return &action->operations;
+}
+
+static void	add_message_alert(zbx_escalation_batch_t *batch, const zbx_db_event *event,
+		const zbx_db_event *r_event, zbx_uint64_t actionid, int esc_step, zbx_uint64_t userid,
+		zbx_uint64_t mediatypeid, const char *subject, const char *message, const zbx_db_acknowledge *ack,
+		const zbx_service_alarm_t *service_alarm, const zbx_db_service *service, int err_type,
+		const char *tz);
 
 typedef enum
 {
@@ -698,8 +1131,8 @@ static void	add_user_msg(zbx_uint64_t userid, zbx_uint64_t mediatypeid, zbx_user
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
-static void	add_user_msgs(zbx_uint64_t userid, zbx_uint64_t operationid, zbx_uint64_t mediatypeid,
-		zbx_user_msg_t **user_msg, zbx_uint64_t actionid, const zbx_db_event *event,
+static void	add_user_msgs(zbx_uint64_t userid, const zbx_escalation_operation_t *operation,
+		zbx_uint64_t mediatypeid, zbx_user_msg_t **user_msg, zbx_uint64_t actionid, const zbx_db_event *event,
 		const zbx_db_event *r_event, const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm,
 		const zbx_db_service *service, int macro_type, unsigned char evt_src, unsigned char op_mode,
 		const char *default_timezone, const char *user_timezone)
@@ -716,27 +1149,19 @@ static void	add_user_msgs(zbx_uint64_t userid, zbx_uint64_t operationid, zbx_uin
 	else
 		tz = user_timezone;
 
-	result = zbx_db_select(
-			"select mediatypeid,default_msg,subject,message from opmessage where operationid=" ZBX_FS_UI64,
-			operationid);
-
-	if (NULL != (row = zbx_db_fetch(result)))
-	{
-		if (0 == mediatypeid)
-			ZBX_DBROW2UINT64(mediatypeid, row[0]);
+	if (ZBX_ESCALATION_OPMESSAGE_NONE == operation->opmessage)
+		goto out;
 
-		if (1 != atoi(row[1]))
-		{
-			add_user_msg(userid, mediatypeid, user_msg, row[2], row[3], actionid, event, r_event, ack,
-					service_alarm, service, ZBX_MACRO_EXPAND_YES, macro_type,
-					ZBX_ALERT_MESSAGE_ERR_NONE, tz);
-			goto out;
-		}
+	if (0 == mediatypeid)
+		mediatypeid = operation->mediatypeid;
 
-		zbx_db_free_result(result);
-	}
-	else
+	if (ZBX_ESCALATION_OPMESSAGE_CUSTOM == operation->opmessage)
+	{
+		add_user_msg(userid, mediatypeid, user_msg, operation->subject, operation->message, actionid, event,
+				r_event, ack, service_alarm, service, ZBX_MACRO_EXPAND_YES, macro_type,
+				ZBX_ALERT_MESSAGE_ERR_NONE, tz);
 		goto out;
+	}
 
 	mtid = mediatypeid;
 
@@ -786,45 +1211,30 @@ static void	add_user_msgs(zbx_uint64_t userid, zbx_uint64_t operationid, zbx_uin
 				ZBX_MACRO_EXPAND_NO, 0,
 				0 == mtid ? ZBX_ALERT_MESSAGE_ERR_USR : ZBX_ALERT_MESSAGE_ERR_MSG, tz);
 	}
-out:
-	zbx_db_free_result(result);
 
+	zbx_db_free_result(result);
+out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
-static void	add_object_msg(zbx_uint64_t actionid, zbx_uint64_t operationid, zbx_user_msg_t **user_msg,
-		zbx_db_event *event, const zbx_db_event *r_event, const zbx_db_acknowledge *ack,
-		const zbx_service_alarm_t *service_alarm, const zbx_db_service *service, int macro_type,
-		unsigned char evt_src, unsigned char op_mode, const char *default_timezone, zbx_hashset_t *roles)
+static void	add_object_msg(zbx_uint64_t actionid, const zbx_escalation_operation_t *operation,
+		zbx_user_msg_t **user_msg, zbx_db_event *event, const zbx_db_event *r_event,
+		const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm, const zbx_db_service *service,
+		int macro_type, unsigned char evt_src, unsigned char op_mode, const char *default_timezone,
+		zbx_escalation_batch_t *batch)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	result = zbx_db_select(
-			"select userid"
-			" from opmessage_usr"
-			" where operationid=" ZBX_FS_UI64
-			" union "
-			"select g.userid"
-			" from opmessage_grp m,users_groups g"
-			" where m.usrgrpid=g.usrgrpid"
-				" and m.operationid=" ZBX_FS_UI64,
-			operationid, operationid);
-
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < operation->userids.values_num; i++)
 	{
-		zbx_uint64_t	userid;
+		zbx_uint64_t	userid = operation->userids.values[i];
 		char		*user_timezone = NULL;
 
-		ZBX_STR2UINT64(userid, row[0]);
-
 		/* exclude acknowledgment author from the recipient list */
 		if (NULL != ack && ack->userid == userid)
 			continue;
 
-		if (SUCCEED != zbx_db_check_user_perm2system(userid))
+		if (SUCCEED != escalation_batch_check_user_perm2system(batch, userid))
 			continue;
 
 		switch (event->object)
@@ -839,19 +1249,18 @@ static void	add_object_msg(zbx_uint64_t actionid, zbx_uint64_t operationid, zbx_
 					goto clean;
 				break;
 			case EVENT_OBJECT_SERVICE:
-				if (PERM_READ > get_service_permission(userid, &user_timezone, service, roles))
+				if (PERM_READ > get_service_permission(userid, &user_timezone, service, &batch->roles))
 					goto clean;
 				break;
 			default:
 				user_timezone = zbx_db_get_user_timezone(userid);
 		}
 
-		add_user_msgs(userid, operationid, 0, user_msg, actionid, event, r_event, ack, service_alarm, service,
+		add_user_msgs(userid, operation, 0, user_msg, actionid, event, r_event, ack, service_alarm, service,
 				macro_type, evt_src, op_mode, default_timezone, user_timezone);
 clean:
 		zbx_free(user_timezone);
 	}
-	zbx_db_free_result(result);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -864,7 +1273,7 @@ clean:
  *                                                                            *
  * Parameters: user_msg         - [IN/OUT] message list                       *
  *             actionid         - [IN]                                        *
- *             operationid      - [IN]                                        *
+ *             operation        - [IN]                                        *
  *             event            - [IN]                                        *
  *             r_event          - [IN] recovery event (optional, can be NULL) *
  *             ack              - [IN] (optional, can be NULL)                *
@@ -873,63 +1282,45 @@ clean:
  *             evt_src          - [IN] action event source                    *
  *             op_mode          - [IN] operation mode                         *
  *             default_timezone - [IN]                                        *
- *             roles            - [IN]                                        *
+ *             batch            - [IN/OUT] escalation batch data              *
  *                                                                            *
  ******************************************************************************/
-static void	add_sentusers_msg(zbx_user_msg_t **user_msg, zbx_uint64_t actionid, zbx_uint64_t operationid,
-		zbx_db_event *event, const zbx_db_event *r_event, const zbx_db_acknowledge *ack,
-		const zbx_service_alarm_t *service_alarm, const zbx_db_service *service, unsigned char evt_src,
-		unsigned char op_mode, const char *default_timezone, zbx_hashset_t *roles)
+static void	add_sentusers_msg(zbx_user_msg_t **user_msg, zbx_uint64_t actionid,
+		const zbx_escalation_operation_t *operation, zbx_db_event *event, const zbx_db_event *r_event,
+		const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm, const zbx_db_service *service,
+		unsigned char evt_src, unsigned char op_mode, const char *default_timezone,
+		zbx_escalation_batch_t *batch)
 {
-	char		*sql = NULL;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	int		message_type;
-	size_t		sql_alloc = 0, sql_offset = 0;
+	zbx_vector_uint64_pair_t	recipients;
+	int				message_type;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-			"select distinct userid,mediatypeid"
-			" from alerts"
-			" where actionid=" ZBX_FS_UI64
-				" and mediatypeid is not null"
-				" and alerttype=%d"
-				" and acknowledgeid is null"
-				" and (eventid=" ZBX_FS_UI64,
-				actionid, ALERT_TYPE_MESSAGE, event->eventid);
-
 	if (NULL != r_event)
-	{
 		message_type = ZBX_MACRO_TYPE_MESSAGE_RECOVERY;
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " or eventid=" ZBX_FS_UI64, r_event->eventid);
-	}
 	else
 		message_type = ZBX_MACRO_TYPE_MESSAGE_NORMAL;
 
-	zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ')');
-
 	if (NULL != ack)
 		message_type = ZBX_MACRO_TYPE_MESSAGE_UPDATE;
 
-	result = zbx_db_select("%s", sql);
+	zbx_vector_uint64_pair_create(&recipients);
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	escalation_batch_get_recipients(batch, actionid, event->eventid, NULL != r_event ? r_event->eventid : 0,
+			&recipients);
+
+	for (int i = 0; i < recipients.values_num; i++)
 	{
 		char		*user_timezone = NULL;
-		zbx_uint64_t	userid, mediatypeid;
-
-		ZBX_DBROW2UINT64(userid, row[0]);
+		zbx_uint64_t	userid = recipients.values[i].first, mediatypeid = recipients.values[i].second;
 
 		/* exclude acknowledgment author from the recipient list */
 		if (NULL != ack && ack->userid == userid)
 			continue;
 
-		if (SUCCEED != zbx_db_check_user_perm2system(userid))
+		if (SUCCEED != escalation_batch_check_user_perm2system(batch, userid))
 			continue;
 
-		ZBX_STR2UINT64(mediatypeid, row[1]);
-
 		switch (event->object)
 		{
 			case EVENT_OBJECT_TRIGGER:
@@ -942,21 +1333,20 @@ static void	add_sentusers_msg(zbx_user_msg_t **user_msg, zbx_uint64_t actionid,
 					goto clean;
 				break;
 			case EVENT_OBJECT_SERVICE:
-				if (PERM_READ > get_service_permission(userid, &user_timezone, service, roles))
+				if (PERM_READ > get_service_permission(userid, &user_timezone, service, &batch->roles))
 					goto clean;
 				break;
 			default:
 				user_timezone = zbx_db_get_user_timezone(userid);
 		}
 
-		add_user_msgs(userid, operationid, mediatypeid, user_msg, actionid, event, r_event, ack, service_alarm,
+		add_user_msgs(userid, operation, mediatypeid, user_msg, actionid, event, r_event, ack, service_alarm,
 				service, message_type, evt_src, op_mode, default_timezone, user_timezone);
 clean:
 		zbx_free(user_timezone);
 	}
-	zbx_db_free_result(result);
 
-	zbx_free(sql);
+	zbx_vector_uint64_pair_destroy(&recipients);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -974,89 +1364,67 @@ clean:
  *             error            - [IN]                                        *
  *             default_timezone - [IN]                                        *
  *             service          - [IN]                                        *
- *             roles            - [IN]                                        *
+ *             batch            - [IN/OUT] escalation batch data              *
  *                                                                            *
  ******************************************************************************/
 static void	add_sentusers_msg_esc_cancel(zbx_user_msg_t **user_msg, zbx_uint64_t actionid, zbx_db_event *event,
-		const char *error, const char *default_timezone, const zbx_db_service *service, zbx_hashset_t *roles)
+		const char *error, const char *default_timezone, const zbx_db_service *service,
+		zbx_escalation_batch_t *batch)
 {
-	char		*sql = NULL;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	zbx_uint64_t	userid_prev = 0, mediatypeid_prev = 0;
-	int		esc_step_prev = 0;
-	size_t		sql_alloc = 0, sql_offset = 0;
+	zbx_vector_escalation_alert_ptr_t	alerts;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-			"select userid,mediatypeid,subject,message,esc_step"
-			" from alerts"
-			" where actionid=" ZBX_FS_UI64
-				" and mediatypeid is not null"
-				" and alerttype=%d"
-				" and acknowledgeid is null"
-				" and eventid=" ZBX_FS_UI64
-				" order by userid,mediatypeid,esc_step desc",
-				actionid, ALERT_TYPE_MESSAGE, event->eventid);
+	zbx_vector_escalation_alert_ptr_create(&alerts);
 
-	result = zbx_db_select("%s", sql);
+	escalation_batch_get_last_alerts(batch, actionid, event->eventid, &alerts);
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < alerts.values_num; i++)
 	{
-		char		*message_dyn, *user_timezone = NULL;
-		const char	*tz;
-		zbx_uint64_t	userid, mediatypeid;
-		int		esc_step;
-
-		ZBX_DBROW2UINT64(userid, row[0]);
-		ZBX_STR2UINT64(mediatypeid, row[1]);
-		esc_step = atoi(row[4]);
+		char				*message_dyn, *user_timezone = NULL;
+		const char			*tz;
+		const zbx_escalation_alert_t	*alert = alerts.values[i];
 
-		if (userid == userid_prev && mediatypeid == mediatypeid_prev && esc_step < esc_step_prev)
-			continue;
-
-		userid_prev = userid;
-		mediatypeid_prev = mediatypeid;
-		esc_step_prev = esc_step;
-
-		if (SUCCEED != zbx_db_check_user_perm2system(userid))
+		if (SUCCEED != escalation_batch_check_user_perm2system(batch, alert->userid))
 			continue;
 
 		switch (event->object)
 		{
 			case EVENT_OBJECT_TRIGGER:
-				if (SUCCEED != check_trigger_permission(userid, event, &user_timezone))
+				if (SUCCEED != check_trigger_permission(alert->userid, event, &user_timezone))
 					goto clean;
 				break;
 			case EVENT_OBJECT_ITEM:
 			case EVENT_OBJECT_LLDRULE:
-				if (PERM_READ > zbx_get_item_permission(userid, event->objectid, &user_timezone))
+				if (PERM_READ > zbx_get_item_permission(alert->userid, event->objectid, &user_timezone))
 					goto clean;
 				break;
 			case EVENT_OBJECT_SERVICE:
-				if (PERM_READ > get_service_permission(userid, &user_timezone, service, roles))
+				if (PERM_READ > get_service_permission(alert->userid, &user_timezone, service,
+						&batch->roles))
+				{
 					goto clean;
+				}
 				break;
 			default:
-				user_timezone = zbx_db_get_user_timezone(userid);
+				user_timezone = zbx_db_get_user_timezone(alert->userid);
 		}
 
 		message_dyn = zbx_dsprintf(NULL, "NOTE: Escalation canceled: %s\nLast message sent:\n%s", error,
-				row[3]);
+				alert->message);
 
 		tz = NULL == user_timezone || 0 == strcmp(user_timezone, "default") ? default_timezone : user_timezone;
 
-		add_user_msg(userid, mediatypeid, user_msg, row[2], message_dyn, actionid, event, NULL, NULL,
-				NULL, NULL, ZBX_MACRO_EXPAND_NO, 0, ZBX_ALERT_MESSAGE_ERR_NONE, tz);
+		add_user_msg(alert->userid, alert->mediatypeid, user_msg, alert->subject, message_dyn, actionid, event,
+				NULL, NULL, NULL, NULL, ZBX_MACRO_EXPAND_NO, 0, ZBX_ALERT_MESSAGE_ERR_NONE, tz);
 
 		zbx_free(message_dyn);
 clean:
 		zbx_free(user_timezone);
 	}
-	zbx_db_free_result(result);
 
-	zbx_free(sql);
+	zbx_vector_escalation_alert_ptr_clear_ext(&alerts, escalation_alert_free);
+	zbx_vector_escalation_alert_ptr_destroy(&alerts);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -1068,17 +1436,19 @@ clean:
  *                                                                            *
  * Parameters: user_msg         - [IN/OUT] message list                       *
  *             actionid         - [IN]                                        *
- *             operationid      - [IN]                                        *
+ *             operation        - [IN]                                        *
  *             event            - [IN]                                        *
  *             r_event          - [IN] recovery event                         *
  *             ack              - [IN]                                        *
  *             evt_src          - [IN] action event source                    *
  *             default_timezone - [IN]                                        *
+ *             batch            - [IN/OUT] escalation batch data              *
  *                                                                            *
  ******************************************************************************/
-static void	add_sentusers_ack_msg(zbx_user_msg_t **user_msg, zbx_uint64_t actionid, zbx_uint64_t operationid,
-		zbx_db_event *event, const zbx_db_event *r_event, const zbx_db_acknowledge *ack, unsigned char evt_src,
-		const char *default_timezone)
+static void	add_sentusers_ack_msg(zbx_user_msg_t **user_msg, zbx_uint64_t actionid,
+		const zbx_escalation_operation_t *operation, zbx_db_event *event, const zbx_db_event *r_event,
+		const zbx_db_acknowledge *ack, unsigned char evt_src, const char *default_timezone,
+		zbx_escalation_batch_t *batch)
 {
 	zbx_db_result_t	result;
 	zbx_db_row_t	row;
@@ -1102,13 +1472,13 @@ static void	add_sentusers_ack_msg(zbx_user_msg_t **user_msg, zbx_uint64_t action
 		if (ack->userid == userid)
 			continue;
 
-		if (SUCCEED != zbx_db_check_user_perm2system(userid))
+		if (SUCCEED != escalation_batch_check_user_perm2system(batch, userid))
 			continue;
 
 		if (SUCCEED != check_trigger_permission(userid, event, &user_timezone))
 			goto clean;
 
-		add_user_msgs(userid, operationid, 0, user_msg, actionid, event, r_event, ack, NULL, NULL,
+		add_user_msgs(userid, operation, 0, user_msg, actionid, event, r_event, ack, NULL, NULL,
 				ZBX_MACRO_TYPE_MESSAGE_UPDATE, evt_src, ZBX_OPERATION_MODE_UPDATE, default_timezone,
 				user_timezone);
 clean:
@@ -1119,9 +1489,9 @@ clean:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
-static void	flush_user_msg(zbx_user_msg_t **user_msg, int esc_step, const zbx_db_event *event,
-		const zbx_db_event *r_event, zbx_uint64_t actionid, const zbx_db_acknowledge *ack,
-		const zbx_service_alarm_t *service_alarm, const zbx_db_service *service)
+static void	flush_user_msg(zbx_escalation_batch_t *batch, zbx_user_msg_t **user_msg, int esc_step,
+		const zbx_db_event *event, const zbx_db_event *r_event, zbx_uint64_t actionid,
+		const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm, const zbx_db_service *service)
 {
 	while (NULL != *user_msg)
 	{
@@ -1130,8 +1500,8 @@ static void	flush_user_msg(zbx_user_msg_t **user_msg, int esc_step, const zbx_db
 		p = *user_msg;
 		*user_msg = (zbx_user_msg_t *)(*user_msg)->next;
 
-		add_message_alert(event, r_event, actionid, esc_step, p->userid, p->mediatypeid, p->subject,
-					p->message, ack, service_alarm, service, p->err, p->tz);
+		add_message_alert(batch, event, r_event, actionid, esc_step, p->userid, p->mediatypeid, p->subject,
+				p->message, ack, service_alarm, service, p->err, p->tz);
 
 		zbx_free(p->subject);
 		zbx_free(p->message);
@@ -1666,18 +2036,24 @@ static void	get_mediatype_params_array(const zbx_db_event *event, const zbx_db_e
 	zbx_json_free(&json);
 }
 
-static void	add_message_alert(const zbx_db_event *event, const zbx_db_event *r_event, zbx_uint64_t actionid,
-		int esc_step, zbx_uint64_t userid, zbx_uint64_t mediatypeid, const char *subject, const char *message,
-		const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm, const zbx_db_service *service,
-		int err_type, const char *tz)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds message alerts for user media to batch alert inserts       *
+ *                                                                            *
+ * Comments: Alerts are written to database together with escalation        *
+ *           updates of the batch, see escalation_batch_flush_alerts().       *
+ *                                                                            *
+ ******************************************************************************/
+static void	add_message_alert(zbx_escalation_batch_t *batch, const zbx_db_event *event,
+		const zbx_db_event *r_event, zbx_uint64_t actionid, int esc_step, zbx_uint64_t userid,
+		zbx_uint64_t mediatypeid, const char *subject, const char *message, const zbx_db_acknowledge *ack,
+		const zbx_service_alarm_t *service_alarm, const zbx_db_service *service, int err_type,
+		const char *tz)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	int		now, priority, have_alerts = 0;
-	zbx_db_insert_t	db_insert;
-	zbx_uint64_t	ackid, eventid, p_eventid;
-	char		*period = NULL;
-	const char	*error;
+	int			now, priority, media_num = 0;
+	zbx_uint64_t		ackid, eventid, p_eventid;
+	char			*period = NULL;
+	zbx_escalation_user_t	*user;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -1698,28 +2074,6 @@ static void	add_message_alert(const zbx_db_event *event, const zbx_db_event *r_e
 	if (ZBX_ALERT_MESSAGE_ERR_USR == err_type)
 		goto err_alert;
 
-	if (0 == mediatypeid)
-	{
-		result = zbx_db_select(
-				"select m.mediatypeid,m.sendto,m.severity,m.period,mt.status,m.active,mt.type"
-				" from media m,media_type mt"
-				" where m.mediatypeid=mt.mediatypeid"
-					" and m.userid=" ZBX_FS_UI64,
-				userid);
-	}
-	else
-	{
-		result = zbx_db_select(
-				"select m.mediatypeid,m.sendto,m.severity,m.period,mt.status,m.active,mt.type"
-				" from media m,media_type mt"
-				" where m.mediatypeid=mt.mediatypeid"
-					" and m.userid=" ZBX_FS_UI64
-					" and m.mediatypeid=" ZBX_FS_UI64,
-				userid, mediatypeid);
-	}
-
-	mediatypeid = 0;
-
 	if (EVENT_SOURCE_TRIGGERS == event->source)
 		priority = event->trigger.priority;
 	else if (EVENT_SOURCE_SERVICE == event->source)
@@ -1727,31 +2081,35 @@ static void	add_message_alert(const zbx_db_event *event, const zbx_db_event *r_e
 	else
 		priority = TRIGGER_SEVERITY_NOT_CLASSIFIED;
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	user = escalation_batch_get_user(batch, userid);
+
+	for (int i = 0; i < user->media.values_num; i++)
 	{
-		int		severity, status, type, res;
-		const char	*perror;
-		char		*params;
+		int			status, res;
+		const char		*perror;
+		char			*params;
+		zbx_escalation_media_t	*media = user->media.values[i];
 
-		ZBX_STR2UINT64(mediatypeid, row[0]);
-		severity = atoi(row[2]);
-		period = zbx_strdup(period, row[3]);
-		type = atoi(row[6]);
+		if (0 != mediatypeid && media->mediatypeid != mediatypeid)
+			continue;
+
+		media_num++;
+		period = zbx_strdup(period, media->period);
 
 		zbx_dc_um_handle_t	*um_handle = zbx_dc_open_user_macros();
 		zbx_dc_expand_user_and_func_macros(um_handle, &period, NULL, 0, NULL);
 		zbx_dc_close_user_macros(um_handle);
 
 		zabbix_log(LOG_LEVEL_DEBUG, "severity:%d, media severity:%d, period:'%s', userid:" ZBX_FS_UI64,
-				priority, severity, period, userid);
+				priority, media->severity, period, userid);
 
-		if (MEDIA_STATUS_DISABLED == atoi(row[5]))
+		if (MEDIA_STATUS_DISABLED == media->active)
 		{
 			zabbix_log(LOG_LEVEL_DEBUG, "will not send message (user media disabled)");
 			continue;
 		}
 
-		if (0 == ((1 << priority) & severity))
+		if (0 == ((1 << priority) & media->severity))
 		{
 			zabbix_log(LOG_LEVEL_DEBUG, "will not send message (severity)");
 			continue;
@@ -1767,7 +2125,7 @@ static void	add_message_alert(const zbx_db_event *event, const zbx_db_event *r_e
 			zabbix_log(LOG_LEVEL_DEBUG, "will not send message (period)");
 			continue;
 		}
-		else if (MEDIA_TYPE_STATUS_DISABLED == atoi(row[4]))
+		else if (MEDIA_TYPE_STATUS_DISABLED == media->mediatype_status)
 		{
 			status = ALERT_STATUS_FAILED;
 			perror = "Media type disabled.";
@@ -1783,68 +2141,62 @@ static void	add_message_alert(const zbx_db_event *event, const zbx_db_event *r_e
 			perror = "";
 		}
 
-		if (0 == have_alerts)
+		if (0 == batch->alerts_num)
 		{
-			have_alerts = 1;
-			zbx_db_insert_prepare(&db_insert, "alerts", "alertid", "actionid", "eventid", "userid",
-					"clock", "mediatypeid", "sendto", "subject", "message", "status", "error",
-					"esc_step", "alerttype", "acknowledgeid", "parameters", "p_eventid",
+			zbx_db_insert_prepare(&batch->db_insert_alerts, "alerts", "alertid", "actionid", "eventid",
+					"userid", "clock", "mediatypeid", "sendto", "subject", "message", "status",
+					"error", "esc_step", "alerttype", "acknowledgeid", "parameters", "p_eventid",
 					(char *)NULL);
 		}
 
-		if (MEDIA_TYPE_EXEC == type)
+		if (MEDIA_TYPE_EXEC == media->mediatype_type)
 		{
-			get_mediatype_params_array(event, r_event, actionid, userid, mediatypeid, row[1], subject,
-					message, ack, service_alarm, service, &params, tz);
+			get_mediatype_params_array(event, r_event, actionid, userid, media->mediatypeid, media->sendto,
+					subject, message, ack, service_alarm, service, &params, tz);
 		}
 		else
 		{
-			get_mediatype_params_object(event, r_event, actionid, userid, mediatypeid, row[1], subject,
-					message, ack, service_alarm, service, &params, tz);
+			get_mediatype_params_object(event, r_event, actionid, userid, media->mediatypeid, media->sendto,
+					subject, message, ack, service_alarm, service, &params, tz);
 		}
 
-		zbx_db_insert_add_values(&db_insert, __UINT64_C(0), actionid, eventid, userid,
-				now, mediatypeid, row[1], subject, message, status, perror, esc_step,
+		zbx_db_insert_add_values(&batch->db_insert_alerts, __UINT64_C(0), actionid, eventid, userid,
+				now, media->mediatypeid, media->sendto, subject, message, status, perror, esc_step,
 				(int)ALERT_TYPE_MESSAGE, ackid, params, p_eventid);
+		batch->alerts_num++;
+
+		if (0 == ackid)
+		{
+			zbx_vector_escalation_alert_ptr_append(&batch->step_alerts, escalation_alert_create(actionid,
+					eventid, userid, media->mediatypeid, subject, message, esc_step));
+		}
 
 		zbx_free(params);
 	}
 
 	zbx_free(period);
 
-	zbx_db_free_result(result);
-
-	if (0 == mediatypeid)
+	if (0 == media_num)
 	{
 err_alert:
-		have_alerts = 1;
-		error = "No media defined for user.";
-
-		zbx_db_insert_prepare(&db_insert, "alerts", "alertid", "actionid", "eventid", "userid", "clock",
-				"subject", "message", "status", "retries", "error", "esc_step", "alerttype",
-				"acknowledgeid", "p_eventid", (char *)NULL);
+		if (0 == batch->err_alerts_num)
+		{
+			zbx_db_insert_prepare(&batch->db_insert_err_alerts, "alerts", "alertid", "actionid", "eventid",
+					"userid", "clock", "subject", "message", "status", "retries", "error",
+					"esc_step", "alerttype", "acknowledgeid", "p_eventid", (char *)NULL);
+		}
 
 /* max number of retries for alerts */
 #define ALERT_MAX_RETRIES	3
 
-		zbx_db_insert_add_values(&db_insert, __UINT64_C(0), actionid, eventid, userid,
-				now, subject, message, (int)ALERT_STATUS_FAILED, (int)ALERT_MAX_RETRIES, error,
-				esc_step, (int)ALERT_TYPE_MESSAGE, ackid, p_eventid);
+		zbx_db_insert_add_values(&batch->db_insert_err_alerts, __UINT64_C(0), actionid, eventid, userid,
+				now, subject, message, (int)ALERT_STATUS_FAILED, (int)ALERT_MAX_RETRIES,
+				"No media defined for user.", esc_step, (int)ALERT_TYPE_MESSAGE, ackid, p_eventid);
+		batch->err_alerts_num++;
 
 #undef ALERT_MAX_RETRIES
 	}
 
-	if (0 != have_alerts)
-	{
-		zbx_db_insert_autoincrement(&db_insert, "alertid");
-		zbx_db_insert_execute(&db_insert);
-		zbx_db_insert_clean(&db_insert);
-
-		/* because alerts are inserted without transaction there no need to wait for */
-		/* commit and alerter notification can be sent immediately                   */
-		notify_alerter(ALERTER_NOTIFY);
-	}
-
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
@@ -1852,44 +2204,36 @@ err_alert:
  *                                                                            *
  * Purpose: checks if all conditions of operation match event                 *
  *                                                                            *
- * Parameters: event       - [IN]                                             *
- *             operationid - [IN]                                             *
- *             evaltype    - [IN] condition type                              *
+ * Parameters: event     - [IN]                                               *
+ *             operation - [IN] operation with prefetched conditions          *
  *                                                                            *
  * Return value: SUCCEED - matches, FAIL - otherwise                          *
  *                                                                            *
  ******************************************************************************/
-static int	check_operation_conditions(zbx_db_event *event, zbx_uint64_t operationid, unsigned char evaltype)
+static int	check_operation_conditions(zbx_db_event *event, const zbx_escalation_operation_t *operation)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
 	int		exit = 0, ret = SUCCEED;	/* SUCCEED required for ZBX_CONDITION_EVAL_TYPE_AND_OR */
 	unsigned char	old_type = 0xff;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() operationid:" ZBX_FS_UI64, __func__, operationid);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() operationid:" ZBX_FS_UI64, __func__, operation->operationid);
 
 	/* events with service events source can't have operation conditions */
 	if (EVENT_SOURCE_SERVICE == event->source)
 		goto succeed;
 
-	result = zbx_db_select("select conditiontype,operator,value"
-				" from opconditions"
-				" where operationid=" ZBX_FS_UI64
-				" order by conditiontype",
-			operationid);
-
-	while (NULL != (row = zbx_db_fetch(result)) && 0 == exit)
+	for (int i = 0; i < operation->conditions.values_num && 0 == exit; i++)
 	{
-		int		cond;
-		zbx_condition_t	condition;
+		int				cond;
+		zbx_condition_t			condition;
+		zbx_escalation_opcondition_t	*opcondition = operation->conditions.values[i];
 
 		memset(&condition, 0, sizeof(condition));
-		condition.conditiontype	= (unsigned char)atoi(row[0]);
-		condition.op = (unsigned char)atoi(row[1]);
-		condition.value = row[2];
+		condition.conditiontype	= opcondition->conditiontype;
+		condition.op = opcondition->op;
+		condition.value = opcondition->value;
 		zbx_vector_uint64_create(&condition.eventids);
 
-		switch (evaltype)
+		switch (operation->evaltype)
 		{
 			case ZBX_CONDITION_EVAL_TYPE_AND_OR:
 				if (old_type == condition.conditiontype)	/* OR conditions */
@@ -1937,7 +2281,6 @@ static int	check_operation_conditions(zbx_db_event *event, zbx_uint64_t operatio
 
 		zbx_vector_uint64_destroy(&condition.eventids);
 	}
-	zbx_db_free_result(result);
 succeed:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
@@ -1946,42 +2289,48 @@ succeed:
 
 static void	escalation_execute_operations(zbx_db_escalation *escalation, zbx_db_event *event,
 		const zbx_db_action *action, const zbx_db_service *service, const char *default_timezone,
-		zbx_hashset_t *roles, int config_timeout, int config_trapper_timeout, const char *config_source_ip,
-		const char *config_ssh_key_location, zbx_get_config_forks_f get_config_forks,
-		int config_enable_global_scripts, unsigned char program_type)
+		zbx_escalation_batch_t *batch, int config_timeout, int config_trapper_timeout,
+		const char *config_source_ip, const char *config_ssh_key_location,
+		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	int		next_esc_period = 0, esc_period, default_esc_period;
-	zbx_user_msg_t	*user_msg = NULL;
+	int						next_esc_period = 0, esc_period, default_esc_period,
+							next_steps = 0;
+	zbx_user_msg_t					*user_msg = NULL;
+	const zbx_vector_escalation_operation_ptr_t	*operations;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	default_esc_period = 0 == action->esc_period ? SEC_PER_HOUR : action->esc_period;
 	escalation->esc_step++;
 
-	result = zbx_db_select(
-			"select o.operationid,o.operationtype,o.esc_period,o.evaltype"
-			" from operations o"
-			" where o.actionid=" ZBX_FS_UI64
-				" and o.operationtype in (%d,%d)"
-				" and o.esc_step_from<=%d"
-				" and (o.esc_step_to=0 or o.esc_step_to>=%d)"
-				" and o.recovery=%d",
-			action->actionid,
-			ZBX_OPERATION_TYPE_MESSAGE, ZBX_OPERATION_TYPE_COMMAND,
-			escalation->esc_step,
-			escalation->esc_step,
-			ZBX_OPERATION_MODE_NORMAL);
+	if (NULL == (operations = escalation_batch_get_operations(batch, action->actionid)))
+		goto out;
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < operations->values_num; i++)
 	{
-		char		*tmp;
-		zbx_uint64_t	operationid;
+		char					*tmp;
+		const zbx_escalation_operation_t	*operation = operations->values[i];
 
-		ZBX_STR2UINT64(operationid, row[0]);
+		if (ZBX_OPERATION_MODE_NORMAL != operation->recovery)
+			continue;
+
+		/* check if there are operations left for the next escalation steps */
+		if (0 == operation->esc_step_to || operation->esc_step_to > escalation->esc_step)
+			next_steps = 1;
+
+		if (ZBX_OPERATION_TYPE_MESSAGE != operation->operationtype &&
+				ZBX_OPERATION_TYPE_COMMAND != operation->operationtype)
+		{
+			continue;
+		}
+
+		if (operation->esc_step_from > escalation->esc_step ||
+				(0 != operation->esc_step_to && operation->esc_step_to < escalation->esc_step))
+		{
+			continue;
+		}
 
-		tmp = zbx_strdup(NULL, row[2]);
+		tmp = zbx_strdup(NULL, operation->esc_period);
 
 		zbx_dc_um_handle_t	*um_handle = zbx_dc_open_user_macros();
 		zbx_dc_expand_user_and_func_macros(um_handle, &tmp, NULL, 0, NULL);
@@ -2001,21 +2350,21 @@ static void	escalation_execute_operations(zbx_db_escalation *escalation, zbx_db_
 		if (0 == next_esc_period || next_esc_period > esc_period)
 			next_esc_period = esc_period;
 
-		if (SUCCEED == check_operation_conditions(event, operationid, (unsigned char)atoi(row[3])))
+		if (SUCCEED == check_operation_conditions(event, operation))
 		{
 			zabbix_log(LOG_LEVEL_DEBUG, "Conditions match our event. Execute operation.");
 
-			switch (atoi(row[1]))
+			switch (operation->operationtype)
 			{
 				case ZBX_OPERATION_TYPE_MESSAGE:
-					add_object_msg(action->actionid, operationid, &user_msg, event, NULL, NULL,
+					add_object_msg(action->actionid, operation, &user_msg, event, NULL, NULL,
 							NULL, service, ZBX_MACRO_TYPE_MESSAGE_NORMAL,
 							action->eventsource, ZBX_OPERATION_MODE_NORMAL,
-							default_timezone, roles);
+							default_timezone, batch);
 					break;
 				case ZBX_OPERATION_TYPE_COMMAND:
 					execute_commands(event, NULL, NULL, NULL, service, action->actionid,
-							operationid, escalation->esc_step,
+							operation->operationid, escalation->esc_step,
 							ZBX_MACRO_TYPE_MESSAGE_NORMAL, default_timezone, config_timeout,
 							config_trapper_timeout, config_source_ip,
 							config_ssh_key_location, get_config_forks, config_enable_global_scripts, program_type);
@@ -2025,25 +2374,13 @@ static void	escalation_execute_operations(zbx_db_escalation *escalation, zbx_db_
 		else
 			zabbix_log(LOG_LEVEL_DEBUG, "Conditions do not match our event. Do not execute operation.");
 	}
-	zbx_db_free_result(result);
-
-	flush_user_msg(&user_msg, escalation->esc_step, event, NULL, action->actionid, NULL, NULL, service);
 
+	flush_user_msg(batch, &user_msg, escalation->esc_step, event, NULL, action->actionid, NULL, NULL, service);
+out:
 	if (EVENT_SOURCE_TRIGGERS == action->eventsource || EVENT_SOURCE_INTERNAL == action->eventsource ||
 			EVENT_SOURCE_SERVICE == action->eventsource)
 	{
-		char	*sql;
-
-		sql = zbx_dsprintf(NULL,
-				"select null"
-				" from operations"
-				" where actionid=" ZBX_FS_UI64
-					" and (esc_step_to>%d or esc_step_to=0)"
-					" and recovery=%d",
-					action->actionid, escalation->esc_step, ZBX_OPERATION_MODE_NORMAL);
-		result = zbx_db_select_n(sql, 1);
-
-		if (NULL != zbx_db_fetch(result))
+		if (0 != next_steps)
 		{
 			next_esc_period = (0 != next_esc_period ? next_esc_period : default_esc_period);
 			escalation->nextcheck = time(NULL) + next_esc_period;
@@ -2055,9 +2392,6 @@ static void	escalation_execute_operations(zbx_db_escalation *escalation, zbx_db_
 		}
 		else
 			escalation->status = ESCALATION_STATUS_COMPLETED;
-
-		zbx_db_free_result(result);
-		zbx_free(sql);
 	}
 	else
 		escalation->status = ESCALATION_STATUS_COMPLETED;
@@ -2074,7 +2408,7 @@ static void	escalation_execute_operations(zbx_db_escalation *escalation, zbx_db_
  *             action                  - [IN]                                 *
  *             service                 - [IN]                                 *
  *             default_timezone        - [IN]                                 *
- *             roles                   - [IN]                                 *
+ *             batch                   - [IN/OUT] escalation batch data       *
  *             config_timeout          - [IN]                                 *
  *             config_trapper_timeout  - [IN]                                 *
  *             config_source_ip        - [IN]                                 *
@@ -2089,56 +2423,49 @@ static void	escalation_execute_operations(zbx_db_escalation *escalation, zbx_db_
  ******************************************************************************/
 static void	escalation_execute_recovery_operations(zbx_db_event *event, const zbx_db_event *r_event,
 		const zbx_db_action *action, const zbx_db_service *service, const char *default_timezone,
-		zbx_hashset_t *roles, int config_timeout, int config_trapper_timeout, const char *config_source_ip,
-		const char *config_ssh_key_location, zbx_get_config_forks_f get_config_forks,
-		int config_enable_global_scripts, unsigned char program_type)
+		zbx_escalation_batch_t *batch, int config_timeout, int config_trapper_timeout,
+		const char *config_source_ip, const char *config_ssh_key_location,
+		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	zbx_user_msg_t	*user_msg = NULL;
-	zbx_uint64_t	operationid;
-	unsigned char	operationtype;
+	zbx_user_msg_t					*user_msg = NULL;
+	const zbx_vector_escalation_operation_ptr_t	*operations;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	result = zbx_db_select(
-			"select o.operationid,o.operationtype"
-			" from operations o"
-			" where o.actionid=" ZBX_FS_UI64
-				" and o.operationtype in (%d,%d,%d)"
-				" and o.recovery=%d",
-			action->actionid,
-			ZBX_OPERATION_TYPE_MESSAGE, ZBX_OPERATION_TYPE_COMMAND, ZBX_OPERATION_TYPE_RECOVERY_MESSAGE,
-			ZBX_OPERATION_MODE_RECOVERY);
+	if (NULL == (operations = escalation_batch_get_operations(batch, action->actionid)))
+		goto out;
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < operations->values_num; i++)
 	{
-		ZBX_STR2UINT64(operationid, row[0]);
-		operationtype = (unsigned char)atoi(row[1]);
+		const zbx_escalation_operation_t	*operation = operations->values[i];
 
-		switch (operationtype)
+		if (ZBX_OPERATION_MODE_RECOVERY != operation->recovery)
+			continue;
+
+		switch (operation->operationtype)
 		{
 			case ZBX_OPERATION_TYPE_MESSAGE:
-				add_object_msg(action->actionid, operationid, &user_msg, event, r_event, NULL, NULL,
+				add_object_msg(action->actionid, operation, &user_msg, event, r_event, NULL, NULL,
 						service, ZBX_MACRO_TYPE_MESSAGE_RECOVERY, action->eventsource,
-						ZBX_OPERATION_MODE_RECOVERY, default_timezone, roles);
+						ZBX_OPERATION_MODE_RECOVERY, default_timezone, batch);
 				break;
 			case ZBX_OPERATION_TYPE_RECOVERY_MESSAGE:
-				add_sentusers_msg(&user_msg, action->actionid, operationid, event, r_event, NULL, NULL,
+				add_sentusers_msg(&user_msg, action->actionid, operation, event, r_event, NULL, NULL,
 						service, action->eventsource, ZBX_OPERATION_MODE_RECOVERY,
-						default_timezone, roles);
+						default_timezone, batch);
 				break;
 			case ZBX_OPERATION_TYPE_COMMAND:
-				execute_commands(event, r_event, NULL, NULL, service, action->actionid, operationid, 1,
-						ZBX_MACRO_TYPE_MESSAGE_RECOVERY, default_timezone, config_timeout,
-						config_trapper_timeout, config_source_ip, config_ssh_key_location,
-						get_config_forks, config_enable_global_scripts, program_type);
+				execute_commands(event, r_event, NULL, NULL, service, action->actionid,
+						operation->operationid, 1, ZBX_MACRO_TYPE_MESSAGE_RECOVERY,
+						default_timezone, config_timeout, config_trapper_timeout,
+						config_source_ip, config_ssh_key_location, get_config_forks,
+						config_enable_global_scripts, program_type);
 				break;
 		}
 	}
-	zbx_db_free_result(result);
 
-	flush_user_msg(&user_msg, 1, event, r_event, action->actionid, NULL, NULL, service);
+	flush_user_msg(batch, &user_msg, 1, event, r_event, action->actionid, NULL, NULL, service);
+out:
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -2152,7 +2479,7 @@ static void	escalation_execute_recovery_operations(zbx_db_event *event, const zb
  *             service_alarm           - [IN]                                 *
  *             service                 - [IN]                                 *
  *             default_timezone        - [IN]                                 *
- *             roles                   - [IN]                                 *
+ *             batch                   - [IN/OUT] escalation batch data       *
  *             config_timeout          - [IN]                                 *
  *             config_trapper_timeout  - [IN]                                 *
  *             config_source_ip        - [IN]                                 *
@@ -2167,64 +2494,57 @@ static void	escalation_execute_recovery_operations(zbx_db_event *event, const zb
  ******************************************************************************/
 static void	escalation_execute_update_operations(zbx_db_event *event, const zbx_db_event *r_event,
 		const zbx_db_action *action, const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm,
-		const zbx_db_service *service, const char *default_timezone, zbx_hashset_t *roles, int config_timeout,
-		int config_trapper_timeout, const char *config_source_ip, const char *config_ssh_key_location,
-		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
+		const zbx_db_service *service, const char *default_timezone, zbx_escalation_batch_t *batch,
+		int config_timeout, int config_trapper_timeout, const char *config_source_ip,
+		const char *config_ssh_key_location, zbx_get_config_forks_f get_config_forks,
+		int config_enable_global_scripts, unsigned char program_type)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	zbx_user_msg_t	*user_msg = NULL;
-	zbx_uint64_t	operationid;
-	unsigned char	operationtype;
+	zbx_user_msg_t					*user_msg = NULL;
+	const zbx_vector_escalation_operation_ptr_t	*operations;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	result = zbx_db_select(
-			"select o.operationid,o.operationtype"
-			" from operations o"
-			" where o.actionid=" ZBX_FS_UI64
-				" and o.operationtype in (%d,%d,%d)"
-				" and o.recovery=%d",
-			action->actionid,
-			ZBX_OPERATION_TYPE_MESSAGE, ZBX_OPERATION_TYPE_COMMAND, ZBX_OPERATION_TYPE_UPDATE_MESSAGE,
-			ZBX_OPERATION_MODE_UPDATE);
+	if (NULL == (operations = escalation_batch_get_operations(batch, action->actionid)))
+		goto out;
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < operations->values_num; i++)
 	{
-		ZBX_STR2UINT64(operationid, row[0]);
-		operationtype = (unsigned char)atoi(row[1]);
+		const zbx_escalation_operation_t	*operation = operations->values[i];
 
-		switch (operationtype)
+		if (ZBX_OPERATION_MODE_UPDATE != operation->recovery)
+			continue;
+
+		switch (operation->operationtype)
 		{
 			case ZBX_OPERATION_TYPE_MESSAGE:
-				add_object_msg(action->actionid, operationid, &user_msg, event, r_event, ack,
+				add_object_msg(action->actionid, operation, &user_msg, event, r_event, ack,
 						service_alarm, service, ZBX_MACRO_TYPE_MESSAGE_UPDATE,
 						action->eventsource, ZBX_OPERATION_MODE_UPDATE, default_timezone,
-						roles);
+						batch);
 				break;
 			case ZBX_OPERATION_TYPE_UPDATE_MESSAGE:
-				add_sentusers_msg(&user_msg, action->actionid, operationid, event, r_event, ack,
+				add_sentusers_msg(&user_msg, action->actionid, operation, event, r_event, ack,
 						service_alarm, service, action->eventsource, ZBX_OPERATION_MODE_UPDATE,
-						default_timezone, roles);
+						default_timezone, batch);
 
 				if (NULL != ack)
 				{
-					add_sentusers_ack_msg(&user_msg, action->actionid, operationid, event, r_event,
-							ack, action->eventsource, default_timezone);
+					add_sentusers_ack_msg(&user_msg, action->actionid, operation, event, r_event,
+							ack, action->eventsource, default_timezone, batch);
 				}
 				break;
 			case ZBX_OPERATION_TYPE_COMMAND:
 				execute_commands(event, r_event, ack, service_alarm, service, action->actionid,
-						operationid, 1, ZBX_MACRO_TYPE_MESSAGE_UPDATE, default_timezone,
-						config_timeout, config_trapper_timeout, config_source_ip,
-						config_ssh_key_location, get_config_forks,
+						operation->operationid, 1, ZBX_MACRO_TYPE_MESSAGE_UPDATE,
+						default_timezone, config_timeout, config_trapper_timeout,
+						config_source_ip, config_ssh_key_location, get_config_forks,
 						config_enable_global_scripts, program_type);
 				break;
 		}
 	}
-	zbx_db_free_result(result);
 
-	flush_user_msg(&user_msg, 1, event, r_event, action->actionid, ack, service_alarm, service);
+	flush_user_msg(batch, &user_msg, 1, event, r_event, action->actionid, ack, service_alarm, service);
+out:
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -2577,11 +2897,12 @@ static void	escalation_log_cancel_warning(const zbx_db_escalation *escalation, c
  *             error            - [IN]                                        *
  *             default_timezone - [IN]                                        *
  *             service          - [IN]                                        *
- *             roles            - [IN]                                        *
+ *             batch            - [IN/OUT] escalation batch data              *
  *                                                                            *
  ******************************************************************************/
 static void	escalation_cancel(zbx_db_escalation *escalation, const zbx_db_action *action, zbx_db_event *event,
-		const char *error, const char *default_timezone, const zbx_db_service *service, zbx_hashset_t *roles)
+		const char *error, const char *default_timezone, const zbx_db_service *service,
+		zbx_escalation_batch_t *batch)
 {
 /* action escalation canceled notification mode */
 /* #define ACTION_NOTIFY_IF_CANCELED_TRUE	1 notify about canceled escalations for action (default) */
@@ -2596,8 +2917,9 @@ static void	escalation_cancel(zbx_db_escalation *escalation, const zbx_db_action
 			ACTION_NOTIFY_IF_CANCELED_FALSE != action->notify_if_canceled)
 	{
 		add_sentusers_msg_esc_cancel(&user_msg, action->actionid, event, ZBX_NULL2EMPTY_STR(error),
-				default_timezone, service, roles);
-		flush_user_msg(&user_msg, escalation->esc_step, event, NULL, action->actionid, NULL, NULL, NULL);
+				default_timezone, service, batch);
+		flush_user_msg(batch, &user_msg, escalation->esc_step, event, NULL, action->actionid, NULL, NULL,
+				NULL);
 	}
 
 	escalation_log_cancel_warning(escalation, ZBX_NULL2EMPTY_STR(error));
@@ -2616,7 +2938,7 @@ static void	escalation_cancel(zbx_db_escalation *escalation, const zbx_db_action
  *             event                   - [IN]                                 *
  *             service                 - [IN]                                 *
  *             default_timezone        - [IN]                                 *
- *             roles                   - [IN]                                 *
+ *             batch                   - [IN/OUT] escalation batch data       *
  *             config_timeout          - [IN]                                 *
  *             config_trapper_timeout  - [IN]                                 *
  *             config_source_ip        - [IN]                                 *
@@ -2626,14 +2948,15 @@ static void	escalation_cancel(zbx_db_escalation *escalation, const zbx_db_action
  *                                                                            *
  ******************************************************************************/
 static void	escalation_execute(zbx_db_escalation *escalation, const zbx_db_action *action, zbx_db_event *event,
-		const zbx_db_service *service, const char *default_timezone, zbx_hashset_t *roles, int config_timeout,
-		int config_trapper_timeout, const char *config_source_ip, const char *config_ssh_key_location,
-		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
+		const zbx_db_service *service, const char *default_timezone, zbx_escalation_batch_t *batch,
+		int config_timeout, int config_trapper_timeout, const char *config_source_ip,
+		const char *config_ssh_key_location, zbx_get_config_forks_f get_config_forks,
+		int config_enable_global_scripts, unsigned char program_type)
 {
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() escalationid:" ZBX_FS_UI64 " status:%s",
 			__func__, escalation->escalationid, escalation_status_string(escalation->status));
 
-	escalation_execute_operations(escalation, event, action, service, default_timezone, roles, config_timeout,
+	escalation_execute_operations(escalation, event, action, service, default_timezone, batch, config_timeout,
 			config_trapper_timeout, config_source_ip, config_ssh_key_location, get_config_forks,
 			config_enable_global_scripts, program_type);
 
@@ -2650,7 +2973,7 @@ static void	escalation_execute(zbx_db_escalation *escalation, const zbx_db_actio
  *             r_event                 - [IN] recovery event                  *
  *             service                 - [IN]                                 *
  *             default_timezone        - [IN]                                 *
- *             roles                   - [IN]                                 *
+ *             batch                   - [IN/OUT] escalation batch data       *
  *             config_timeout          - [IN]                                 *
  *             config_trapper_timeout  - [IN]                                 *
  *             config_source_ip        - [IN]                                 *
@@ -2661,14 +2984,14 @@ static void	escalation_execute(zbx_db_escalation *escalation, const zbx_db_actio
  ******************************************************************************/
 static void	escalation_recover(zbx_db_escalation *escalation, const zbx_db_action *action, zbx_db_event *event,
 		const zbx_db_event *r_event, const zbx_db_service *service, const char *default_timezone,
-		zbx_hashset_t *roles, int config_timeout, int config_trapper_timeout, const char *config_source_ip,
-		const char *config_ssh_key_location, zbx_get_config_forks_f get_config_forks,
-		int config_enable_global_scripts, unsigned char program_type)
+		zbx_escalation_batch_t *batch, int config_timeout, int config_trapper_timeout,
+		const char *config_source_ip, const char *config_ssh_key_location,
+		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
 {
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() escalationid:" ZBX_FS_UI64 " status:%s",
 			__func__, escalation->escalationid, escalation_status_string(escalation->status));
 
-	escalation_execute_recovery_operations(event, r_event, action, service, default_timezone, roles,
+	escalation_execute_recovery_operations(event, r_event, action, service, default_timezone, batch,
 			config_timeout, config_trapper_timeout, config_source_ip, config_ssh_key_location,
 			get_config_forks, config_enable_global_scripts, program_type);
 
@@ -2686,7 +3009,7 @@ static void	escalation_recover(zbx_db_escalation *escalation, const zbx_db_actio
  *             event                   - [IN]                                 *
  *             r_event                 - [IN] recovery event                  *
  *             default_timezone        - [IN]                                 *
- *             roles                   - [IN]                                 *
+ *             batch                   - [IN/OUT] escalation batch data       *
  *             config_timeout          - [IN]                                 *
  *             config_trapper_timeout  - [IN]                                 *
  *             config_source_ip        - [IN]                                 *
@@ -2697,42 +3020,24 @@ static void	escalation_recover(zbx_db_escalation *escalation, const zbx_db_actio
  ******************************************************************************/
 static void	escalation_acknowledge(zbx_db_escalation *escalation, const zbx_db_action *action,
 		zbx_db_event *event, const zbx_db_event *r_event, const char *default_timezone,
-		zbx_hashset_t *roles, int config_timeout, int config_trapper_timeout, const char *config_source_ip,
-		const char *config_ssh_key_location, zbx_get_config_forks_f get_config_forks,
-		int config_enable_global_scripts, unsigned char program_type)
+		zbx_escalation_batch_t *batch, int config_timeout, int config_trapper_timeout,
+		const char *config_source_ip, const char *config_ssh_key_location,
+		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
 {
-	zbx_db_row_t	row;
-	zbx_db_result_t	result;
+	const zbx_db_acknowledge	*ack;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() escalationid:" ZBX_FS_UI64 " acknowledgeid:" ZBX_FS_UI64 " status:%s",
 			__func__, escalation->escalationid, escalation->acknowledgeid,
 			escalation_status_string(escalation->status));
 
-	result = zbx_db_select(
-			"select message,userid,clock,action,old_severity,new_severity,suppress_until from acknowledges"
-			" where acknowledgeid=" ZBX_FS_UI64,
-			escalation->acknowledgeid);
-
-	if (NULL != (row = zbx_db_fetch(result)))
+	if (NULL != (ack = (const zbx_db_acknowledge *)zbx_hashset_search(&batch->acknowledges,
+			&escalation->acknowledgeid)))
 	{
-		zbx_db_acknowledge	ack;
-
-		ack.message = row[0];
-		ZBX_STR2UINT64(ack.userid, row[1]);
-		ack.clock = atoi(row[2]);
-		ack.acknowledgeid = escalation->acknowledgeid;
-		ack.action = atoi(row[3]);
-		ack.old_severity = atoi(row[4]);
-		ack.new_severity = atoi(row[5]);
-		ack.suppress_until = atoi(row[6]);
-
-		escalation_execute_update_operations(event, r_event, action, &ack, NULL, NULL, default_timezone, roles,
+		escalation_execute_update_operations(event, r_event, action, ack, NULL, NULL, default_timezone, batch,
 				config_timeout, config_trapper_timeout, config_source_ip, config_ssh_key_location,
 				get_config_forks, config_enable_global_scripts, program_type);
 	}
 
-	zbx_db_free_result(result);
-
 	escalation->status = ESCALATION_STATUS_COMPLETED;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
@@ -2748,7 +3053,7 @@ static void	escalation_acknowledge(zbx_db_escalation *escalation, const zbx_db_a
  *             service_alarm           - [IN]                                 *
  *             service                 - [IN]                                 *
  *             default_timezone        - [IN]                                 *
- *             roles                   - [IN]                                 *
+ *             batch                   - [IN/OUT] escalation batch data       *
  *             config_timeout          - [IN]                                 *
  *             config_trapper_timeout  - [IN]                                 *
  *             config_source_ip        - [IN]                                 *
@@ -2759,8 +3064,8 @@ static void	escalation_acknowledge(zbx_db_escalation *escalation, const zbx_db_a
  ******************************************************************************/
 static void	escalation_update(zbx_db_escalation *escalation, const zbx_db_action *action,
 		zbx_db_event *event, const zbx_service_alarm_t *service_alarm, const zbx_db_service *service,
-		const char *default_timezone, zbx_hashset_t *roles, int config_timeout, int config_trapper_timeout,
-		const char *config_source_ip, const char *config_ssh_key_location,
+		const char *default_timezone, zbx_escalation_batch_t *batch, int config_timeout,
+		int config_trapper_timeout, const char *config_source_ip, const char *config_ssh_key_location,
 		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
 {
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() escalationid:" ZBX_FS_UI64 " servicealarmid:" ZBX_FS_UI64 " status:%s",
@@ -2768,7 +3073,7 @@ static void	escalation_update(zbx_db_escalation *escalation, const zbx_db_action
 			escalation_status_string(escalation->status));
 
 	escalation_execute_update_operations(event, NULL, action, NULL, service_alarm, service, default_timezone,
-			roles, config_timeout, config_trapper_timeout, config_source_ip, config_ssh_key_location,
+			batch, config_timeout, config_trapper_timeout, config_source_ip, config_ssh_key_location,
 			get_config_forks, config_enable_global_scripts, program_type);
 
 	escalation->status = ESCALATION_STATUS_COMPLETED;
@@ -3100,6 +3405,359 @@ static void	service_role_clean(zbx_service_role_t *role)
 	zbx_vector_uint64_destroy(&role->serviceids);
 }
 
+static void	escalation_operation_clean(zbx_escalation_operation_t *operation)
+{
+	zbx_free(operation->esc_period);
+	zbx_free(operation->subject);
+	zbx_free(operation->message);
+	zbx_vector_escalation_opcondition_ptr_clear_ext(&operation->conditions, escalation_opcondition_free);
+	zbx_vector_escalation_opcondition_ptr_destroy(&operation->conditions);
+	zbx_vector_uint64_destroy(&operation->userids);
+}
+
+static void	escalation_action_clean(zbx_escalation_action_t *action)
+{
+	zbx_vector_escalation_operation_ptr_destroy(&action->operations);
+}
+
+static void	escalation_user_clean(zbx_escalation_user_t *user)
+{
+	zbx_vector_escalation_media_ptr_clear_ext(&user->media, escalation_media_free);
+	zbx_vector_escalation_media_ptr_destroy(&user->media);
+}
+
+static void	escalation_acknowledge_clean(zbx_db_acknowledge *ack)
+{
+	zbx_free(ack->message);
+}
+
+static void	escalation_batch_init(zbx_escalation_batch_t *batch)
+{
+	zbx_hashset_create_ext(&batch->roles, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)service_role_clean,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create_ext(&batch->operations, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)escalation_operation_clean,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create_ext(&batch->actions, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)escalation_action_clean,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create_ext(&batch->users, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)escalation_user_clean,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create_ext(&batch->acknowledges, 0, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)escalation_acknowledge_clean,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+
+	batch->alerts_num = 0;
+	batch->err_alerts_num = 0;
+	zbx_vector_escalation_alert_ptr_create(&batch->step_alerts);
+}
+
+static void	escalation_batch_clean(zbx_escalation_batch_t *batch)
+{
+	if (0 != batch->alerts_num)
+		zbx_db_insert_clean(&batch->db_insert_alerts);
+
+	if (0 != batch->err_alerts_num)
+		zbx_db_insert_clean(&batch->db_insert_err_alerts);
+
+	zbx_vector_escalation_alert_ptr_clear_ext(&batch->step_alerts, escalation_alert_free);
+	zbx_vector_escalation_alert_ptr_destroy(&batch->step_alerts);
+
+	zbx_hashset_destroy(&batch->acknowledges);
+	zbx_hashset_destroy(&batch->users);
+	zbx_hashset_destroy(&batch->actions);
+	zbx_hashset_destroy(&batch->operations);
+	zbx_hashset_destroy(&batch->roles);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prefetches operations with their conditions, messages and       *
+ *          recipients for actions of escalation batch                        *
+ *                                                                            *
+ * Parameters: batch     - [IN/OUT]                                           *
+ *             actionids - [IN] sorted action identifiers                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_batch_load_operations(zbx_escalation_batch_t *batch, const zbx_vector_uint64_t *actionids)
+{
+	zbx_db_result_t			result;
+	zbx_db_row_t			row;
+	char				*sql = NULL;
+	size_t				sql_alloc = 0, sql_offset = 0;
+	zbx_vector_uint64_t		operationids, userids;
+	zbx_uint64_t			operationid, userid;
+	zbx_escalation_operation_t	*operation, operation_local;
+	zbx_escalation_action_t		*action, action_local;
+	zbx_hashset_iter_t		iter;
+
+	if (0 == actionids->values_num)
+		return;
+
+	zbx_vector_uint64_create(&operationids);
+	zbx_vector_uint64_create(&userids);
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			"select operationid,actionid,operationtype,esc_period,evaltype,esc_step_from,esc_step_to,"
+				"recovery"
+			" from operations"
+			" where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "actionid", actionids->values,
+			actionids->values_num);
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " order by operationid");
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		memset(&operation_local, 0, sizeof(operation_local));
+		ZBX_STR2UINT64(operation_local.operationid, row[0]);
+		ZBX_STR2UINT64(operation_local.actionid, row[1]);
+
+		operation = (zbx_escalation_operation_t *)zbx_hashset_insert(&batch->operations, &operation_local,
+				sizeof(operation_local));
+
+		ZBX_STR2UCHAR(operation->operationtype, row[2]);
+		operation->esc_period = zbx_strdup(NULL, row[3]);
+		ZBX_STR2UCHAR(operation->evaltype, row[4]);
+		operation->esc_step_from = atoi(row[5]);
+		operation->esc_step_to = atoi(row[6]);
+		ZBX_STR2UCHAR(operation->recovery, row[7]);
+		operation->opmessage = ZBX_ESCALATION_OPMESSAGE_NONE;
+		zbx_vector_escalation_opcondition_ptr_create(&operation->conditions);
+		zbx_vector_uint64_create(&operation->userids);
+
+		if (NULL == (action = (zbx_escalation_action_t *)zbx_hashset_search(&batch->actions,
+				&operation->actionid)))
+		{
+			action_local.actionid = operation->actionid;
+			action = (zbx_escalation_action_t *)zbx_hashset_insert(&batch->actions, &action_local,
+					sizeof(action_local));
+			zbx_vector_escalation_operation_ptr_create(&action->operations);
+		}
+
+		zbx_vector_escalation_operation_ptr_append(&action->operations, operation);
+		zbx_vector_uint64_append(&operationids, operation->operationid);
+	}
+	zbx_db_free_result(result);
+
+	if (0 == operationids.values_num)
+		goto out;
+
+	/* operations were selected in operationid order */
+
+	sql_offset = 0;
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			"select operationid,conditiontype,operator,value"
+			" from opconditions"
+			" where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "operationid", operationids.values,
+			operationids.values_num);
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " order by operationid,conditiontype");
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_escalation_opcondition_t	*condition;
+
+		ZBX_STR2UINT64(operationid, row[0]);
+
+		if (NULL == (operation = (zbx_escalation_operation_t *)zbx_hashset_search(&batch->operations,
+				&operationid)))
+		{
+			continue;
+		}
+
+		condition = (zbx_escalation_opcondition_t *)zbx_malloc(NULL, sizeof(zbx_escalation_opcondition_t));
+		ZBX_STR2UCHAR(condition->conditiontype, row[1]);
+		ZBX_STR2UCHAR(condition->op, row[2]);
+		condition->value = zbx_strdup(NULL, row[3]);
+		zbx_vector_escalation_opcondition_ptr_append(&operation->conditions, condition);
+	}
+	zbx_db_free_result(result);
+
+	sql_offset = 0;
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			"select operationid,mediatypeid,default_msg,subject,message"
+			" from opmessage"
+			" where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "operationid", operationids.values,
+			operationids.values_num);
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(operationid, row[0]);
+
+		if (NULL == (operation = (zbx_escalation_operation_t *)zbx_hashset_search(&batch->operations,
+				&operationid)))
+		{
+			continue;
+		}
+
+		ZBX_DBROW2UINT64(operation->mediatypeid, row[1]);
+
+		if (1 != atoi(row[2]))
+		{
+			operation->opmessage = ZBX_ESCALATION_OPMESSAGE_CUSTOM;
+			operation->subject = zbx_strdup(NULL, row[3]);
+			operation->message = zbx_strdup(NULL, row[4]);
+		}
+		else
+			operation->opmessage = ZBX_ESCALATION_OPMESSAGE_DEFAULT;
+	}
+	zbx_db_free_result(result);
+
+	sql_offset = 0;
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			"select operationid,userid"
+			" from opmessage_usr"
+			" where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "operationid", operationids.values,
+			operationids.values_num);
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			" union "
+			"select m.operationid,g.userid"
+			" from opmessage_grp m,users_groups g"
+			" where m.usrgrpid=g.usrgrpid"
+				" and");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "m.operationid", operationids.values,
+			operationids.values_num);
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(operationid, row[0]);
+		ZBX_STR2UINT64(userid, row[1]);
+
+		if (NULL == (operation = (zbx_escalation_operation_t *)zbx_hashset_search(&batch->operations,
+				&operationid)))
+		{
+			continue;
+		}
+
+		zbx_vector_uint64_append(&operation->userids, userid);
+		zbx_vector_uint64_append(&userids, userid);
+	}
+	zbx_db_free_result(result);
+
+	zbx_hashset_iter_reset(&batch->operations, &iter);
+	while (NULL != (operation = (zbx_escalation_operation_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_vector_uint64_sort(&operation->userids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_uniq(&operation->userids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	}
+
+	/* prefetch permissions and media of all operation message recipients */
+	zbx_vector_uint64_sort(&userids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(&userids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	escalation_batch_load_users(batch, &userids);
+out:
+	zbx_free(sql);
+
+	zbx_vector_uint64_destroy(&userids);
+	zbx_vector_uint64_destroy(&operationids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prefetches acknowledgments of escalation batch                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_batch_load_acknowledges(zbx_escalation_batch_t *batch,
+		const zbx_vector_db_escalation_ptr_t *escalations)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
+	zbx_vector_uint64_t	acknowledgeids;
+
+	zbx_vector_uint64_create(&acknowledgeids);
+
+	for (int i = 0; i < escalations->values_num; i++)
+	{
+		if (0 != escalations->values[i]->acknowledgeid)
+			zbx_vector_uint64_append(&acknowledgeids, escalations->values[i]->acknowledgeid);
+	}
+
+	if (0 == acknowledgeids.values_num)
+		goto out;
+
+	zbx_vector_uint64_sort(&acknowledgeids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(&acknowledgeids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			"select acknowledgeid,message,userid,clock,action,old_severity,new_severity,suppress_until"
+			" from acknowledges"
+			" where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "acknowledgeid", acknowledgeids.values,
+			acknowledgeids.values_num);
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_db_acknowledge	ack;
+
+		ZBX_STR2UINT64(ack.acknowledgeid, row[0]);
+		ack.message = zbx_strdup(NULL, row[1]);
+		ZBX_STR2UINT64(ack.userid, row[2]);
+		ack.clock = atoi(row[3]);
+		ack.action = atoi(row[4]);
+		ack.old_severity = atoi(row[5]);
+		ack.new_severity = atoi(row[6]);
+		ack.suppress_until = atoi(row[7]);
+
+		zbx_hashset_insert(&batch->acknowledges, &ack, sizeof(ack));
+	}
+	zbx_db_free_result(result);
+
+	zbx_free(sql);
+out:
+	zbx_vector_uint64_destroy(&acknowledgeids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes message alerts accumulated by escalation batch           *
+ *                                                                            *
+ * Return value: number of written alerts                                     *
+ *                                                                            *
+ * Comments: Must be called inside escalation update transaction so alerts    *
+ *           and escalation steps that generated them are committed together. *
+ *                                                                            *
+ ******************************************************************************/
+static int	escalation_batch_flush_alerts(zbx_escalation_batch_t *batch)
+{
+	int	alerts_num = batch->alerts_num + batch->err_alerts_num;
+
+	if (0 != batch->alerts_num)
+	{
+		zbx_db_insert_autoincrement(&batch->db_insert_alerts, "alertid");
+		zbx_db_insert_execute(&batch->db_insert_alerts);
+		zbx_db_insert_clean(&batch->db_insert_alerts);
+		batch->alerts_num = 0;
+	}
+
+	if (0 != batch->err_alerts_num)
+	{
+		zbx_db_insert_autoincrement(&batch->db_insert_err_alerts, "alertid");
+		zbx_db_insert_execute(&batch->db_insert_err_alerts);
+		zbx_db_insert_clean(&batch->db_insert_err_alerts);
+		batch->err_alerts_num = 0;
+	}
+
+	zbx_vector_escalation_alert_ptr_clear_ext(&batch->step_alerts, escalation_alert_free);
+
+	return alerts_num;
+}
+
 static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalation_ptr_t *escalations,
 		zbx_vector_uint64_t *eventids, zbx_vector_uint64_t *problem_eventids, zbx_vector_uint64_t *actionids,
 		const char *default_timezone, int config_timeout, int config_trapper_timeout,
@@ -3116,9 +3774,10 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 	zbx_vector_service_alarm_t		service_alarms;
 	zbx_service_alarm_t			*service_alarm, service_alarm_local;
 	zbx_vector_db_service_t			services;
-	zbx_hashset_t				service_roles;
+	zbx_escalation_batch_t			batch;
 	zbx_db_service				service_local;
 	zbx_dc_um_handle_t			*um_handle;
+	int					alerts_num = 0;
 
 	zbx_vector_uint64_create(&escalationids);
 	zbx_vector_uint64_create(&symptom_eventids);
@@ -3129,9 +3788,7 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 	zbx_vector_service_alarm_create(&service_alarms);
 	zbx_vector_db_service_create(&services);
 
-	zbx_hashset_create_ext(&service_roles, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)service_role_clean,
-			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	escalation_batch_init(&batch);
 
 	add_ack_escalation_r_eventids(escalations, eventids, &event_pairs);
 
@@ -3140,6 +3797,10 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 	get_db_actions_info(actionids, &actions);
 	zbx_db_get_events_by_eventids(eventids, &events);
 
+	/* prefetch data used by escalation operations for the whole batch */
+	escalation_batch_load_operations(&batch, actionids);
+	escalation_batch_load_acknowledges(&batch, escalations);
+
 	zbx_db_select_symptom_eventids(problem_eventids, &symptom_eventids);
 	zbx_vector_uint64_sort(&symptom_eventids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
@@ -3266,7 +3927,7 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 		{
 			case ZBX_ESCALATION_CANCEL:
 				escalation_cancel(escalation, action, event, error, default_timezone, service,
-						&service_roles);
+						&batch);
 				zbx_free(error);
 				zbx_vector_uint64_append(&escalationids, escalation->escalationid);
 				continue;
@@ -3296,7 +3957,7 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 			/* service_alarm is either initialized when servicealarmid is set or */
 			/* the escalation is cancelled and this code will not be reached     */
 			escalation_update(escalation, action, event, service_alarm, service, default_timezone,
-					&service_roles, config_timeout, config_trapper_timeout, config_source_ip,
+					&batch, config_timeout, config_trapper_timeout, config_source_ip,
 					config_ssh_key_location, get_config_forks, config_enable_global_scripts, program_type);
 		}
 		else if (0 != escalation->acknowledgeid)
@@ -3320,7 +3981,7 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 
 			}
 
-			escalation_acknowledge(escalation, action, event, r_event, default_timezone, &service_roles,
+			escalation_acknowledge(escalation, action, event, r_event, default_timezone, &batch,
 					config_timeout, config_trapper_timeout, config_source_ip,
 					config_ssh_key_location, get_config_forks, config_enable_global_scripts, program_type);
 		}
@@ -3328,7 +3989,7 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 		{
 			if (0 == escalation->esc_step)
 			{
-				escalation_execute(escalation, action, event, service, default_timezone, &service_roles,
+				escalation_execute(escalation, action, event, service, default_timezone, &batch,
 						config_timeout, config_trapper_timeout, config_source_ip,
 						config_ssh_key_location, get_config_forks,
 						config_enable_global_scripts, program_type);
@@ -3336,7 +3997,7 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 			else
 			{
 				escalation_recover(escalation, action, event, r_event, service, default_timezone,
-						&service_roles, config_timeout, config_trapper_timeout,
+						&batch, config_timeout, config_trapper_timeout,
 						config_source_ip, config_ssh_key_location, get_config_forks,
 						config_enable_global_scripts, program_type);
 			}
@@ -3345,7 +4006,7 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 		{
 			if (ESCALATION_STATUS_ACTIVE == escalation->status)
 			{
-				escalation_execute(escalation, action, event, service, default_timezone, &service_roles,
+				escalation_execute(escalation, action, event, service, default_timezone, &batch,
 						config_timeout, config_trapper_timeout, config_source_ip,
 						config_ssh_key_location, get_config_forks,
 						config_enable_global_scripts, program_type);
@@ -3441,7 +4102,11 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 		zbx_db_execute_multiple_query("delete from escalations where", "escalationid", &escalationids);
 	}
 
-	zbx_db_commit();
+	/* 4. write message alerts generated by the batch */
+	alerts_num = escalation_batch_flush_alerts(&batch);
+
+	if (ZBX_DB_OK == zbx_db_commit() && 0 != alerts_num)
+		notify_alerter(ALERTER_NOTIFY);
 out:
 	zbx_dc_close_user_macros(um_handle);
 
@@ -3460,7 +4125,7 @@ out:
 	zbx_vector_db_service_clear_ext(&services, service_clean);
 	zbx_vector_db_service_destroy(&services);
 
-	zbx_hashset_destroy(&service_roles);
+	escalation_batch_clean(&batch);
 
 	ret = escalationids.values_num;	/* performance metric */
 
@@ -3476,6 +4141,48 @@ out:
 #undef ZBX_DIFF_ESCALATION_UPDATE_STATUS
 #undef ZBX_DIFF_ESCALATION_UPDATE
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds condition selecting escalations of the escalator process     *
+ *                                                                            *
+ * Parameters: filter         - [IN/OUT] SQL filter                           *
+ *             filter_alloc   - [IN/OUT]                                      *
+ *             filter_offset  - [IN/OUT]                                      *
+ *             field          - [IN] escalation partitioning field            *
+ *             process_num    - [IN] escalator process number                 *
+ *             escalators_num - [IN] number of escalator processes            *
+ *             shardids       - [IN] claimed shards (optional)                *
+ *                                                                            *
+ ******************************************************************************/
+static void	add_escalations_partition_filter(char **filter, size_t *filter_alloc, size_t *filter_offset,
+		const char *field, int process_num, int escalators_num, const zbx_vector_int32_t *shardids)
+{
+	if (NULL != shardids)
+	{
+		zbx_snprintf_alloc(filter, filter_alloc, filter_offset, " and " ZBX_SQL_MOD(%s, %d), field,
+				zbx_escalation_shards_num());
+
+		if (1 == shardids->values_num)
+		{
+			zbx_snprintf_alloc(filter, filter_alloc, filter_offset, "=%d", shardids->values[0]);
+			return;
+		}
+
+		for (int i = 0; i < shardids->values_num; i++)
+		{
+			zbx_snprintf_alloc(filter, filter_alloc, filter_offset, "%s%d", 0 == i ? " in (" : ",",
+					shardids->values[i]);
+		}
+
+		zbx_chrcpy_alloc(filter, filter_alloc, filter_offset, ')');
+	}
+	else if (1 < escalators_num)
+	{
+		zbx_snprintf_alloc(filter, filter_alloc, filter_offset, " and " ZBX_SQL_MOD(%s, %d) "=%d", field,
+				escalators_num, process_num - 1);
+	}
+}
+
 /********************************************************************************
  *                                                                              *
  * Purpose: Executes escalation steps and recovery operations;                  *
@@ -3495,6 +4202,7 @@ out:
  *             get_config_forks        - [IN]                                   *
  *             program_type            - [IN]                                   *
  *             escalationids           - [IN]                                   *
+ *             shardids                - [IN] shards to process (optional)      *
  *                                                                              *
  * Return value: count of deleted escalations                                   *
  *                                                                              *
@@ -3509,7 +4217,7 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 		const char *default_timezone, int process_num, int config_timeout, int config_trapper_timeout,
 		const char *config_source_ip, const char *config_ssh_key_location,
 		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type,
-		zbx_vector_uint64_t *escalationids)
+		zbx_vector_uint64_t *escalationids, const zbx_vector_int32_t *shardids)
 {
 	int				ret = 0;
 	zbx_db_result_t			result;
@@ -3546,54 +4254,36 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 		/* Note that each escalator always handles all escalations from the same triggers and items.          */
 		/* The rest of the escalations (e.g. not trigger or item based) are spread evenly between escalators. */
 		/*                                                                                                    */
+		/* With EscalatorShards set the same ids are taken modulo shard count instead and escalators process  */
+		/* the shards they have claimed, so escalations of a trigger or item are still handled by a single    */
+		/* escalator at a time.                                                                               */
+		/*                                                                                                    */
 		/* * by e.actionid, e.triggerid, e.itemid, e.escalationid                                             */
 		switch (escalation_source)
 		{
 			case ZBX_ESCALATION_SOURCE_TRIGGER:
 				zbx_strcpy_alloc(&filter, &filter_alloc, &filter_offset, "triggerid is not null");
-
-				if (1 < get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR))
-				{
-					zbx_snprintf_alloc(&filter, &filter_alloc, &filter_offset,
-							" and " ZBX_SQL_MOD(triggerid, %d) "=%d",
-							get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), process_num - 1);
-				}
-
+				add_escalations_partition_filter(&filter, &filter_alloc, &filter_offset, "triggerid",
+						process_num, get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), shardids);
 				break;
 			case ZBX_ESCALATION_SOURCE_ITEM:
 				zbx_strcpy_alloc(&filter, &filter_alloc, &filter_offset, "triggerid is null and"
 						" itemid is not null");
-
-				if (1 < get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR))
-				{
-					zbx_snprintf_alloc(&filter, &filter_alloc, &filter_offset,
-							" and " ZBX_SQL_MOD(itemid, %d) "=%d",
-							get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), process_num - 1);
-				}
+				add_escalations_partition_filter(&filter, &filter_alloc, &filter_offset, "itemid",
+						process_num, get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), shardids);
 				break;
 
 			case ZBX_ESCALATION_SOURCE_SERVICE:
 				zbx_strcpy_alloc(&filter, &filter_alloc, &filter_offset,
 						"triggerid is null and itemid is null and serviceid is not null");
-
-				if (1 < get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR))
-				{
-					zbx_snprintf_alloc(&filter, &filter_alloc, &filter_offset,
-							" and " ZBX_SQL_MOD(serviceid, %d) "=%d",
-							get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), process_num - 1);
-				}
-
+				add_escalations_partition_filter(&filter, &filter_alloc, &filter_offset, "serviceid",
+						process_num, get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), shardids);
 				break;
 			case ZBX_ESCALATION_SOURCE_DEFAULT:
 				zbx_strcpy_alloc(&filter, &filter_alloc, &filter_offset,
 						"triggerid is null and itemid is null and serviceid is null");
-				if (1 < get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR))
-				{
-					zbx_snprintf_alloc(&filter, &filter_alloc, &filter_offset,
-							" and " ZBX_SQL_MOD(escalationid, %d) "=%d",
-							get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), process_num - 1);
-				}
-
+				add_escalations_partition_filter(&filter, &filter_alloc, &filter_offset, "escalationid",
+						process_num, get_config_forks(ZBX_PROCESS_TYPE_ESCALATOR), shardids);
 				break;
 		}
 	}
@@ -3679,6 +4369,64 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 	return ret;	/* performance metric */
 }
 
+static int	escalation_source_queue(unsigned int escalation_source)
+{
+	switch (escalation_source)
+	{
+		case ZBX_ESCALATION_SOURCE_TRIGGER:
+			return 0;
+		case ZBX_ESCALATION_SOURCE_ITEM:
+			return 1;
+		case ZBX_ESCALATION_SOURCE_SERVICE:
+			return 2;
+		default:
+			return 3;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes escalations of the specified source either statically   *
+ *          assigned to escalator or from shards claimed from shared queue    *
+ *                                                                            *
+ * Return value: count of deleted escalations                                 *
+ *                                                                            *
+ * Comments: In shared queue mode the notified escalations are processed      *
+ *           together with other escalations of their shards.                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	process_source_escalations(int now, int *nextcheck, unsigned int escalation_source,
+		const char *default_timezone, int process_num, int config_timeout, int config_trapper_timeout,
+		const char *config_source_ip, const char *config_ssh_key_location,
+		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type,
+		zbx_vector_uint64_t *escalationids)
+{
+	int			ret = 0, queue;
+	zbx_vector_int32_t	shardids;
+
+	if (0 == zbx_escalation_shards_num())
+	{
+		return process_escalations(now, nextcheck, escalation_source, default_timezone, process_num,
+				config_timeout, config_trapper_timeout, config_source_ip, config_ssh_key_location,
+				get_config_forks, config_enable_global_scripts, program_type, escalationids, NULL);
+	}
+
+	queue = escalation_source_queue(escalation_source);
+	zbx_vector_int32_create(&shardids);
+
+	while (ZBX_IS_RUNNING() && 0 != zbx_escalation_shards_claim(queue, process_num, &shardids))
+	{
+		ret += process_escalations(now, nextcheck, escalation_source, default_timezone, process_num,
+				config_timeout, config_trapper_timeout, config_source_ip, config_ssh_key_location,
+				get_config_forks, config_enable_global_scripts, program_type, NULL, &shardids);
+		zbx_escalation_shards_release(queue, &shardids);
+	}
+
+	zbx_vector_int32_destroy(&shardids);
+
+	return ret;
+}
+
 static	void deserialize_escalationids(zbx_vector_uint64_t *escalationids, const unsigned char *data)
 {
 	zbx_uint64_t		escalationid;
@@ -3694,6 +4442,11 @@ static	void deserialize_escalationids(zbx_vector_uint64_t *escalationids, const
 	}
 }
 
+static double	escalations_per_sec(int escalations_count, double total_sec)
+{
+	return 0.0 < total_sec ? escalations_count / total_sec : 0.0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: periodically checks table escalations and generates alerts        *
@@ -3762,30 +4515,36 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 
 		if (0 != sleeptime)
 		{
-			zbx_setproctitle("%s #%d [processed %d escalations in " ZBX_FS_DBL
-					" sec, processing escalations]", get_process_type_string(process_type),
-					process_num, old_escalations_count, old_total_sec);
+			zbx_setproctitle("%s #%d [processed %d escalations in " ZBX_FS_DBL " sec (" ZBX_FS_DBL
+					" escalations/sec), processing escalations]",
+					get_process_type_string(process_type), process_num, old_escalations_count,
+					old_total_sec,
+					escalations_per_sec(old_escalations_count, old_total_sec));
 		}
 
 		zbx_config_get(&cfg, ZBX_CONFIG_FLAGS_DEFAULT_TIMEZONE);
 
 		nextcheck = time(NULL) + CONFIG_ESCALATOR_FREQUENCY;
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_TRIGGER,
+
+		if (0 != zbx_escalation_shards_num())
+			zbx_escalation_shards_queue(process_num, time(NULL), CONFIG_ESCALATOR_FREQUENCY);
+
+		escalations_count += process_source_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_TRIGGER,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
 				escalator_args_in->config_enable_global_scripts, info->program_type, &escalationids);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_ITEM,
+		escalations_count += process_source_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_ITEM,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
 				escalator_args_in->config_enable_global_scripts, info->program_type, NULL);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_SERVICE,
+		escalations_count += process_source_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_SERVICE,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
 				escalator_args_in->config_enable_global_scripts, info->program_type, NULL);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_DEFAULT,
+		escalations_count += process_source_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_DEFAULT,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
@@ -3807,15 +4566,18 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 		{
 			if (0 == sleeptime)
 			{
-				zbx_setproctitle("%s #%d [processed %d escalations in " ZBX_FS_DBL
-						" sec, processing escalations]", get_process_type_string(process_type),
-						process_num, escalations_count, total_sec);
+				zbx_setproctitle("%s #%d [processed %d escalations in " ZBX_FS_DBL " sec (" ZBX_FS_DBL
+						" escalations/sec), processing escalations]",
+						get_process_type_string(process_type), process_num, escalations_count,
+						total_sec, escalations_per_sec(escalations_count, total_sec));
 			}
 			else
 			{
-				zbx_setproctitle("%s #%d [processed %d escalations in " ZBX_FS_DBL " sec, idle %d sec]",
+				zbx_setproctitle("%s #%d [processed %d escalations in " ZBX_FS_DBL " sec (" ZBX_FS_DBL
+						" escalations/sec), idle %d sec]",
 						get_process_type_string(process_type), process_num, escalations_count,
-						total_sec, sleeptime);
+						total_sec,
+						escalations_per_sec(escalations_count, total_sec), sleeptime);
 
 				old_escalations_count = escalations_count;
 				old_total_sec = total_sec;
@@ -984,45 +984,122 @@ int	lld_validate_lldrule_override_no_discover(const zbx_vector_lld_override_ptr_
 	return ZBX_PROTOTYPE_NO_DISCOVER == override_default ? FAIL : SUCCEED;
 }
 
-static int	lld_rows_get(zbx_vector_lld_entry_ptr_t *lld_entries, zbx_lld_filter_t *filter,
-		zbx_vector_lld_row_ptr_t *lld_rows, const zbx_vector_lld_override_ptr_t *overrides, char **info)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: makes discovery row from entry if it passes the filter            *
+ *                                                                            *
+ * Parameters: filter    - [IN] discovery rule filter                         *
+ *             overrides - [IN] discovery rule overrides                      *
+ *             lld_entry - [IN] discovery entry                               *
+ *             info      - [OUT] warning description                          *
+ *                                                                            *
+ * Return value: the discovery row or NULL if the entry was filtered out      *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_lld_row_t	*lld_row_make(const zbx_lld_filter_t *filter, const zbx_vector_lld_override_ptr_t *overrides,
+		zbx_lld_entry_t *lld_entry, char **info)
 {
 	zbx_lld_row_t	*lld_row;
-	int		ret = FAIL;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	if (SUCCEED != filter_evaluate(filter, lld_entry, info))
+		return NULL;
 
-	for (int i = 0; i < lld_entries->values_num; i++)
+	lld_row = (zbx_lld_row_t *)zbx_malloc(NULL, sizeof(zbx_lld_row_t));
+
+	lld_row->data = lld_entry;
+	zbx_vector_lld_item_link_ptr_create(&lld_row->item_links);
+	zbx_vector_lld_override_ptr_create(&lld_row->overrides);
+
+#define OVERRIDE_STOP_TRUE	1
+
+	for (int j = 0; j < overrides->values_num; j++)
 	{
-		zbx_lld_entry_t	*lld_entry = (zbx_lld_entry_t *)lld_entries->values[i];
+		zbx_lld_override_t	*override = overrides->values[j];
 
-		if (SUCCEED != filter_evaluate(filter, lld_entry, info))
+		if (SUCCEED != filter_evaluate(&override->filter, lld_entry, info))
 			continue;
 
-		lld_row = (zbx_lld_row_t *)zbx_malloc(NULL, sizeof(zbx_lld_row_t));
-		zbx_vector_lld_row_ptr_append(lld_rows, lld_row);
+		zbx_vector_lld_override_ptr_append(&lld_row->overrides, override);
 
-		lld_row->data = lld_entry;
-		zbx_vector_lld_item_link_ptr_create(&lld_row->item_links);
-		zbx_vector_lld_override_ptr_create(&lld_row->overrides);
+		if (OVERRIDE_STOP_TRUE == override->stop)
+			break;
+	}
 
-#define OVERRIDE_STOP_TRUE	1
+#undef OVERRIDE_STOP_TRUE
 
-		for (int j = 0; j < overrides->values_num; j++)
-		{
-			zbx_lld_override_t	*override = overrides->values[j];
+	return lld_row;
+}
 
-			if (SUCCEED != filter_evaluate(&override->filter, lld_entry, info))
-				continue;
+typedef struct
+{
+	const zbx_vector_lld_entry_ptr_t	*lld_entries;
+	const zbx_lld_filter_t			*filter;
+	const zbx_vector_lld_override_ptr_t	*overrides;
 
-			zbx_vector_lld_override_ptr_append(&lld_row->overrides, override);
+	/* rows by entry index, NULL for filtered out entries */
+	zbx_lld_row_t				**rows;
 
-			if (OVERRIDE_STOP_TRUE == override->stop)
-				break;
-		}
+	/* warning descriptions by job index */
+	char					**infos;
+}
+zbx_lld_rows_job_t;
 
-#undef OVERRIDE_STOP_TRUE
+static void	lld_rows_job(void *data, int first, int last, int job)
+{
+	zbx_lld_rows_job_t	*rows_job = (zbx_lld_rows_job_t *)data;
+
+	for (int i = first; i < last; i++)
+	{
+		rows_job->rows[i] = lld_row_make(rows_job->filter, rows_job->overrides,
+				rows_job->lld_entries->values[i], &rows_job->infos[job]);
 	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: makes discovery rows from entries passing the filter              *
+ *                                                                            *
+ * Comments: Filters and overrides of large rules are evaluated in parallel   *
+ *           threads, rows and warnings are merged in the entry order.        *
+ *                                                                            *
+ ******************************************************************************/
+static int	lld_rows_get(zbx_vector_lld_entry_ptr_t *lld_entries, zbx_lld_filter_t *filter,
+		zbx_vector_lld_row_ptr_t *lld_rows, const zbx_vector_lld_override_ptr_t *overrides, char **info)
+{
+	zbx_lld_row_t		*lld_row;
+	int			ret = FAIL, jobs_num;
+	zbx_lld_rows_job_t	rows_job;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	jobs_num = lld_jobs_num(lld_entries->values_num * (overrides->values_num + 1));
+
+	rows_job.lld_entries = lld_entries;
+	rows_job.filter = filter;
+	rows_job.overrides = overrides;
+	rows_job.rows = (zbx_lld_row_t **)zbx_malloc(NULL, sizeof(zbx_lld_row_t *) *
+			(size_t)MAX(1, lld_entries->values_num));
+	rows_job.infos = (char **)zbx_calloc(NULL, (size_t)jobs_num, sizeof(char *));
+
+	lld_jobs_run(jobs_num, lld_entries->values_num, lld_rows_job, &rows_job);
+
+	for (int i = 0; i < lld_entries->values_num; i++)
+	{
+		if (NULL != rows_job.rows[i])
+			zbx_vector_lld_row_ptr_append(lld_rows, rows_job.rows[i]);
+	}
+
+	for (int i = 0; i < jobs_num; i++)
+	{
+		if (NULL != rows_job.infos[i])
+		{
+			*info = zbx_strdcat(*info, rows_job.infos[i]);
+			zbx_free(rows_job.infos[i]);
+		}
+	}
+
+	zbx_free(rows_job.infos);
+	zbx_free(rows_job.rows);
 
 	ret = SUCCEED;
 
@@ -1093,18 +1170,326 @@ static void	lld_lifetime_init(zbx_lld_lifetime_t *lifetime, const char *key, zbx
 	zbx_free(duration_res);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if discovery rule has host prototypes                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	lld_rule_has_host_prototypes(zbx_uint64_t lld_ruleid)
+{
+	zbx_db_result_t	result;
+	char		*sql;
+	int		ret;
+
+	sql = zbx_dsprintf(NULL, "select null from host_discovery where lldruleid=" ZBX_FS_UI64, lld_ruleid);
+	result = zbx_db_select_n(sql, 1);
+	zbx_free(sql);
+
+	ret = (NULL != zbx_db_fetch(result) ? SUCCEED : FAIL);
+	zbx_db_free_result(result);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: keeps only rows of the entries changed since the previous value   *
+ *                                                                            *
+ * Parameters: lld_rows - [IN/OUT] discovery rows                             *
+ *             added    - [IN] new or changed entries, sorted by address      *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_rows_filter_added(zbx_vector_lld_row_ptr_t *lld_rows, const zbx_vector_lld_entry_ptr_t *added)
+{
+	for (int i = lld_rows->values_num - 1; i >= 0; i--)
+	{
+		zbx_lld_entry_t	*entry = (zbx_lld_entry_t *)lld_rows->values[i]->data;
+
+		if (FAIL != zbx_vector_lld_entry_ptr_bsearch(added, entry, ZBX_DEFAULT_PTR_COMPARE_FUNC))
+			continue;
+
+		lld_row_free(lld_rows->values[i]);
+		zbx_vector_lld_row_ptr_remove(lld_rows, i);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends rows returned by query to configuration hash              *
+ *                                                                            *
+ * Parameters: state      - [IN/OUT] md5 state                                *
+ *             fields_num - [IN] number of selected fields                    *
+ *             sql        - [IN] query, must order rows                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_config_hash_append(md5_state_t *state, int fields_num, const char *sql)
+{
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		for (int i = 0; i < fields_num; i++)
+		{
+			/* fields are separated by terminating zero, NULL is hashed as a single marker byte */
+			if (SUCCEED == zbx_db_is_null(row[i]))
+				zbx_md5_append(state, (const md5_byte_t *)"\1", 1);
+			else
+				zbx_md5_append(state, (const md5_byte_t *)row[i], (int)strlen(row[i]) + 1);
+		}
+	}
+	zbx_db_free_result(result);
+
+	/* separate rows of different queries */
+	zbx_md5_append(state, (const md5_byte_t *)"\2", 1);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates hash of discovery rule configuration applied to the    *
+ *          discovered rows                                                   *
+ *                                                                            *
+ * Parameters: lld_ruleid - [IN] discovery rule                               *
+ *             hash       - [OUT] configuration hash                          *
+ *                                                                            *
+ * Comments: The hash covers filter, overrides, macro paths and exported      *
+ *           macros of the rule, item, trigger and graph prototypes and       *
+ *           filter, macro paths and overrides of discovery rule prototypes.  *
+ *           Host prototypes are not hashed because rules having them are     *
+ *           always processed fully.                                          *
+ *                                                                            *
+ ******************************************************************************/
+void	lld_rule_get_config_hash(zbx_uint64_t lld_ruleid, md5_byte_t *hash)
+{
+	md5_state_t	state;
+	char		*sql = NULL, *rules, *prototypes, *triggers, *graphs;
+	size_t		sql_alloc = 0, sql_offset;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64, __func__, lld_ruleid);
+
+	/* the rule and its discovery rule prototypes */
+	rules = zbx_dsprintf(NULL, "(select id.itemid from item_discovery id where id.lldruleid=" ZBX_FS_UI64
+			" union select " ZBX_FS_UI64 ")", lld_ruleid, lld_ruleid);
+	prototypes = zbx_dsprintf(NULL, "(select id.itemid from item_discovery id where id.lldruleid=" ZBX_FS_UI64
+			")", lld_ruleid);
+	triggers = zbx_dsprintf(NULL, "(select f.triggerid from functions f where f.itemid in %s)", prototypes);
+	graphs = zbx_dsprintf(NULL, "(select gi.graphid from graphs_items gi where gi.itemid in %s)", prototypes);
+
+	zbx_md5_init(&state);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select evaltype,formula,lifetime_type,lifetime,enabled_lifetime_type,enabled_lifetime"
+			" from items"
+			" where itemid=" ZBX_FS_UI64, lld_ruleid);
+	lld_config_hash_append(&state, 6, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select lld_macro,value"
+			" from lld_macro_export"
+			" where itemid=" ZBX_FS_UI64
+			" order by lld_macro", lld_ruleid);
+	lld_config_hash_append(&state, 2, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select item_conditionid,itemid,operator,macro,value"
+			" from item_condition"
+			" where itemid in %s"
+			" order by item_conditionid", rules);
+	lld_config_hash_append(&state, 5, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select lld_macro_pathid,itemid,lld_macro,path"
+			" from lld_macro_path"
+			" where itemid in %s"
+			" order by lld_macro_pathid", rules);
+	lld_config_hash_append(&state, 4, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select lld_overrideid,itemid,name,step,stop,evaltype,formula"
+			" from lld_override"
+			" where itemid in %s"
+			" order by lld_overrideid", rules);
+	lld_config_hash_append(&state, 7, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select c.lld_override_conditionid,c.lld_overrideid,c.operator,c.macro,c.value"
+			" from lld_override_condition c,lld_override o"
+			" where c.lld_overrideid=o.lld_overrideid"
+				" and o.itemid in %s"
+			" order by c.lld_override_conditionid", rules);
+	lld_config_hash_append(&state, 5, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select op.lld_override_operationid,op.lld_overrideid,op.operationobject,op.operator,op.value,"
+				"s.status,d.discover,p.delay,h.history,t.trends,os.severity,i.inventory_mode"
+			" from lld_override_operation op"
+			" join lld_override o"
+				" on op.lld_overrideid=o.lld_overrideid"
+			" left join lld_override_opstatus s"
+				" on op.lld_override_operationid=s.lld_override_operationid"
+			" left join lld_override_opdiscover d"
+				" on op.lld_override_operationid=d.lld_override_operationid"
+			" left join lld_override_opperiod p"
+				" on op.lld_override_operationid=p.lld_override_operationid"
+			" left join lld_override_ophistory h"
+				" on op.lld_override_operationid=h.lld_override_operationid"
+			" left join lld_override_optrends t"
+				" on op.lld_override_operationid=t.lld_override_operationid"
+			" left join lld_override_opseverity os"
+				" on op.lld_override_operationid=os.lld_override_operationid"
+			" left join lld_override_opinventory i"
+				" on op.lld_override_operationid=i.lld_override_operationid"
+			" where o.itemid in %s"
+			" order by op.lld_override_operationid", rules);
+	lld_config_hash_append(&state, 12, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select ot.lld_override_optagid,ot.lld_override_operationid,ot.tag,ot.value"
+			" from lld_override_optag ot,lld_override_operation op,lld_override o"
+			" where ot.lld_override_operationid=op.lld_override_operationid"
+				" and op.lld_overrideid=o.lld_overrideid"
+				" and o.itemid in %s"
+			" order by ot.lld_override_optagid", rules);
+	lld_config_hash_append(&state, 4, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select ot.lld_override_optemplateid,ot.lld_override_operationid,ot.templateid"
+			" from lld_override_optemplate ot,lld_override_operation op,lld_override o"
+			" where ot.lld_override_operationid=op.lld_override_operationid"
+				" and op.lld_overrideid=o.lld_overrideid"
+				" and o.itemid in %s"
+			" order by ot.lld_override_optemplateid", rules);
+	lld_config_hash_append(&state, 3, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select itemid,name,key_,type,value_type,delay,history,trends,status,trapper_hosts,units,"
+				"formula,logtimefmt,valuemapid,params,ipmi_sensor,snmp_oid,authtype,username,password,"
+				"publickey,privatekey,description,interfaceid,jmx_endpoint,master_itemid,timeout,url,"
+				"query_fields,posts,status_codes,follow_redirects,post_type,http_proxy,headers,"
+				"retrieve_mode,request_method,output_format,ssl_cert_file,ssl_key_file,"
+				"ssl_key_password,verify_peer,verify_host,allow_traps,discover,lifetime,lifetime_type,"
+				"enabled_lifetime,enabled_lifetime_type,evaltype,flags"
+			" from items"
+			" where itemid in %s"
+			" order by itemid", prototypes);
+	lld_config_hash_append(&state, 51, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select item_preprocid,itemid,step,type,params,error_handler,error_handler_params"
+			" from item_preproc"
+			" where itemid in %s"
+			" order by item_preprocid", prototypes);
+	lld_config_hash_append(&state, 7, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select item_parameterid,itemid,name,value"
+			" from item_parameter"
+			" where itemid in %s"
+			" order by item_parameterid", prototypes);
+	lld_config_hash_append(&state, 4, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select itemtagid,itemid,tag,value"
+			" from item_tag"
+			" where itemid in %s"
+			" order by itemtagid", prototypes);
+	lld_config_hash_append(&state, 4, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select triggerid,description,expression,status,type,priority,comments,url,url_name,"
+				"recovery_expression,recovery_mode,correlation_mode,correlation_tag,manual_close,"
+				"opdata,discover,event_name"
+			" from triggers"
+			" where triggerid in %s"
+			" order by triggerid", triggers);
+	lld_config_hash_append(&state, 17, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select functionid,triggerid,itemid,name,parameter"
+			" from functions"
+			" where triggerid in %s"
+			" order by functionid", triggers);
+	lld_config_hash_append(&state, 5, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select triggertagid,triggerid,tag,value"
+			" from trigger_tag"
+			" where triggerid in %s"
+			" order by triggertagid", triggers);
+	lld_config_hash_append(&state, 4, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select triggerdepid,triggerid_down,triggerid_up"
+			" from trigger_depends"
+			" where triggerid_down in %s"
+			" order by triggerdepid", triggers);
+	lld_config_hash_append(&state, 3, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select graphid,name,width,height,yaxismin,yaxismax,show_work_period,show_triggers,"
+				"graphtype,show_legend,show_3d,percent_left,percent_right,ymin_type,ymin_itemid,"
+				"ymax_type,ymax_itemid,discover"
+			" from graphs"
+			" where graphid in %s"
+			" order by graphid", graphs);
+	lld_config_hash_append(&state, 18, sql);
+
+	sql_offset = 0;
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select gitemid,graphid,itemid,drawtype,sortorder,color,yaxisside,calc_fnc,type"
+			" from graphs_items"
+			" where graphid in %s"
+			" order by gitemid", graphs);
+	lld_config_hash_append(&state, 9, sql);
+
+	zbx_md5_finish(&state, hash);
+
+	zbx_free(graphs);
+	zbx_free(triggers);
+	zbx_free(prototypes);
+	zbx_free(rules);
+	zbx_free(sql);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: adds or updates items, triggers and graphs for discovery item     *
  *                                                                            *
  * Parameters: item        - [IN] discovery rule                              *
  *             lld_entries - [IN] discovery entries (rows)                    *
+ *             delta       - [IN/OUT] Changes since the previous value of the *
+ *                               rule (optional). When set only the objects   *
+ *                               discovered from added or removed entries are *
+ *                               processed.                                   *
  *             error       - [OUT] Error or informational message. Will be    *
  *                               set to empty string on successful discovery  *
  *                               without additional information.              *
  *                                                                            *
  ******************************************************************************/
-int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *lld_entries, char **error)
+int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *lld_entries,
+		zbx_lld_delta_t *delta, char **error)
 {
 	zbx_db_result_t			result;
 	zbx_db_row_t			row;
@@ -1165,6 +1550,13 @@ int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *
 	if (SUCCEED != (ret = lld_overrides_load(&overrides, item, error)))
 		goto out;
 
+	/* host groups and permissions of discovered hosts depend on all rows */
+	if (NULL != delta && SUCCEED == lld_rule_has_host_prototypes(item->itemid))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "discovery rule has host prototypes, processing all rows");
+		delta = NULL;
+	}
+
 	lld_rule_get_exported_macros(item->itemid, &exported_macros);
 	for (int i = 0; i < lld_entries->values_num; i++)
 		lld_entries->values[i]->exported_macros = &exported_macros;
@@ -1175,14 +1567,33 @@ int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *
 		goto out;
 	}
 
+	if (NULL != delta)
+	{
+		char	*info_removed = NULL;
+
+		lld_rows_filter_added(&lld_rows, &delta->added);
+
+		for (int i = 0; i < delta->removed.values_num; i++)
+			delta->removed.values[i]->exported_macros = &exported_macros;
+
+		(void)lld_rows_get(&delta->removed, &filter, &delta->removed_rows, &overrides, &info_removed);
+		zbx_free(info_removed);
+
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() processing %d added and %d removed rows", __func__,
+				lld_rows.values_num, delta->removed_rows.values_num);
+	}
+
 	*error = zbx_strdup(*error, "");
 
+	if (NULL != delta && 0 == lld_rows.values_num && 0 == delta->removed_rows.values_num)
+		goto info;
+
 	now = time(NULL);
 
 	zbx_audit_init(cfg.auditlog_enabled, cfg.auditlog_mode, ZBX_AUDIT_LLD_CONTEXT);
 
 	if (SUCCEED != lld_update_items(hostid, item->itemid, &lld_rows, error, &lifetime, &enabled_lifetime, now,
-			ZBX_FLAG_DISCOVERY_NORMAL, NULL, NULL))
+			ZBX_FLAG_DISCOVERY_NORMAL, NULL, NULL, delta))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot update/add items because parent host was removed while"
 				" processing lld rule");
@@ -1192,7 +1603,7 @@ int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *
 	lld_item_links_sort(&lld_rows);
 
 	if (SUCCEED != lld_update_triggers(hostid, item->itemid, &lld_rows, error, &lifetime, &enabled_lifetime, now,
-			ZBX_FLAG_DISCOVERY_NORMAL, NULL))
+			ZBX_FLAG_DISCOVERY_NORMAL, NULL, delta))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot update/add triggers because parent host was removed while"
 				" processing lld rule");
@@ -1200,7 +1611,7 @@ int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *
 	}
 
 	if (SUCCEED != lld_update_graphs(hostid, item->itemid, &lld_rows, error, &lifetime, now,
-			ZBX_FLAG_DISCOVERY_NORMAL, NULL))
+			ZBX_FLAG_DISCOVERY_NORMAL, NULL, delta))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot update/add graphs because parent host was removed while"
 				" processing lld rule");
@@ -1210,6 +1621,7 @@ int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *
 	lld_update_hosts(item->itemid, &lld_rows, error, &lifetime, &enabled_lifetime, now, ZBX_FLAG_DISCOVERY_NORMAL,
 			NULL, NULL);
 
+info:
 	/* add informative warning to the error message about lack of data for macros used in filter */
 	if (NULL != info)
 		*error = zbx_strdcat(*error, info);
@@ -1224,6 +1636,12 @@ out:
 	for (int i = 0; i < lld_entries->values_num; i++)
 		lld_entries->values[i]->exported_macros = NULL;
 
+	if (NULL != delta)
+	{
+		for (int i = 0; i < delta->removed.values_num; i++)
+			delta->removed.values[i]->exported_macros = NULL;
+	}
+
 	for (int i = 0; i < exported_macros.values_num; i++)
 		lld_macro_clear(&exported_macros.values[i]);
 
@@ -19,6 +19,7 @@
 #include "zbxjson.h"
 #include "zbxcacheconfig.h"
 #include "zbxdbhigh.h"
+#include "zbxhash.h"
 
 typedef struct zbx_lld_item_full_s zbx_lld_item_full_t;
 typedef struct zbx_lld_dependency_s zbx_lld_dependency_t;
@@ -133,6 +134,37 @@ ZBX_PTR_VECTOR_DECL(lld_row_ptr, zbx_lld_row_t*)
 
 void	lld_row_free(zbx_lld_row_t *lld_row);
 
+/* changes of LLD rule value since its previous processing */
+typedef struct
+{
+	/* new or changed entries of the current value, sorted by address */
+	zbx_vector_lld_entry_ptr_t	added;
+
+	/* entries of the previous value missing from the current value */
+	zbx_vector_lld_entry_ptr_t	removed;
+
+	/* the time when removed entries were last discovered */
+	int				lastcheck;
+
+	/* rows of removed entries, used to find objects that were lost */
+	zbx_vector_lld_row_ptr_t	removed_rows;
+
+	/* sorted identifiers of the items that were discovered from removed rows */
+	zbx_vector_uint64_t		lost_itemids;
+}
+zbx_lld_delta_t;
+
+int	lld_delta_has_lost_item(const zbx_lld_delta_t *delta, zbx_uint64_t itemid);
+int	lld_delta_get_lastcheck(const zbx_lld_delta_t *delta, int lastcheck);
+int	lld_entries_get_delta(const zbx_hashset_t *entries, const zbx_hashset_t *entries_prev, zbx_lld_delta_t *delta);
+
+/* processes work items from first (inclusive) to last (exclusive) as a part of parallel job */
+typedef void	(*zbx_lld_job_func_t)(void *data, int first, int last, int job);
+
+void	lld_jobs_init(int threads_max);
+int	lld_jobs_num(int work_num);
+void	lld_jobs_run(int jobs_num, int items_num, zbx_lld_job_func_t func, void *data);
+
 typedef struct
 {
 	zbx_uint64_t	item_preprocid;
@@ -439,17 +471,17 @@ int	lld_validate_lldrule_override_no_discover(const zbx_vector_lld_override_ptr_
 
 int	lld_update_items(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, zbx_vector_lld_row_ptr_t *lld_rows, char **error,
 		const zbx_lld_lifetime_t *lifetime, const zbx_lld_lifetime_t *enabled_lifetime, int lastcheck,
-		int dflags, zbx_hashset_t *rule_index, const zbx_vector_uint64_t *ruleids);
+		int dflags, zbx_hashset_t *rule_index, const zbx_vector_uint64_t *ruleids, zbx_lld_delta_t *delta);
 
 void	lld_item_links_sort(zbx_vector_lld_row_ptr_t *lld_rows);
 
 int	lld_update_triggers(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, const zbx_vector_lld_row_ptr_t *lld_rows,
 		char **error, const zbx_lld_lifetime_t *lifetime, const zbx_lld_lifetime_t *enabled_lifetime,
-		int lastcheck, int dflags, const zbx_vector_uint64_t *ruleids);
+		int lastcheck, int dflags, const zbx_vector_uint64_t *ruleids, const zbx_lld_delta_t *delta);
 
 int	lld_update_graphs(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, const zbx_vector_lld_row_ptr_t *lld_rows,
 		char **error, const zbx_lld_lifetime_t *lifetime, int lastcheck, int dflags,
-		const zbx_vector_uint64_t *ruleids);
+		const zbx_vector_uint64_t *ruleids, const zbx_lld_delta_t *delta);
 
 void	lld_update_hosts(zbx_uint64_t lld_ruleid, const zbx_vector_lld_row_ptr_t *lld_rows, char **error,
 		const zbx_lld_lifetime_t *lifetime, const zbx_lld_lifetime_t *enabled_lifetime, int lastcheck,
@@ -468,7 +500,9 @@ typedef void	(*object_audit_entry_update_status_f)(int audit_context_mode, zbx_u
 		int status_old, int status_new);
 typedef unsigned char	(get_object_status_val)(int status);
 
-int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *lld_entries, char **error);
+int	lld_process_discovery_rule(zbx_dc_item_t *item, zbx_vector_lld_entry_ptr_t *lld_entries,
+		zbx_lld_delta_t *delta, char **error);
+void	lld_rule_get_config_hash(zbx_uint64_t lld_ruleid, md5_byte_t *hash);
 
 /* discovered resource tracking (*_discovery tables) */
 typedef struct
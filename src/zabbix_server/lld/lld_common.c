@@ -21,6 +21,9 @@
 #include "zbxalgo.h"
 #include "zbxstr.h"
 #include "zbxdbwrap.h"
+#include "zbxregexp.h"
+#include "zbxnix.h"
+#include "zbxthreads.h"
 
 ZBX_VECTOR_IMPL(lld_discovery_ptr, zbx_lld_discovery_t *)
 
@@ -235,6 +238,170 @@ void	lld_disable_lost_object(zbx_lld_discovery_t *discovery, unsigned char objec
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if item was discovered from an entry removed since the      *
+ *          previous processing of LLD rule                                   *
+ *                                                                            *
+ * Parameters: delta  - [IN] LLD value changes                                *
+ *             itemid - [IN]                                                  *
+ *                                                                            *
+ * Return value: SUCCEED - item was lost with removed entry                   *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	lld_delta_has_lost_item(const zbx_lld_delta_t *delta, zbx_uint64_t itemid)
+{
+	if (FAIL == zbx_vector_uint64_bsearch(&delta->lost_itemids, itemid, ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the time lost object was last discovered                      *
+ *                                                                            *
+ * Parameters: delta     - [IN] LLD value changes, NULL for full processing   *
+ *             lastcheck - [IN] object lastcheck stored in database           *
+ *                                                                            *
+ * Comments: Incremental processing does not update lastcheck of objects      *
+ *           discovered from unchanged entries, so the object of removed      *
+ *           entry was seen at least during the previous processing.          *
+ *                                                                            *
+ ******************************************************************************/
+int	lld_delta_get_lastcheck(const zbx_lld_delta_t *delta, int lastcheck)
+{
+	if (NULL == delta || lastcheck >= delta->lastcheck)
+		return lastcheck;
+
+	return delta->lastcheck;
+}
+
+/* the maximum number of threads processing one discovery rule */
+static int	lld_job_threads_max = 1;
+
+/* the minimum amount of work (rows multiplied by prototypes) worth a separate thread */
+#define LLD_JOB_WORK_MIN	1000
+
+typedef struct
+{
+	zbx_lld_job_func_t	func;
+	void			*data;
+	int			first;
+	int			last;
+	int			job;
+	int			started;
+	pthread_t		thread;
+}
+zbx_lld_job_t;
+
+static void	*lld_job_entry(void *args)
+{
+	zbx_lld_job_t	*job = (zbx_lld_job_t *)args;
+	int		err;
+
+	zbx_init_regexp_env();
+
+	if (0 != (err = zbx_init_thread_signal_handler()))
+		zabbix_log(LOG_LEVEL_WARNING, "cannot block signals: %s", zbx_strerror(err));
+
+	job->func(job->data, job->first, job->last, job->job);
+
+	zbx_deinit_regexp_env();
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: set the maximum number of threads processing one discovery rule   *
+ *                                                                            *
+ * Parameters: threads_max - [IN] the maximum number of threads               *
+ *                                                                            *
+ ******************************************************************************/
+void	lld_jobs_init(int threads_max)
+{
+	lld_job_threads_max = MAX(1, threads_max);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the number of parallel jobs for the specified amount of work  *
+ *                                                                            *
+ * Parameters: work_num - [IN] the number of rows multiplied by the number of *
+ *                             prototypes                                     *
+ *                                                                            *
+ ******************************************************************************/
+int	lld_jobs_num(int work_num)
+{
+	return MAX(1, MIN(lld_job_threads_max, work_num / LLD_JOB_WORK_MIN));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: process work items in parallel threads                            *
+ *                                                                            *
+ * Parameters: jobs_num  - [IN] the number of jobs                            *
+ *             items_num - [IN] the number of work items                      *
+ *             func      - [IN] the job function                              *
+ *             data      - [IN] the job data                                  *
+ *                                                                            *
+ * Comments: Work items are split into ranges of similar size, ordered by job *
+ *           index. The first job is processed by the calling thread, jobs    *
+ *           which cannot be started in a separate thread are processed after *
+ *           it. The function returns when all jobs are finished.             *
+ *                                                                            *
+ ******************************************************************************/
+void	lld_jobs_run(int jobs_num, int items_num, zbx_lld_job_func_t func, void *data)
+{
+	zbx_lld_job_t	*jobs;
+	pthread_attr_t	attr;
+	int		err;
+
+	jobs = (zbx_lld_job_t *)zbx_malloc(NULL, sizeof(zbx_lld_job_t) * (size_t)jobs_num);
+
+	for (int i = 0; i < jobs_num; i++)
+	{
+		jobs[i].func = func;
+		jobs[i].data = data;
+		jobs[i].first = (int)((zbx_uint64_t)items_num * (zbx_uint64_t)i / (zbx_uint64_t)jobs_num);
+		jobs[i].last = (int)((zbx_uint64_t)items_num * (zbx_uint64_t)(i + 1) / (zbx_uint64_t)jobs_num);
+		jobs[i].job = i;
+		jobs[i].started = FAIL;
+	}
+
+	if (1 < jobs_num)
+	{
+		zbx_pthread_init_attr(&attr);
+
+		for (int i = 1; i < jobs_num; i++)
+		{
+			if (0 != (err = pthread_create(&jobs[i].thread, &attr, lld_job_entry, (void *)&jobs[i])))
+			{
+				zabbix_log(LOG_LEVEL_WARNING, "cannot create thread: %s", zbx_strerror(err));
+				continue;
+			}
+
+			jobs[i].started = SUCCEED;
+		}
+
+		pthread_attr_destroy(&attr);
+	}
+
+	func(data, jobs[0].first, jobs[0].last, 0);
+
+	for (int i = 1; i < jobs_num; i++)
+	{
+		if (SUCCEED == jobs[i].started)
+			pthread_join(jobs[i].thread, NULL);
+		else
+			func(data, jobs[i].first, jobs[i].last, i);
+	}
+
+	zbx_free(jobs);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: lock objects with pending status updates in database and check    *
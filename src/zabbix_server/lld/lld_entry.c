@@ -266,6 +266,52 @@ int	lld_compare_entries(const zbx_hashset_t *entries1, const zbx_hashset_t *entr
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find entries added and removed since the previous LLD rule value  *
+ *                                                                            *
+ * Parameters: entries      - [IN] entries of the current value               *
+ *             entries_prev - [IN] entries of the previous value              *
+ *             delta        - [OUT] added and removed entries                 *
+ *                                                                            *
+ * Return value: SUCCEED - only the changed entries can be processed          *
+ *               FAIL    - most of the entries were changed, all entries must *
+ *                         be processed                                       *
+ *                                                                            *
+ * Comments: Changed entry is returned as removed old and added new entry.    *
+ *                                                                            *
+ ******************************************************************************/
+int	lld_entries_get_delta(const zbx_hashset_t *entries, const zbx_hashset_t *entries_prev, zbx_lld_delta_t *delta)
+{
+	zbx_hashset_const_iter_t	iter;
+	const zbx_lld_entry_t		*entry;
+	int				entries_num;
+
+	zbx_hashset_const_iter_reset(entries, &iter);
+	while (NULL != (entry = (const zbx_lld_entry_t *)zbx_hashset_const_iter_next(&iter)))
+	{
+		if (NULL == zbx_hashset_search(entries_prev, entry))
+			zbx_vector_lld_entry_ptr_append(&delta->added, (zbx_lld_entry_t *)entry);
+	}
+
+	zbx_hashset_const_iter_reset(entries_prev, &iter);
+	while (NULL != (entry = (const zbx_lld_entry_t *)zbx_hashset_const_iter_next(&iter)))
+	{
+		if (NULL == zbx_hashset_search(entries, entry))
+			zbx_vector_lld_entry_ptr_append(&delta->removed, (zbx_lld_entry_t *)entry);
+	}
+
+	entries_num = MAX(entries->num_data, entries_prev->num_data);
+
+	/* with most of the rows changed processing all rows costs the same */
+	if (entries_num < (delta->added.values_num + delta->removed.values_num) * 2)
+		return FAIL;
+
+	zbx_vector_lld_entry_ptr_sort(&delta->added, ZBX_DEFAULT_PTR_COMPARE_FUNC);
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: print entry contents as comma delimited macro:value string        *
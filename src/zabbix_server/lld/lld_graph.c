@@ -1591,12 +1591,29 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if graph uses items discovered from removed LLD rows        *
+ *                                                                            *
+ ******************************************************************************/
+static int	lld_graph_has_lost_item(const zbx_lld_graph_t *graph, const zbx_lld_delta_t *delta)
+{
+	for (int i = 0; i < graph->gitems.values_num; i++)
+	{
+		if (SUCCEED == lld_delta_has_lost_item(delta, graph->gitems.values[i]->itemid))
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: process lost graph resources                                      *
  *                                                                            *
  ******************************************************************************/
-static void	lld_process_lost_graphs(zbx_vector_lld_graph_ptr_t *graphs, const zbx_lld_lifetime_t *lifetime, int now)
+static void	lld_process_lost_graphs(zbx_vector_lld_graph_ptr_t *graphs, const zbx_lld_lifetime_t *lifetime, int now,
+		const zbx_lld_delta_t *delta)
 {
 	zbx_hashset_t	discoveries;
 
@@ -1608,6 +1625,13 @@ static void	lld_process_lost_graphs(zbx_vector_lld_graph_ptr_t *graphs, const zb
 		zbx_lld_graph_t	*graph = graphs->values[i];
 		zbx_lld_discovery_t	*discovery;
 
+		/* graphs of unchanged rows are left as they are during incremental processing */
+		if (NULL != delta && 0 == (graph->flags & ZBX_FLAG_LLD_GRAPH_DISCOVERED) &&
+				SUCCEED != lld_graph_has_lost_item(graph, delta))
+		{
+			continue;
+		}
+
 		discovery = lld_add_discovery(&discoveries, graph->graphid, graph->name);
 
 		if (0 != (graph->flags & ZBX_FLAG_LLD_GRAPH_DISCOVERED))
@@ -1619,7 +1643,8 @@ static void	lld_process_lost_graphs(zbx_vector_lld_graph_ptr_t *graphs, const zb
 
 		/* process lost graphs */
 
-		lld_process_lost_object(discovery, ZBX_LLD_OBJECT_STATUS_ENABLED, graph->lastcheck, now, lifetime,
+		lld_process_lost_object(discovery, ZBX_LLD_OBJECT_STATUS_ENABLED,
+				lld_delta_get_lastcheck(delta, graph->lastcheck), now, lifetime,
 				graph->discovery_status, 0, graph->ts_delete);
 	}
 
@@ -1640,7 +1665,7 @@ static void	lld_process_lost_graphs(zbx_vector_lld_graph_ptr_t *graphs, const zb
  ******************************************************************************/
 int	lld_update_graphs(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, const zbx_vector_lld_row_ptr_t *lld_rows,
 		char **error, const zbx_lld_lifetime_t *lifetime, int lastcheck, int dflags,
-		const zbx_vector_uint64_t *ruleids)
+		const zbx_vector_uint64_t *ruleids, const zbx_lld_delta_t *delta)
 {
 	int				ret = SUCCEED;
 	zbx_db_result_t			result;
@@ -1714,7 +1739,7 @@ int	lld_update_graphs(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, const zbx_ve
 				percent_right, ymin_type, ymax_type, discover_proto,
 				dflags | ZBX_FLAG_DISCOVERY_CREATED);
 
-		lld_process_lost_graphs(&graphs, lifetime, lastcheck);
+		lld_process_lost_graphs(&graphs, lifetime, lastcheck, delta);
 
 		lld_items_free(&items);
 		lld_gitems_free(&gitems_proto);
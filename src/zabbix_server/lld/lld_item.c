@@ -2349,6 +2349,113 @@ static void	lld_item_update(const zbx_lld_item_prototype_t *item_prototype, cons
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds existing item discovered by prototype from LLD row          *
+ *                                                                            *
+ * Parameters: item_prototype - [IN] item prototype with index of its items   *
+ *             lld_row        - [IN] LLD data row                             *
+ *             item_stub      - [IN/OUT] item used for index lookup           *
+ *                                                                            *
+ * Return value: the item index reference or NULL if item was not found       *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_lld_item_ref_t	*lld_item_index_find(zbx_lld_item_prototype_t *item_prototype,
+		const zbx_lld_row_t *lld_row, zbx_lld_item_full_t *item_stub)
+{
+	zbx_lld_item_ref_t	*ref, ref_local = {.item = item_stub};
+
+	for (int k = 0; k < item_prototype->keys.values_num; k++)
+	{
+		item_stub->key_ = zbx_strdup(item_stub->key_, item_prototype->keys.values[k]);
+
+		if (SUCCEED != zbx_substitute_item_key_params(&item_stub->key_, NULL, 0, lld_substitute_key_cb,
+				lld_row->data))
+		{
+			continue;
+		}
+
+		if (NULL == (ref = (zbx_lld_item_ref_t *)zbx_hashset_search(&item_prototype->item_index, &ref_local)))
+			continue;
+
+		if (0 == (item_prototype->item_flags & ZBX_FLAG_DISCOVERY_PROTOTYPE))
+		{
+			if (0 == (item_prototype->item_flags & ZBX_FLAG_DISCOVERY_RULE))
+			{
+				if (SUCCEED != lld_validate_item_override_no_discover(&lld_row->overrides,
+						ref->item->name, item_prototype->discover))
+				{
+					continue;
+				}
+			}
+			else
+			{
+				if (SUCCEED != lld_validate_lldrule_override_no_discover(&lld_row->overrides,
+						ref->item->name, item_prototype->discover))
+				{
+					continue;
+				}
+			}
+		}
+
+		return ref;
+	}
+
+	return NULL;
+}
+
+typedef struct
+{
+	const zbx_vector_lld_item_prototype_ptr_t	*item_prototypes;
+	const zbx_vector_lld_row_ptr_t			*lld_rows;
+	zbx_hashset_t					*items_index;
+	int						lastcheck;
+
+	/* created items by prototype and row index, NULL for updated items */
+	zbx_lld_item_full_t				**items;
+
+	/* error messages by job index */
+	char						**errors;
+}
+zbx_lld_items_job_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates existing or makes new items for a range of prototype and  *
+ *          row pairs                                                         *
+ *                                                                            *
+ * Comments: The items index is not changed while jobs are running, created   *
+ *           items are indexed after all jobs are finished.                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_items_job(void *data, int first, int last, int job)
+{
+	zbx_lld_items_job_t	*items_job = (zbx_lld_items_job_t *)data;
+	zbx_lld_item_index_t	*item_index, item_index_local;
+	int			rows_num = items_job->lld_rows->values_num;
+
+	for (int i = first; i < last; i++)
+	{
+		const zbx_lld_item_prototype_t	*item_prototype = items_job->item_prototypes->values[i / rows_num];
+
+		item_index_local.parent_itemid = item_prototype->itemid;
+		item_index_local.lld_row = items_job->lld_rows->values[i % rows_num];
+
+		if (NULL == (item_index = (zbx_lld_item_index_t *)zbx_hashset_search(items_job->items_index,
+				&item_index_local)))
+		{
+			items_job->items[i] = lld_item_make(item_prototype, item_index_local.lld_row,
+					items_job->lastcheck, &items_job->errors[job]);
+		}
+		else
+		{
+			items_job->items[i] = NULL;
+			lld_item_update(item_prototype, item_index_local.lld_row, item_index->item,
+					&items_job->errors[job]);
+		}
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Updates existing items and creates new ones based on item,        *
@@ -2360,18 +2467,22 @@ static void	lld_item_update(const zbx_lld_item_prototype_t *item_prototype, cons
  *             items_index     - [OUT] Index of items based on prototype ids  *
  *                                     and LLD rows. Used to quickly find an  *
  *                                     item by prototype and lld_row.         *
+ *             delta           - [IN/OUT] LLD value changes, the items        *
+ *                                        discovered from removed rows are    *
+ *                                        added to lost items (optional)      *
  *             error           - [OUT] error message                          *
  *                                                                            *
  ******************************************************************************/
 static void	lld_items_make(const zbx_vector_lld_item_prototype_ptr_t *item_prototypes,
 		zbx_vector_lld_row_ptr_t *lld_rows, zbx_vector_lld_item_full_ptr_t *items, zbx_hashset_t *items_index,
-		int lastcheck, char **error)
+		int lastcheck, zbx_lld_delta_t *delta, char **error)
 {
-	int				index;
+	int				index, items_num, jobs_num;
 	zbx_lld_item_prototype_t	*item_prototype;
 	zbx_lld_item_full_t		*item;
 	zbx_lld_row_t			*lld_row;
-	zbx_lld_item_index_t		*item_index, item_index_local;
+	zbx_lld_item_index_t		item_index_local;
+	zbx_lld_items_job_t		items_job;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -2416,7 +2527,7 @@ static void	lld_items_make(const zbx_vector_lld_item_prototype_ptr_t *item_proto
 	for (int i = 0; i < item_prototypes->values_num; i++)
 	{
 		zbx_lld_item_full_t	item_stub = {0};
-		zbx_lld_item_ref_t	*ref, ref_local = {.item = &item_stub};
+		zbx_lld_item_ref_t	*ref;
 
 		item_prototype = item_prototypes->values[i];
 
@@ -2424,53 +2535,31 @@ static void	lld_items_make(const zbx_vector_lld_item_prototype_ptr_t *item_proto
 		{
 			lld_row = item_prototype->lld_rows.values[j];
 
-			for (int k = 0; k < item_prototype->keys.values_num; k++)
-			{
-				item_stub.key_ = zbx_strdup(item_stub.key_, item_prototype->keys.values[k]);
+			if (NULL == (ref = lld_item_index_find(item_prototype, lld_row, &item_stub)))
+				continue;
 
-				if (SUCCEED != zbx_substitute_item_key_params(&item_stub.key_, NULL, 0,
-						lld_substitute_key_cb, lld_row->data))
-				{
-					continue;
-				}
+			item_index_local.parent_itemid = ref->item->parent_itemid;
+			item_index_local.lld_row = lld_row;
+			item_index_local.item = ref->item;
+			zbx_hashset_insert(items_index, &item_index_local, sizeof(item_index_local));
 
-				if (NULL == (ref = (zbx_lld_item_ref_t *)zbx_hashset_search(&item_prototype->item_index,
-						&ref_local)))
-				{
-					continue;
-				}
+			zbx_vector_lld_row_ptr_remove_noorder(&item_prototype->lld_rows, j);
+			zbx_hashset_remove_direct(&item_prototype->item_index, ref);
+		}
 
-				if (0 == (item_prototype->item_flags & ZBX_FLAG_DISCOVERY_PROTOTYPE))
+		/* items left unmatched by current rows are lost only if they belong to removed rows */
+		if (NULL != delta)
+		{
+			for (int j = 0; j < delta->removed_rows.values_num; j++)
+			{
+				if (NULL == (ref = lld_item_index_find(item_prototype, delta->removed_rows.values[j],
+						&item_stub)))
 				{
-					if (0 == (item_prototype->item_flags & ZBX_FLAG_DISCOVERY_RULE))
-					{
-						if (SUCCEED != lld_validate_item_override_no_discover(
-								&lld_row->overrides, ref->item->name,
-								item_prototype->discover))
-						{
-							continue;
-						}
-					}
-					else
-					{
-						if (SUCCEED != lld_validate_lldrule_override_no_discover(
-								&lld_row->overrides, ref->item->name,
-								item_prototype->discover))
-						{
-							continue;
-						}
-					}
+					continue;
 				}
 
-				item_index_local.parent_itemid = ref->item->parent_itemid;
-				item_index_local.lld_row = lld_row;
-				item_index_local.item = ref->item;
-				zbx_hashset_insert(items_index, &item_index_local, sizeof(item_index_local));
-
-				zbx_vector_lld_row_ptr_remove_noorder(&item_prototype->lld_rows, j);
+				zbx_vector_uint64_append(&delta->lost_itemids, ref->item->itemid);
 				zbx_hashset_remove_direct(&item_prototype->item_index, ref);
-
-				break;
 			}
 		}
 
@@ -2478,30 +2567,44 @@ static void	lld_items_make(const zbx_vector_lld_item_prototype_ptr_t *item_proto
 	}
 
 	/* update/create discovered items */
-	for (int i = 0; i < item_prototypes->values_num; i++)
-	{
-		item_prototype = item_prototypes->values[i];
-		item_index_local.parent_itemid = item_prototype->itemid;
+	items_num = item_prototypes->values_num * lld_rows->values_num;
+	jobs_num = lld_jobs_num(items_num);
 
-		for (int j = 0; j < lld_rows->values_num; j++)
-		{
-			item_index_local.lld_row = lld_rows->values[j];
+	items_job.item_prototypes = item_prototypes;
+	items_job.lld_rows = lld_rows;
+	items_job.items_index = items_index;
+	items_job.lastcheck = lastcheck;
+	items_job.items = (zbx_lld_item_full_t **)zbx_malloc(NULL, sizeof(zbx_lld_item_full_t *) *
+			(size_t)MAX(1, items_num));
+	items_job.errors = (char **)zbx_calloc(NULL, (size_t)jobs_num, sizeof(char *));
 
-			if (NULL == (item_index = (zbx_lld_item_index_t *)zbx_hashset_search(items_index,
-					&item_index_local)))
-			{
-				item = lld_item_make(item_prototype, item_index_local.lld_row, lastcheck, error);
+	lld_jobs_run(jobs_num, items_num, lld_items_job, &items_job);
 
-				/* add the created item to items vector and update index */
-				zbx_vector_lld_item_full_ptr_append(items, item);
-				item_index_local.item = item;
-				zbx_hashset_insert(items_index, &item_index_local, sizeof(item_index_local));
-			}
-			else
-				lld_item_update(item_prototype, item_index_local.lld_row, item_index->item, error);
+	for (int i = 0; i < items_num; i++)
+	{
+		if (NULL == (item = items_job.items[i]))
+			continue;
+
+		/* add the created item to items vector and update index */
+		zbx_vector_lld_item_full_ptr_append(items, item);
+		item_index_local.parent_itemid = item->parent_itemid;
+		item_index_local.lld_row = lld_rows->values[i % lld_rows->values_num];
+		item_index_local.item = item;
+		zbx_hashset_insert(items_index, &item_index_local, sizeof(item_index_local));
+	}
+
+	for (int i = 0; i < jobs_num; i++)
+	{
+		if (NULL != items_job.errors[i])
+		{
+			*error = zbx_strdcat(*error, items_job.errors[i]);
+			zbx_free(items_job.errors[i]);
 		}
 	}
 
+	zbx_free(items_job.errors);
+	zbx_free(items_job.items);
+
 	zbx_vector_lld_item_full_ptr_sort(items, lld_item_full_compare_func);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%d items", __func__, items->values_num);
@@ -4557,7 +4660,7 @@ static void	lld_link_dependent_items(zbx_vector_lld_item_full_ptr_t *items, zbx_
  *                                                                            *
  ******************************************************************************/
 static void	lld_process_lost_items(zbx_vector_lld_item_full_ptr_t *items, const zbx_lld_lifetime_t *lifetime,
-		const zbx_lld_lifetime_t *enabled_lifetime, int now)
+		const zbx_lld_lifetime_t *enabled_lifetime, int now, const zbx_lld_delta_t *delta)
 {
 	zbx_hashset_t	discoveries;
 
@@ -4571,6 +4674,14 @@ static void	lld_process_lost_items(zbx_vector_lld_item_full_ptr_t *items, const
 		zbx_lld_item_full_t	*item = items->values[i];
 		zbx_lld_discovery_t	*discovery;
 		unsigned char		object_status;
+		int			lastcheck;
+
+		/* items of unchanged rows are left as they are during incremental processing */
+		if (NULL != delta && 0 == (item->flags & ZBX_FLAG_LLD_ITEM_DISCOVERED) &&
+				SUCCEED != lld_delta_has_lost_item(delta, item->itemid))
+		{
+			continue;
+		}
 
 		object_status = (ITEM_STATUS_DISABLED == item->status ? ZBX_LLD_OBJECT_STATUS_DISABLED :
 				ZBX_LLD_OBJECT_STATUS_ENABLED);
@@ -4586,11 +4697,12 @@ static void	lld_process_lost_items(zbx_vector_lld_item_full_ptr_t *items, const
 
 		/* process lost items */
 
-		lld_process_lost_object(discovery, object_status, item->lastcheck, now, lifetime,
-				item->discovery_status, item->disable_source, item->ts_delete);
+		lastcheck = lld_delta_get_lastcheck(delta, item->lastcheck);
+
+		lld_process_lost_object(discovery, object_status, lastcheck, now, lifetime, item->discovery_status,
+				item->disable_source, item->ts_delete);
 
-		lld_disable_lost_object(discovery, object_status, item->lastcheck, now, enabled_lifetime,
-				item->ts_disable);
+		lld_disable_lost_object(discovery, object_status, lastcheck, now, enabled_lifetime, item->ts_disable);
 	}
 
 	lld_flush_discoveries(&discoveries, "itemid", "items", "item_discovery", now, get_item_status_value,
@@ -4769,7 +4881,7 @@ static void	lld_item_prototype_dump(zbx_lld_item_prototype_t *item_prototype)
  ******************************************************************************/
 int	lld_update_items(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, zbx_vector_lld_row_ptr_t *lld_rows, char **error,
 		const zbx_lld_lifetime_t *lifetime, const zbx_lld_lifetime_t *enabled_lifetime, int lastcheck,
-		int dflags, zbx_hashset_t *rule_index, const zbx_vector_uint64_t *ruleids)
+		int dflags, zbx_hashset_t *rule_index, const zbx_vector_uint64_t *ruleids, zbx_lld_delta_t *delta)
 {
 	zbx_vector_lld_item_prototype_ptr_t	item_prototypes;
 	zbx_hashset_t				items_index;
@@ -4798,7 +4910,10 @@ int	lld_update_items(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, zbx_vector_ll
 	lld_items_get(&item_prototypes, ruleids, &items);
 	zbx_db_commit();
 
-	lld_items_make(&item_prototypes, lld_rows, &items, &items_index, lastcheck, error);
+	lld_items_make(&item_prototypes, lld_rows, &items, &items_index, lastcheck, delta, error);
+
+	if (NULL != delta)
+		zbx_vector_uint64_sort(&delta->lost_itemids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	lld_items_preproc_make(&item_prototypes, &items);
 	lld_items_param_make(&item_prototypes, &items, error);
@@ -4835,7 +4950,7 @@ int	lld_update_items(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, zbx_vector_ll
 	}
 
 	lld_item_links_populate(&item_prototypes, lld_rows, &items_index);
-	lld_process_lost_items(&items, lifetime, enabled_lifetime, lastcheck);
+	lld_process_lost_items(&items, lifetime, enabled_lifetime, lastcheck, delta);
 
 	lld_rule_discover_prototypes(hostid, lld_rows, &item_prototypes, &items, error, lastcheck, &items_index);
 clean:
@@ -26,6 +26,7 @@
 #include "zbxtime.h"
 #include "zbx_rtc_constants.h"
 #include "zbxrtc.h"
+#include "zbxcacheconfig.h"
 
 /*
  * The LLD queue is organized as a queue (rule_queue binary heap) of LLD rules,
@@ -46,9 +47,25 @@ typedef struct
 {
 	zbx_ipc_client_t	*client;
 	zbx_lld_rule_t		*rule;
+
+	/* the time when the worker started processing the rule */
+	double			time_start;
 }
 zbx_lld_worker_t;
 
+/* processing statistics of LLD rule */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+
+	/* revision of the last rule processing, used by workers to validate cached rule values */
+	zbx_uint64_t	revision;
+
+	/* the duration of the last rule processing in milliseconds */
+	int		time_ms;
+}
+zbx_lld_rule_stats_t;
+
 ZBX_PTR_VECTOR_DECL(lld_worker_ptr, zbx_lld_worker_t*)
 ZBX_PTR_VECTOR_IMPL(lld_worker_ptr, zbx_lld_worker_t*)
 
@@ -75,6 +92,11 @@ typedef struct
 	/* the number of queued LLD rules */
 	zbx_uint64_t			queued_num;
 
+	/* processing statistics of LLD rules */
+	zbx_hashset_t			rule_stats;
+
+	/* the last assigned rule processing revision */
+	zbx_uint64_t			revision;
 }
 zbx_lld_manager_t;
 
@@ -147,6 +169,9 @@ static void	lld_manager_init(zbx_lld_manager_t *manager, zbx_get_config_forks_f
 
 	zbx_binary_heap_create(&manager->rule_queue, rule_elem_compare_func, ZBX_BINARY_HEAP_OPTION_EMPTY);
 
+	zbx_hashset_create(&manager->rule_stats, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	manager->revision = 0;
+
 	manager->next_worker_index = 0;
 
 	for (int i = 0; i < get_config_forks_cb(ZBX_PROCESS_TYPE_LLDWORKER); i++)
@@ -329,18 +354,65 @@ static void	lld_process_next_request(zbx_lld_manager_t *manager, zbx_lld_worker_
 	unsigned char		*buf;
 	zbx_uint32_t		buf_len;
 	zbx_lld_data_t		*data;
+	zbx_lld_rule_stats_t	*rule_stats, rule_stats_local;
+	zbx_uint64_t		revision_prev;
 
 	elem = zbx_binary_heap_find_min(&manager->rule_queue);
 	worker->rule = elem->data;
 	zbx_binary_heap_remove_min(&manager->rule_queue);
 
 	data = worker->rule->head;
-	buf_len = zbx_lld_serialize_item_value(&buf, data->itemid, 0, data->value, &data->ts, data->meta,
-			data->lastlogsize, data->mtime, data->error);
+
+	/* the worker can process only changed rows if it has the value of the previous rule processing */
+	rule_stats_local.itemid = data->itemid;
+	rule_stats_local.revision = 0;
+	rule_stats_local.time_ms = 0;
+
+	rule_stats = (zbx_lld_rule_stats_t *)zbx_hashset_insert(&manager->rule_stats, &rule_stats_local,
+			sizeof(rule_stats_local));
+
+	revision_prev = rule_stats->revision;
+	rule_stats->revision = ++manager->revision;
+
+	worker->time_start = zbx_time();
+
+	buf_len = zbx_lld_serialize_prepare_value(&buf, revision_prev, rule_stats->revision, data->itemid,
+			data->value, &data->ts, data->meta, data->lastlogsize, data->mtime, data->error);
 	zbx_ipc_client_send(worker->client, ZBX_IPC_LLD_PREPARE_VALUE, buf, buf_len);
 	zbx_free(buf);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes processing statistics of deleted LLD rules                *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_rule_stats_cleanup(zbx_lld_manager_t *manager)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_lld_rule_stats_t	*rule_stats;
+	zbx_vector_uint64_t	itemids;
+
+	zbx_vector_uint64_create(&itemids);
+
+	zbx_hashset_iter_reset(&manager->rule_stats, &iter);
+	while (NULL != (rule_stats = (zbx_lld_rule_stats_t *)zbx_hashset_iter_next(&iter)))
+		zbx_vector_uint64_append(&itemids, rule_stats->itemid);
+
+	if (0 != itemids.values_num)
+	{
+		zbx_dc_config_history_sync_unset_existing_itemids(&itemids);
+
+		for (int i = 0; i < itemids.values_num; i++)
+			zbx_hashset_remove(&manager->rule_stats, &itemids.values[i]);
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() removed:%d remaining:%d", __func__, itemids.values_num,
+			manager->rule_stats.num_data);
+
+	zbx_vector_uint64_destroy(&itemids);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sends queued LLD rules to free workers                            *
@@ -372,12 +444,23 @@ static void	lld_process_result(zbx_lld_manager_t *manager, zbx_ipc_client_t *cli
 	zbx_lld_worker_t	*worker;
 	zbx_lld_rule_t		*rule;
 	zbx_lld_data_t		*data;
+	zbx_lld_rule_stats_t	*rule_stats;
+	double			time_ms;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	worker = lld_get_worker_by_client(manager, client);
 
-	zabbix_log(LOG_LEVEL_DEBUG, "discovery rule:" ZBX_FS_UI64 " has been processed", worker->rule->head->itemid);
+	time_ms = (zbx_time() - worker->time_start) * 1000;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "discovery rule:" ZBX_FS_UI64 " has been processed in " ZBX_FS_DBL " ms",
+			worker->rule->head->itemid, time_ms);
+
+	if (NULL != (rule_stats = (zbx_lld_rule_stats_t *)zbx_hashset_search(&manager->rule_stats,
+			&worker->rule->head->itemid)))
+	{
+		rule_stats->time_ms = (int)time_ms;
+	}
 
 	rule = worker->rule;
 	worker->rule = NULL;
@@ -523,6 +606,20 @@ static int	lld_diag_item_compare_values_desc(const void *d1, const void *d2)
 	return r2->values_num - r1->values_num;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: Sorts LLD manager cache item view by the duration of the last     *
+ *          processing in descending order.                                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	lld_diag_item_compare_time_desc(const void *d1, const void *d2)
+{
+	zbx_lld_rule_info_t	*r1 = *(zbx_lld_rule_info_t **)d1;
+	zbx_lld_rule_info_t	*r2 = *(zbx_lld_rule_info_t **)d2;
+
+	return r2->time_ms - r1->time_ms;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: processes external top items request                              *
@@ -531,6 +628,9 @@ static int	lld_diag_item_compare_values_desc(const void *d1, const void *d2)
  *             client  - [IN] connected worker IPC client data                *
  *             message - [IN] received message                                *
  *                                                                            *
+ * Comments: Items are sorted by the number of queued values or by the        *
+ *           duration of the last processing, depending on the request code.  *
+ *                                                                            *
  ******************************************************************************/
 static void	lld_process_top_items(zbx_lld_manager_t *manager, zbx_ipc_client_t *client,
 		const zbx_ipc_message_t *message)
@@ -551,33 +651,57 @@ static void	lld_process_top_items(zbx_lld_manager_t *manager, zbx_ipc_client_t *
 			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	zbx_vector_lld_rule_info_ptr_create(&view);
 
-	zbx_hashset_iter_reset(&manager->rule_index, &iter);
-
-	while (NULL != (rule = (zbx_lld_rule_t *)zbx_hashset_iter_next(&iter)))
+	if (ZBX_IPC_LLD_TOP_TIME_MS == message->code)
 	{
-		zbx_lld_data_t	*data_ptr;
+		zbx_lld_rule_stats_t	*rule_stats;
+
+		zbx_hashset_iter_reset(&manager->rule_stats, &iter);
 
-		for (data_ptr = rule->head; NULL != data_ptr; data_ptr = data_ptr->next)
+		while (NULL != (rule_stats = (zbx_lld_rule_stats_t *)zbx_hashset_iter_next(&iter)))
 		{
-			zbx_lld_rule_info_t	*rule_info, rule_info_local = {.itemid = data_ptr->itemid};
+			zbx_lld_rule_info_t	*rule_info, rule_info_local = {.itemid = rule_stats->itemid,
+							.time_ms = rule_stats->time_ms};
+
+			if (0 == rule_stats->time_ms)
+				continue;
+
+			rule_info = (zbx_lld_rule_info_t *)zbx_hashset_insert(&rule_infos, &rule_info_local,
+					sizeof(zbx_lld_rule_info_t));
+			zbx_vector_lld_rule_info_ptr_append(&view, rule_info);
+		}
+
+		zbx_vector_lld_rule_info_ptr_sort(&view, lld_diag_item_compare_time_desc);
+	}
+	else
+	{
+		zbx_hashset_iter_reset(&manager->rule_index, &iter);
 
-			rule_info = (zbx_lld_rule_info_t *)zbx_hashset_search(&rule_infos, &rule_info_local);
+		while (NULL != (rule = (zbx_lld_rule_t *)zbx_hashset_iter_next(&iter)))
+		{
+			zbx_lld_data_t	*data_ptr;
 
-			if (NULL == rule_info)
+			for (data_ptr = rule->head; NULL != data_ptr; data_ptr = data_ptr->next)
 			{
-				rule_info = (zbx_lld_rule_info_t *)zbx_hashset_insert(&rule_infos, &rule_info_local,
-						sizeof(zbx_lld_rule_info_t));
-				zbx_vector_lld_rule_info_ptr_append(&view, rule_info);
-			}
+				zbx_lld_rule_info_t	*rule_info, rule_info_local = {.itemid = data_ptr->itemid};
 
-			rule_info->values_num++;
+				rule_info = (zbx_lld_rule_info_t *)zbx_hashset_search(&rule_infos, &rule_info_local);
+
+				if (NULL == rule_info)
+				{
+					rule_info = (zbx_lld_rule_info_t *)zbx_hashset_insert(&rule_infos,
+							&rule_info_local, sizeof(zbx_lld_rule_info_t));
+					zbx_vector_lld_rule_info_ptr_append(&view, rule_info);
+				}
+
+				rule_info->values_num++;
+			}
 		}
-	}
 
-	zbx_vector_lld_rule_info_ptr_sort(&view, lld_diag_item_compare_values_desc);
+		zbx_vector_lld_rule_info_ptr_sort(&view, lld_diag_item_compare_values_desc);
+	}
 
 	data_len = zbx_lld_serialize_top_items_result(&data, (const zbx_lld_rule_info_t **)view.values,
-			MIN(limit, view.values_num));
+			MIN(limit, view.values_num), message->code);
 	zbx_ipc_client_send(client, ZBX_IPC_LLD_TOP_ITEMS_RESULT, data, data_len);
 
 	zbx_free(data);
@@ -601,7 +725,7 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 	char			*error = NULL;
 	zbx_ipc_client_t	*client;
 	zbx_ipc_message_t	*message;
-	double			time_stat, time_now, sec, time_idle = 0;
+	double			time_stat, time_now, sec, time_idle = 0, time_cleanup;
 	zbx_lld_manager_t	manager;
 	zbx_uint64_t		processed_num = 0;
 	zbx_timespec_t		timeout = {1, 0};
@@ -630,6 +754,7 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 
 	/* initialize statistics */
 	time_stat = zbx_time();
+	time_cleanup = time_stat;
 
 	zbx_setproctitle("%s #%d started", get_process_type_string(process_type), process_num);
 
@@ -653,6 +778,12 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 			processed_num = 0;
 		}
 
+		if (SEC_PER_HOUR < time_now - time_cleanup)
+		{
+			lld_rule_stats_cleanup(&manager);
+			time_cleanup = time_now;
+		}
+
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
 		ret = zbx_ipc_service_recv(&lld_service, &timeout, &client, &message);
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
@@ -689,6 +820,7 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 					lld_process_diag_stats(&manager, client);
 					break;
 				case ZBX_IPC_LLD_TOP_ITEMS:
+				case ZBX_IPC_LLD_TOP_TIME_MS:
 					lld_process_top_items(&manager, client, message);
 					break;
 				case ZBX_RTC_SHUTDOWN:
@@ -63,6 +63,9 @@ typedef struct
 
 	/* the number of queued values */
 	int		values_num;
+
+	/* the duration of the last rule processing in milliseconds */
+	int		time_ms;
 }
 zbx_lld_rule_info_t;
 
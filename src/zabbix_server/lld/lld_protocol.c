@@ -75,6 +75,58 @@ void	zbx_lld_deserialize_item_value(const unsigned char *data, zbx_uint64_t *ite
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: serializes LLD value sent to worker for processing together with  *
+ *          revisions of the rule processing                                  *
+ *                                                                            *
+ * Parameters: data          - [OUT] serialized data                          *
+ *             revision_prev - [IN] revision of the previous rule processing, *
+ *                                  0 if the rule was not processed yet       *
+ *             revision      - [IN] revision of this rule processing          *
+ *             ...           - [IN] LLD value, see                            *
+ *                                  zbx_lld_serialize_item_value()            *
+ *                                                                            *
+ * Return value: size of serialized data                                      *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint32_t	zbx_lld_serialize_prepare_value(unsigned char **data, zbx_uint64_t revision_prev, zbx_uint64_t revision,
+		zbx_uint64_t itemid, const char *value, const zbx_timespec_t *ts, unsigned char meta,
+		zbx_uint64_t lastlogsize, int mtime, const char *error)
+{
+	unsigned char	*ptr, *value_data;
+	zbx_uint32_t	data_len = 0, value_data_len;
+
+	value_data_len = zbx_lld_serialize_item_value(&value_data, itemid, 0, value, ts, meta, lastlogsize, mtime,
+			error);
+
+	zbx_serialize_prepare_value(data_len, revision_prev);
+	zbx_serialize_prepare_value(data_len, revision);
+
+	*data = (unsigned char *)zbx_malloc(NULL, data_len + value_data_len);
+
+	ptr = *data;
+	ptr += zbx_serialize_value(ptr, revision_prev);
+	ptr += zbx_serialize_value(ptr, revision);
+	memcpy(ptr, value_data, value_data_len);
+
+	zbx_free(value_data);
+
+	return data_len + value_data_len;
+}
+
+void	zbx_lld_deserialize_prepare_value(const unsigned char *data, zbx_uint64_t *revision_prev,
+		zbx_uint64_t *revision, zbx_uint64_t *itemid, char **value, zbx_timespec_t *ts, unsigned char *meta,
+		zbx_uint64_t *lastlogsize, int *mtime, char **error)
+{
+	zbx_uint64_t	hostid;
+
+	data += zbx_deserialize_value(data, revision_prev);
+	data += zbx_deserialize_value(data, revision);
+
+	zbx_lld_deserialize_item_value(data, itemid, &hostid, value, ts, meta, lastlogsize, mtime, error);
+}
+
 zbx_uint32_t	zbx_lld_serialize_value(unsigned char **data, const char *value)
 {
 	zbx_uint32_t	data_len = 0, value_len;
@@ -144,7 +196,7 @@ void	zbx_lld_deserialize_top_items_request(const unsigned char *data, int *limit
 }
 
 zbx_uint32_t	zbx_lld_serialize_top_items_result(unsigned char **data, const zbx_lld_rule_info_t **rule_infos,
-		int num)
+		int num, zbx_uint32_t code)
 {
 	unsigned char	*ptr;
 	zbx_uint32_t	data_len = 0, item_len = 0;
@@ -165,7 +217,11 @@ zbx_uint32_t	zbx_lld_serialize_top_items_result(unsigned char **data, const zbx_
 	for (int i = 0; i < num; i++)
 	{
 		ptr += zbx_serialize_value(ptr, rule_infos[i]->itemid);
-		ptr += zbx_serialize_value(ptr, rule_infos[i]->values_num);
+
+		if (ZBX_IPC_LLD_TOP_TIME_MS == code)
+			ptr += zbx_serialize_value(ptr, rule_infos[i]->time_ms);
+		else
+			ptr += zbx_serialize_value(ptr, rule_infos[i]->values_num);
 	}
 
 	return data_len;
@@ -332,19 +388,7 @@ int	zbx_lld_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, ch
 	return SUCCEED;
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: gets top N items by number of queued values                       *
- *                                                                            *
- * Parameters limit - [IN] number of top records to retrieve                  *
- *            items - [OUT] vector of top itemid, values_num pairs            *
- *            error - [OUT] error message                                     *
- *                                                                            *
- * Return value: SUCCEED - top n items were returned successfully             *
- *               FAIL - otherwise                                             *
- *                                                                            *
- ******************************************************************************/
-int	zbx_lld_get_top_items(int limit, zbx_vector_uint64_pair_t *items, char **error)
+static int	lld_get_top_items(zbx_uint32_t code, int limit, zbx_vector_uint64_pair_t *items, char **error)
 {
 	int		ret;
 	unsigned char	*data, *result;
@@ -352,8 +396,8 @@ int	zbx_lld_get_top_items(int limit, zbx_vector_uint64_pair_t *items, char **err
 
 	data_len = zbx_lld_serialize_top_items_request(&data, limit);
 
-	if (SUCCEED != (ret = zbx_ipc_async_exchange(ZBX_IPC_SERVICE_LLD, ZBX_IPC_LLD_TOP_ITEMS, SEC_PER_MIN, data,
-			data_len, &result, error)))
+	if (SUCCEED != (ret = zbx_ipc_async_exchange(ZBX_IPC_SERVICE_LLD, code, SEC_PER_MIN, data, data_len, &result,
+			error)))
 	{
 		goto out;
 	}
@@ -365,3 +409,37 @@ out:
 
 	return ret;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets top N items by number of queued values                       *
+ *                                                                            *
+ * Parameters limit - [IN] number of top records to retrieve                  *
+ *            items - [OUT] vector of top itemid, values_num pairs            *
+ *            error - [OUT] error message                                     *
+ *                                                                            *
+ * Return value: SUCCEED - top n items were returned successfully             *
+ *               FAIL - otherwise                                             *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_lld_get_top_items(int limit, zbx_vector_uint64_pair_t *items, char **error)
+{
+	return lld_get_top_items(ZBX_IPC_LLD_TOP_ITEMS, limit, items, error);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets top N items by duration of the last processing               *
+ *                                                                            *
+ * Parameters limit - [IN] number of top records to retrieve                  *
+ *            items - [OUT] vector of top itemid, time_ms pairs               *
+ *            error - [OUT] error message                                     *
+ *                                                                            *
+ * Return value: SUCCEED - top n items were returned successfully             *
+ *               FAIL - otherwise                                             *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_lld_get_top_time_ms(int limit, zbx_vector_uint64_pair_t *items, char **error)
+{
+	return lld_get_top_items(ZBX_IPC_LLD_TOP_TIME_MS, limit, items, error);
+}
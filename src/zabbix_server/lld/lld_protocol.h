@@ -49,6 +49,9 @@
 /* manager -> process */
 #define ZBX_IPC_LLD_TOP_ITEMS_RESULT	1403
 
+/* process -> manager */
+#define ZBX_IPC_LLD_TOP_TIME_MS		1404
+
 zbx_uint32_t	zbx_lld_serialize_item_value(unsigned char **data, zbx_uint64_t itemid, zbx_uint64_t hostid,
 		const char *value, const zbx_timespec_t *ts, unsigned char meta, zbx_uint64_t lastlogsize, int mtime,
 		const char *error);
@@ -57,6 +60,14 @@ void	zbx_lld_deserialize_item_value(const unsigned char *data, zbx_uint64_t *ite
 		char **value, zbx_timespec_t *ts, unsigned char *meta, zbx_uint64_t *lastlogsize, int *mtime,
 		char **error);
 
+zbx_uint32_t	zbx_lld_serialize_prepare_value(unsigned char **data, zbx_uint64_t revision_prev, zbx_uint64_t revision,
+		zbx_uint64_t itemid, const char *value, const zbx_timespec_t *ts, unsigned char meta,
+		zbx_uint64_t lastlogsize, int mtime, const char *error);
+
+void	zbx_lld_deserialize_prepare_value(const unsigned char *data, zbx_uint64_t *revision_prev,
+		zbx_uint64_t *revision, zbx_uint64_t *itemid, char **value, zbx_timespec_t *ts, unsigned char *meta,
+		zbx_uint64_t *lastlogsize, int *mtime, char **error);
+
 zbx_uint32_t	zbx_lld_serialize_value(unsigned char **data, const char *value);
 
 void	zbx_lld_deserialize_value(const unsigned char *data, char **value);
@@ -66,7 +77,7 @@ zbx_uint32_t	zbx_lld_serialize_diag_stats(unsigned char **data, zbx_uint64_t ite
 void	zbx_lld_deserialize_top_items_request(const unsigned char *data, int *limit);
 
 zbx_uint32_t	zbx_lld_serialize_top_items_result(unsigned char **data, const zbx_lld_rule_info_t **rule_infos,
-		int num);
+		int num, zbx_uint32_t code);
 
 void	zbx_lld_queue_value(zbx_uint64_t itemid, zbx_uint64_t hostid, const char *value, const zbx_timespec_t *ts,
 		unsigned char meta, zbx_uint64_t lastlogsize, int mtime, const char *error);
@@ -79,5 +90,6 @@ int	zbx_lld_get_queue_size(zbx_uint64_t *size, char **error);
 int	zbx_lld_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, char **error);
 
 int	zbx_lld_get_top_items(int limit, zbx_vector_uint64_pair_t *items, char **error);
+int	zbx_lld_get_top_time_ms(int limit, zbx_vector_uint64_pair_t *items, char **error);
 
 #endif
@@ -3842,13 +3842,29 @@ static	unsigned char	get_trigger_status_value(int status)
 	return TRIGGER_STATUS_DISABLED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if trigger uses items discovered from removed LLD rows      *
+ *                                                                            *
+ ******************************************************************************/
+static int	lld_trigger_has_lost_item(const zbx_lld_trigger_t *trigger, const zbx_lld_delta_t *delta)
+{
+	for (int i = 0; i < trigger->functions.values_num; i++)
+	{
+		if (SUCCEED == lld_delta_has_lost_item(delta, trigger->functions.values[i]->itemid))
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: process lost trigger resources                                    *
  *                                                                            *
  ******************************************************************************/
 static void	lld_process_lost_triggers(zbx_vector_lld_trigger_ptr_t *triggers, const zbx_lld_lifetime_t *lifetime,
-		const zbx_lld_lifetime_t *enabled_lifetime, int now)
+		const zbx_lld_lifetime_t *enabled_lifetime, int now, const zbx_lld_delta_t *delta)
 {
 	zbx_hashset_t	discoveries;
 
@@ -3860,6 +3876,14 @@ static void	lld_process_lost_triggers(zbx_vector_lld_trigger_ptr_t *triggers, co
 		zbx_lld_trigger_t	*trigger = triggers->values[i];
 		zbx_lld_discovery_t	*discovery;
 		unsigned char		object_status;
+		int			lastcheck;
+
+		/* triggers of unchanged rows are left as they are during incremental processing */
+		if (NULL != delta && 0 == (trigger->flags & ZBX_FLAG_LLD_TRIGGER_DISCOVERED) &&
+				SUCCEED != lld_trigger_has_lost_item(trigger, delta))
+		{
+			continue;
+		}
 
 		object_status = (TRIGGER_STATUS_DISABLED == trigger->status ? ZBX_LLD_OBJECT_STATUS_DISABLED :
 				ZBX_LLD_OBJECT_STATUS_ENABLED);
@@ -3876,10 +3900,12 @@ static void	lld_process_lost_triggers(zbx_vector_lld_trigger_ptr_t *triggers, co
 
 		/* process lost triggers */
 
-		lld_process_lost_object(discovery, object_status, trigger->lastcheck, now, lifetime,
-				trigger->discovery_status, trigger->disable_source, trigger->ts_delete);
+		lastcheck = lld_delta_get_lastcheck(delta, trigger->lastcheck);
+
+		lld_process_lost_object(discovery, object_status, lastcheck, now, lifetime, trigger->discovery_status,
+				trigger->disable_source, trigger->ts_delete);
 
-		lld_disable_lost_object(discovery, object_status, trigger->lastcheck, now, enabled_lifetime,
+		lld_disable_lost_object(discovery, object_status, lastcheck, now, enabled_lifetime,
 				trigger->ts_disable);
 	}
 
@@ -3901,7 +3927,7 @@ static void	lld_process_lost_triggers(zbx_vector_lld_trigger_ptr_t *triggers, co
  ******************************************************************************/
 int	lld_update_triggers(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, const zbx_vector_lld_row_ptr_t *lld_rows,
 		char **error, const zbx_lld_lifetime_t *lifetime, const zbx_lld_lifetime_t *enabled_lifetime,
-		int lastcheck, int dflags, const zbx_vector_uint64_t *ruleids)
+		int lastcheck, int dflags, const zbx_vector_uint64_t *ruleids, const zbx_lld_delta_t *delta)
 {
 	zbx_vector_lld_trigger_prototype_ptr_t	trigger_prototypes;
 	zbx_vector_lld_trigger_ptr_t		triggers;
@@ -3955,7 +3981,7 @@ int	lld_update_triggers(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, const zbx_
 	lld_trigger_dependencies_validate(&triggers, error);
 	lld_trigger_tags_make(&trigger_prototypes, &triggers, lld_rows, error);
 	ret = lld_triggers_save(hostid, &trigger_prototypes, &triggers, dflags |  ZBX_FLAG_DISCOVERY_CREATED);
-	lld_process_lost_triggers(&triggers, lifetime, enabled_lifetime, lastcheck);
+	lld_process_lost_triggers(&triggers, lifetime, enabled_lifetime, lastcheck, delta);
 
 	/* cleaning */
 
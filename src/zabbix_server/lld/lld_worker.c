@@ -32,6 +32,10 @@
 #include "zbxalgo.h"
 #include "zbxhash.h"
 
+#ifdef HAVE_LIBXML2
+#	include <libxml/parser.h>
+#endif
+
 typedef struct
 {
 	zbx_dc_item_t			item;
@@ -44,9 +48,38 @@ typedef struct
 	zbx_vector_lld_entry_ptr_t	entries_sorted;
 	zbx_vector_lld_macro_path_ptr_t	macro_paths;
 	zbx_jsonobj_t			source;
+	zbx_uint64_t			revision_prev;
+	zbx_uint64_t			revision;
 }
 zbx_lld_value_t;
 
+/* the period after which all rows of LLD rule are processed even if only few have changed and rule */
+/* configuration hash has not changed                                                               */
+#define LLD_FULL_PROCESSING_PERIOD	SEC_PER_HOUR
+
+/* the minimum number of rows for LLD rule value to be cached for incremental processing */
+#define LLD_INCREMENTAL_ENTRIES_MIN	100
+
+/* the maximum number of rows of all LLD rule values cached by worker */
+#define LLD_INCREMENTAL_ENTRIES_MAX	100000
+
+/* the value of the last LLD rule processing, used to process only the changed rows of the next value */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	zbx_uint64_t	revision;
+	md5_byte_t	config_hash[ZBX_MD5_DIGEST_SIZE];
+	zbx_hashset_t	entries;
+	int		lastcheck;
+	int		full_lastcheck;
+}
+zbx_lld_rule_state_t;
+
+static void	lld_rule_state_clear(zbx_lld_rule_state_t *rule_state)
+{
+	zbx_hashset_destroy(&rule_state->entries);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: registers LLD worker with LLD manager                             *
@@ -191,24 +224,74 @@ static void	lld_flush_value(zbx_lld_value_t *lld_value, unsigned char state, con
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get cached value of the previous LLD rule processing              *
+ *                                                                            *
+ * Parameters: rule_states   - [IN/OUT] cached LLD rule values                *
+ *             itemid        - [IN] LLD rule identifier                       *
+ *             revision_prev - [IN] LLD rule revision when the previous value *
+ *                                  was processed                             *
+ *             config_hash   - [IN] current LLD rule configuration hash       *
+ *                                  (optional)                                *
+ *                                                                            *
+ * Return value: the cached value or NULL if the rule was processed by other  *
+ *               worker or its configuration was changed since it was cached  *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_lld_rule_state_t	*lld_get_rule_state(zbx_hashset_t *rule_states, zbx_uint64_t itemid,
+		zbx_uint64_t revision_prev, const md5_byte_t *config_hash)
+{
+	zbx_lld_rule_state_t	*rule_state;
+
+	if (NULL == (rule_state = (zbx_lld_rule_state_t *)zbx_hashset_search(rule_states, &itemid)))
+		return NULL;
+
+	if (rule_state->revision != revision_prev)
+	{
+		zbx_hashset_remove_direct(rule_states, rule_state);
+		return NULL;
+	}
+
+	if (NULL != config_hash && 0 != memcmp(rule_state->config_hash, config_hash, ZBX_MD5_DIGEST_SIZE))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "configuration of discovery rule " ZBX_FS_UI64 " has changed, processing"
+				" all rows", itemid);
+		zbx_hashset_remove_direct(rule_states, rule_state);
+		return NULL;
+	}
+
+	return rule_state;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: prepare LLD value                                                 *
  *                                                                            *
  ******************************************************************************/
-static int	lld_prepare_value(const zbx_ipc_message_t *message, zbx_lld_value_t *lld_value)
+static int	lld_prepare_value(const zbx_ipc_message_t *message, zbx_lld_value_t *lld_value,
+		zbx_hashset_t *rule_states)
 {
-	zbx_uint64_t	itemid, hostid;
-	char		*error = NULL, *value = NULL;
-	int		ret = FAIL;
+	zbx_uint64_t		itemid;
+	char			*error = NULL, *value = NULL;
+	int			ret = FAIL;
+	zbx_lld_rule_state_t	*rule_state;
+
+	zbx_lld_deserialize_prepare_value(message->data, &lld_value->revision_prev, &lld_value->revision, &itemid,
+			&value, &lld_value->ts, &lld_value->meta, &lld_value->lastlogsize, &lld_value->mtime, &error);
 
-	zbx_lld_deserialize_item_value(message->data, &itemid, &hostid, &value, &lld_value->ts, &lld_value->meta,
-			&lld_value->lastlogsize, &lld_value->mtime, &error);
+	rule_state = lld_get_rule_state(rule_states, itemid, lld_value->revision_prev, NULL);
 
 	zbx_dc_config_get_items_by_itemids(&lld_value->item, &itemid, &lld_value->errcode, 1);
 
 	if (SUCCEED != lld_value->errcode)
+	{
+		/* the rule was deleted */
+		if (NULL != rule_state)
+			zbx_hashset_remove_direct(rule_states, rule_state);
+
 		goto out;
+	}
 
 	if (NULL != value)
 	{
@@ -242,6 +325,10 @@ static int	lld_prepare_value(const zbx_ipc_message_t *message, zbx_lld_value_t *
 		lld_flush_value(lld_value, state, error);
 		ret = FAIL;
 
+		/* discovered objects were not changed, the cached value is still valid */
+		if (NULL != rule_state)
+			rule_state->revision = lld_value->revision;
+
 		goto out;
 	}
 
@@ -287,21 +374,185 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove cached values of deleted LLD rules and of the rules that   *
+ *          would be fully processed anyway                                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_rule_states_cleanup(zbx_hashset_t *rule_states, int now)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_lld_rule_state_t	*rule_state;
+	zbx_vector_uint64_t	itemids;
+
+	zbx_vector_uint64_create(&itemids);
+
+	zbx_hashset_iter_reset(rule_states, &iter);
+	while (NULL != (rule_state = (zbx_lld_rule_state_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (LLD_FULL_PROCESSING_PERIOD <= now - rule_state->full_lastcheck)
+			zbx_hashset_iter_remove(&iter);
+		else
+			zbx_vector_uint64_append(&itemids, rule_state->itemid);
+	}
+
+	if (0 != itemids.values_num)
+	{
+		zbx_dc_config_history_sync_unset_existing_itemids(&itemids);
+
+		for (int i = 0; i < itemids.values_num; i++)
+			zbx_hashset_remove(rule_states, &itemids.values[i]);
+	}
+
+	zbx_vector_uint64_destroy(&itemids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove the least recently processed cached LLD rule values until  *
+ *          the specified number of rows can be cached                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_rule_states_reserve(zbx_hashset_t *rule_states, int entries_num)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_lld_rule_state_t	*rule_state, *rule_state_oldest;
+	int			cached_num = 0;
+
+	zbx_hashset_iter_reset(rule_states, &iter);
+	while (NULL != (rule_state = (zbx_lld_rule_state_t *)zbx_hashset_iter_next(&iter)))
+		cached_num += rule_state->entries.num_data;
+
+	while (LLD_INCREMENTAL_ENTRIES_MAX < cached_num + entries_num)
+	{
+		rule_state_oldest = NULL;
+
+		zbx_hashset_iter_reset(rule_states, &iter);
+		while (NULL != (rule_state = (zbx_lld_rule_state_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (NULL == rule_state_oldest || rule_state->lastcheck < rule_state_oldest->lastcheck)
+				rule_state_oldest = rule_state;
+		}
+
+		cached_num -= rule_state_oldest->entries.num_data;
+		zbx_hashset_remove_direct(rule_states, rule_state_oldest);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: cache processed LLD value for incremental processing of the next  *
+ *          rule value                                                        *
+ *                                                                            *
+ * Parameters: rule_states    - [IN/OUT] cached LLD rule values               *
+ *             lld_value      - [IN/OUT] processed LLD value, its entries are *
+ *                                       moved to the cache                   *
+ *             config_hash    - [IN] LLD rule configuration hash, calculated  *
+ *                                   before processing                        *
+ *             lastcheck      - [IN] processing time                          *
+ *             full_lastcheck - [IN] time when all rows were processed        *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_cache_rule_state(zbx_hashset_t *rule_states, zbx_lld_value_t *lld_value,
+		const md5_byte_t *config_hash, int lastcheck, int full_lastcheck)
+{
+	zbx_lld_rule_state_t	*rule_state, rule_state_local = {.itemid = lld_value->item.itemid};
+	zbx_hashset_iter_t	iter;
+	zbx_lld_entry_t		*entry;
+
+	if (NULL != (rule_state = (zbx_lld_rule_state_t *)zbx_hashset_search(rule_states, &rule_state_local)))
+		zbx_hashset_remove_direct(rule_states, rule_state);
+
+	if (LLD_INCREMENTAL_ENTRIES_MIN > lld_value->entries.num_data ||
+			LLD_INCREMENTAL_ENTRIES_MAX < lld_value->entries.num_data)
+	{
+		return;
+	}
+
+	lld_rule_states_reserve(rule_states, lld_value->entries.num_data);
+
+	/* the source JSON is freed together with LLD value */
+	zbx_hashset_iter_reset(&lld_value->entries, &iter);
+	while (NULL != (entry = (zbx_lld_entry_t *)zbx_hashset_iter_next(&iter)))
+		entry->source = NULL;
+
+	rule_state_local.revision = lld_value->revision;
+	memcpy(rule_state_local.config_hash, config_hash, ZBX_MD5_DIGEST_SIZE);
+	rule_state_local.entries = lld_value->entries;
+	rule_state_local.lastcheck = lastcheck;
+	rule_state_local.full_lastcheck = full_lastcheck;
+
+	zbx_hashset_insert(rule_states, &rule_state_local, sizeof(rule_state_local));
+
+	zbx_vector_lld_entry_ptr_clear(&lld_value->entries_sorted);
+	zbx_hashset_create_ext(&lld_value->entries, 0, lld_entry_hash, lld_entry_compare,
+			(zbx_clean_func_t)lld_entry_clear, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: process LLD value                                                 *
  *                                                                            *
+ * Comments: When the worker has the value of the previous rule processing    *
+ *           only the objects discovered from added, changed or removed rows  *
+ *           are processed. All rows are processed when the rule filter,      *
+ *           overrides or prototypes have changed and periodically to remove  *
+ *           expired lost objects.                                            *
+ *                                                                            *
  ******************************************************************************/
-static void	lld_process_value(zbx_lld_value_t *lld_value)
+static void	lld_process_value(zbx_lld_value_t *lld_value, zbx_hashset_t *rule_states)
 {
-	char		*error = NULL;
-	unsigned char	state;
+	char			*error = NULL;
+	unsigned char		state;
+	int			now, full_lastcheck;
+	zbx_lld_rule_state_t	*rule_state;
+	zbx_lld_delta_t		delta, *pdelta = NULL;
+	md5_byte_t		config_hash[ZBX_MD5_DIGEST_SIZE] = {0};
+
+	now = (int)time(NULL);
+	full_lastcheck = now;
+
+	zbx_vector_lld_entry_ptr_create(&delta.added);
+	zbx_vector_lld_entry_ptr_create(&delta.removed);
+	zbx_vector_lld_row_ptr_create(&delta.removed_rows);
+	zbx_vector_uint64_create(&delta.lost_itemids);
+
+	/* configuration is hashed only for the values that were or will be cached for incremental processing */
+	if (LLD_INCREMENTAL_ENTRIES_MIN <= lld_value->entries.num_data ||
+			NULL != zbx_hashset_search(rule_states, &lld_value->item.itemid))
+	{
+		lld_rule_get_config_hash(lld_value->item.itemid, config_hash);
+	}
+
+	if (NULL != (rule_state = lld_get_rule_state(rule_states, lld_value->item.itemid, lld_value->revision_prev,
+			config_hash)) && LLD_FULL_PROCESSING_PERIOD > now - rule_state->full_lastcheck &&
+			SUCCEED == lld_entries_get_delta(&lld_value->entries, &rule_state->entries, &delta))
+	{
+		delta.lastcheck = rule_state->lastcheck;
+		pdelta = &delta;
+		full_lastcheck = rule_state->full_lastcheck;
+	}
 
-	if (SUCCEED == lld_process_discovery_rule(&lld_value->item, &lld_value->entries_sorted, &error))
+	if (SUCCEED == lld_process_discovery_rule(&lld_value->item, &lld_value->entries_sorted, pdelta, &error))
 		state = ITEM_STATE_NORMAL;
 	else
 		state = ITEM_STATE_NOTSUPPORTED;
 
+	zbx_vector_lld_row_ptr_clear_ext(&delta.removed_rows, lld_row_free);
+	zbx_vector_lld_row_ptr_destroy(&delta.removed_rows);
+	zbx_vector_lld_entry_ptr_destroy(&delta.removed);
+	zbx_vector_lld_entry_ptr_destroy(&delta.added);
+	zbx_vector_uint64_destroy(&delta.lost_itemids);
+
+	if (ITEM_STATE_NORMAL == state)
+	{
+		lld_cache_rule_state(rule_states, lld_value, config_hash, now, full_lastcheck);
+	}
+	else if (NULL != rule_state)
+		zbx_hashset_remove_direct(rule_states, rule_state);
+
 	lld_flush_value(lld_value, state, error);
 
 	zbx_free(error);
@@ -319,6 +570,11 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 				process_num = ((zbx_thread_args_t *)args)->info.process_num;
 	unsigned char		process_type = ((zbx_thread_args_t *)args)->info.process_type;
 	zbx_lld_value_t		lld_value = {0};
+	zbx_hashset_t		rule_states;
+	int			time_cleanup = 0;
+	long			cpu_num;
+
+	zbx_thread_lld_worker_args	*args_in = (zbx_thread_lld_worker_args *)(((zbx_thread_args_t *)args)->args);
 
 	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
 			server_num, get_process_type_string(process_type), process_num);
@@ -336,6 +592,20 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 
 	lld_register_worker(&lld_socket);
 
+#ifdef HAVE_LIBXML2
+	/* large discovery rules are processed by several threads */
+	xmlInitParser();
+#endif
+	/* share online CPUs between LLD workers processing large rules at the same time */
+	if (0 >= (cpu_num = sysconf(_SC_NPROCESSORS_ONLN)))
+		cpu_num = 1;
+
+	lld_jobs_init((int)(cpu_num / MAX(1, args_in->get_process_forks_cb_arg(ZBX_PROCESS_TYPE_LLDWORKER))));
+
+	zbx_hashset_create_ext(&rule_states, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+			(zbx_clean_func_t)lld_rule_state_clear, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+
 	time_stat = zbx_time();
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
@@ -360,6 +630,12 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 			processed_num = 0;
 		}
 #undef STAT_INTERVAL
+		if (LLD_FULL_PROCESSING_PERIOD <= (int)time_now - time_cleanup)
+		{
+			lld_rule_states_cleanup(&rule_states, (int)time_now);
+			time_cleanup = (int)time_now;
+		}
+
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
 		if (SUCCEED != zbx_ipc_socket_read(&lld_socket, &message))
 		{
@@ -383,7 +659,7 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 				}
 
 				lld_value_init(&lld_value);
-				if (SUCCEED == lld_prepare_value(&message, &lld_value))
+				if (SUCCEED == lld_prepare_value(&message, &lld_value, &rule_states))
 				{
 					zbx_ipc_socket_write(&lld_socket, ZBX_IPC_LLD_NEXT, NULL, 0);
 				}
@@ -411,7 +687,7 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 				}
 				ZBX_FALLTHROUGH;
 			case ZBX_IPC_LLD_PROCESS:
-				lld_process_value(&lld_value);
+				lld_process_value(&lld_value, &rule_states);
 				lld_value_clear(&lld_value);
 				zbx_ipc_socket_write(&lld_socket, ZBX_IPC_LLD_DONE, NULL, 0);
 				processed_num++;
@@ -424,6 +700,8 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 	if (0 != lld_value.item.itemid)
 		lld_value_clear(&lld_value);
 
+	zbx_hashset_destroy(&rule_states);
+
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
@@ -17,6 +17,12 @@
 
 #include "zbxthreads.h"
 
+typedef struct
+{
+	zbx_get_config_forks_f	get_process_forks_cb_arg;
+}
+zbx_thread_lld_worker_args;
+
 ZBX_THREAD_ENTRY(lld_worker_thread, args);
 
 #endif
@@ -1625,6 +1625,7 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 	int				ret, flags = ZBX_TCP_PROTOCOL, loglevel, version_int;
 	size_t				buffer_size, reserved = 0;
 	zbx_proxyconfig_status_t	status = ZBX_PROXYCONFIG_STATUS_DATA;
+	unsigned char			codec;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -1669,15 +1670,21 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 		goto clean;
 	}
 
+	zbx_add_compress_codecs(&j);
+
 	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	/* reply with the codec used by proxy */
+	codec = zbx_tcp_get_compress_codec(sock);
+
+	if (SUCCEED != zbx_compress_ext(codec, j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto clean;
 	}
 
 	reserved = j.buffer_size;
+	flags |= zbx_tcp_compress_flags(codec);
 
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
 
@@ -41,6 +41,26 @@
 
 static zbx_get_program_type_f		zbx_get_program_type_cb = NULL;
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stores codec negotiated with proxy in configuration cache         *
+ *                                                                            *
+ * Parameters: proxyid - [IN]                                                 *
+ *             codec   - [IN] ZBX_COMPRESS_* codec                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxy_update_compress_codec(zbx_uint64_t proxyid, unsigned char codec)
+{
+	zbx_proxy_diff_t	diff;
+
+	diff.hostid = proxyid;
+	diff.flags = ZBX_FLAGS_PROXY_DIFF_UPDATE_COMPRESS;
+	diff.lastaccess = time(NULL);
+	diff.compress = codec;
+
+	zbx_dc_update_proxy(&diff);
+}
+
 static int	connect_to_proxy(const zbx_dc_proxy_t *proxy, zbx_socket_t *sock, int timeout,
 		const char *config_source_ip)
 {
@@ -156,8 +176,7 @@ static void	disconnect_proxy(zbx_socket_t *sock)
  * Return value: SUCCESS - processed successfully                               *
  *               other code - an error occurred                                 *
  *                                                                              *
- * Comments: The proxy->compress property is updated depending on the           *
- *           protocol flags sent by proxy.                                      *
+ * Comments: The request is compressed with the codec negotiated with proxy.     *
  *                                                                              *
  ********************************************************************************/
 static int	get_data_from_proxy(zbx_dc_proxy_t *proxy, const char *request, int config_timeout,
@@ -165,7 +184,7 @@ static int	get_data_from_proxy(zbx_dc_proxy_t *proxy, const char *request, int c
 {
 	zbx_socket_t	s;
 	struct zbx_json	j;
-	int		ret, flags = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS;
+	int		ret, flags = ZBX_TCP_PROTOCOL | zbx_tcp_compress_flags(proxy->compress_codec);
 	char		*buffer = NULL;
 	size_t		buffer_size, reserved = 0;
 
@@ -175,7 +194,7 @@ static int	get_data_from_proxy(zbx_dc_proxy_t *proxy, const char *request, int c
 
 	zbx_json_addstring(&j, "request", request, ZBX_JSON_TYPE_STRING);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	if (SUCCEED != zbx_compress_ext(proxy->compress_codec, j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		ret = FAIL;
@@ -249,8 +268,8 @@ out:
  * Return value: SUCCEED - processed successfully                             *
  *               other code - an error occurred                               *
  *                                                                            *
- * Comments: This function updates proxy version, compress and lastaccess     *
- *           properties.                                                      *
+ * Comments: This function updates proxy version, compress codec and          *
+ *           lastaccess properties.                                           *
  *                                                                            *
  ******************************************************************************/
 static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vault_t *config_vault,
@@ -258,7 +277,7 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 		const char *config_ssl_cert_location, const char *config_ssl_key_location)
 {
 	char				*error = NULL, *buffer = NULL;
-	int				ret, flags = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, loglevel;
+	int				ret, loglevel;
 	zbx_socket_t			s;
 	struct zbx_json			j;
 	struct zbx_json_parse		jp;
@@ -289,6 +308,9 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 		goto clean;
 	}
 
+	/* older proxies do not advertise codecs and get zlib compressed configuration */
+	proxy->compress_codec = zbx_parse_compress_codecs(&jp);
+
 	zbx_json_clean(&j);
 
 	if (SUCCEED != (ret = zbx_proxyconfig_get_data(proxy, &jp, &j, &status, config_vault, config_source_ip,
@@ -299,7 +321,7 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 		goto clean;
 	}
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	if (SUCCEED != zbx_compress_ext(proxy->compress_codec, j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		ret = FAIL;
@@ -316,7 +338,8 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 			s.peer, (zbx_fs_size_t)reserved, (zbx_fs_size_t)buffer_size,
 			(double)reserved / buffer_size);
 
-	ret = send_data_to_proxy(proxy, &s, buffer, buffer_size, reserved, flags);
+	ret = send_data_to_proxy(proxy, &s, buffer, buffer_size, reserved,
+			ZBX_TCP_PROTOCOL | zbx_tcp_compress_flags(proxy->compress_codec));
 	zbx_free(buffer);		/* json buffer can be large, free as fast as possible */
 
 	if (SUCCEED == ret)
@@ -374,8 +397,8 @@ out:
  * Return value: SUCCEED - data were received and processed successfully      *
  *               FAIL - otherwise                                             *
  *                                                                            *
- * Comments: The proxy->version property is updated with the version number   *
- *           sent by proxy.                                                   *
+ * Comments: The proxy->version and proxy->compress_codec properties are      *
+ *           updated with the version number and codecs sent by proxy.        *
  *                                                                            *
  ******************************************************************************/
 static int	proxy_process_proxy_data(zbx_dc_proxy_t *proxy, const char *answer, zbx_timespec_t *ts,
@@ -408,6 +431,7 @@ static int	proxy_process_proxy_data(zbx_dc_proxy_t *proxy, const char *answer, z
 
 	zbx_strlcpy(proxy->version_str, version_str, sizeof(proxy->version_str));
 	proxy->version_int = version_int;
+	proxy->compress_codec = zbx_parse_compress_codecs(&jp);
 
 	if (SUCCEED != zbx_check_protocol_version(proxy, version_int))
 	{
@@ -449,8 +473,8 @@ out:
  * Return value: SUCCEED - data were received and processed successfully      *
  *               other code - an error occurred                               *
  *                                                                            *
- * Comments: This function updates proxy version, compress and lastaccess     *
- *           properties.                                                      *
+ * Comments: This function updates proxy version, compress codec and          *
+ *           lastaccess properties.                                           *
  *                                                                            *
  ******************************************************************************/
 static int	proxy_get_data(zbx_dc_proxy_t *proxy, int config_timeout, int config_trapper_timeout,
@@ -504,8 +528,8 @@ out:
  * Return value: SUCCEED - data were received and processed successfully      *
  *               other code - an error occurred                               *
  *                                                                            *
- * Comments: This function updates proxy version, compress and lastaccess     *
- *           properties.                                                      *
+ * Comments: This function updates proxy version, compress codec and          *
+ *           lastaccess properties.                                           *
  *                                                                            *
  ******************************************************************************/
 static int	proxy_get_tasks(zbx_dc_proxy_t *proxy, int config_timeout, int config_trapper_timeout,
@@ -659,6 +683,13 @@ error:
 			zbx_update_proxy_data(&proxy_old, proxy.version_str, proxy.version_int, proxy.lastaccess, 0);
 		}
 
+		/* the proxy might have been replaced by one not supporting the codec */
+		if (SUCCEED != ret)
+			proxy.compress_codec = ZBX_COMPRESS_ZLIB;
+
+		if (proxy_old.compress_codec != proxy.compress_codec)
+			proxy_update_compress_codec(proxy.proxyid, proxy.compress_codec);
+
 		zbx_dc_requeue_proxy(proxy.proxyid, update_nextcheck, ret, proxyconfig_frequency, proxydata_frequency);
 	}
 
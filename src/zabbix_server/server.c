@@ -59,6 +59,8 @@
 #include "zbxmodules.h"
 #include "zbxnix.h"
 #include "zbxcomms.h"
+#include "zbxcompress.h"
+#include "zbxregexp.h"
 #include "zbxcacheconfig.h"
 #include "zbxdb.h"
 #include "zbxdbhigh.h"
@@ -292,6 +294,15 @@ static int	get_config_forks(unsigned char process_type)
 	return 0;
 }
 
+static void	get_selfmon_counters(zbx_uint64_t *counters)
+{
+	counters[ZBX_SELFMON_COUNTER_RECV_PEAK_UNENCRYPTED] = zbx_tcp_recv_get_peak_memory(ZBX_TCP_SEC_UNENCRYPTED);
+	counters[ZBX_SELFMON_COUNTER_RECV_PEAK_PSK] = zbx_tcp_recv_get_peak_memory(ZBX_TCP_SEC_TLS_PSK);
+	counters[ZBX_SELFMON_COUNTER_RECV_PEAK_CERT] = zbx_tcp_recv_get_peak_memory(ZBX_TCP_SEC_TLS_CERT);
+	zbx_regexp_cache_get_stats(&counters[ZBX_SELFMON_COUNTER_REGEXP_CACHE_HITS],
+			&counters[ZBX_SELFMON_COUNTER_REGEXP_CACHE_MISSES]);
+}
+
 ZBX_GET_CONFIG_VAR2(char *, const char *, zbx_config_source_ip, NULL)
 ZBX_GET_CONFIG_VAR2(char *, const char *, zbx_config_tmpdir, NULL)
 ZBX_GET_CONFIG_VAR2(char *, const char *, zbx_config_fping_location, NULL)
@@ -325,10 +336,14 @@ static zbx_uint64_t	config_trends_cache_size	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_trend_func_cache_size	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_value_cache_size		= 8 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_vmware_cache_size	= 8 * ZBX_MEBIBYTE;
+static int		config_history_cache_partitions	= 1;
+static int		config_parallel_trend_flush	= 0;
 
 static int	config_unreachable_period		= 45;
 static int	config_unreachable_delay		= 15;
 static int	config_max_concurrent_checks_per_poller	= 1000;
+static int	config_snmp_max_repetitions_tuning	= 0;
+static int	config_max_concurrent_connections_per_trapper	= 1;
 static int	config_log_level		= LOG_LEVEL_WARNING;
 static char	*config_externalscripts		= NULL;
 static int	config_allow_unsupported_db_versions = 0;
@@ -374,11 +389,14 @@ static char	*config_history_storage_url		= NULL;
 static char	*config_history_storage_opts		= NULL;
 static int	config_history_storage_pipelines	= 0;
 static char	*config_stats_allowed_ip		= NULL;
+static char	*config_compression_codec		= NULL;
 static int	config_tcp_max_backlog_size		= SOMAXCONN;
 static char	*zbx_config_webservice_url		= NULL;
 static int	config_service_manager_sync_frequency	= 60;
 static int	config_vps_limit			= 0;
 static int	config_vps_overcommit_limit		= 0;
+static int	config_escalator_shards			= 0;
+static int	config_escalator_shard_batch_size	= 4;
 static char	*config_file				= NULL;
 static int	config_allow_root			= 0;
 static int	config_enable_global_scripts		= 1;
@@ -758,6 +776,25 @@ static void	zbx_validate_config(ZBX_TASK_EX *task)
 		err = 1;
 	}
 
+	if (NULL != config_compression_codec)
+	{
+		unsigned char	codec;
+
+		if (SUCCEED != zbx_compress_codec_parse(config_compression_codec, &codec))
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "invalid \"CompressionCodec\" configuration parameter: '%s'",
+					config_compression_codec);
+			err = 1;
+		}
+		else if (SUCCEED != zbx_compress_set_codec(codec))
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "\"CompressionCodec\" configuration parameter cannot be set to"
+					" '%s': compiled without %s support", config_compression_codec,
+					config_compression_codec);
+			err = 1;
+		}
+	}
+
 	if (NULL != config_frontend_allowed_ip && FAIL == zbx_validate_peer_list(config_frontend_allowed_ip, &ch_error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "invalid entry in \"FrontendAllowedIP\" configuration parameter: %s",
@@ -918,6 +955,10 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 		{"StartEscalators",		&config_forks[ZBX_PROCESS_TYPE_ESCALATOR],
 											ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			100},
+		{"EscalatorShards",		&config_escalator_shards,		ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	0,			10000},
+		{"EscalatorShardBatchSize",	&config_escalator_shard_batch_size,	ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	1,			1000},
 		{"JavaGateway",			&config_java_gateway,			ZBX_CFG_TYPE_STRING,
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"JavaGatewayPort",		&config_java_gateway_port,		ZBX_CFG_TYPE_INT,
@@ -933,8 +974,12 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(16) * ZBX_GIBIBYTE},
 		{"HistoryIndexCacheSize",	&config_history_index_cache_size,	ZBX_CFG_TYPE_UINT64,
 				ZBX_CONF_PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(16) * ZBX_GIBIBYTE},
+		{"HistoryCachePartitions",	&config_history_cache_partitions,	ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	1,			ZBX_HC_PARTITIONS_MAX},
 		{"TrendCacheSize",		&config_trends_cache_size,		ZBX_CFG_TYPE_UINT64,
 				ZBX_CONF_PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(16) * ZBX_GIBIBYTE},
+		{"ParallelTrendFlush",		&config_parallel_trend_flush,		ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	0,			1},
 		{"TrendFunctionCacheSize",	&config_trend_func_cache_size,		ZBX_CFG_TYPE_UINT64,
 				ZBX_CONF_PARM_OPT,	0,			__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"ValueCacheSize",		&config_value_cache_size,		ZBX_CFG_TYPE_UINT64,
@@ -955,6 +1000,10 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	1,			30},
 		{"TrapperTimeout",		&zbx_config_trapper_timeout,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			300},
+		{"MaxConcurrentConnectionsPerTrapper",
+						&config_max_concurrent_connections_per_trapper,
+											ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	1,			1000},
 		{"UnreachablePeriod",		&config_unreachable_period,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			SEC_PER_HOUR},
 		{"UnreachableDelay",		&config_unreachable_delay,		ZBX_CFG_TYPE_INT,
@@ -1116,6 +1165,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 		{"StartLLDProcessors",		&config_forks[ZBX_PROCESS_TYPE_LLDWORKER],
 											ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			100},
+		{"CompressionCodec",		&config_compression_codec,		ZBX_CFG_TYPE_STRING,
+				ZBX_CONF_PARM_OPT,	0,			0},
 		{"StatsAllowedIP",		&config_stats_allowed_ip,		ZBX_CFG_TYPE_STRING_LIST,
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"StartHistoryPollers",		&config_forks[ZBX_PROCESS_TYPE_HISTORYPOLLER],
@@ -1157,6 +1208,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 						&config_max_concurrent_checks_per_poller,
 											ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			1000},
+		{"SNMPMaxRepetitionsTuning",	&config_snmp_max_repetitions_tuning,	ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	0,			1000},
 		{"VPSLimit",			&config_vps_limit,			ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	0,			ZBX_MEBIBYTE},
 		{"VPSOvercommitLimit",		&config_vps_overcommit_limit,		ZBX_CFG_TYPE_INT,
@@ -1244,6 +1297,7 @@ static void	zbx_on_exit(int ret, void *on_exit_args)
 		zbx_vc_destroy();
 
 		zbx_deinit_remote_commands_cache();
+		zbx_deinit_escalation_shards();
 
 		/* free vmware support */
 		zbx_vmware_destroy();
@@ -1584,6 +1638,7 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 			.config_unreachable_period = config_unreachable_period,
 			.config_unreachable_delay = config_unreachable_delay,
 			.config_max_concurrent_checks_per_poller = config_max_concurrent_checks_per_poller,
+			.config_snmp_max_repetitions_tuning = config_snmp_max_repetitions_tuning,
 			.get_config_forks = get_config_forks,
 			.config_java_gateway = config_java_gateway,
 			.config_java_gateway_port = config_java_gateway_port,
@@ -1614,7 +1669,9 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 			.config_webdriver_url = config_webdriver_url,
 			.trapper_process_request_func_cb = zbx_trapper_process_request_server,
 			.autoreg_update_host_cb = zbx_autoreg_update_host_server,
-			.config_frontend_allowed_ip = config_frontend_allowed_ip
+			.config_frontend_allowed_ip = config_frontend_allowed_ip,
+			.config_max_concurrent_connections_per_trapper =
+					config_max_concurrent_connections_per_trapper
 		};
 
 	zbx_thread_escalator_args	escalator_args =
@@ -1773,6 +1830,11 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 			.get_process_forks_cb_arg = get_config_forks
 		};
 
+	zbx_thread_lld_worker_args	lld_worker_args =
+		{
+			.get_process_forks_cb_arg = get_config_forks
+		};
+
 	zbx_thread_connector_manager_args	connector_manager_args =
 		{
 			.get_process_forks_cb_arg = get_config_forks
@@ -1813,7 +1875,9 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 		};
 
 	if (SUCCEED != zbx_init_database_cache(get_zbx_program_type, zbx_sync_history_cache_server,
-			config_history_cache_size, config_history_index_cache_size, &config_trends_cache_size, &error))
+			config_history_cache_size, config_history_index_cache_size, config_history_cache_partitions,
+			0 != config_parallel_trend_flush ? config_forks[ZBX_PROCESS_TYPE_HISTSYNCER] : 0,
+			&config_trends_cache_size, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize database cache: %s", error);
 		zbx_free(error);
@@ -1830,6 +1894,13 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 
 	zbx_vps_monitor_init(config_vps_limit, config_vps_overcommit_limit);
 
+	if (SUCCEED != zbx_init_escalation_shards(config_escalator_shards, config_escalator_shard_batch_size, &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize escalation shards: %s", error);
+		zbx_free(error);
+		return FAIL;
+	}
+
 	if (0 != config_forks[ZBX_PROCESS_TYPE_VMWARE] && SUCCEED != zbx_vmware_init(&config_vmware_cache_size, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize VMware cache: %s", error);
@@ -2059,6 +2130,7 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 				zbx_thread_start(lld_manager_thread, &thread_args, &zbx_threads[i]);
 				break;
 			case ZBX_PROCESS_TYPE_LLDWORKER:
+				thread_args.args = &lld_worker_args;
 				zbx_thread_start(lld_worker_thread, &thread_args, &zbx_threads[i]);
 				break;
 			case ZBX_PROCESS_TYPE_ALERTSYNCER:
@@ -2231,6 +2303,7 @@ static void	server_teardown(zbx_rtc_t *rtc, zbx_socket_t *listen_sock)
 	zbx_free_configuration_cache();
 	zbx_free_database_cache(ZBX_SYNC_NONE, &events_cbs, config_history_storage_pipelines);
 	zbx_deinit_remote_commands_cache();
+	zbx_deinit_escalation_shards();
 	zbx_db_clear_idcache();
 
 #ifdef HAVE_PTHREAD_PROCESS_SHARED
@@ -2417,6 +2490,10 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		zabbix_log(LOG_LEVEL_CRIT, "cannot disable core dump, exiting...");
 		exit(EXIT_FAILURE);
 	}
+#endif
+#if defined(HAVE_OPENSSL)
+	/* session tickets issued by one process must be accepted by the others */
+	zbx_tls_generate_ticket_keys();
 #endif
 	zbx_initialize_events();
 
@@ -2485,7 +2562,9 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 	}
 
 	if (SUCCEED != zbx_init_database_cache(get_zbx_program_type, zbx_sync_history_cache_server,
-			config_history_cache_size, config_history_index_cache_size, &config_trends_cache_size, &error))
+			config_history_cache_size, config_history_index_cache_size, config_history_cache_partitions,
+			0 != config_parallel_trend_flush ? config_forks[ZBX_PROCESS_TYPE_HISTSYNCER] : 0,
+			&config_trends_cache_size, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize database cache: %s", error);
 		zbx_free(error);
@@ -2524,7 +2603,7 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		exit(EXIT_FAILURE);
 	}
 
-	if (SUCCEED != zbx_init_selfmon_collector(get_config_forks, &error))
+	if (SUCCEED != zbx_init_selfmon_collector(get_config_forks, get_selfmon_counters, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize self-monitoring: %s", error);
 		zbx_free(error);
@@ -1374,7 +1374,7 @@ static zbx_service_update_t	*update_service(zbx_hashset_t *service_updates, zbx_
 	}
 
 	update->ts = *ts;
-	service->status = status;
+	service_set_status(service, status);
 
 	return update;
 }
@@ -1687,89 +1687,126 @@ static int	services_get_weight(const zbx_vector_service_ptr_t *services)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: gets service status according to specified rule                   *
+ * Purpose: gets minimum status of children counted by service status rule    *
  *                                                                            *
- * Parameters: service - [IN]                                                 *
- *             rule    - [IN] service status rule                             *
+ * Parameters: rule         - [IN] service status rule                        *
+ *             status_limit - [OUT]                                           *
  *                                                                            *
- *  Return value: service status                                              *
+ * Return value: SUCCEED - status limit was returned                          *
+ *               FAIL    - unknown rule type                                  *
  *                                                                            *
  ******************************************************************************/
-int	service_get_rule_status(const zbx_service_t *service, const zbx_service_rule_t *rule)
+static int	service_rule_get_status_limit(const zbx_service_rule_t *rule, int *status_limit)
 {
-	zbx_vector_service_ptr_t	children;
-	int				status = ZBX_SERVICE_STATUS_OK, status_limit, total_num, total_weight, weight;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() service:" ZBX_FS_UI64 ", rule:" ZBX_FS_UI64, __func__, service->serviceid,
-			rule->service_ruleid);
-
-	zbx_vector_service_ptr_create(&children);
-
 	switch (rule->type)
 	{
 		case ZBX_SERVICE_STATUS_RULE_TYPE_N_GE:
 		case ZBX_SERVICE_STATUS_RULE_TYPE_NP_GE:
 		case ZBX_SERVICE_STATUS_RULE_TYPE_W_GE:
 		case ZBX_SERVICE_STATUS_RULE_TYPE_WP_GE:
-			status_limit = rule->limit_status;
-			break;
+			*status_limit = rule->limit_status;
+			return SUCCEED;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_N_L:
 		case ZBX_SERVICE_STATUS_RULE_TYPE_NP_L:
 		case ZBX_SERVICE_STATUS_RULE_TYPE_W_L:
 		case ZBX_SERVICE_STATUS_RULE_TYPE_WP_L:
-			status_limit = rule->limit_status + 1;
-			break;
+			*status_limit = rule->limit_status + 1;
+			return SUCCEED;
 		default:
 			THIS_SHOULD_NEVER_HAPPEN;
-			goto out;
+			return FAIL;
 	}
+}
 
-	service_get_children_by_status(service, status_limit, &children, &total_weight, &total_num);
-
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if service status rule is met                              *
+ *                                                                            *
+ * Parameters: rule         - [IN] service status rule                        *
+ *             num          - [IN] number of children counted by rule         *
+ *             weight       - [IN] weight of children counted by rule         *
+ *             total_num    - [IN] number of all not ignored children         *
+ *             total_weight - [IN] weight of all not ignored children         *
+ *                                                                            *
+ * Return value: SUCCEED - rule is met                                        *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	service_rule_match(const zbx_service_rule_t *rule, int num, int weight, int total_num,
+		int total_weight)
+{
 	switch (rule->type)
 	{
 		case ZBX_SERVICE_STATUS_RULE_TYPE_N_GE:
-			if (children.values_num < rule->limit_value)
-				goto out;
+			if (num < rule->limit_value)
+				return FAIL;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_NP_GE:
-			if (0 == total_num || children.values_num * 100 / total_num < rule->limit_value)
-				goto out;
+			if (0 == total_num || num * 100 / total_num < rule->limit_value)
+				return FAIL;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_N_L:
-			if (total_num - children.values_num >= rule->limit_value)
-				goto out;
+			if (total_num - num >= rule->limit_value)
+				return FAIL;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_NP_L:
-			if (0 == total_num || (total_num - children.values_num) * 100 / total_num >= rule->limit_value)
-				goto out;
+			if (0 == total_num || (total_num - num) * 100 / total_num >= rule->limit_value)
+				return FAIL;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_W_GE:
-			weight = services_get_weight(&children);
 			if (weight < rule->limit_value)
-				goto out;
+				return FAIL;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_WP_GE:
-			weight = services_get_weight(&children);
 			if (0 == total_weight || weight * 100 / total_weight < rule->limit_value)
-				goto out;
+				return FAIL;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_W_L:
-			weight = services_get_weight(&children);
 			if (total_weight - weight >= rule->limit_value)
-				goto out;
+				return FAIL;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_WP_L:
-			weight = services_get_weight(&children);
 			if (0 == total_weight || (total_weight - weight) * 100 / total_weight >= rule->limit_value)
-				goto out;
+				return FAIL;
 			break;
 		default:
 			THIS_SHOULD_NEVER_HAPPEN;
-			goto out;
+			return FAIL;
 	}
 
-	status = rule->new_status;
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets service status according to specified rule                   *
+ *                                                                            *
+ * Parameters: service - [IN]                                                 *
+ *             rule    - [IN] service status rule                             *
+ *                                                                            *
+ *  Return value: service status                                              *
+ *                                                                            *
+ ******************************************************************************/
+int	service_get_rule_status(const zbx_service_t *service, const zbx_service_rule_t *rule)
+{
+	zbx_vector_service_ptr_t	children;
+	int				status = ZBX_SERVICE_STATUS_OK, status_limit, total_num, total_weight;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() service:" ZBX_FS_UI64 ", rule:" ZBX_FS_UI64, __func__, service->serviceid,
+			rule->service_ruleid);
+
+	zbx_vector_service_ptr_create(&children);
+
+	if (SUCCEED != service_rule_get_status_limit(rule, &status_limit))
+		goto out;
+
+	service_get_children_by_status(service, status_limit, &children, &total_weight, &total_num);
+
+	if (SUCCEED == service_rule_match(rule, children.values_num, services_get_weight(&children), total_num,
+			total_weight))
+	{
+		status = rule->new_status;
+	}
 out:
 	zbx_vector_service_ptr_destroy(&children);
 
@@ -1778,6 +1815,325 @@ out:
 	return status;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds or removes service propagated status from status counters    *
+ *          of its parents                                                    *
+ *                                                                            *
+ * Parameters: service - [IN]                                                 *
+ *             sign    - [IN] 1 - add status, -1 - remove status              *
+ *                                                                            *
+ ******************************************************************************/
+static void	service_update_parents_status_index(const zbx_service_t *service, int sign)
+{
+	int	status;
+
+	if (SUCCEED != service_get_status(service, &status))
+		return;
+
+	status -= ZBX_SERVICE_STATUS_OK;
+
+	if (0 > status || ZBX_SERVICE_STATUS_NUM <= status)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return;
+	}
+
+	for (int i = 0; i < service->parents.values_num; i++)
+	{
+		zbx_service_t	*parent = service->parents.values[i];
+
+		parent->children_status_num[status] += sign;
+		parent->children_status_weight[status] += sign * service->weight;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: rebuilds children status counters and levels of all services      *
+ *                                                                            *
+ * Parameters: services - [IN/OUT]                                            *
+ *                                                                            *
+ * Comments: Must be called after service links or service propagation        *
+ *           settings have been changed. Afterwards service statuses must     *
+ *           be changed with service_set_status() to keep counters valid.     *
+ *                                                                            *
+ ******************************************************************************/
+void	services_build_status_index(zbx_hashset_t *services)
+{
+	zbx_hashset_iter_t		iter;
+	zbx_service_t			*service;
+	zbx_vector_service_ptr_t	queue;
+	zbx_hashset_t			pending;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	zbx_vector_service_ptr_create(&queue);
+	zbx_hashset_create(&pending, (size_t)services->num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	zbx_hashset_iter_reset(services, &iter);
+	while (NULL != (service = (zbx_service_t *)zbx_hashset_iter_next(&iter)))
+	{
+		memset(service->children_status_num, 0, sizeof(service->children_status_num));
+		memset(service->children_status_weight, 0, sizeof(service->children_status_weight));
+		service->level = 0;
+	}
+
+	zbx_hashset_iter_reset(services, &iter);
+	while (NULL != (service = (zbx_service_t *)zbx_hashset_iter_next(&iter)))
+	{
+		service_update_parents_status_index(service, 1);
+
+		if (0 == service->children.values_num)
+		{
+			zbx_vector_service_ptr_append(&queue, service);
+		}
+		else
+		{
+			zbx_uint64_pair_t	pair = {.first = service->serviceid,
+						.second = (zbx_uint64_t)service->children.values_num};
+
+			zbx_hashset_insert(&pending, &pair, sizeof(pair));
+		}
+	}
+
+	/* set levels from leaves up, a parent is reached after levels of all its children are known */
+	for (int i = 0; i < queue.values_num; i++)
+	{
+		service = queue.values[i];
+
+		for (int j = 0; j < service->parents.values_num; j++)
+		{
+			zbx_service_t		*parent = service->parents.values[j];
+			zbx_uint64_pair_t	*pair, pair_local = {.first = parent->serviceid};
+
+			if (parent->level <= service->level)
+				parent->level = service->level + 1;
+
+			if (NULL != (pair = (zbx_uint64_pair_t *)zbx_hashset_search(&pending, &pair_local)) &&
+					0 == --pair->second)
+			{
+				zbx_vector_service_ptr_append(&queue, parent);
+			}
+		}
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() services:%d ordered:%d", __func__, services->num_data,
+			queue.values_num);
+
+	zbx_hashset_destroy(&pending);
+	zbx_vector_service_ptr_destroy(&queue);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets service status and updates status counters of its parents    *
+ *                                                                            *
+ ******************************************************************************/
+void	service_set_status(zbx_service_t *service, int status)
+{
+	if (service->status == status)
+		return;
+
+	service_update_parents_status_index(service, -1);
+	service->status = status;
+	service_update_parents_status_index(service, 1);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets service status by applying main service status algorithm     *
+ *          to children status counters                                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	service_get_indexed_main_status(const zbx_service_t *service)
+{
+	switch (service->algorithm)
+	{
+		case ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ALL:
+			if (0 != service->children_status_num[ZBX_SERVICE_STATUS_OK - ZBX_SERVICE_STATUS_OK])
+				return ZBX_SERVICE_STATUS_OK;
+			ZBX_FALLTHROUGH;
+		case ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ONE:
+			for (int i = ZBX_SERVICE_STATUS_NUM - 1; 0 < i; i--)
+			{
+				if (0 != service->children_status_num[i])
+					return i + ZBX_SERVICE_STATUS_OK;
+			}
+			break;
+		case ZBX_SERVICE_STATUS_CALC_SET_OK:
+			break;
+		default:
+			zabbix_log(LOG_LEVEL_ERR, "unknown calculation algorithm of service status [%d]",
+					service->algorithm);
+			break;
+	}
+
+	return ZBX_SERVICE_STATUS_OK;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets service status according to specified rule by applying it    *
+ *          to children status counters                                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	service_get_indexed_rule_status(const zbx_service_t *service, const zbx_service_rule_t *rule)
+{
+	int	status_limit, num = 0, weight = 0, total_num = 0, total_weight = 0;
+
+	if (SUCCEED != service_rule_get_status_limit(rule, &status_limit))
+		return ZBX_SERVICE_STATUS_OK;
+
+	for (int i = 0; i < ZBX_SERVICE_STATUS_NUM; i++)
+	{
+		total_num += service->children_status_num[i];
+		total_weight += service->children_status_weight[i];
+
+		if (i + ZBX_SERVICE_STATUS_OK >= status_limit)
+		{
+			num += service->children_status_num[i];
+			weight += service->children_status_weight[i];
+		}
+	}
+
+	if (SUCCEED != service_rule_match(rule, num, weight, total_num, total_weight))
+		return ZBX_SERVICE_STATUS_OK;
+
+	return rule->new_status;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates status of service with children                        *
+ *                                                                            *
+ * Parameters: service - [IN]                                                 *
+ *                                                                            *
+ * Return value: service status                                               *
+ *                                                                            *
+ * Comments: The status is calculated from children status counters without   *
+ *           walking children, see services_build_status_index().             *
+ *                                                                            *
+ ******************************************************************************/
+int	service_calculate_status(const zbx_service_t *service)
+{
+	int	status, rule_status;
+
+	status = service_get_indexed_main_status(service);
+
+	for (int i = 0; i < service->status_rules.values_num; i++)
+	{
+		if (status < (rule_status = service_get_indexed_rule_status(service, service->status_rules.values[i])))
+			status = rule_status;
+	}
+
+	return status;
+}
+
+typedef struct
+{
+	zbx_service_t	*service;
+	zbx_timespec_t	ts;
+	int		flags;
+}
+zbx_service_propagation_entry_t;
+
+static int	service_propagation_compare(const void *d1, const void *d2)
+{
+	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
+	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(e1->key, e2->key);
+
+	return 0;
+}
+
+void	service_propagation_init(zbx_service_propagation_t *propagation)
+{
+	zbx_hashset_create(&propagation->services, 100, ZBX_DEFAULT_PTR_HASH_FUNC, ZBX_DEFAULT_PTR_COMPARE_FUNC);
+	zbx_binary_heap_create(&propagation->queue, service_propagation_compare, ZBX_BINARY_HEAP_OPTION_EMPTY);
+}
+
+void	service_propagation_destroy(zbx_service_propagation_t *propagation)
+{
+	zbx_binary_heap_destroy(&propagation->queue);
+	zbx_hashset_destroy(&propagation->services);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: queues parents of service for status recalculation                *
+ *                                                                            *
+ * Parameters: propagation - [IN/OUT]                                         *
+ *             service     - [IN] service with changed status                 *
+ *             ts          - [IN] status change timestamp                     *
+ *             flags       - [IN] service update flags                        *
+ *                                                                            *
+ * Comments: Each service is queued once during propagation. If several       *
+ *           children change, the latest timestamp and all flags are kept.    *
+ *                                                                            *
+ ******************************************************************************/
+void	service_propagation_add_parents(zbx_service_propagation_t *propagation, const zbx_service_t *service,
+		const zbx_timespec_t *ts, int flags)
+{
+	for (int i = 0; i < service->parents.values_num; i++)
+	{
+		zbx_service_propagation_entry_t	*entry, entry_local = {.service = service->parents.values[i]};
+		zbx_binary_heap_elem_t		elem;
+
+		if (NULL != (entry = (zbx_service_propagation_entry_t *)zbx_hashset_search(&propagation->services,
+				&entry_local)))
+		{
+			if (0 > zbx_timespec_compare(&entry->ts, ts))
+				entry->ts = *ts;
+
+			entry->flags |= flags;
+			continue;
+		}
+
+		entry_local.ts = *ts;
+		entry_local.flags = flags;
+		entry = (zbx_service_propagation_entry_t *)zbx_hashset_insert(&propagation->services, &entry_local,
+				sizeof(entry_local));
+
+		elem.key = (zbx_uint64_t)entry->service->level;
+		elem.data = entry;
+		zbx_binary_heap_insert(&propagation->queue, &elem);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets next queued service for status recalculation                 *
+ *                                                                            *
+ * Parameters: propagation - [IN/OUT]                                         *
+ *             ts          - [OUT] latest status change timestamp of children *
+ *             flags       - [OUT] service update flags                       *
+ *                                                                            *
+ * Return value: queued service with the lowest level or NULL if queue is     *
+ *               empty                                                        *
+ *                                                                            *
+ * Comments: Services are returned children before parents, so every service  *
+ *           is recalculated once after all its changed children.             *
+ *                                                                            *
+ ******************************************************************************/
+zbx_service_t	*service_propagation_next(zbx_service_propagation_t *propagation, zbx_timespec_t *ts, int *flags)
+{
+	zbx_service_propagation_entry_t	*entry;
+
+	if (SUCCEED == zbx_binary_heap_empty(&propagation->queue))
+		return NULL;
+
+	entry = (zbx_service_propagation_entry_t *)zbx_binary_heap_find_min(&propagation->queue)->data;
+	zbx_binary_heap_remove_min(&propagation->queue);
+
+	*ts = entry->ts;
+	*flags = entry->flags;
+
+	return entry->service;
+}
+
 typedef struct
 {
 	zbx_service_t	*service;
@@ -1998,35 +2354,28 @@ void	service_get_rootcause_eventids(const zbx_service_t *parent, zbx_vector_uint
 
 /******************************************************************************
  *                                                                            *
- * Purpose: updates service and its parents statuses                          *
+ * Purpose: updates service status                                            *
  *                                                                            *
  * Parameters: itservice       - [IN] service to update                       *
  *             ts              - [IN] update timestamp                        *
  *             alarms          - [OUT] alarms update queue                    *
  *             service_updates - [IN/OUT]                                     *
  *             flags           - [IN]                                         *
- *                                                                            *
+ *             propagation     - [IN/OUT] services queued for recalculation   *
  *                                                                            *
  * Comments: This function recalculates service status according to the       *
  *           algorithm and status of the children services. If the status     *
  *           has been changed, an alarm is generated and parent services      *
- *           (up until the root service) are updated too.                     *
+ *           are queued for recalculation too.                                *
  *                                                                            *
  ******************************************************************************/
 static void	its_itservice_update_status(zbx_service_t *itservice, const zbx_timespec_t *ts,
-		zbx_vector_status_update_ptr_t *alarms, zbx_hashset_t *service_updates, int flags)
+		zbx_vector_status_update_ptr_t *alarms, zbx_hashset_t *service_updates, int flags,
+		zbx_service_propagation_t *propagation)
 {
-	int	status, rule_status;
-
-	status = service_get_main_status(itservice);
+	int	status;
 
-	for (int i = 0; i < itservice->status_rules.values_num; i++)
-	{
-		zbx_service_rule_t	*rule = itservice->status_rules.values[i];
-
-		if (status < (rule_status = service_get_rule_status(itservice, rule)))
-			status = rule_status;
-	}
+	status = service_calculate_status(itservice);
 
 	if (itservice->status != status)
 	{
@@ -2035,22 +2384,10 @@ static void	its_itservice_update_status(zbx_service_t *itservice, const zbx_time
 		update = update_service(service_updates, itservice, status, ts);
 		update->alarm = its_updates_append(alarms, itservice->serviceid, status, ts->sec);
 
-		/* update parent services */
-		for (int i = 0; i < itservice->parents.values_num; i++)
-		{
-			its_itservice_update_status(itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
-		}
+		service_propagation_add_parents(propagation, itservice, ts, flags);
 	}
 	else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & flags))
-	{
-		/* update parent services */
-		for (int i = 0; i < itservice->parents.values_num; i++)
-		{
-			its_itservice_update_status((zbx_service_t *)itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
-		}
-	}
+		service_propagation_add_parents(propagation, itservice, ts, flags);
 }
 
 static char	*service_get_event_name(zbx_service_manager_t *manager, const char *name, int status)
@@ -2574,6 +2911,10 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	zbx_vector_service_problem_ptr_t	service_problems_new;
 	zbx_vector_uint64_t			service_problemids;
 	zbx_hashset_t				service_updates;
+	zbx_service_propagation_t		propagation;
+	zbx_service_t				*service;
+	zbx_timespec_t				ts;
+	int					flags;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -2581,14 +2922,17 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	zbx_vector_service_problem_ptr_create(&service_problems_new);
 	zbx_vector_uint64_create(&service_problemids);
 	zbx_hashset_create(&service_updates, 100, service_update_hash_func, service_update_compare_func);
+	service_propagation_init(&propagation);
 
 	zbx_hashset_iter_reset(&manager->service_diffs, &iter);
 
 	while (NULL != (service_diff = (zbx_services_diff_t *)zbx_hashset_iter_next(&iter)))
 	{
-		zbx_service_t	service_local = {.serviceid = service_diff->serviceid}, *service;
+		zbx_service_t	service_local = {.serviceid = service_diff->serviceid};
 		int		status = ZBX_SERVICE_STATUS_OK;
-		zbx_timespec_t	ts = {0, 0};
+
+		ts.sec = 0;
+		ts.ns = 0;
 
 		service = zbx_hashset_search(&manager->services, &service_local);
 
@@ -2704,24 +3048,16 @@ static void	db_update_services(zbx_service_manager_t *manager)
 			update = update_service(&service_updates, service, status, &ts);
 			update->alarm = its_updates_append(&alarms, service->serviceid, service->status, ts.sec);
 
-			/* update parent services */
-			for (int i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
+			service_propagation_add_parents(&propagation, service, &ts, service_diff->flags);
 		}
 		else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & service_diff->flags))
-		{
-			/* update parent services */
-			for (int i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
-		}
+			service_propagation_add_parents(&propagation, service, &ts, service_diff->flags);
 	}
 
+	/* update parent services, each of them once after all its changed children */
+	while (NULL != (service = service_propagation_next(&propagation, &ts, &flags)))
+		its_itservice_update_status(service, &ts, &alarms, &service_updates, flags, &propagation);
+
 	do
 	{
 		zbx_db_begin();
@@ -2732,6 +3068,7 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	}
 	while (ZBX_DB_DOWN == zbx_db_commit());
 
+	service_propagation_destroy(&propagation);
 	zbx_vector_uint64_destroy(&service_problemids);
 	zbx_vector_service_problem_ptr_destroy(&service_problems_new);
 	zbx_hashset_destroy(&service_updates);
@@ -3643,6 +3980,9 @@ ZBX_THREAD_ENTRY(service_manager_thread, args)
 			}
 			while (ZBX_DB_DOWN == zbx_db_commit());
 
+			/* service links are reloaded during sync */
+			services_build_status_index(&service_manager.services);
+
 			if (0 != updated)
 				recalculate_services(&service_manager);
 
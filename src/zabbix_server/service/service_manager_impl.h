@@ -17,9 +17,13 @@
 
 #include "zbxalgo.h"
 #include "zbxtime.h"
+#include "zbx_trigger_constants.h"
 
 #define ZBX_SERVICE_STATUS_OK		-1
 
+/* number of service statuses - OK and trigger severities */
+#define ZBX_SERVICE_STATUS_NUM		(TRIGGER_SEVERITY_COUNT + 1)
+
 #define ZBX_SERVICE_STATUS_PROPAGATION_AS_IS	0
 #define ZBX_SERVICE_STATUS_PROPAGATION_INCREASE	1
 #define ZBX_SERVICE_STATUS_PROPAGATION_DECREASE	2
@@ -108,6 +112,14 @@ struct zbx_service_s
 	int					weight;
 	int					propagation_rule;
 	int					propagation_value;
+
+	/* number and weight of not ignored children by their propagated status, */
+	/* indexed by status - ZBX_SERVICE_STATUS_OK                              */
+	int					children_status_num[ZBX_SERVICE_STATUS_NUM];
+	int					children_status_weight[ZBX_SERVICE_STATUS_NUM];
+
+	/* service height above its deepest leaf, parents are always higher than children */
+	int					level;
 };
 
 /* status update queue items */
@@ -167,9 +179,27 @@ zbx_service_action_t;
 
 ZBX_PTR_VECTOR_DECL(service_action_ptr, zbx_service_action_t *)
 
+/* services queued for status recalculation, ordered by their level */
+typedef struct
+{
+	zbx_hashset_t		services;
+	zbx_binary_heap_t	queue;
+}
+zbx_service_propagation_t;
+
 int	service_get_status(const zbx_service_t	*service, int *status);
 int	service_get_main_status(const zbx_service_t *service);
 int	service_get_rule_status(const zbx_service_t *service, const zbx_service_rule_t *rule);
 void	service_get_rootcause_eventids(const zbx_service_t *parent, zbx_vector_uint64_t *eventids);
 
+void	services_build_status_index(zbx_hashset_t *services);
+void	service_set_status(zbx_service_t *service, int status);
+int	service_calculate_status(const zbx_service_t *service);
+
+void	service_propagation_init(zbx_service_propagation_t *propagation);
+void	service_propagation_destroy(zbx_service_propagation_t *propagation);
+void	service_propagation_add_parents(zbx_service_propagation_t *propagation, const zbx_service_t *service,
+		const zbx_timespec_t *ts, int flags);
+zbx_service_t	*service_propagation_next(zbx_service_propagation_t *propagation, zbx_timespec_t *ts, int *flags);
+
 #endif
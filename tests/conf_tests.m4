@@ -55,11 +55,14 @@ AC_DEFUN([CONF_TESTS],
 			tests/test_zbxcommon/Makefile
 			tests/libs/zbxcomms/Makefile
 			tests/libs/zbxcommshigh/Makefile
+			tests/libs/zbxcompress/Makefile
 			tests/libs/zbxcfg/Makefile
 			tests/libs/zbxcachevalue/Makefile
 			tests/libs/zbxcacheconfig/Makefile
+			tests/libs/zbxcachehistory/Makefile
 			tests/libs/zbxdb/Makefile
 			tests/libs/zbxdbhigh/Makefile
+			tests/libs/zbxescalations/Makefile
 			tests/libs/zbxeval/Makefile
 			tests/libs/zbxexpr/Makefile
 			tests/libs/zbxfile/Makefile
@@ -87,6 +90,7 @@ AC_DEFUN([CONF_TESTS],
 			tests/libs/zbxodbc/Makefile
 			tests/libs/zbxip/Makefile
 			tests/zabbix_server/Makefile
+			tests/zabbix_server/escalator/Makefile
 			tests/zabbix_server/pinger/Makefile
 			tests/zabbix_server/service/Makefile
 			tests/zabbix_server/trapper/Makefile
@@ -0,0 +1,235 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/libs/zbxcachehistory/cachehistory.c"
+
+/* trend row written by upsert */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	int		num;
+	char		avg[ZBX_MAX_DOUBLE_LEN + 1];
+}
+zbx_mock_trend_row_t;
+
+static unsigned char		mock_value_type;
+static int			mock_execute_result;
+static char			*mock_clause;
+static zbx_mock_trend_row_t	mock_rows[16];
+static int			mock_rows_num;
+
+void	__wrap_zbx_db_insert_prepare(zbx_db_insert_t *self, const char *table, ...);
+void	__wrap_zbx_db_insert_clause(zbx_db_insert_t *self, const char *clause);
+void	__wrap_zbx_db_insert_add_values(zbx_db_insert_t *self, ...);
+int	__wrap_zbx_db_insert_execute(zbx_db_insert_t *self);
+void	__wrap_zbx_db_insert_clean(zbx_db_insert_t *self);
+
+void	__wrap_zbx_db_insert_prepare(zbx_db_insert_t *self, const char *table, ...)
+{
+	ZBX_UNUSED(self);
+	ZBX_UNUSED(table);
+}
+
+void	__wrap_zbx_db_insert_clause(zbx_db_insert_t *self, const char *clause)
+{
+	ZBX_UNUSED(self);
+
+	mock_clause = zbx_strdup(mock_clause, clause);
+}
+
+void	__wrap_zbx_db_insert_add_values(zbx_db_insert_t *self, ...)
+{
+	va_list			args;
+	zbx_mock_trend_row_t	*row;
+
+	ZBX_UNUSED(self);
+
+	if (ARRSIZE(mock_rows) == mock_rows_num)
+		fail_msg("too many trend rows");
+
+	row = &mock_rows[mock_rows_num++];
+
+	va_start(args, self);
+
+	row->itemid = va_arg(args, zbx_uint64_t);
+	(void)va_arg(args, int);
+	row->num = va_arg(args, int);
+
+	if (ITEM_VALUE_TYPE_FLOAT == mock_value_type)
+	{
+		(void)va_arg(args, double);
+		zbx_snprintf(row->avg, sizeof(row->avg), ZBX_FS_DBL, va_arg(args, double));
+	}
+	else
+	{
+		(void)va_arg(args, zbx_uint64_t);
+		zbx_snprintf(row->avg, sizeof(row->avg), ZBX_FS_UI64, va_arg(args, zbx_uint64_t));
+	}
+
+	va_end(args);
+}
+
+int	__wrap_zbx_db_insert_execute(zbx_db_insert_t *self)
+{
+	ZBX_UNUSED(self);
+
+	return mock_execute_result;
+}
+
+void	__wrap_zbx_db_insert_clean(zbx_db_insert_t *self)
+{
+	ZBX_UNUSED(self);
+}
+
+static unsigned char	str_to_value_type(const char *str)
+{
+	if (0 == strcmp(str, "FLOAT"))
+		return ITEM_VALUE_TYPE_FLOAT;
+
+	if (0 == strcmp(str, "UINT64"))
+		return ITEM_VALUE_TYPE_UINT64;
+
+	fail_msg("unsupported trend value type '%s'", str);
+
+	return ITEM_VALUE_TYPE_NONE;
+}
+
+static void	read_trends(ZBX_DC_TREND *trends, int *trends_num, int trends_alloc)
+{
+	zbx_mock_handle_t	htrends, htrend;
+	zbx_mock_error_t	err;
+
+	htrends = zbx_mock_get_parameter_handle("in.trends");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(htrends, &htrend)))
+	{
+		ZBX_DC_TREND	*trend;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read trend: %s", zbx_mock_error_string(err));
+
+		if (trends_alloc == *trends_num)
+			fail_msg("too many trends");
+
+		trend = &trends[(*trends_num)++];
+		memset(trend, 0, sizeof(ZBX_DC_TREND));
+		trend->itemid = zbx_mock_get_object_member_uint64(htrend, "itemid");
+		trend->clock = zbx_mock_get_object_member_int(htrend, "clock");
+		trend->num = zbx_mock_get_object_member_int(htrend, "num");
+		trend->disable_from = zbx_mock_get_object_member_int(htrend, "disable_from");
+		trend->value_type = mock_value_type;
+
+		/* unsigned trends keep sum of values instead of average until written */
+		if (ITEM_VALUE_TYPE_FLOAT == mock_value_type)
+		{
+			trend->value_min.dbl = atof(zbx_mock_get_object_member_string(htrend, "min"));
+			trend->value_avg.dbl = atof(zbx_mock_get_object_member_string(htrend, "avg"));
+			trend->value_max.dbl = atof(zbx_mock_get_object_member_string(htrend, "max"));
+		}
+		else
+		{
+			trend->value_min.ui64 = zbx_mock_get_object_member_uint64(htrend, "min");
+			trend->value_avg.ui64.lo = zbx_mock_get_object_member_uint64(htrend, "sum");
+			trend->value_max.ui64 = zbx_mock_get_object_member_uint64(htrend, "max");
+		}
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	ZBX_DC_TREND			trends[16];
+	int				trends_num = 0;
+	zbx_vector_uint64_pair_t	trends_diff;
+	zbx_mock_handle_t		hrows, hrow, hdiffs, hdiff;
+	zbx_mock_error_t		err;
+	char				msg[64];
+	int				i;
+#if defined(HAVE_POSTGRESQL)
+	const char			*clause_path = "out.clause.postgresql";
+#elif defined(HAVE_MYSQL)
+	const char			*clause_path = "out.clause.mysql";
+#endif
+
+	ZBX_UNUSED(state);
+
+#if !defined(HAVE_POSTGRESQL) && !defined(HAVE_MYSQL)
+	skip();
+#else
+	trends_flush_upsert = 1;
+	mock_value_type = str_to_value_type(zbx_mock_get_parameter_string("in.value_type"));
+	mock_execute_result = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("in.execute"));
+
+	read_trends(trends, &trends_num, (int)ARRSIZE(trends));
+
+	zbx_vector_uint64_pair_create(&trends_diff);
+
+	zbx_db_flush_trends(trends, &trends_num, &trends_diff, ZBX_DC_SYNC_TREND_MODE_NORMAL);
+
+	if (NULL == mock_clause || NULL == strstr(mock_clause, zbx_mock_get_parameter_string(clause_path)))
+		fail_msg("unexpected merge clause '%s'", ZBX_NULL2EMPTY_STR(mock_clause));
+
+	hrows = zbx_mock_get_parameter_handle("out.rows");
+
+	for (i = 0; ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hrows, &hrow)); i++)
+	{
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read row: %s", zbx_mock_error_string(err));
+
+		if (i == mock_rows_num)
+			fail_msg("expected more than %d rows", mock_rows_num);
+
+		zbx_snprintf(msg, sizeof(msg), "row #%d itemid", i + 1);
+		zbx_mock_assert_uint64_eq(msg, zbx_mock_get_object_member_uint64(hrow, "itemid"),
+				mock_rows[i].itemid);
+
+		zbx_snprintf(msg, sizeof(msg), "row #%d num", i + 1);
+		zbx_mock_assert_int_eq(msg, zbx_mock_get_object_member_int(hrow, "num"), mock_rows[i].num);
+
+		zbx_snprintf(msg, sizeof(msg), "row #%d avg", i + 1);
+		zbx_mock_assert_str_eq(msg, zbx_mock_get_object_member_string(hrow, "avg"), mock_rows[i].avg);
+	}
+
+	zbx_mock_assert_int_eq("rows", i, mock_rows_num);
+
+	hdiffs = zbx_mock_get_parameter_handle("out.trends_diff");
+
+	for (i = 0; ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hdiffs, &hdiff)); i++)
+	{
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read trend change: %s", zbx_mock_error_string(err));
+
+		if (i == trends_diff.values_num)
+			fail_msg("expected more than %d trend changes", trends_diff.values_num);
+
+		zbx_snprintf(msg, sizeof(msg), "trend change #%d itemid", i + 1);
+		zbx_mock_assert_uint64_eq(msg, zbx_mock_get_object_member_uint64(hdiff, "itemid"),
+				trends_diff.values[i].first);
+
+		zbx_snprintf(msg, sizeof(msg), "trend change #%d disable_from", i + 1);
+		zbx_mock_assert_uint64_eq(msg, zbx_mock_get_object_member_uint64(hdiff, "disable_from"),
+				trends_diff.values[i].second);
+	}
+
+	zbx_mock_assert_int_eq("trend changes", i, trends_diff.values_num);
+	zbx_mock_assert_int_eq("trends left", zbx_mock_get_parameter_int("out.trends_left"), trends_num);
+
+	zbx_vector_uint64_pair_destroy(&trends_diff);
+	zbx_free(mock_clause);
+#endif
+}
@@ -0,0 +1,189 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/libs/zbxcomms/tls_openssl.c"
+
+#if defined(ZBX_TLS_SESSION_RESUMPTION)
+#include <openssl/x509.h>
+
+static int	verify_any_cb(int preverify_ok, X509_STORE_CTX *ctx)
+{
+	ZBX_UNUSED(preverify_ok);
+	ZBX_UNUSED(ctx);
+
+	return 1;
+}
+
+/* self-signed certificate is enough, peer certificates are not verified by the test */
+static void	ctx_set_certificate(SSL_CTX *ctx)
+{
+	EVP_PKEY_CTX	*pctx;
+	EVP_PKEY	*pkey = NULL;
+	X509		*cert;
+
+	pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+
+	if (NULL == pctx || 1 != EVP_PKEY_keygen_init(pctx) ||
+			1 != EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pctx, NID_X9_62_prime256v1) ||
+			1 != EVP_PKEY_keygen(pctx, &pkey))
+	{
+		fail_msg("cannot generate key");
+	}
+
+	EVP_PKEY_CTX_free(pctx);
+
+	cert = X509_new();
+	ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+	X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+	X509_gmtime_adj(X509_getm_notAfter(cert), SEC_PER_DAY);
+	X509_set_pubkey(cert, pkey);
+	X509_NAME_add_entry_by_txt(X509_get_subject_name(cert), "CN", MBSTRING_ASC, (const unsigned char *)"test",
+			-1, -1, 0);
+	X509_set_issuer_name(cert, X509_get_subject_name(cert));
+
+	if (0 == X509_sign(cert, pkey, EVP_sha256()))
+		fail_msg("cannot sign certificate");
+
+	if (1 != SSL_CTX_use_certificate(ctx, cert) || 1 != SSL_CTX_use_PrivateKey(ctx, pkey))
+		fail_msg("cannot set certificate");
+
+	X509_free(cert);
+	EVP_PKEY_free(pkey);
+}
+
+static SSL_CTX	*server_ctx_create(void)
+{
+	SSL_CTX	*ctx;
+
+	if (NULL == (ctx = SSL_CTX_new(TLS_server_method())))
+		fail_msg("cannot create server context");
+
+	ctx_set_certificate(ctx);
+	SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, verify_any_cb);
+
+	/* resume from tickets only, like processes not sharing session cache */
+	SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+	zbx_ctx_enable_tickets(ctx);
+
+	/* same as set by zbx_tls_accept(), required to resume sessions with verified peer */
+	if (1 != SSL_CTX_set_session_id_context(ctx, (const unsigned char *)"Zbx", 3))
+		fail_msg("cannot set session id context");
+
+	return ctx;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: connects client and server over memory buffers, reads data sent   *
+ *          by server so the client receives session ticket                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	tls_connect(SSL *client, SSL *server)
+{
+	BIO	*client_bio, *server_bio;
+	int	i, client_done = 0, server_done = 0;
+	char	buf[1];
+
+	if (1 != BIO_new_bio_pair(&client_bio, 0, &server_bio, 0))
+		fail_msg("cannot create BIO pair");
+
+	SSL_set_bio(client, client_bio, client_bio);
+	SSL_set_bio(server, server_bio, server_bio);
+	SSL_set_connect_state(client);
+	SSL_set_accept_state(server);
+
+	for (i = 0; i < 100 && (0 == client_done || 0 == server_done); i++)
+	{
+		if (0 == client_done && 1 == SSL_do_handshake(client))
+			client_done = 1;
+
+		if (0 == server_done && 1 == SSL_do_handshake(server))
+			server_done = 1;
+	}
+
+	if (0 == client_done || 0 == server_done)
+		fail_msg("TLS handshake failed");
+
+	if (1 != SSL_write(server, "x", 1) || 1 != SSL_read(client, buf, sizeof(buf)))
+		fail_msg("cannot exchange data");
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	SSL_CTX		*client_ctx, *server_ctx, *server_ctx_next;
+	SSL		*client, *server;
+	SSL_SESSION	*session;
+	zbx_hash_t	hash = 1;
+	int		reused;
+
+	ZBX_UNUSED(state);
+
+	zbx_tls_generate_ticket_keys();
+
+	if (NULL == (client_ctx = SSL_CTX_new(TLS_client_method())))
+		fail_msg("cannot create client context");
+
+	if (0 == strcmp(zbx_mock_get_parameter_string("in.client_certificate"), "yes"))
+		ctx_set_certificate(client_ctx);
+
+	server_ctx = server_ctx_create();
+
+	client = SSL_new(client_ctx);
+	server = SSL_new(server_ctx);
+	tls_connect(client, server);
+
+	/* session of connection freed without close_notify cannot be resumed, same as in zbx_tls_close() */
+	SSL_shutdown(client);
+	SSL_shutdown(server);
+	tls_session_save(hash, client);
+	SSL_free(server);
+	SSL_free(client);
+
+	if (NULL == (session = tls_session_find(hash)))
+		fail_msg("session was not cached");
+
+	/* the next connection is accepted by another process which got the same or different ticket keys */
+	if (0 == strcmp(zbx_mock_get_parameter_string("in.regenerate_keys"), "yes"))
+		zbx_tls_generate_ticket_keys();
+
+	server_ctx_next = server_ctx_create();
+
+	client = SSL_new(client_ctx);
+	server = SSL_new(server_ctx_next);
+	SSL_set_session(client, session);
+	tls_connect(client, server);
+	reused = SSL_session_reused(client);
+	SSL_free(server);
+	SSL_free(client);
+
+	zbx_mock_assert_int_eq("session reused", zbx_mock_get_parameter_int("out.reused"), reused);
+
+	tls_sessions_free();
+	SSL_CTX_free(server_ctx_next);
+	SSL_CTX_free(server_ctx);
+	SSL_CTX_free(client_ctx);
+}
+#else
+void	zbx_mock_test_entry(void **state)
+{
+	ZBX_UNUSED(state);
+
+	skip();
+}
+#endif
@@ -0,0 +1,218 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcomms.h"
+#include "zbxcommshigh.h"
+#include "zbxcfg.h"
+
+/* socket layer results of the current exchange, read from test data */
+static zbx_mock_handle_t	hconnect, hsend, hrecv;
+static int			connects, sends, peer_closed;
+
+int	__wrap_zbx_tcp_connect(zbx_socket_t *s, const char *source_ip, const char *ip, unsigned short port,
+		int timeout, unsigned int tls_connect, const char *tls_arg1, const char *tls_arg2);
+int	__wrap_zbx_tcp_send_ext(zbx_socket_t *s, const char *data, size_t len, size_t reserved,
+		unsigned char flags, int timeout);
+ssize_t	__wrap_zbx_tcp_recv_ext(zbx_socket_t *s, int timeout, unsigned char flags);
+void	__wrap_zbx_tcp_close(zbx_socket_t *s);
+int	__wrap_zbx_tcp_peer_closed(zbx_socket_t *s);
+int	__wrap_zbx_tcp_read_close_notify(zbx_socket_t *s, int timeout, short *events);
+
+static const char	*next_result(zbx_mock_handle_t hvector, const char *name)
+{
+	zbx_mock_handle_t	hresult;
+	const char		*result;
+	zbx_mock_error_t	err;
+
+	if (ZBX_MOCK_SUCCESS != (err = zbx_mock_vector_element(hvector, &hresult)))
+		fail_msg("unexpected %s call: %s", name, zbx_mock_error_string(err));
+
+	if (ZBX_MOCK_SUCCESS != (err = zbx_mock_string(hresult, &result)))
+		fail_msg("cannot read %s result: %s", name, zbx_mock_error_string(err));
+
+	return result;
+}
+
+int	__wrap_zbx_tcp_connect(zbx_socket_t *s, const char *source_ip, const char *ip, unsigned short port,
+		int timeout, unsigned int tls_connect, const char *tls_arg1, const char *tls_arg2)
+{
+	ZBX_UNUSED(source_ip);
+	ZBX_UNUSED(ip);
+	ZBX_UNUSED(port);
+	ZBX_UNUSED(timeout);
+	ZBX_UNUSED(tls_connect);
+	ZBX_UNUSED(tls_arg1);
+	ZBX_UNUSED(tls_arg2);
+
+	connects++;
+
+	if (SUCCEED != zbx_mock_str_to_return_code(next_result(hconnect, "connect")))
+		return FAIL;
+
+	memset(s, 0, sizeof(zbx_socket_t));
+	s->buf_type = ZBX_BUF_TYPE_STAT;
+	s->buffer = s->buf_stat;
+
+	return SUCCEED;
+}
+
+int	__wrap_zbx_tcp_send_ext(zbx_socket_t *s, const char *data, size_t len, size_t reserved,
+		unsigned char flags, int timeout)
+{
+	ZBX_UNUSED(s);
+	ZBX_UNUSED(data);
+	ZBX_UNUSED(len);
+	ZBX_UNUSED(reserved);
+	ZBX_UNUSED(flags);
+	ZBX_UNUSED(timeout);
+
+	sends++;
+
+	if (SUCCEED != zbx_mock_str_to_return_code(next_result(hsend, "send")))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+ssize_t	__wrap_zbx_tcp_recv_ext(zbx_socket_t *s, int timeout, unsigned char flags)
+{
+	const char	*data;
+
+	ZBX_UNUSED(timeout);
+	ZBX_UNUSED(flags);
+
+	/* empty response stands for receive failure */
+	if ('\0' == *(data = next_result(hrecv, "recv")))
+		return FAIL;
+
+	zbx_strlcpy(s->buf_stat, data, sizeof(s->buf_stat));
+	s->buffer = s->buf_stat;
+
+	return (ssize_t)strlen(data);
+}
+
+void	__wrap_zbx_tcp_close(zbx_socket_t *s)
+{
+	ZBX_UNUSED(s);
+}
+
+int	__wrap_zbx_tcp_peer_closed(zbx_socket_t *s)
+{
+	ZBX_UNUSED(s);
+
+	return peer_closed;
+}
+
+int	__wrap_zbx_tcp_read_close_notify(zbx_socket_t *s, int timeout, short *events)
+{
+	ZBX_UNUSED(s);
+	ZBX_UNUSED(timeout);
+	ZBX_UNUSED(events);
+
+	return 0;
+}
+
+static int	str_to_exchange_result(const char *str)
+{
+	if (0 == strcmp(str, "SUCCEED"))
+		return SUCCEED;
+
+	if (0 == strcmp(str, "CONNECT_ERROR"))
+		return CONNECT_ERROR;
+
+	if (0 == strcmp(str, "SEND_ERROR"))
+		return SEND_ERROR;
+
+	if (0 == strcmp(str, "RECV_ERROR"))
+		return RECV_ERROR;
+
+	fail_msg("unknown exchange result '%s'", str);
+
+	return FAIL;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_comms_keepalive_t	keepalive;
+	zbx_vector_addr_ptr_t	addrs;
+	zbx_config_tls_t	config_tls;
+	zbx_mock_handle_t	hexchanges, hexchange;
+	zbx_addr_t		*addr;
+	zbx_mock_error_t	err;
+	int			step = 0;
+
+	ZBX_UNUSED(state);
+
+	memset(&keepalive, 0, sizeof(keepalive));
+	memset(&config_tls, 0, sizeof(config_tls));
+	config_tls.connect_mode = ZBX_TCP_SEC_UNENCRYPTED;
+
+	zbx_vector_addr_ptr_create(&addrs);
+	addr = (zbx_addr_t *)zbx_malloc(NULL, sizeof(zbx_addr_t));
+	addr->ip = zbx_strdup(NULL, "127.0.0.1");
+	addr->port = 10051;
+	addr->revision = 0;
+	zbx_vector_addr_ptr_append(&addrs, addr);
+
+	hexchanges = zbx_mock_get_parameter_handle("in.exchanges");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hexchanges, &hexchange)))
+	{
+		char	*out = NULL, *error = NULL, msg[64];
+		int	ret, expected_ret;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read exchange: %s", zbx_mock_error_string(err));
+
+		step++;
+		connects = 0;
+		sends = 0;
+		peer_closed = (0 == strcmp(zbx_mock_get_object_member_string(hexchange, "peer"), "closed") ?
+				SUCCEED : FAIL);
+		hconnect = zbx_mock_get_object_member_handle(hexchange, "connect");
+		hsend = zbx_mock_get_object_member_handle(hexchange, "send");
+		hrecv = zbx_mock_get_object_member_handle(hexchange, "recv");
+
+		ret = zbx_comms_exchange_keepalive(&keepalive, NULL, &addrs, 1, 1, 0, LOG_LEVEL_DEBUG, &config_tls,
+				"{\"request\":\"sender data\",\"keepalive\":\"true\"}", NULL, NULL, &out, &error);
+
+		expected_ret = str_to_exchange_result(zbx_mock_get_object_member_string(hexchange, "return"));
+
+		zbx_snprintf(msg, sizeof(msg), "exchange #%d return code", step);
+		zbx_mock_assert_int_eq(msg, expected_ret, ret);
+
+		zbx_snprintf(msg, sizeof(msg), "exchange #%d connects", step);
+		zbx_mock_assert_int_eq(msg, zbx_mock_get_object_member_int(hexchange, "connects"), connects);
+
+		zbx_snprintf(msg, sizeof(msg), "exchange #%d sends", step);
+		zbx_mock_assert_int_eq(msg, zbx_mock_get_object_member_int(hexchange, "sends"), sends);
+
+		zbx_snprintf(msg, sizeof(msg), "exchange #%d kept connection", step);
+		zbx_mock_assert_int_eq(msg, zbx_mock_get_object_member_int(hexchange, "kept"),
+				NULL != keepalive.ip ? 1 : 0);
+
+		zbx_free(out);
+		zbx_free(error);
+	}
+
+	zbx_comms_keepalive_close(&keepalive);
+	zbx_vector_addr_ptr_clear_ext(&addrs, zbx_addr_free);
+	zbx_vector_addr_ptr_destroy(&addrs);
+}
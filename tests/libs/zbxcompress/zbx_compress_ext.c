@@ -0,0 +1,90 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcompress.h"
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char	*codec_name, *pattern;
+	unsigned char	codec;
+	char		*data, *compressed = NULL, *out;
+	size_t		pattern_len, data_len, compressed_size, out_size;
+	zbx_uint64_t	repeat;
+
+	ZBX_UNUSED(state);
+
+	codec_name = zbx_mock_get_parameter_string("in.codec");
+
+	if (SUCCEED != zbx_compress_codec_parse(codec_name, &codec))
+		fail_msg("unknown codec \"%s\"", codec_name);
+
+	/* codecs not compiled in must be rejected */
+	if (SUCCEED != zbx_compress_codec_supported(codec))
+	{
+		zbx_mock_assert_result_eq("zbx_compress_ext() return code", FAIL,
+				zbx_compress_ext(codec, "data", 4, &compressed, &compressed_size));
+		skip();
+	}
+
+	pattern = zbx_mock_get_parameter_string("in.data");
+	repeat = zbx_mock_get_parameter_uint64("in.repeat");
+	pattern_len = strlen(pattern);
+	data_len = pattern_len * (size_t)repeat;
+
+	data = (char *)zbx_malloc(NULL, data_len + 1);
+
+	for (size_t i = 0; i < (size_t)repeat; i++)
+		memcpy(data + i * pattern_len, pattern, pattern_len);
+
+	data[data_len] = '\0';
+
+	zbx_mock_assert_result_eq("zbx_compress_ext() return code", SUCCEED,
+			zbx_compress_ext(codec, data, data_len, &compressed, &compressed_size));
+
+	out = (char *)zbx_malloc(NULL, data_len + 1);
+
+	/* the output buffer size is known from the protocol header, smaller buffer must fail */
+	if (0 != data_len)
+	{
+		out_size = data_len - 1;
+		zbx_mock_assert_result_eq("zbx_uncompress_ext() with small buffer return code", FAIL,
+				zbx_uncompress_ext(codec, compressed, compressed_size, out, &out_size));
+	}
+
+	out_size = data_len;
+	zbx_mock_assert_result_eq("zbx_uncompress_ext() return code", SUCCEED,
+			zbx_uncompress_ext(codec, compressed, compressed_size, out, &out_size));
+	zbx_mock_assert_uint64_eq("uncompressed size", data_len, out_size);
+
+	if (0 != memcmp(data, out, data_len))
+		fail_msg("uncompressed data does not match the original");
+
+	/* truncated data must be detected */
+	if (1 < compressed_size)
+	{
+		out_size = data_len;
+		zbx_mock_assert_result_eq("zbx_uncompress_ext() with truncated data return code", FAIL,
+				zbx_uncompress_ext(codec, compressed, compressed_size / 2, out, &out_size));
+	}
+
+	zbx_free(out);
+	zbx_free(compressed);
+	zbx_free(data);
+}
@@ -0,0 +1,48 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcompress.h"
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char	*codecs = NULL;
+	unsigned char	codec_local, codec_expected;
+
+	ZBX_UNUSED(state);
+
+	if (SUCCEED != zbx_compress_codec_parse(zbx_mock_get_parameter_string("in.codec"), &codec_local))
+		fail_msg("unknown local codec");
+
+	if (SUCCEED != zbx_compress_codec_parse(zbx_mock_get_parameter_string("out.codec"), &codec_expected))
+		fail_msg("unknown expected codec");
+
+	/* the configured codec must be compiled in */
+	if (SUCCEED != zbx_compress_set_codec(codec_local))
+		skip();
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.codecs"))
+		codecs = zbx_mock_get_parameter_string("in.codecs");
+
+	zbx_mock_assert_int_eq("negotiated codec", codec_expected, zbx_compress_negotiate(codecs));
+
+	/* data compressed without negotiation must stay readable by any peer */
+	zbx_mock_assert_int_eq("zbx_compress_codecs() starts with zlib", 0,
+			strncmp(zbx_compress_codecs(), "zlib", ZBX_CONST_STRLEN("zlib")));
+}
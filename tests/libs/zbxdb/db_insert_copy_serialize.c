@@ -0,0 +1,81 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxmockhelper.h"
+
+#include "../../../src/libs/zbxdb/dbinsert.c"
+
+void	zbx_mock_test_entry(void **state)
+{
+#if defined(HAVE_POSTGRESQL)
+	static const zbx_db_table_t	table = {"copy_test", "", 0,
+		{
+			{"id",		NULL,	NULL,	NULL,	0,	ZBX_TYPE_ID,	0,		0},
+			{"name",	"",	NULL,	NULL,	255,	ZBX_TYPE_CHAR,	ZBX_NOTNULL,	0},
+			{"data",	"",	NULL,	NULL,	0,	ZBX_TYPE_BLOB,	ZBX_NOTNULL,	0},
+			{"count",	"0",	NULL,	NULL,	0,	ZBX_TYPE_INT,	ZBX_NOTNULL,	0},
+			{"value",	"0",	NULL,	NULL,	0,	ZBX_TYPE_UINT,	ZBX_NOTNULL,	0},
+			{0}
+		},
+		NULL
+	};
+
+	const zbx_db_field_t	*insert_fields[] = {&table.fields[0], &table.fields[1], &table.fields[2],
+					&table.fields[3], &table.fields[4]};
+	zbx_db_insert_t		db_insert;
+	zbx_mock_handle_t	hrows, hrow;
+	char			*buf, *expected;
+	size_t			buf_alloc = 16, buf_offset = 0, expected_size = 0;
+
+	ZBX_UNUSED(state);
+
+	zbx_dbconn_prepare_insert_dyn(NULL, &db_insert, &table, insert_fields, (int)ARRSIZE(insert_fields));
+
+	hrows = zbx_mock_get_parameter_handle("in.rows");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hrows, &hrow))
+	{
+		zbx_db_value_t	id, name, data, count, value, *values[] = {&id, &name, &data, &count, &value};
+
+		id.ui64 = zbx_mock_get_object_member_uint64(hrow, "id");
+		name.str = (char *)zbx_mock_get_object_member_string(hrow, "name");
+		data.str = (char *)zbx_mock_get_object_member_string(hrow, "data");
+		count.i32 = zbx_mock_get_object_member_int(hrow, "count");
+		value.ui64 = zbx_mock_get_object_member_uint64(hrow, "value");
+
+		zbx_db_insert_add_values_dyn(&db_insert, values, (int)ARRSIZE(values));
+	}
+
+	buf = (char *)zbx_malloc(NULL, buf_alloc);
+	db_insert_copy_serialize(&db_insert, &buf, &buf_alloc, &buf_offset);
+
+	expected = zbx_yaml_assemble_binary_sequence("out.data", &expected_size);
+
+	zbx_mock_assert_uint64_eq("serialized data size", expected_size, buf_offset);
+
+	if (0 != memcmp(expected, buf, expected_size))
+		fail_msg("serialized data does not match expected data");
+
+	zbx_free(expected);
+	zbx_free(buf);
+	zbx_db_insert_clean(&db_insert);
+#else
+	ZBX_UNUSED(state);
+	skip();
+#endif
+}
@@ -0,0 +1,173 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxescalations.h"
+#include "zbxmutexs.h"
+
+/* escalator process notified by the last zbx_start_escalations() call */
+static int	notified_process_num;
+
+static int	mock_rtc_notify(zbx_ipc_async_socket_t *rtc, unsigned char process_type, int process_num,
+		zbx_uint32_t code, const char *data, zbx_uint32_t size)
+{
+	ZBX_UNUSED(rtc);
+	ZBX_UNUSED(process_type);
+	ZBX_UNUSED(code);
+	ZBX_UNUSED(data);
+	ZBX_UNUSED(size);
+
+	notified_process_num = process_num;
+
+	return SUCCEED;
+}
+
+static int	notify_escalator(zbx_uint64_t triggerid)
+{
+	zbx_vector_escalation_new_ptr_t	escalations;
+	zbx_escalation_new_t		escalation;
+	zbx_db_event			event;
+
+	memset(&event, 0, sizeof(event));
+	event.object = EVENT_OBJECT_TRIGGER;
+	event.objectid = triggerid;
+
+	escalation.actionid = 1;
+	escalation.escalationid = 1;
+	escalation.event = &event;
+
+	zbx_vector_escalation_new_ptr_create(&escalations);
+	zbx_vector_escalation_new_ptr_append(&escalations, &escalation);
+
+	notified_process_num = 0;
+	zbx_start_escalations(NULL, &escalations);
+
+	zbx_vector_escalation_new_ptr_destroy(&escalations);
+
+	return notified_process_num;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_mock_handle_t	hsteps, hstep;
+	zbx_mock_error_t	err;
+	zbx_vector_int32_t	*claimed;
+	int			escalators_num, step = 0;
+	char			*error = NULL;
+
+	ZBX_UNUSED(state);
+
+	if (SUCCEED != zbx_locks_create(&error))
+		fail_msg("cannot create locks: %s", error);
+
+	escalators_num = zbx_mock_get_parameter_int("in.escalators");
+	zbx_init_escalations(escalators_num, mock_rtc_notify);
+
+	if (SUCCEED != zbx_init_escalation_shards(zbx_mock_get_parameter_int("in.shards"),
+			zbx_mock_get_parameter_int("in.batch"), &error))
+	{
+		fail_msg("cannot initialize escalation shards: %s", error);
+	}
+
+	/* shards claimed by each escalator and not yet released */
+	claimed = (zbx_vector_int32_t *)zbx_malloc(NULL, (size_t)escalators_num * sizeof(zbx_vector_int32_t));
+
+	for (int i = 0; i < escalators_num; i++)
+		zbx_vector_int32_create(&claimed[i]);
+
+	hsteps = zbx_mock_get_parameter_handle("in.steps");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hsteps, &hstep)))
+	{
+		const char	*op;
+		char		msg[64];
+		int		process_num;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read step: %s", zbx_mock_error_string(err));
+
+		step++;
+		op = zbx_mock_get_object_member_string(hstep, "op");
+
+		if (0 == strcmp(op, "notify"))
+		{
+			zbx_snprintf(msg, sizeof(msg), "step #%d notified escalator", step);
+			zbx_mock_assert_int_eq(msg, zbx_mock_get_object_member_int(hstep, "escalator"),
+					notify_escalator(zbx_mock_get_object_member_uint64(hstep, "triggerid")));
+			continue;
+		}
+
+		process_num = zbx_mock_get_object_member_int(hstep, "escalator");
+
+		if (0 == strcmp(op, "queue"))
+		{
+			zbx_escalation_shards_queue(process_num, zbx_mock_get_object_member_int(hstep, "now"),
+					zbx_mock_get_object_member_int(hstep, "delay"));
+		}
+		else if (0 == strcmp(op, "claim"))
+		{
+			zbx_vector_int32_t	expected;
+			zbx_mock_handle_t	hshards, hshard;
+			int			shardid;
+
+			zbx_vector_int32_create(&expected);
+			hshards = zbx_mock_get_object_member_handle(hstep, "shards");
+
+			while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hshards, &hshard)))
+			{
+				if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != (err = zbx_mock_int(hshard,
+						&shardid)))
+				{
+					fail_msg("cannot read shard: %s", zbx_mock_error_string(err));
+				}
+
+				zbx_vector_int32_append(&expected, shardid);
+			}
+
+			zbx_escalation_shards_claim(zbx_mock_get_object_member_int(hstep, "queue"), process_num,
+					&claimed[process_num - 1]);
+
+			zbx_snprintf(msg, sizeof(msg), "step #%d claimed shard count", step);
+			zbx_mock_assert_int_eq(msg, expected.values_num, claimed[process_num - 1].values_num);
+
+			for (int i = 0; i < expected.values_num; i++)
+			{
+				zbx_snprintf(msg, sizeof(msg), "step #%d claimed shard #%d", step, i + 1);
+				zbx_mock_assert_int_eq(msg, expected.values[i], claimed[process_num - 1].values[i]);
+			}
+
+			zbx_vector_int32_destroy(&expected);
+		}
+		else if (0 == strcmp(op, "release"))
+		{
+			zbx_escalation_shards_release(zbx_mock_get_object_member_int(hstep, "queue"),
+					&claimed[process_num - 1]);
+			zbx_vector_int32_clear(&claimed[process_num - 1]);
+		}
+		else
+			fail_msg("unknown operation '%s'", op);
+	}
+
+	for (int i = 0; i < escalators_num; i++)
+		zbx_vector_int32_destroy(&claimed[i]);
+
+	zbx_free(claimed);
+
+	zbx_deinit_escalation_shards();
+	zbx_locks_destroy();
+}
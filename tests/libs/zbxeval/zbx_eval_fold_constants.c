@@ -0,0 +1,82 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxeval.h"
+#include "mock_eval.h"
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_eval_context_t	ctx, ctx_orig;
+	char			*error = NULL, *ret_expression = NULL;
+	zbx_uint64_t		rules;
+	const char		*expression;
+	zbx_variant_t		value;
+	double			expected_value;
+
+	ZBX_UNUSED(state);
+
+	rules = mock_eval_read_rules("in.rules");
+	expression = zbx_mock_get_parameter_string("in.expression");
+
+	if (SUCCEED != zbx_eval_parse_expression(&ctx, expression, rules, &error))
+		fail_msg("failed to parse expression: %s", error);
+
+	zbx_eval_fold_constants(&ctx);
+
+	zbx_mock_assert_int_eq("number of tokens", (int)zbx_mock_get_parameter_uint64("out.tokens"),
+			ctx.stack.values_num);
+
+	zbx_eval_compose_expression(&ctx, &ret_expression);
+	zbx_mock_assert_str_eq("invalid folded expression", zbx_mock_get_parameter_string("out.expression"),
+			ret_expression);
+	zbx_free(ret_expression);
+
+	/* composing without cached values must restore the original expression */
+	zbx_eval_copy(&ctx_orig, &ctx, ctx.expression);
+
+	for (int i = 0; i < ctx_orig.stack.values_num; i++)
+		zbx_variant_clear(&ctx_orig.stack.values[i].value);
+
+	zbx_eval_compose_expression(&ctx_orig, &ret_expression);
+	zbx_mock_assert_str_eq("invalid original expression", expression, ret_expression);
+	zbx_free(ret_expression);
+	zbx_eval_clear(&ctx_orig);
+
+	mock_eval_read_values(&ctx, "in.replace");
+
+	if (SUCCEED != zbx_eval_execute(&ctx, NULL, &value, &error))
+	{
+		zbx_mock_assert_str_eq("execution error", zbx_mock_get_parameter_string("out.error"), error);
+		zbx_free(error);
+	}
+	else
+	{
+		if (SUCCEED != zbx_variant_convert(&value, ZBX_VARIANT_DBL))
+			fail_msg("cannot convert value \"%s\" to double", zbx_variant_value_desc(&value));
+
+		expected_value = atof(zbx_mock_get_parameter_string("out.value"));
+
+		if (1e-12 < fabs(value.data.dbl - expected_value))
+			fail_msg("Expected value \"%f\" while got \"%f\"", expected_value, value.data.dbl);
+	}
+
+	zbx_eval_clear(&ctx);
+}
@@ -0,0 +1,187 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+/* Benchmark of json string scanning, not run by tests. Build it with 'make zbx_json_scan_bench'   */
+/* and 'make zbx_json_scan_bench_scalar' - the latter uses byte by byte string scanning, so both   */
+/* implementations can be compared on the same machine:                                            */
+/*                                                                                                 */
+/*   zbx_json_scan_bench [<records> [<passes> [<file>]]]                                           */
+/*                                                                                                 */
+/* Each pass opens proxy history data payload and reads itemid, value and ns of all records. The   */
+/* payload is either generated with the specified number of records or read from file.             */
+
+#include "../../../src/libs/zbxjson/json.c"
+
+#include "zbxtime.h"
+
+#define BENCH_RECORDS	20000
+#define BENCH_PASSES	100
+
+static char	*bench_generate_payload(int records)
+{
+	struct zbx_json	json;
+	char		value[256], *payload;
+
+	zbx_json_init(&json, ZBX_JSON_STAT_BUF_LEN);
+	zbx_json_addstring(&json, ZBX_PROTO_TAG_REQUEST, ZBX_PROTO_TAG_HISTORY_DATA, ZBX_JSON_TYPE_STRING);
+	zbx_json_addstring(&json, ZBX_PROTO_TAG_HOST, "proxy", ZBX_JSON_TYPE_STRING);
+	zbx_json_addarray(&json, ZBX_PROTO_TAG_DATA);
+
+	for (int i = 0; i < records; i++)
+	{
+		zbx_json_addobject(&json, NULL);
+		zbx_json_adduint64(&json, ZBX_PROTO_TAG_ITEMID, (zbx_uint64_t)(100000 + i));
+		zbx_json_addint64(&json, ZBX_PROTO_TAG_CLOCK, 1700000000 + i / 100);
+		zbx_json_addint64(&json, ZBX_PROTO_TAG_NS, i * 7919 % 1000000000);
+
+		/* mix of numeric values and log lines with occasional characters that must be escaped */
+		if (0 == i % 3)
+		{
+			zbx_snprintf(value, sizeof(value), "%d.%03d", i, i % 1000);
+		}
+		else
+		{
+			zbx_snprintf(value, sizeof(value), "%s service[%d]: request from \"10.0.%d.%d\" processed in"
+					" %d ms, path C:\\data\\%d%s", 0 == i % 2 ? "Oct 17 10:00:00 host" : "info",
+					i, i % 256, i % 199, i % 997, i, 0 == i % 5 ? "\n\ttrace follows" : "");
+		}
+
+		zbx_json_addstring(&json, ZBX_PROTO_TAG_VALUE, value, ZBX_JSON_TYPE_STRING);
+		zbx_json_close(&json);
+	}
+
+	zbx_json_close(&json);
+
+	payload = zbx_strdup(NULL, json.buffer);
+	zbx_json_free(&json);
+
+	return payload;
+}
+
+static char	*bench_read_payload(const char *path)
+{
+	FILE	*f;
+	char	*payload;
+	long	size;
+
+	if (NULL == (f = fopen(path, "rb")))
+	{
+		printf("cannot open \"%s\": %s\n", path, zbx_strerror(errno));
+		return NULL;
+	}
+
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	payload = (char *)zbx_malloc(NULL, (size_t)size + 1);
+
+	if ((size_t)size != fread(payload, 1, (size_t)size, f))
+	{
+		printf("cannot read \"%s\"\n", path);
+		zbx_free(payload);
+	}
+	else
+		payload[size] = '\0';
+
+	fclose(f);
+
+	return payload;
+}
+
+static int	bench_pass(const char *payload, zbx_uint64_t *checksum)
+{
+	struct zbx_json_parse	jp, jp_data, jp_row;
+	const char		*p = NULL;
+	char			buf[MAX_STRING_LEN];
+	int			records = 0;
+	zbx_uint64_t		itemid;
+
+	if (SUCCEED != zbx_json_open(payload, &jp) ||
+			SUCCEED != zbx_json_brackets_by_name(&jp, ZBX_PROTO_TAG_DATA, &jp_data))
+	{
+		printf("cannot parse payload: %s\n", zbx_json_strerror());
+		return FAIL;
+	}
+
+	while (NULL != (p = zbx_json_next(&jp_data, p)))
+	{
+		if (SUCCEED != zbx_json_brackets_open(p, &jp_row))
+			return FAIL;
+
+		if (SUCCEED == zbx_json_value_by_name(&jp_row, ZBX_PROTO_TAG_ITEMID, buf, sizeof(buf), NULL) &&
+				SUCCEED == zbx_is_uint64(buf, &itemid))
+		{
+			*checksum += itemid;
+		}
+
+		if (SUCCEED == zbx_json_value_by_name(&jp_row, ZBX_PROTO_TAG_VALUE, buf, sizeof(buf), NULL))
+			*checksum += strlen(buf);
+
+		if (SUCCEED == zbx_json_value_by_name(&jp_row, ZBX_PROTO_TAG_NS, buf, sizeof(buf), NULL))
+			*checksum += (zbx_uint64_t)atoi(buf);
+
+		records++;
+	}
+
+	return records;
+}
+
+int	main(int argc, char **argv)
+{
+	int		records = BENCH_RECORDS, passes = BENCH_PASSES, rows = 0;
+	char		*payload;
+	double		sec;
+	zbx_uint64_t	checksum = 0;
+
+	if (1 < argc)
+		records = atoi(argv[1]);
+
+	if (2 < argc)
+		passes = atoi(argv[2]);
+
+	if (0 >= records || 0 >= passes)
+	{
+		printf("usage: %s [<records> [<passes> [<file>]]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (NULL == (payload = (3 < argc ? bench_read_payload(argv[3]) : bench_generate_payload(records))))
+		return EXIT_FAILURE;
+
+	sec = zbx_time();
+
+	for (int i = 0; i < passes; i++)
+	{
+		if (FAIL == (rows = bench_pass(payload, &checksum)))
+		{
+			zbx_free(payload);
+			return EXIT_FAILURE;
+		}
+	}
+
+	sec = zbx_time() - sec;
+
+#ifdef ZBX_JSON_SCAN_SSE2
+	printf("scan:sse2");
+#else
+	printf("scan:scalar");
+#endif
+	printf(" size:" ZBX_FS_SIZE_T " records:%d passes:%d time per pass:" ZBX_FS_DBL " ms checksum:" ZBX_FS_UI64
+			"\n", (zbx_fs_size_t)strlen(payload), rows, passes, sec * 1000 / passes, checksum);
+
+	zbx_free(payload);
+
+	return EXIT_SUCCESS;
+}
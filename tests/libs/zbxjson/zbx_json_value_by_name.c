@@ -0,0 +1,71 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxcommon.h"
+#include "zbxjson.h"
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+/* json strings are scanned in 16 byte blocks, so every test case is */
+/* repeated with the data starting at all offsets inside a block     */
+#define JSON_BLOCK_SIZE	16
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char	*data, *name;
+	char		*buffer, *json, *value = NULL;
+	size_t		data_len, value_alloc = 0;
+	int		expected_ret;
+
+	ZBX_UNUSED(state);
+
+	data = zbx_mock_get_parameter_string("in.data");
+	name = zbx_mock_get_parameter_string("in.name");
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return"));
+
+	data_len = strlen(data);
+	buffer = (char *)zbx_malloc(NULL, data_len + JSON_BLOCK_SIZE * 3);
+
+	for (int offset = 0; offset < JSON_BLOCK_SIZE; offset++)
+	{
+		struct zbx_json_parse	jp;
+		char			msg[64];
+		int			ret;
+
+		/* fill the data tail with quotes to check that scanning stops at terminating zero */
+		memset(buffer, '"', data_len + JSON_BLOCK_SIZE * 3);
+
+		json = (char *)(((uintptr_t)buffer + JSON_BLOCK_SIZE - 1) & ~(uintptr_t)(JSON_BLOCK_SIZE - 1)) +
+				offset;
+		memcpy(json, data, data_len + 1);
+
+		if (SUCCEED == (ret = zbx_json_open(json, &jp)))
+			ret = zbx_json_value_by_name_dyn(&jp, name, &value, &value_alloc, NULL);
+
+		zbx_snprintf(msg, sizeof(msg), "return value at offset %d", offset);
+		zbx_mock_assert_result_eq(msg, expected_ret, ret);
+
+		if (SUCCEED == ret)
+		{
+			zbx_snprintf(msg, sizeof(msg), "value at offset %d", offset);
+			zbx_mock_assert_str_eq(msg, zbx_mock_get_parameter_string("out.value"), value);
+		}
+	}
+
+	zbx_free(value);
+	zbx_free(buffer);
+}
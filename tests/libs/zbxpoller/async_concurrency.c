@@ -0,0 +1,226 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/libs/zbxpoller/async_concurrency.c"
+
+double	__wrap_zbx_time(void);
+
+static double	mock_time = 1700000000;
+
+double	__wrap_zbx_time(void)
+{
+	return mock_time;
+}
+
+/* deferred checks are owned by poller items, which are freed by poller manager in production code */
+void	zbx_poller_item_free(zbx_poller_item_t *poller_item)
+{
+	zbx_free(poller_item->items);
+	zbx_free(poller_item);
+}
+
+static void	mock_item_init(zbx_dc_item_t *item, zbx_mock_handle_t hstep, int offset)
+{
+	memset(item, 0, sizeof(zbx_dc_item_t));
+	item->itemid = zbx_mock_get_object_member_uint64(hstep, "itemid") + (zbx_uint64_t)offset;
+	item->host.hostid = zbx_mock_get_object_member_uint64(hstep, "hostid");
+	item->interface.interfaceid = item->host.hostid;
+}
+
+static int	mock_step_count(zbx_mock_handle_t hstep)
+{
+	zbx_mock_handle_t	hcount;
+	int			count;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_object_member(hstep, "count", &hcount))
+		return 1;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_int(hcount, &count))
+		fail_msg("invalid count");
+
+	return count;
+}
+
+static void	mock_step_acquire(zbx_async_concurrency_t *concurrency, zbx_mock_handle_t hstep)
+{
+	int	expected = zbx_mock_str_to_return_code(zbx_mock_get_object_member_string(hstep, "return")),
+		count = mock_step_count(hstep);
+
+	for (int i = 0; i < count; i++)
+	{
+		zbx_dc_item_t	item;
+
+		mock_item_init(&item, hstep, i);
+		zbx_mock_assert_result_eq("async_concurrency_acquire() return value", expected,
+				async_concurrency_acquire(concurrency, &item));
+	}
+}
+
+static void	mock_step_defer(zbx_async_concurrency_t *concurrency, zbx_mock_handle_t hstep)
+{
+	int	count = mock_step_count(hstep);
+
+	for (int i = 0; i < count; i++)
+	{
+		zbx_dc_item_t		item;
+		zbx_poller_item_t	*poller_item;
+
+		mock_item_init(&item, hstep, i);
+
+		poller_item = (zbx_poller_item_t *)zbx_malloc(NULL, sizeof(zbx_poller_item_t));
+		memset(poller_item, 0, sizeof(zbx_poller_item_t));
+		poller_item->items = (zbx_dc_item_t *)zbx_malloc(NULL, sizeof(zbx_dc_item_t));
+		poller_item->items[0] = item;
+		poller_item->num = 1;
+
+		async_concurrency_defer(concurrency, &item, poller_item, 0);
+	}
+}
+
+static void	mock_step_next(zbx_async_concurrency_t *concurrency, zbx_mock_handle_t hstep)
+{
+	zbx_async_deferred_t	deferred;
+	int			expected, ret;
+
+	expected = zbx_mock_str_to_return_code(zbx_mock_get_object_member_string(hstep, "return"));
+	ret = async_concurrency_next_deferred(concurrency, &deferred);
+	zbx_mock_assert_result_eq("async_concurrency_next_deferred() return value", expected, ret);
+
+	if (SUCCEED != ret)
+		return;
+
+	zbx_mock_assert_uint64_eq("deferred itemid", zbx_mock_get_object_member_uint64(hstep, "itemid"),
+			deferred.poller_item->items[deferred.index].itemid);
+
+	if (0 == --deferred.poller_item->deferred_num)
+		zbx_poller_item_free(deferred.poller_item);
+}
+
+static void	mock_step_release(zbx_async_concurrency_t *concurrency, zbx_mock_handle_t hstep)
+{
+	int		errcode = zbx_mock_str_to_return_code(zbx_mock_get_object_member_string(hstep, "errcode")),
+			count = mock_step_count(hstep);
+	zbx_uint64_t	itemid = zbx_mock_get_object_member_uint64(hstep, "itemid");
+
+	for (int i = 0; i < count; i++)
+		async_concurrency_release(concurrency, itemid + (zbx_uint64_t)i, errcode);
+}
+
+static void	mock_step_check(zbx_async_concurrency_t *concurrency, zbx_mock_handle_t hstep)
+{
+	zbx_mock_handle_t	hvalue;
+	int			value;
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "limit", &hvalue) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_int(hvalue, &value))
+	{
+		zbx_mock_assert_int_eq("poller concurrency limit", value, async_concurrency_get_limit(concurrency));
+	}
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "fetch_limit", &hvalue) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_int(hvalue, &value))
+	{
+		zbx_mock_assert_int_eq("fetch limit", value, async_concurrency_get_fetch_limit(concurrency));
+	}
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "inflight", &hvalue) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_int(hvalue, &value))
+	{
+		zbx_mock_assert_int_eq("checks in progress", value, concurrency->inflight_num);
+	}
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "deferred", &hvalue) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_int(hvalue, &value))
+	{
+		zbx_mock_assert_int_eq("deferred checks", value, concurrency->deferred_num);
+	}
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "hosts", &hvalue) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_int(hvalue, &value))
+	{
+		zbx_mock_assert_int_eq("tracked hosts", value, concurrency->hosts.num_data);
+	}
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "host_limit", &hvalue) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_int(hvalue, &value))
+	{
+		zbx_async_host_t	*host, host_local;
+
+		host_local.key.first = zbx_mock_get_object_member_uint64(hstep, "hostid");
+		host_local.key.second = host_local.key.first;
+
+		if (NULL == (host = (zbx_async_host_t *)zbx_hashset_search(&concurrency->hosts, &host_local)))
+			fail_msg("host " ZBX_FS_UI64 " is not tracked", host_local.key.first);
+
+		zbx_mock_assert_int_eq("host concurrency limit", value, host->limit);
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_async_concurrency_t	concurrency;
+	zbx_mock_handle_t	hsteps, hstep, hlimit;
+	zbx_mock_error_t	err;
+	int			limit;
+
+	ZBX_UNUSED(state);
+
+	async_concurrency_init(&concurrency, zbx_mock_get_parameter_int("in.limit_max"),
+			zbx_mock_get_parameter_int("in.timeout"));
+
+	/* start from lowered concurrency without going through the preceding windows */
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter("in.limit", &hlimit) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_int(hlimit, &limit))
+	{
+		concurrency.limit = limit;
+	}
+
+	hsteps = zbx_mock_get_parameter_handle("in.steps");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hsteps, &hstep))))
+	{
+		const char	*action;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read step: %s", zbx_mock_error_string(err));
+
+		action = zbx_mock_get_object_member_string(hstep, "action");
+
+		if (0 == strcmp(action, "acquire"))
+			mock_step_acquire(&concurrency, hstep);
+		else if (0 == strcmp(action, "defer"))
+			mock_step_defer(&concurrency, hstep);
+		else if (0 == strcmp(action, "next"))
+			mock_step_next(&concurrency, hstep);
+		else if (0 == strcmp(action, "release"))
+			mock_step_release(&concurrency, hstep);
+		else if (0 == strcmp(action, "cancel"))
+			async_concurrency_cancel(&concurrency, zbx_mock_get_object_member_uint64(hstep, "itemid"));
+		else if (0 == strcmp(action, "sleep"))
+			mock_time += zbx_mock_get_object_member_float(hstep, "seconds");
+		else if (0 == strcmp(action, "update"))
+			async_concurrency_update(&concurrency);
+		else if (0 == strcmp(action, "check"))
+			mock_step_check(&concurrency, hstep);
+		else
+			fail_msg("unknown step action \"%s\"", action);
+	}
+
+	async_concurrency_destroy(&concurrency);
+}
@@ -0,0 +1,90 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/libs/zbxpoller/checks_snmp.c"
+
+#ifdef HAVE_NETSNMP
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_snmp_context_t	snmp_context;
+	zbx_bulkwalk_context_t	bulkwalk_context;
+	struct snmp_pdu		response;
+	struct variable_list	*vars;
+	oid			name[] = {1, 3, 6, 1, 2, 1, 2, 2, 1, 2, 0};
+	u_char			*value;
+	int			vars_num, value_size;
+
+	ZBX_UNUSED(state);
+
+	snmp_repetitions_limit = zbx_mock_get_parameter_int("in.limit");
+
+	memset(&snmp_context, 0, sizeof(snmp_context));
+	snmp_context.snmp_max_repetitions = zbx_mock_get_parameter_int("in.max_repetitions");
+	snmp_context.repetitions = snmp_repetitions_get("device", snmp_context.snmp_max_repetitions);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.ceiling"))
+		snmp_context.repetitions->ceiling = zbx_mock_get_parameter_int("in.ceiling");
+
+	memset(&bulkwalk_context, 0, sizeof(bulkwalk_context));
+	bulkwalk_context.pdu_type = SNMP_MSG_GETBULK;
+	bulkwalk_context.max_repetitions = snmp_context.snmp_max_repetitions;
+	bulkwalk_context.running = zbx_mock_get_parameter_int("in.running");
+
+	/* response variables differ only by the last sub-identifier, values are not inspected */
+	vars_num = zbx_mock_get_parameter_int("in.response.vars");
+	value_size = zbx_mock_get_parameter_int("in.response.value_size");
+	value = (u_char *)zbx_malloc(NULL, (size_t)value_size);
+	memset(value, 'x', (size_t)value_size);
+
+	vars = (struct variable_list *)zbx_malloc(NULL, sizeof(struct variable_list) * (size_t)MAX(1, vars_num));
+	memset(vars, 0, sizeof(struct variable_list) * (size_t)MAX(1, vars_num));
+
+	for (int i = 0; i < vars_num; i++)
+	{
+		vars[i].name = name;
+		vars[i].name_length = ARRSIZE(name);
+		vars[i].type = ASN_OCTET_STR;
+		vars[i].val.string = value;
+		vars[i].val_len = (size_t)value_size;
+		vars[i].next_variable = (i + 1 < vars_num ? &vars[i + 1] : NULL);
+	}
+
+	memset(&response, 0, sizeof(response));
+	response.command = SNMP_MSG_RESPONSE;
+	response.variables = (0 != vars_num ? vars : NULL);
+
+	snmp_max_repetitions_tune(&snmp_context, &bulkwalk_context, &response);
+
+	zbx_mock_assert_int_eq("max-repetitions", zbx_mock_get_parameter_int("out.max_repetitions"),
+			snmp_context.snmp_max_repetitions);
+	zbx_mock_assert_int_eq("device max-repetitions", zbx_mock_get_parameter_int("out.max_repetitions"),
+			snmp_context.repetitions->max_repetitions);
+
+	zbx_free(vars);
+	zbx_free(value);
+	zbx_hashset_destroy(&snmp_repetitions);
+}
+#else
+void	zbx_mock_test_entry(void **state)
+{
+	ZBX_UNUSED(state);
+
+	skip();
+}
+#endif
@@ -0,0 +1,384 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/libs/zbxpoller/checks_snmp.c"
+
+#ifdef HAVE_NETSNMP
+static void	test_parse_oid(const char *str, oid *name, size_t *name_length)
+{
+	const char	*ptr = str;
+
+	*name_length = 0;
+
+	while ('.' == *ptr && MAX_OID_LEN > *name_length)
+	{
+		char	*end;
+
+		name[(*name_length)++] = (oid)strtoul(ptr + 1, &end, 10);
+		ptr = end;
+	}
+
+	if ('\0' != *ptr)
+		fail_msg("cannot parse numeric OID \"%s\"", str);
+}
+
+static zbx_snmp_context_t	*test_item_create(zbx_mock_handle_t hoids)
+{
+	zbx_snmp_context_t	*snmp_context;
+	zbx_mock_handle_t	hoid;
+	zbx_mock_error_t	err;
+
+	snmp_context = (zbx_snmp_context_t *)zbx_malloc(NULL, sizeof(zbx_snmp_context_t));
+	memset(snmp_context, 0, sizeof(zbx_snmp_context_t));
+
+	snmp_context->item.key = zbx_strdup(NULL, "walk");
+	snmp_context->item.key_orig = zbx_strdup(NULL, "walk");
+	snmp_context->device = zbx_strdup(NULL, "device");
+	zbx_init_agent_result(&snmp_context->item.result);
+	zbx_vector_snmp_oid_create(&snmp_context->param_oids);
+	zbx_vector_bulkwalk_context_create(&snmp_context->bulkwalk_contexts);
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hoids, &hoid)))
+	{
+		zbx_snmp_oid_t	*p_oid;
+		const char	*str;
+
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_string(hoid, &str))
+			fail_msg("cannot read item OID");
+
+		p_oid = (zbx_snmp_oid_t *)zbx_malloc(NULL, sizeof(zbx_snmp_oid_t));
+		test_parse_oid(str, p_oid->root_oid, &p_oid->root_oid_len);
+		p_oid->str_oid = zbx_strdup(NULL, str);
+		zbx_vector_snmp_oid_append(&snmp_context->param_oids, p_oid);
+	}
+
+	return snmp_context;
+}
+
+static int	test_item_index(const zbx_vector_snmp_context_t *items, const zbx_snmp_context_t *snmp_context)
+{
+	int	i;
+
+	if (FAIL == (i = zbx_vector_snmp_context_search(items, (zbx_snmp_context_t *)snmp_context,
+			ZBX_DEFAULT_PTR_COMPARE_FUNC)))
+	{
+		fail_msg("unknown group member");
+	}
+
+	return i;
+}
+
+static void	test_check_groups(const zbx_vector_snmp_context_t *items, const zbx_snmp_walk_device_t *device)
+{
+	zbx_mock_handle_t	hgroups, hgroup, hvalue, hvalues;
+	zbx_mock_error_t	err;
+	int			groups_num = 0;
+
+	hgroups = zbx_mock_get_parameter_handle("out.groups");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hgroups, &hgroup)))
+	{
+		const zbx_snmp_walk_group_t	*group;
+		int				num = 0;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read group");
+
+		if (groups_num >= device->groups.values_num)
+			fail_msg("expected more than %d groups", device->groups.values_num);
+
+		group = device->groups.values[groups_num++];
+
+		hvalues = zbx_mock_get_object_member_handle(hgroup, "members");
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hvalues, &hvalue)))
+		{
+			int	index;
+
+			if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_int(hvalue, &index))
+				fail_msg("cannot read group member");
+
+			if (num >= group->members.values_num)
+				fail_msg("group #%d has fewer members than expected", groups_num);
+
+			zbx_mock_assert_int_eq("group member", index, test_item_index(items,
+					group->members.values[num++]));
+		}
+
+		zbx_mock_assert_int_eq("group members", num, group->members.values_num);
+
+		num = 0;
+		hvalues = zbx_mock_get_object_member_handle(hgroup, "oids");
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hvalues, &hvalue)))
+		{
+			const char	*str;
+			int		i;
+
+			if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_string(hvalue, &str))
+				fail_msg("cannot read group OID");
+
+			for (i = 0; i < group->oids.values_num; i++)
+			{
+				if (0 == strcmp(group->oids.values[i]->str_oid, str))
+					break;
+			}
+
+			if (i == group->oids.values_num)
+				fail_msg("group #%d does not walk subtree \"%s\"", groups_num, str);
+
+			num++;
+		}
+
+		zbx_mock_assert_int_eq("group subtrees", num, group->oids.values_num);
+	}
+
+	zbx_mock_assert_int_eq("number of groups", groups_num, device->groups.values_num);
+}
+
+/* fills walker results as if its subtrees were walked, variables are given as "<OID> = <value>" lines */
+static void	test_walk(zbx_snmp_context_t *walker)
+{
+	zbx_mock_handle_t	hwalk, hsubtree, hvars, hvar;
+	zbx_mock_error_t	err;
+	char			*results = NULL;
+	size_t			results_alloc = 0, results_offset = 0;
+
+	walker->item.ret = SUCCEED;
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.walk_error"))
+	{
+		walker->item.ret = TIMEOUT_ERROR;
+		SET_MSG_RESULT(&walker->item.result, zbx_strdup(NULL, zbx_mock_get_parameter_string("in.walk_error")));
+		return;
+	}
+
+	hwalk = zbx_mock_get_parameter_handle("in.walk");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hwalk, &hsubtree)))
+	{
+		zbx_bulkwalk_context_t	*bulkwalk_context = NULL;
+		const char		*str;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read walked subtree");
+
+		str = zbx_mock_get_object_member_string(hsubtree, "oid");
+
+		for (int i = 0; i < walker->bulkwalk_contexts.values_num; i++)
+		{
+			if (0 == strcmp(walker->bulkwalk_contexts.values[i]->p_oid->str_oid, str))
+				bulkwalk_context = walker->bulkwalk_contexts.values[i];
+		}
+
+		/* subtree of another group */
+		if (NULL == bulkwalk_context)
+			continue;
+
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hsubtree, "error", &hvar))
+		{
+			if (ZBX_MOCK_SUCCESS != zbx_mock_string(hvar, &str))
+				fail_msg("cannot read subtree error");
+
+			bulkwalk_context->error = zbx_strdup(NULL, str);
+		}
+
+		if (ZBX_MOCK_SUCCESS != zbx_mock_object_member(hsubtree, "vars", &hvars))
+			continue;
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hvars, &hvar)))
+		{
+			zbx_snmp_walk_var_t	walk_var;
+			oid			name[MAX_OID_LEN];
+			char			buffer[MAX_STRING_LEN];
+			const char		*sep;
+
+			if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_string(hvar, &str))
+				fail_msg("cannot read walked variable");
+
+			if (NULL == (sep = strstr(str, " = ")))
+				fail_msg("invalid walked variable \"%s\"", str);
+
+			zbx_strlcpy(buffer, str, (size_t)(sep - str) + 1);
+			test_parse_oid(buffer, name, &walk_var.name_length);
+
+			walk_var.name = (oid *)zbx_malloc(NULL, walk_var.name_length * sizeof(oid));
+			memcpy(walk_var.name, name, walk_var.name_length * sizeof(oid));
+			walk_var.root = bulkwalk_context->p_oid;
+
+			if (NULL != results)
+				zbx_chrcpy_alloc(&results, &results_alloc, &results_offset, '\n');
+
+			walk_var.offset = results_offset;
+			walk_var.len = strlen(str);
+			zbx_strcpy_alloc(&results, &results_alloc, &results_offset, str);
+
+			zbx_vector_snmp_walk_var_append(&walker->group->vars, walk_var);
+		}
+	}
+
+	SET_TEXT_RESULT(&walker->item.result, NULL != results ? results : zbx_strdup(NULL, ""));
+}
+
+static void	test_check_result(const zbx_snmp_context_t *item, int ret, zbx_mock_handle_t hresult, int index)
+{
+	char	msg[64];
+	int	expected_ret;
+
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_object_member_string(hresult, "return"));
+
+	/* FAIL means that item must be polled separately */
+	zbx_snprintf(msg, sizeof(msg), "item #%d polled separately", index);
+	zbx_mock_assert_int_eq(msg, FAIL == expected_ret ? FAIL : SUCCEED, ret);
+
+	if (FAIL == expected_ret)
+		return;
+
+	zbx_snprintf(msg, sizeof(msg), "item #%d return code", index);
+	zbx_mock_assert_int_eq(msg, expected_ret, item->item.ret);
+
+	zbx_snprintf(msg, sizeof(msg), "item #%d result", index);
+
+	if (SUCCEED == expected_ret)
+	{
+		if (!ZBX_ISSET_TEXT(&item->item.result))
+			fail_msg("item #%d has no value", index);
+
+		zbx_mock_assert_str_eq(msg, zbx_mock_get_object_member_string(hresult, "value"),
+				item->item.result.text);
+	}
+	else
+	{
+		if (!ZBX_ISSET_MSG(&item->item.result))
+			fail_msg("item #%d has no error", index);
+
+		zbx_mock_assert_str_eq(msg, zbx_mock_get_object_member_string(hresult, "error"),
+				item->item.result.msg);
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vector_snmp_context_t	items;
+	zbx_vector_ptr_t		walkers;
+	zbx_snmp_walk_device_t		*device, device_local;
+	zbx_mock_handle_t		hitems, hitem, hresults;
+	zbx_mock_error_t		err;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_snmp_context_create(&items);
+	zbx_vector_ptr_create(&walkers);
+
+	hitems = zbx_mock_get_parameter_handle("in.items");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hitems, &hitem)))
+	{
+		zbx_snmp_context_t	*snmp_context;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read item");
+
+		snmp_context = test_item_create(hitem);
+		zbx_vector_snmp_context_append(&items, snmp_context);
+		snmp_walk_group_add(snmp_context);
+	}
+
+	device_local.device = "device";
+
+	if (NULL == (device = (zbx_snmp_walk_device_t *)zbx_hashset_search(snmp_walk_devices, &device_local)))
+		fail_msg("items were not grouped");
+
+	test_check_groups(&items, device);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter("out.results", &hresults))
+	{
+		zbx_mock_handle_t	hresult;
+		int			results_num = 0;
+
+		for (int i = 0; i < device->groups.values_num; i++)
+		{
+			zbx_snmp_context_t	*walker = snmp_walk_group_create_walker(device->groups.values[i]);
+
+			test_walk(walker);
+			zbx_vector_ptr_append(&walkers, walker);
+		}
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hresults, &hresult)))
+		{
+			zbx_snmp_context_t	*item, *walker = NULL;
+			int			ret;
+
+			if (ZBX_MOCK_SUCCESS != err)
+				fail_msg("cannot read expected result");
+
+			if (results_num >= items.values_num)
+				fail_msg("more results than items");
+
+			item = items.values[results_num];
+
+			for (int i = 0; i < walkers.values_num; i++)
+			{
+				zbx_snmp_context_t	*candidate = (zbx_snmp_context_t *)walkers.values[i];
+
+				if (FAIL != zbx_vector_snmp_context_search(&candidate->group->members, item,
+						ZBX_DEFAULT_PTR_COMPARE_FUNC))
+				{
+					walker = candidate;
+				}
+			}
+
+			ret = snmp_walk_group_set_result(walker, item);
+			test_check_result(item, ret, hresult, results_num++);
+		}
+
+		zbx_mock_assert_int_eq("number of results", items.values_num, results_num);
+
+		for (int i = 0; i < walkers.values_num; i++)
+		{
+			zbx_snmp_context_t	*walker = (zbx_snmp_context_t *)walkers.values[i];
+
+			snmp_walk_group_free(walker->group);
+			walker->group = NULL;
+			zbx_async_check_snmp_clean(walker);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < device->groups.values_num; i++)
+			snmp_walk_group_free(device->groups.values[i]);
+	}
+
+	zbx_hashset_destroy(snmp_walk_devices);
+	zbx_free(snmp_walk_devices);
+
+	for (int i = 0; i < items.values_num; i++)
+		zbx_async_check_snmp_clean(items.values[i]);
+
+	zbx_vector_ptr_destroy(&walkers);
+	zbx_vector_snmp_context_destroy(&items);
+}
+#else
+void	zbx_mock_test_entry(void **state)
+{
+	ZBX_UNUSED(state);
+
+	skip();
+}
+#endif
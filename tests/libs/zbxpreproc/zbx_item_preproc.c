@@ -343,7 +343,7 @@ void	zbx_mock_test_entry(void **state)
 
 	preproc.steps = &step;
 	preproc.steps_num = 1;
-	cache = pp_cache_create(&preproc, &value_in);
+	cache = pp_cache_create(&value_in);
 
 	for (i = 0; i < 4; i++)
 	{
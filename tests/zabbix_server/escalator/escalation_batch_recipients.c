@@ -0,0 +1,214 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxmockdata.h"
+#include "zbxcommon.h"
+
+#include "../../../src/zabbix_server/escalator/escalator.c"
+
+#define ESCALATION_ALERT_COLUMNS_MAX	8
+
+/* alerts table query results, read from test data in the query order */
+struct zbx_db_result
+{
+	zbx_mock_handle_t	hrows;
+	char			*row[ESCALATION_ALERT_COLUMNS_MAX + 1];
+};
+
+static int	selects;
+
+zbx_db_result_t	__wrap_zbx_db_select(const char *fmt, ...);
+zbx_db_row_t	__wrap_zbx_db_fetch(zbx_db_result_t result);
+void	__wrap_zbx_db_free_result(zbx_db_result_t result);
+
+zbx_db_result_t	__wrap_zbx_db_select(const char *fmt, ...)
+{
+	va_list			args;
+	char			*sql, data_source[32];
+	zbx_db_result_t		result;
+	zbx_mock_error_t	err;
+
+	va_start(args, fmt);
+	sql = zbx_dvsprintf(NULL, fmt, args);
+	va_end(args);
+
+	if (NULL == strstr(sql, " from alerts "))
+		fail_msg("unexpected query: %s", sql);
+
+	zbx_free(sql);
+
+	if (1 == ++selects)
+		zbx_strlcpy(data_source, "alerts", sizeof(data_source));
+	else
+		zbx_snprintf(data_source, sizeof(data_source), "alerts (%d)", selects);
+
+	result = (zbx_db_result_t)zbx_malloc(NULL, sizeof(struct zbx_db_result));
+
+	if (ZBX_MOCK_SUCCESS != (err = zbx_mock_db_rows(data_source, &result->hrows)))
+		fail_msg("cannot find data for \"%s\": %s", data_source, zbx_mock_error_string(err));
+
+	return result;
+}
+
+zbx_db_row_t	__wrap_zbx_db_fetch(zbx_db_result_t result)
+{
+	zbx_mock_handle_t	hrow, hfield;
+	zbx_mock_error_t	err;
+	int			column = 0;
+
+	if (ZBX_MOCK_END_OF_VECTOR == zbx_mock_vector_element(result->hrows, &hrow))
+		return NULL;
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hrow, &hfield)))
+	{
+		if (ESCALATION_ALERT_COLUMNS_MAX <= column || ZBX_MOCK_SUCCESS != err ||
+				ZBX_MOCK_SUCCESS != zbx_mock_string(hfield, (const char **)&result->row[column]))
+		{
+			fail_msg("cannot read column %d", column + 1);
+		}
+
+		column++;
+	}
+
+	result->row[column] = NULL;
+
+	return result->row;
+}
+
+void	__wrap_zbx_db_free_result(zbx_db_result_t result)
+{
+	zbx_free(result);
+}
+
+static void	batch_add_step_alerts(zbx_escalation_batch_t *batch)
+{
+	zbx_mock_handle_t	halerts, halert;
+	zbx_mock_error_t	err;
+
+	halerts = zbx_mock_get_parameter_handle("in.batch.alerts");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(halerts, &halert)))
+	{
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read batch alert: %s", zbx_mock_error_string(err));
+
+		zbx_vector_escalation_alert_ptr_append(&batch->step_alerts, escalation_alert_create(
+				zbx_mock_get_object_member_uint64(halert, "actionid"),
+				zbx_mock_get_object_member_uint64(halert, "eventid"),
+				zbx_mock_get_object_member_uint64(halert, "userid"),
+				zbx_mock_get_object_member_uint64(halert, "mediatypeid"),
+				zbx_mock_get_object_member_string(halert, "subject"),
+				zbx_mock_get_object_member_string(halert, "message"),
+				zbx_mock_get_object_member_int(halert, "esc_step")));
+	}
+}
+
+static void	check_recipients(const char *path, const zbx_vector_uint64_pair_t *recipients)
+{
+	zbx_mock_handle_t	hrecipients, hrecipient;
+	zbx_mock_error_t	err;
+	int			i = 0;
+
+	hrecipients = zbx_mock_get_parameter_handle(path);
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hrecipients, &hrecipient)))
+	{
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read %s recipient: %s", path, zbx_mock_error_string(err));
+
+		if (i >= recipients->values_num)
+			fail_msg("%s: expected more than %d recipients", path, recipients->values_num);
+
+		zbx_mock_assert_uint64_eq(path, zbx_mock_get_object_member_uint64(hrecipient, "userid"),
+				recipients->values[i].first);
+		zbx_mock_assert_uint64_eq(path, zbx_mock_get_object_member_uint64(hrecipient, "mediatypeid"),
+				recipients->values[i].second);
+		i++;
+	}
+
+	zbx_mock_assert_int_eq(path, i, recipients->values_num);
+}
+
+static void	check_alerts(const char *path, const zbx_vector_escalation_alert_ptr_t *alerts)
+{
+	zbx_mock_handle_t	halerts, halert;
+	zbx_mock_error_t	err;
+	int			i = 0;
+
+	halerts = zbx_mock_get_parameter_handle(path);
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(halerts, &halert)))
+	{
+		const zbx_escalation_alert_t	*alert;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read %s alert: %s", path, zbx_mock_error_string(err));
+
+		if (i >= alerts->values_num)
+			fail_msg("%s: expected more than %d alerts", path, alerts->values_num);
+
+		alert = alerts->values[i++];
+
+		zbx_mock_assert_uint64_eq(path, zbx_mock_get_object_member_uint64(halert, "userid"), alert->userid);
+		zbx_mock_assert_uint64_eq(path, zbx_mock_get_object_member_uint64(halert, "mediatypeid"),
+				alert->mediatypeid);
+		zbx_mock_assert_int_eq(path, zbx_mock_get_object_member_int(halert, "esc_step"), alert->esc_step);
+		zbx_mock_assert_str_eq(path, zbx_mock_get_object_member_string(halert, "message"), alert->message);
+	}
+
+	zbx_mock_assert_int_eq(path, i, alerts->values_num);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_escalation_batch_t			batch;
+	zbx_vector_uint64_pair_t		recipients;
+	zbx_vector_escalation_alert_ptr_t	alerts;
+	zbx_uint64_t				actionid, eventid, r_eventid;
+
+	ZBX_UNUSED(state);
+
+	selects = 0;
+
+	escalation_batch_init(&batch);
+	zbx_vector_uint64_pair_create(&recipients);
+	zbx_vector_escalation_alert_ptr_create(&alerts);
+
+	batch_add_step_alerts(&batch);
+
+	actionid = zbx_mock_get_parameter_uint64("in.actionid");
+	eventid = zbx_mock_get_parameter_uint64("in.eventid");
+	r_eventid = zbx_mock_get_parameter_uint64("in.r_eventid");
+
+	/* recovery message is sent to recipients of problem and recovery messages */
+	escalation_batch_get_recipients(&batch, actionid, eventid, r_eventid, &recipients);
+	check_recipients("out.recovery", &recipients);
+
+	/* update message is sent to recipients of problem messages */
+	zbx_vector_uint64_pair_clear(&recipients);
+	escalation_batch_get_recipients(&batch, actionid, eventid, 0, &recipients);
+	check_recipients("out.update", &recipients);
+
+	/* escalation cancel message repeats the last problem message of each recipient */
+	escalation_batch_get_last_alerts(&batch, actionid, eventid, &alerts);
+	check_alerts("out.cancel", &alerts);
+
+	zbx_vector_escalation_alert_ptr_clear_ext(&alerts, escalation_alert_free);
+	zbx_vector_escalation_alert_ptr_destroy(&alerts);
+	zbx_vector_uint64_pair_destroy(&recipients);
+	escalation_batch_clean(&batch);
+}
@@ -0,0 +1,124 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "../../../src/zabbix_server/lld/lld_entry.c"
+#include "zbxmocktest.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxmockdata.h"
+#include "zbxcommon.h"
+
+static void	extract_entries(const char *path, zbx_jsonobj_t *obj, zbx_hashset_t *entries,
+		const zbx_vector_lld_macro_path_ptr_t *macro_paths)
+{
+	char	*error = NULL;
+
+	zbx_mock_assert_result_eq("zbx_jsonobj_open()", SUCCEED, zbx_jsonobj_open(zbx_mock_get_parameter_string(path),
+			obj));
+
+	zbx_hashset_create_ext(entries, 0, lld_entry_hash, lld_entry_compare, (zbx_clean_func_t)lld_entry_clear,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+
+	if (SUCCEED != lld_extract_entries(entries, NULL, obj, macro_paths, &error))
+		fail_msg("lld_extract_entries(%s): %s", path, error);
+}
+
+static void	check_entries(const char *path, const zbx_vector_lld_entry_ptr_t *entries)
+{
+	zbx_vector_str_t	expected, returned;
+	zbx_mock_handle_t	hentries, hentry;
+	zbx_mock_error_t	err;
+	const char		*str;
+
+	zbx_vector_str_create(&expected);
+	zbx_vector_str_create(&returned);
+
+	hentries = zbx_mock_get_parameter_handle(path);
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hentries, &hentry)))
+	{
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_string(hentry, &str))
+			fail_msg("cannot read %s entry", path);
+
+		zbx_vector_str_append(&expected, zbx_strdup(NULL, str));
+	}
+
+	for (int i = 0; i < entries->values_num; i++)
+	{
+		char	*entry = NULL;
+		size_t	entry_alloc = 0, entry_offset = 0;
+
+		lld_entry_snprintf_alloc(entries->values[i], &entry, &entry_alloc, &entry_offset);
+		zbx_vector_str_append(&returned, entry);
+	}
+
+	zbx_vector_str_sort(&expected, ZBX_DEFAULT_STR_COMPARE_FUNC);
+	zbx_vector_str_sort(&returned, ZBX_DEFAULT_STR_COMPARE_FUNC);
+
+	zbx_mock_assert_int_eq(path, expected.values_num, returned.values_num);
+
+	for (int i = 0; i < expected.values_num; i++)
+		zbx_mock_assert_str_eq(path, expected.values[i], returned.values[i]);
+
+	zbx_vector_str_clear_ext(&returned, zbx_str_free);
+	zbx_vector_str_clear_ext(&expected, zbx_str_free);
+	zbx_vector_str_destroy(&returned);
+	zbx_vector_str_destroy(&expected);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vector_lld_macro_path_ptr_t	macro_paths;
+	zbx_jsonobj_t			obj, obj_prev;
+	zbx_hashset_t			entries, entries_prev;
+	zbx_lld_delta_t			delta;
+	int				expected_ret, returned_ret;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_lld_macro_path_ptr_create(&macro_paths);
+	zbx_vector_lld_entry_ptr_create(&delta.added);
+	zbx_vector_lld_entry_ptr_create(&delta.removed);
+
+	extract_entries("in.previous", &obj_prev, &entries_prev, &macro_paths);
+	extract_entries("in.current", &obj, &entries, &macro_paths);
+
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.result"));
+	returned_ret = lld_entries_get_delta(&entries, &entries_prev, &delta);
+
+	zbx_mock_assert_result_eq("lld_entries_get_delta()", expected_ret, returned_ret);
+
+	if (SUCCEED == returned_ret)
+	{
+		check_entries("out.added", &delta.added);
+		check_entries("out.removed", &delta.removed);
+
+		for (int i = 1; i < delta.added.values_num; i++)
+		{
+			if (delta.added.values[i - 1] > delta.added.values[i])
+				fail_msg("added entries are not sorted by address");
+		}
+	}
+
+	zbx_vector_lld_entry_ptr_destroy(&delta.removed);
+	zbx_vector_lld_entry_ptr_destroy(&delta.added);
+
+	zbx_hashset_destroy(&entries);
+	zbx_hashset_destroy(&entries_prev);
+
+	zbx_jsonobj_clear(&obj);
+	zbx_jsonobj_clear(&obj_prev);
+
+	zbx_vector_lld_macro_path_ptr_destroy(&macro_paths);
+}
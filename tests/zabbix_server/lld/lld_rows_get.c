@@ -0,0 +1,199 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "../../../src/zabbix_server/lld/lld.c"
+#include "zbxmocktest.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxmockdata.h"
+#include "zbxcommon.h"
+
+/* rows have name0..name9 names, every third row has no type and every seventh row has no label */
+static char	*rows_json_create(int rows_num)
+{
+	char	*json = NULL;
+	size_t	json_alloc = 0, json_offset = 0;
+
+	zbx_chrcpy_alloc(&json, &json_alloc, &json_offset, '[');
+
+	for (int i = 0; i < rows_num; i++)
+	{
+		if (0 != i)
+			zbx_chrcpy_alloc(&json, &json_alloc, &json_offset, ',');
+
+		zbx_snprintf_alloc(&json, &json_alloc, &json_offset, "{\"{#ID}\":\"%d\",\"{#NAME}\":\"name%d\"", i,
+				i % 10);
+
+		if (0 != i % 3)
+		{
+			zbx_snprintf_alloc(&json, &json_alloc, &json_offset, ",\"{#TYPE}\":\"%s\"",
+					0 != i % 2 ? "a" : "b");
+		}
+
+		if (0 != i % 7)
+			zbx_strcpy_alloc(&json, &json_alloc, &json_offset, ",\"{#LABEL}\":\"x\"");
+
+		zbx_chrcpy_alloc(&json, &json_alloc, &json_offset, '}');
+	}
+
+	zbx_chrcpy_alloc(&json, &json_alloc, &json_offset, ']');
+
+	return json;
+}
+
+static void	filter_read(zbx_mock_handle_t hfilter, zbx_lld_filter_t *filter)
+{
+	zbx_mock_handle_t	hconditions, hcondition;
+	zbx_mock_error_t	err;
+
+	filter->evaltype = zbx_mock_get_object_member_int(hfilter, "evaltype");
+
+	if (ZBX_CONDITION_EVAL_TYPE_EXPRESSION == filter->evaltype)
+	{
+		filter->expression = zbx_strdup(filter->expression, zbx_mock_get_object_member_string(hfilter,
+				"expression"));
+	}
+
+	hconditions = zbx_mock_get_object_member_handle(hfilter, "conditions");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hconditions, &hcondition)))
+	{
+		zbx_lld_condition_t	*condition;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read filter condition: %s", zbx_mock_error_string(err));
+
+		condition = zbx_lld_filter_condition_create(zbx_mock_get_object_member_string(hcondition, "id"),
+				zbx_mock_get_object_member_string(hcondition, "operator"),
+				zbx_mock_get_object_member_string(hcondition, "macro"),
+				zbx_mock_get_object_member_string(hcondition, "value"));
+
+		zbx_vector_lld_condition_ptr_append(&filter->conditions, condition);
+	}
+
+	if (ZBX_CONDITION_EVAL_TYPE_AND_OR == filter->evaltype)
+		zbx_vector_lld_condition_ptr_sort(&filter->conditions, lld_condition_compare_by_macro);
+}
+
+static void	overrides_read(zbx_vector_lld_override_ptr_t *overrides)
+{
+	zbx_mock_handle_t	hoverrides, hoverride;
+	zbx_mock_error_t	err;
+
+	hoverrides = zbx_mock_get_parameter_handle("in.overrides");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hoverrides, &hoverride)))
+	{
+		zbx_lld_override_t	*override;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read override: %s", zbx_mock_error_string(err));
+
+		override = zbx_lld_override_create(zbx_mock_get_object_member_string(hoverride, "id"), "1",
+				"override", zbx_mock_get_object_member_string(hoverride, "id"), "0", "",
+				zbx_mock_get_object_member_string(hoverride, "stop"));
+
+		filter_read(zbx_mock_get_object_member_handle(hoverride, "filter"), &override->filter);
+		zbx_vector_lld_override_ptr_append(overrides, override);
+	}
+}
+
+static void	compare_rows(const zbx_vector_lld_row_ptr_t *rows, const zbx_vector_lld_row_ptr_t *rows_serial)
+{
+	zbx_mock_assert_int_eq("number of rows", rows_serial->values_num, rows->values_num);
+
+	for (int i = 0; i < rows->values_num; i++)
+	{
+		const zbx_lld_row_t	*row = rows->values[i], *row_serial = rows_serial->values[i];
+
+		zbx_mock_assert_ptr_eq("row entry", row_serial->data, row->data);
+		zbx_mock_assert_int_eq("number of row overrides", row_serial->overrides.values_num,
+				row->overrides.values_num);
+
+		for (int j = 0; j < row->overrides.values_num; j++)
+		{
+			zbx_mock_assert_ptr_eq("row override", row_serial->overrides.values[j],
+					row->overrides.values[j]);
+		}
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vector_lld_macro_path_ptr_t	macro_paths;
+	zbx_vector_lld_entry_ptr_t	entries_sorted;
+	zbx_vector_lld_override_ptr_t	overrides;
+	zbx_vector_lld_row_ptr_t	rows, rows_serial;
+	zbx_lld_filter_t		filter;
+	zbx_jsonobj_t			obj;
+	zbx_hashset_t			entries;
+	char				*json, *error = NULL, *info = NULL, *info_serial = NULL;
+	int				jobs_num;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_lld_macro_path_ptr_create(&macro_paths);
+	zbx_vector_lld_entry_ptr_create(&entries_sorted);
+	zbx_vector_lld_override_ptr_create(&overrides);
+	zbx_vector_lld_row_ptr_create(&rows);
+	zbx_vector_lld_row_ptr_create(&rows_serial);
+	zbx_hashset_create_ext(&entries, 0, lld_entry_hash, lld_entry_compare, (zbx_clean_func_t)lld_entry_clear,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+
+	json = rows_json_create(zbx_mock_get_parameter_int("in.rows"));
+
+	if (SUCCEED != zbx_jsonobj_open(json, &obj))
+		fail_msg("cannot parse rows: %s", zbx_json_strerror());
+
+	if (SUCCEED != lld_extract_entries(&entries, &entries_sorted, &obj, &macro_paths, &error))
+		fail_msg("cannot extract entries: %s", error);
+
+	zbx_lld_filter_init(&filter);
+	filter_read(zbx_mock_get_parameter_handle("in.filter"), &filter);
+	overrides_read(&overrides);
+
+	lld_jobs_init(1);
+	zbx_mock_assert_result_eq("serial processing", SUCCEED, lld_rows_get(&entries_sorted, &filter, &rows_serial,
+			&overrides, &info_serial));
+
+	lld_jobs_init(zbx_mock_get_parameter_int("in.threads"));
+	jobs_num = lld_jobs_num(entries_sorted.values_num * (overrides.values_num + 1));
+	zbx_mock_assert_int_eq("number of jobs", zbx_mock_get_parameter_int("out.jobs"), jobs_num);
+
+	zbx_mock_assert_result_eq("parallel processing", SUCCEED, lld_rows_get(&entries_sorted, &filter, &rows,
+			&overrides, &info));
+
+	zbx_mock_assert_int_eq("number of discovered rows", zbx_mock_get_parameter_int("out.rows"), rows.values_num);
+	compare_rows(&rows, &rows_serial);
+	zbx_mock_assert_str_eq("warnings", ZBX_NULL2EMPTY_STR(info_serial), ZBX_NULL2EMPTY_STR(info));
+
+	zbx_free(info);
+	zbx_free(info_serial);
+
+	zbx_vector_lld_row_ptr_clear_ext(&rows, lld_row_free);
+	zbx_vector_lld_row_ptr_clear_ext(&rows_serial, lld_row_free);
+	zbx_vector_lld_row_ptr_destroy(&rows);
+	zbx_vector_lld_row_ptr_destroy(&rows_serial);
+
+	zbx_vector_lld_override_ptr_clear_ext(&overrides, zbx_lld_override_free);
+	zbx_vector_lld_override_ptr_destroy(&overrides);
+	zbx_lld_filter_clean(&filter);
+
+	zbx_vector_lld_entry_ptr_destroy(&entries_sorted);
+	zbx_hashset_destroy(&entries);
+	zbx_jsonobj_clear(&obj);
+	zbx_free(json);
+
+	zbx_vector_lld_macro_path_ptr_destroy(&macro_paths);
+}
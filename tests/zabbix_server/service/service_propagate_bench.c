@@ -0,0 +1,122 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+/* Benchmark of service status propagation, not run by tests. Build it with                        */
+/* 'make service_propagate_bench':                                                                 */
+/*                                                                                                 */
+/*   service_propagate_bench [<changes>]                                                           */
+/*                                                                                                 */
+/* Leaf status changes are applied to synthetic deep, wide and shared trees of about 100k services */
+/* by service manager and by the reference implementation, which recalculates every parent of a    */
+/* changed service by walking all its children. Service manager time includes building problem     */
+/* diffs, status rule and event processing and the mocked database update. Trees and changes are   */
+/* generated by the service_propagate_status test.                                                 */
+
+#include "service_propagate_status.c"
+
+#include "zbxtime.h"
+
+#define BENCH_CHANGES	100000
+
+typedef struct
+{
+	const char	*name;
+	int		depth;
+	int		width;
+	int		shared;
+}
+zbx_bench_tree_t;
+
+static void	bench_tree(const zbx_bench_tree_t *tree, int algorithm, int changes)
+{
+	zbx_service_manager_t		manager;
+	zbx_hashset_t			services_full;
+	zbx_vector_service_ptr_t	leaves_full, leaves;
+	double				sec_reference, sec_manager;
+	zbx_hashset_iter_t		iter;
+	zbx_service_t			*service;
+	int				mismatches = 0;
+
+	zbx_vector_service_ptr_create(&leaves_full);
+	zbx_vector_service_ptr_create(&leaves);
+
+	zbx_hashset_create_ext(&services_full, 1000, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+			(zbx_clean_func_t)service_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+	tree_create(&services_full, &leaves_full, tree->depth, tree->width, tree->shared, algorithm, NULL);
+
+	sec_reference = zbx_time();
+	propagate_full(&leaves_full, changes);
+	sec_reference = zbx_time() - sec_reference;
+
+	service_manager_init(&manager);
+	tree_create(&manager.services, &leaves, tree->depth, tree->width, tree->shared, algorithm, NULL);
+	services_build_status_index(&manager.services);
+
+	sec_manager = zbx_time();
+	propagate_manager(&manager, &leaves, changes, ZBX_FLAG_SERVICE_UPDATE);
+	sec_manager = zbx_time() - sec_manager;
+
+	zbx_hashset_iter_reset(&manager.services, &iter);
+	while (NULL != (service = (zbx_service_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_service_t	*service_full;
+
+		if (NULL == (service_full = (zbx_service_t *)zbx_hashset_search(&services_full, service)) ||
+				service_full->status != service->status)
+		{
+			mismatches++;
+		}
+	}
+
+	printf("%-7s %s services:%d leaves:%d changes:%d reference:" ZBX_FS_DBL " sec manager:" ZBX_FS_DBL " sec%s\n",
+			tree->name, ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ONE == algorithm ? "MIN" : "MAX",
+			manager.services.num_data, leaves.values_num, changes, sec_reference, sec_manager,
+			0 == mismatches ? "" : " STATUS MISMATCH");
+
+	service_manager_free(&manager);
+	zbx_hashset_destroy(&manager.service_diffs);
+	zbx_hashset_destroy(&manager.service_problem_tags_index);
+	zbx_hashset_destroy(&services_full);
+
+	zbx_vector_service_ptr_destroy(&leaves);
+	zbx_vector_service_ptr_destroy(&leaves_full);
+}
+
+int	main(int argc, char **argv)
+{
+	/* trees of about 100k services */
+	const zbx_bench_tree_t	trees[] = {
+		{"deep", 16, 2, 0},
+		{"wide", 2, 316, 0},
+		{"shared", 8, 4, 1}
+	};
+	const int		algorithms[] = {ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ONE,
+						ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ALL};
+	int			changes = BENCH_CHANGES;
+
+	if (1 < argc && 0 >= (changes = atoi(argv[1])))
+	{
+		printf("usage: %s [<changes>]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (int i = 0; i < (int)ARRSIZE(trees); i++)
+	{
+		for (int j = 0; j < (int)ARRSIZE(algorithms); j++)
+			bench_tree(&trees[i], algorithms[j], changes);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,387 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/zabbix_server/service/service_manager.c"
+
+void		__wrap_zbx_db_begin(void);
+int		__wrap_zbx_db_commit(void);
+int		__wrap_zbx_db_execute_overflowed_sql(char **sql, size_t *sql_alloc, size_t *sql_offset);
+int		__wrap_zbx_db_flush_overflowed_sql(char *sql, size_t sql_offset);
+int		__wrap_zbx_db_lock_ids(const char *table_name, const char *field_name, zbx_vector_uint64_t *ids);
+zbx_uint64_t	__wrap_zbx_db_get_maxid_num(const char *tablename, int num);
+void		__wrap_zbx_db_insert_prepare(zbx_db_insert_t *self, const char *table, ...);
+void		__wrap_zbx_db_insert_add_values(zbx_db_insert_t *db_insert, ...);
+int		__wrap_zbx_db_insert_execute(zbx_db_insert_t *db_insert);
+void		__wrap_zbx_db_insert_clean(zbx_db_insert_t *db_insert);
+
+/* service status changes are written to database by service manager, the test checks only cached statuses */
+
+void	__wrap_zbx_db_begin(void)
+{
+}
+
+int	__wrap_zbx_db_commit(void)
+{
+	return ZBX_DB_OK;
+}
+
+int	__wrap_zbx_db_execute_overflowed_sql(char **sql, size_t *sql_alloc, size_t *sql_offset)
+{
+	ZBX_UNUSED(sql);
+	ZBX_UNUSED(sql_alloc);
+
+	*sql_offset = 0;
+
+	return SUCCEED;
+}
+
+int	__wrap_zbx_db_flush_overflowed_sql(char *sql, size_t sql_offset)
+{
+	ZBX_UNUSED(sql);
+	ZBX_UNUSED(sql_offset);
+
+	return ZBX_DB_OK;
+}
+
+int	__wrap_zbx_db_lock_ids(const char *table_name, const char *field_name, zbx_vector_uint64_t *ids)
+{
+	ZBX_UNUSED(table_name);
+	ZBX_UNUSED(field_name);
+	ZBX_UNUSED(ids);
+
+	return SUCCEED;
+}
+
+zbx_uint64_t	__wrap_zbx_db_get_maxid_num(const char *tablename, int num)
+{
+	ZBX_UNUSED(tablename);
+	ZBX_UNUSED(num);
+
+	return 1;
+}
+
+void	__wrap_zbx_db_insert_prepare(zbx_db_insert_t *self, const char *table, ...)
+{
+	ZBX_UNUSED(self);
+	ZBX_UNUSED(table);
+}
+
+void	__wrap_zbx_db_insert_add_values(zbx_db_insert_t *db_insert, ...)
+{
+	ZBX_UNUSED(db_insert);
+}
+
+int	__wrap_zbx_db_insert_execute(zbx_db_insert_t *db_insert)
+{
+	ZBX_UNUSED(db_insert);
+
+	return SUCCEED;
+}
+
+void	__wrap_zbx_db_insert_clean(zbx_db_insert_t *db_insert)
+{
+	ZBX_UNUSED(db_insert);
+}
+
+/* synthetic service tree - every service above the last level has 'width' children, */
+/* with 'shared' option children are also linked to the next service of parent level */
+static void	tree_create(zbx_hashset_t *services, zbx_vector_service_ptr_t *leaves, int depth, int width,
+		int shared, int algorithm, zbx_service_rule_t *rule)
+{
+	zbx_vector_service_ptr_t	level, level_next;
+	zbx_uint64_t			serviceid = 0;
+
+	zbx_vector_service_ptr_create(&level);
+	zbx_vector_service_ptr_create(&level_next);
+
+	for (int l = 0; l <= depth; l++)
+	{
+		int	num = (0 == l ? 1 : level.values_num * width);
+
+		for (int i = 0; i < num; i++)
+		{
+			zbx_service_t	service_local, *service;
+
+			memset(&service_local, 0, sizeof(service_local));
+			service_local.serviceid = ++serviceid;
+			service_local.status = ZBX_SERVICE_STATUS_OK;
+			service_local.algorithm = algorithm;
+			service_local.weight = (int)(serviceid % 4);
+
+			if (0 == serviceid % 7)
+			{
+				service_local.propagation_rule = ZBX_SERVICE_STATUS_PROPAGATION_IGNORE;
+			}
+			else if (0 == serviceid % 5)
+			{
+				service_local.propagation_rule = ZBX_SERVICE_STATUS_PROPAGATION_INCREASE;
+				service_local.propagation_value = 1;
+			}
+			else if (0 == serviceid % 11)
+			{
+				service_local.propagation_rule = ZBX_SERVICE_STATUS_PROPAGATION_DECREASE;
+				service_local.propagation_value = 1;
+			}
+
+			service = (zbx_service_t *)zbx_hashset_insert(services, &service_local, sizeof(service_local));
+
+			zbx_vector_service_ptr_create(&service->children);
+			zbx_vector_service_ptr_create(&service->parents);
+			zbx_vector_service_rule_ptr_create(&service->status_rules);
+			zbx_vector_service_tag_ptr_create(&service->tags);
+			zbx_vector_service_problem_tag_ptr_create(&service->service_problem_tags);
+			zbx_vector_service_problem_ptr_create(&service->service_problems);
+
+			if (NULL != rule && l != depth)
+				zbx_vector_service_rule_ptr_append(&service->status_rules, rule);
+
+			if (0 != l)
+			{
+				zbx_service_t	*parent = level.values[i / width];
+
+				zbx_vector_service_ptr_append(&service->parents, parent);
+				zbx_vector_service_ptr_append(&parent->children, service);
+
+				if (0 != shared && 1 < level.values_num)
+				{
+					parent = level.values[(i / width + 1) % level.values_num];
+
+					zbx_vector_service_ptr_append(&service->parents, parent);
+					zbx_vector_service_ptr_append(&parent->children, service);
+				}
+			}
+
+			zbx_vector_service_ptr_append(&level_next, service);
+		}
+
+		zbx_vector_service_ptr_clear(&level);
+		zbx_vector_service_ptr_append_array(&level, level_next.values, level_next.values_num);
+		zbx_vector_service_ptr_clear(&level_next);
+	}
+
+	zbx_vector_service_ptr_append_array(leaves, level.values, level.values_num);
+
+	zbx_vector_service_ptr_destroy(&level_next);
+	zbx_vector_service_ptr_destroy(&level);
+}
+
+static int	change_get_status(int change)
+{
+	return change % ZBX_SERVICE_STATUS_NUM + ZBX_SERVICE_STATUS_OK;
+}
+
+static zbx_service_t	*change_get_leaf(const zbx_vector_service_ptr_t *leaves, int change)
+{
+	return leaves->values[(int)(((zbx_uint64_t)change * 7919 + 13) % (zbx_uint64_t)leaves->values_num)];
+}
+
+/* reference implementation - recalculates parents on every change by walking their children */
+static void	service_update_status_full(zbx_service_t *service)
+{
+	int	status, rule_status;
+
+	status = service_get_main_status(service);
+
+	for (int i = 0; i < service->status_rules.values_num; i++)
+	{
+		if (status < (rule_status = service_get_rule_status(service, service->status_rules.values[i])))
+			status = rule_status;
+	}
+
+	if (service->status == status)
+		return;
+
+	service->status = status;
+
+	for (int i = 0; i < service->parents.values_num; i++)
+		service_update_status_full(service->parents.values[i]);
+}
+
+static void	propagate_full(const zbx_vector_service_ptr_t *leaves, int changes)
+{
+	for (int i = 0; i < changes; i++)
+	{
+		zbx_service_t	*leaf = change_get_leaf(leaves, i);
+
+		leaf->status = change_get_status(i);
+
+		for (int j = 0; j < leaf->parents.values_num; j++)
+			service_update_status_full(leaf->parents.values[j]);
+	}
+}
+
+static void	manager_update_services(zbx_service_manager_t *manager)
+{
+	db_update_services(manager);
+	zbx_hashset_clear(&manager->service_diffs);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: changes leaf statuses by replacing their problems and updates     *
+ *          service statuses by service manager                               *
+ *                                                                            *
+ * Comments: Service can be changed once per service manager update, so the   *
+ *           changes are applied in batches of different leaves.              *
+ *                                                                            *
+ ******************************************************************************/
+static void	propagate_manager(zbx_service_manager_t *manager, const zbx_vector_service_ptr_t *leaves, int changes,
+		int flags)
+{
+	zbx_uint64_t	eventid = 0;
+
+	for (int i = 0; i < changes; i++)
+	{
+		zbx_service_t		*leaf = change_get_leaf(leaves, i);
+		zbx_services_diff_t	*service_diff, service_diff_local = {.serviceid = leaf->serviceid};
+		zbx_service_problem_t	*service_problem;
+		int			status = change_get_status(i);
+
+		if (NULL != zbx_hashset_search(&manager->service_diffs, &service_diff_local))
+			manager_update_services(manager);
+
+		zbx_vector_service_problem_ptr_create(&service_diff_local.service_problems);
+		zbx_vector_service_problem_ptr_create(&service_diff_local.service_problems_recovered);
+		service_diff_local.flags = flags;
+		service_diff = (zbx_services_diff_t *)zbx_hashset_insert(&manager->service_diffs, &service_diff_local,
+				sizeof(service_diff_local));
+
+		/* when recalculating, problems missing from the update are removed by service manager */
+		if (0 == (ZBX_FLAG_SERVICE_RECALCULATE & flags))
+		{
+			for (int j = 0; j < leaf->service_problems.values_num; j++)
+			{
+				service_problem = zbx_malloc(NULL, sizeof(zbx_service_problem_t));
+				*service_problem = *leaf->service_problems.values[j];
+				zbx_vector_service_problem_ptr_append(&service_diff->service_problems_recovered,
+						service_problem);
+			}
+		}
+
+		if (ZBX_SERVICE_STATUS_OK == status)
+			continue;
+
+		service_problem = (zbx_service_problem_t *)zbx_malloc(NULL, sizeof(zbx_service_problem_t));
+		service_problem->service_problemid = ++eventid;
+		service_problem->eventid = eventid;
+		service_problem->serviceid = leaf->serviceid;
+		service_problem->severity = status;
+		service_problem->ts.sec = i + 1;
+		service_problem->ts.ns = 0;
+		zbx_vector_service_problem_ptr_append(&service_diff->service_problems, service_problem);
+	}
+
+	manager_update_services(manager);
+}
+
+static int	str_to_algorithm(const char *str)
+{
+	if (0 == strcmp(str, "MIN"))
+		return ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ONE;
+
+	if (0 == strcmp(str, "MAX"))
+		return ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ALL;
+
+	fail_msg("unknown service algorithm '%s'", str);
+
+	return FAIL;
+}
+
+static int	str_to_rule_type(const char *str)
+{
+	const char	*types[] = {"N_GE", "NP_GE", "N_LT", "NP_LT", "W_GE", "WP_GE", "W_LT", "WP_LT"};
+
+	for (int i = 0; i < (int)ARRSIZE(types); i++)
+	{
+		if (0 == strcmp(str, types[i]))
+			return i;
+	}
+
+	fail_msg("unsupported service rule type '%s'", str);
+
+	return FAIL;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_service_manager_t		manager;
+	zbx_hashset_t			services_full;
+	zbx_vector_service_ptr_t	leaves_full, leaves;
+	zbx_service_rule_t		rule, *prule = NULL;
+	zbx_hashset_iter_t		iter;
+	zbx_service_t			*service;
+	zbx_mock_handle_t		hrule;
+	int				depth, width, shared, algorithm, changes, flags = ZBX_FLAG_SERVICE_UPDATE;
+
+	ZBX_UNUSED(state);
+
+	depth = zbx_mock_get_parameter_int("in.depth");
+	width = zbx_mock_get_parameter_int("in.width");
+	changes = zbx_mock_get_parameter_int("in.changes");
+	algorithm = str_to_algorithm(zbx_mock_get_parameter_string("in.algorithm"));
+	shared = (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.shared"));
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.recalculate"))
+		flags |= ZBX_FLAG_SERVICE_RECALCULATE;
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter("in.rule", &hrule))
+	{
+		memset(&rule, 0, sizeof(rule));
+		rule.type = str_to_rule_type(zbx_mock_get_object_member_string(hrule, "type"));
+		rule.limit_status = zbx_mock_get_object_member_int(hrule, "limit");
+		rule.limit_value = zbx_mock_get_object_member_int(hrule, "value");
+		rule.new_status = zbx_mock_get_object_member_int(hrule, "status");
+		prule = &rule;
+	}
+
+	zbx_vector_service_ptr_create(&leaves_full);
+	zbx_vector_service_ptr_create(&leaves);
+
+	zbx_hashset_create_ext(&services_full, 1000, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+			(zbx_clean_func_t)service_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+	tree_create(&services_full, &leaves_full, depth, width, shared, algorithm, prule);
+	propagate_full(&leaves_full, changes);
+
+	service_manager_init(&manager);
+	tree_create(&manager.services, &leaves, depth, width, shared, algorithm, prule);
+	services_build_status_index(&manager.services);
+	propagate_manager(&manager, &leaves, changes, flags);
+
+	zbx_hashset_iter_reset(&manager.services, &iter);
+	while (NULL != (service = (zbx_service_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_service_t	*service_full;
+		char		msg[64];
+
+		if (NULL == (service_full = (zbx_service_t *)zbx_hashset_search(&services_full, service)))
+			fail_msg("cannot find service " ZBX_FS_UI64, service->serviceid);
+
+		zbx_snprintf(msg, sizeof(msg), "service " ZBX_FS_UI64 " status", service->serviceid);
+		zbx_mock_assert_int_eq(msg, service_full->status, service->status);
+	}
+
+	service_manager_free(&manager);
+	zbx_hashset_destroy(&manager.service_diffs);
+	zbx_hashset_destroy(&manager.service_problem_tags_index);
+	zbx_hashset_destroy(&services_full);
+
+	zbx_vector_service_ptr_destroy(&leaves);
+	zbx_vector_service_ptr_destroy(&leaves_full);
+}